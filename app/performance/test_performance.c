@@ -55,6 +55,49 @@
  *
  * The program outputs the time elapsed for (de)compression all packets, the
  * number of (de)compressed packets and the average elapsed time per packet.
+ *
+ * Context lookup
+ * --------------
+ *
+ * The 'lookup' action does not read any capture: it generates the given
+ * number of simultaneous IPv4/UDP flows, brings all their contexts to the
+ * Second Order state, then compresses packets from all flows in round-robin
+ * and outputs the average time elapsed per packet. It shows how the cost of
+ * finding the context of a packet evolves with the number of active flows.
+ *
+ * Burst compression
+ * -----------------
+ *
+ * The 'burst' action loads all the packets of the capture in memory, then
+ * compresses them several times with two compressors: one compressor is fed
+ * packet per packet with \ref rohc_compress4, the other one is fed with
+ * bursts of packets with \ref rohc_compress_burst. The ROHC packets of both
+ * compressors are checked to be the same. The program outputs the average
+ * time elapsed per packet for both ways of compressing.
+ *
+ * Capture replay
+ * --------------
+ *
+ * The 'replay' action maps the capture in memory and indexes all its packets
+ * once before any measure, so that neither I/O nor libpcap are measured. The
+ * capture is then replayed several times (see option --loops): all the
+ * packets are compressed, then all the ROHC packets are decompressed. The first
+ * replay is not measured if the capture is replayed several times, so that
+ * only the steady state of the contexts is measured. The program outputs the
+ * throughput, the latency percentiles and the CPU cycles per packet for both
+ * compression and decompression. The throughput and the CPU cycles are
+ * measured over the whole loops, the latencies are measured for every call.
+ *
+ * Pool compression
+ * ----------------
+ *
+ * The 'pool' action loads all the packets of the capture in memory, then
+ * compresses them with pools of 1 to N compressors (see option --threads).
+ * Every shard of a pool is used by its own thread, and every thread
+ * compresses all the packets of the capture several times (see option
+ * --loops). The first loop is not measured if there are several loops. The
+ * program outputs the throughput of the pool for every number of threads, so
+ * that the scaling of compression with the number of CPUs may be checked.
  */
 
 #include "config.h" /* for HAVE_*_H */
@@ -69,10 +112,16 @@
 #endif
 #include <time.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
+#if HAVE_PTHREAD_H == 1
+#  include <pthread.h>
+#endif
 
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
@@ -87,6 +136,7 @@ for ./configure ? If yes, check configure output and config.log"
 /* includes for network headers */
 #include <protocols/ipv4.h>
 #include <protocols/ipv6.h>
+#include <protocols/udp.h>
 
 /* ROHC includes */
 #include <rohc/rohc.h>
@@ -100,6 +150,15 @@ for ./configure ? If yes, check configure output and config.log"
 /** The maximal size for the ROHC packets */
 #define MAX_ROHC_SIZE  (5 * 1024)
 
+/** The number of packets in one burst for the 'burst' test */
+#define BURST_MAX_PACKETS  32U
+
+/** The smallest WLSB width for the 'wlsb' test */
+#define WLSB_WIDTH_MIN  4U
+
+/** The largest WLSB width for the 'wlsb' test */
+#define WLSB_WIDTH_MAX  256U
+
 /** The length of the Linux Cooked Sockets header */
 #define LINUX_COOKED_HDR_LEN  16U
 
@@ -109,6 +168,54 @@ for ./configure ? If yes, check configure output and config.log"
 /** The minimum Ethernet length (in bytes) */
 #define ETHER_FRAME_MIN_LEN  60U
 
+/** The length (in bytes) of the global header of a PCAP file */
+#define PCAP_FILE_HDR_LEN  24U
+
+/** The length (in bytes) of the header of every record in a PCAP file */
+#define PCAP_RECORD_HDR_LEN  16U
+
+/** The link type for raw IP in PCAP files (DLT_RAW is only used by libpcap) */
+#define PCAP_LINKTYPE_RAW  101U
+
+
+/** A PCAP capture mapped in memory with all its IP packets indexed */
+struct mapped_capture
+{
+	uint8_t *data;              /**< The content of the PCAP file */
+	size_t len;                 /**< The length of the PCAP file */
+	struct rohc_buf *packets;   /**< The IP packets within the mapping */
+	size_t packets_nr;          /**< The number of IP packets */
+	size_t max_packet_len;      /**< The length of the largest IP packet */
+};
+
+
+/** The measures of one operation for the 'replay' test */
+struct replay_measures
+{
+	uint32_t *latencies;  /**< The time spent for every packet (in ns) */
+	size_t nr;            /**< The number of packets measured so far */
+	double total_ns;      /**< The time spent for the whole loops (in ns) */
+	uint64_t cycles;      /**< The CPU cycles spent for the whole loops */
+	uint64_t hdr_bytes;   /**< The bytes of uncompressed headers processed */
+};
+
+
+#if HAVE_PTHREAD_H == 1
+
+/** One thread of the 'pool' test, it compresses with one shard */
+struct pool_thread
+{
+	pthread_t thread;                /**< The thread */
+	struct rohc_comp *shard;         /**< The shard of the thread */
+	const struct rohc_buf *packets;  /**< The IP packets of the capture */
+	size_t packets_nr;               /**< The number of IP packets */
+	size_t loops_nr;                 /**< The number of loops to compress */
+	double elapsed_ns;               /**< The time of the measured loops */
+	bool is_success;                 /**< Whether all packets were compressed */
+};
+
+#endif
+
 
 static void usage(void);
 
@@ -123,6 +230,97 @@ static int time_compress_packet(struct rohc_comp *comp,
                                 struct pcap_pkthdr header,
                                 unsigned char *packet,
                                 size_t link_len);
+static bool get_ip_packet(const unsigned long num_packet,
+                          const struct pcap_pkthdr header,
+                          unsigned char *const packet,
+                          const size_t link_len,
+                          struct rohc_buf *const ip_packet)
+	__attribute__((warn_unused_result, nonnull(3, 5)));
+
+static int test_burst_perfs(const bool is_verbose,
+                            char *filename,
+                            const rohc_cid_type_t cid_type,
+                            const size_t wlsb_width,
+                            const size_t max_contexts,
+                            unsigned long *packet_count);
+static int test_wlsb_perfs(const bool is_verbose,
+                           char *filename,
+                           const rohc_cid_type_t cid_type,
+                           const size_t max_contexts,
+                           unsigned long *packet_count);
+static bool load_capture(char *filename,
+                         struct rohc_buf **const packets,
+                         size_t *const packets_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void free_capture(struct rohc_buf *const packets,
+                         const size_t packets_nr);
+static struct rohc_comp * create_perf_compressor(bool *const is_verbose,
+                                                 const rohc_cid_type_t cid_type,
+                                                 const size_t wlsb_width,
+                                                 const size_t max_contexts)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool setup_perf_compressor(struct rohc_comp *const comp,
+                                  bool *const is_verbose,
+                                  const size_t wlsb_width)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+#if HAVE_PTHREAD_H == 1
+static int test_pool_perfs(const bool is_verbose,
+                           char *filename,
+                           const rohc_cid_type_t cid_type,
+                           const size_t wlsb_width,
+                           const size_t max_contexts,
+                           const size_t threads_nr,
+                           const size_t loops_nr,
+                           unsigned long *packet_count);
+static void * run_pool_thread(void *const arg)
+	__attribute__((nonnull(1)));
+#endif
+
+static int test_replay_perfs(const bool is_verbose,
+                             char *filename,
+                             const rohc_cid_type_t cid_type,
+                             const size_t wlsb_width,
+                             const size_t max_contexts,
+                             const size_t loops_nr,
+                             unsigned long *packet_count);
+static uint32_t read_pcap_u32(const uint8_t *const data,
+                              const bool is_swapped)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool map_capture(char *filename,
+                        struct mapped_capture *const capture)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void unmap_capture(struct mapped_capture *const capture)
+	__attribute__((nonnull(1)));
+static struct rohc_decomp * create_perf_decompressor(bool *const is_verbose,
+                                                     const rohc_cid_type_t cid_type,
+                                                     const size_t max_contexts)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void replay_measures_add(struct replay_measures *const measures,
+                                const struct timespec start,
+                                const struct timespec end)
+	__attribute__((nonnull(1)));
+static void replay_measures_add_loop(struct replay_measures *const measures,
+                                     const struct timespec start,
+                                     const struct timespec end,
+                                     const uint64_t cycles,
+                                     const uint64_t hdr_bytes)
+	__attribute__((nonnull(1)));
+static void print_replay_measures(const char *const name,
+                                  struct replay_measures *const measures)
+	__attribute__((nonnull(1, 2)));
+static int cmp_latencies(const void *const latency1,
+                         const void *const latency2)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline uint64_t read_cpu_cycles(void)
+	__attribute__((warn_unused_result));
+
+static int test_ctxt_lookup_perfs(const bool is_verbose,
+                                  const rohc_cid_type_t cid_type,
+                                  const size_t wlsb_width,
+                                  const size_t max_contexts,
+                                  const size_t flows_nr,
+                                  unsigned long *packet_count);
 
 static int test_decompression_perfs(const bool is_verbose,
                                     char *filename,
@@ -134,7 +332,8 @@ static int time_decompress_packet(struct rohc_decomp *decomp,
                                   struct pcap_pkthdr header,
                                   unsigned char *packet,
                                   size_t link_len,
-                                  const struct rohc_ts arrival_time);
+                                  const struct rohc_ts arrival_time,
+                                  double *const elapsed_ns);
 
 static void print_rohc_traces(void *const is_verbose__,
                               const rohc_trace_level_t level,
@@ -170,6 +369,8 @@ int main(int argc, char *argv[])
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	char *cid_type_name = NULL;
 	int wlsb_width = 4;
+	int loops_nr = 1;
+	int threads_nr = 1;
 	char *test_type = NULL; /* the name of the test to perform */
 	char *filename = NULL; /* the name of the PCAP capture used as input */
 	rohc_cid_type_t cid_type;
@@ -218,6 +419,20 @@ int main(int argc, char *argv[])
 			argv++;
 			argc--;
 		}
+		else if(!strcmp(*argv, "--loops"))
+		{
+			/* get the number of times the capture should be replayed */
+			loops_nr = atoi(argv[1]);
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--threads"))
+		{
+			/* get the largest number of threads for the 'pool' test */
+			threads_nr = atoi(argv[1]);
+			argv++;
+			argc--;
+		}
 		else if(test_type == 0)
 		{
 			/* get the name of the test */
@@ -257,6 +472,23 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* check the number of replays */
+	if(loops_nr <= 0)
+	{
+		fprintf(stderr, "invalid number of loops %d: should be a positive "
+		        "number\n", loops_nr);
+		goto error;
+	}
+
+	/* check the number of threads, every thread needs one CID at least */
+	if(threads_nr <= 0 || threads_nr > max_contexts)
+	{
+		fprintf(stderr, "invalid number of threads %d: should be a positive "
+		        "number not greater than the maximum number of ROHC contexts "
+		        "(%d)\n", threads_nr, max_contexts);
+		goto error;
+	}
+
 	/* check CID type */
 	if(!strcmp(cid_type_name, "smallcid"))
 	{
@@ -304,6 +536,45 @@ int main(int argc, char *argv[])
 		ret = test_decompression_perfs(is_verbose, filename, cid_type,
 		                               max_contexts, &packet_count);
 	}
+	else if(strcmp(test_type, "lookup") == 0)
+	{
+		/* test ROHC compression with many simultaneous generated flows */
+		const int flows_nr = atoi(filename);
+		if(flows_nr < 1 || flows_nr > max_contexts)
+		{
+			fprintf(stderr, "the number of flows should be between 1 and the "
+			        "maximum number of ROHC contexts (%d)\n", max_contexts);
+			goto error;
+		}
+		ret = test_ctxt_lookup_perfs(is_verbose, cid_type, wlsb_width,
+		                             max_contexts, flows_nr, &packet_count);
+	}
+	else if(strcmp(test_type, "burst") == 0)
+	{
+		/* compare ROHC compression packet per packet and by bursts */
+		ret = test_burst_perfs(is_verbose, filename, cid_type, wlsb_width,
+		                       max_contexts, &packet_count);
+	}
+	else if(strcmp(test_type, "wlsb") == 0)
+	{
+		/* test ROHC compression with several WLSB widths */
+		ret = test_wlsb_perfs(is_verbose, filename, cid_type, max_contexts,
+		                      &packet_count);
+	}
+	else if(strcmp(test_type, "replay") == 0)
+	{
+		/* replay the capture mapped in memory through both directions */
+		ret = test_replay_perfs(is_verbose, filename, cid_type, wlsb_width,
+		                        max_contexts, loops_nr, &packet_count);
+	}
+#if HAVE_PTHREAD_H == 1
+	else if(strcmp(test_type, "pool") == 0)
+	{
+		/* compress with pools of compressors, one thread per shard */
+		ret = test_pool_perfs(is_verbose, filename, cid_type, wlsb_width,
+		                      max_contexts, threads_nr, loops_nr, &packet_count);
+	}
+#endif
 	else
 	{
 		fprintf(stderr, "unexpected test type '%s'\n", test_type);
@@ -319,7 +590,7 @@ int main(int argc, char *argv[])
 
 	/* print performance statistics */
 	fprintf(stderr, "%scompression: %lu packets\n",
-	        (strcmp(test_type, "comp") == 0 ? "" : "de"), packet_count);
+	        (strcmp(test_type, "decomp") != 0 ? "" : "de"), packet_count);
 
 	/* everything went fine */
 	status = 0;
@@ -342,12 +613,18 @@ static void usage(void)
 		"\n"
 		"Options:\n"
 		"Mandatory parameters:\n"
-		"  ACTION            Run a compression test with 'comp' or a\n"
-		"                    decompression test with 'decomp'\n"
+		"  ACTION            Run a compression test with 'comp', a\n"
+		"                    decompression test with 'decomp', a\n"
+		"                    context lookup test with 'lookup', a\n"
+		"                    burst compression test with 'burst', a\n"
+		"                    WLSB width compression test with 'wlsb', a\n"
+		"                    capture replay test with 'replay', or a\n"
+		"                    multi-threaded compression test with 'pool'\n"
 		"  CID_TYPE          Run a small CID test with 'smallcid' or a\n"
 		"                    large CID test with 'largecid'\n"
 		"  FLOW              A flow of Ethernet frames to (de)compress\n"
-		"                    (in PCAP format)\n"
+		"                    (in PCAP format), or the number of\n"
+		"                    simultaneous flows for the 'lookup' test\n"
 		"General options:\n"
 		"  -h, --help              Print application usage and exit\n"
 		"  -v, --version           Print version information and exit\n"
@@ -356,10 +633,23 @@ static void usage(void)
 		"      --wlsb-width NUM    The width of the WLSB window to use\n"
 		"      --max-contexts NUM  The maximum number of ROHC contexts to\n"
 		"                          simultaneously use during the test\n"
+		"      --loops NUM         The number of times the 'replay' and\n"
+		"                          'pool' tests replay the capture\n"
+		"                          (default: 1)\n"
+		"      --threads NUM       The largest number of threads for the\n"
+		"                          'pool' test (default: 1)\n"
 		"\n"
 		"Examples:\n"
 		"  rohc_test_performance comp smallcid voip.pcap     test compression performances with small CIDs on the given VoIP stream\n"
 		"  rohc_test_performance decomp largecid a.pcap      test decompression performances with large CIDs on the given stream\n"
+		"  rohc_test_performance --max-contexts 16384 lookup largecid 1024\n"
+		"                                                    test context lookup performances with 1024 simultaneous flows\n"
+		"  rohc_test_performance burst smallcid voip.pcap    compare compression performances packet per packet and by bursts\n"
+		"  rohc_test_performance wlsb smallcid voip.pcap     compare compression performances with WLSB widths from 4 to 256\n"
+		"  rohc_test_performance --loops 100 replay smallcid voip.pcap\n"
+		"                                                    measure steady-state (de)compression performances on the given stream\n"
+		"  rohc_test_performance --max-contexts 1024 --threads 16 --loops 100 pool largecid a.pcap\n"
+		"                                                    measure compression performances with 1 to 16 threads\n"
 		"\n"
 		"Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
@@ -524,9 +814,7 @@ static int time_compress_packet(struct rohc_comp *comp,
                                 size_t link_len)
 {
 	/* the buffer that will contain the initial uncompressed packet */
-	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
-	struct rohc_buf ip_packet =
-		rohc_buf_init_full(packet, header.caplen, arrival_time);
+	struct rohc_buf ip_packet;
 
 	/* the buffer that will contain the compressed ROHC packet */
 	uint8_t rohc_buffer[MAX_ROHC_SIZE];
@@ -536,16 +824,62 @@ static int time_compress_packet(struct rohc_comp *comp,
 	int is_failure = 1;
 	rohc_status_t status;
 
+	/* get the IP packet from the frame */
+	if(!get_ip_packet(num_packet, header, packet, link_len, &ip_packet))
+	{
+		goto error;
+	}
+
+	/* compress the packet */
+	status = rohc_compress4(comp, ip_packet, &rohc_packet);
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "packet %lu: compression failed\n", num_packet);
+		goto error;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Get the IP packet from the given captured frame
+ *
+ * The link layer header and the Ethernet padding are removed.
+ *
+ * @param num_packet      A number affected to the IP packet (traces only)
+ * @param header          The PCAP header for the frame
+ * @param packet          The frame (link layer included)
+ * @param link_len        The length of the link layer header before IP data
+ * @param[out] ip_packet  The IP packet within the frame
+ * @return                true if the IP packet was found, false otherwise
+ */
+static bool get_ip_packet(const unsigned long num_packet,
+                          const struct pcap_pkthdr header,
+                          unsigned char *const packet,
+                          const size_t link_len,
+                          struct rohc_buf *const ip_packet)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const struct rohc_buf frame =
+		rohc_buf_init_full(packet, header.caplen, arrival_time);
+
+	*ip_packet = frame;
+
 	/* check Ethernet frame length */
 	if(header.len <= link_len || header.len != header.caplen)
 	{
 		fprintf(stderr, "packet %lu: bad PCAP packet (len = %u, caplen = %u)\n",
 		        num_packet, header.len, header.caplen);
-		goto error;
+		return false;
 	}
 
 	/* skip the link layer header */
-	rohc_buf_pull(&ip_packet, link_len);
+	rohc_buf_pull(ip_packet, link_len);
 
 	/* check for padding after the IP packet in the Ethernet payload */
 	if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
@@ -554,165 +888,1669 @@ static int time_compress_packet(struct rohc_comp *comp,
 		uint16_t tot_len;
 
 		/* determine the total length of the IP packet */
-		ip_version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
+		ip_version = (rohc_buf_byte(*ip_packet) >> 4) & 0x0f;
 		if(ip_version == 4) /* IPv4 */
 		{
 			struct ipv4_hdr *ip;
 
-			ip = (struct ipv4_hdr *) rohc_buf_data(ip_packet);
+			ip = (struct ipv4_hdr *) rohc_buf_data(*ip_packet);
 			tot_len = ntohs(ip->tot_len);
 		}
 		else if(ip_version == 6) /* IPv6 */
 		{
 			struct ipv6_hdr *ip;
 
-			ip = (struct ipv6_hdr *) rohc_buf_data(ip_packet);
+			ip = (struct ipv6_hdr *) rohc_buf_data(*ip_packet);
 			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
 		}
 		else /* unknown IP version */
 		{
 			fprintf(stderr, "packet %lu: bad IP version (0x%x) "
 			        "in packet\n", num_packet, ip_version);
-			goto error;
+			return false;
 		}
 
 		/* update the length of the IP packet if padding is present */
-		if(tot_len < ip_packet.len)
+		if(tot_len < ip_packet->len)
 		{
 			fprintf(stderr, "packet %lu: the Ethernet frame has %zu "
 			        "bytes of padding after the %u-byte IP packet!\n",
-			        num_packet, ip_packet.len - tot_len, tot_len);
-			ip_packet.len = tot_len;
+			        num_packet, ip_packet->len - tot_len, tot_len);
+			ip_packet->len = tot_len;
 		}
 	}
 
-	/* compress the packet */
-	status = rohc_compress4(comp, ip_packet, &rohc_packet);
-	if(status != ROHC_STATUS_OK)
-	{
-		fprintf(stderr, "packet %lu: compression failed\n", num_packet);
-		goto error;
-	}
-
-	/* everything went fine */
-	is_failure = 0;
-
-error:
-	return is_failure;
+	return true;
 }
 
 
 /**
- * @brief Test the decompression performance of the ROHC library
- *        with a flow of IP packets
+ * @brief Test the performance of the context lookup of the ROHC compressor
+ *        with many simultaneous IPv4/UDP flows
  *
  * @param is_verbose    Whether the test is run in verbose mode or not
- * @param filename      The name of the PCAP file that contains the ROHC packets
- * @param cid_type      The type of CIDs the decompressor shall use
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
  * @param max_contexts  The maximum number of ROHC contexts to use
- * @param packet_count  OUT: the number of decompressed packets, undefined if
- *                      decompression failed
+ * @param flows_nr      The number of simultaneous flows to compress
+ * @param packet_count  OUT: the number of compressed packets, undefined if
+ *                      compression failed
  * @return              0 in case of success, 1 otherwise
  */
-static int test_decompression_perfs(const bool is_verbose,
-                                    char *filename,
-                                    const rohc_cid_type_t cid_type,
-                                    const size_t max_contexts,
-                                    unsigned long *packet_count)
+static int test_ctxt_lookup_perfs(const bool is_verbose,
+                                  const rohc_cid_type_t cid_type,
+                                  const size_t wlsb_width,
+                                  const size_t max_contexts,
+                                  const size_t flows_nr,
+                                  unsigned long *packet_count)
 {
+	/* enough packets to reach the SO state, then about 1M timed packets */
+	const size_t warmup_rounds = 10;
+	const size_t timed_packets_nr = 1000 * 1000;
+	const size_t timed_rounds =
+		(timed_packets_nr + flows_nr - 1) / flows_nr;
 	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
-	pcap_t *handle;
-	char errbuf[PCAP_ERRBUF_SIZE];
-	int link_layer_type;
-	size_t link_len;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
-	struct rohc_decomp *decomp;
+	const size_t payload_len = 20;
+	const size_t pkt_len =
+		sizeof(struct ipv4_hdr) + sizeof(struct udphdr) + payload_len;
+	uint8_t *packets;
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	struct rohc_comp *comp;
+	struct timespec start;
+	struct timespec end;
+	double elapsed_ns;
+	size_t round;
+	size_t i;
 	int is_failure = 1;
-	int ret;
 
-	assert(max_contexts > 0);
+	assert(flows_nr > 0);
+	assert(flows_nr <= max_contexts);
 
-	/* open the PCAP file that contains the stream */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
+	/* build one IPv4/UDP packet per flow, flows differ by their source
+	 * address and port */
+	packets = calloc(flows_nr, pkt_len);
+	if(packets == NULL)
 	{
-		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
+		fprintf(stderr, "failed to allocate memory for %zu packets\n", flows_nr);
 		goto exit;
 	}
-
-	/* link layer in the capture must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW)
+	for(i = 0; i < flows_nr; i++)
 	{
-		fprintf(stderr, "link layer type %d not supported in capture "
-		        "(supported = %d, %d, %d)\n", link_layer_type,
-		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
-		goto close_input;
+		struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) (packets + i * pkt_len);
+		struct udphdr *const udp = (struct udphdr *) (ipv4 + 1);
+
+		ipv4->version = 4;
+		ipv4->ihl = 5;
+		ipv4->tos = 0;
+		ipv4->tot_len = htons(pkt_len);
+		ipv4->id = 0;
+		ipv4->frag_off = 0;
+		ipv4->ttl = 64;
+		ipv4->protocol = IPPROTO_UDP;
+		ipv4->check = 0; /* IP checksum not computed, useless for the test */
+		ipv4->saddr = htonl(0x0a000000 + i);
+		ipv4->daddr = htonl(0xc0a80001);
+
+		udp->source = htons(1024 + (i % 60000));
+		udp->dest = htons(4242);
+		udp->len = htons(sizeof(struct udphdr) + payload_len);
+		udp->check = 0; /* UDP checksum disabled */
 	}
 
-	if(link_layer_type == DLT_EN10MB)
+	/* create ROHC compressor */
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
+	if(comp == NULL)
 	{
-		link_len = ETHER_HDR_LEN;
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto free_packets;
 	}
-	else if(link_layer_type == DLT_LINUX_SLL)
+
+	/* set the callback for traces */
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, (void *) &is_verbose))
 	{
-		link_len = LINUX_COOKED_HDR_LEN;
+		fprintf(stderr, "failed to set the callback for traces\n");
+		goto free_compresssor;
 	}
-	else /* DLT_RAW */
+
+	/* activate the IP-only and IP/UDP compression profiles */
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
 	{
-		link_len = 0;
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto free_compresssor;
 	}
 
-	/* create ROHC decompressor */
-	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
-	if(decomp == NULL)
+	/* set the WLSB window width on compressor */
+	if(!rohc_comp_set_wlsb_window_width(comp, wlsb_width))
 	{
-		fprintf(stderr, "cannot create the ROHC decompressor\n");
-		goto close_input;
+		fprintf(stderr, "failed to set the WLSB window width on compressor\n");
+		goto free_compresssor;
 	}
 
-	/* set trace callback for decompressor in verbose mode */
-	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, (void *) &is_verbose))
+	/* create all the contexts and bring them to the SO state, then compress
+	 * the packets of all flows in round-robin */
+	*packet_count = 0;
+	for(round = 0; round < (warmup_rounds + timed_rounds); round++)
 	{
-		fprintf(stderr, "cannot set trace callback for decompressor\n");
-		goto free_decompressor;
+		if(round == warmup_rounds)
+		{
+			clock_gettime(CLOCK_MONOTONIC, &start);
+		}
+
+		for(i = 0; i < flows_nr; i++)
+		{
+			const struct rohc_buf ip_packet =
+				rohc_buf_init_full(packets + i * pkt_len, pkt_len, arrival_time);
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+
+			if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "flow %zu: compression failed\n", i);
+				goto free_compresssor;
+			}
+			(*packet_count)++;
+		}
 	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
 
-	/* activate all the decompression profiles */
-	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
-	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
-	                                ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
-	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+	fprintf(stderr, "lookup: %zu flows, %zu timed packets, %.1f ns/packet\n",
+	        flows_nr, timed_rounds * flows_nr,
+	        elapsed_ns / (timed_rounds * flows_nr));
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_compresssor:
+	rohc_comp_free(comp);
+free_packets:
+	free(packets);
+exit:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compare the compression performance of the ROHC library packet per
+ *        packet and by bursts of packets
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param filename      The name of the PCAP file that contains the IP packets
+ * @param cid_type      The type of CIDs the compressors shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param packet_count  OUT: the number of packets compressed by every
+ *                      compressor, undefined if compression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_burst_perfs(const bool is_verbose,
+                            char *filename,
+                            const rohc_cid_type_t cid_type,
+                            const size_t wlsb_width,
+                            const size_t max_contexts,
+                            unsigned long *packet_count)
+{
+	/* compress the capture enough times for about 100k timed packets */
+	const size_t timed_packets_nr = 100 * 1000;
+	const size_t burst_max = BURST_MAX_PACKETS;
+	bool verbose = is_verbose;
+	struct rohc_buf *packets;
+	size_t packets_nr;
+	uint8_t *rohc_buffers;
+	struct rohc_buf single_packets[BURST_MAX_PACKETS];
+	struct rohc_buf burst_packets[BURST_MAX_PACKETS];
+	rohc_status_t statuses[BURST_MAX_PACKETS];
+	double single_ns = 0;
+	double burst_ns = 0;
+	size_t rounds_nr;
+	size_t round;
+	int is_failure = 1;
+
+	assert(max_contexts > 0);
+
+	/* load all the packets of the capture in memory */
+	if(!load_capture(filename, &packets, &packets_nr))
 	{
-		fprintf(stderr, "failed to enable the decompression profiles\n");
-		goto free_decompressor;
+		goto exit;
+	}
+	if(packets_nr == 0)
+	{
+		fprintf(stderr, "no packet in capture\n");
+		goto free_packets;
 	}
+	rounds_nr = (timed_packets_nr + packets_nr - 1) / packets_nr;
 
-	fflush(stderr);
+	/* the ROHC packets of both compressors */
+	rohc_buffers = malloc(2 * burst_max * MAX_ROHC_SIZE);
+	if(rohc_buffers == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for ROHC packets\n");
+		goto free_packets;
+	}
 
-	/* for each packet in the dump */
 	*packet_count = 0;
-	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	for(round = 0; round < rounds_nr; round++)
 	{
-		(*packet_count)++;
-		if((*packet_count) != 0 && ((*packet_count) % 100000) == 0)
+		struct rohc_comp *single_comp;
+		struct rohc_comp *burst_comp;
+		size_t first;
+
+		/* compress the capture with new compressors every time */
+		single_comp = create_perf_compressor(&verbose, cid_type, wlsb_width,
+		                                     max_contexts);
+		if(single_comp == NULL)
 		{
-			fprintf(stderr, "decompression: packet #%lu\r", *packet_count);
-			fflush(stderr);
+			goto free_buffers;
+		}
+		burst_comp = create_perf_compressor(&verbose, cid_type, wlsb_width,
+		                                    max_contexts);
+		if(burst_comp == NULL)
+		{
+			rohc_comp_free(single_comp);
+			goto free_buffers;
 		}
 
-		/* decompress the ROHC packet */
-		ret = time_decompress_packet(decomp, *packet_count,
-		                             header, packet, link_len, arrival_time);
-		if(ret != 0)
+		for(first = 0; first < packets_nr; first += burst_max)
 		{
-			fprintf(stderr, "packet %lu: performance test failed\n",
-			        *packet_count);
-			goto free_decompressor;
+			const size_t nr = (packets_nr - first < burst_max ?
+			                   packets_nr - first : burst_max);
+			struct timespec start;
+			struct timespec end;
+			size_t compressed_nr;
+			size_t i;
+
+			for(i = 0; i < nr; i++)
+			{
+				const struct rohc_buf single_packet =
+					rohc_buf_init_empty(rohc_buffers + i * MAX_ROHC_SIZE,
+					                    MAX_ROHC_SIZE);
+				const struct rohc_buf burst_packet =
+					rohc_buf_init_empty(rohc_buffers + (burst_max + i) * MAX_ROHC_SIZE,
+					                    MAX_ROHC_SIZE);
+
+				single_packets[i] = single_packet;
+				burst_packets[i] = burst_packet;
+			}
+
+			/* compress the packets one by one */
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			for(i = 0; i < nr; i++)
+			{
+				statuses[i] = rohc_compress4(single_comp, packets[first + i],
+				                             &single_packets[i]);
+			}
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			single_ns += (end.tv_sec - start.tv_sec) * 1e9 +
+			             (end.tv_nsec - start.tv_nsec);
+			for(i = 0; i < nr; i++)
+			{
+				if(statuses[i] != ROHC_STATUS_OK)
+				{
+					fprintf(stderr, "packet %zu: compression failed\n",
+					        first + i + 1);
+					goto free_compressors;
+				}
+			}
+
+			/* compress the packets as one burst */
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			compressed_nr = rohc_compress_burst(burst_comp, packets + first,
+			                                    burst_packets, statuses, nr);
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			burst_ns += (end.tv_sec - start.tv_sec) * 1e9 +
+			            (end.tv_nsec - start.tv_nsec);
+			if(compressed_nr != nr)
+			{
+				fprintf(stderr, "packets %zu-%zu: burst compression failed for "
+				        "%zu packets\n", first + 1, first + nr, nr - compressed_nr);
+				goto free_compressors;
+			}
+
+			/* both ways of compressing shall produce the same ROHC packets */
+			if(round == 0)
+			{
+				for(i = 0; i < nr; i++)
+				{
+					if(burst_packets[i].len != single_packets[i].len ||
+					   memcmp(rohc_buf_data(burst_packets[i]),
+					          rohc_buf_data(single_packets[i]),
+					          single_packets[i].len) != 0)
+					{
+						fprintf(stderr, "packet %zu: burst compression does not "
+						        "produce the same ROHC packet\n", first + i + 1);
+						goto free_compressors;
+					}
+				}
+			}
 		}
+
+		rohc_comp_free(burst_comp);
+		rohc_comp_free(single_comp);
+		*packet_count += packets_nr;
+		continue;
+
+free_compressors:
+		rohc_comp_free(burst_comp);
+		rohc_comp_free(single_comp);
+		goto free_buffers;
+	}
+
+	fprintf(stderr, "burst: %zu packets in capture, %zu rounds\n",
+	        packets_nr, rounds_nr);
+	fprintf(stderr, "burst: packet per packet: %.1f ns/packet\n",
+	        single_ns / (*packet_count));
+	fprintf(stderr, "burst: bursts of %zu packets: %.1f ns/packet\n",
+	        burst_max, burst_ns / (*packet_count));
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_buffers:
+	free(rohc_buffers);
+free_packets:
+	free_capture(packets, packets_nr);
+exit:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compare the compression performance of the ROHC library with
+ *        several widths of the WLSB window
+ *
+ * The WLSB widths are all the powers of 2 from \ref WLSB_WIDTH_MIN to
+ * \ref WLSB_WIDTH_MAX.
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param filename      The name of the PCAP file that contains the IP packets
+ * @param cid_type      The type of CIDs the compressors shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param packet_count  OUT: the number of packets compressed for all the
+ *                      WLSB widths, undefined if compression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_wlsb_perfs(const bool is_verbose,
+                           char *filename,
+                           const rohc_cid_type_t cid_type,
+                           const size_t max_contexts,
+                           unsigned long *packet_count)
+{
+	/* compress the capture enough times for about 100k timed packets
+	 * with every WLSB width */
+	const size_t timed_packets_nr = 100 * 1000;
+	bool verbose = is_verbose;
+	struct rohc_buf *packets;
+	size_t packets_nr;
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	size_t wlsb_width;
+	size_t rounds_nr;
+	int is_failure = 1;
+
+	assert(max_contexts > 0);
+
+	/* load all the packets of the capture in memory */
+	if(!load_capture(filename, &packets, &packets_nr))
+	{
+		goto exit;
+	}
+	if(packets_nr == 0)
+	{
+		fprintf(stderr, "no packet in capture\n");
+		goto free_packets;
+	}
+	rounds_nr = (timed_packets_nr + packets_nr - 1) / packets_nr;
+	fprintf(stderr, "wlsb: %zu packets in capture, %zu rounds per width\n",
+	        packets_nr, rounds_nr);
+
+	*packet_count = 0;
+	for(wlsb_width = WLSB_WIDTH_MIN; wlsb_width <= WLSB_WIDTH_MAX;
+	    wlsb_width *= 2)
+	{
+		double elapsed_ns = 0;
+		size_t round;
+
+		for(round = 0; round < rounds_nr; round++)
+		{
+			struct rohc_comp *comp;
+			struct timespec start;
+			struct timespec end;
+			size_t i;
+
+			/* compress the capture with a new compressor every time */
+			comp = create_perf_compressor(&verbose, cid_type, wlsb_width,
+			                              max_contexts);
+			if(comp == NULL)
+			{
+				goto free_packets;
+			}
+
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			for(i = 0; i < packets_nr; i++)
+			{
+				struct rohc_buf rohc_packet =
+					rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+
+				if(rohc_compress4(comp, packets[i], &rohc_packet) != ROHC_STATUS_OK)
+				{
+					fprintf(stderr, "WLSB width %zu: packet %zu: compression "
+					        "failed\n", wlsb_width, i + 1);
+					rohc_comp_free(comp);
+					goto free_packets;
+				}
+			}
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			elapsed_ns += (end.tv_sec - start.tv_sec) * 1e9 +
+			              (end.tv_nsec - start.tv_nsec);
+
+			rohc_comp_free(comp);
+		}
+
+		fprintf(stderr, "wlsb: width %3zu: %.1f ns/packet\n", wlsb_width,
+		        elapsed_ns / (rounds_nr * packets_nr));
+		*packet_count += rounds_nr * packets_nr;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_packets:
+	free_capture(packets, packets_nr);
+exit:
+	return is_failure;
+}
+
+
+#if HAVE_PTHREAD_H == 1
+
+/**
+ * @brief Measure the scaling of compression with the number of threads
+ *
+ * For every number of threads from 1 to \e threads_nr, a pool of as many
+ * compressors is created and every shard of the pool compresses all the
+ * packets of the capture in its own thread. The throughput of the pool is
+ * the sum of the throughputs of its threads.
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param filename      The name of the PCAP file that contains the IP packets
+ * @param cid_type      The type of CIDs the pools shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts of every pool,
+ *                      shared by its shards
+ * @param threads_nr    The largest number of threads
+ * @param loops_nr      The number of times every thread compresses the
+ *                      capture
+ * @param packet_count  OUT: the number of packets compressed by all the
+ *                      threads, undefined if compression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_pool_perfs(const bool is_verbose,
+                           char *filename,
+                           const rohc_cid_type_t cid_type,
+                           const size_t wlsb_width,
+                           const size_t max_contexts,
+                           const size_t threads_nr,
+                           const size_t loops_nr,
+                           unsigned long *packet_count)
+{
+	const size_t measured_loops_nr = (loops_nr > 1 ? loops_nr - 1 : 1);
+	bool verbose = is_verbose;
+	struct pool_thread *threads;
+	struct rohc_buf *packets;
+	size_t packets_nr;
+	size_t shards_nr;
+	int is_failure = 1;
+
+	assert(max_contexts > 0);
+	assert(threads_nr > 0 && threads_nr <= max_contexts);
+	assert(loops_nr > 0);
+
+	/* load all the packets of the capture in memory, they are shared by all
+	 * the threads */
+	if(!load_capture(filename, &packets, &packets_nr))
+	{
+		goto exit;
+	}
+	if(packets_nr == 0)
+	{
+		fprintf(stderr, "no packet in capture\n");
+		goto free_packets;
+	}
+	fprintf(stderr, "pool: %zu packets in capture, %zu measured loops per "
+	        "thread\n", packets_nr, measured_loops_nr);
+
+	threads = calloc(threads_nr, sizeof(struct pool_thread));
+	if(threads == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu threads\n",
+		        threads_nr);
+		goto free_packets;
+	}
+
+	*packet_count = 0;
+	for(shards_nr = 1; shards_nr <= threads_nr; shards_nr++)
+	{
+		struct rohc_comp_pool *pool;
+		double packets_per_sec = 0;
+		size_t started_nr;
+		size_t i;
+
+		pool = rohc_comp_pool_new(cid_type, max_contexts - 1, shards_nr,
+		                          gen_false_random_num, NULL);
+		if(pool == NULL)
+		{
+			fprintf(stderr, "cannot create a pool of %zu compressors\n",
+			        shards_nr);
+			goto free_threads;
+		}
+		for(i = 0; i < shards_nr; i++)
+		{
+			threads[i].shard = rohc_comp_pool_get_shard(pool, i);
+			if(!setup_perf_compressor(threads[i].shard, &verbose, wlsb_width))
+			{
+				goto free_pool;
+			}
+			threads[i].packets = packets;
+			threads[i].packets_nr = packets_nr;
+			threads[i].loops_nr = loops_nr;
+		}
+
+		/* compress on all the shards at once */
+		for(started_nr = 0; started_nr < shards_nr; started_nr++)
+		{
+			if(pthread_create(&threads[started_nr].thread, NULL, run_pool_thread,
+			                  &threads[started_nr]) != 0)
+			{
+				fprintf(stderr, "failed to start thread #%zu\n", started_nr + 1);
+				break;
+			}
+		}
+		for(i = 0; i < started_nr; i++)
+		{
+			pthread_join(threads[i].thread, NULL);
+		}
+		if(started_nr != shards_nr)
+		{
+			goto free_pool;
+		}
+
+		for(i = 0; i < shards_nr; i++)
+		{
+			if(!threads[i].is_success)
+			{
+				fprintf(stderr, "%zu threads: compression failed in thread "
+				        "#%zu\n", shards_nr, i + 1);
+				goto free_pool;
+			}
+			packets_per_sec += (packets_nr * measured_loops_nr) /
+			                   (threads[i].elapsed_ns / 1e9);
+		}
+		fprintf(stderr, "pool: %2zu thread(s): %.0f packets/s, %.0f packets/s "
+		        "per thread\n", shards_nr, packets_per_sec,
+		        packets_per_sec / shards_nr);
+		*packet_count += shards_nr * packets_nr * loops_nr;
+
+		rohc_comp_pool_free(pool);
+		continue;
+
+free_pool:
+		rohc_comp_pool_free(pool);
+		goto free_threads;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_threads:
+	free(threads);
+free_packets:
+	free_capture(packets, packets_nr);
+exit:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress the capture with one shard of a pool for the 'pool' test
+ *
+ * The first loop is not measured if there are several loops.
+ *
+ * @param arg  The thread, as a \ref pool_thread
+ * @return     Always NULL, the result is stored in the \ref pool_thread
+ */
+static void * run_pool_thread(void *const arg)
+{
+	struct pool_thread *const thread = (struct pool_thread *) arg;
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	struct timespec start;
+	struct timespec end;
+	size_t loop;
+
+	thread->is_success = false;
+	thread->elapsed_ns = 0;
+
+	for(loop = 0; loop < thread->loops_nr; loop++)
+	{
+		size_t i;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for(i = 0; i < thread->packets_nr; i++)
+		{
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+
+			if(rohc_compress4(thread->shard, thread->packets[i],
+			                  &rohc_packet) != ROHC_STATUS_OK)
+			{
+				goto error;
+			}
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		if(loop > 0 || thread->loops_nr == 1)
+		{
+			thread->elapsed_ns += (end.tv_sec - start.tv_sec) * 1e9 +
+			                      (end.tv_nsec - start.tv_nsec);
+		}
+	}
+
+	thread->is_success = true;
+
+error:
+	return NULL;
+}
+
+#endif
+
+
+/**
+ * @brief Load all the IP packets of the given capture in memory
+ *
+ * @param filename         The name of the PCAP file that contains the packets
+ * @param[out] packets     The IP packets of the capture, to be freed with
+ *                         \ref free_capture
+ * @param[out] packets_nr  The number of IP packets in the capture
+ * @return                 true if the capture was loaded, false otherwise
+ */
+static bool load_capture(char *filename,
+                         struct rohc_buf **const packets,
+                         size_t *const packets_nr)
+{
+	pcap_t *handle;
+	char errbuf[PCAP_ERRBUF_SIZE];
+	int link_layer_type;
+	size_t link_len;
+	struct pcap_pkthdr header;
+	unsigned char *packet;
+	size_t packets_max = 0;
+	bool is_success = false;
+
+	*packets = NULL;
+	*packets_nr = 0;
+
+	/* open the PCAP file that contains the stream */
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
+		goto exit;
+	}
+
+	/* link layer in the capture must be Ethernet */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type != DLT_EN10MB &&
+	   link_layer_type != DLT_LINUX_SLL &&
+	   link_layer_type != DLT_RAW)
+	{
+		fprintf(stderr, "link layer type %d not supported in capture "
+		        "(supported = %d, %d, %d)\n", link_layer_type,
+		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
+		goto close_input;
+	}
+
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else /* DLT_RAW */
+	{
+		link_len = 0;
+	}
+
+	/* copy every IP packet of the capture */
+	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	{
+		struct rohc_buf ip_packet;
+		uint8_t *data;
+
+		if(!get_ip_packet((*packets_nr) + 1, header, packet, link_len,
+		                  &ip_packet))
+		{
+			goto free_packets;
+		}
+
+		if((*packets_nr) == packets_max)
+		{
+			struct rohc_buf *new_packets;
+
+			packets_max = (packets_max == 0 ? 1024 : packets_max * 2);
+			new_packets = realloc(*packets, packets_max * sizeof(struct rohc_buf));
+			if(new_packets == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for %zu packets\n",
+				        packets_max);
+				goto free_packets;
+			}
+			*packets = new_packets;
+		}
+
+		data = malloc(ip_packet.len);
+		if(data == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for packet %zu\n",
+			        (*packets_nr) + 1);
+			goto free_packets;
+		}
+		memcpy(data, rohc_buf_data(ip_packet), ip_packet.len);
+		ip_packet.data = data;
+		ip_packet.max_len = ip_packet.len;
+		ip_packet.offset = 0;
+		(*packets)[*packets_nr] = ip_packet;
+		(*packets_nr)++;
+	}
+
+	is_success = true;
+
+free_packets:
+	if(!is_success)
+	{
+		free_capture(*packets, *packets_nr);
+		*packets = NULL;
+		*packets_nr = 0;
+	}
+close_input:
+	pcap_close(handle);
+exit:
+	return is_success;
+}
+
+
+/**
+ * @brief Free the IP packets loaded by \ref load_capture
+ *
+ * @param packets     The IP packets to free
+ * @param packets_nr  The number of IP packets
+ */
+static void free_capture(struct rohc_buf *const packets,
+                         const size_t packets_nr)
+{
+	size_t i;
+
+	for(i = 0; i < packets_nr; i++)
+	{
+		free(packets[i].data);
+	}
+	free(packets);
+}
+
+
+/**
+ * @brief Create a compressor with all profiles enabled for the performance
+ *        tests
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @return              The new compressor, NULL in case of error
+ */
+static struct rohc_comp * create_perf_compressor(bool *const is_verbose,
+                                                 const rohc_cid_type_t cid_type,
+                                                 const size_t wlsb_width,
+                                                 const size_t max_contexts)
+{
+	struct rohc_comp *comp;
+
+	/* create ROHC compressor */
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+
+	if(!setup_perf_compressor(comp, is_verbose, wlsb_width))
+	{
+		goto free_compressor;
+	}
+
+	return comp;
+
+free_compressor:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Configure a compressor for the performance tests
+ *
+ * All profiles are enabled, and the RTP detection callback is set.
+ *
+ * @param comp          The compressor to configure
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param wlsb_width    The width of the WLSB window to use
+ * @return              true if the compressor was configured,
+ *                      false otherwise
+ */
+static bool setup_perf_compressor(struct rohc_comp *const comp,
+                                  bool *const is_verbose,
+                                  const size_t wlsb_width)
+{
+	/* set the callback for traces */
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, (void *) is_verbose))
+	{
+		fprintf(stderr, "failed to set the callback for traces\n");
+		goto error;
+	}
+
+	/* activate all the compression profiles */
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                              ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto error;
+	}
+
+	/* set the WLSB window width on compressor */
+	if(!rohc_comp_set_wlsb_window_width(comp, wlsb_width))
+	{
+		fprintf(stderr, "failed to set the WLSB window width on compressor\n");
+		goto error;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback on compressor\n");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Measure the steady-state performance of the ROHC library by
+ *        replaying a capture mapped in memory
+ *
+ * Every replay compresses all the packets of the capture, then decompresses
+ * all the ROHC packets. The throughput and the CPU cycles are measured over
+ * these whole loops, the time of every call is measured for the latency
+ * percentiles only. The first replay of the capture is not measured if the
+ * capture is replayed several times.
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param filename      The name of the PCAP file that contains the IP packets
+ * @param cid_type      The type of CIDs the (de)compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param loops_nr      The number of times the capture is replayed
+ * @param packet_count  OUT: the number of packets compressed and decompressed,
+ *                      undefined if (de)compression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_replay_perfs(const bool is_verbose,
+                             char *filename,
+                             const rohc_cid_type_t cid_type,
+                             const size_t wlsb_width,
+                             const size_t max_contexts,
+                             const size_t loops_nr,
+                             unsigned long *packet_count)
+{
+	const size_t measured_loops_nr = (loops_nr > 1 ? loops_nr - 1 : 1);
+	bool verbose = is_verbose;
+	struct mapped_capture capture;
+	struct replay_measures comp_measures;
+	struct replay_measures decomp_measures;
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	struct rohc_buf *rohc_packets;
+	struct rohc_buf *ip_packets;
+	uint8_t *rohc_buffer;
+	uint8_t *ip_buffer;
+	size_t rohc_buffer_len;
+	size_t ip_buffer_len;
+	uint64_t hdr_bytes = 0;
+	size_t loop;
+	int is_failure = 1;
+
+	assert(max_contexts > 0);
+	assert(loops_nr > 0);
+
+	memset(&comp_measures, 0, sizeof(struct replay_measures));
+	memset(&decomp_measures, 0, sizeof(struct replay_measures));
+
+	/* map the capture in memory and index all its packets */
+	if(!map_capture(filename, &capture))
+	{
+		goto exit;
+	}
+	if(capture.packets_nr == 0)
+	{
+		fprintf(stderr, "no packet in capture\n");
+		goto unmap;
+	}
+
+	/* the ROHC packets and the decompressed IP packets of one replay are
+	 * stored one after the other, so that all the packets are compressed
+	 * before the first one is decompressed: the ROHC packets are given twice
+	 * the size of the capture, the decompressed IP packets are as large as
+	 * the IP packets of the capture */
+	rohc_packets = calloc(capture.packets_nr, sizeof(struct rohc_buf));
+	if(rohc_packets == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for ROHC packets\n");
+		goto unmap;
+	}
+	ip_packets = calloc(capture.packets_nr, sizeof(struct rohc_buf));
+	if(ip_packets == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for IP packets\n");
+		goto free_rohc_packets;
+	}
+	rohc_buffer_len = 2 * capture.len + MAX_ROHC_SIZE;
+	rohc_buffer = malloc(rohc_buffer_len);
+	if(rohc_buffer == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for ROHC packets\n");
+		goto free_ip_packets;
+	}
+	ip_buffer_len = capture.len + capture.max_packet_len + MAX_ROHC_SIZE;
+	ip_buffer = malloc(ip_buffer_len);
+	if(ip_buffer == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for IP packets\n");
+		goto free_rohc_buffer;
+	}
+
+	/* the latencies of all the measured packets */
+	comp_measures.latencies =
+		calloc(capture.packets_nr * measured_loops_nr, sizeof(uint32_t));
+	decomp_measures.latencies =
+		calloc(capture.packets_nr * measured_loops_nr, sizeof(uint32_t));
+	if(comp_measures.latencies == NULL || decomp_measures.latencies == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the latencies of %zu "
+		        "packets\n", capture.packets_nr * measured_loops_nr);
+		goto free_latencies;
+	}
+
+	/* create the ROHC compressor and decompressor */
+	comp = create_perf_compressor(&verbose, cid_type, wlsb_width, max_contexts);
+	if(comp == NULL)
+	{
+		goto free_latencies;
+	}
+	decomp = create_perf_decompressor(&verbose, cid_type, max_contexts);
+	if(decomp == NULL)
+	{
+		goto free_compressor;
+	}
+
+	fflush(stderr);
+
+	*packet_count = 0;
+	for(loop = 0; loop < loops_nr; loop++)
+	{
+		const bool is_measured = (loops_nr == 1 || loop > 0);
+		struct timespec loop_start;
+		struct timespec loop_end;
+		uint64_t loop_cycles;
+		size_t offset;
+		size_t i;
+
+		/* compress all the IP packets */
+		offset = 0;
+		clock_gettime(CLOCK_MONOTONIC, &loop_start);
+		loop_cycles = read_cpu_cycles();
+		for(i = 0; i < capture.packets_nr; i++)
+		{
+			const struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer + offset, rohc_buffer_len - offset);
+			struct timespec start;
+			struct timespec end;
+			rohc_status_t status;
+
+			rohc_packets[i] = rohc_packet;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			status = rohc_compress4(comp, capture.packets[i], &rohc_packets[i]);
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "loop %zu: packet %zu: compression failed\n",
+				        loop + 1, i + 1);
+				goto free_decompressor;
+			}
+			offset += rohc_packets[i].len;
+
+			/* the lengths of the uncompressed headers are the same for every
+			 * replay, they are retrieved during the first one only */
+			if(loop == 0)
+			{
+				rohc_comp_last_packet_info2_t last_packet_info;
+
+				memset(&last_packet_info, 0,
+				       sizeof(rohc_comp_last_packet_info2_t));
+				last_packet_info.version_major = 0;
+				last_packet_info.version_minor = 0;
+				if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
+				{
+					fprintf(stderr, "loop %zu: packet %zu: failed to get "
+					        "information about the compressed packet\n",
+					        loop + 1, i + 1);
+					goto free_decompressor;
+				}
+				hdr_bytes += last_packet_info.header_last_uncomp_size;
+			}
+
+			if(is_measured)
+			{
+				replay_measures_add(&comp_measures, start, end);
+			}
+		}
+		loop_cycles = read_cpu_cycles() - loop_cycles;
+		clock_gettime(CLOCK_MONOTONIC, &loop_end);
+		if(is_measured)
+		{
+			replay_measures_add_loop(&comp_measures, loop_start, loop_end,
+			                         loop_cycles, hdr_bytes);
+		}
+
+		/* decompress all the ROHC packets */
+		offset = 0;
+		clock_gettime(CLOCK_MONOTONIC, &loop_start);
+		loop_cycles = read_cpu_cycles();
+		for(i = 0; i < capture.packets_nr; i++)
+		{
+			const struct rohc_buf ip_packet =
+				rohc_buf_init_empty(ip_buffer + offset, ip_buffer_len - offset);
+			struct timespec start;
+			struct timespec end;
+			rohc_status_t status;
+
+			ip_packets[i] = ip_packet;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			status = rohc_decompress3(decomp, rohc_packets[i], &ip_packets[i],
+			                          NULL, NULL);
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "loop %zu: packet %zu: decompression failed\n",
+				        loop + 1, i + 1);
+				goto free_decompressor;
+			}
+			offset += ip_packets[i].len;
+
+			if(is_measured)
+			{
+				replay_measures_add(&decomp_measures, start, end);
+			}
+		}
+		loop_cycles = read_cpu_cycles() - loop_cycles;
+		clock_gettime(CLOCK_MONOTONIC, &loop_end);
+		if(is_measured)
+		{
+			replay_measures_add_loop(&decomp_measures, loop_start, loop_end,
+			                         loop_cycles, hdr_bytes);
+		}
+
+		/* the decompressed packets shall be the original ones */
+		for(i = 0; loop == 0 && i < capture.packets_nr; i++)
+		{
+			if(ip_packets[i].len != capture.packets[i].len ||
+			   memcmp(rohc_buf_data(ip_packets[i]),
+			          rohc_buf_data(capture.packets[i]), ip_packets[i].len) != 0)
+			{
+				fprintf(stderr, "loop %zu: packet %zu: decompressed packet does "
+				        "not match the original one\n", loop + 1, i + 1);
+				goto free_decompressor;
+			}
+		}
+
+		(*packet_count) += capture.packets_nr;
+	}
+
+	fprintf(stderr, "replay: %zu packets in capture, %zu loops, %zu measured "
+	        "packets\n", capture.packets_nr, loops_nr, comp_measures.nr);
+	print_replay_measures("comp", &comp_measures);
+	print_replay_measures("decomp", &decomp_measures);
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_decompressor:
+	rohc_decomp_free(decomp);
+free_compressor:
+	rohc_comp_free(comp);
+free_latencies:
+	free(decomp_measures.latencies);
+	free(comp_measures.latencies);
+	free(ip_buffer);
+free_rohc_buffer:
+	free(rohc_buffer);
+free_ip_packets:
+	free(ip_packets);
+free_rohc_packets:
+	free(rohc_packets);
+unmap:
+	unmap_capture(&capture);
+exit:
+	return is_failure;
+}
+
+
+/**
+ * @brief Read one 32-bit field of a PCAP file
+ *
+ * @param data        The field to read
+ * @param is_swapped  Whether the PCAP file was written with the other byte
+ *                    order
+ * @return            The value of the field in Host Byte Order
+ */
+static uint32_t read_pcap_u32(const uint8_t *const data,
+                              const bool is_swapped)
+{
+	uint32_t value;
+
+	memcpy(&value, data, sizeof(uint32_t));
+	if(is_swapped)
+	{
+		value = __builtin_bswap32(value);
+	}
+
+	return value;
+}
+
+
+/**
+ * @brief Map the given capture in memory and index all its IP packets
+ *
+ * The IP packets are not copied: they point to the mapping.
+ *
+ * @param filename      The name of the PCAP file that contains the packets
+ * @param[out] capture  The capture mapped in memory, to be released with
+ *                      \ref unmap_capture
+ * @return              true if the capture was mapped, false otherwise
+ */
+static bool map_capture(char *filename,
+                        struct mapped_capture *const capture)
+{
+	struct stat file_stat;
+	uint32_t magic;
+	uint32_t link_layer_type;
+	bool is_swapped;
+	size_t link_len;
+	size_t packets_max = 0;
+	size_t offset;
+	int fd;
+	bool is_success = false;
+
+	memset(capture, 0, sizeof(struct mapped_capture));
+
+	/* map the whole PCAP file in memory */
+	fd = open(filename, O_RDONLY);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to open the pcap file '%s': %s (%d)\n",
+		        filename, strerror(errno), errno);
+		goto exit;
+	}
+	if(fstat(fd, &file_stat) != 0)
+	{
+		fprintf(stderr, "failed to get the size of the pcap file '%s': %s (%d)\n",
+		        filename, strerror(errno), errno);
+		goto close_file;
+	}
+	if(file_stat.st_size < PCAP_FILE_HDR_LEN)
+	{
+		fprintf(stderr, "pcap file '%s' is too short\n", filename);
+		goto close_file;
+	}
+	capture->len = file_stat.st_size;
+	capture->data = mmap(NULL, capture->len, PROT_READ | PROT_WRITE,
+	                     MAP_PRIVATE, fd, 0);
+	if(capture->data == MAP_FAILED)
+	{
+		fprintf(stderr, "failed to map the pcap file '%s': %s (%d)\n",
+		        filename, strerror(errno), errno);
+		capture->data = NULL;
+		goto close_file;
+	}
+
+	/* the magic number tells the byte order of the PCAP file */
+	memcpy(&magic, capture->data, sizeof(uint32_t));
+	if(magic == 0xa1b2c3d4 || magic == 0xa1b23c4d)
+	{
+		is_swapped = false;
+	}
+	else if(magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1)
+	{
+		is_swapped = true;
+	}
+	else
+	{
+		fprintf(stderr, "file '%s' is not a pcap file (magic = 0x%08x)\n",
+		        filename, magic);
+		goto unmap;
+	}
+
+	/* link layer in the capture must be Ethernet */
+	link_layer_type = read_pcap_u32(capture->data + 20, is_swapped);
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(link_layer_type == PCAP_LINKTYPE_RAW || link_layer_type == DLT_RAW)
+	{
+		link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link layer type %u not supported in capture "
+		        "(supported = %d, %d, %u)\n", link_layer_type,
+		        DLT_EN10MB, DLT_LINUX_SLL, PCAP_LINKTYPE_RAW);
+		goto unmap;
+	}
+
+	/* index every IP packet of the capture */
+	offset = PCAP_FILE_HDR_LEN;
+	while(offset < capture->len)
+	{
+		struct pcap_pkthdr header;
+		struct rohc_buf ip_packet;
+
+		if((capture->len - offset) < PCAP_RECORD_HDR_LEN)
+		{
+			fprintf(stderr, "packet %zu: truncated pcap record header\n",
+			        capture->packets_nr + 1);
+			goto free_packets;
+		}
+		header.ts.tv_sec = read_pcap_u32(capture->data + offset, is_swapped);
+		header.ts.tv_usec = read_pcap_u32(capture->data + offset + 4, is_swapped);
+		header.caplen = read_pcap_u32(capture->data + offset + 8, is_swapped);
+		header.len = read_pcap_u32(capture->data + offset + 12, is_swapped);
+		offset += PCAP_RECORD_HDR_LEN;
+		if(header.caplen > (capture->len - offset))
+		{
+			fprintf(stderr, "packet %zu: truncated pcap record\n",
+			        capture->packets_nr + 1);
+			goto free_packets;
+		}
+
+		if(!get_ip_packet(capture->packets_nr + 1, header, capture->data + offset,
+		                  link_len, &ip_packet))
+		{
+			goto free_packets;
+		}
+		offset += header.caplen;
+
+		if(capture->packets_nr == packets_max)
+		{
+			struct rohc_buf *new_packets;
+
+			packets_max = (packets_max == 0 ? 1024 : packets_max * 2);
+			new_packets = realloc(capture->packets,
+			                      packets_max * sizeof(struct rohc_buf));
+			if(new_packets == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for %zu packets\n",
+				        packets_max);
+				goto free_packets;
+			}
+			capture->packets = new_packets;
+		}
+		capture->packets[capture->packets_nr] = ip_packet;
+		capture->packets_nr++;
+		if(ip_packet.len > capture->max_packet_len)
+		{
+			capture->max_packet_len = ip_packet.len;
+		}
+	}
+
+	is_success = true;
+
+free_packets:
+	if(!is_success)
+	{
+		free(capture->packets);
+		capture->packets = NULL;
+		capture->packets_nr = 0;
+	}
+unmap:
+	if(!is_success)
+	{
+		munmap(capture->data, capture->len);
+		capture->data = NULL;
+	}
+close_file:
+	close(fd);
+exit:
+	return is_success;
+}
+
+
+/**
+ * @brief Release the capture mapped by \ref map_capture
+ *
+ * @param capture  The capture to release
+ */
+static void unmap_capture(struct mapped_capture *const capture)
+{
+	free(capture->packets);
+	capture->packets = NULL;
+	capture->packets_nr = 0;
+	if(capture->data != NULL)
+	{
+		munmap(capture->data, capture->len);
+		capture->data = NULL;
+	}
+}
+
+
+/**
+ * @brief Record the latency of one packet for the 'replay' test
+ *
+ * @param measures  The measures to update
+ * @param start     The time at which the processing of the packet began
+ * @param end       The time at which the processing of the packet ended
+ */
+static void replay_measures_add(struct replay_measures *const measures,
+                                const struct timespec start,
+                                const struct timespec end)
+{
+	const double elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 +
+	                          (end.tv_nsec - start.tv_nsec);
+
+	measures->latencies[measures->nr] =
+		(elapsed_ns > UINT32_MAX ? UINT32_MAX : (uint32_t) elapsed_ns);
+	measures->nr++;
+}
+
+
+/**
+ * @brief Record the measures of one whole loop for the 'replay' test
+ *
+ * @param measures   The measures to update
+ * @param start      The time at which the loop began
+ * @param end        The time at which the loop ended
+ * @param cycles     The CPU cycles spent in the loop
+ * @param hdr_bytes  The bytes of uncompressed headers processed by the loop
+ */
+static void replay_measures_add_loop(struct replay_measures *const measures,
+                                     const struct timespec start,
+                                     const struct timespec end,
+                                     const uint64_t cycles,
+                                     const uint64_t hdr_bytes)
+{
+	measures->total_ns += (end.tv_sec - start.tv_sec) * 1e9 +
+	                      (end.tv_nsec - start.tv_nsec);
+	measures->cycles += cycles;
+	measures->hdr_bytes += hdr_bytes;
+}
+
+
+/**
+ * @brief Print the measures of one operation for the 'replay' test
+ *
+ * The latencies are sorted to compute the percentiles.
+ *
+ * @param name      The name of the operation
+ * @param measures  The measures to print
+ */
+static void print_replay_measures(const char *const name,
+                                  struct replay_measures *const measures)
+{
+	if(measures->nr == 0 || measures->total_ns <= 0)
+	{
+		fprintf(stderr, "replay: %s: no packet measured\n", name);
+		return;
+	}
+
+	qsort(measures->latencies, measures->nr, sizeof(uint32_t), cmp_latencies);
+
+	fprintf(stderr, "replay: %s: %.3f Mpps, %.3f Gbit/s of headers\n", name,
+	        measures->nr * 1e3 / measures->total_ns,
+	        measures->hdr_bytes * 8 / measures->total_ns);
+	fprintf(stderr, "replay: %s: latency p50 = %u ns, p99 = %u ns, "
+	        "p99.9 = %u ns\n", name,
+	        measures->latencies[(measures->nr - 1) * 500 / 1000],
+	        measures->latencies[(measures->nr - 1) * 990 / 1000],
+	        measures->latencies[(measures->nr - 1) * 999 / 1000]);
+	if(measures->cycles > 0)
+	{
+		fprintf(stderr, "replay: %s: %.1f cycles/packet\n", name,
+		        ((double) measures->cycles) / measures->nr);
+	}
+	else
+	{
+		fprintf(stderr, "replay: %s: cycles/packet not available on this "
+		        "platform\n", name);
+	}
+}
+
+
+/**
+ * @brief Compare two latencies for sorting them
+ *
+ * @param latency1  The first latency
+ * @param latency2  The second latency
+ * @return          < 0 if the first latency is smaller than the second one,
+ *                  0 if they are equal, > 0 otherwise
+ */
+static int cmp_latencies(const void *const latency1,
+                         const void *const latency2)
+{
+	const uint32_t value1 = *((const uint32_t *) latency1);
+	const uint32_t value2 = *((const uint32_t *) latency2);
+
+	return (value1 > value2) - (value1 < value2);
+}
+
+
+/**
+ * @brief Read the CPU cycle counter
+ *
+ * @return  The value of the Time Stamp Counter on x86, 0 on other platforms
+ */
+static inline uint64_t read_cpu_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Create a decompressor with all profiles enabled for the performance
+ *        tests
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @return              The new decompressor, NULL in case of error
+ */
+static struct rohc_decomp * create_perf_decompressor(bool *const is_verbose,
+                                                     const rohc_cid_type_t cid_type,
+                                                     const size_t max_contexts)
+{
+	struct rohc_decomp *decomp;
+
+	/* create ROHC decompressor */
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto error;
+	}
+
+	/* set the callback for traces */
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, (void *) is_verbose))
+	{
+		fprintf(stderr, "cannot set trace callback for decompressor\n");
+		goto free_decompressor;
+	}
+
+	/* activate all the decompression profiles */
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                                ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decompressor;
+	}
+
+	return decomp;
+
+free_decompressor:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Test the decompression performance of the ROHC library
+ *        with a flow of IP packets
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param filename      The name of the PCAP file that contains the ROHC packets
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param packet_count  OUT: the number of decompressed packets, undefined if
+ *                      decompression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_decompression_perfs(const bool is_verbose,
+                                    char *filename,
+                                    const rohc_cid_type_t cid_type,
+                                    const size_t max_contexts,
+                                    unsigned long *packet_count)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	pcap_t *handle;
+	char errbuf[PCAP_ERRBUF_SIZE];
+	int link_layer_type;
+	size_t link_len;
+	struct pcap_pkthdr header;
+	unsigned char *packet;
+	struct rohc_decomp *decomp;
+	double elapsed_ns = 0;
+	int is_failure = 1;
+	int ret;
+
+	assert(max_contexts > 0);
+
+	/* open the PCAP file that contains the stream */
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
+		goto exit;
+	}
+
+	/* link layer in the capture must be Ethernet */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type != DLT_EN10MB &&
+	   link_layer_type != DLT_LINUX_SLL &&
+	   link_layer_type != DLT_RAW)
+	{
+		fprintf(stderr, "link layer type %d not supported in capture "
+		        "(supported = %d, %d, %d)\n", link_layer_type,
+		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
+		goto close_input;
+	}
+
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else /* DLT_RAW */
+	{
+		link_len = 0;
+	}
+
+	/* create ROHC decompressor */
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto close_input;
+	}
+
+	/* set trace callback for decompressor in verbose mode */
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, (void *) &is_verbose))
+	{
+		fprintf(stderr, "cannot set trace callback for decompressor\n");
+		goto free_decompressor;
+	}
+
+	/* activate all the decompression profiles */
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                                ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decompressor;
+	}
+
+	fflush(stderr);
+
+	/* for each packet in the dump */
+	*packet_count = 0;
+	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	{
+		(*packet_count)++;
+		if((*packet_count) != 0 && ((*packet_count) % 100000) == 0)
+		{
+			fprintf(stderr, "decompression: packet #%lu\r", *packet_count);
+			fflush(stderr);
+		}
+
+		/* decompress the ROHC packet */
+		ret = time_decompress_packet(decomp, *packet_count, header, packet,
+		                             link_len, arrival_time, &elapsed_ns);
+		if(ret != 0)
+		{
+			fprintf(stderr, "packet %lu: performance test failed\n",
+			        *packet_count);
+			goto free_decompressor;
+		}
+	}
+	if((*packet_count) > 0)
+	{
+		fprintf(stderr, "decomp: %.1f ns/packet\n", elapsed_ns / (*packet_count));
 	}
 
 	/* everything went fine */
@@ -737,6 +2575,9 @@ exit:
  * @param header        The PCAP header for the packet
  * @param packet        The packet to decompress (link layer included)
  * @param link_len      The length of the link layer header before ROHC data
+ * @param arrival_time  The time at which the ROHC packet was received
+ * @param elapsed_ns    IN/OUT: the time elapsed while decompressing packets,
+ *                      increased by the time elapsed for the packet
  * @return              0 if decompression is successful, 1 otherwise
  */
 static int time_decompress_packet(struct rohc_decomp *decomp,
@@ -744,7 +2585,8 @@ static int time_decompress_packet(struct rohc_decomp *decomp,
                                   struct pcap_pkthdr header,
                                   unsigned char *packet,
                                   size_t link_len,
-                                  const struct rohc_ts arrival_time)
+                                  const struct rohc_ts arrival_time,
+                                  double *const elapsed_ns)
 {
 	/* the buffer that will contain the compressed ROHC packet */
 	struct rohc_buf rohc_packet =
@@ -754,6 +2596,8 @@ static int time_decompress_packet(struct rohc_decomp *decomp,
 	uint8_t ip_buffer[MAX_ROHC_SIZE];
 	struct rohc_buf ip_packet = rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
 
+	struct timespec start;
+	struct timespec end;
 	int is_failure = 1;
 	rohc_status_t status;
 
@@ -769,7 +2613,11 @@ static int time_decompress_packet(struct rohc_decomp *decomp,
 	rohc_buf_pull(&rohc_packet, link_len);
 
 	/* decompress the packet */
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	status = rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	*elapsed_ns += (end.tv_sec - start.tv_sec) * 1e9 +
+	               (end.tv_nsec - start.tv_nsec);
 	if(status != ROHC_STATUS_OK)
 	{
 		fprintf(stderr, "packet %lu: decompression failed\n", num_packet);
@@ -271,7 +271,8 @@ static bool compress_with_callback(struct rohc_comp *const compressor,
 	rohc_status_t status;
 
 	/* define the user-defined function that the ROHC compressor shall
-	 * call for every UDP packet in order to detect RTP packets */
+	 * call for the first UDP packet of every flow in order to detect RTP
+	 * streams */
 	printf("\ndefine the RTP detection callback\n");
 //! [set RTP detection callback]
 	if(!rohc_comp_set_rtp_detection_cb(compressor, rtp_detect, NULL))
@@ -29,10 +29,15 @@
 
 #include <linux/module.h>
 #include <linux/slab.h>
+#include <linux/skbuff.h>
+#include <linux/if_ether.h>
+#include <linux/ktime.h>
 #include "config.h"
 #include "rohc.h"
 #include "rohc_comp.h"
 #include "rohc_decomp.h"
+#include "rohc_skb.h"
+#include "rohc_comp_percpu.h"
 
 
 MODULE_VERSION(PACKAGE_VERSION PACKAGE_REVNO);
@@ -42,6 +47,225 @@ MODULE_DESCRIPTION(PACKAGE_NAME
 	", version " PACKAGE_VERSION PACKAGE_REVNO " (" PACKAGE_URL ")");
 
 
+static struct rohc_ts rohc_skb_get_time(const struct sk_buff *const skb);
+
+
+/**
+ * @brief Compress the IP packet of the given socket buffer in place
+ *
+ * Compress the IP packet of the given socket buffer as \ref rohc_compress_sg
+ * does, then replace its uncompressed headers by the ROHC header. The payload
+ * is not copied: the ROHC header is written right in front of it, over the
+ * uncompressed headers, or partly in the headroom of the socket buffer if the
+ * ROHC header is longer than the uncompressed headers (IR packets for
+ * example).
+ *
+ * The ROHC header is built in the headroom of the socket buffer, so that it
+ * does not overwrite the uncompressed headers it is computed from. It is at
+ * most \ref ROHC_SKB_COMP_OVERHEAD bytes longer than the uncompressed packet
+ * and never longer than \e max_len bytes. Socket buffers with less headroom
+ * get their ROHC header built in a temporary buffer instead.
+ *
+ * Non-linear socket buffers are linearized and cloned socket buffers get a
+ * private copy of their headers, otherwise nothing is copied. A checksum left
+ * to the hardware is computed before compression. GSO socket buffers shall
+ * be segmented before compression.
+ *
+ * If ROHC segmentation is required (\ref ROHC_STATUS_SEGMENT), the socket
+ * buffer is not modified and the ROHC segments shall be retrieved with
+ * \ref rohc_comp_get_segment2 before the socket buffer is modified or freed.
+ *
+ * @param comp      The ROHC compressor
+ * @param skb       IN:  The socket buffer with the IP packet to compress
+ *                  OUT: The socket buffer with the ROHC packet
+ * @param max_len   The maximum length (in bytes) of the ROHC packet
+ * @return          Possible return values, see \ref rohc_compress_sg
+ */
+rohc_status_t rohc_compress_skb(struct rohc_comp *const comp,
+				struct sk_buff *const skb,
+				const size_t max_len)
+{
+	struct rohc_buf rohc_hdr;
+	struct rohc_buf uncomp_packet;
+	rohc_comp_payload_t payload;
+	uint8_t *tmp_hdr = NULL;
+	size_t uncomp_hdr_len;
+	size_t hdr_room;
+	rohc_status_t status;
+
+	if (skb_is_gso(skb))
+		goto error;
+	if (skb->ip_summed == CHECKSUM_PARTIAL && skb_checksum_help(skb) != 0)
+		goto error;
+	if (skb_linearize(skb) != 0 || skb_cow_head(skb, 0) != 0)
+		goto error;
+
+	uncomp_packet.time = rohc_skb_get_time(skb);
+	uncomp_packet.data = skb->data;
+	uncomp_packet.max_len = skb->len;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = skb->len;
+
+	/* build the ROHC header in the headroom if it is large enough for the
+	 * longest ROHC header, in a temporary buffer otherwise */
+	hdr_room = min_t(size_t, max_len, skb->len + ROHC_SKB_COMP_OVERHEAD);
+	if (skb_headroom(skb) >= hdr_room) {
+		rohc_hdr.data = skb->head;
+	} else {
+		tmp_hdr = kmalloc(hdr_room, GFP_ATOMIC);
+		if (tmp_hdr == NULL)
+			goto error;
+		rohc_hdr.data = tmp_hdr;
+	}
+	rohc_hdr.max_len = hdr_room;
+	rohc_hdr.offset = 0;
+	rohc_hdr.len = 0;
+
+	status = rohc_compress_sg(comp, uncomp_packet, max_len, &rohc_hdr,
+				  &payload);
+	if (status != ROHC_STATUS_OK)
+		goto free_tmp_hdr;
+
+	/* the ROHC header replaces the uncompressed headers in front of the
+	 * payload, a headroom that held the ROHC header is large enough for the
+	 * bytes it adds */
+	uncomp_hdr_len = payload.data - skb->data;
+	if (rohc_hdr.len > uncomp_hdr_len) {
+		const size_t missing_len = rohc_hdr.len - uncomp_hdr_len;
+
+		if (tmp_hdr != NULL && skb_cow_head(skb, missing_len) != 0) {
+			status = ROHC_STATUS_ERROR;
+			goto free_tmp_hdr;
+		}
+		skb_push(skb, missing_len);
+	} else {
+		skb_pull(skb, uncomp_hdr_len - rohc_hdr.len);
+	}
+	if (tmp_hdr != NULL) {
+		memcpy(skb->data, tmp_hdr, rohc_hdr.len);
+		kfree(tmp_hdr);
+	} else {
+		/* the ROHC header and its final place may overlap */
+		memmove(skb->data, skb->head, rohc_hdr.len);
+	}
+
+	skb_reset_network_header(skb);
+	skb->protocol = htons(ROHC_ETHERTYPE);
+	skb->ip_summed = CHECKSUM_NONE;
+
+	return ROHC_STATUS_OK;
+
+free_tmp_hdr:
+	kfree(tmp_hdr);
+	return status;
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress the ROHC packet of the given socket buffer in place
+ *
+ * Decompress the ROHC packet of the given socket buffer as
+ * \ref rohc_decompress_inplace does: the uncompressed headers are built in
+ * the headroom of the socket buffer, then they replace the ROHC header in
+ * front of the payload. The payload is not copied.
+ *
+ * Non-linear socket buffers are linearized, while cloned socket buffers and
+ * socket buffers with less than \ref ROHC_SKB_DECOMP_HEADROOM bytes of
+ * headroom get new private headers, otherwise nothing is copied.
+ *
+ * The socket buffer is empty once decompressed if the ROHC packet contained
+ * only feedback data. If decompression fails, the socket buffer shall be
+ * dropped.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param skb                 IN:  The socket buffer with the ROHC packet
+ *                            OUT: The socket buffer with the IP packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer, see
+ *                            \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @return                    Possible return values, see
+ *                            \ref rohc_decompress_inplace
+ */
+rohc_status_t rohc_decompress_skb(struct rohc_decomp *const decomp,
+				  struct sk_buff *const skb,
+				  struct rohc_buf *const rcvd_feedback,
+				  struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf packet;
+	rohc_status_t status;
+	size_t headroom;
+
+	if (skb_linearize(skb) != 0 ||
+	    skb_cow_head(skb, ROHC_SKB_DECOMP_HEADROOM) != 0)
+		goto error;
+
+	headroom = skb_headroom(skb);
+	packet.time = rohc_skb_get_time(skb);
+	packet.data = skb->head;
+	packet.max_len = headroom + skb->len;
+	packet.offset = headroom;
+	packet.len = skb->len;
+
+	status = rohc_decompress_inplace(decomp, &packet, rcvd_feedback,
+					 feedback_send);
+	if (status != ROHC_STATUS_OK)
+		return status;
+
+	if (packet.len == 0) {
+		/* feedback-only ROHC packet */
+		skb_trim(skb, 0);
+		return ROHC_STATUS_OK;
+	}
+
+	/* the payload did not move, the uncompressed headers are now in front
+	 * of it */
+	if (packet.offset < headroom)
+		skb_push(skb, headroom - packet.offset);
+	else
+		skb_pull(skb, packet.offset - headroom);
+	skb_trim(skb, packet.len);
+
+	skb_reset_network_header(skb);
+	if ((skb->data[0] >> 4) == 6)
+		skb->protocol = htons(ETH_P_IPV6);
+	else
+		skb->protocol = htons(ETH_P_IP);
+	skb->ip_summed = CHECKSUM_NONE;
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Get the arrival time of the given socket buffer
+ *
+ * @param skb  The socket buffer
+ * @return     The timestamp of the socket buffer, or the current time if the
+ *             socket buffer was not timestamped
+ */
+static struct rohc_ts rohc_skb_get_time(const struct sk_buff *const skb)
+{
+	struct timespec64 ts;
+	struct rohc_ts time;
+
+	if (ktime_to_ns(skb->tstamp) != 0)
+		ts = ktime_to_timespec64(skb->tstamp);
+	else
+		ktime_get_real_ts64(&ts);
+
+	time.sec = ts.tv_sec;
+	time.nsec = ts.tv_nsec;
+
+	return time;
+}
+
+
 /*
  * General API
  */
@@ -66,6 +290,26 @@ EXPORT_SYMBOL_GPL(rohc_buf_append_buf);
 EXPORT_SYMBOL_GPL(rohc_buf_reset);
 
 
+/*
+ * Socket buffer API
+ */
+
+EXPORT_SYMBOL_GPL(rohc_compress_skb);
+EXPORT_SYMBOL_GPL(rohc_decompress_skb);
+
+
+/*
+ * Per-CPU compression front-end
+ */
+
+EXPORT_SYMBOL_GPL(rohc_comp_percpu_new);
+EXPORT_SYMBOL_GPL(rohc_comp_percpu_free);
+EXPORT_SYMBOL_GPL(rohc_comp_percpu_get_pool);
+EXPORT_SYMBOL_GPL(rohc_comp_percpu_compress_skb);
+EXPORT_SYMBOL_GPL(rohc_comp_percpu_deliver_feedback);
+EXPORT_SYMBOL_GPL(rohc_comp_percpu_get_stats);
+
+
 /*
  * Compression API
  */
@@ -74,18 +318,27 @@ EXPORT_SYMBOL_GPL(rohc_buf_reset);
 EXPORT_SYMBOL_GPL(rohc_comp_new2);
 EXPORT_SYMBOL_GPL(rohc_comp_free);
 EXPORT_SYMBOL_GPL(rohc_compress4);
+EXPORT_SYMBOL_GPL(rohc_compress_burst);
+EXPORT_SYMBOL_GPL(rohc_compress_sg);
 EXPORT_SYMBOL_GPL(rohc_comp_force_contexts_reinit);
 
 /* segment */
 EXPORT_SYMBOL_GPL(rohc_comp_get_segment2);
+EXPORT_SYMBOL_GPL(rohc_comp_get_segment_sg);
 
 /* feedback */
 EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_feedback_queue);
+EXPORT_SYMBOL_GPL(rohc_comp_queue_feedback);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_comp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_comp_get_general_info);
 EXPORT_SYMBOL_GPL(rohc_comp_get_last_packet_info2);
+EXPORT_SYMBOL_GPL(rohc_comp_get_stats_snapshot);
+EXPORT_SYMBOL_GPL(rohc_comp_get_ctxt_stats_snapshot);
+EXPORT_SYMBOL_GPL(rohc_comp_export_contexts);
+EXPORT_SYMBOL_GPL(rohc_comp_import_contexts);
 
 /* configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_profile_enabled);
@@ -100,10 +353,22 @@ EXPORT_SYMBOL_GPL(rohc_comp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_comp_set_wlsb_window_width);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes);
 EXPORT_SYMBOL_GPL(rohc_comp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_traces_min_level);
 EXPORT_SYMBOL_GPL(rohc_comp_set_features);
 
 /* RTP-specific configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_heuristic);
+
+/* pools of compressors */
+EXPORT_SYMBOL_GPL(rohc_comp_pool_new);
+EXPORT_SYMBOL_GPL(rohc_comp_pool_free);
+EXPORT_SYMBOL_GPL(rohc_comp_pool_get_shards_nr);
+EXPORT_SYMBOL_GPL(rohc_comp_pool_get_shard);
+EXPORT_SYMBOL_GPL(rohc_comp_pool_get_packet_shard);
+EXPORT_SYMBOL_GPL(rohc_comp_pool_get_feedback_shard);
+EXPORT_SYMBOL_GPL(rohc_comp_pool_compress);
+EXPORT_SYMBOL_GPL(rohc_comp_pool_deliver_feedback2);
 
 
 /*
@@ -114,12 +379,18 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
 EXPORT_SYMBOL_GPL(rohc_decomp_new2);
 EXPORT_SYMBOL_GPL(rohc_decomp_free);
 EXPORT_SYMBOL_GPL(rohc_decompress3);
+EXPORT_SYMBOL_GPL(rohc_decompress_inplace);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_decomp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_general_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_context_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_last_packet_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_stats_snapshot);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_ctxt_stats_snapshot);
+EXPORT_SYMBOL_GPL(rohc_decomp_export_contexts);
+EXPORT_SYMBOL_GPL(rohc_decomp_import_contexts);
 
 /* configuration */
 EXPORT_SYMBOL_GPL(rohc_decomp_profile_enabled);
@@ -136,5 +407,6 @@ EXPORT_SYMBOL_GPL(rohc_decomp_get_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_min_level);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_features);
 
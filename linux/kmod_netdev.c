@@ -0,0 +1,576 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file    kmod_netdev.c
+ * @brief   A small module for the Linux kernel to test ROHC in the datapath
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The module creates one ROHC network device over each end of a veth pair,
+ * rohc0 over veth0 and rohc1 over veth1 by default:
+ *  - the IP packets sent on a ROHC device are compressed in their socket
+ *    buffers, then sent on its lower device with the ROHC Ethertype,
+ *  - the ROHC packets received on the lower device are decompressed in
+ *    their socket buffers, then received on the ROHC device.
+ *
+ * Move one of the ROHC devices in another network namespace to exchange
+ * packets between both ROHC devices:
+ * \code
+	ip link add veth0 type veth peer name veth1
+	ip link set veth0 up ; ip link set veth1 up
+	insmod rohc_netdev.ko lower=veth0,veth1
+	ip netns add peer ; ip link set rohc1 netns peer
+	ip addr add 10.0.0.1/24 dev rohc0 ; ip link set rohc0 up
+	ip -n peer addr add 10.0.0.2/24 dev rohc1 ; ip -n peer link set rohc1 up
+	ping 10.0.0.2
+\endcode
+ *
+ * The module holds references on the lower devices: unload it before
+ * deleting the veth pair.
+ */
+
+#include <linux/module.h>
+#include <linux/netdevice.h>
+#include <linux/etherdevice.h>
+#include <linux/if_arp.h>
+#include <linux/skbuff.h>
+#include <linux/spinlock.h>
+#include <linux/percpu.h>
+#include <linux/u64_stats_sync.h>
+
+#include "config.h"
+#include "rohc.h"
+#include "rohc_comp.h"
+#include "rohc_decomp.h"
+#include "rohc_skb.h"
+#include "rohc_comp_percpu.h"
+
+
+/** The name of the ROHC network device */
+#define ROHC_NETDEV_NAME "rohc%d"
+
+/** The bytes that the ROHC headers may add to the uncompressed headers */
+#define ROHC_NETDEV_OVERHEAD  32U
+
+/** The largest CID on the ROHC channels, the CIDs are shared by the CPUs */
+#define ROHC_NETDEV_MAX_CID  255U
+
+/** The headroom for the small packets to be compressed in place */
+#define ROHC_NETDEV_HEADROOM  256U
+
+
+/** Custom pr_info() macro for the module */
+#define rohc_info(format, ...) \
+	pr_info("[%s] " format, THIS_MODULE->name, ##__VA_ARGS__)
+
+/** Custom pr_err() macro for the module */
+#define rohc_err(format, ...) \
+	pr_err("[%s] " format, THIS_MODULE->name, ##__VA_ARGS__)
+
+
+/** The statistics of the packets received by one CPU on the device */
+struct rohc_netdev_rx_stats {
+	/** The number of packets received on the ROHC network device */
+	u64 packets;
+	/** The number of bytes received on the ROHC network device */
+	u64 bytes;
+	/** The synchronization with the readers on 32-bit systems */
+	struct u64_stats_sync syncp;
+};
+
+
+/** The private part of the ROHC network device */
+struct rohc_netdev {
+
+	/** The ROHC network device */
+	struct net_device *dev;
+	/** The lower device that transmits and receives the ROHC packets */
+	struct net_device *lower;
+
+	/** The per-CPU ROHC compressor for the packets sent on the device */
+	struct rohc_comp_percpu *comp;
+	/** The number of packets dropped after compression */
+	atomic_long_t tx_dropped;
+
+	/** The ROHC decompressor for the packets from the lower device */
+	struct rohc_decomp *decomp;
+	/** The lock that serializes the accesses to the decompressor */
+	spinlock_t decomp_lock;
+	/** The per-CPU statistics of the packets received on the device */
+	struct rohc_netdev_rx_stats __percpu *rx_stats;
+	/** The number of packets dropped before or during decompression */
+	atomic_long_t rx_dropped;
+};
+
+
+/** The maximum number of ROHC network devices */
+#define ROHC_NETDEV_MAX  2U
+
+/** The names of the lower devices */
+static char *lower[ROHC_NETDEV_MAX] = { "veth0", "veth1" };
+/** The number of lower devices */
+static int lower_nr = ROHC_NETDEV_MAX;
+module_param_array(lower, charp, &lower_nr, 0444);
+MODULE_PARM_DESC(lower, "The lower devices (default: veth0,veth1)");
+
+/** The ROHC network devices created by the module */
+static struct net_device *rohc_devs[ROHC_NETDEV_MAX];
+
+
+/**
+ * @brief Generate a false random number for the ROHC compressor
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int rohc_netdev_random_num(const struct rohc_comp *const comp,
+				  void *const user_context)
+{
+	return 0;
+}
+
+
+/**
+ * @brief Start the ROHC network device
+ *
+ * @param dev  The ROHC network device
+ * @return     Always 0
+ */
+static int rohc_netdev_open(struct net_device *dev)
+{
+	netif_start_queue(dev);
+	return 0;
+}
+
+
+/**
+ * @brief Stop the ROHC network device
+ *
+ * @param dev  The ROHC network device
+ * @return     Always 0
+ */
+static int rohc_netdev_stop(struct net_device *dev)
+{
+	netif_stop_queue(dev);
+	return 0;
+}
+
+
+/**
+ * @brief Compress one IP packet sent on the ROHC network device
+ *
+ * The IP packet is compressed in its socket buffer, then the ROHC packet is
+ * transmitted on the lower device.
+ *
+ * @param skb  The socket buffer with the IP packet
+ * @param dev  The ROHC network device
+ * @return     Always NETDEV_TX_OK, the socket buffer is consumed
+ */
+static netdev_tx_t rohc_netdev_xmit(struct sk_buff *skb,
+				    struct net_device *dev)
+{
+	struct rohc_netdev *const priv = netdev_priv(dev);
+	struct net_device *const lower_dev = priv->lower;
+	rohc_status_t status;
+
+	status = rohc_comp_percpu_compress_skb(priv->comp, skb, lower_dev->mtu);
+	if (status != ROHC_STATUS_OK)
+		goto free_skb;
+
+	/* add the link layer header of the lower device */
+	if (skb_cow_head(skb, LL_RESERVED_SPACE(lower_dev)) != 0)
+		goto drop;
+	skb->dev = lower_dev;
+	if (dev_hard_header(skb, lower_dev, ROHC_ETHERTYPE,
+			    lower_dev->broadcast, NULL, skb->len) < 0)
+		goto drop;
+
+	dev_queue_xmit(skb);
+
+	return NETDEV_TX_OK;
+
+drop:
+	atomic_long_inc(&priv->tx_dropped);
+free_skb:
+	kfree_skb(skb);
+	return NETDEV_TX_OK;
+}
+
+
+/**
+ * @brief Get the statistics of the ROHC network device
+ *
+ * The transmission statistics are the per-CPU statistics of the compressor,
+ * the reception statistics are the per-CPU statistics of the receive handler.
+ *
+ * @param dev    The ROHC network device
+ * @param stats  The statistics of the ROHC network device
+ */
+static void rohc_netdev_get_stats64(struct net_device *dev,
+				    struct rtnl_link_stats64 *stats)
+{
+	struct rohc_netdev *const priv = netdev_priv(dev);
+	unsigned int cpu;
+
+	for_each_possible_cpu(cpu) {
+		const struct rohc_netdev_rx_stats *const rx_stats =
+			per_cpu_ptr(priv->rx_stats, cpu);
+		struct rohc_comp_percpu_stats comp_stats;
+		unsigned int start;
+		u64 rx_packets;
+		u64 rx_bytes;
+
+		do {
+			start = u64_stats_fetch_begin(&rx_stats->syncp);
+			rx_packets = rx_stats->packets;
+			rx_bytes = rx_stats->bytes;
+		} while (u64_stats_fetch_retry(&rx_stats->syncp, start));
+		stats->rx_packets += rx_packets;
+		stats->rx_bytes += rx_bytes;
+
+		if (!rohc_comp_percpu_get_stats(priv->comp, cpu, &comp_stats))
+			continue;
+		stats->tx_packets += comp_stats.packets;
+		stats->tx_bytes += comp_stats.comp_bytes;
+		stats->tx_dropped += comp_stats.errors;
+	}
+	stats->tx_dropped += atomic_long_read(&priv->tx_dropped);
+	stats->rx_dropped += atomic_long_read(&priv->rx_dropped);
+}
+
+
+/**
+ * @brief Decompress one ROHC packet received on the lower device
+ *
+ * The ROHC packet is decompressed in its socket buffer, then the IP packet is
+ * received on the ROHC network device. Other packets are left to the lower
+ * device.
+ *
+ * @param pskb  The socket buffer received on the lower device
+ * @return      RX_HANDLER_CONSUMED for ROHC packets,
+ *              RX_HANDLER_PASS for other packets
+ */
+static rx_handler_result_t rohc_netdev_rx(struct sk_buff **pskb)
+{
+	struct sk_buff *skb = *pskb;
+	struct rohc_netdev_rx_stats *rx_stats;
+	struct rohc_netdev *priv;
+	rohc_status_t status;
+
+	if (skb->protocol != htons(ROHC_ETHERTYPE))
+		return RX_HANDLER_PASS;
+
+	priv = rcu_dereference(skb->dev->rx_handler_data);
+
+	skb = skb_share_check(skb, GFP_ATOMIC);
+	if (skb == NULL)
+		goto dropped;
+
+	spin_lock(&priv->decomp_lock);
+	status = rohc_decompress_skb(priv->decomp, skb, NULL, NULL);
+	spin_unlock(&priv->decomp_lock);
+	if (status != ROHC_STATUS_OK || skb->len == 0)
+		goto drop;
+
+	skb->dev = priv->dev;
+	skb->pkt_type = PACKET_HOST;
+	skb_reset_mac_header(skb);
+	rx_stats = this_cpu_ptr(priv->rx_stats);
+	u64_stats_update_begin(&rx_stats->syncp);
+	rx_stats->packets++;
+	rx_stats->bytes += skb->len;
+	u64_stats_update_end(&rx_stats->syncp);
+	netif_rx(skb);
+
+	return RX_HANDLER_CONSUMED;
+
+drop:
+	kfree_skb(skb);
+dropped:
+	atomic_long_inc(&priv->rx_dropped);
+	return RX_HANDLER_CONSUMED;
+}
+
+
+/** The operations of the ROHC network device */
+static const struct net_device_ops rohc_netdev_ops = {
+	.ndo_open       = rohc_netdev_open,
+	.ndo_stop       = rohc_netdev_stop,
+	.ndo_start_xmit = rohc_netdev_xmit,
+	.ndo_get_stats64 = rohc_netdev_get_stats64,
+};
+
+
+/**
+ * @brief Setup the ROHC network device
+ *
+ * The device carries IP packets without link layer header. It does not
+ * advertise any offload feature, so the stack sends it only packets with
+ * complete checksums and without GSO. It has no queue and no transmit lock,
+ * so that every CPU compresses its packets with its own compressor.
+ *
+ * @param dev  The ROHC network device
+ */
+static void rohc_netdev_setup(struct net_device *dev)
+{
+	dev->netdev_ops = &rohc_netdev_ops;
+	dev->type = ARPHRD_NONE;
+	dev->flags = IFF_POINTOPOINT | IFF_NOARP;
+	dev->hard_header_len = 0;
+	dev->addr_len = 0;
+	dev->mtu = ETH_DATA_LEN - ROHC_NETDEV_OVERHEAD;
+	dev->tx_queue_len = 0;
+	dev->priv_flags |= IFF_NO_QUEUE;
+#ifdef NETIF_F_LLTX
+	dev->features |= NETIF_F_LLTX;
+#else
+	dev->lltx = true;
+#endif
+}
+
+
+/**
+ * @brief Create the ROHC compressor and decompressor of the network device
+ *
+ * @param priv  The private part of the ROHC network device
+ * @return      0 in case of success, non-zero otherwise
+ */
+static int rohc_netdev_init_rohc(struct rohc_netdev *const priv)
+{
+	char debugfs_name[IFNAMSIZ + 16];
+	struct rohc_comp_pool *pool;
+	unsigned int cpu;
+	size_t i;
+
+	/* statistics in /sys/kernel/debug/rohc_comp_<lower device> */
+	snprintf(debugfs_name, sizeof(debugfs_name), "rohc_comp_%s",
+		 priv->lower->name);
+	priv->comp = rohc_comp_percpu_new(ROHC_LARGE_CID, ROHC_NETDEV_MAX_CID,
+					  rohc_netdev_random_num, NULL,
+					  debugfs_name);
+	if (priv->comp == NULL) {
+		rohc_err("cannot create the per-CPU ROHC compressor\n");
+		goto error;
+	}
+	pool = rohc_comp_percpu_get_pool(priv->comp);
+	for (i = 0; i < rohc_comp_pool_get_shards_nr(pool); i++) {
+		struct rohc_comp *const shard = rohc_comp_pool_get_shard(pool, i);
+
+		if (!rohc_comp_enable_profiles(shard,
+				ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_RTP,
+				ROHC_PROFILE_UDP, ROHC_PROFILE_ESP,
+				ROHC_PROFILE_IP, ROHC_PROFILE_TCP,
+				ROHC_PROFILE_UDPLITE, -1)) {
+			rohc_err("failed to enable the compression profiles\n");
+			goto free_compressor;
+		}
+	}
+	atomic_long_set(&priv->tx_dropped, 0);
+
+	/* no feedback channel between the peers, so use the U-mode */
+	priv->decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_NETDEV_MAX_CID,
+					ROHC_U_MODE);
+	if (priv->decomp == NULL) {
+		rohc_err("cannot create the ROHC decompressor\n");
+		goto free_compressor;
+	}
+	if (!rohc_decomp_enable_profiles(priv->decomp,
+			ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_RTP,
+			ROHC_PROFILE_UDP, ROHC_PROFILE_ESP, ROHC_PROFILE_IP,
+			ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE, -1)) {
+		rohc_err("failed to enable the decompression profiles\n");
+		goto free_decompressor;
+	}
+	spin_lock_init(&priv->decomp_lock);
+
+	priv->rx_stats = alloc_percpu(struct rohc_netdev_rx_stats);
+	if (priv->rx_stats == NULL) {
+		rohc_err("cannot allocate the reception statistics\n");
+		goto free_decompressor;
+	}
+	for_each_possible_cpu(cpu)
+		u64_stats_init(&per_cpu_ptr(priv->rx_stats, cpu)->syncp);
+	atomic_long_set(&priv->rx_dropped, 0);
+
+	return 0;
+
+free_decompressor:
+	rohc_decomp_free(priv->decomp);
+free_compressor:
+	rohc_comp_percpu_free(priv->comp);
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Create one ROHC network device over the given lower device
+ *
+ * @param lower_name  The name of the lower device
+ * @param[out] dev    The ROHC network device
+ * @return            0 in case of success, a negative error code otherwise
+ */
+static int rohc_netdev_create(const char *const lower_name,
+			      struct net_device **const dev)
+{
+	struct net_device *lower_dev;
+	struct rohc_netdev *priv;
+	int ret;
+
+	lower_dev = dev_get_by_name(&init_net, lower_name);
+	if (lower_dev == NULL) {
+		rohc_err("lower device '%s' not found\n", lower_name);
+		ret = -ENODEV;
+		goto error;
+	}
+	if (lower_dev->type != ARPHRD_ETHER) {
+		rohc_err("lower device '%s' is not an Ethernet device\n",
+			 lower_name);
+		ret = -EINVAL;
+		goto put_lower;
+	}
+
+	*dev = alloc_netdev(sizeof(struct rohc_netdev), ROHC_NETDEV_NAME,
+			    NET_NAME_UNKNOWN, rohc_netdev_setup);
+	if (*dev == NULL) {
+		ret = -ENOMEM;
+		goto put_lower;
+	}
+	(*dev)->needed_headroom = LL_RESERVED_SPACE(lower_dev) +
+				  ROHC_NETDEV_HEADROOM;
+	(*dev)->mtu = lower_dev->mtu - ROHC_NETDEV_OVERHEAD;
+
+	priv = netdev_priv(*dev);
+	priv->dev = *dev;
+	priv->lower = lower_dev;
+	if (rohc_netdev_init_rohc(priv) != 0) {
+		ret = -ENOMEM;
+		goto free_netdev;
+	}
+
+	ret = register_netdev(*dev);
+	if (ret != 0) {
+		rohc_err("cannot register the ROHC network device\n");
+		goto free_rohc;
+	}
+
+	rtnl_lock();
+	ret = netdev_rx_handler_register(lower_dev, rohc_netdev_rx, priv);
+	rtnl_unlock();
+	if (ret != 0) {
+		rohc_err("cannot receive packets from lower device '%s'\n",
+			 lower_name);
+		goto unregister_netdev;
+	}
+
+	rohc_info("ROHC network device %s successfully created over %s\n",
+		  (*dev)->name, lower_dev->name);
+
+	return 0;
+
+unregister_netdev:
+	unregister_netdev(*dev);
+free_rohc:
+	free_percpu(priv->rx_stats);
+	rohc_decomp_free(priv->decomp);
+	rohc_comp_percpu_free(priv->comp);
+free_netdev:
+	free_netdev(*dev);
+put_lower:
+	dev_put(lower_dev);
+error:
+	return ret;
+}
+
+
+/**
+ * @brief Destroy the given ROHC network device
+ *
+ * @param dev  The ROHC network device
+ */
+static void rohc_netdev_destroy(struct net_device *const dev)
+{
+	struct rohc_netdev *const priv = netdev_priv(dev);
+	struct net_device *const lower_dev = priv->lower;
+
+	rtnl_lock();
+	netdev_rx_handler_unregister(lower_dev);
+	rtnl_unlock();
+	unregister_netdev(dev);
+
+	free_percpu(priv->rx_stats);
+	rohc_decomp_free(priv->decomp);
+	rohc_comp_percpu_free(priv->comp);
+	free_netdev(dev);
+	dev_put(lower_dev);
+}
+
+
+/**
+ * @brief The entry point of the kernel module
+ *
+ * @return  0 in case of success, non-zero otherwise
+ */
+static int __init rohc_netdev_init(void)
+{
+	int ret;
+	int i;
+
+	rohc_info("loading ROHC network device module...\n");
+
+	for (i = 0; i < lower_nr; i++) {
+		ret = rohc_netdev_create(lower[i], &rohc_devs[i]);
+		if (ret != 0)
+			goto destroy_devs;
+	}
+
+	rohc_info("ROHC network device module successfully loaded\n");
+
+	return 0;
+
+destroy_devs:
+	while (--i >= 0)
+		rohc_netdev_destroy(rohc_devs[i]);
+	return ret;
+}
+
+
+/**
+ * @brief The exit point of the kernel module
+ */
+static void __exit rohc_netdev_exit(void)
+{
+	int i;
+
+	rohc_info("unloading ROHC network device module...\n");
+	for (i = 0; i < lower_nr; i++)
+		rohc_netdev_destroy(rohc_devs[i]);
+	rohc_info("ROHC network device module successfully unloaded\n");
+}
+
+
+MODULE_VERSION(PACKAGE_VERSION PACKAGE_REVNO);
+MODULE_LICENSE("GPL");
+MODULE_AUTHOR("Didier Barvaux");
+MODULE_DESCRIPTION("ROHC network device for testing " PACKAGE_NAME " "
+	PACKAGE_VERSION PACKAGE_REVNO " (" PACKAGE_URL ")");
+
+module_init(rohc_netdev_init);
+module_exit(rohc_netdev_exit);
+
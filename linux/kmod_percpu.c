@@ -0,0 +1,561 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   kmod_percpu.c
+ * @brief  Per-CPU ROHC compression front-end for the Linux kernel
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/percpu.h>
+#include <linux/hashtable.h>
+#include <linux/rcupdate.h>
+#include <linux/spinlock.h>
+#include <linux/jiffies.h>
+#include <linux/u64_stats_sync.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include "rohc.h"
+#include "rohc_comp.h"
+#include "rohc_skb.h"
+#include "rohc_comp_percpu.h"
+
+
+/** The log2 of the number of buckets in the flow-to-shard map */
+#define ROHC_COMP_PERCPU_FLOWS_BITS  10
+
+/** The time after which an unused flow is removed from the map when the map
+ *  is full */
+#define ROHC_COMP_PERCPU_FLOW_TIMEOUT  (30 * HZ)
+
+
+/** One flow of the flow-to-shard map */
+struct rohc_comp_percpu_flow {
+	/** The node in the bucket of the map */
+	struct hlist_node node;
+	/** The RCU head to free the flow once no CPU reads it anymore */
+	struct rcu_head rcu;
+	/** The hash of the flow, see skb_get_hash() */
+	u32 hash;
+	/** The shard that compresses the flow */
+	unsigned int shard_idx;
+	/** The last time (in jiffies) a packet of the flow was compressed */
+	unsigned long last_used;
+};
+
+
+/** One shard of the front-end */
+struct rohc_comp_percpu_shard {
+	/** The lock that serializes the accesses to the shard, it is only
+	 *  contended when flows move between CPUs */
+	spinlock_t lock;
+	/** The number of CIDs owned by the shard */
+	size_t cids_nr;
+	/** The number of flows of the map given to the shard, protected by
+	 *  the lock of the map */
+	size_t flows_nr;
+} ____cacheline_aligned_in_smp;
+
+
+/** The statistics of one CPU and their synchronization for 32-bit CPUs */
+struct rohc_comp_percpu_stats_sync {
+	/** The statistics */
+	struct rohc_comp_percpu_stats counters;
+	/** The synchronization of the statistics */
+	struct u64_stats_sync syncp;
+};
+
+
+/** The per-CPU compression front-end */
+struct rohc_comp_percpu {
+	/** The pool of compressors, one shard per CPU */
+	struct rohc_comp_pool *pool;
+	/** The number of shards of the pool */
+	unsigned int shards_nr;
+	/** The locks of the shards */
+	struct rohc_comp_percpu_shard *shards;
+
+	/** The flow-to-shard map, read under RCU */
+	DECLARE_HASHTABLE(flows, ROHC_COMP_PERCPU_FLOWS_BITS);
+	/** The lock that serializes the changes of the flow-to-shard map */
+	spinlock_t flows_lock;
+	/** The number of flows in the map */
+	size_t flows_nr;
+	/** The maximum number of flows in the map */
+	size_t flows_max;
+
+	/** The statistics of every CPU */
+	struct rohc_comp_percpu_stats_sync __percpu *stats;
+	/** The debugfs file for the statistics */
+	struct dentry *debugfs_file;
+};
+
+
+static unsigned int rohc_comp_percpu_flow_shard(struct rohc_comp_percpu *front,
+						const u32 hash,
+						const unsigned int local_idx);
+static unsigned int
+	rohc_comp_percpu_free_shard(const struct rohc_comp_percpu *const front,
+				    const unsigned int local_idx);
+static void rohc_comp_percpu_expire_flows(struct rohc_comp_percpu *const front);
+
+static int rohc_comp_percpu_stats_show(struct seq_file *s, void *v);
+static int rohc_comp_percpu_stats_open(struct inode *inode, struct file *file);
+
+
+/** The operations of the debugfs file for statistics */
+static const struct file_operations rohc_comp_percpu_stats_fops = {
+	.owner   = THIS_MODULE,
+	.open    = rohc_comp_percpu_stats_open,
+	.read    = seq_read,
+	.llseek  = seq_lseek,
+	.release = single_release,
+};
+
+
+/**
+ * @brief Create a new per-CPU compression front-end
+ *
+ * Create a pool of ROHC compressors with one shard per possible CPU, or
+ * fewer shards if the ROHC channel has fewer CIDs than CPUs: some CPUs then
+ * share one shard. The shards shall be configured (profiles, callbacks...)
+ * with \ref rohc_comp_pool_get_shard before the first packet is compressed.
+ *
+ * @param cid_type   The type of Context IDs (CID) of the ROHC channel
+ * @param max_cid    The maximum value for CIDs on the ROHC channel
+ * @param rand_cb    The random callback to set on every shard
+ * @param rand_priv  Private data that will be given to the callback
+ * @param name       The name of the debugfs file for statistics,
+ *                   NULL for no debugfs file
+ * @return           The created front-end if successful,
+ *                   NULL if creation failed
+ */
+struct rohc_comp_percpu *rohc_comp_percpu_new(const rohc_cid_type_t cid_type,
+					      const rohc_cid_t max_cid,
+					      const rohc_comp_random_cb_t rand_cb,
+					      void *const rand_priv,
+					      const char *const name)
+{
+	struct rohc_comp_percpu *front;
+	unsigned int cpu;
+	unsigned int i;
+
+	front = kzalloc(sizeof(struct rohc_comp_percpu), GFP_KERNEL);
+	if (front == NULL)
+		goto error;
+
+	front->shards_nr = min_t(unsigned int, nr_cpu_ids, max_cid + 1);
+	front->pool = rohc_comp_pool_new(cid_type, max_cid, front->shards_nr,
+					 rand_cb, rand_priv);
+	if (front->pool == NULL)
+		goto free_front;
+
+	front->shards = kcalloc(front->shards_nr,
+				sizeof(struct rohc_comp_percpu_shard),
+				GFP_KERNEL);
+	if (front->shards == NULL)
+		goto free_pool;
+	/* the shards own the CIDs as the pool split them */
+	for (i = 0; i < front->shards_nr; i++) {
+		spin_lock_init(&front->shards[i].lock);
+		front->shards[i].cids_nr =
+			((i + 1) * (max_cid + 1)) / front->shards_nr -
+			(i * (max_cid + 1)) / front->shards_nr;
+		front->shards[i].flows_nr = 0;
+	}
+
+	/* there is no point in tracking more flows than contexts */
+	hash_init(front->flows);
+	spin_lock_init(&front->flows_lock);
+	front->flows_nr = 0;
+	front->flows_max = max_cid + 1;
+
+	front->stats = alloc_percpu(struct rohc_comp_percpu_stats_sync);
+	if (front->stats == NULL)
+		goto free_shards;
+	for_each_possible_cpu(cpu)
+		u64_stats_init(&per_cpu_ptr(front->stats, cpu)->syncp);
+
+	/* statistics are still available with rohc_comp_percpu_get_stats()
+	 * if the debugfs file cannot be created */
+	if (name != NULL)
+		front->debugfs_file =
+			debugfs_create_file(name, 0444, NULL, front,
+					    &rohc_comp_percpu_stats_fops);
+
+	return front;
+
+free_shards:
+	kfree(front->shards);
+free_pool:
+	rohc_comp_pool_free(front->pool);
+free_front:
+	kfree(front);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given per-CPU compression front-end
+ *
+ * No CPU shall use the front-end anymore.
+ *
+ * @param front  The front-end to destroy
+ */
+void rohc_comp_percpu_free(struct rohc_comp_percpu *const front)
+{
+	struct rohc_comp_percpu_flow *flow;
+	struct hlist_node *tmp;
+	unsigned int bkt;
+
+	if (front == NULL)
+		return;
+
+	debugfs_remove(front->debugfs_file);
+
+	/* flows removed by expiration may still wait for their RCU grace
+	 * period, they are freed by RCU */
+	hash_for_each_safe(front->flows, bkt, tmp, flow, node) {
+		hash_del(&flow->node);
+		kfree(flow);
+	}
+
+	free_percpu(front->stats);
+	kfree(front->shards);
+	rohc_comp_pool_free(front->pool);
+	kfree(front);
+}
+
+
+/**
+ * @brief Get the pool of compressors of the given per-CPU front-end
+ *
+ * The pool gives access to the shards, so that they may be configured.
+ *
+ * @param front  The per-CPU compression front-end
+ * @return       The pool of compressors, NULL if the front-end is not valid
+ */
+struct rohc_comp_pool *
+	rohc_comp_percpu_get_pool(const struct rohc_comp_percpu *const front)
+{
+	if (front == NULL)
+		return NULL;
+	return front->pool;
+}
+
+
+/**
+ * @brief Compress the IP packet of the given socket buffer on the current CPU
+ *
+ * The packet is compressed in place as \ref rohc_compress_skb does, by the
+ * shard that compresses its flow. A new flow is given to the shard of the
+ * current CPU if it has free CIDs, see \ref rohc_comp_percpu_flow_shard.
+ * The function shall be called with bottom halves disabled,
+ * for example from the ndo_start_xmit() callback of a network device.
+ *
+ * @param front    The per-CPU compression front-end
+ * @param skb      IN:  The socket buffer with the IP packet to compress
+ *                 OUT: The socket buffer with the ROHC packet
+ * @param max_len  The maximum length (in bytes) of the ROHC packet
+ * @return         Possible return values, see \ref rohc_compress_skb
+ */
+rohc_status_t rohc_comp_percpu_compress_skb(struct rohc_comp_percpu *const front,
+					    struct sk_buff *const skb,
+					    const size_t max_len)
+{
+	const unsigned int local_shard_idx =
+		smp_processor_id() % front->shards_nr;
+	struct rohc_comp_percpu_stats_sync *const stats =
+		this_cpu_ptr(front->stats);
+	const unsigned int uncomp_len = skb->len;
+	struct rohc_comp *comp;
+	unsigned int shard_idx;
+	rohc_status_t status;
+
+	shard_idx = rohc_comp_percpu_flow_shard(front, skb_get_hash(skb),
+						local_shard_idx);
+	comp = rohc_comp_pool_get_shard(front->pool, shard_idx);
+
+	spin_lock(&front->shards[shard_idx].lock);
+	status = rohc_compress_skb(comp, skb, max_len);
+	spin_unlock(&front->shards[shard_idx].lock);
+
+	u64_stats_update_begin(&stats->syncp);
+	if (status == ROHC_STATUS_OK) {
+		stats->counters.packets++;
+		if (shard_idx != local_shard_idx)
+			stats->counters.remote_packets++;
+		stats->counters.uncomp_bytes += uncomp_len;
+		stats->counters.comp_bytes += skb->len;
+	} else {
+		stats->counters.errors++;
+	}
+	u64_stats_update_end(&stats->syncp);
+
+	return status;
+}
+
+
+/**
+ * @brief Deliver feedback to the shards of the given per-CPU front-end
+ *
+ * Every feedback item is delivered with \ref rohc_comp_deliver_feedback2 to
+ * the shard that owns its CID. The function shall be called with bottom
+ * halves disabled.
+ *
+ * @param front     The per-CPU compression front-end
+ * @param feedback  The feedback data
+ * @return          true if all the feedback items were successfully taken
+ *                  into account, false otherwise
+ */
+bool rohc_comp_percpu_deliver_feedback(struct rohc_comp_percpu *const front,
+				       const struct rohc_buf feedback)
+{
+	struct rohc_buf remain_data = feedback;
+	size_t nr_failures = 0;
+
+	while (remain_data.len > 0) {
+		struct rohc_buf feedback_item = remain_data;
+		struct rohc_comp *comp;
+		size_t feedback_len;
+		size_t shard_idx;
+		bool is_ok;
+
+		if (!rohc_comp_pool_get_feedback_shard(front->pool, remain_data,
+						       &shard_idx,
+						       &feedback_len))
+			return false;
+
+		feedback_item.len = feedback_len;
+		spin_lock(&front->shards[shard_idx].lock);
+		comp = rohc_comp_pool_get_shard(front->pool, shard_idx);
+		is_ok = rohc_comp_deliver_feedback2(comp, feedback_item);
+		spin_unlock(&front->shards[shard_idx].lock);
+		if (!is_ok)
+			nr_failures++;
+		rohc_buf_pull(&remain_data, feedback_len);
+	}
+
+	return (nr_failures == 0);
+}
+
+
+/**
+ * @brief Get the statistics of one CPU of the given per-CPU front-end
+ *
+ * @param front       The per-CPU compression front-end
+ * @param cpu         The CPU
+ * @param[out] stats  The statistics of the CPU
+ * @return            true if successful, false if the CPU is not valid
+ */
+bool rohc_comp_percpu_get_stats(const struct rohc_comp_percpu *const front,
+				const unsigned int cpu,
+				struct rohc_comp_percpu_stats *const stats)
+{
+	const struct rohc_comp_percpu_stats_sync *cpu_stats;
+	unsigned int start;
+
+	if (front == NULL || stats == NULL ||
+	    cpu >= nr_cpu_ids || !cpu_possible(cpu))
+		return false;
+
+	cpu_stats = per_cpu_ptr(front->stats, cpu);
+	do {
+		start = u64_stats_fetch_begin(&cpu_stats->syncp);
+		*stats = cpu_stats->counters;
+	} while (u64_stats_fetch_retry(&cpu_stats->syncp, start));
+
+	return true;
+}
+
+
+/**
+ * @brief Get the shard that compresses the flow with the given hash
+ *
+ * The map is read without lock. A flow that is not in the map yet is added
+ * with the shard of the current CPU if that shard has free CIDs, with another
+ * shard that has free CIDs otherwise. If the map is full even once the unused
+ * flows were removed, the flow is compressed without being added by a shard
+ * chosen from its hash, so that all its packets go to the same shard.
+ *
+ * @param front            The per-CPU compression front-end
+ * @param hash             The hash of the flow
+ * @param local_idx        The shard of the current CPU
+ * @return                 The shard that compresses the flow
+ */
+static unsigned int rohc_comp_percpu_flow_shard(struct rohc_comp_percpu *front,
+						const u32 hash,
+						const unsigned int local_idx)
+{
+	struct rohc_comp_percpu_flow *flow;
+	unsigned int shard_idx;
+
+	rcu_read_lock();
+	hash_for_each_possible_rcu(front->flows, flow, node, hash) {
+		if (flow->hash == hash) {
+			/* dirty the cache line once per tick at most */
+			if (READ_ONCE(flow->last_used) != jiffies)
+				WRITE_ONCE(flow->last_used, jiffies);
+			shard_idx = flow->shard_idx;
+			rcu_read_unlock();
+			return shard_idx;
+		}
+	}
+	rcu_read_unlock();
+
+	spin_lock(&front->flows_lock);
+
+	/* another CPU may have added the flow in the meantime */
+	hash_for_each_possible(front->flows, flow, node, hash) {
+		if (flow->hash == hash) {
+			shard_idx = flow->shard_idx;
+			goto unlock;
+		}
+	}
+
+	/* the flow is not tracked if the map is full or if memory is missing,
+	 * its hash then always gives it to the same shard */
+	shard_idx = hash % front->shards_nr;
+	if (front->flows_nr >= front->flows_max)
+		rohc_comp_percpu_expire_flows(front);
+	if (front->flows_nr < front->flows_max) {
+		flow = kmalloc(sizeof(struct rohc_comp_percpu_flow),
+			       GFP_ATOMIC);
+		if (flow != NULL) {
+			shard_idx = rohc_comp_percpu_free_shard(front,
+								local_idx);
+			flow->hash = hash;
+			flow->shard_idx = shard_idx;
+			flow->last_used = jiffies;
+			hash_add_rcu(front->flows, &flow->node, hash);
+			front->flows_nr++;
+			front->shards[shard_idx].flows_nr++;
+		}
+	}
+
+unlock:
+	spin_unlock(&front->flows_lock);
+	return shard_idx;
+}
+
+
+/**
+ * @brief Get a shard with free CIDs for a new flow
+ *
+ * The shard of the current CPU is preferred, the next shards are tried
+ * otherwise. The lock of the map shall be held and the map shall not be
+ * full: since the map tracks as many flows as CIDs, one shard at least
+ * has free CIDs then.
+ *
+ * @param front      The per-CPU compression front-end
+ * @param local_idx  The shard of the current CPU
+ * @return           The shard with free CIDs
+ */
+static unsigned int
+	rohc_comp_percpu_free_shard(const struct rohc_comp_percpu *const front,
+				    const unsigned int local_idx)
+{
+	unsigned int i;
+
+	for (i = 0; i < front->shards_nr; i++) {
+		const unsigned int shard_idx = (local_idx + i) %
+					       front->shards_nr;
+		const struct rohc_comp_percpu_shard *const shard =
+			&front->shards[shard_idx];
+
+		if (shard->flows_nr < shard->cids_nr)
+			return shard_idx;
+	}
+
+	return local_idx;
+}
+
+
+/**
+ * @brief Remove the flows that were not used for a while from the map
+ *
+ * The lock of the map shall be held.
+ *
+ * @param front  The per-CPU compression front-end
+ */
+static void rohc_comp_percpu_expire_flows(struct rohc_comp_percpu *const front)
+{
+	struct rohc_comp_percpu_flow *flow;
+	struct hlist_node *tmp;
+	unsigned int bkt;
+
+	hash_for_each_safe(front->flows, bkt, tmp, flow, node) {
+		const unsigned long expiry = READ_ONCE(flow->last_used) +
+					     ROHC_COMP_PERCPU_FLOW_TIMEOUT;
+
+		if (time_after(jiffies, expiry)) {
+			hash_del_rcu(&flow->node);
+			front->shards[flow->shard_idx].flows_nr--;
+			kfree_rcu(flow, rcu);
+			front->flows_nr--;
+		}
+	}
+}
+
+
+/**
+ * @brief Print the statistics of every CPU in the debugfs file
+ *
+ * @param s  The sequence file
+ * @param v  Unused
+ * @return   Always 0
+ */
+static int rohc_comp_percpu_stats_show(struct seq_file *s, void *v)
+{
+	const struct rohc_comp_percpu *const front = s->private;
+	unsigned int cpu;
+
+	seq_printf(s, "%-5s %14s %14s %14s %18s %18s\n", "cpu", "packets",
+		   "remote", "errors", "uncomp_bytes", "comp_bytes");
+	for_each_possible_cpu(cpu) {
+		struct rohc_comp_percpu_stats stats;
+
+		if (!rohc_comp_percpu_get_stats(front, cpu, &stats))
+			continue;
+		seq_printf(s, "%-5u %14llu %14llu %14llu %18llu %18llu\n", cpu,
+			   stats.packets, stats.remote_packets, stats.errors,
+			   stats.uncomp_bytes, stats.comp_bytes);
+	}
+	seq_printf(s, "flows: %zu/%zu\n", READ_ONCE(front->flows_nr),
+		   front->flows_max);
+
+	return 0;
+}
+
+
+/**
+ * @brief Open the debugfs file for statistics
+ *
+ * @param inode  The inode of the debugfs file
+ * @param file   The debugfs file
+ * @return       0 in case of success, a negative error code otherwise
+ */
+static int rohc_comp_percpu_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, rohc_comp_percpu_stats_show, inode->i_private);
+}
+
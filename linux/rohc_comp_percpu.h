@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   rohc_comp_percpu.h
+ * @brief  Per-CPU ROHC compression front-end for the Linux kernel
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The front-end compresses socket buffers from any CPU for one ROHC channel.
+ * It is built on a pool of ROHC compressors (see \ref rohc_comp_pool_new)
+ * with one shard per CPU:
+ *  - every flow is compressed by the shard of the CPU that sent its first
+ *    packet if that shard has free CIDs, by another shard with free CIDs
+ *    otherwise, so flows are compressed in parallel as long as they do not
+ *    move between CPUs,
+ *  - the flow-to-shard map is read without lock thanks to RCU, the shard
+ *    owns the CID of the flow,
+ *  - the statistics are counted per CPU and may be read in debugfs.
+ */
+
+#ifndef ROHC_COMP_PERCPU_H
+#define ROHC_COMP_PERCPU_H
+
+#include <linux/skbuff.h>
+
+#include "rohc.h"
+#include "rohc_comp.h"
+
+
+/** The per-CPU compression front-end, see \ref rohc_comp_percpu_new */
+struct rohc_comp_percpu;
+
+
+/** The statistics of one CPU of a per-CPU compression front-end */
+struct rohc_comp_percpu_stats {
+	/** The number of packets successfully compressed */
+	u64 packets;
+	/** The number of packets compressed by the shard of another CPU
+	 *  because their flow started on that CPU */
+	u64 remote_packets;
+	/** The number of packets that failed to be compressed */
+	u64 errors;
+	/** The number of bytes of the uncompressed packets */
+	u64 uncomp_bytes;
+	/** The number of bytes of the ROHC packets */
+	u64 comp_bytes;
+};
+
+
+struct rohc_comp_percpu *rohc_comp_percpu_new(const rohc_cid_type_t cid_type,
+					      const rohc_cid_t max_cid,
+					      const rohc_comp_random_cb_t rand_cb,
+					      void *const rand_priv,
+					      const char *const name);
+
+void rohc_comp_percpu_free(struct rohc_comp_percpu *const front);
+
+struct rohc_comp_pool *
+	rohc_comp_percpu_get_pool(const struct rohc_comp_percpu *const front);
+
+rohc_status_t rohc_comp_percpu_compress_skb(struct rohc_comp_percpu *const front,
+					    struct sk_buff *const skb,
+					    const size_t max_len);
+
+bool rohc_comp_percpu_deliver_feedback(struct rohc_comp_percpu *const front,
+				       const struct rohc_buf feedback);
+
+bool rohc_comp_percpu_get_stats(const struct rohc_comp_percpu *const front,
+				const unsigned int cpu,
+				struct rohc_comp_percpu_stats *const stats);
+
+#endif /* ROHC_COMP_PERCPU_H */
+
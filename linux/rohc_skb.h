@@ -0,0 +1,70 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   rohc_skb.h
+ * @brief  ROHC (de)compression of Linux socket buffers
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The functions compress and decompress packets directly in the socket
+ * buffers of the Linux kernel: the payload is never copied, only the headers
+ * are rewritten in the headroom of the socket buffer.
+ */
+
+#ifndef ROHC_SKB_H
+#define ROHC_SKB_H
+
+#include <linux/skbuff.h>
+
+#include "rohc.h"
+#include "rohc_comp.h"
+#include "rohc_decomp.h"
+
+
+/**
+ * @brief The headroom (in bytes) that decompression requires in socket buffers
+ *
+ * The uncompressed headers are built in the headroom of the socket buffer
+ * before they replace the ROHC header, see \ref rohc_decompress_inplace.
+ * Socket buffers with less headroom are reallocated.
+ */
+#define ROHC_SKB_DECOMP_HEADROOM  128U
+
+/**
+ * @brief The bytes that a ROHC header may add to the uncompressed packet
+ *
+ * The IR packets repeat the uncompressed headers in their static and dynamic
+ * chains, with the large CID, the packet type, the profile, the CRC and the
+ * encoding of the lists of IPv6 extension headers and TCP options. Socket
+ * buffers whose headroom exceeds their length by that many bytes get their
+ * ROHC header built in place, see \ref rohc_compress_skb.
+ */
+#define ROHC_SKB_COMP_OVERHEAD  128U
+
+
+rohc_status_t rohc_compress_skb(struct rohc_comp *const comp,
+				struct sk_buff *const skb,
+				const size_t max_len);
+
+rohc_status_t rohc_decompress_skb(struct rohc_decomp *const decomp,
+				  struct sk_buff *const skb,
+				  struct rohc_buf *const rcvd_feedback,
+				  struct rohc_buf *const feedback_send);
+
+#endif /* ROHC_SKB_H */
+
@@ -42,6 +42,17 @@
 #include <stdlib.h>
 #include <assert.h>
 
+#if ROHC_CRC_FCS32_PCLMUL == 1
+#  include <cpuid.h>
+#  include <wmmintrin.h>
+#  include <smmintrin.h>
+#endif
+#if ROHC_CRC_FCS32_PMULL == 1
+#  include <sys/auxv.h>
+#  include <asm/hwcap.h>
+#  include <arm_neon.h>
+#endif
+
 
 /**
  * @brief The pre-computed table for 32-bit Frame Check Sequence (FCS)
@@ -121,45 +132,894 @@ static const uint32_t crc_table_fcs32[256] =
 };
 
 
+/** The number of bytes processed by one step of the slicing-by-N algorithm */
+#define ROHC_CRC_SLICES  8U
+
+/**
+ * @brief The pre-computed tables for CRC-3 computation, slicing-by-8
+ *
+ * Table k gives the CRC of one byte followed by k zero bytes. Table 0 is the
+ * classic byte-wise table.
+ */
+static const uint8_t crc_table_3[ROHC_CRC_SLICES][256] =
+{
+	{
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06
+	},
+	{
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+		0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+		0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+		0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+		0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+		0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+		0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+		0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03
+	},
+	{
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+		0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+		0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+		0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+		0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+		0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+		0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+		0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07
+	},
+	{
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+		0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+		0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+		0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+		0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+		0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+		0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+		0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05
+	},
+	{
+		0x00, 0x04, 0x05, 0x01, 0x07, 0x03, 0x02, 0x06,
+		0x03, 0x07, 0x06, 0x02, 0x04, 0x00, 0x01, 0x05,
+		0x06, 0x02, 0x03, 0x07, 0x01, 0x05, 0x04, 0x00,
+		0x05, 0x01, 0x00, 0x04, 0x02, 0x06, 0x07, 0x03,
+		0x01, 0x05, 0x04, 0x00, 0x06, 0x02, 0x03, 0x07,
+		0x02, 0x06, 0x07, 0x03, 0x05, 0x01, 0x00, 0x04,
+		0x07, 0x03, 0x02, 0x06, 0x00, 0x04, 0x05, 0x01,
+		0x04, 0x00, 0x01, 0x05, 0x03, 0x07, 0x06, 0x02,
+		0x02, 0x06, 0x07, 0x03, 0x05, 0x01, 0x00, 0x04,
+		0x01, 0x05, 0x04, 0x00, 0x06, 0x02, 0x03, 0x07,
+		0x04, 0x00, 0x01, 0x05, 0x03, 0x07, 0x06, 0x02,
+		0x07, 0x03, 0x02, 0x06, 0x00, 0x04, 0x05, 0x01,
+		0x03, 0x07, 0x06, 0x02, 0x04, 0x00, 0x01, 0x05,
+		0x00, 0x04, 0x05, 0x01, 0x07, 0x03, 0x02, 0x06,
+		0x05, 0x01, 0x00, 0x04, 0x02, 0x06, 0x07, 0x03,
+		0x06, 0x02, 0x03, 0x07, 0x01, 0x05, 0x04, 0x00,
+		0x04, 0x00, 0x01, 0x05, 0x03, 0x07, 0x06, 0x02,
+		0x07, 0x03, 0x02, 0x06, 0x00, 0x04, 0x05, 0x01,
+		0x02, 0x06, 0x07, 0x03, 0x05, 0x01, 0x00, 0x04,
+		0x01, 0x05, 0x04, 0x00, 0x06, 0x02, 0x03, 0x07,
+		0x05, 0x01, 0x00, 0x04, 0x02, 0x06, 0x07, 0x03,
+		0x06, 0x02, 0x03, 0x07, 0x01, 0x05, 0x04, 0x00,
+		0x03, 0x07, 0x06, 0x02, 0x04, 0x00, 0x01, 0x05,
+		0x00, 0x04, 0x05, 0x01, 0x07, 0x03, 0x02, 0x06,
+		0x06, 0x02, 0x03, 0x07, 0x01, 0x05, 0x04, 0x00,
+		0x05, 0x01, 0x00, 0x04, 0x02, 0x06, 0x07, 0x03,
+		0x00, 0x04, 0x05, 0x01, 0x07, 0x03, 0x02, 0x06,
+		0x03, 0x07, 0x06, 0x02, 0x04, 0x00, 0x01, 0x05,
+		0x07, 0x03, 0x02, 0x06, 0x00, 0x04, 0x05, 0x01,
+		0x04, 0x00, 0x01, 0x05, 0x03, 0x07, 0x06, 0x02,
+		0x01, 0x05, 0x04, 0x00, 0x06, 0x02, 0x03, 0x07,
+		0x02, 0x06, 0x07, 0x03, 0x05, 0x01, 0x00, 0x04
+	},
+	{
+		0x00, 0x02, 0x04, 0x06, 0x05, 0x07, 0x01, 0x03,
+		0x07, 0x05, 0x03, 0x01, 0x02, 0x00, 0x06, 0x04,
+		0x03, 0x01, 0x07, 0x05, 0x06, 0x04, 0x02, 0x00,
+		0x04, 0x06, 0x00, 0x02, 0x01, 0x03, 0x05, 0x07,
+		0x06, 0x04, 0x02, 0x00, 0x03, 0x01, 0x07, 0x05,
+		0x01, 0x03, 0x05, 0x07, 0x04, 0x06, 0x00, 0x02,
+		0x05, 0x07, 0x01, 0x03, 0x00, 0x02, 0x04, 0x06,
+		0x02, 0x00, 0x06, 0x04, 0x07, 0x05, 0x03, 0x01,
+		0x01, 0x03, 0x05, 0x07, 0x04, 0x06, 0x00, 0x02,
+		0x06, 0x04, 0x02, 0x00, 0x03, 0x01, 0x07, 0x05,
+		0x02, 0x00, 0x06, 0x04, 0x07, 0x05, 0x03, 0x01,
+		0x05, 0x07, 0x01, 0x03, 0x00, 0x02, 0x04, 0x06,
+		0x07, 0x05, 0x03, 0x01, 0x02, 0x00, 0x06, 0x04,
+		0x00, 0x02, 0x04, 0x06, 0x05, 0x07, 0x01, 0x03,
+		0x04, 0x06, 0x00, 0x02, 0x01, 0x03, 0x05, 0x07,
+		0x03, 0x01, 0x07, 0x05, 0x06, 0x04, 0x02, 0x00,
+		0x02, 0x00, 0x06, 0x04, 0x07, 0x05, 0x03, 0x01,
+		0x05, 0x07, 0x01, 0x03, 0x00, 0x02, 0x04, 0x06,
+		0x01, 0x03, 0x05, 0x07, 0x04, 0x06, 0x00, 0x02,
+		0x06, 0x04, 0x02, 0x00, 0x03, 0x01, 0x07, 0x05,
+		0x04, 0x06, 0x00, 0x02, 0x01, 0x03, 0x05, 0x07,
+		0x03, 0x01, 0x07, 0x05, 0x06, 0x04, 0x02, 0x00,
+		0x07, 0x05, 0x03, 0x01, 0x02, 0x00, 0x06, 0x04,
+		0x00, 0x02, 0x04, 0x06, 0x05, 0x07, 0x01, 0x03,
+		0x03, 0x01, 0x07, 0x05, 0x06, 0x04, 0x02, 0x00,
+		0x04, 0x06, 0x00, 0x02, 0x01, 0x03, 0x05, 0x07,
+		0x00, 0x02, 0x04, 0x06, 0x05, 0x07, 0x01, 0x03,
+		0x07, 0x05, 0x03, 0x01, 0x02, 0x00, 0x06, 0x04,
+		0x05, 0x07, 0x01, 0x03, 0x00, 0x02, 0x04, 0x06,
+		0x02, 0x00, 0x06, 0x04, 0x07, 0x05, 0x03, 0x01,
+		0x06, 0x04, 0x02, 0x00, 0x03, 0x01, 0x07, 0x05,
+		0x01, 0x03, 0x05, 0x07, 0x04, 0x06, 0x00, 0x02
+	},
+	{
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x05, 0x04, 0x07, 0x06, 0x01, 0x00, 0x03, 0x02,
+		0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00,
+		0x02, 0x03, 0x00, 0x01, 0x06, 0x07, 0x04, 0x05,
+		0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04,
+		0x06, 0x07, 0x04, 0x05, 0x02, 0x03, 0x00, 0x01,
+		0x04, 0x05, 0x06, 0x07, 0x00, 0x01, 0x02, 0x03,
+		0x01, 0x00, 0x03, 0x02, 0x05, 0x04, 0x07, 0x06,
+		0x06, 0x07, 0x04, 0x05, 0x02, 0x03, 0x00, 0x01,
+		0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04,
+		0x01, 0x00, 0x03, 0x02, 0x05, 0x04, 0x07, 0x06,
+		0x04, 0x05, 0x06, 0x07, 0x00, 0x01, 0x02, 0x03,
+		0x05, 0x04, 0x07, 0x06, 0x01, 0x00, 0x03, 0x02,
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x02, 0x03, 0x00, 0x01, 0x06, 0x07, 0x04, 0x05,
+		0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00,
+		0x01, 0x00, 0x03, 0x02, 0x05, 0x04, 0x07, 0x06,
+		0x04, 0x05, 0x06, 0x07, 0x00, 0x01, 0x02, 0x03,
+		0x06, 0x07, 0x04, 0x05, 0x02, 0x03, 0x00, 0x01,
+		0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04,
+		0x02, 0x03, 0x00, 0x01, 0x06, 0x07, 0x04, 0x05,
+		0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00,
+		0x05, 0x04, 0x07, 0x06, 0x01, 0x00, 0x03, 0x02,
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00,
+		0x02, 0x03, 0x00, 0x01, 0x06, 0x07, 0x04, 0x05,
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x05, 0x04, 0x07, 0x06, 0x01, 0x00, 0x03, 0x02,
+		0x04, 0x05, 0x06, 0x07, 0x00, 0x01, 0x02, 0x03,
+		0x01, 0x00, 0x03, 0x02, 0x05, 0x04, 0x07, 0x06,
+		0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04,
+		0x06, 0x07, 0x04, 0x05, 0x02, 0x03, 0x00, 0x01
+	},
+	{
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+		0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+		0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+		0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+		0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+		0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+		0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+		0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06
+	}
+};
+
+
+/**
+ * @brief The pre-computed tables for CRC-7 computation, slicing-by-8
+ *
+ * Table k gives the CRC of one byte followed by k zero bytes. Table 0 is the
+ * classic byte-wise table.
+ */
+static const uint8_t crc_table_7[ROHC_CRC_SLICES][256] =
+{
+	{
+		0x00, 0x40, 0x73, 0x33, 0x15, 0x55, 0x66, 0x26,
+		0x2a, 0x6a, 0x59, 0x19, 0x3f, 0x7f, 0x4c, 0x0c,
+		0x54, 0x14, 0x27, 0x67, 0x41, 0x01, 0x32, 0x72,
+		0x7e, 0x3e, 0x0d, 0x4d, 0x6b, 0x2b, 0x18, 0x58,
+		0x5b, 0x1b, 0x28, 0x68, 0x4e, 0x0e, 0x3d, 0x7d,
+		0x71, 0x31, 0x02, 0x42, 0x64, 0x24, 0x17, 0x57,
+		0x0f, 0x4f, 0x7c, 0x3c, 0x1a, 0x5a, 0x69, 0x29,
+		0x25, 0x65, 0x56, 0x16, 0x30, 0x70, 0x43, 0x03,
+		0x45, 0x05, 0x36, 0x76, 0x50, 0x10, 0x23, 0x63,
+		0x6f, 0x2f, 0x1c, 0x5c, 0x7a, 0x3a, 0x09, 0x49,
+		0x11, 0x51, 0x62, 0x22, 0x04, 0x44, 0x77, 0x37,
+		0x3b, 0x7b, 0x48, 0x08, 0x2e, 0x6e, 0x5d, 0x1d,
+		0x1e, 0x5e, 0x6d, 0x2d, 0x0b, 0x4b, 0x78, 0x38,
+		0x34, 0x74, 0x47, 0x07, 0x21, 0x61, 0x52, 0x12,
+		0x4a, 0x0a, 0x39, 0x79, 0x5f, 0x1f, 0x2c, 0x6c,
+		0x60, 0x20, 0x13, 0x53, 0x75, 0x35, 0x06, 0x46,
+		0x79, 0x39, 0x0a, 0x4a, 0x6c, 0x2c, 0x1f, 0x5f,
+		0x53, 0x13, 0x20, 0x60, 0x46, 0x06, 0x35, 0x75,
+		0x2d, 0x6d, 0x5e, 0x1e, 0x38, 0x78, 0x4b, 0x0b,
+		0x07, 0x47, 0x74, 0x34, 0x12, 0x52, 0x61, 0x21,
+		0x22, 0x62, 0x51, 0x11, 0x37, 0x77, 0x44, 0x04,
+		0x08, 0x48, 0x7b, 0x3b, 0x1d, 0x5d, 0x6e, 0x2e,
+		0x76, 0x36, 0x05, 0x45, 0x63, 0x23, 0x10, 0x50,
+		0x5c, 0x1c, 0x2f, 0x6f, 0x49, 0x09, 0x3a, 0x7a,
+		0x3c, 0x7c, 0x4f, 0x0f, 0x29, 0x69, 0x5a, 0x1a,
+		0x16, 0x56, 0x65, 0x25, 0x03, 0x43, 0x70, 0x30,
+		0x68, 0x28, 0x1b, 0x5b, 0x7d, 0x3d, 0x0e, 0x4e,
+		0x42, 0x02, 0x31, 0x71, 0x57, 0x17, 0x24, 0x64,
+		0x67, 0x27, 0x14, 0x54, 0x72, 0x32, 0x01, 0x41,
+		0x4d, 0x0d, 0x3e, 0x7e, 0x58, 0x18, 0x2b, 0x6b,
+		0x33, 0x73, 0x40, 0x00, 0x26, 0x66, 0x55, 0x15,
+		0x19, 0x59, 0x6a, 0x2a, 0x0c, 0x4c, 0x7f, 0x3f
+	},
+	{
+		0x00, 0x45, 0x79, 0x3c, 0x01, 0x44, 0x78, 0x3d,
+		0x02, 0x47, 0x7b, 0x3e, 0x03, 0x46, 0x7a, 0x3f,
+		0x04, 0x41, 0x7d, 0x38, 0x05, 0x40, 0x7c, 0x39,
+		0x06, 0x43, 0x7f, 0x3a, 0x07, 0x42, 0x7e, 0x3b,
+		0x08, 0x4d, 0x71, 0x34, 0x09, 0x4c, 0x70, 0x35,
+		0x0a, 0x4f, 0x73, 0x36, 0x0b, 0x4e, 0x72, 0x37,
+		0x0c, 0x49, 0x75, 0x30, 0x0d, 0x48, 0x74, 0x31,
+		0x0e, 0x4b, 0x77, 0x32, 0x0f, 0x4a, 0x76, 0x33,
+		0x10, 0x55, 0x69, 0x2c, 0x11, 0x54, 0x68, 0x2d,
+		0x12, 0x57, 0x6b, 0x2e, 0x13, 0x56, 0x6a, 0x2f,
+		0x14, 0x51, 0x6d, 0x28, 0x15, 0x50, 0x6c, 0x29,
+		0x16, 0x53, 0x6f, 0x2a, 0x17, 0x52, 0x6e, 0x2b,
+		0x18, 0x5d, 0x61, 0x24, 0x19, 0x5c, 0x60, 0x25,
+		0x1a, 0x5f, 0x63, 0x26, 0x1b, 0x5e, 0x62, 0x27,
+		0x1c, 0x59, 0x65, 0x20, 0x1d, 0x58, 0x64, 0x21,
+		0x1e, 0x5b, 0x67, 0x22, 0x1f, 0x5a, 0x66, 0x23,
+		0x20, 0x65, 0x59, 0x1c, 0x21, 0x64, 0x58, 0x1d,
+		0x22, 0x67, 0x5b, 0x1e, 0x23, 0x66, 0x5a, 0x1f,
+		0x24, 0x61, 0x5d, 0x18, 0x25, 0x60, 0x5c, 0x19,
+		0x26, 0x63, 0x5f, 0x1a, 0x27, 0x62, 0x5e, 0x1b,
+		0x28, 0x6d, 0x51, 0x14, 0x29, 0x6c, 0x50, 0x15,
+		0x2a, 0x6f, 0x53, 0x16, 0x2b, 0x6e, 0x52, 0x17,
+		0x2c, 0x69, 0x55, 0x10, 0x2d, 0x68, 0x54, 0x11,
+		0x2e, 0x6b, 0x57, 0x12, 0x2f, 0x6a, 0x56, 0x13,
+		0x30, 0x75, 0x49, 0x0c, 0x31, 0x74, 0x48, 0x0d,
+		0x32, 0x77, 0x4b, 0x0e, 0x33, 0x76, 0x4a, 0x0f,
+		0x34, 0x71, 0x4d, 0x08, 0x35, 0x70, 0x4c, 0x09,
+		0x36, 0x73, 0x4f, 0x0a, 0x37, 0x72, 0x4e, 0x0b,
+		0x38, 0x7d, 0x41, 0x04, 0x39, 0x7c, 0x40, 0x05,
+		0x3a, 0x7f, 0x43, 0x06, 0x3b, 0x7e, 0x42, 0x07,
+		0x3c, 0x79, 0x45, 0x00, 0x3d, 0x78, 0x44, 0x01,
+		0x3e, 0x7b, 0x47, 0x02, 0x3f, 0x7a, 0x46, 0x03
+	},
+	{
+		0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70,
+		0x73, 0x63, 0x53, 0x43, 0x33, 0x23, 0x13, 0x03,
+		0x15, 0x05, 0x35, 0x25, 0x55, 0x45, 0x75, 0x65,
+		0x66, 0x76, 0x46, 0x56, 0x26, 0x36, 0x06, 0x16,
+		0x2a, 0x3a, 0x0a, 0x1a, 0x6a, 0x7a, 0x4a, 0x5a,
+		0x59, 0x49, 0x79, 0x69, 0x19, 0x09, 0x39, 0x29,
+		0x3f, 0x2f, 0x1f, 0x0f, 0x7f, 0x6f, 0x5f, 0x4f,
+		0x4c, 0x5c, 0x6c, 0x7c, 0x0c, 0x1c, 0x2c, 0x3c,
+		0x54, 0x44, 0x74, 0x64, 0x14, 0x04, 0x34, 0x24,
+		0x27, 0x37, 0x07, 0x17, 0x67, 0x77, 0x47, 0x57,
+		0x41, 0x51, 0x61, 0x71, 0x01, 0x11, 0x21, 0x31,
+		0x32, 0x22, 0x12, 0x02, 0x72, 0x62, 0x52, 0x42,
+		0x7e, 0x6e, 0x5e, 0x4e, 0x3e, 0x2e, 0x1e, 0x0e,
+		0x0d, 0x1d, 0x2d, 0x3d, 0x4d, 0x5d, 0x6d, 0x7d,
+		0x6b, 0x7b, 0x4b, 0x5b, 0x2b, 0x3b, 0x0b, 0x1b,
+		0x18, 0x08, 0x38, 0x28, 0x58, 0x48, 0x78, 0x68,
+		0x5b, 0x4b, 0x7b, 0x6b, 0x1b, 0x0b, 0x3b, 0x2b,
+		0x28, 0x38, 0x08, 0x18, 0x68, 0x78, 0x48, 0x58,
+		0x4e, 0x5e, 0x6e, 0x7e, 0x0e, 0x1e, 0x2e, 0x3e,
+		0x3d, 0x2d, 0x1d, 0x0d, 0x7d, 0x6d, 0x5d, 0x4d,
+		0x71, 0x61, 0x51, 0x41, 0x31, 0x21, 0x11, 0x01,
+		0x02, 0x12, 0x22, 0x32, 0x42, 0x52, 0x62, 0x72,
+		0x64, 0x74, 0x44, 0x54, 0x24, 0x34, 0x04, 0x14,
+		0x17, 0x07, 0x37, 0x27, 0x57, 0x47, 0x77, 0x67,
+		0x0f, 0x1f, 0x2f, 0x3f, 0x4f, 0x5f, 0x6f, 0x7f,
+		0x7c, 0x6c, 0x5c, 0x4c, 0x3c, 0x2c, 0x1c, 0x0c,
+		0x1a, 0x0a, 0x3a, 0x2a, 0x5a, 0x4a, 0x7a, 0x6a,
+		0x69, 0x79, 0x49, 0x59, 0x29, 0x39, 0x09, 0x19,
+		0x25, 0x35, 0x05, 0x15, 0x65, 0x75, 0x45, 0x55,
+		0x56, 0x46, 0x76, 0x66, 0x16, 0x06, 0x36, 0x26,
+		0x30, 0x20, 0x10, 0x00, 0x70, 0x60, 0x50, 0x40,
+		0x43, 0x53, 0x63, 0x73, 0x03, 0x13, 0x23, 0x33
+	},
+	{
+		0x00, 0x54, 0x5b, 0x0f, 0x45, 0x11, 0x1e, 0x4a,
+		0x79, 0x2d, 0x22, 0x76, 0x3c, 0x68, 0x67, 0x33,
+		0x01, 0x55, 0x5a, 0x0e, 0x44, 0x10, 0x1f, 0x4b,
+		0x78, 0x2c, 0x23, 0x77, 0x3d, 0x69, 0x66, 0x32,
+		0x02, 0x56, 0x59, 0x0d, 0x47, 0x13, 0x1c, 0x48,
+		0x7b, 0x2f, 0x20, 0x74, 0x3e, 0x6a, 0x65, 0x31,
+		0x03, 0x57, 0x58, 0x0c, 0x46, 0x12, 0x1d, 0x49,
+		0x7a, 0x2e, 0x21, 0x75, 0x3f, 0x6b, 0x64, 0x30,
+		0x04, 0x50, 0x5f, 0x0b, 0x41, 0x15, 0x1a, 0x4e,
+		0x7d, 0x29, 0x26, 0x72, 0x38, 0x6c, 0x63, 0x37,
+		0x05, 0x51, 0x5e, 0x0a, 0x40, 0x14, 0x1b, 0x4f,
+		0x7c, 0x28, 0x27, 0x73, 0x39, 0x6d, 0x62, 0x36,
+		0x06, 0x52, 0x5d, 0x09, 0x43, 0x17, 0x18, 0x4c,
+		0x7f, 0x2b, 0x24, 0x70, 0x3a, 0x6e, 0x61, 0x35,
+		0x07, 0x53, 0x5c, 0x08, 0x42, 0x16, 0x19, 0x4d,
+		0x7e, 0x2a, 0x25, 0x71, 0x3b, 0x6f, 0x60, 0x34,
+		0x08, 0x5c, 0x53, 0x07, 0x4d, 0x19, 0x16, 0x42,
+		0x71, 0x25, 0x2a, 0x7e, 0x34, 0x60, 0x6f, 0x3b,
+		0x09, 0x5d, 0x52, 0x06, 0x4c, 0x18, 0x17, 0x43,
+		0x70, 0x24, 0x2b, 0x7f, 0x35, 0x61, 0x6e, 0x3a,
+		0x0a, 0x5e, 0x51, 0x05, 0x4f, 0x1b, 0x14, 0x40,
+		0x73, 0x27, 0x28, 0x7c, 0x36, 0x62, 0x6d, 0x39,
+		0x0b, 0x5f, 0x50, 0x04, 0x4e, 0x1a, 0x15, 0x41,
+		0x72, 0x26, 0x29, 0x7d, 0x37, 0x63, 0x6c, 0x38,
+		0x0c, 0x58, 0x57, 0x03, 0x49, 0x1d, 0x12, 0x46,
+		0x75, 0x21, 0x2e, 0x7a, 0x30, 0x64, 0x6b, 0x3f,
+		0x0d, 0x59, 0x56, 0x02, 0x48, 0x1c, 0x13, 0x47,
+		0x74, 0x20, 0x2f, 0x7b, 0x31, 0x65, 0x6a, 0x3e,
+		0x0e, 0x5a, 0x55, 0x01, 0x4b, 0x1f, 0x10, 0x44,
+		0x77, 0x23, 0x2c, 0x78, 0x32, 0x66, 0x69, 0x3d,
+		0x0f, 0x5b, 0x54, 0x00, 0x4a, 0x1e, 0x11, 0x45,
+		0x76, 0x22, 0x2d, 0x79, 0x33, 0x67, 0x68, 0x3c
+	},
+	{
+		0x00, 0x04, 0x08, 0x0c, 0x10, 0x14, 0x18, 0x1c,
+		0x20, 0x24, 0x28, 0x2c, 0x30, 0x34, 0x38, 0x3c,
+		0x40, 0x44, 0x48, 0x4c, 0x50, 0x54, 0x58, 0x5c,
+		0x60, 0x64, 0x68, 0x6c, 0x70, 0x74, 0x78, 0x7c,
+		0x73, 0x77, 0x7b, 0x7f, 0x63, 0x67, 0x6b, 0x6f,
+		0x53, 0x57, 0x5b, 0x5f, 0x43, 0x47, 0x4b, 0x4f,
+		0x33, 0x37, 0x3b, 0x3f, 0x23, 0x27, 0x2b, 0x2f,
+		0x13, 0x17, 0x1b, 0x1f, 0x03, 0x07, 0x0b, 0x0f,
+		0x15, 0x11, 0x1d, 0x19, 0x05, 0x01, 0x0d, 0x09,
+		0x35, 0x31, 0x3d, 0x39, 0x25, 0x21, 0x2d, 0x29,
+		0x55, 0x51, 0x5d, 0x59, 0x45, 0x41, 0x4d, 0x49,
+		0x75, 0x71, 0x7d, 0x79, 0x65, 0x61, 0x6d, 0x69,
+		0x66, 0x62, 0x6e, 0x6a, 0x76, 0x72, 0x7e, 0x7a,
+		0x46, 0x42, 0x4e, 0x4a, 0x56, 0x52, 0x5e, 0x5a,
+		0x26, 0x22, 0x2e, 0x2a, 0x36, 0x32, 0x3e, 0x3a,
+		0x06, 0x02, 0x0e, 0x0a, 0x16, 0x12, 0x1e, 0x1a,
+		0x2a, 0x2e, 0x22, 0x26, 0x3a, 0x3e, 0x32, 0x36,
+		0x0a, 0x0e, 0x02, 0x06, 0x1a, 0x1e, 0x12, 0x16,
+		0x6a, 0x6e, 0x62, 0x66, 0x7a, 0x7e, 0x72, 0x76,
+		0x4a, 0x4e, 0x42, 0x46, 0x5a, 0x5e, 0x52, 0x56,
+		0x59, 0x5d, 0x51, 0x55, 0x49, 0x4d, 0x41, 0x45,
+		0x79, 0x7d, 0x71, 0x75, 0x69, 0x6d, 0x61, 0x65,
+		0x19, 0x1d, 0x11, 0x15, 0x09, 0x0d, 0x01, 0x05,
+		0x39, 0x3d, 0x31, 0x35, 0x29, 0x2d, 0x21, 0x25,
+		0x3f, 0x3b, 0x37, 0x33, 0x2f, 0x2b, 0x27, 0x23,
+		0x1f, 0x1b, 0x17, 0x13, 0x0f, 0x0b, 0x07, 0x03,
+		0x7f, 0x7b, 0x77, 0x73, 0x6f, 0x6b, 0x67, 0x63,
+		0x5f, 0x5b, 0x57, 0x53, 0x4f, 0x4b, 0x47, 0x43,
+		0x4c, 0x48, 0x44, 0x40, 0x5c, 0x58, 0x54, 0x50,
+		0x6c, 0x68, 0x64, 0x60, 0x7c, 0x78, 0x74, 0x70,
+		0x0c, 0x08, 0x04, 0x00, 0x1c, 0x18, 0x14, 0x10,
+		0x2c, 0x28, 0x24, 0x20, 0x3c, 0x38, 0x34, 0x30
+	},
+	{
+		0x00, 0x15, 0x2a, 0x3f, 0x54, 0x41, 0x7e, 0x6b,
+		0x5b, 0x4e, 0x71, 0x64, 0x0f, 0x1a, 0x25, 0x30,
+		0x45, 0x50, 0x6f, 0x7a, 0x11, 0x04, 0x3b, 0x2e,
+		0x1e, 0x0b, 0x34, 0x21, 0x4a, 0x5f, 0x60, 0x75,
+		0x79, 0x6c, 0x53, 0x46, 0x2d, 0x38, 0x07, 0x12,
+		0x22, 0x37, 0x08, 0x1d, 0x76, 0x63, 0x5c, 0x49,
+		0x3c, 0x29, 0x16, 0x03, 0x68, 0x7d, 0x42, 0x57,
+		0x67, 0x72, 0x4d, 0x58, 0x33, 0x26, 0x19, 0x0c,
+		0x01, 0x14, 0x2b, 0x3e, 0x55, 0x40, 0x7f, 0x6a,
+		0x5a, 0x4f, 0x70, 0x65, 0x0e, 0x1b, 0x24, 0x31,
+		0x44, 0x51, 0x6e, 0x7b, 0x10, 0x05, 0x3a, 0x2f,
+		0x1f, 0x0a, 0x35, 0x20, 0x4b, 0x5e, 0x61, 0x74,
+		0x78, 0x6d, 0x52, 0x47, 0x2c, 0x39, 0x06, 0x13,
+		0x23, 0x36, 0x09, 0x1c, 0x77, 0x62, 0x5d, 0x48,
+		0x3d, 0x28, 0x17, 0x02, 0x69, 0x7c, 0x43, 0x56,
+		0x66, 0x73, 0x4c, 0x59, 0x32, 0x27, 0x18, 0x0d,
+		0x02, 0x17, 0x28, 0x3d, 0x56, 0x43, 0x7c, 0x69,
+		0x59, 0x4c, 0x73, 0x66, 0x0d, 0x18, 0x27, 0x32,
+		0x47, 0x52, 0x6d, 0x78, 0x13, 0x06, 0x39, 0x2c,
+		0x1c, 0x09, 0x36, 0x23, 0x48, 0x5d, 0x62, 0x77,
+		0x7b, 0x6e, 0x51, 0x44, 0x2f, 0x3a, 0x05, 0x10,
+		0x20, 0x35, 0x0a, 0x1f, 0x74, 0x61, 0x5e, 0x4b,
+		0x3e, 0x2b, 0x14, 0x01, 0x6a, 0x7f, 0x40, 0x55,
+		0x65, 0x70, 0x4f, 0x5a, 0x31, 0x24, 0x1b, 0x0e,
+		0x03, 0x16, 0x29, 0x3c, 0x57, 0x42, 0x7d, 0x68,
+		0x58, 0x4d, 0x72, 0x67, 0x0c, 0x19, 0x26, 0x33,
+		0x46, 0x53, 0x6c, 0x79, 0x12, 0x07, 0x38, 0x2d,
+		0x1d, 0x08, 0x37, 0x22, 0x49, 0x5c, 0x63, 0x76,
+		0x7a, 0x6f, 0x50, 0x45, 0x2e, 0x3b, 0x04, 0x11,
+		0x21, 0x34, 0x0b, 0x1e, 0x75, 0x60, 0x5f, 0x4a,
+		0x3f, 0x2a, 0x15, 0x00, 0x6b, 0x7e, 0x41, 0x54,
+		0x64, 0x71, 0x4e, 0x5b, 0x30, 0x25, 0x1a, 0x0f
+	},
+	{
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+		0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+		0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+		0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+		0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+		0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+		0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+		0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f,
+		0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+		0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
+		0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+		0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+		0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+		0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f,
+		0x73, 0x72, 0x71, 0x70, 0x77, 0x76, 0x75, 0x74,
+		0x7b, 0x7a, 0x79, 0x78, 0x7f, 0x7e, 0x7d, 0x7c,
+		0x63, 0x62, 0x61, 0x60, 0x67, 0x66, 0x65, 0x64,
+		0x6b, 0x6a, 0x69, 0x68, 0x6f, 0x6e, 0x6d, 0x6c,
+		0x53, 0x52, 0x51, 0x50, 0x57, 0x56, 0x55, 0x54,
+		0x5b, 0x5a, 0x59, 0x58, 0x5f, 0x5e, 0x5d, 0x5c,
+		0x43, 0x42, 0x41, 0x40, 0x47, 0x46, 0x45, 0x44,
+		0x4b, 0x4a, 0x49, 0x48, 0x4f, 0x4e, 0x4d, 0x4c,
+		0x33, 0x32, 0x31, 0x30, 0x37, 0x36, 0x35, 0x34,
+		0x3b, 0x3a, 0x39, 0x38, 0x3f, 0x3e, 0x3d, 0x3c,
+		0x23, 0x22, 0x21, 0x20, 0x27, 0x26, 0x25, 0x24,
+		0x2b, 0x2a, 0x29, 0x28, 0x2f, 0x2e, 0x2d, 0x2c,
+		0x13, 0x12, 0x11, 0x10, 0x17, 0x16, 0x15, 0x14,
+		0x1b, 0x1a, 0x19, 0x18, 0x1f, 0x1e, 0x1d, 0x1c,
+		0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04,
+		0x0b, 0x0a, 0x09, 0x08, 0x0f, 0x0e, 0x0d, 0x0c
+	},
+	{
+		0x00, 0x40, 0x73, 0x33, 0x15, 0x55, 0x66, 0x26,
+		0x2a, 0x6a, 0x59, 0x19, 0x3f, 0x7f, 0x4c, 0x0c,
+		0x54, 0x14, 0x27, 0x67, 0x41, 0x01, 0x32, 0x72,
+		0x7e, 0x3e, 0x0d, 0x4d, 0x6b, 0x2b, 0x18, 0x58,
+		0x5b, 0x1b, 0x28, 0x68, 0x4e, 0x0e, 0x3d, 0x7d,
+		0x71, 0x31, 0x02, 0x42, 0x64, 0x24, 0x17, 0x57,
+		0x0f, 0x4f, 0x7c, 0x3c, 0x1a, 0x5a, 0x69, 0x29,
+		0x25, 0x65, 0x56, 0x16, 0x30, 0x70, 0x43, 0x03,
+		0x45, 0x05, 0x36, 0x76, 0x50, 0x10, 0x23, 0x63,
+		0x6f, 0x2f, 0x1c, 0x5c, 0x7a, 0x3a, 0x09, 0x49,
+		0x11, 0x51, 0x62, 0x22, 0x04, 0x44, 0x77, 0x37,
+		0x3b, 0x7b, 0x48, 0x08, 0x2e, 0x6e, 0x5d, 0x1d,
+		0x1e, 0x5e, 0x6d, 0x2d, 0x0b, 0x4b, 0x78, 0x38,
+		0x34, 0x74, 0x47, 0x07, 0x21, 0x61, 0x52, 0x12,
+		0x4a, 0x0a, 0x39, 0x79, 0x5f, 0x1f, 0x2c, 0x6c,
+		0x60, 0x20, 0x13, 0x53, 0x75, 0x35, 0x06, 0x46,
+		0x79, 0x39, 0x0a, 0x4a, 0x6c, 0x2c, 0x1f, 0x5f,
+		0x53, 0x13, 0x20, 0x60, 0x46, 0x06, 0x35, 0x75,
+		0x2d, 0x6d, 0x5e, 0x1e, 0x38, 0x78, 0x4b, 0x0b,
+		0x07, 0x47, 0x74, 0x34, 0x12, 0x52, 0x61, 0x21,
+		0x22, 0x62, 0x51, 0x11, 0x37, 0x77, 0x44, 0x04,
+		0x08, 0x48, 0x7b, 0x3b, 0x1d, 0x5d, 0x6e, 0x2e,
+		0x76, 0x36, 0x05, 0x45, 0x63, 0x23, 0x10, 0x50,
+		0x5c, 0x1c, 0x2f, 0x6f, 0x49, 0x09, 0x3a, 0x7a,
+		0x3c, 0x7c, 0x4f, 0x0f, 0x29, 0x69, 0x5a, 0x1a,
+		0x16, 0x56, 0x65, 0x25, 0x03, 0x43, 0x70, 0x30,
+		0x68, 0x28, 0x1b, 0x5b, 0x7d, 0x3d, 0x0e, 0x4e,
+		0x42, 0x02, 0x31, 0x71, 0x57, 0x17, 0x24, 0x64,
+		0x67, 0x27, 0x14, 0x54, 0x72, 0x32, 0x01, 0x41,
+		0x4d, 0x0d, 0x3e, 0x7e, 0x58, 0x18, 0x2b, 0x6b,
+		0x33, 0x73, 0x40, 0x00, 0x26, 0x66, 0x55, 0x15,
+		0x19, 0x59, 0x6a, 0x2a, 0x0c, 0x4c, 0x7f, 0x3f
+	}
+};
+
+
+/**
+ * @brief The pre-computed tables for CRC-8 computation, slicing-by-8
+ *
+ * Table k gives the CRC of one byte followed by k zero bytes. Table 0 is the
+ * classic byte-wise table.
+ */
+static const uint8_t crc_table_8[ROHC_CRC_SLICES][256] =
+{
+	{
+		0x00, 0x91, 0xe3, 0x72, 0x07, 0x96, 0xe4, 0x75,
+		0x0e, 0x9f, 0xed, 0x7c, 0x09, 0x98, 0xea, 0x7b,
+		0x1c, 0x8d, 0xff, 0x6e, 0x1b, 0x8a, 0xf8, 0x69,
+		0x12, 0x83, 0xf1, 0x60, 0x15, 0x84, 0xf6, 0x67,
+		0x38, 0xa9, 0xdb, 0x4a, 0x3f, 0xae, 0xdc, 0x4d,
+		0x36, 0xa7, 0xd5, 0x44, 0x31, 0xa0, 0xd2, 0x43,
+		0x24, 0xb5, 0xc7, 0x56, 0x23, 0xb2, 0xc0, 0x51,
+		0x2a, 0xbb, 0xc9, 0x58, 0x2d, 0xbc, 0xce, 0x5f,
+		0x70, 0xe1, 0x93, 0x02, 0x77, 0xe6, 0x94, 0x05,
+		0x7e, 0xef, 0x9d, 0x0c, 0x79, 0xe8, 0x9a, 0x0b,
+		0x6c, 0xfd, 0x8f, 0x1e, 0x6b, 0xfa, 0x88, 0x19,
+		0x62, 0xf3, 0x81, 0x10, 0x65, 0xf4, 0x86, 0x17,
+		0x48, 0xd9, 0xab, 0x3a, 0x4f, 0xde, 0xac, 0x3d,
+		0x46, 0xd7, 0xa5, 0x34, 0x41, 0xd0, 0xa2, 0x33,
+		0x54, 0xc5, 0xb7, 0x26, 0x53, 0xc2, 0xb0, 0x21,
+		0x5a, 0xcb, 0xb9, 0x28, 0x5d, 0xcc, 0xbe, 0x2f,
+		0xe0, 0x71, 0x03, 0x92, 0xe7, 0x76, 0x04, 0x95,
+		0xee, 0x7f, 0x0d, 0x9c, 0xe9, 0x78, 0x0a, 0x9b,
+		0xfc, 0x6d, 0x1f, 0x8e, 0xfb, 0x6a, 0x18, 0x89,
+		0xf2, 0x63, 0x11, 0x80, 0xf5, 0x64, 0x16, 0x87,
+		0xd8, 0x49, 0x3b, 0xaa, 0xdf, 0x4e, 0x3c, 0xad,
+		0xd6, 0x47, 0x35, 0xa4, 0xd1, 0x40, 0x32, 0xa3,
+		0xc4, 0x55, 0x27, 0xb6, 0xc3, 0x52, 0x20, 0xb1,
+		0xca, 0x5b, 0x29, 0xb8, 0xcd, 0x5c, 0x2e, 0xbf,
+		0x90, 0x01, 0x73, 0xe2, 0x97, 0x06, 0x74, 0xe5,
+		0x9e, 0x0f, 0x7d, 0xec, 0x99, 0x08, 0x7a, 0xeb,
+		0x8c, 0x1d, 0x6f, 0xfe, 0x8b, 0x1a, 0x68, 0xf9,
+		0x82, 0x13, 0x61, 0xf0, 0x85, 0x14, 0x66, 0xf7,
+		0xa8, 0x39, 0x4b, 0xda, 0xaf, 0x3e, 0x4c, 0xdd,
+		0xa6, 0x37, 0x45, 0xd4, 0xa1, 0x30, 0x42, 0xd3,
+		0xb4, 0x25, 0x57, 0xc6, 0xb3, 0x22, 0x50, 0xc1,
+		0xba, 0x2b, 0x59, 0xc8, 0xbd, 0x2c, 0x5e, 0xcf
+	},
+	{
+		0x00, 0x6d, 0xda, 0xb7, 0x75, 0x18, 0xaf, 0xc2,
+		0xea, 0x87, 0x30, 0x5d, 0x9f, 0xf2, 0x45, 0x28,
+		0x15, 0x78, 0xcf, 0xa2, 0x60, 0x0d, 0xba, 0xd7,
+		0xff, 0x92, 0x25, 0x48, 0x8a, 0xe7, 0x50, 0x3d,
+		0x2a, 0x47, 0xf0, 0x9d, 0x5f, 0x32, 0x85, 0xe8,
+		0xc0, 0xad, 0x1a, 0x77, 0xb5, 0xd8, 0x6f, 0x02,
+		0x3f, 0x52, 0xe5, 0x88, 0x4a, 0x27, 0x90, 0xfd,
+		0xd5, 0xb8, 0x0f, 0x62, 0xa0, 0xcd, 0x7a, 0x17,
+		0x54, 0x39, 0x8e, 0xe3, 0x21, 0x4c, 0xfb, 0x96,
+		0xbe, 0xd3, 0x64, 0x09, 0xcb, 0xa6, 0x11, 0x7c,
+		0x41, 0x2c, 0x9b, 0xf6, 0x34, 0x59, 0xee, 0x83,
+		0xab, 0xc6, 0x71, 0x1c, 0xde, 0xb3, 0x04, 0x69,
+		0x7e, 0x13, 0xa4, 0xc9, 0x0b, 0x66, 0xd1, 0xbc,
+		0x94, 0xf9, 0x4e, 0x23, 0xe1, 0x8c, 0x3b, 0x56,
+		0x6b, 0x06, 0xb1, 0xdc, 0x1e, 0x73, 0xc4, 0xa9,
+		0x81, 0xec, 0x5b, 0x36, 0xf4, 0x99, 0x2e, 0x43,
+		0xa8, 0xc5, 0x72, 0x1f, 0xdd, 0xb0, 0x07, 0x6a,
+		0x42, 0x2f, 0x98, 0xf5, 0x37, 0x5a, 0xed, 0x80,
+		0xbd, 0xd0, 0x67, 0x0a, 0xc8, 0xa5, 0x12, 0x7f,
+		0x57, 0x3a, 0x8d, 0xe0, 0x22, 0x4f, 0xf8, 0x95,
+		0x82, 0xef, 0x58, 0x35, 0xf7, 0x9a, 0x2d, 0x40,
+		0x68, 0x05, 0xb2, 0xdf, 0x1d, 0x70, 0xc7, 0xaa,
+		0x97, 0xfa, 0x4d, 0x20, 0xe2, 0x8f, 0x38, 0x55,
+		0x7d, 0x10, 0xa7, 0xca, 0x08, 0x65, 0xd2, 0xbf,
+		0xfc, 0x91, 0x26, 0x4b, 0x89, 0xe4, 0x53, 0x3e,
+		0x16, 0x7b, 0xcc, 0xa1, 0x63, 0x0e, 0xb9, 0xd4,
+		0xe9, 0x84, 0x33, 0x5e, 0x9c, 0xf1, 0x46, 0x2b,
+		0x03, 0x6e, 0xd9, 0xb4, 0x76, 0x1b, 0xac, 0xc1,
+		0xd6, 0xbb, 0x0c, 0x61, 0xa3, 0xce, 0x79, 0x14,
+		0x3c, 0x51, 0xe6, 0x8b, 0x49, 0x24, 0x93, 0xfe,
+		0xc3, 0xae, 0x19, 0x74, 0xb6, 0xdb, 0x6c, 0x01,
+		0x29, 0x44, 0xf3, 0x9e, 0x5c, 0x31, 0x86, 0xeb
+	},
+	{
+		0x00, 0xd0, 0x61, 0xb1, 0xc2, 0x12, 0xa3, 0x73,
+		0x45, 0x95, 0x24, 0xf4, 0x87, 0x57, 0xe6, 0x36,
+		0x8a, 0x5a, 0xeb, 0x3b, 0x48, 0x98, 0x29, 0xf9,
+		0xcf, 0x1f, 0xae, 0x7e, 0x0d, 0xdd, 0x6c, 0xbc,
+		0xd5, 0x05, 0xb4, 0x64, 0x17, 0xc7, 0x76, 0xa6,
+		0x90, 0x40, 0xf1, 0x21, 0x52, 0x82, 0x33, 0xe3,
+		0x5f, 0x8f, 0x3e, 0xee, 0x9d, 0x4d, 0xfc, 0x2c,
+		0x1a, 0xca, 0x7b, 0xab, 0xd8, 0x08, 0xb9, 0x69,
+		0x6b, 0xbb, 0x0a, 0xda, 0xa9, 0x79, 0xc8, 0x18,
+		0x2e, 0xfe, 0x4f, 0x9f, 0xec, 0x3c, 0x8d, 0x5d,
+		0xe1, 0x31, 0x80, 0x50, 0x23, 0xf3, 0x42, 0x92,
+		0xa4, 0x74, 0xc5, 0x15, 0x66, 0xb6, 0x07, 0xd7,
+		0xbe, 0x6e, 0xdf, 0x0f, 0x7c, 0xac, 0x1d, 0xcd,
+		0xfb, 0x2b, 0x9a, 0x4a, 0x39, 0xe9, 0x58, 0x88,
+		0x34, 0xe4, 0x55, 0x85, 0xf6, 0x26, 0x97, 0x47,
+		0x71, 0xa1, 0x10, 0xc0, 0xb3, 0x63, 0xd2, 0x02,
+		0xd6, 0x06, 0xb7, 0x67, 0x14, 0xc4, 0x75, 0xa5,
+		0x93, 0x43, 0xf2, 0x22, 0x51, 0x81, 0x30, 0xe0,
+		0x5c, 0x8c, 0x3d, 0xed, 0x9e, 0x4e, 0xff, 0x2f,
+		0x19, 0xc9, 0x78, 0xa8, 0xdb, 0x0b, 0xba, 0x6a,
+		0x03, 0xd3, 0x62, 0xb2, 0xc1, 0x11, 0xa0, 0x70,
+		0x46, 0x96, 0x27, 0xf7, 0x84, 0x54, 0xe5, 0x35,
+		0x89, 0x59, 0xe8, 0x38, 0x4b, 0x9b, 0x2a, 0xfa,
+		0xcc, 0x1c, 0xad, 0x7d, 0x0e, 0xde, 0x6f, 0xbf,
+		0xbd, 0x6d, 0xdc, 0x0c, 0x7f, 0xaf, 0x1e, 0xce,
+		0xf8, 0x28, 0x99, 0x49, 0x3a, 0xea, 0x5b, 0x8b,
+		0x37, 0xe7, 0x56, 0x86, 0xf5, 0x25, 0x94, 0x44,
+		0x72, 0xa2, 0x13, 0xc3, 0xb0, 0x60, 0xd1, 0x01,
+		0x68, 0xb8, 0x09, 0xd9, 0xaa, 0x7a, 0xcb, 0x1b,
+		0x2d, 0xfd, 0x4c, 0x9c, 0xef, 0x3f, 0x8e, 0x5e,
+		0xe2, 0x32, 0x83, 0x53, 0x20, 0xf0, 0x41, 0x91,
+		0xa7, 0x77, 0xc6, 0x16, 0x65, 0xb5, 0x04, 0xd4
+	},
+	{
+		0x00, 0x8c, 0xd9, 0x55, 0x73, 0xff, 0xaa, 0x26,
+		0xe6, 0x6a, 0x3f, 0xb3, 0x95, 0x19, 0x4c, 0xc0,
+		0x0d, 0x81, 0xd4, 0x58, 0x7e, 0xf2, 0xa7, 0x2b,
+		0xeb, 0x67, 0x32, 0xbe, 0x98, 0x14, 0x41, 0xcd,
+		0x1a, 0x96, 0xc3, 0x4f, 0x69, 0xe5, 0xb0, 0x3c,
+		0xfc, 0x70, 0x25, 0xa9, 0x8f, 0x03, 0x56, 0xda,
+		0x17, 0x9b, 0xce, 0x42, 0x64, 0xe8, 0xbd, 0x31,
+		0xf1, 0x7d, 0x28, 0xa4, 0x82, 0x0e, 0x5b, 0xd7,
+		0x34, 0xb8, 0xed, 0x61, 0x47, 0xcb, 0x9e, 0x12,
+		0xd2, 0x5e, 0x0b, 0x87, 0xa1, 0x2d, 0x78, 0xf4,
+		0x39, 0xb5, 0xe0, 0x6c, 0x4a, 0xc6, 0x93, 0x1f,
+		0xdf, 0x53, 0x06, 0x8a, 0xac, 0x20, 0x75, 0xf9,
+		0x2e, 0xa2, 0xf7, 0x7b, 0x5d, 0xd1, 0x84, 0x08,
+		0xc8, 0x44, 0x11, 0x9d, 0xbb, 0x37, 0x62, 0xee,
+		0x23, 0xaf, 0xfa, 0x76, 0x50, 0xdc, 0x89, 0x05,
+		0xc5, 0x49, 0x1c, 0x90, 0xb6, 0x3a, 0x6f, 0xe3,
+		0x68, 0xe4, 0xb1, 0x3d, 0x1b, 0x97, 0xc2, 0x4e,
+		0x8e, 0x02, 0x57, 0xdb, 0xfd, 0x71, 0x24, 0xa8,
+		0x65, 0xe9, 0xbc, 0x30, 0x16, 0x9a, 0xcf, 0x43,
+		0x83, 0x0f, 0x5a, 0xd6, 0xf0, 0x7c, 0x29, 0xa5,
+		0x72, 0xfe, 0xab, 0x27, 0x01, 0x8d, 0xd8, 0x54,
+		0x94, 0x18, 0x4d, 0xc1, 0xe7, 0x6b, 0x3e, 0xb2,
+		0x7f, 0xf3, 0xa6, 0x2a, 0x0c, 0x80, 0xd5, 0x59,
+		0x99, 0x15, 0x40, 0xcc, 0xea, 0x66, 0x33, 0xbf,
+		0x5c, 0xd0, 0x85, 0x09, 0x2f, 0xa3, 0xf6, 0x7a,
+		0xba, 0x36, 0x63, 0xef, 0xc9, 0x45, 0x10, 0x9c,
+		0x51, 0xdd, 0x88, 0x04, 0x22, 0xae, 0xfb, 0x77,
+		0xb7, 0x3b, 0x6e, 0xe2, 0xc4, 0x48, 0x1d, 0x91,
+		0x46, 0xca, 0x9f, 0x13, 0x35, 0xb9, 0xec, 0x60,
+		0xa0, 0x2c, 0x79, 0xf5, 0xd3, 0x5f, 0x0a, 0x86,
+		0x4b, 0xc7, 0x92, 0x1e, 0x38, 0xb4, 0xe1, 0x6d,
+		0xad, 0x21, 0x74, 0xf8, 0xde, 0x52, 0x07, 0x8b
+	},
+	{
+		0x00, 0xe9, 0x13, 0xfa, 0x26, 0xcf, 0x35, 0xdc,
+		0x4c, 0xa5, 0x5f, 0xb6, 0x6a, 0x83, 0x79, 0x90,
+		0x98, 0x71, 0x8b, 0x62, 0xbe, 0x57, 0xad, 0x44,
+		0xd4, 0x3d, 0xc7, 0x2e, 0xf2, 0x1b, 0xe1, 0x08,
+		0xf1, 0x18, 0xe2, 0x0b, 0xd7, 0x3e, 0xc4, 0x2d,
+		0xbd, 0x54, 0xae, 0x47, 0x9b, 0x72, 0x88, 0x61,
+		0x69, 0x80, 0x7a, 0x93, 0x4f, 0xa6, 0x5c, 0xb5,
+		0x25, 0xcc, 0x36, 0xdf, 0x03, 0xea, 0x10, 0xf9,
+		0x23, 0xca, 0x30, 0xd9, 0x05, 0xec, 0x16, 0xff,
+		0x6f, 0x86, 0x7c, 0x95, 0x49, 0xa0, 0x5a, 0xb3,
+		0xbb, 0x52, 0xa8, 0x41, 0x9d, 0x74, 0x8e, 0x67,
+		0xf7, 0x1e, 0xe4, 0x0d, 0xd1, 0x38, 0xc2, 0x2b,
+		0xd2, 0x3b, 0xc1, 0x28, 0xf4, 0x1d, 0xe7, 0x0e,
+		0x9e, 0x77, 0x8d, 0x64, 0xb8, 0x51, 0xab, 0x42,
+		0x4a, 0xa3, 0x59, 0xb0, 0x6c, 0x85, 0x7f, 0x96,
+		0x06, 0xef, 0x15, 0xfc, 0x20, 0xc9, 0x33, 0xda,
+		0x46, 0xaf, 0x55, 0xbc, 0x60, 0x89, 0x73, 0x9a,
+		0x0a, 0xe3, 0x19, 0xf0, 0x2c, 0xc5, 0x3f, 0xd6,
+		0xde, 0x37, 0xcd, 0x24, 0xf8, 0x11, 0xeb, 0x02,
+		0x92, 0x7b, 0x81, 0x68, 0xb4, 0x5d, 0xa7, 0x4e,
+		0xb7, 0x5e, 0xa4, 0x4d, 0x91, 0x78, 0x82, 0x6b,
+		0xfb, 0x12, 0xe8, 0x01, 0xdd, 0x34, 0xce, 0x27,
+		0x2f, 0xc6, 0x3c, 0xd5, 0x09, 0xe0, 0x1a, 0xf3,
+		0x63, 0x8a, 0x70, 0x99, 0x45, 0xac, 0x56, 0xbf,
+		0x65, 0x8c, 0x76, 0x9f, 0x43, 0xaa, 0x50, 0xb9,
+		0x29, 0xc0, 0x3a, 0xd3, 0x0f, 0xe6, 0x1c, 0xf5,
+		0xfd, 0x14, 0xee, 0x07, 0xdb, 0x32, 0xc8, 0x21,
+		0xb1, 0x58, 0xa2, 0x4b, 0x97, 0x7e, 0x84, 0x6d,
+		0x94, 0x7d, 0x87, 0x6e, 0xb2, 0x5b, 0xa1, 0x48,
+		0xd8, 0x31, 0xcb, 0x22, 0xfe, 0x17, 0xed, 0x04,
+		0x0c, 0xe5, 0x1f, 0xf6, 0x2a, 0xc3, 0x39, 0xd0,
+		0x40, 0xa9, 0x53, 0xba, 0x66, 0x8f, 0x75, 0x9c
+	},
+	{
+		0x00, 0x37, 0x6e, 0x59, 0xdc, 0xeb, 0xb2, 0x85,
+		0x79, 0x4e, 0x17, 0x20, 0xa5, 0x92, 0xcb, 0xfc,
+		0xf2, 0xc5, 0x9c, 0xab, 0x2e, 0x19, 0x40, 0x77,
+		0x8b, 0xbc, 0xe5, 0xd2, 0x57, 0x60, 0x39, 0x0e,
+		0x25, 0x12, 0x4b, 0x7c, 0xf9, 0xce, 0x97, 0xa0,
+		0x5c, 0x6b, 0x32, 0x05, 0x80, 0xb7, 0xee, 0xd9,
+		0xd7, 0xe0, 0xb9, 0x8e, 0x0b, 0x3c, 0x65, 0x52,
+		0xae, 0x99, 0xc0, 0xf7, 0x72, 0x45, 0x1c, 0x2b,
+		0x4a, 0x7d, 0x24, 0x13, 0x96, 0xa1, 0xf8, 0xcf,
+		0x33, 0x04, 0x5d, 0x6a, 0xef, 0xd8, 0x81, 0xb6,
+		0xb8, 0x8f, 0xd6, 0xe1, 0x64, 0x53, 0x0a, 0x3d,
+		0xc1, 0xf6, 0xaf, 0x98, 0x1d, 0x2a, 0x73, 0x44,
+		0x6f, 0x58, 0x01, 0x36, 0xb3, 0x84, 0xdd, 0xea,
+		0x16, 0x21, 0x78, 0x4f, 0xca, 0xfd, 0xa4, 0x93,
+		0x9d, 0xaa, 0xf3, 0xc4, 0x41, 0x76, 0x2f, 0x18,
+		0xe4, 0xd3, 0x8a, 0xbd, 0x38, 0x0f, 0x56, 0x61,
+		0x94, 0xa3, 0xfa, 0xcd, 0x48, 0x7f, 0x26, 0x11,
+		0xed, 0xda, 0x83, 0xb4, 0x31, 0x06, 0x5f, 0x68,
+		0x66, 0x51, 0x08, 0x3f, 0xba, 0x8d, 0xd4, 0xe3,
+		0x1f, 0x28, 0x71, 0x46, 0xc3, 0xf4, 0xad, 0x9a,
+		0xb1, 0x86, 0xdf, 0xe8, 0x6d, 0x5a, 0x03, 0x34,
+		0xc8, 0xff, 0xa6, 0x91, 0x14, 0x23, 0x7a, 0x4d,
+		0x43, 0x74, 0x2d, 0x1a, 0x9f, 0xa8, 0xf1, 0xc6,
+		0x3a, 0x0d, 0x54, 0x63, 0xe6, 0xd1, 0x88, 0xbf,
+		0xde, 0xe9, 0xb0, 0x87, 0x02, 0x35, 0x6c, 0x5b,
+		0xa7, 0x90, 0xc9, 0xfe, 0x7b, 0x4c, 0x15, 0x22,
+		0x2c, 0x1b, 0x42, 0x75, 0xf0, 0xc7, 0x9e, 0xa9,
+		0x55, 0x62, 0x3b, 0x0c, 0x89, 0xbe, 0xe7, 0xd0,
+		0xfb, 0xcc, 0x95, 0xa2, 0x27, 0x10, 0x49, 0x7e,
+		0x82, 0xb5, 0xec, 0xdb, 0x5e, 0x69, 0x30, 0x07,
+		0x09, 0x3e, 0x67, 0x50, 0xd5, 0xe2, 0xbb, 0x8c,
+		0x70, 0x47, 0x1e, 0x29, 0xac, 0x9b, 0xc2, 0xf5
+	},
+	{
+		0x00, 0x51, 0xa2, 0xf3, 0x85, 0xd4, 0x27, 0x76,
+		0xcb, 0x9a, 0x69, 0x38, 0x4e, 0x1f, 0xec, 0xbd,
+		0x57, 0x06, 0xf5, 0xa4, 0xd2, 0x83, 0x70, 0x21,
+		0x9c, 0xcd, 0x3e, 0x6f, 0x19, 0x48, 0xbb, 0xea,
+		0xae, 0xff, 0x0c, 0x5d, 0x2b, 0x7a, 0x89, 0xd8,
+		0x65, 0x34, 0xc7, 0x96, 0xe0, 0xb1, 0x42, 0x13,
+		0xf9, 0xa8, 0x5b, 0x0a, 0x7c, 0x2d, 0xde, 0x8f,
+		0x32, 0x63, 0x90, 0xc1, 0xb7, 0xe6, 0x15, 0x44,
+		0x9d, 0xcc, 0x3f, 0x6e, 0x18, 0x49, 0xba, 0xeb,
+		0x56, 0x07, 0xf4, 0xa5, 0xd3, 0x82, 0x71, 0x20,
+		0xca, 0x9b, 0x68, 0x39, 0x4f, 0x1e, 0xed, 0xbc,
+		0x01, 0x50, 0xa3, 0xf2, 0x84, 0xd5, 0x26, 0x77,
+		0x33, 0x62, 0x91, 0xc0, 0xb6, 0xe7, 0x14, 0x45,
+		0xf8, 0xa9, 0x5a, 0x0b, 0x7d, 0x2c, 0xdf, 0x8e,
+		0x64, 0x35, 0xc6, 0x97, 0xe1, 0xb0, 0x43, 0x12,
+		0xaf, 0xfe, 0x0d, 0x5c, 0x2a, 0x7b, 0x88, 0xd9,
+		0xfb, 0xaa, 0x59, 0x08, 0x7e, 0x2f, 0xdc, 0x8d,
+		0x30, 0x61, 0x92, 0xc3, 0xb5, 0xe4, 0x17, 0x46,
+		0xac, 0xfd, 0x0e, 0x5f, 0x29, 0x78, 0x8b, 0xda,
+		0x67, 0x36, 0xc5, 0x94, 0xe2, 0xb3, 0x40, 0x11,
+		0x55, 0x04, 0xf7, 0xa6, 0xd0, 0x81, 0x72, 0x23,
+		0x9e, 0xcf, 0x3c, 0x6d, 0x1b, 0x4a, 0xb9, 0xe8,
+		0x02, 0x53, 0xa0, 0xf1, 0x87, 0xd6, 0x25, 0x74,
+		0xc9, 0x98, 0x6b, 0x3a, 0x4c, 0x1d, 0xee, 0xbf,
+		0x66, 0x37, 0xc4, 0x95, 0xe3, 0xb2, 0x41, 0x10,
+		0xad, 0xfc, 0x0f, 0x5e, 0x28, 0x79, 0x8a, 0xdb,
+		0x31, 0x60, 0x93, 0xc2, 0xb4, 0xe5, 0x16, 0x47,
+		0xfa, 0xab, 0x58, 0x09, 0x7f, 0x2e, 0xdd, 0x8c,
+		0xc8, 0x99, 0x6a, 0x3b, 0x4d, 0x1c, 0xef, 0xbe,
+		0x03, 0x52, 0xa1, 0xf0, 0x86, 0xd7, 0x24, 0x75,
+		0x9f, 0xce, 0x3d, 0x6c, 0x1a, 0x4b, 0xb8, 0xe9,
+		0x54, 0x05, 0xf6, 0xa7, 0xd1, 0x80, 0x73, 0x22
+	},
+	{
+		0x00, 0xfd, 0x3b, 0xc6, 0x76, 0x8b, 0x4d, 0xb0,
+		0xec, 0x11, 0xd7, 0x2a, 0x9a, 0x67, 0xa1, 0x5c,
+		0x19, 0xe4, 0x22, 0xdf, 0x6f, 0x92, 0x54, 0xa9,
+		0xf5, 0x08, 0xce, 0x33, 0x83, 0x7e, 0xb8, 0x45,
+		0x32, 0xcf, 0x09, 0xf4, 0x44, 0xb9, 0x7f, 0x82,
+		0xde, 0x23, 0xe5, 0x18, 0xa8, 0x55, 0x93, 0x6e,
+		0x2b, 0xd6, 0x10, 0xed, 0x5d, 0xa0, 0x66, 0x9b,
+		0xc7, 0x3a, 0xfc, 0x01, 0xb1, 0x4c, 0x8a, 0x77,
+		0x64, 0x99, 0x5f, 0xa2, 0x12, 0xef, 0x29, 0xd4,
+		0x88, 0x75, 0xb3, 0x4e, 0xfe, 0x03, 0xc5, 0x38,
+		0x7d, 0x80, 0x46, 0xbb, 0x0b, 0xf6, 0x30, 0xcd,
+		0x91, 0x6c, 0xaa, 0x57, 0xe7, 0x1a, 0xdc, 0x21,
+		0x56, 0xab, 0x6d, 0x90, 0x20, 0xdd, 0x1b, 0xe6,
+		0xba, 0x47, 0x81, 0x7c, 0xcc, 0x31, 0xf7, 0x0a,
+		0x4f, 0xb2, 0x74, 0x89, 0x39, 0xc4, 0x02, 0xff,
+		0xa3, 0x5e, 0x98, 0x65, 0xd5, 0x28, 0xee, 0x13,
+		0xc8, 0x35, 0xf3, 0x0e, 0xbe, 0x43, 0x85, 0x78,
+		0x24, 0xd9, 0x1f, 0xe2, 0x52, 0xaf, 0x69, 0x94,
+		0xd1, 0x2c, 0xea, 0x17, 0xa7, 0x5a, 0x9c, 0x61,
+		0x3d, 0xc0, 0x06, 0xfb, 0x4b, 0xb6, 0x70, 0x8d,
+		0xfa, 0x07, 0xc1, 0x3c, 0x8c, 0x71, 0xb7, 0x4a,
+		0x16, 0xeb, 0x2d, 0xd0, 0x60, 0x9d, 0x5b, 0xa6,
+		0xe3, 0x1e, 0xd8, 0x25, 0x95, 0x68, 0xae, 0x53,
+		0x0f, 0xf2, 0x34, 0xc9, 0x79, 0x84, 0x42, 0xbf,
+		0xac, 0x51, 0x97, 0x6a, 0xda, 0x27, 0xe1, 0x1c,
+		0x40, 0xbd, 0x7b, 0x86, 0x36, 0xcb, 0x0d, 0xf0,
+		0xb5, 0x48, 0x8e, 0x73, 0xc3, 0x3e, 0xf8, 0x05,
+		0x59, 0xa4, 0x62, 0x9f, 0x2f, 0xd2, 0x14, 0xe9,
+		0x9e, 0x63, 0xa5, 0x58, 0xe8, 0x15, 0xd3, 0x2e,
+		0x72, 0x8f, 0x49, 0xb4, 0x04, 0xf9, 0x3f, 0xc2,
+		0x87, 0x7a, 0xbc, 0x41, 0xf1, 0x0c, 0xca, 0x37,
+		0x6b, 0x96, 0x50, 0xad, 0x1d, 0xe0, 0x26, 0xdb
+	}
+};
+
 /**
  * Prototypes of private functions
  */
 
 static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
                                         const rohc_crc_type_t crc_type,
-                                        const uint8_t init_val,
-                                        const uint8_t *const crc_table)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+                                        const uint8_t init_val)
+	__attribute__((warn_unused_result, nonnull(1)));
 static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
                                      const rohc_crc_type_t crc_type,
-                                     const uint8_t init_val,
-                                     const uint8_t *const crc_table)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+                                     const uint8_t init_val)
+	__attribute__((warn_unused_result, nonnull(1)));
 static uint8_t * ipv6_get_first_extension(const uint8_t *const ip,
                                           uint8_t *const type)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 
-static bool rohc_crc_get_polynom(const rohc_crc_type_t crc_type,
-                                 uint8_t *const polynom)
-	__attribute__((nonnull(2), warn_unused_result));
-
+static inline uint8_t crc_calc_sliced(const uint8_t *const buf,
+                                      const size_t size,
+                                      const uint8_t init_val,
+                                      const uint8_t crc_mask,
+                                      const uint8_t crc_table[ROHC_CRC_SLICES][256])
+	__attribute__((nonnull(1, 5), warn_unused_result, pure));
 
-static inline uint8_t crc_calc_8(const uint8_t *const buf,
-                                 const size_t size,
-                                 const uint8_t init_val,
-                                 const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 4), warn_unused_result, pure));
-static inline uint8_t crc_calc_7(const uint8_t *const buf,
-                                 const size_t size,
-                                 const uint8_t init_val,
-                                 const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 4), warn_unused_result, pure));
-static inline uint8_t crc_calc_3(const uint8_t *const buf,
-                                 const size_t size,
-                                 const uint8_t init_val,
-                                 const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 4), warn_unused_result, pure));
+#if ROHC_CRC_FCS32_PCLMUL == 1
+static uint32_t crc_fold_fcs32_pclmul(const uint8_t *data,
+                                      size_t length,
+                                      const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure,
+	               target("sse4.1,pclmul")));
+#endif
+#if ROHC_CRC_FCS32_PMULL == 1
+static uint32_t crc_fold_fcs32_pmull(const uint8_t *data,
+                                     size_t length,
+                                     const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+#endif
 
 
 
@@ -168,59 +1028,6 @@ static inline uint8_t crc_calc_3(const uint8_t *const buf,
  */
 
 
-/**
- * @brief Initialize a CRC table given a 256-byte table and the CRC type to use
- *
- * @param table     IN/OUT: The 256-byte table to initialize
- * @param crc_type  The type of CRC to initialize the table for
- * @return          true in case of success, false in case of failure
- */
-bool rohc_crc_init_table(uint8_t *const table,
-                         const rohc_crc_type_t crc_type)
-{
-	uint8_t crc;
-	uint8_t polynom;
-	bool is_fine;
-	int i, j;
-
-	/* sanity check */
-	assert(table != NULL);
-
-	/* determine the polynom to use */
-	is_fine = rohc_crc_get_polynom(crc_type, &polynom);
-	if(is_fine != true)
-	{
-		goto error;
-	}
-
-	/* fill the CRC table */
-	for(i = 0; i < 256; i++)
-	{
-		crc = i;
-
-		for(j = 0; j < 8; j++)
-		{
-			if(crc & 1)
-			{
-				crc = (crc >> 1) ^ polynom;
-			}
-			else
-			{
-				crc = crc >> 1;
-			}
-		}
-
-		table[i] = crc;
-	}
-
-	/* everything went fine */
-	return true;
-
-error:
-	return false;
-}
-
-
 /**
  * @brief Calculate the checksum for the given data.
  *
@@ -228,14 +1035,12 @@ error:
  * @param data       The data to calculate the checksum on
  * @param length     The length of the data
  * @param init_val   The initial CRC value
- * @param crc_table  The pre-computed table for fast CRC computation
  * @return           The checksum
  */
 uint8_t crc_calculate(const rohc_crc_type_t crc_type,
                       const uint8_t *const data,
                       const size_t length,
-                      const uint8_t init_val,
-                      const uint8_t *const crc_table)
+                      const uint8_t init_val)
 {
 	uint8_t crc;
 
@@ -243,13 +1048,13 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
 	switch(crc_type)
 	{
 		case ROHC_CRC_TYPE_8:
-			crc = crc_calc_8(data, length, init_val, crc_table);
+			crc = crc_calc_sliced(data, length, init_val, 0xff, crc_table_8);
 			break;
 		case ROHC_CRC_TYPE_7:
-			crc = crc_calc_7(data, length, init_val, crc_table);
+			crc = crc_calc_sliced(data, length, init_val, 0x7f, crc_table_7);
 			break;
 		case ROHC_CRC_TYPE_3:
-			crc = crc_calc_3(data, length, init_val, crc_table);
+			crc = crc_calc_sliced(data, length, init_val, 0x07, crc_table_3);
 			break;
 		case ROHC_CRC_TYPE_NONE:
 		default:
@@ -263,6 +1068,40 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
 }
 
 
+/**
+ * @brief Get the fastest FCS-32 implementation supported by the CPU
+ *
+ * The carry-less multiplication instructions (PCLMULQDQ on x86, PMULL on
+ * ARMv8) are used if the library was built with them and if the CPU supports
+ * them. Otherwise, the table-based implementation is used.
+ *
+ * @return  The function to compute FCS-32 CRCs with
+ */
+rohc_crc_fcs32_t rohc_crc_fcs32_probe(void)
+{
+#if ROHC_CRC_FCS32_PCLMUL == 1
+	unsigned int eax;
+	unsigned int ebx;
+	unsigned int ecx;
+	unsigned int edx;
+
+	if(__get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+	   (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSE4_1) != 0)
+	{
+		return crc_calc_fcs32_pclmul;
+	}
+#endif
+#if ROHC_CRC_FCS32_PMULL == 1
+	if((getauxval(AT_HWCAP) & HWCAP_PMULL) != 0)
+	{
+		return crc_calc_fcs32_pmull;
+	}
+#endif
+
+	return crc_calc_fcs32;
+}
+
+
 /**
  * @brief Optimized CRC FCS-32 calculation using a table
  *
@@ -287,6 +1126,342 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
 }
 
 
+#if ROHC_CRC_FCS32_PCLMUL == 1
+
+/**
+ * @brief CRC FCS-32 calculation using the x86 PCLMULQDQ instruction
+ *
+ * The CPU shall support the PCLMULQDQ and SSE4.1 instructions, see
+ * \ref rohc_crc_fcs32_probe.
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+uint32_t crc_calc_fcs32_pclmul(const uint8_t *const data,
+                               const size_t length,
+                               const uint32_t init_val)
+{
+	const size_t fold_len = length & ~((size_t) 15);
+	uint32_t crc = init_val;
+
+	/* fold the largest multiple of 16 bytes, at least 64 bytes */
+	if(fold_len < 64)
+	{
+		return crc_calc_fcs32(data, length, init_val);
+	}
+	crc = crc_fold_fcs32_pclmul(data, fold_len, crc);
+
+	/* the last bytes with the table */
+	return crc_calc_fcs32(data + fold_len, length - fold_len, crc);
+}
+
+
+/**
+ * @brief Fold data into a FCS-32 CRC with the x86 PCLMULQDQ instruction
+ *
+ * See "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+ * Instruction", V. Gopal et al., Intel, 2009. The constants are the ones
+ * of the bit-reflected CRC-32 polynomial given at the end of the paper.
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data, a multiple of 16 not lower than 64
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t crc_fold_fcs32_pclmul(const uint8_t *data,
+                                      size_t length,
+                                      const uint32_t init_val)
+{
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+	const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+	const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+	const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+	__m128i x1, x2, x3, x4;
+	__m128i t1, t2, t3, t4;
+
+	assert(length >= 64);
+	assert((length % 16) == 0);
+
+	/* load the first 64 bytes, and inject the initial CRC */
+	x1 = _mm_loadu_si128((const __m128i *) (data + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *) (data + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *) (data + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *) (data + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) init_val));
+	data += 64;
+	length -= 64;
+
+	/* fold 64 bytes at a time in 4 independent lanes */
+	while(length >= 64)
+	{
+		t1 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		t2 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		t3 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		t4 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, t1),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, t2),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, t3),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, t4),
+		                   _mm_loadu_si128((const __m128i *) (data + 0x30)));
+		data += 64;
+		length -= 64;
+	}
+
+	/* fold the 4 lanes into one */
+	t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), t1);
+	t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), t1);
+	t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), t1);
+
+	/* fold the remaining blocks of 16 bytes */
+	while(length >= 16)
+	{
+		t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, t1),
+		                   _mm_loadu_si128((const __m128i *) data));
+		data += 16;
+		length -= 16;
+	}
+
+	/* fold 128 bits into 64 bits */
+	t1 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), t1);
+	t1 = _mm_srli_si128(x1, 4);
+	x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00);
+	x1 = _mm_xor_si128(x1, t1);
+
+	/* Barrett reduction to 32 bits */
+	t1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+	t1 = _mm_clmulepi64_si128(_mm_and_si128(t1, mask32), poly, 0x00);
+	x1 = _mm_xor_si128(x1, t1);
+
+	return (uint32_t) _mm_extract_epi32(x1, 1);
+}
+
+#endif /* ROHC_CRC_FCS32_PCLMUL */
+
+
+#if ROHC_CRC_FCS32_PMULL == 1
+
+/**
+ * @brief CRC FCS-32 calculation using the ARMv8 PMULL instruction
+ *
+ * The CPU shall support the PMULL instruction, see
+ * \ref rohc_crc_fcs32_probe.
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+uint32_t crc_calc_fcs32_pmull(const uint8_t *const data,
+                              const size_t length,
+                              const uint32_t init_val)
+{
+	const size_t fold_len = length & ~((size_t) 15);
+	uint32_t crc = init_val;
+
+	/* fold the largest multiple of 16 bytes, at least 64 bytes */
+	if(fold_len < 64)
+	{
+		return crc_calc_fcs32(data, length, init_val);
+	}
+	crc = crc_fold_fcs32_pmull(data, fold_len, crc);
+
+	/* the last bytes with the table */
+	return crc_calc_fcs32(data + fold_len, length - fold_len, crc);
+}
+
+
+/** Carry-less multiplication of the given 64-bit lanes of a and b */
+#define crc_pmull(a, lane_a, b, lane_b) \
+	vreinterpretq_u64_p128(vmull_p64((poly64_t) vgetq_lane_u64(a, lane_a), \
+	                                 (poly64_t) vgetq_lane_u64(b, lane_b)))
+
+/** Shift the 128-bit vector right by the given number of bytes */
+#define crc_shift_right(a, bytes) \
+	vreinterpretq_u64_u8(vextq_u8(vreinterpretq_u8_u64(a), vdupq_n_u8(0), bytes))
+
+
+/**
+ * @brief Fold data into a FCS-32 CRC with the ARMv8 PMULL instruction
+ *
+ * Same algorithm and constants as \ref crc_fold_fcs32_pclmul.
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data, a multiple of 16 not lower than 64
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t crc_fold_fcs32_pmull(const uint8_t *data,
+                                     size_t length,
+                                     const uint32_t init_val)
+{
+	static const uint64_t k1k2_val[2] = { 0x0154442bd4, 0x01c6e41596 };
+	static const uint64_t k3k4_val[2] = { 0x01751997d0, 0x00ccaa009e };
+	static const uint64_t k5k0_val[2] = { 0x0163cd6124, 0x0000000000 };
+	static const uint64_t poly_val[2] = { 0x01db710641, 0x01f7011641 };
+	const uint64x2_t k1k2 = vld1q_u64(k1k2_val);
+	const uint64x2_t k3k4 = vld1q_u64(k3k4_val);
+	const uint64x2_t k5k0 = vld1q_u64(k5k0_val);
+	const uint64x2_t poly = vld1q_u64(poly_val);
+	const uint64x2_t mask32 = vdupq_n_u64(0xffffffffULL);
+	uint64x2_t x1, x2, x3, x4;
+	uint64x2_t t1, t2, t3, t4;
+
+	assert(length >= 64);
+	assert((length % 16) == 0);
+
+	/* load the first 64 bytes, and inject the initial CRC */
+	x1 = vreinterpretq_u64_u8(vld1q_u8(data + 0x00));
+	x2 = vreinterpretq_u64_u8(vld1q_u8(data + 0x10));
+	x3 = vreinterpretq_u64_u8(vld1q_u8(data + 0x20));
+	x4 = vreinterpretq_u64_u8(vld1q_u8(data + 0x30));
+	x1 = veorq_u64(x1, vsetq_lane_u64((uint64_t) init_val, vdupq_n_u64(0), 0));
+	data += 64;
+	length -= 64;
+
+	/* fold 64 bytes at a time in 4 independent lanes */
+	while(length >= 64)
+	{
+		t1 = crc_pmull(x1, 0, k1k2, 0);
+		t2 = crc_pmull(x2, 0, k1k2, 0);
+		t3 = crc_pmull(x3, 0, k1k2, 0);
+		t4 = crc_pmull(x4, 0, k1k2, 0);
+		x1 = crc_pmull(x1, 1, k1k2, 1);
+		x2 = crc_pmull(x2, 1, k1k2, 1);
+		x3 = crc_pmull(x3, 1, k1k2, 1);
+		x4 = crc_pmull(x4, 1, k1k2, 1);
+		x1 = veorq_u64(veorq_u64(x1, t1), vreinterpretq_u64_u8(vld1q_u8(data + 0x00)));
+		x2 = veorq_u64(veorq_u64(x2, t2), vreinterpretq_u64_u8(vld1q_u8(data + 0x10)));
+		x3 = veorq_u64(veorq_u64(x3, t3), vreinterpretq_u64_u8(vld1q_u8(data + 0x20)));
+		x4 = veorq_u64(veorq_u64(x4, t4), vreinterpretq_u64_u8(vld1q_u8(data + 0x30)));
+		data += 64;
+		length -= 64;
+	}
+
+	/* fold the 4 lanes into one */
+	t1 = crc_pmull(x1, 0, k3k4, 0);
+	x1 = crc_pmull(x1, 1, k3k4, 1);
+	x1 = veorq_u64(veorq_u64(x1, x2), t1);
+	t1 = crc_pmull(x1, 0, k3k4, 0);
+	x1 = crc_pmull(x1, 1, k3k4, 1);
+	x1 = veorq_u64(veorq_u64(x1, x3), t1);
+	t1 = crc_pmull(x1, 0, k3k4, 0);
+	x1 = crc_pmull(x1, 1, k3k4, 1);
+	x1 = veorq_u64(veorq_u64(x1, x4), t1);
+
+	/* fold the remaining blocks of 16 bytes */
+	while(length >= 16)
+	{
+		t1 = crc_pmull(x1, 0, k3k4, 0);
+		x1 = crc_pmull(x1, 1, k3k4, 1);
+		x1 = veorq_u64(veorq_u64(x1, t1), vreinterpretq_u64_u8(vld1q_u8(data)));
+		data += 16;
+		length -= 16;
+	}
+
+	/* fold 128 bits into 64 bits */
+	t1 = crc_pmull(x1, 0, k3k4, 1);
+	x1 = veorq_u64(crc_shift_right(x1, 8), t1);
+	t1 = crc_shift_right(x1, 4);
+	x1 = vandq_u64(x1, mask32);
+	x1 = veorq_u64(crc_pmull(x1, 0, k5k0, 0), t1);
+
+	/* Barrett reduction to 32 bits */
+	t1 = vandq_u64(x1, mask32);
+	t1 = crc_pmull(t1, 0, poly, 1);
+	t1 = vandq_u64(t1, mask32);
+	t1 = crc_pmull(t1, 0, poly, 0);
+	x1 = veorq_u64(x1, t1);
+
+	return vgetq_lane_u32(vreinterpretq_u32_u64(x1), 1);
+}
+
+#endif /* ROHC_CRC_FCS32_PMULL */
+
+
+/**
+ * @brief Reset the cache of the CRCs computed on the CRC-STATIC fields
+ *
+ * @param cache  The cache to reset
+ */
+void crc_static_cache_reset(struct crc_static_cache *const cache)
+{
+	size_t i;
+
+	for(i = 0; i <= ROHC_CRC_TYPE_8; i++)
+	{
+		cache->crcs[i].is_valid = false;
+	}
+}
+
+
+/**
+ * @brief Get the CRC computed on the CRC-STATIC fields from the cache
+ *
+ * @param cache     The cache of the context
+ * @param crc_type  The type of CRC
+ * @param init_val  The initial CRC value
+ * @param[out] crc  The cached CRC
+ * @return          true if the CRC was cached for the given type and
+ *                  initial value, false otherwise
+ */
+bool crc_static_cache_get(const struct crc_static_cache *const cache,
+                          const rohc_crc_type_t crc_type,
+                          const uint8_t init_val,
+                          uint8_t *const crc)
+{
+	assert(crc_type <= ROHC_CRC_TYPE_8);
+
+	if(!cache->crcs[crc_type].is_valid ||
+	   cache->crcs[crc_type].init_val != init_val)
+	{
+		return false;
+	}
+	*crc = cache->crcs[crc_type].crc;
+
+	return true;
+}
+
+
+/**
+ * @brief Store the CRC computed on the CRC-STATIC fields in the cache
+ *
+ * @param cache     The cache of the context
+ * @param crc_type  The type of CRC
+ * @param init_val  The initial CRC value
+ * @param crc       The CRC computed on the CRC-STATIC fields
+ */
+void crc_static_cache_set(struct crc_static_cache *const cache,
+                          const rohc_crc_type_t crc_type,
+                          const uint8_t init_val,
+                          const uint8_t crc)
+{
+	assert(crc_type <= ROHC_CRC_TYPE_8);
+
+	cache->crcs[crc_type].is_valid = true;
+	cache->crcs[crc_type].init_val = init_val;
+	cache->crcs[crc_type].crc = crc;
+}
+
+
 /**
  * @brief Compute the CRC-STATIC part of an IP header
  *
@@ -303,15 +1478,13 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t compute_crc_static(const uint8_t *const outer_ip,
                            const uint8_t *const inner_ip,
                            const uint8_t *const next_header __attribute__((unused)),
                            const rohc_crc_type_t crc_type,
-                           const uint8_t init_val,
-                           const uint8_t *const crc_table)
+                           const uint8_t init_val)
 {
 	const struct ip_hdr *const outer_ip_hdr = (struct ip_hdr *) outer_ip;
 	uint8_t crc = init_val;
@@ -323,13 +1496,13 @@ uint8_t compute_crc_static(const uint8_t *const outer_ip,
 
 		/* bytes 1-2 (Version, Header length, TOS) */
 		crc = crc_calculate(crc_type, (uint8_t *)(ip_hdr), 2,
-		                    crc, crc_table);
+		                    crc);
 		/* bytes 7-10 (Flags, Fragment Offset, TTL, Protocol) */
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->frag_off), 4,
-		                    crc, crc_table);
+		                    crc);
 		/* bytes 13-20 (Source Address, Destination Address) */
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->saddr), 8,
-		                    crc, crc_table);
+		                    crc);
 	}
 	else /* first IPv6 header */
 	{
@@ -337,12 +1510,12 @@ uint8_t compute_crc_static(const uint8_t *const outer_ip,
 
 		/* bytes 1-4 (Version, TC, Flow Label) */
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->version_tc_flow), 4,
-		                    crc, crc_table);
+		                    crc);
 		/* bytes 7-40 (Next Header, Hop Limit, Source Address, Destination Address) */
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->nh), 34,
-		                    crc, crc_table);
+		                    crc);
 		/* IPv6 extensions */
-		crc = ipv6_ext_calc_crc_static(outer_ip, crc_type, crc, crc_table);
+		crc = ipv6_ext_calc_crc_static(outer_ip, crc_type, crc);
 	}
 
 	/* second header */
@@ -357,13 +1530,13 @@ uint8_t compute_crc_static(const uint8_t *const outer_ip,
 
 			/* bytes 1-2 (Version, Header length, TOS) */
 			crc = crc_calculate(crc_type, (uint8_t *)(ip_hdr), 2,
-			                    crc, crc_table);
+			                    crc);
 			/* bytes 7-10 (Flags, Fragment Offset, TTL, Protocol) */
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->frag_off), 4,
-			                    crc, crc_table);
+			                    crc);
 			/* bytes 13-20 (Source Address, Destination Address) */
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->saddr), 8,
-			                    crc, crc_table);
+			                    crc);
 		}
 		else /* IPv6 */
 		{
@@ -371,12 +1544,12 @@ uint8_t compute_crc_static(const uint8_t *const outer_ip,
 
 			/* bytes 1-4 (Version, TC, Flow Label) */
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->version_tc_flow), 4,
-			                    crc, crc_table);
+			                    crc);
 			/* bytes 7-40 (Next Header, Hop Limit, Source Address, Destination Address) */
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->nh), 34,
-			                    crc, crc_table);
+			                    crc);
 			/* IPv6 extensions */
-			crc = ipv6_ext_calc_crc_static(inner_ip, crc_type, crc, crc_table);
+			crc = ipv6_ext_calc_crc_static(inner_ip, crc_type, crc);
 		}
 	}
 
@@ -396,15 +1569,13 @@ uint8_t compute_crc_static(const uint8_t *const outer_ip,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
                             const uint8_t *const inner_ip,
                             const uint8_t *const next_header __attribute__((unused)),
                             const rohc_crc_type_t crc_type,
-                            const uint8_t init_val,
-                            const uint8_t *const crc_table)
+                            const uint8_t init_val)
 {
 	const struct ip_hdr *const outer_ip_hdr = (struct ip_hdr *) outer_ip;
 	uint8_t crc = init_val;
@@ -415,19 +1586,19 @@ uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
 		const struct ipv4_hdr *ip_hdr = (struct ipv4_hdr *) outer_ip;
 		/* bytes 3-6 (Total Length, Identification) */
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->tot_len), 4,
-		                    crc, crc_table);
+		                    crc);
 		/* bytes 11-12 (Header Checksum) */
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->check), 2,
-		                    crc, crc_table);
+		                    crc);
 	}
 	else /* first IPv6 header */
 	{
 		const struct ipv6_hdr *ip_hdr = (struct ipv6_hdr *) outer_ip;
 		/* bytes 5-6 (Payload Length) */
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->plen), 2,
-		                    crc, crc_table);
+		                    crc);
 		/* IPv6 extensions (only AH is CRC-DYNAMIC) */
-		crc = ipv6_ext_calc_crc_dyn(outer_ip, crc_type, crc, crc_table);
+		crc = ipv6_ext_calc_crc_dyn(outer_ip, crc_type, crc);
 	}
 
 	/* second_header */
@@ -441,19 +1612,19 @@ uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
 			const struct ipv4_hdr *ip_hdr = (struct ipv4_hdr *) inner_ip;
 			/* bytes 3-6 (Total Length, Identification) */
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->tot_len), 4,
-			                    crc, crc_table);
+			                    crc);
 			/* bytes 11-12 (Header Checksum) */
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->check), 2,
-			                    crc, crc_table);
+			                    crc);
 		}
 		else /* IPv6 */
 		{
 			const struct ipv6_hdr *ip_hdr = (struct ipv6_hdr *) inner_ip;
 			/* bytes 5-6 (Payload Length) */
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->plen), 2,
-			                    crc, crc_table);
+			                    crc);
 			/* IPv6 extensions (only AH is CRC-DYNAMIC) */
-			crc = ipv6_ext_calc_crc_dyn(inner_ip, crc_type, crc, crc_table);
+			crc = ipv6_ext_calc_crc_dyn(inner_ip, crc_type, crc);
 		}
 	}
 
@@ -473,29 +1644,27 @@ uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const inner_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
-                               const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const struct udphdr *udp;
 
 	/* compute the CRC-STATIC value for IP and IP2 headers */
 	crc = compute_crc_static(outer_ip, inner_ip, next_header,
-	                         crc_type, crc, crc_table);
+	                         crc_type, crc);
 
 	/* get the start of UDP header */
 	udp = (struct udphdr *) next_header;
 
 	/* bytes 1-4 (Source Port, Destination Port) */
 	crc = crc_calculate(crc_type, (uint8_t *)(&udp->source), 4,
-	                    crc, crc_table);
+	                    crc);
 
 	return crc;
 }
@@ -512,29 +1681,27 @@ uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t udp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
-                                const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const struct udphdr *udp;
 
 	/* compute the CRC-DYNAMIC value for IP and IP2 headers */
 	crc = compute_crc_dynamic(outer_ip, inner_ip, next_header,
-	                          crc_type, crc, crc_table);
+	                          crc_type, crc);
 
 	/* get the start of UDP header */
 	udp = (struct udphdr *) next_header;
 
 	/* bytes 5-8 (Length, Checksum) */
 	crc = crc_calculate(crc_type, (uint8_t *)(&udp->len), 4,
-	                    crc, crc_table);
+	                    crc);
 
 	return crc;
 }
@@ -552,29 +1719,27 @@ uint8_t udp_compute_crc_dynamic(const uint8_t *const outer_ip,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const inner_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
-                               const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const struct esphdr *esp;
 
 	/* compute the CRC-STATIC value for IP and IP2 headers */
 	crc = compute_crc_static(outer_ip, inner_ip, next_header,
-	                         crc_type, crc, crc_table);
+	                         crc_type, crc);
 
 	/* get the start of ESP header */
 	esp = (struct esphdr *) next_header;
 
 	/* bytes 1-4 (Security parameters index) */
 	crc = crc_calculate(crc_type, (uint8_t *)(&esp->spi), 4,
-	                    crc, crc_table);
+	                    crc);
 
 	return crc;
 }
@@ -591,29 +1756,27 @@ uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t esp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
-                                const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const struct esphdr *esp;
 
 	/* compute the CRC-DYNAMIC value for IP and IP2 headers */
 	crc = compute_crc_dynamic(outer_ip, inner_ip, next_header,
-	                          crc_type, crc, crc_table);
+	                          crc_type, crc);
 
 	/* get the start of ESP header */
 	esp = (struct esphdr *) next_header;
 
 	/* bytes 5-8 (Sequence number) */
 	crc = crc_calculate(crc_type, (uint8_t *)(&esp->sn), 4,
-	                    crc, crc_table);
+	                    crc);
 
 	return crc;
 }
@@ -631,32 +1794,30 @@ uint8_t esp_compute_crc_dynamic(const uint8_t *const outer_ip,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const inner_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
-                               const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const struct rtphdr *rtp;
 
 	/* compute the CRC-STATIC value for IP, IP2 and UDP headers */
 	crc = udp_compute_crc_static(outer_ip, inner_ip, next_header,
-	                             crc_type, crc, crc_table);
+	                             crc_type, crc);
 
 	/* get the start of RTP header */
 	rtp = (struct rtphdr *) (next_header + sizeof(struct udphdr));
 
 	/* byte 1 (Version, P, X, CC) */
-	crc = crc_calculate(crc_type, (uint8_t *)rtp, 1, crc, crc_table);
+	crc = crc_calculate(crc_type, (uint8_t *)rtp, 1, crc);
 
 	/* bytes 9-12 (SSRC identifier) */
 	crc = crc_calculate(crc_type, (uint8_t *)(&rtp->ssrc), 4,
-	                    crc, crc_table);
+	                    crc);
 
 	/* TODO: CSRC identifiers */
 
@@ -675,29 +1836,27 @@ uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
  * @param next_header The next header located after the IP header(s)
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
-                                const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const struct rtphdr *rtp;
 
 	/* compute the CRC-DYNAMIC value for IP, IP2 and UDP headers */
 	crc = udp_compute_crc_dynamic(outer_ip, inner_ip, next_header,
-	                              crc_type, crc, crc_table);
+	                              crc_type, crc);
 
 	/* get the start of RTP header */
 	rtp = (struct rtphdr *) (next_header + sizeof(struct udphdr));
 
 	/* bytes 2-8 (Payload Type, Sequence Number, Timestamp) */
 	crc = crc_calculate(crc_type, ((uint8_t *) rtp) + 1, 7,
-	                    crc, crc_table);
+	                    crc);
 
 	return crc;
 }
@@ -715,13 +1874,11 @@ uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
  * @param ip          The IPv6 packet
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
                                         const rohc_crc_type_t crc_type,
-                                        const uint8_t init_val,
-                                        const uint8_t *const crc_table)
+                                        const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const uint8_t *ext;
@@ -735,7 +1892,7 @@ static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
 		if(ext_type != ROHC_IPPROTO_AH)
 		{
 			crc = crc_calculate(crc_type, ext, ip_get_extension_size(ext),
-			                    crc, crc_table);
+			                    crc);
 		}
 		ext = ip_get_next_ext_from_ext(ext, &ext_type);
 	}
@@ -752,13 +1909,11 @@ static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
  * @param ip          The IPv6 packet
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
  * @return            The checksum
  */
 static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
                                      const rohc_crc_type_t crc_type,
-                                     const uint8_t init_val,
-                                     const uint8_t *const crc_table)
+                                     const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 	const uint8_t *ext;
@@ -772,7 +1927,7 @@ static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
 		if(ext_type == ROHC_IPPROTO_AH)
 		{
 			crc = crc_calculate(crc_type, ext, ip_get_extension_size(ext),
-			                    crc, crc_table);
+			                    crc);
 		}
 		ext = ip_get_next_ext_from_ext(ext, &ext_type);
 	}
@@ -781,46 +1936,6 @@ static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
 }
 
 
-/**
- * @brief Get the polynom for the given CRC type
- *
- * @param crc_type The CRC type
- * @param polynom  IN/OUT: the polynom for the requested CRC type
- * @return         true in case of success, false otherwise
- */
-static bool rohc_crc_get_polynom(const rohc_crc_type_t crc_type,
-                                 uint8_t *const polynom)
-{
-	/* sanity check */
-	assert(polynom != NULL);
-
-	/* determine the polynom for CRC */
-	switch(crc_type)
-	{
-		case ROHC_CRC_TYPE_3:
-			*polynom = 0x6;
-			break;
-		case ROHC_CRC_TYPE_7:
-			*polynom = 0x79;
-			break;
-		case ROHC_CRC_TYPE_8:
-			*polynom = 0xe0;
-			break;
-		case ROHC_CRC_TYPE_NONE:
-		default:
-			/* unknown CRC type, should not happen */
-			assert(0);
-			goto error;
-	}
-
-	/* everything went fine */
-	return true;
-
-error:
-	return false;
-}
-
-
 /**
  * @brief Get the first extension in an IPv6 packet
  *
@@ -853,77 +1968,51 @@ static uint8_t * ipv6_get_first_extension(const uint8_t *const ip,
 
 
 /**
- * @brief Optimized CRC-8 calculation using a table
+ * @brief Optimized CRC-3, CRC-7 or CRC-8 calculation using slicing-by-8
+ *
+ * The data is processed 8 bytes at a time, then 4 bytes at a time, with one
+ * table lookup per byte. The lookups of one step do not depend on each
+ * other, only the first one depends on the CRC of the previous step. The last
+ * bytes are processed one by one.
  *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
  * @param init_val   The initial CRC value
- * @param crc_table  The pre-computed table for fast CRC computation
+ * @param crc_mask   The mask to apply on the CRC before every lookup
+ * @param crc_table  The pre-computed tables for the CRC type
  * @return           The CRC byte
  */
-static inline uint8_t crc_calc_8(const uint8_t *const buf,
-                                 const size_t size,
-                                 const uint8_t init_val,
-                                 const uint8_t *const crc_table)
+static inline uint8_t crc_calc_sliced(const uint8_t *const buf,
+                                      const size_t size,
+                                      const uint8_t init_val,
+                                      const uint8_t crc_mask,
+                                      const uint8_t crc_table[ROHC_CRC_SLICES][256])
 {
 	uint8_t crc = init_val;
-	size_t i;
+	size_t i = 0;
 
-	for(i = 0; i < size; i++)
+	for(; (i + 8) <= size; i += 8)
 	{
-		crc = crc_table[buf[i] ^ crc];
+		crc = crc_table[7][buf[i] ^ (crc & crc_mask)] ^
+		      crc_table[6][buf[i + 1]] ^
+		      crc_table[5][buf[i + 2]] ^
+		      crc_table[4][buf[i + 3]] ^
+		      crc_table[3][buf[i + 4]] ^
+		      crc_table[2][buf[i + 5]] ^
+		      crc_table[1][buf[i + 6]] ^
+		      crc_table[0][buf[i + 7]];
 	}
-
-	return crc;
-}
-
-
-/**
- * @brief Optimized CRC-7 calculation using a table
- *
- * @param buf        The data to compute the CRC for
- * @param size       The size of the data
- * @param init_val   The initial CRC value
- * @param crc_table  The pre-computed table for fast CRC computation
- * @return           The CRC byte
- */
-static inline uint8_t crc_calc_7(const uint8_t *const buf,
-                                 const size_t size,
-                                 const uint8_t init_val,
-                                 const uint8_t *const crc_table)
-{
-	uint8_t crc = init_val;
-	size_t i;
-
-	for(i = 0; i < size; i++)
+	if((i + 4) <= size)
 	{
-		crc = crc_table[buf[i] ^ (crc & 127)];
+		crc = crc_table[3][buf[i] ^ (crc & crc_mask)] ^
+		      crc_table[2][buf[i + 1]] ^
+		      crc_table[1][buf[i + 2]] ^
+		      crc_table[0][buf[i + 3]];
+		i += 4;
 	}
-
-	return crc;
-}
-
-
-/**
- * @brief Optimized CRC-3 calculation using a table
- *
- * @param buf        The data to compute the CRC for
- * @param size       The size of the data
- * @param init_val   The initial CRC value
- * @param crc_table  The pre-computed table for fast CRC computation
- * @return           The CRC byte
- */
-static inline uint8_t crc_calc_3(const uint8_t *const buf,
-                                 const size_t size,
-                                 const uint8_t init_val,
-                                 const uint8_t *const crc_table)
-{
-	uint8_t crc = init_val;
-	size_t i;
-
-	for(i = 0; i < size; i++)
+	for(; i < size; i++)
 	{
-		crc = crc_table[buf[i] ^ (crc & 7)];
+		crc = crc_table[0][buf[i] ^ (crc & crc_mask)];
 	}
 
 	return crc;
@@ -52,6 +52,23 @@
 /** The length (in bytes) of the FCS-32 CRC */
 #define CRC_FCS32_LEN  4U
 
+/** Whether the FCS-32 CRC may be computed with the x86 PCLMULQDQ instruction */
+#if !defined(__KERNEL__) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#  define ROHC_CRC_FCS32_PCLMUL 1
+#else
+#  define ROHC_CRC_FCS32_PCLMUL 0
+#endif
+
+/** Whether the FCS-32 CRC may be computed with the ARMv8 PMULL instruction */
+#if !defined(__KERNEL__) && defined(__GNUC__) && \
+    defined(__aarch64__) && defined(__linux__) && \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#  define ROHC_CRC_FCS32_PMULL 1
+#else
+#  define ROHC_CRC_FCS32_PMULL 0
+#endif
+
 /** The different types of CRC used to protect ROHC headers */
 typedef enum
 {
@@ -62,85 +79,129 @@ typedef enum
 } rohc_crc_type_t;
 
 
+/** The function that computes a FCS-32 CRC */
+typedef uint32_t (*rohc_crc_fcs32_t)(const uint8_t *const data,
+                                     const size_t length,
+                                     const uint32_t init_val);
+
+
+/**
+ * @brief The CRCs computed on the CRC-STATIC fields of one context
+ *
+ * The CRC-STATIC fields seldom change, so the CRC computed on them is kept in
+ * the context, one per CRC type. The cache shall be reset whenever one of
+ * the CRC-STATIC fields of the context changes.
+ *
+ * @see crc_static_cache_get
+ * @see crc_static_cache_set
+ * @see crc_static_cache_reset
+ */
+struct crc_static_cache
+{
+	/** The cached CRCs, indexed by CRC type */
+	struct
+	{
+		bool is_valid;     /**< Whether the CRC is cached */
+		uint8_t init_val;  /**< The initial value the CRC was computed with */
+		uint8_t crc;       /**< The CRC computed on the CRC-STATIC fields */
+	} crcs[ROHC_CRC_TYPE_8 + 1];
+};
+
+
 /*
  * Function prototypes.
  */
 
-bool rohc_crc_init_table(uint8_t *const table,
-                         const rohc_crc_type_t crc_type)
-	__attribute__((nonnull(1), warn_unused_result));
-
 uint8_t crc_calculate(const rohc_crc_type_t crc_type,
                       const uint8_t *const data,
                       const size_t length,
-                      const uint8_t init_val,
-                      const uint8_t *const crc_table)
-	__attribute__((nonnull(2, 5), warn_unused_result));
+                      const uint8_t init_val)
+	__attribute__((nonnull(2), warn_unused_result, pure));
 
 uint32_t crc_calc_fcs32(const uint8_t *const data,
                         const size_t length,
                         const uint32_t init_val)
 	__attribute__((nonnull(1), warn_unused_result, pure));
+#if ROHC_CRC_FCS32_PCLMUL == 1
+uint32_t crc_calc_fcs32_pclmul(const uint8_t *const data,
+                               const size_t length,
+                               const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+#endif
+#if ROHC_CRC_FCS32_PMULL == 1
+uint32_t crc_calc_fcs32_pmull(const uint8_t *const data,
+                              const size_t length,
+                              const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+#endif
+
+rohc_crc_fcs32_t rohc_crc_fcs32_probe(void)
+	__attribute__((warn_unused_result));
+
+void crc_static_cache_reset(struct crc_static_cache *const cache)
+	__attribute__((nonnull(1)));
+bool crc_static_cache_get(const struct crc_static_cache *const cache,
+                          const rohc_crc_type_t crc_type,
+                          const uint8_t init_val,
+                          uint8_t *const crc)
+	__attribute__((nonnull(1, 4), warn_unused_result));
+void crc_static_cache_set(struct crc_static_cache *const cache,
+                          const rohc_crc_type_t crc_type,
+                          const uint8_t init_val,
+                          const uint8_t crc)
+	__attribute__((nonnull(1)));
 
 uint8_t compute_crc_static(const uint8_t *const outer_ip,
                            const uint8_t *const inner_ip,
                            const uint8_t *const next_header,
                            const rohc_crc_type_t crc_type,
-                           const uint8_t init_val,
-                           const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 6), warn_unused_result));
+                           const uint8_t init_val)
+	__attribute__((nonnull(1), warn_unused_result));
 uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
                             const uint8_t *const inner_ip,
                             const uint8_t *const next_header,
                             const rohc_crc_type_t crc_type,
-                            const uint8_t init_val,
-                            const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 6), warn_unused_result));
+                            const uint8_t init_val)
+	__attribute__((nonnull(1), warn_unused_result));
 
 uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const inner_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
-                               const uint8_t init_val,
-                               const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 3, 6), warn_unused_result));
+                               const uint8_t init_val)
+	__attribute__((nonnull(1, 3), warn_unused_result));
 uint8_t udp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
-                                const uint8_t init_val,
-                                const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 3, 6), warn_unused_result));
+                                const uint8_t init_val)
+	__attribute__((nonnull(1, 3), warn_unused_result));
 
 uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const inner_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
-                               const uint8_t init_val,
-                               const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 3, 6), warn_unused_result));
+                               const uint8_t init_val)
+	__attribute__((nonnull(1, 3), warn_unused_result));
 uint8_t esp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
-                                const uint8_t init_val,
-                                const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 3, 6), warn_unused_result));
+                                const uint8_t init_val)
+	__attribute__((nonnull(1, 3), warn_unused_result));
 
 uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const inner_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
-                               const uint8_t init_val,
-                               const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 3, 6), warn_unused_result));
+                               const uint8_t init_val)
+	__attribute__((nonnull(1, 3), warn_unused_result));
 uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
-                                const uint8_t init_val,
-                                const uint8_t *const crc_table)
-	__attribute__((nonnull(1, 3, 6), warn_unused_result));
+                                const uint8_t init_val)
+	__attribute__((nonnull(1, 3), warn_unused_result));
 
 #endif
 
@@ -32,19 +32,21 @@
 /**
  * @brief Parse a network packet
  *
- * @param[out] packet    The parsed packet
- * @param data           The data to parse
- * @param trace_cb       The function to call for printing traces
- * @param trace_cb_priv  An optional private context, may be NULL
- * @param trace_entity   The entity that emits the traces
- * @return               true if the packet was successfully parsed,
- *                       false if a problem occurred (a malformed packet is
- *                       not considered as an error)
+ * @param[out] packet      The parsed packet
+ * @param data             The data to parse
+ * @param trace_cb         The function to call for printing traces
+ * @param trace_cb_priv    An optional private context, may be NULL
+ * @param trace_min_level  The minimum level of the traces to print
+ * @param trace_entity     The entity that emits the traces
+ * @return                 true if the packet was successfully parsed,
+ *                         false if a problem occurred (a malformed packet is
+ *                         not considered as an error)
  */
 bool net_pkt_parse(struct net_pkt *const packet,
                    const struct rohc_buf data,
                    rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
+                   const rohc_trace_level_t trace_min_level,
                    rohc_trace_entity_t trace_entity)
 {
 	packet->data = rohc_buf_data(data);
@@ -55,6 +57,7 @@ bool net_pkt_parse(struct net_pkt *const packet,
 	/* traces */
 	packet->trace_callback = trace_cb;
 	packet->trace_callback_priv = trace_cb_priv;
+	packet->trace_min_level = trace_min_level;
 
 	/* create the outer IP packet from raw data */
 	if(!ip_create(&packet->outer_ip, rohc_buf_data(data), data.len))
@@ -53,6 +53,8 @@ struct net_pkt
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 };
 
 
@@ -60,6 +62,7 @@ bool net_pkt_parse(struct net_pkt *const packet,
                    const struct rohc_buf data,
                    rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
+                   const rohc_trace_level_t trace_min_level,
                    rohc_trace_entity_t trace_entity)
 	__attribute__((warn_unused_result, nonnull(1)));
 
@@ -150,6 +150,50 @@ typedef enum
 #define ROHC_SMALL_CID_MAX  15U
 
 
+/**
+ * @brief The number of buckets in the histograms of processing times
+ *
+ * The bucket i counts the packets processed in [2^i ; 2^(i+1)[ nanoseconds.
+ * The first bucket also counts the packets processed in less than 1 ns, the
+ * last bucket also counts the slower packets.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_get_stats_snapshot
+ * @see rohc_decomp_get_stats_snapshot
+ */
+#define ROHC_STATS_TIME_BUCKETS  32U
+
+
+/**
+ * @brief The number of buckets in the histograms of header compression ratios
+ *
+ * The bucket i counts the packets whose compressed header is [10*i ;
+ * 10*(i+1)[ percents of their uncompressed header. The last bucket counts the
+ * packets whose header was not compressed at all.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_get_stats_snapshot
+ * @see rohc_decomp_get_stats_snapshot
+ */
+#define ROHC_STATS_RATIO_BUCKETS  11U
+
+
+/**
+ * @brief The number of context states in statistics
+ *
+ * The compressor states (\ref rohc_comp_state_t) and the decompressor states
+ * (\ref rohc_decomp_state_t) are both indexed from 0 (unknown state) to 3.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_get_stats_snapshot
+ * @see rohc_decomp_get_stats_snapshot
+ */
+#define ROHC_STATS_STATES_NR  4U
+
+
 /**
  * @brief The different types of Context IDs (CID)
  *
@@ -24,6 +24,7 @@
  */
 
 #include "rohc_list.h"
+#include "rohc_snapshot.h"
 
 #include <stdlib.h>
 #ifndef __KERNEL__
@@ -205,3 +206,150 @@ static bool rohc_list_item_update(struct rohc_list_item *const list_item,
 	return true;
 }
 
+
+
+/**
+ * @brief Write the items of a translation table in a snapshot
+ *
+ * @param trans_table  The translation table of \ref ROHC_LIST_MAX_ITEM items
+ * @param snapshot     The snapshot to write to
+ * @return             true if successful, false if the snapshot is too small
+ */
+bool rohc_list_trans_table_export(const struct rohc_list_item *const trans_table,
+                                  struct rohc_buf *const snapshot)
+{
+	size_t i;
+
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		const struct rohc_list_item *const item = &trans_table[i];
+
+		if(!rohc_snapshot_put8(snapshot, item->type) ||
+		   !rohc_snapshot_put8(snapshot, item->known) ||
+		   !rohc_snapshot_put32(snapshot, item->counter) ||
+		   !rohc_snapshot_put16(snapshot, item->length) ||
+		   !rohc_snapshot_put(snapshot, item->data, item->length))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Read the items of a translation table from a snapshot
+ *
+ * @param trans_table  The translation table of \ref ROHC_LIST_MAX_ITEM items
+ * @param snapshot     The snapshot to read from
+ * @return             true if successful, false if the snapshot is malformed
+ */
+bool rohc_list_trans_table_import(struct rohc_list_item *const trans_table,
+                                  struct rohc_buf *const snapshot)
+{
+	size_t i;
+
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		struct rohc_list_item *const item = &trans_table[i];
+		uint8_t type;
+		uint8_t known;
+		uint32_t counter;
+		uint16_t length;
+
+		if(!rohc_snapshot_get8(snapshot, &type) ||
+		   !rohc_snapshot_get8(snapshot, &known) || known > 1 ||
+		   !rohc_snapshot_get32(snapshot, &counter) ||
+		   !rohc_snapshot_get16(snapshot, &length) ||
+		   length > ROHC_LIST_ITEM_DATA_MAX ||
+		   !rohc_snapshot_get(snapshot, item->data, length))
+		{
+			return false;
+		}
+		item->type = type;
+		item->known = !!known;
+		item->counter = counter;
+		item->length = length;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Write the given list in a snapshot
+ *
+ * The items of the list are written as their indexes in the translation
+ * table, the ID of the list is not written.
+ *
+ * @param list         The list to write
+ * @param trans_table  The translation table the items of the list belong to
+ * @param snapshot     The snapshot to write to
+ * @return             true if successful, false if the snapshot is too small
+ */
+bool rohc_list_export(const struct rohc_list *const list,
+                      const struct rohc_list_item *const trans_table,
+                      struct rohc_buf *const snapshot)
+{
+	size_t i;
+
+	if(!rohc_snapshot_put32(snapshot, list->counter) ||
+	   !rohc_snapshot_put8(snapshot, list->items_nr))
+	{
+		return false;
+	}
+	for(i = 0; i < list->items_nr; i++)
+	{
+		const size_t index = list->items[i] - trans_table;
+
+		assert(index < ROHC_LIST_MAX_ITEM);
+		if(!rohc_snapshot_put8(snapshot, index))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Read the given list from a snapshot
+ *
+ * The ID of the list is left unchanged.
+ *
+ * @param list         The list to read
+ * @param trans_table  The translation table the items of the list belong to
+ * @param snapshot     The snapshot to read from
+ * @return             true if successful, false if the snapshot is malformed
+ */
+bool rohc_list_import(struct rohc_list *const list,
+                      struct rohc_list_item *const trans_table,
+                      struct rohc_buf *const snapshot)
+{
+	uint32_t counter;
+	uint8_t items_nr;
+	size_t i;
+
+	if(!rohc_snapshot_get32(snapshot, &counter) ||
+	   !rohc_snapshot_get8(snapshot, &items_nr) ||
+	   items_nr > ROHC_LIST_ITEMS_MAX)
+	{
+		return false;
+	}
+	for(i = 0; i < items_nr; i++)
+	{
+		uint8_t index;
+
+		if(!rohc_snapshot_get8(snapshot, &index) || index >= ROHC_LIST_MAX_ITEM)
+		{
+			return false;
+		}
+		list->items[i] = &trans_table[index];
+	}
+	list->items_nr = items_nr;
+	list->counter = counter;
+
+	return true;
+}
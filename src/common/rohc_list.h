@@ -28,6 +28,7 @@
 
 #include "protocols/ipv6.h"
 #include "protocols/ip_numbers.h"
+#include "rohc_buf.h"
 
 #include <stdlib.h>
 
@@ -136,5 +137,21 @@ int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
                                      const size_t item_len)
 	__attribute__((warn_unused_result, nonnull(2, 4)));
 
+bool rohc_list_trans_table_export(const struct rohc_list_item *const trans_table,
+                                  struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool rohc_list_trans_table_import(struct rohc_list_item *const trans_table,
+                                  struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_list_export(const struct rohc_list *const list,
+                      const struct rohc_list_item *const trans_table,
+                      struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+bool rohc_list_import(struct rohc_list *const list,
+                      struct rohc_list_item *const trans_table,
+                      struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
 #endif
 
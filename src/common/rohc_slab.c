@@ -0,0 +1,315 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_slab.c
+ * @brief  Preallocated slabs of fixed-size objects for ROHC contexts
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_slab.h"
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <assert.h>
+
+
+static size_t rohc_slab_round_size(const size_t size)
+	__attribute__((warn_unused_result, const));
+
+static struct rohc_slab_class *
+	rohc_slab_get_class(struct rohc_slab *const slab, const size_t obj_size)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/**
+ * @brief Initialize an empty slab
+ *
+ * An empty slab forwards all allocations to the system allocator.
+ *
+ * @param slab  The slab to initialize
+ */
+void rohc_slab_init(struct rohc_slab *const slab)
+{
+	memset(slab, 0, sizeof(struct rohc_slab));
+}
+
+
+/**
+ * @brief Declare the objects required by one kind of context
+ *
+ * The objects of the same size are grouped in one class. Every class is
+ * sized for the kind of context that requires the largest number of objects
+ * of that size, so that \e slots_nr contexts of any declared kind may exist
+ * at the same time.
+ *
+ * Must be called before \ref rohc_slab_prealloc.
+ *
+ * @param slab           The slab to declare objects for
+ * @param objs_sizes     The sizes of the objects required by one context,
+ *                       zero sizes are ignored
+ * @param objs_sizes_nr  The number of object sizes
+ * @param slots_nr       The number of contexts that may exist at the same time
+ * @return               true if the objects were declared,
+ *                       false if the slab has too many classes of objects
+ */
+bool rohc_slab_add(struct rohc_slab *const slab,
+                   const size_t objs_sizes[],
+                   const size_t objs_sizes_nr,
+                   const size_t slots_nr)
+{
+	size_t i;
+
+	assert(slab->reserved_bytes == 0);
+
+	for(i = 0; i < objs_sizes_nr; i++)
+	{
+		const size_t obj_size = rohc_slab_round_size(objs_sizes[i]);
+		struct rohc_slab_class *class;
+		size_t same_size_nr;
+		size_t j;
+
+		if(obj_size == 0)
+		{
+			continue;
+		}
+
+		/* count the objects of the same size, skip them if already counted */
+		same_size_nr = 0;
+		for(j = 0; j < objs_sizes_nr; j++)
+		{
+			if(rohc_slab_round_size(objs_sizes[j]) == obj_size)
+			{
+				if(j < i)
+				{
+					break;
+				}
+				same_size_nr++;
+			}
+		}
+		if(same_size_nr == 0)
+		{
+			continue;
+		}
+
+		class = rohc_slab_get_class(slab, obj_size);
+		if(class == NULL)
+		{
+			return false;
+		}
+		if(class->objs_nr < (same_size_nr * slots_nr))
+		{
+			class->objs_nr = same_size_nr * slots_nr;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Preallocate all the objects declared for the slab
+ *
+ * @param slab  The slab to preallocate objects for
+ * @return      true if all the objects were allocated,
+ *              false if memory is lacking (the slab is then emptied)
+ */
+bool rohc_slab_prealloc(struct rohc_slab *const slab)
+{
+	size_t i;
+
+	assert(slab->reserved_bytes == 0);
+
+	for(i = 0; i < slab->classes_nr; i++)
+	{
+		struct rohc_slab_class *const class = &(slab->classes[i]);
+		const size_t class_len = class->obj_size * class->objs_nr;
+		size_t j;
+
+		class->mem = malloc(class_len + ROHC_SLAB_ALIGN - 1);
+		if(class->mem == NULL)
+		{
+			goto error;
+		}
+		class->objs = class->mem +
+			((ROHC_SLAB_ALIGN - ((uintptr_t) class->mem % ROHC_SLAB_ALIGN)) %
+			 ROHC_SLAB_ALIGN);
+		slab->reserved_bytes += class_len;
+
+		/* chain all the objects in the list of free objects, the first object
+		 * of the class at the head of the list */
+		class->free_objs = NULL;
+		for(j = class->objs_nr; j > 0; j--)
+		{
+			void **const obj = (void **) (class->objs + (j - 1) * class->obj_size);
+			*obj = class->free_objs;
+			class->free_objs = obj;
+		}
+		class->used_nr = 0;
+	}
+
+	return true;
+
+error:
+	rohc_slab_reset(slab);
+	return false;
+}
+
+
+/**
+ * @brief Free all the objects of the slab, then empty it
+ *
+ * All the objects allocated from the slab shall be released before.
+ *
+ * @param slab  The slab to reset
+ */
+void rohc_slab_reset(struct rohc_slab *const slab)
+{
+	size_t i;
+
+	for(i = 0; i < slab->classes_nr; i++)
+	{
+		assert(slab->classes[i].used_nr == 0);
+		free(slab->classes[i].mem);
+	}
+	rohc_slab_init(slab);
+}
+
+
+/**
+ * @brief Allocate one object from the slab
+ *
+ * The smallest free object large enough is used. If the slab is empty or if
+ * no object is available, fallback on the system allocator.
+ *
+ * @param slab  The slab to allocate the object from
+ * @param size  The size (in bytes) of the object
+ * @return      The object, NULL if memory is lacking
+ */
+void * rohc_slab_malloc(struct rohc_slab *const slab, const size_t size)
+{
+	size_t i;
+
+	for(i = 0; i < slab->classes_nr; i++)
+	{
+		struct rohc_slab_class *const class = &(slab->classes[i]);
+
+		if(class->obj_size >= size && class->free_objs != NULL)
+		{
+			void **const obj = class->free_objs;
+			class->free_objs = *obj;
+			class->used_nr++;
+			slab->used_bytes += class->obj_size;
+			if(slab->used_bytes > slab->peak_bytes)
+			{
+				slab->peak_bytes = slab->used_bytes;
+			}
+			return obj;
+		}
+	}
+
+	return malloc(size);
+}
+
+
+/**
+ * @brief Release one object allocated by \ref rohc_slab_malloc
+ *
+ * @param slab  The slab the object was allocated from
+ * @param obj   The object to release, may be NULL
+ */
+void rohc_slab_free(struct rohc_slab *const slab, void *const obj)
+{
+	const uint8_t *const obj_bytes = obj;
+	size_t i;
+
+	if(obj == NULL)
+	{
+		return;
+	}
+
+	for(i = 0; i < slab->classes_nr; i++)
+	{
+		struct rohc_slab_class *const class = &(slab->classes[i]);
+
+		if(obj_bytes >= class->objs &&
+		   obj_bytes < (class->objs + class->obj_size * class->objs_nr))
+		{
+			assert(((size_t) (obj_bytes - class->objs)) % class->obj_size == 0);
+			assert(class->used_nr > 0);
+			*((void **) obj) = class->free_objs;
+			class->free_objs = obj;
+			class->used_nr--;
+			slab->used_bytes -= class->obj_size;
+			return;
+		}
+	}
+
+	free(obj);
+}
+
+
+/**
+ * @brief Round the given size up to the alignment of slab objects
+ *
+ * @param size  The size (in bytes) to round up
+ * @return      The size rounded up to a multiple of ROHC_SLAB_ALIGN
+ */
+static size_t rohc_slab_round_size(const size_t size)
+{
+	return ((size + ROHC_SLAB_ALIGN - 1) / ROHC_SLAB_ALIGN) * ROHC_SLAB_ALIGN;
+}
+
+
+/**
+ * @brief Get the class for the given object size, create it if needed
+ *
+ * @param slab      The slab to get the class from
+ * @param obj_size  The size (in bytes) of the objects, already rounded up
+ * @return          The class of objects, NULL if too many classes
+ */
+static struct rohc_slab_class *
+	rohc_slab_get_class(struct rohc_slab *const slab, const size_t obj_size)
+{
+	size_t i = 0;
+
+	/* classes are sorted by increasing object size */
+	while(i < slab->classes_nr && slab->classes[i].obj_size < obj_size)
+	{
+		i++;
+	}
+	if(i < slab->classes_nr && slab->classes[i].obj_size == obj_size)
+	{
+		return &(slab->classes[i]);
+	}
+	if(slab->classes_nr >= ROHC_SLAB_CLASSES_MAX)
+	{
+		return NULL;
+	}
+
+	/* insert a new class at its place */
+	memmove(&(slab->classes[i + 1]), &(slab->classes[i]),
+	        (slab->classes_nr - i) * sizeof(struct rohc_slab_class));
+	memset(&(slab->classes[i]), 0, sizeof(struct rohc_slab_class));
+	slab->classes[i].obj_size = obj_size;
+	slab->classes_nr++;
+
+	return &(slab->classes[i]);
+}
+
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_slab.h
+ * @brief  Preallocated slabs of fixed-size objects for ROHC contexts
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A slab groups several classes of objects. Every class holds a fixed number
+ * of objects of the same size that are allocated once for all when the slab
+ * is preallocated. Allocating or releasing an object then only pops or pushes
+ * it on the list of free objects of its class, the system allocator is never
+ * called.
+ *
+ * An empty slab (no class declared) simply forwards allocations to malloc(3)
+ * and free(3), so the same code paths work with or without preallocation.
+ */
+
+#ifndef ROHC_COMMON_SLAB_H
+#define ROHC_COMMON_SLAB_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** The maximum number of object classes in one slab */
+#define ROHC_SLAB_CLASSES_MAX  16U
+
+/** The alignment (in bytes) of the objects, one cache line */
+#define ROHC_SLAB_ALIGN  64U
+
+
+/** One class of objects of the same size in a slab */
+struct rohc_slab_class
+{
+	/** The size (in bytes) of every object, multiple of ROHC_SLAB_ALIGN */
+	size_t obj_size;
+	/** The number of objects in the class */
+	size_t objs_nr;
+	/** The number of objects currently allocated */
+	size_t used_nr;
+	/** The memory allocated for the class, not aligned */
+	uint8_t *mem;
+	/** The first object of the class, aligned on ROHC_SLAB_ALIGN */
+	uint8_t *objs;
+	/** The list of free objects, chained through their first bytes */
+	void *free_objs;
+};
+
+
+/** A slab of preallocated objects */
+struct rohc_slab
+{
+	/** The classes of objects, sorted by increasing object size */
+	struct rohc_slab_class classes[ROHC_SLAB_CLASSES_MAX];
+	/** The number of classes of objects */
+	size_t classes_nr;
+
+	/** The number of bytes preallocated for all the classes */
+	size_t reserved_bytes;
+	/** The number of bytes currently allocated from the classes */
+	size_t used_bytes;
+	/** The largest number of bytes ever allocated from the classes */
+	size_t peak_bytes;
+};
+
+
+/** Release an object plus set its pointer to NULL, see zfree() */
+#define rohc_slab_zfree(slab, pointer) \
+	do { \
+		rohc_slab_free(slab, pointer); \
+		pointer = NULL; \
+	} while(0)
+
+
+/*
+ * Functions prototypes
+ */
+
+void rohc_slab_init(struct rohc_slab *const slab)
+	__attribute__((nonnull(1)));
+
+bool rohc_slab_add(struct rohc_slab *const slab,
+                   const size_t objs_sizes[],
+                   const size_t objs_sizes_nr,
+                   const size_t slots_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool rohc_slab_prealloc(struct rohc_slab *const slab)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_slab_reset(struct rohc_slab *const slab)
+	__attribute__((nonnull(1)));
+
+void * rohc_slab_malloc(struct rohc_slab *const slab, const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_slab_free(struct rohc_slab *const slab, void *const obj)
+	__attribute__((nonnull(1)));
+
+#endif
+
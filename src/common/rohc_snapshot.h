@@ -0,0 +1,320 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    rohc_snapshot.h
+ * @brief   ROHC internal helpers to write and read snapshots of contexts
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * A snapshot is a binary image of the contexts of a compressor (or of a
+ * decompressor) that another compressor (or decompressor) may import to
+ * restart without going back to the IR state. All the fields of a snapshot
+ * are written in Network Byte Order.
+ *
+ * The snapshot begins with a header:
+ *   magic 'ROHC' (4 bytes) | format version (1) | kind (1) | CID type (1) |
+ *   MAX_CID (2) | number of contexts (2)
+ *
+ * Every context is then recorded one after the other:
+ *   CID (2) | profile ID (2) | record length (2) | record
+ *
+ * The record is opaque for the generic code, so that unknown profiles may be
+ * skipped.
+ */
+
+#ifndef ROHC_SNAPSHOT_H
+#define ROHC_SNAPSHOT_H
+
+#include "rohc_buf.h"
+
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
+#  include <stdbool.h>
+#  include <stdint.h>
+#  include <string.h>
+#endif
+
+
+/** The magic number at the very beginning of every snapshot */
+#define ROHC_SNAPSHOT_MAGIC  "ROHC"
+/** The length (in bytes) of the magic number */
+#define ROHC_SNAPSHOT_MAGIC_LEN  4U
+
+/** The version of the snapshot format */
+#define ROHC_SNAPSHOT_VERSION  1U
+
+/** The kind of snapshot for the contexts of a compressor */
+#define ROHC_SNAPSHOT_KIND_COMP    'C'
+/** The kind of snapshot for the contexts of a decompressor */
+#define ROHC_SNAPSHOT_KIND_DECOMP  'D'
+
+/** The length (in bytes) of the snapshot header */
+#define ROHC_SNAPSHOT_HDR_LEN  (ROHC_SNAPSHOT_MAGIC_LEN + 1U + 1U + 1U + 2U + 2U)
+/** The offset of the number of contexts in the snapshot header */
+#define ROHC_SNAPSHOT_HDR_CTXTS_NR_OFFSET  (ROHC_SNAPSHOT_HDR_LEN - 2U)
+
+/** The length (in bytes) of the header of every context record */
+#define ROHC_SNAPSHOT_CTXT_HDR_LEN  6U
+
+
+static inline bool rohc_snapshot_put(struct rohc_buf *const snapshot,
+                                     const void *const data,
+                                     const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline bool rohc_snapshot_put8(struct rohc_buf *const snapshot,
+                                      const uint8_t value)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline bool rohc_snapshot_put16(struct rohc_buf *const snapshot,
+                                       const uint16_t value)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline bool rohc_snapshot_put32(struct rohc_buf *const snapshot,
+                                       const uint32_t value)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline bool rohc_snapshot_put64(struct rohc_buf *const snapshot,
+                                       const uint64_t value)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline void rohc_snapshot_set16(const struct rohc_buf snapshot,
+                                       const size_t offset,
+                                       const uint16_t value);
+
+static inline bool rohc_snapshot_get(struct rohc_buf *const snapshot,
+                                     void *const data,
+                                     const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline bool rohc_snapshot_get8(struct rohc_buf *const snapshot,
+                                      uint8_t *const value)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline bool rohc_snapshot_get16(struct rohc_buf *const snapshot,
+                                       uint16_t *const value)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline bool rohc_snapshot_get32(struct rohc_buf *const snapshot,
+                                       uint32_t *const value)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline bool rohc_snapshot_get64(struct rohc_buf *const snapshot,
+                                       uint64_t *const value)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/**
+ * @brief Append raw bytes at the end of the given snapshot
+ *
+ * @param snapshot  The snapshot to write to
+ * @param data      The bytes to append
+ * @param len       The number of bytes to append
+ * @return          true if successful, false if the snapshot is too small
+ */
+static inline bool rohc_snapshot_put(struct rohc_buf *const snapshot,
+                                     const void *const data,
+                                     const size_t len)
+{
+	if((snapshot->len + len) > rohc_buf_avail_len(*snapshot))
+	{
+		return false;
+	}
+	rohc_buf_append(snapshot, data, len);
+	return true;
+}
+
+
+/**
+ * @brief Append one byte at the end of the given snapshot
+ *
+ * @param snapshot  The snapshot to write to
+ * @param value     The value to append
+ * @return          true if successful, false if the snapshot is too small
+ */
+static inline bool rohc_snapshot_put8(struct rohc_buf *const snapshot,
+                                      const uint8_t value)
+{
+	return rohc_snapshot_put(snapshot, &value, 1);
+}
+
+
+/**
+ * @brief Append one 16-bit value at the end of the given snapshot
+ *
+ * @param snapshot  The snapshot to write to
+ * @param value     The value to append (in Host Byte Order)
+ * @return          true if successful, false if the snapshot is too small
+ */
+static inline bool rohc_snapshot_put16(struct rohc_buf *const snapshot,
+                                       const uint16_t value)
+{
+	const uint8_t bytes[2] = { (value >> 8) & 0xff, value & 0xff };
+	return rohc_snapshot_put(snapshot, bytes, 2);
+}
+
+
+/**
+ * @brief Append one 32-bit value at the end of the given snapshot
+ *
+ * @param snapshot  The snapshot to write to
+ * @param value     The value to append (in Host Byte Order)
+ * @return          true if successful, false if the snapshot is too small
+ */
+static inline bool rohc_snapshot_put32(struct rohc_buf *const snapshot,
+                                       const uint32_t value)
+{
+	return (rohc_snapshot_put16(snapshot, (value >> 16) & 0xffff) &&
+	        rohc_snapshot_put16(snapshot, value & 0xffff));
+}
+
+
+/**
+ * @brief Append one 64-bit value at the end of the given snapshot
+ *
+ * @param snapshot  The snapshot to write to
+ * @param value     The value to append (in Host Byte Order)
+ * @return          true if successful, false if the snapshot is too small
+ */
+static inline bool rohc_snapshot_put64(struct rohc_buf *const snapshot,
+                                       const uint64_t value)
+{
+	return (rohc_snapshot_put32(snapshot, (value >> 32) & 0xffffffff) &&
+	        rohc_snapshot_put32(snapshot, value & 0xffffffff));
+}
+
+
+/**
+ * @brief Overwrite one 16-bit value already written in the given snapshot
+ *
+ * Useful for lengths and numbers that are known only once the data after
+ * them were written.
+ *
+ * @param snapshot  The snapshot to write to
+ * @param offset    The offset of the value in the snapshot
+ * @param value     The value to write (in Host Byte Order)
+ */
+static inline void rohc_snapshot_set16(const struct rohc_buf snapshot,
+                                       const size_t offset,
+                                       const uint16_t value)
+{
+	uint8_t *const bytes = rohc_buf_data_at(snapshot, offset);
+	bytes[0] = (value >> 8) & 0xff;
+	bytes[1] = value & 0xff;
+}
+
+
+/**
+ * @brief Read raw bytes at the beginning of the given snapshot
+ *
+ * The bytes are pulled from the snapshot once they are read.
+ *
+ * @param snapshot   The snapshot to read from
+ * @param[out] data  The bytes read
+ * @param len        The number of bytes to read
+ * @return           true if successful, false if the snapshot is too short
+ */
+static inline bool rohc_snapshot_get(struct rohc_buf *const snapshot,
+                                     void *const data,
+                                     const size_t len)
+{
+	if(snapshot->len < len)
+	{
+		return false;
+	}
+	memcpy(data, rohc_buf_data(*snapshot), len);
+	rohc_buf_pull(snapshot, len);
+	return true;
+}
+
+
+/**
+ * @brief Read one byte at the beginning of the given snapshot
+ *
+ * @param snapshot    The snapshot to read from
+ * @param[out] value  The value read
+ * @return            true if successful, false if the snapshot is too short
+ */
+static inline bool rohc_snapshot_get8(struct rohc_buf *const snapshot,
+                                      uint8_t *const value)
+{
+	return rohc_snapshot_get(snapshot, value, 1);
+}
+
+
+/**
+ * @brief Read one 16-bit value at the beginning of the given snapshot
+ *
+ * @param snapshot    The snapshot to read from
+ * @param[out] value  The value read (in Host Byte Order)
+ * @return            true if successful, false if the snapshot is too short
+ */
+static inline bool rohc_snapshot_get16(struct rohc_buf *const snapshot,
+                                       uint16_t *const value)
+{
+	uint8_t bytes[2];
+
+	if(!rohc_snapshot_get(snapshot, bytes, 2))
+	{
+		return false;
+	}
+	*value = (bytes[0] << 8) | bytes[1];
+	return true;
+}
+
+
+/**
+ * @brief Read one 32-bit value at the beginning of the given snapshot
+ *
+ * @param snapshot    The snapshot to read from
+ * @param[out] value  The value read (in Host Byte Order)
+ * @return            true if successful, false if the snapshot is too short
+ */
+static inline bool rohc_snapshot_get32(struct rohc_buf *const snapshot,
+                                       uint32_t *const value)
+{
+	uint16_t msb;
+	uint16_t lsb;
+
+	if(!rohc_snapshot_get16(snapshot, &msb) ||
+	   !rohc_snapshot_get16(snapshot, &lsb))
+	{
+		return false;
+	}
+	*value = (((uint32_t) msb) << 16) | lsb;
+	return true;
+}
+
+
+/**
+ * @brief Read one 64-bit value at the beginning of the given snapshot
+ *
+ * @param snapshot    The snapshot to read from
+ * @param[out] value  The value read (in Host Byte Order)
+ * @return            true if successful, false if the snapshot is too short
+ */
+static inline bool rohc_snapshot_get64(struct rohc_buf *const snapshot,
+                                       uint64_t *const value)
+{
+	uint32_t msb;
+	uint32_t lsb;
+
+	if(!rohc_snapshot_get32(snapshot, &msb) ||
+	   !rohc_snapshot_get32(snapshot, &lsb))
+	{
+		return false;
+	}
+	*value = (((uint64_t) msb) << 32) | lsb;
+	return true;
+}
+
+
+#endif /* ROHC_SNAPSHOT_H */
+
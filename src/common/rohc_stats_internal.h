@@ -0,0 +1,178 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    rohc_stats_internal.h
+ * @brief   ROHC internal counters for detailed statistics
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The detailed statistics are kept by compressors and decompressors only if
+ * users enable them, see features \ref ROHC_COMP_FEATURE_STATS and
+ * \ref ROHC_DECOMP_FEATURE_STATS. They are kept for the whole compressor (or
+ * decompressor) and for every context.
+ */
+
+#ifndef ROHC_STATS_INTERNAL_H
+#define ROHC_STATS_INTERNAL_H
+
+#include "rohc.h"
+#include "rohc_packets.h"
+
+#include <stdlib.h>
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
+#  include <stdint.h>
+#endif
+
+
+/** The detailed statistics of one context or of a whole (de)compressor */
+struct rohc_stats
+{
+	/** The number of packets successfully processed */
+	uint64_t packets_nr;
+	/** The number of bytes of uncompressed headers */
+	uint64_t uncomp_hdr_bytes;
+	/** The number of bytes of compressed headers */
+	uint64_t comp_hdr_bytes;
+	/** The log2 histogram of the processing times (in nanoseconds) */
+	uint64_t time_hist[ROHC_STATS_TIME_BUCKETS];
+	/** The histogram of the header compression ratios */
+	uint64_t ratio_hist[ROHC_STATS_RATIO_BUCKETS];
+	/** The number of packets of every type */
+	uint64_t packet_types[ROHC_PACKET_MAX];
+	/** The number of transitions from one state (1st index) to another */
+	uint64_t transitions[ROHC_STATS_STATES_NR][ROHC_STATS_STATES_NR];
+};
+
+
+/** The length of one cache line */
+#define ROHC_STATS_CACHE_LINE_LEN  64U
+
+/** The detailed statistics padded to whole cache lines, so that the counters
+ *  of two contexts never share a cache line in an array of statistics */
+union rohc_stats_padded
+{
+	struct rohc_stats counters;  /**< The statistics */
+	/** The padding up to the next cache line */
+	uint8_t padding[((sizeof(struct rohc_stats) + ROHC_STATS_CACHE_LINE_LEN - 1) /
+	                 ROHC_STATS_CACHE_LINE_LEN) * ROHC_STATS_CACHE_LINE_LEN];
+};
+
+
+static inline void rohc_stats_add_pkt(struct rohc_stats *const stats,
+                                      const rohc_packet_t packet_type,
+                                      const uint64_t duration)
+	__attribute__((nonnull(1)));
+
+static inline void rohc_stats_add_hdr(struct rohc_stats *const stats,
+                                      const size_t comp_hdr_len,
+                                      const size_t uncomp_hdr_len)
+	__attribute__((nonnull(1)));
+
+static inline void rohc_stats_add_transition(struct rohc_stats *const stats,
+                                             const unsigned int old_state,
+                                             const unsigned int new_state)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Record one packet successfully processed in the given statistics
+ *
+ * @param stats        The statistics to update
+ * @param packet_type  The type of the ROHC packet
+ * @param duration     The time spent to process the packet (in nanoseconds)
+ */
+static inline void rohc_stats_add_pkt(struct rohc_stats *const stats,
+                                      const rohc_packet_t packet_type,
+                                      const uint64_t duration)
+{
+	size_t bucket;
+
+	/* the log2 of the duration gives the bucket */
+	if(duration == 0)
+	{
+		bucket = 0;
+	}
+	else
+	{
+		bucket = 63 - __builtin_clzll(duration);
+		if(bucket >= ROHC_STATS_TIME_BUCKETS)
+		{
+			bucket = ROHC_STATS_TIME_BUCKETS - 1;
+		}
+	}
+	stats->time_hist[bucket]++;
+
+	if(packet_type < ROHC_PACKET_MAX)
+	{
+		stats->packet_types[packet_type]++;
+	}
+	stats->packets_nr++;
+}
+
+
+/**
+ * @brief Record the header lengths of one packet in the given statistics
+ *
+ * @param stats           The statistics to update
+ * @param comp_hdr_len    The length (in bytes) of the compressed header
+ * @param uncomp_hdr_len  The length (in bytes) of the uncompressed header
+ */
+static inline void rohc_stats_add_hdr(struct rohc_stats *const stats,
+                                      const size_t comp_hdr_len,
+                                      const size_t uncomp_hdr_len)
+{
+	size_t bucket;
+
+	/* buckets are 10% wide, the last one is for headers that were not
+	 * compressed at all */
+	if(comp_hdr_len >= uncomp_hdr_len)
+	{
+		bucket = ROHC_STATS_RATIO_BUCKETS - 1;
+	}
+	else
+	{
+		bucket = (comp_hdr_len * 10) / uncomp_hdr_len;
+	}
+	stats->ratio_hist[bucket]++;
+
+	stats->comp_hdr_bytes += comp_hdr_len;
+	stats->uncomp_hdr_bytes += uncomp_hdr_len;
+}
+
+
+/**
+ * @brief Record one state transition in the given statistics
+ *
+ * @param stats      The statistics to update
+ * @param old_state  The state the context leaves
+ * @param new_state  The state the context enters in
+ */
+static inline void rohc_stats_add_transition(struct rohc_stats *const stats,
+                                             const unsigned int old_state,
+                                             const unsigned int new_state)
+{
+	if(old_state < ROHC_STATS_STATES_NR && new_state < ROHC_STATS_STATES_NR)
+	{
+		stats->transitions[old_state][new_state]++;
+	}
+}
+
+
+#endif /* ROHC_STATS_INTERNAL_H */
@@ -31,8 +31,11 @@
 
 #include "rohc_time.h" /* for public definition of struct rohc_ts */
 
-#ifndef __KERNEL__
+#ifdef __KERNEL__
+#  include <linux/ktime.h>
+#else
 #  include <sys/time.h>
+#  include <time.h>
 #endif
 
 
@@ -40,6 +43,9 @@ static inline uint64_t rohc_time_interval(const struct rohc_ts begin,
                                           const struct rohc_ts end)
 	__attribute__((warn_unused_result, const));
 
+static inline uint64_t rohc_time_get_ns(void)
+	__attribute__((warn_unused_result));
+
 
 /**
  * @brief Compute the interval of time between 2 timestamps
@@ -63,5 +69,30 @@ static inline uint64_t rohc_time_interval(const struct rohc_ts begin,
 }
 
 
+/**
+ * @brief Get the current time from a monotonic clock
+ *
+ * The time is not related to the timestamps given by users with packets, it
+ * is meant to measure the time spent by the library to process packets.
+ *
+ * @return  The current time (in nanoseconds), 0 if the clock is not available
+ */
+static inline uint64_t rohc_time_get_ns(void)
+{
+#ifdef __KERNEL__
+	return ktime_get_ns();
+#else
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+
+	return ((uint64_t) now.tv_sec) * 1000000000UL + now.tv_nsec;
+#endif
+}
+
+
 #endif /* ROHC_TIME_INTERNAL_H */
 
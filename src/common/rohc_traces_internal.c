@@ -36,6 +36,9 @@
 /**
  * @brief Dump the content of the given packet
  *
+ * Use the \ref rohc_dump_packet macro that checks the level of the trace
+ * first.
+ *
  * @param trace_cb      The function to log traces
  * @param trace_cb_priv An optional private context, may be NULL
  * @param trace_entity  The entity that emits the traces
@@ -43,12 +46,12 @@
  * @param descr         The description of the packet to dump
  * @param packet        The packet to dump
  */
-void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
-                      void *const trace_cb_priv,
-                      const rohc_trace_entity_t trace_entity,
-                      const rohc_trace_level_t trace_level,
-                      const char *const descr,
-                      const struct rohc_buf packet)
+void __rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
+                        void *const trace_cb_priv,
+                        const rohc_trace_entity_t trace_entity,
+                        const rohc_trace_level_t trace_level,
+                        const char *const descr,
+                        const struct rohc_buf packet)
 {
 	/* leave early if no trace callback was defined */
 	if(trace_cb == NULL)
@@ -58,14 +61,16 @@ void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
 
 	assert(!rohc_buf_is_malformed(packet));
 
-	rohc_dump_buf(trace_cb, trace_cb_priv, trace_entity, trace_level, descr,
-	              rohc_buf_data(packet), rohc_min(packet.len, 100U));
+	__rohc_dump_buf(trace_cb, trace_cb_priv, trace_entity, trace_level, descr,
+	                rohc_buf_data(packet), rohc_min(packet.len, 100U));
 }
 
 
 /**
  * @brief Dump the content of the given buffer
  *
+ * Use the \ref rohc_dump_buf macro that checks the level of the trace first.
+ *
  * @param trace_cb      The function to log traces
  * @param trace_cb_priv An optional private context, may be NULL
  * @param trace_entity  The entity that emits the traces
@@ -74,13 +79,13 @@ void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
  * @param packet        The packet to dump
  * @param length        The length (in bytes) of the packet to dump
  */
-void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
-                   void *const trace_cb_priv,
-                   const rohc_trace_entity_t trace_entity,
-                   const rohc_trace_level_t trace_level,
-                   const char *const descr,
-                   const uint8_t *const packet,
-                   const size_t length)
+void __rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
+                     void *const trace_cb_priv,
+                     const rohc_trace_entity_t trace_entity,
+                     const rohc_trace_level_t trace_level,
+                     const char *const descr,
+                     const uint8_t *const packet,
+                     const size_t length)
 {
 	/* leave early if no trace callback was defined */
 	if(trace_cb == NULL)
@@ -90,7 +95,7 @@ void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
 
 	if(length == 0)
 	{
-		__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_DEBUG, trace_entity,
+		__rohc_print(trace_cb, trace_cb_priv, trace_level, trace_entity,
 		             ROHC_PROFILE_GENERAL, "%s (0 byte)", descr);
 	}
 	else
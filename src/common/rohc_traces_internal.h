@@ -33,28 +33,42 @@
 #include "rohc_traces.h"
 #include <rohc/rohc_buf.h>
 
+#include "config.h" /* for ROHC_TRACES_MIN_LEVEL */
+
 #include <stdlib.h>
 #include <assert.h>
 
 
+/** The minimum level of the traces built in the library, see the configure
+ *  option --with-max-trace-level: the traces of lower levels are removed at
+ *  build time */
+#ifndef ROHC_TRACES_MIN_LEVEL
+#  define ROHC_TRACES_MIN_LEVEL  0
+#endif
+
 /** Print information depending on the debug level (internal usage) */
 #define __rohc_print(trace_cb, trace_cb_priv, \
                      level, entity, profile, format, ...) \
 	do { \
-		if(trace_cb != NULL) { \
+		if(((int) (level)) >= ROHC_TRACES_MIN_LEVEL && trace_cb != NULL) { \
 			trace_cb(trace_cb_priv, level, entity, profile, \
 			         "[%s:%d %s()] " format "\n", \
 			         __FILE__, __LINE__, __FUNCTION__, ##__VA_ARGS__); \
 		} \
 	} while(0)
 
-/** Print information depending on the debug level */
+/** Print information depending on the debug level: the level is checked
+ *  against the minimum level of the entity before the arguments are
+ *  evaluated */
 #define rohc_print(entity_struct, level, entity, profile, format, ...) \
 	do { \
-		__rohc_print((entity_struct)->trace_callback, \
-		             (entity_struct)->trace_callback_priv, \
-		             level, entity, profile, \
-		             format, ##__VA_ARGS__); \
+		if(((int) (level)) >= ROHC_TRACES_MIN_LEVEL && \
+		   (level) >= (entity_struct)->trace_min_level) { \
+			__rohc_print((entity_struct)->trace_callback, \
+			             (entity_struct)->trace_callback_priv, \
+			             level, entity, profile, \
+			             format, ##__VA_ARGS__); \
+		} \
 	} while(0)
 
 /** Print debug messages prefixed with the function name */
@@ -97,22 +111,46 @@
 		} \
 	} while(0)
 
+/** Dump the content of the given packet: the level is checked against the
+ *  minimum level of the entity before the packet is formatted */
+#define rohc_dump_packet(entity_struct, entity, level, descr, packet) \
+	do { \
+		if(((int) (level)) >= ROHC_TRACES_MIN_LEVEL && \
+		   (level) >= (entity_struct)->trace_min_level) { \
+			__rohc_dump_packet((entity_struct)->trace_callback, \
+			                   (entity_struct)->trace_callback_priv, \
+			                   entity, level, descr, packet); \
+		} \
+	} while(0)
+
+/** Dump the content of the given buffer: the level is checked against the
+ *  minimum level of the entity before the buffer is formatted */
+#define rohc_dump_buf(entity_struct, entity, level, descr, buf, buf_len) \
+	do { \
+		if(((int) (level)) >= ROHC_TRACES_MIN_LEVEL && \
+		   (level) >= (entity_struct)->trace_min_level) { \
+			__rohc_dump_buf((entity_struct)->trace_callback, \
+			                (entity_struct)->trace_callback_priv, \
+			                entity, level, descr, buf, buf_len); \
+		} \
+	} while(0)
+
 
-void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
-                      void *const trace_cb_priv,
-                      const rohc_trace_entity_t trace_entity,
-                      const rohc_trace_level_t trace_level,
-                      const char *const descr,
-                      const struct rohc_buf packet)
+void __rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
+                        void *const trace_cb_priv,
+                        const rohc_trace_entity_t trace_entity,
+                        const rohc_trace_level_t trace_level,
+                        const char *const descr,
+                        const struct rohc_buf packet)
 	__attribute__((nonnull(5)));
 
-void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
-                   void *const trace_cb_priv,
-                   const rohc_trace_entity_t trace_entity,
-                   const rohc_trace_level_t trace_level,
-                   const char *const descr,
-                   const uint8_t *const packet,
-                   const size_t length)
+void __rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
+                     void *const trace_cb_priv,
+                     const rohc_trace_entity_t trace_entity,
+                     const rohc_trace_level_t trace_level,
+                     const char *const descr,
+                     const uint8_t *const packet,
+                     const size_t length)
 	__attribute__((nonnull(5, 6)));
 
 #endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_crc_fcs32.c
+ * @brief   Test that all the FCS-32 implementations agree
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "crc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The largest buffer to compute a CRC for, the largest MRRU */
+#define TEST_BUF_MAX_LEN  65535U
+
+/** The number of random buffers to compute a CRC for */
+#define TEST_BUF_NR  2000U
+
+
+/** One FCS-32 implementation to test */
+struct test_fcs32_impl
+{
+	const char *name;        /**< The name of the implementation */
+	rohc_crc_fcs32_t crc;    /**< The implementation */
+};
+
+
+/**
+ * @brief Test that all the FCS-32 implementations agree on random buffers
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const uint8_t check_data[] = "123456789";
+	struct test_fcs32_impl impls[3];
+	size_t impls_nr = 0;
+	rohc_crc_fcs32_t fastest;
+	uint8_t *buf;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test that all the FCS-32 implementations agree\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* the table-based implementation is always available, the other ones
+	 * only if the CPU supports them */
+	fastest = rohc_crc_fcs32_probe();
+	impls[impls_nr].name = "table";
+	impls[impls_nr].crc = crc_calc_fcs32;
+	impls_nr++;
+#if ROHC_CRC_FCS32_PCLMUL == 1
+	if(fastest == crc_calc_fcs32_pclmul)
+	{
+		impls[impls_nr].name = "PCLMULQDQ";
+		impls[impls_nr].crc = crc_calc_fcs32_pclmul;
+		impls_nr++;
+	}
+#endif
+#if ROHC_CRC_FCS32_PMULL == 1
+	if(fastest == crc_calc_fcs32_pmull)
+	{
+		impls[impls_nr].name = "PMULL";
+		impls[impls_nr].crc = crc_calc_fcs32_pmull;
+		impls_nr++;
+	}
+#endif
+	CHECK(fastest == impls[impls_nr - 1].crc);
+	for(i = 0; i < impls_nr; i++)
+	{
+		trace(verbose, "test the %s implementation\n", impls[i].name);
+	}
+
+	/* the well-known check value of the CRC-32 used by FCS-32 */
+	for(i = 0; i < impls_nr; i++)
+	{
+		const uint32_t crc =
+			impls[i].crc(check_data, strlen((char *) check_data), CRC_INIT_FCS32);
+		CHECK((~crc) == 0xcbf43926);
+	}
+
+	/* random buffers of random lengths, at random alignments, with random
+	 * initial values, computed in one or two parts */
+	buf = malloc(TEST_BUF_MAX_LEN + 16);
+	CHECK(buf != NULL);
+	srand(42);
+	for(i = 0; i < (TEST_BUF_MAX_LEN + 16); i++)
+	{
+		buf[i] = rand() & 0xff;
+	}
+	for(i = 0; i < TEST_BUF_NR; i++)
+	{
+		const size_t offset = rand() % 16;
+		const size_t len = (i < 512 ? i : (size_t) rand() % TEST_BUF_MAX_LEN);
+		const size_t split = (len > 0 ? (size_t) rand() % len : 0);
+		const uint32_t init_val =
+			(i % 2) == 0 ? CRC_INIT_FCS32 : (((uint32_t) rand()) << 16) ^ rand();
+		const uint32_t ref_crc = crc_calc_fcs32(buf + offset, len, init_val);
+		size_t j;
+
+		for(j = 1; j < impls_nr; j++)
+		{
+			uint32_t crc;
+
+			crc = impls[j].crc(buf + offset, len, init_val);
+			CHECK(crc == ref_crc);
+
+			crc = impls[j].crc(buf + offset, split, init_val);
+			crc = impls[j].crc(buf + offset + split, len - split, crc);
+			CHECK(crc == ref_crc);
+		}
+	}
+	free(buf);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -28,6 +28,7 @@
 #include "rohc_comp_rfc3095.h"
 #include "c_ip.h"
 #include "rohc_traces_internal.h"
+#include "rohc_snapshot.h"
 #include "crc.h"
 #include "protocols/esp.h"
 #include "rohc_utils.h"
@@ -70,7 +71,11 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static bool c_esp_check_profile(const struct rohc_comp *const comp,
+static rohc_status_t c_esp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool c_esp_check_profile(struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
@@ -148,7 +153,8 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->sn);
 
 	/* create the ESP part of the profile context */
-	esp_context = malloc(sizeof(struct sc_esp_context));
+	esp_context = rohc_slab_malloc(&context->compressor->ctxt_slab,
+	                               sizeof(struct sc_esp_context));
 	if(esp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -210,7 +216,7 @@ quit:
  *                  \li false if the IP packet does not correspond to
  *                      the profile
  */
-static bool c_esp_check_profile(const struct rohc_comp *const comp,
+static bool c_esp_check_profile(struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 {
 	bool ip_check;
@@ -448,6 +454,27 @@ static size_t esp_code_dynamic_esp_part(const struct rohc_comp_ctxt *const conte
 }
 
 
+/**
+ * @brief Write the ESP context in a snapshot
+ *
+ * The previous ESP header is part of the reference headers, so the generic
+ * part of the context is the whole context.
+ *
+ * @param context   The compression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          Possible return values, see \ref rohc_comp_rfc3095_export
+ */
+static rohc_status_t c_esp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct sc_esp_context *const esp_context = rfc3095_ctxt->specific;
+
+	return rohc_comp_rfc3095_export(context, (uint8_t *) &esp_context->old_esp,
+	                                sizeof(struct esphdr), snapshot);
+}
+
+
 /**
  * @brief Define the compression part of the ESP profile as described
  *        in the RFC 3095.
@@ -456,6 +483,9 @@ const struct rohc_comp_profile c_esp_profile =
 {
 	.id             = ROHC_PROFILE_ESP, /* profile ID (see 8 in RFC 3095) */
 	.protocol       = ROHC_IPPROTO_ESP, /* IP protocol */
+	.ctxt_objs_sizes = { sizeof(struct rohc_comp_rfc3095_ctxt),
+	                     sizeof(struct sc_esp_context) },
+	.ctxt_wlsbs_widths = { ROHC_COMP_RFC3095_CTXT_WLSBS },
 	.create         = c_esp_create,     /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
 	.check_profile  = c_esp_check_profile,
@@ -463,5 +493,7 @@ const struct rohc_comp_profile c_esp_profile =
 	.encode         = c_esp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.export_ctxt    = c_esp_export_ctxt,
+	.import_ctxt    = rohc_comp_rfc3095_import,
 };
 
@@ -43,6 +43,10 @@ static bool rohc_ip_ctxt_create(struct rohc_comp_ctxt *const context,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static rohc_status_t c_ip_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                      struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 
 /*
  * Definitions of public functions
@@ -500,6 +504,23 @@ error:
 }
 
 
+/**
+ * @brief Write the IP-only context in a snapshot
+ *
+ * The IP-only profile has no next header, the generic part of the context
+ * is the whole context.
+ *
+ * @param context   The compression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          Possible return values, see \ref rohc_comp_rfc3095_export
+ */
+static rohc_status_t c_ip_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                      struct rohc_buf *const snapshot)
+{
+	return rohc_comp_rfc3095_export(context, NULL, 0, snapshot);
+}
+
+
 /**
  * @brief Define the compression part of the IP-only profile as described
  *        in the RFC 3843.
@@ -508,6 +529,8 @@ const struct rohc_comp_profile c_ip_profile =
 {
 	.id             = ROHC_PROFILE_IP,     /* profile ID (see 5 in RFC 3843) */
 	.protocol       = 0,                   /* IP protocol */
+	.ctxt_objs_sizes = { sizeof(struct rohc_comp_rfc3095_ctxt) },
+	.ctxt_wlsbs_widths = { ROHC_COMP_RFC3095_CTXT_WLSBS },
 	.create         = rohc_ip_ctxt_create, /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
 	.check_profile  = rohc_comp_rfc3095_check_profile,
@@ -515,5 +538,7 @@ const struct rohc_comp_profile c_ip_profile =
 	.encode         = rohc_comp_rfc3095_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.export_ctxt    = c_ip_export_ctxt,
+	.import_ctxt    = rohc_comp_rfc3095_import,
 };
 
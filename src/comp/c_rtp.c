@@ -30,6 +30,7 @@
 #include "c_rtp.h"
 #include "c_udp.h"
 #include "rohc_traces_internal.h"
+#include "rohc_snapshot.h"
 #include "rohc_packets.h"
 #include "rohc_utils.h"
 #include "sdvl.h"
@@ -46,6 +47,10 @@
  * Constants and macros
  */
 
+/** The largest SN increase between two consecutive packets of a flow that
+ *  the RTP heuristic accepts */
+#define C_RTP_HEURISTIC_MAX_SN_JUMP  100U
+
 
 /*
  * Private function prototypes.
@@ -57,10 +62,27 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
-static bool c_rtp_check_profile(const struct rohc_comp *const comp,
+static rohc_status_t c_rtp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_rtp_import_ctxt(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool c_rtp_check_profile(struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static struct rohc_comp_rtp_flow *
+	c_rtp_get_flow(struct rohc_comp *const comp,
+	               const struct ip_packet *const ip,
+	               const struct udphdr *const udp)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void c_rtp_probe_flow(const struct rohc_comp *const comp,
+                             struct rohc_comp_rtp_flow *const flow,
+                             const struct rtphdr *const rtp)
+	__attribute__((nonnull(1, 2, 3)));
+
 static bool c_rtp_check_context(const struct rohc_comp_ctxt *const context,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2), pure));
@@ -104,6 +126,11 @@ static int rtp_changed_rtp_dynamic(const struct rohc_comp_ctxt *const context,
                                    const struct rtphdr *const rtp)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static bool rtp_is_steady(const struct rohc_comp_ctxt *const context,
+                          const struct udphdr *const udp,
+                          const struct rtphdr *const rtp)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
 
 /**
  * @brief Create a new RTP context and initialize it thanks to the given
@@ -121,6 +148,8 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
+	const struct ip_packet *innermost_ip;
+	struct rohc_comp_rtp_flow *flow;
 	const struct udphdr *udp;
 	const struct rtphdr *rtp;
 
@@ -141,6 +170,26 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	udp = (struct udphdr *) packet->transport->data;
 	rtp = (struct rtphdr *) (udp + 1);
 
+	/* a RTP context exists for the UDP flow, so remember that the flow is a
+	 * RTP one: the next packets of the flow match the context even if the
+	 * context was imported from a snapshot and the RTP heuristic never saw
+	 * the flow */
+	if(packet->ip_hdr_nr == 1)
+	{
+		innermost_ip = &packet->outer_ip;
+	}
+	else
+	{
+		innermost_ip = &packet->inner_ip;
+	}
+	flow = c_rtp_get_flow(context->compressor, innermost_ip, udp);
+	if(flow == NULL)
+	{
+		rohc_comp_warn(context, "no room for the UDP flow in the cache of RTP "
+		               "detection");
+		goto clean;
+	}
+
 	/* initialize SN with the SN found in the RTP header */
 	rfc3095_ctxt->sn = (uint32_t) rohc_ntoh16(rtp->sn);
 	assert(rfc3095_ctxt->sn <= 0xffff);
@@ -148,7 +197,8 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->sn);
 
 	/* create the RTP part of the profile context */
-	rtp_context = malloc(sizeof(struct sc_rtp_context));
+	rtp_context = rohc_slab_malloc(&context->compressor->ctxt_slab,
+	                               sizeof(struct sc_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -165,15 +215,21 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rtp_context->rtp_padding_change_count = 0;
 	rtp_context->rtp_extension_change_count = 0;
 	memcpy(&rtp_context->old_rtp, rtp, sizeof(struct rtphdr));
-	if(!c_create_sc(&rtp_context->ts_sc,
+	if(!c_create_sc(&rtp_context->ts_sc, &context->compressor->ctxt_slab,
 	                context->compressor->wlsb_window_width,
 	                context->compressor->trace_callback,
-	                context->compressor->trace_callback_priv))
+	                context->compressor->trace_callback_priv,
+	                context->compressor->trace_min_level))
 	{
 		rohc_comp_warn(context, "cannot create scaled RTP Timestamp encoding");
 		goto clean;
 	}
 
+	/* the flow is never classified again while the context lives */
+	flow->state = ROHC_COMP_RTP_FLOW_RTP;
+	flow->ctxts_nr++;
+	rtp_context->flow = flow;
+
 	/* init the RTP-specific temporary variables */
 	rtp_context->tmp.send_rtp_dynamic = -1;
 	rtp_context->tmp.ts_send = 0;
@@ -231,7 +287,11 @@ static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 	assert(rfc3095_ctxt->specific != NULL);
 	rtp_context = (struct sc_rtp_context *) rfc3095_ctxt->specific;
 
-	c_destroy_sc(&rtp_context->ts_sc);
+	/* the flow may be classified again once no context compresses it */
+	assert(rtp_context->flow->ctxts_nr > 0);
+	rtp_context->flow->ctxts_nr--;
+
+	c_destroy_sc(&rtp_context->ts_sc, &context->compressor->ctxt_slab);
 	rohc_comp_rfc3095_destroy(context);
 }
 
@@ -250,8 +310,10 @@ static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
  *  \li the inner IP payload is at least 8-byte long for UDP header
  *  \li the UDP Length field and the UDP payload match
  *  \li the UDP payload is at least 12-byte long for RTP header
- *  \li the UDP ports are in the list of RTP ports or the user-defined RTP
- *      callback function detected one RTP packet
+ *  \li the UDP flow was detected as a RTP stream, either by the user-defined
+ *      RTP callback function or by the built-in RTP heuristic (the result
+ *      is cached per UDP flow)
+ *  \li the RTP header does not contain any CSRC item
  *
  * @see c_udp_check_profile
  *
@@ -265,12 +327,15 @@ static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
  *                  \li false if the IP packet does not correspond to
  *                      the profile
  */
-static bool c_rtp_check_profile(const struct rohc_comp *const comp,
+static bool c_rtp_check_profile(struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 {
+	const struct ip_packet *innermost_ip_hdr;
 	const struct udphdr *udp_header;
 	const uint8_t *udp_payload;
 	unsigned int udp_payload_size;
+	struct rohc_comp_rtp_flow *flow;
+	const struct rtphdr *rtp;
 	bool udp_check;
 
 	/* check that:
@@ -299,62 +364,300 @@ static bool c_rtp_check_profile(const struct rohc_comp *const comp,
 		goto bad_profile;
 	}
 
-	/* check if the IP/UDP packet is a RTP packet */
+	/* no callback for advanced RTP stream detection and no RTP heuristic,
+	   so the IP/UDP packet will be compressed with another profile (the
+	   IP/UDP one probably) */
+	if(comp->rtp_callback == NULL && comp->rtp_heuristic_pkts_nr == 0)
+	{
+		goto bad_profile;
+	}
+
+	/* retrieve the innermost IP header */
+	if(packet->ip_hdr_nr == 1)
+	{
+		innermost_ip_hdr = &packet->outer_ip;
+	}
+	else
+	{
+		innermost_ip_hdr = &packet->inner_ip;
+	}
+
+	/* check if the IP/UDP packet belongs to a RTP stream: the UDP flow is
+	 * classified only once, either by the user callback dedicated to RTP
+	 * stream detection or by the built-in RTP heuristic, then the result
+	 * is remembered for the next packets of the flow */
+	flow = c_rtp_get_flow(comp, innermost_ip_hdr, udp_header);
+	if(flow == NULL)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no room for the UDP flow in the cache of RTP detection");
+		goto bad_profile;
+	}
 	if(comp->rtp_callback != NULL)
 	{
-		const struct rtphdr *rtp;
+		if(flow->state == ROHC_COMP_RTP_FLOW_FREE)
+		{
+			/* if the RTP callback returns 1, consider that the packets of the
+			 * flow match the RTP profile */
+			const bool is_rtp_packet =
+				comp->rtp_callback(innermost_ip_hdr->data, (uint8_t *) udp_header,
+				                   udp_payload, udp_payload_size,
+				                   comp->rtp_private);
+			if(is_rtp_packet)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "RTP packet detected by the RTP callback");
+				flow->state = ROHC_COMP_RTP_FLOW_RTP;
+			}
+			else
+			{
+				flow->state = ROHC_COMP_RTP_FLOW_NOT_RTP;
+			}
+		}
+	}
+	else if(flow->state != ROHC_COMP_RTP_FLOW_RTP)
+	{
+		c_rtp_probe_flow(comp, flow, (const struct rtphdr *) udp_payload);
+	}
+	if(flow->state != ROHC_COMP_RTP_FLOW_RTP)
+	{
+		goto bad_profile;
+	}
+
+	/* RTP packets with one or more CSRC items cannot be compressed by the
+	 * RTP profile for the moment */
+	rtp = (const struct rtphdr *) udp_payload;
+	if(rtp->cc != 0)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "compression of CSRC items is not supported yet by RTP profile");
+		goto bad_profile;
+	}
 
-		/* check if the IP/UDP packet is a RTP packet with the user callback
-		   dedicated to RTP stream detection: if the RTP callback returns 1,
-		   consider that the packet matches the RTP profile */
+	return true;
 
-		const struct ip_packet *innermost_ip_hdr;
-		bool is_rtp_packet;
+bad_profile:
+	return false;
+}
 
-		/* retrieve the innermost IP header */
-		if(packet->ip_hdr_nr == 1)
+
+/**
+ * @brief Remember that the UDP flow of a packet is a RTP stream
+ *
+ * The RTP contexts imported from a snapshot compress UDP flows that the RTP
+ * detection of the exporting compressor already classified as RTP streams:
+ * the flows are not classified again by the importing compressor.
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  The IP/UDP packet of the flow
+ * @return        true if the flow is now a RTP stream, false if the packet
+ *                is not a valid IP/UDP packet or if there is no room for the
+ *                flow in the cache of RTP detection
+ */
+bool c_rtp_restore_flow(struct rohc_comp *const comp,
+                        const struct net_pkt *const packet)
+{
+	const struct ip_packet *innermost_ip;
+	struct rohc_comp_rtp_flow *flow;
+
+	if(!c_udp_check_profile(comp, packet))
+	{
+		goto error;
+	}
+
+	if(packet->ip_hdr_nr == 1)
+	{
+		innermost_ip = &packet->outer_ip;
+	}
+	else
+	{
+		innermost_ip = &packet->inner_ip;
+	}
+	flow = c_rtp_get_flow(comp, innermost_ip,
+	                      (const struct udphdr *) packet->transport->data);
+	if(flow == NULL)
+	{
+		goto error;
+	}
+	flow->state = ROHC_COMP_RTP_FLOW_RTP;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the UDP flow of a packet in the cache of RTP detection
+ *
+ * The flow is identified by the addresses of the innermost IP header and by
+ * the UDP ports. If the flow is not in the cache yet, it takes the place of
+ * the least recently used flow of its set that no RTP context compresses.
+ * The flows that no RTP context compresses are forgotten once they remained
+ * idle for too long.
+ *
+ * @param comp  The ROHC compressor
+ * @param ip    The innermost IP header of the packet
+ * @param udp   The UDP header of the packet
+ * @return      The UDP flow, in state \ref ROHC_COMP_RTP_FLOW_FREE if the
+ *              flow is a new one, NULL if all the flows of the set are
+ *              compressed by RTP contexts
+ */
+static struct rohc_comp_rtp_flow *
+	c_rtp_get_flow(struct rohc_comp *const comp,
+	               const struct ip_packet *const ip,
+	               const struct udphdr *const udp)
+{
+	const uint8_t version = ip_get_version(ip);
+	uint32_t saddr[4] = { 0 };
+	uint32_t daddr[4] = { 0 };
+	struct rohc_comp_rtp_flow *set;
+	struct rohc_comp_rtp_flow *flow;
+	uint32_t ports;
+	uint32_t hash;
+	size_t i;
+
+	/* the key of the flow */
+	if(version == IPV4)
+	{
+		saddr[0] = ipv4_get_saddr(ip);
+		daddr[0] = ipv4_get_daddr(ip);
+	}
+	else
+	{
+		assert(version == IPV6);
+		memcpy(saddr, ipv6_get_saddr(ip)->u32, sizeof(saddr));
+		memcpy(daddr, ipv6_get_daddr(ip)->u32, sizeof(daddr));
+	}
+	memcpy(&ports, udp, sizeof(uint32_t));
+
+	/* the set of cache entries of the flow */
+	hash = ports * 0x9e3779b1U;
+	for(i = 0; i < 4; i++)
+	{
+		hash = (hash ^ saddr[i]) * 0x9e3779b1U;
+		hash = (hash ^ daddr[i]) * 0x9e3779b1U;
+	}
+	set = &comp->rtp_flows[((hash ^ (hash >> 16)) & comp->rtp_flows_mask) *
+	                       ROHC_COMP_RTP_FLOWS_WAYS];
+
+	/* known flow, unless it remained idle for too long */
+	flow = NULL;
+	for(i = 0; i < ROHC_COMP_RTP_FLOWS_WAYS; i++)
+	{
+		if(set[i].state != ROHC_COMP_RTP_FLOW_FREE &&
+		   set[i].ip_version == version &&
+		   set[i].ports == ports &&
+		   memcmp(set[i].saddr, saddr, sizeof(saddr)) == 0 &&
+		   memcmp(set[i].daddr, daddr, sizeof(daddr)) == 0)
 		{
-			innermost_ip_hdr = &packet->outer_ip;
+			flow = &set[i];
+			break;
 		}
-		else
+	}
+	if(flow != NULL && (flow->ctxts_nr > 0 ||
+	   (comp->flows_clock - flow->last_use) <= ROHC_COMP_FLOWS_MAX_IDLE))
+	{
+		flow->last_use = comp->flows_clock;
+		return flow;
+	}
+
+	/* new flow or idle flow: take the place of the least recently used flow
+	 * that no RTP context compresses */
+	if(flow == NULL)
+	{
+		for(i = 0; i < ROHC_COMP_RTP_FLOWS_WAYS; i++)
 		{
-			innermost_ip_hdr = &packet->inner_ip;
+			if(set[i].ctxts_nr == 0 &&
+			   (flow == NULL || set[i].state == ROHC_COMP_RTP_FLOW_FREE ||
+			    (comp->flows_clock - set[i].last_use) >
+			    (comp->flows_clock - flow->last_use)))
+			{
+				flow = &set[i];
+				if(flow->state == ROHC_COMP_RTP_FLOW_FREE)
+				{
+					break;
+				}
+			}
 		}
-
-		is_rtp_packet = comp->rtp_callback(innermost_ip_hdr->data,
-		                                   (uint8_t *) udp_header,
-		                                   udp_payload, udp_payload_size,
-		                                   comp->rtp_private);
-		if(!is_rtp_packet)
+		if(flow == NULL)
 		{
-			goto bad_profile;
+			return NULL;
 		}
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "UDP flow not found in the cache of RTP detection");
+	memcpy(flow->saddr, saddr, sizeof(saddr));
+	memcpy(flow->daddr, daddr, sizeof(daddr));
+	flow->ports = ports;
+	flow->ip_version = version;
+	flow->state = ROHC_COMP_RTP_FLOW_FREE;
+	flow->probes_nr = 0;
+	flow->last_use = comp->flows_clock;
+
+	return flow;
+}
 
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "RTP packet detected by the RTP callback");
 
-		/* RTP packets with one or more CSRC items cannot be compressed by the
-		 * RTP profile for the moment */
-		rtp = (struct rtphdr *) udp_payload;
-		if(rtp->cc != 0)
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "compression of CSRC items is not supported yet by RTP profile");
-			goto bad_profile;
-		}
+/**
+ * @brief Run the RTP heuristic on one packet of a UDP flow
+ *
+ * The UDP flow is detected as a RTP stream once enough consecutive packets
+ * look like RTP packets of the same RTP stream: RTP version 2, payload type
+ * that is not one of RTCP, same SSRC, increasing SN and non-decreasing TS.
+ * Detection starts over with the current packet if it does not match the
+ * previous one.
+ *
+ * @param comp  The ROHC compressor
+ * @param flow  The UDP flow the packet belongs to
+ * @param rtp   The RTP header of the packet
+ */
+static void c_rtp_probe_flow(const struct rohc_comp *const comp,
+                             struct rohc_comp_rtp_flow *const flow,
+                             const struct rtphdr *const rtp)
+{
+	const uint32_t ssrc = rohc_ntoh32(rtp->ssrc);
+	const uint16_t sn = rohc_ntoh16(rtp->sn);
+	const uint32_t ts = rohc_ntoh32(rtp->timestamp);
+	const uint16_t sn_delta = sn - flow->sn;
+	const uint32_t ts_delta = ts - flow->ts;
+
+	assert(comp->rtp_heuristic_pkts_nr > 0);
+
+	if(rtp->version != 2 || (rtp->m == 1 && rtp->pt >= 72 && rtp->pt <= 76))
+	{
+		/* not RTP version 2 or RTCP packet types 200 to 204 */
+		flow->probes_nr = 0;
+	}
+	else if(flow->probes_nr > 0 &&
+	        ssrc == flow->ssrc &&
+	        sn_delta >= 1 && sn_delta <= C_RTP_HEURISTIC_MAX_SN_JUMP &&
+	        ts_delta <= 0x7fffffffU)
+	{
+		/* one more packet of the same RTP stream */
+		flow->probes_nr++;
 	}
 	else
 	{
-		/* no callback for advanced RTP stream detection and no UDP
-		   destination port reserved for RTP traffic, so the IP/UDP packet will
-		   be compressed with another profile (the IP/UDP one probably) */
-		goto bad_profile;
+		/* first packet of a possible RTP stream */
+		flow->probes_nr = 1;
 	}
+	flow->ssrc = ssrc;
+	flow->sn = sn;
+	flow->ts = ts;
 
-	return true;
-
-bad_profile:
-	return false;
+	if(flow->probes_nr >= comp->rtp_heuristic_pkts_nr)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "RTP stream detected by the RTP heuristic after %zu "
+		           "packets", flow->probes_nr);
+		flow->state = ROHC_COMP_RTP_FLOW_RTP;
+	}
+	else
+	{
+		flow->state = ROHC_COMP_RTP_FLOW_PROBING;
+	}
 }
 
 
@@ -613,6 +916,20 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context
 	/* RTP eXtension bit is STATIC field, not allowed to change in SO state */
 	assert(!rtp_context->tmp.extension_bit_changed);
 
+	/* steady state of the flow: UO-0 is the packet to send unless the W-LSB
+	 * encoding requires more SN or IP-ID bits than usual */
+	if(rfc3095_ctxt->tmp.is_steady &&
+	   rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 0) &&
+	   (!is_outer_ipv4_non_rnd || nr_ip_id_bits == 0) &&
+	   (nr_of_ip_hdr == 1 || rfc3095_ctxt->inner_ip_flags.info.v4.rnd ||
+	    rfc3095_ctxt->tmp.nr_ip_id_bits2 == 0) &&
+	   is_ts_scaled && is_ts_deducible)
+	{
+		rohc_comp_debug(context, "choose packet UO-0 because the flow is in "
+		                "the steady state");
+		return ROHC_PACKET_UO_0;
+	}
+
 	/* find out how many IP headers are IPv4 headers with non-random IP-IDs */
 	nr_ipv4_non_rnd = 0;
 	nr_ipv4_non_rnd_with_bits = 0;
@@ -858,8 +1175,35 @@ static int c_rtp_encode(struct rohc_comp_ctxt *const context,
 	udp = (struct udphdr *) uncomp_pkt->transport->data;
 	rtp = (struct rtphdr *) (udp + 1);
 
-	/* how many UDP/RTP fields changed? */
-	rtp_context->tmp.send_rtp_dynamic = rtp_changed_rtp_dynamic(context, udp, rtp);
+	/* the V, P, X and CC fields of the RTP header are CRC-STATIC fields, the
+	 * UDP ports and the RTP SSRC cannot change since they identify the
+	 * context */
+	rfc3095_ctxt->tmp.crc_static_changed =
+		(rtp->version != rtp_context->old_rtp.version ||
+		 rtp->padding != rtp_context->old_rtp.padding ||
+		 rtp->extension != rtp_context->old_rtp.extension ||
+		 rtp->cc != rtp_context->old_rtp.cc);
+
+	/* how many UDP/RTP fields changed? in the steady state of the flow, only
+	 * SN and TS advanced by their usual strides, so none of them changed */
+	rfc3095_ctxt->tmp.is_steady =
+		((context->compressor->features &
+		  ROHC_COMP_FEATURE_NO_STEADY_PATH) == 0 &&
+		 rtp_is_steady(context, udp, rtp));
+	if(rfc3095_ctxt->tmp.is_steady)
+	{
+		rohc_comp_debug(context, "RTP flow is in the steady state");
+		rtp_context->tmp.send_rtp_dynamic = 0;
+		rtp_context->tmp.is_marker_bit_set = false;
+		rtp_context->tmp.padding_bit_changed = false;
+		rtp_context->tmp.extension_bit_changed = false;
+		rtp_context->tmp.rtp_pt_changed = 0;
+	}
+	else
+	{
+		rtp_context->tmp.send_rtp_dynamic =
+			rtp_changed_rtp_dynamic(context, udp, rtp);
+	}
 
 	/* encode the IP packet */
 	size = rohc_comp_rfc3095_encode(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len,
@@ -996,6 +1340,9 @@ static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 	/* add new TS value to context */
 	assert(rfc3095_ctxt->sn <= 0xffff);
 	c_add_ts(&rtp_context->ts_sc, rohc_ntoh32(rtp->timestamp), rfc3095_ctxt->sn);
+	assert(!rfc3095_ctxt->tmp.is_uo0_steady ||
+	       (rtp_context->ts_sc.state == SEND_SCALED &&
+	        rohc_ts_sc_is_deducible(&rtp_context->ts_sc)));
 
 	/* determine the number of TS bits to send wrt compression state */
 	if(rtp_context->ts_sc.state == INIT_TS ||
@@ -1020,11 +1367,16 @@ static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 	}
 	else /* SEND_SCALED */
 	{
-		/* TS_SCALED value will be send */
+		/* TS_SCALED value will be send, and is deducible from SN in the
+		 * steady state so that the numbers of bits of the previous packet
+		 * are kept */
 		rtp_context->tmp.ts_send = get_ts_scaled(&rtp_context->ts_sc);
-		nb_bits_scaled(&rtp_context->ts_sc,
-		               &rtp_context->tmp.nr_ts_bits_less_equal_than_2,
-		               &rtp_context->tmp.nr_ts_bits_more_than_2);
+		if(!rfc3095_ctxt->tmp.is_uo0_steady)
+		{
+			nb_bits_scaled(&rtp_context->ts_sc,
+			               &rtp_context->tmp.nr_ts_bits_less_equal_than_2,
+			               &rtp_context->tmp.nr_ts_bits_more_than_2);
+		}
 
 		/* save the new unscaled and TS_SCALED values */
 		assert(rfc3095_ctxt->sn <= 0xffff);
@@ -1470,6 +1822,156 @@ static int rtp_changed_rtp_dynamic(const struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Check whether the UDP/RTP headers are in the steady state of the flow
+ *
+ * In the steady state, only the RTP SN and TS advanced by their usual strides
+ * since the previous packet, and no UDP/RTP field changed in the last few
+ * packets. The change detection of \ref rtp_changed_rtp_dynamic is then
+ * useless, and the IP headers are checked with a few compares too.
+ *
+ * @param context  The compression context
+ * @param udp      The UDP header
+ * @param rtp      The RTP header
+ * @return         true if the UDP/RTP headers are in the steady state,
+ *                 false otherwise
+ */
+static bool rtp_is_steady(const struct rohc_comp_ctxt *const context,
+                          const struct udphdr *const udp,
+                          const struct rtphdr *const rtp)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
+		(struct rohc_comp_rfc3095_ctxt *) context->specific;
+	const struct sc_rtp_context *const rtp_context =
+		(struct sc_rtp_context *) rfc3095_ctxt->specific;
+
+	/* the flow shall be in SO state with all the changes already transmitted */
+	if(context->state != ROHC_COMP_STATE_SO ||
+	   rtp_context->ts_sc.state != SEND_SCALED ||
+	   rtp_context->udp_checksum_change_count < MAX_IR_COUNT ||
+	   rtp_context->rtp_version_change_count < MAX_IR_COUNT ||
+	   rtp_context->rtp_padding_change_count < MAX_IR_COUNT ||
+	   rtp_context->rtp_extension_change_count < MAX_IR_COUNT ||
+	   rtp_context->rtp_pt_change_count < MAX_IR_COUNT)
+	{
+		return false;
+	}
+
+	/* the UDP checksum shall keep its behaviour, the RTP fields other than
+	 * SN and TS shall not change and the RTP Marker bit shall not be set */
+	if((udp->check == 0) != (rtp_context->old_udp.check == 0) ||
+	   rtp->version != rtp_context->old_rtp.version ||
+	   rtp->padding != rtp_context->old_rtp.padding ||
+	   rtp->extension != rtp_context->old_rtp.extension ||
+	   rtp->cc != rtp_context->old_rtp.cc ||
+	   rtp->m != 0 ||
+	   rtp->pt != rtp_context->old_rtp.pt ||
+	   rtp->ssrc != rtp_context->old_rtp.ssrc)
+	{
+		return false;
+	}
+
+	/* SN and TS shall advance by their usual strides, without wrapping
+	 * around so that TS_SCALED is deducible from SN */
+	return (rohc_ntoh16(rtp->sn) == (rfc3095_ctxt->sn + 1) &&
+	        rohc_ntoh32(rtp->timestamp) ==
+	        (rtp_context->ts_sc.ts + rtp_context->ts_sc.ts_stride) &&
+	        rohc_ntoh32(rtp->timestamp) > rtp_context->ts_sc.ts);
+}
+
+
+/**
+ * @brief Write the RTP context in a snapshot
+ *
+ * @param context   The compression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          Possible return values, see \ref rohc_comp_rfc3095_export
+ */
+static rohc_status_t c_rtp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	uint8_t next_header[sizeof(struct udphdr) + sizeof(struct rtphdr)];
+	struct udphdr ref_udp = rtp_context->old_udp;
+	rohc_status_t status;
+
+	/* the UDP length of the reference headers is fixed for the parsing */
+	ref_udp.len = rohc_hton16(sizeof(next_header));
+	memcpy(next_header, &ref_udp, sizeof(struct udphdr));
+	memcpy(next_header + sizeof(struct udphdr), &rtp_context->old_rtp,
+	       sizeof(struct rtphdr));
+	status = rohc_comp_rfc3095_export(context, next_header,
+	                                  sizeof(next_header), snapshot);
+	if(status != ROHC_STATUS_OK)
+	{
+		return status;
+	}
+	if(!rohc_snapshot_put32(snapshot, rtp_context->udp_checksum_change_count) ||
+	   !rohc_snapshot_put32(snapshot, rtp_context->rtp_version_change_count) ||
+	   !rohc_snapshot_put32(snapshot, rtp_context->rtp_pt_change_count) ||
+	   !rohc_snapshot_put32(snapshot, rtp_context->rtp_padding_change_count) ||
+	   !rohc_snapshot_put32(snapshot, rtp_context->rtp_extension_change_count) ||
+	   !rohc_snapshot_put8(snapshot, rtp_context->tss) ||
+	   !rohc_snapshot_put8(snapshot, rtp_context->tis) ||
+	   !c_ts_sc_export(&rtp_context->ts_sc, snapshot))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the RTP context from a snapshot
+ *
+ * The previous UDP and RTP headers were initialized from the reference
+ * headers.
+ *
+ * @param context   The compression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool c_rtp_import_ctxt(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	uint32_t counts[5];
+	uint8_t tss;
+	uint8_t tis;
+	size_t i;
+
+	if(!rohc_comp_rfc3095_import(context, snapshot))
+	{
+		return false;
+	}
+	for(i = 0; i < 5; i++)
+	{
+		if(!rohc_snapshot_get32(snapshot, &counts[i]))
+		{
+			return false;
+		}
+	}
+	if(!rohc_snapshot_get8(snapshot, &tss) ||
+	   !rohc_snapshot_get8(snapshot, &tis) ||
+	   !c_ts_sc_import(&rtp_context->ts_sc, snapshot))
+	{
+		return false;
+	}
+	rtp_context->udp_checksum_change_count = counts[0];
+	rtp_context->rtp_version_change_count = counts[1];
+	rtp_context->rtp_pt_change_count = counts[2];
+	rtp_context->rtp_padding_change_count = counts[3];
+	rtp_context->rtp_extension_change_count = counts[4];
+	rtp_context->tss = tss;
+	rtp_context->tis = tis;
+
+	return true;
+}
+
+
 /**
  * @brief Define the compression part of the RTP profile as described
  *        in the RFC 3095.
@@ -1478,6 +1980,11 @@ const struct rohc_comp_profile c_rtp_profile =
 {
 	.id             = ROHC_PROFILE_RTP, /* profile ID */
 	.protocol       = ROHC_IPPROTO_UDP, /* IP protocol */
+	.ctxt_objs_sizes = { sizeof(struct rohc_comp_rfc3095_ctxt),
+	                     sizeof(struct sc_rtp_context) },
+	.ctxt_wlsbs_widths = { ROHC_COMP_RFC3095_CTXT_WLSBS,
+	                       ROHC_COMP_WLSB_WIDTH_CONF,     /* TS_SCALED */
+	                       ROHC_COMP_WLSB_WIDTH_CONF },   /* unscaled TS */
 	.create         = c_rtp_create,     /* profile handlers */
 	.destroy        = c_rtp_destroy,
 	.check_profile  = c_rtp_check_profile,
@@ -1485,5 +1992,7 @@ const struct rohc_comp_profile c_rtp_profile =
 	.encode         = c_rtp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.export_ctxt    = c_rtp_export_ctxt,
+	.import_ctxt    = c_rtp_import_ctxt,
 };
 
@@ -124,6 +124,9 @@ struct sc_rtp_context
 
 	/// Structure to encode the TS field
 	struct ts_sc_comp ts_sc;
+
+	/// The UDP flow of the context in the cache of RTP detection
+	struct rohc_comp_rtp_flow *flow;
 };
 
 
@@ -131,7 +134,9 @@ struct sc_rtp_context
  * Function prototypes.
  */
 
-/* no public function */
+bool c_rtp_restore_flow(struct rohc_comp *const comp,
+                        const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 #endif
 
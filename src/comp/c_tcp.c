@@ -43,6 +43,7 @@
 #include "sdvl.h"
 #include "crc.h"
 #include "rohc_bit_ops.h"
+#include "rohc_snapshot.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -351,7 +352,17 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
-static bool c_tcp_check_profile(const struct rohc_comp *const comp,
+static rohc_status_t c_tcp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_tcp_export_ref_hdrs(const struct sc_tcp_context *const tcp_context,
+                                  struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_tcp_import_ctxt(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool c_tcp_check_profile(struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
@@ -811,6 +822,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_slab *const slab = &context->compressor->ctxt_slab;
 	struct sc_tcp_context *tcp_context;
 	const uint8_t *remain_data = packet->outer_ip.data;
 	size_t remain_len = packet->outer_ip.size;
@@ -819,7 +831,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	size_t i;
 
 	/* create the TCP part of the profile context */
-	tcp_context = malloc(sizeof(struct sc_tcp_context));
+	tcp_context = rohc_slab_malloc(slab, sizeof(struct sc_tcp_context));
 	if(tcp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -937,7 +949,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 
 	/* MSN */
 	tcp_context->msn_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_SN);
+		c_create_wlsb(slab, 16, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_SN);
 	if(tcp_context->msn_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -947,7 +959,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 
 	/* IP-ID offset */
 	tcp_context->ip_id_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 16, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->ip_id_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -957,7 +969,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 
 	/* innermost IPv4 TTL or IPv6 Hop Limit */
 	tcp_context->ttl_hopl_wlsb =
-		c_create_wlsb(8, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_TTL);
+		c_create_wlsb(slab, 8, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_TTL);
 	if(tcp_context->ttl_hopl_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -968,7 +980,8 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 
 	/* TCP window */
 	tcp_context->window_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_WINDOW);
+		c_create_wlsb(slab, 16, comp->wlsb_window_width,
+		              ROHC_LSB_SHIFT_TCP_WINDOW);
 	if(tcp_context->window_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -979,14 +992,14 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	/* TCP sequence number */
 	tcp_context->seq_num = rohc_ntoh32(tcp->seq_num);
 	tcp_context->seq_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->seq_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP sequence number");
 		goto free_wlsb_window;
 	}
-	tcp_context->seq_scaled_wlsb = c_create_wlsb(32, 4, 7);
+	tcp_context->seq_scaled_wlsb = c_create_wlsb(slab, 32, 4, 7);
 	if(tcp_context->seq_scaled_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -998,14 +1011,14 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	/* TCP acknowledgment (ACK) number */
 	tcp_context->ack_num = rohc_ntoh32(tcp->ack_num);
 	tcp_context->ack_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->ack_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP ACK number");
 		goto free_wlsb_seq_scaled;
 	}
-	tcp_context->ack_scaled_wlsb = c_create_wlsb(32, 4, 3);
+	tcp_context->ack_scaled_wlsb = c_create_wlsb(slab, 32, 4, 3);
 	if(tcp_context->ack_scaled_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -1032,7 +1045,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	tcp_context->tcp_opts.is_timestamp_init = false;
 	/* TCP option Timestamp (request) */
 	tcp_context->tcp_opts.ts_req_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->tcp_opts.ts_req_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -1042,7 +1055,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	}
 	/* TCP option Timestamp (reply) */
 	tcp_context->tcp_opts.ts_reply_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->tcp_opts.ts_reply_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -1054,25 +1067,25 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	return true;
 
 free_wlsb_opt_ts_req:
-	c_destroy_wlsb(tcp_context->tcp_opts.ts_req_wlsb);
+	c_destroy_wlsb(slab, tcp_context->tcp_opts.ts_req_wlsb);
 free_wlsb_ack_scaled:
-	c_destroy_wlsb(tcp_context->ack_scaled_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ack_scaled_wlsb);
 free_wlsb_ack:
-	c_destroy_wlsb(tcp_context->ack_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ack_wlsb);
 free_wlsb_seq_scaled:
-	c_destroy_wlsb(tcp_context->seq_scaled_wlsb);
+	c_destroy_wlsb(slab, tcp_context->seq_scaled_wlsb);
 free_wlsb_seq:
-	c_destroy_wlsb(tcp_context->seq_wlsb);
+	c_destroy_wlsb(slab, tcp_context->seq_wlsb);
 free_wlsb_window:
-	c_destroy_wlsb(tcp_context->window_wlsb);
+	c_destroy_wlsb(slab, tcp_context->window_wlsb);
 free_wlsb_ttl_hopl:
-	c_destroy_wlsb(tcp_context->ttl_hopl_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ttl_hopl_wlsb);
 free_wlsb_ip_id:
-	c_destroy_wlsb(tcp_context->ip_id_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ip_id_wlsb);
 free_wlsb_msn:
-	c_destroy_wlsb(tcp_context->msn_wlsb);
+	c_destroy_wlsb(slab, tcp_context->msn_wlsb);
 free_context:
-	free(tcp_context);
+	rohc_slab_free(slab, tcp_context);
 error:
 	return false;
 }
@@ -1086,18 +1099,393 @@ error:
 static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
+	struct rohc_slab *const slab = &context->compressor->ctxt_slab;
+
+	c_destroy_wlsb(slab, tcp_context->tcp_opts.ts_reply_wlsb);
+	c_destroy_wlsb(slab, tcp_context->tcp_opts.ts_req_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ack_scaled_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ack_wlsb);
+	c_destroy_wlsb(slab, tcp_context->seq_scaled_wlsb);
+	c_destroy_wlsb(slab, tcp_context->seq_wlsb);
+	c_destroy_wlsb(slab, tcp_context->window_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ip_id_wlsb);
+	c_destroy_wlsb(slab, tcp_context->ttl_hopl_wlsb);
+	c_destroy_wlsb(slab, tcp_context->msn_wlsb);
+	rohc_slab_free(slab, tcp_context);
+}
+
+
+/**
+ * @brief Write the TCP context in a snapshot
+ *
+ * The record begins with the reference headers, ie. the IP headers without
+ * their extension headers and the TCP header without its options, built from
+ * the context: the compressor that imports the snapshot creates the context
+ * from them as if they were a packet. The dynamic state of the context
+ * follows: the IP contexts with their IPv6 extension headers, the TCP
+ * fields with their W-LSB windows, then the context of the TCP options.
+ *
+ * @param context   The compression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          \ref ROHC_STATUS_OK if the context was exported,
+ *                  \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the snapshot is too
+ *                  small,
+ *                  \ref ROHC_STATUS_ERROR if the context cannot be exported
+ */
+static rohc_status_t c_tcp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	size_t i;
+
+	if(context->num_sent_packets == 0)
+	{
+		rohc_comp_debug(context, "cannot export context that compressed no "
+		                "packet yet");
+		return ROHC_STATUS_ERROR;
+	}
+
+	if(!c_tcp_export_ref_hdrs(tcp_context, snapshot))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	/* the dynamic state of the IP headers */
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+		size_t j;
+
+		if(!rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.dscp) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.ip_ecn_flags) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.ttl_hopl) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.ip_id_behavior) ||
+		   !rohc_snapshot_put8(snapshot,
+		                       ip_context->ctxt.vx.last_ip_id_behavior))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+		if(ip_context->version == IPV4)
+		{
+			if(!rohc_snapshot_put8(snapshot, ip_context->ctxt.v4.df) ||
+			   !rohc_snapshot_put16(snapshot, ip_context->ctxt.v4.last_ip_id))
+			{
+				return ROHC_STATUS_OUTPUT_TOO_SMALL;
+			}
+			continue;
+		}
+		if(!rohc_snapshot_put8(snapshot, ip_context->opts_nr))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+		for(j = 0; j < ip_context->opts_nr; j++)
+		{
+			const ipv6_generic_option_context_t *const opt =
+				&(ip_context->opts[j].generic);
+
+			if(!rohc_snapshot_put16(snapshot, opt->option_length) ||
+			   !rohc_snapshot_put8(snapshot, opt->next_header) ||
+			   !rohc_snapshot_put(snapshot, opt->data, opt->option_length - 2))
+			{
+				return ROHC_STATUS_OUTPUT_TOO_SMALL;
+			}
+		}
+	}
+
+	/* the dynamic state of the TCP header */
+	if(!rohc_snapshot_put32(snapshot, tcp_context->tcp_seq_num_change_count) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->tcp_window_change_count) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->ecn_used) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->ecn_used_change_count) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->ecn_used_zero_count) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->tcp_last_seq_num) ||
+	   !rohc_snapshot_put16(snapshot, tcp_context->msn) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->ttl_hopl_change_count) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->seq_num) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->seq_num_scaled) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->seq_num_residue) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->seq_num_factor) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->seq_num_scaling_nr) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->ack_num) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->ack_deltas_next))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	for(i = 0; i < 20; i++)
+	{
+		if(!rohc_snapshot_put16(snapshot, tcp_context->ack_deltas_width[i]))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+	}
+	if(!rohc_snapshot_put16(snapshot, tcp_context->ack_stride) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->ack_num_scaled) ||
+	   !rohc_snapshot_put16(snapshot, tcp_context->ack_num_residue) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->ack_num_scaling_nr) ||
+	   !rohc_snapshot_put(snapshot, &tcp_context->old_tcphdr,
+	                      sizeof(struct tcphdr)) ||
+	   !c_wlsb_export(tcp_context->msn_wlsb, snapshot) ||
+	   !c_wlsb_export(tcp_context->ttl_hopl_wlsb, snapshot) ||
+	   !c_wlsb_export(tcp_context->ip_id_wlsb, snapshot) ||
+	   !c_wlsb_export(tcp_context->window_wlsb, snapshot) ||
+	   !c_wlsb_export(tcp_context->seq_wlsb, snapshot) ||
+	   !c_wlsb_export(tcp_context->seq_scaled_wlsb, snapshot) ||
+	   !c_wlsb_export(tcp_context->ack_wlsb, snapshot) ||
+	   !c_wlsb_export(tcp_context->ack_scaled_wlsb, snapshot) ||
+	   !c_tcp_opts_export(&tcp_context->tcp_opts, snapshot))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Write the reference headers of the given TCP context in a snapshot
+ *
+ * The IPv4 headers are written with a valid checksum, the lengths of the
+ * IP headers are fixed for the parsing.
+ *
+ * @param tcp_context  The TCP compression context to export
+ * @param snapshot     The snapshot to write to
+ * @return             true if successful, false if the snapshot is too small
+ */
+static bool c_tcp_export_ref_hdrs(const struct sc_tcp_context *const tcp_context,
+                                  struct rohc_buf *const snapshot)
+{
+	struct tcphdr ref_tcp = tcp_context->old_tcphdr;
+	size_t ref_hdrs_len;
+	size_t remain_len;
+	size_t i;
+
+	ref_hdrs_len = sizeof(struct tcphdr);
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		if(tcp_context->ip_contexts[i].version == IPV4)
+		{
+			ref_hdrs_len += sizeof(struct ipv4_hdr);
+		}
+		else
+		{
+			ref_hdrs_len += sizeof(struct ipv6_hdr);
+		}
+	}
+	if(!rohc_snapshot_put16(snapshot, ref_hdrs_len))
+	{
+		return false;
+	}
+
+	remain_len = ref_hdrs_len;
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+
+		if(ip_context->version == IPV4)
+		{
+			struct ipv4_hdr ref_ip;
+
+			memset(&ref_ip, 0, sizeof(struct ipv4_hdr));
+			ref_ip.version = IPV4;
+			ref_ip.ihl = sizeof(struct ipv4_hdr) / sizeof(uint32_t);
+			ref_ip.dscp = ip_context->ctxt.v4.dscp;
+			ref_ip.ecn = ip_context->ctxt.v4.ip_ecn_flags;
+			ref_ip.tot_len = rohc_hton16(remain_len);
+			ref_ip.id = rohc_hton16(ip_context->ctxt.v4.last_ip_id);
+			ref_ip.df = ip_context->ctxt.v4.df;
+			ref_ip.ttl = ip_context->ctxt.v4.ttl_hopl;
+			ref_ip.protocol = ip_context->ctxt.v4.protocol;
+			ref_ip.saddr = ip_context->ctxt.v4.src_addr;
+			ref_ip.daddr = ip_context->ctxt.v4.dst_addr;
+			ref_ip.check = ip_fast_csum((uint8_t *) &ref_ip, ref_ip.ihl);
+			if(!rohc_snapshot_put(snapshot, &ref_ip, sizeof(struct ipv4_hdr)))
+			{
+				return false;
+			}
+			remain_len -= sizeof(struct ipv4_hdr);
+		}
+		else
+		{
+			struct ipv6_hdr ref_ip;
+
+			memset(&ref_ip, 0, sizeof(struct ipv6_hdr));
+			ref_ip.version = IPV6;
+			ipv6_set_flow_label(&ref_ip, ip_context->ctxt.v6.flow_label);
+			remain_len -= sizeof(struct ipv6_hdr);
+			ref_ip.plen = rohc_hton16(remain_len);
+			ref_ip.nh = ip_context->ctxt.v6.next_header;
+			ref_ip.hl = ip_context->ctxt.v6.ttl_hopl;
+			memcpy(&ref_ip.saddr, ip_context->ctxt.v6.src_addr,
+			       sizeof(struct ipv6_addr));
+			memcpy(&ref_ip.daddr, ip_context->ctxt.v6.dest_addr,
+			       sizeof(struct ipv6_addr));
+			if(!rohc_snapshot_put(snapshot, &ref_ip, sizeof(struct ipv6_hdr)))
+			{
+				return false;
+			}
+		}
+	}
+
+	/* the TCP options are restored from the dynamic state of the context */
+	ref_tcp.data_offset = sizeof(struct tcphdr) / sizeof(uint32_t);
+
+	return rohc_snapshot_put(snapshot, &ref_tcp, sizeof(struct tcphdr));
+}
+
+
+/**
+ * @brief Read the TCP context from a snapshot
+ *
+ * The IP and TCP contexts were initialized from the reference headers when
+ * the context was created, they are already pulled from the snapshot.
+ *
+ * @param context   The compression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool c_tcp_import_ctxt(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	uint32_t counts[8];
+	uint8_t ecn_used;
+	uint8_t ack_deltas_next;
+	size_t i;
 
-	c_destroy_wlsb(tcp_context->tcp_opts.ts_reply_wlsb);
-	c_destroy_wlsb(tcp_context->tcp_opts.ts_req_wlsb);
-	c_destroy_wlsb(tcp_context->ack_scaled_wlsb);
-	c_destroy_wlsb(tcp_context->ack_wlsb);
-	c_destroy_wlsb(tcp_context->seq_scaled_wlsb);
-	c_destroy_wlsb(tcp_context->seq_wlsb);
-	c_destroy_wlsb(tcp_context->window_wlsb);
-	c_destroy_wlsb(tcp_context->ip_id_wlsb);
-	c_destroy_wlsb(tcp_context->ttl_hopl_wlsb);
-	c_destroy_wlsb(tcp_context->msn_wlsb);
-	free(tcp_context);
+	/* the dynamic state of the IP headers */
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+		uint8_t fields[5];
+		uint8_t opts_nr;
+		size_t j;
+
+		for(j = 0; j < 5; j++)
+		{
+			if(!rohc_snapshot_get8(snapshot, &fields[j]))
+			{
+				goto malformed_ip;
+			}
+		}
+		if(fields[0] > 0x3f || fields[1] > 0x03 ||
+		   fields[3] > IP_ID_BEHAVIOR_ZERO || fields[4] > IP_ID_BEHAVIOR_ZERO)
+		{
+			goto malformed_ip;
+		}
+		ip_context->ctxt.vx.dscp = fields[0];
+		ip_context->ctxt.vx.ip_ecn_flags = fields[1];
+		ip_context->ctxt.vx.ttl_hopl = fields[2];
+		ip_context->ctxt.vx.ip_id_behavior = fields[3];
+		ip_context->ctxt.vx.last_ip_id_behavior = fields[4];
+
+		if(ip_context->version == IPV4)
+		{
+			uint16_t last_ip_id;
+			uint8_t df;
+
+			if(!rohc_snapshot_get8(snapshot, &df) || df > 1 ||
+			   !rohc_snapshot_get16(snapshot, &last_ip_id))
+			{
+				goto malformed_ip;
+			}
+			ip_context->ctxt.v4.df = df;
+			ip_context->ctxt.v4.last_ip_id = last_ip_id;
+			continue;
+		}
+		if(!rohc_snapshot_get8(snapshot, &opts_nr) ||
+		   opts_nr > ROHC_TCP_MAX_IP_EXT_HDRS)
+		{
+			goto malformed_ip;
+		}
+		for(j = 0; j < opts_nr; j++)
+		{
+			ipv6_generic_option_context_t *const opt =
+				&(ip_context->opts[j].generic);
+			uint16_t option_length;
+
+			if(!rohc_snapshot_get16(snapshot, &option_length) ||
+			   option_length < 2 ||
+			   option_length > (IPV6_OPT_CTXT_LEN_MAX + 2) ||
+			   !rohc_snapshot_get8(snapshot, &opt->next_header) ||
+			   !rohc_snapshot_get(snapshot, opt->data, option_length - 2))
+			{
+				goto malformed_ip;
+			}
+			opt->option_length = option_length;
+		}
+		ip_context->opts_nr = opts_nr;
+	}
+
+	/* the dynamic state of the TCP header */
+	if(!rohc_snapshot_get32(snapshot, &counts[0]) ||
+	   !rohc_snapshot_get32(snapshot, &counts[1]) ||
+	   !rohc_snapshot_get8(snapshot, &ecn_used) || ecn_used > 1 ||
+	   !rohc_snapshot_get32(snapshot, &counts[2]) ||
+	   !rohc_snapshot_get32(snapshot, &counts[3]) ||
+	   !rohc_snapshot_get32(snapshot, &tcp_context->tcp_last_seq_num) ||
+	   !rohc_snapshot_get16(snapshot, &tcp_context->msn) ||
+	   !rohc_snapshot_get32(snapshot, &counts[4]) ||
+	   !rohc_snapshot_get32(snapshot, &tcp_context->seq_num) ||
+	   !rohc_snapshot_get32(snapshot, &tcp_context->seq_num_scaled) ||
+	   !rohc_snapshot_get32(snapshot, &tcp_context->seq_num_residue) ||
+	   !rohc_snapshot_get32(snapshot, &counts[5]) ||
+	   !rohc_snapshot_get32(snapshot, &counts[6]) ||
+	   !rohc_snapshot_get32(snapshot, &tcp_context->ack_num) ||
+	   !rohc_snapshot_get8(snapshot, &ack_deltas_next) ||
+	   ack_deltas_next >= 20)
+	{
+		goto malformed_tcp;
+	}
+	for(i = 0; i < 20; i++)
+	{
+		if(!rohc_snapshot_get16(snapshot, &tcp_context->ack_deltas_width[i]))
+		{
+			goto malformed_tcp;
+		}
+	}
+	if(!rohc_snapshot_get16(snapshot, &tcp_context->ack_stride) ||
+	   !rohc_snapshot_get32(snapshot, &tcp_context->ack_num_scaled) ||
+	   !rohc_snapshot_get16(snapshot, &tcp_context->ack_num_residue) ||
+	   !rohc_snapshot_get32(snapshot, &counts[7]) ||
+	   !rohc_snapshot_get(snapshot, &tcp_context->old_tcphdr,
+	                      sizeof(struct tcphdr)) ||
+	   !c_wlsb_import(tcp_context->msn_wlsb, snapshot) ||
+	   !c_wlsb_import(tcp_context->ttl_hopl_wlsb, snapshot) ||
+	   !c_wlsb_import(tcp_context->ip_id_wlsb, snapshot) ||
+	   !c_wlsb_import(tcp_context->window_wlsb, snapshot) ||
+	   !c_wlsb_import(tcp_context->seq_wlsb, snapshot) ||
+	   !c_wlsb_import(tcp_context->seq_scaled_wlsb, snapshot) ||
+	   !c_wlsb_import(tcp_context->ack_wlsb, snapshot) ||
+	   !c_wlsb_import(tcp_context->ack_scaled_wlsb, snapshot))
+	{
+		goto malformed_tcp;
+	}
+	tcp_context->tcp_seq_num_change_count = counts[0];
+	tcp_context->tcp_window_change_count = counts[1];
+	tcp_context->ecn_used = !!ecn_used;
+	tcp_context->ecn_used_change_count = counts[2];
+	tcp_context->ecn_used_zero_count = counts[3];
+	tcp_context->ttl_hopl_change_count = counts[4];
+	tcp_context->seq_num_factor = counts[5];
+	tcp_context->seq_num_scaling_nr = counts[6];
+	tcp_context->ack_deltas_next = ack_deltas_next;
+	tcp_context->ack_num_scaling_nr = counts[7];
+
+	if(!c_tcp_opts_import(&tcp_context->tcp_opts, snapshot))
+	{
+		rohc_comp_warn(context, "malformed TCP options in snapshot");
+		goto error;
+	}
+
+	return true;
+
+malformed_ip:
+	rohc_comp_warn(context, "malformed IP header #%zu in snapshot", i + 1);
+	goto error;
+malformed_tcp:
+	rohc_comp_warn(context, "malformed TCP header in snapshot");
+error:
+	return false;
 }
 
 
@@ -1123,7 +1511,7 @@ static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
  *                  \li false if the IP packet does not correspond to
  *                      the profile
  */
-static bool c_tcp_check_profile(const struct rohc_comp *const comp,
+static bool c_tcp_check_profile(struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 {
 	/* TODO: should avoid code duplication by using net_pkt as
@@ -1920,8 +2308,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 
 	/* IR(-DYN) header was successfully built, compute the CRC */
 	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
-	                                       rohc_hdr_len, CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	                                       rohc_hdr_len, CRC_INIT_8);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                rohc_hdr_len, rohc_pkt[crc_position]);
 
@@ -3531,14 +3918,14 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	   packet_type == ROHC_PACKET_TCP_CO_COMMON)
 	{
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_7, ip->data, *payload_offset,
-		                             CRC_INIT_7, context->compressor->crc_table_7);
+		                             CRC_INIT_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                *payload_offset, crc_computed);
 	}
 	else
 	{
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_3, ip->data, *payload_offset,
-		                             CRC_INIT_3, context->compressor->crc_table_3);
+		                             CRC_INIT_3);
 		rohc_comp_debug(context, "CRC-3 on %zu-byte uncompressed header = 0x%x",
 		                *payload_offset, crc_computed);
 	}
@@ -7274,6 +7661,17 @@ const struct rohc_comp_profile c_tcp_profile =
 {
 	.id             = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC 3095) */
 	.protocol       = ROHC_IPPROTO_TCP, /* IP protocol */
+	.ctxt_objs_sizes = { sizeof(struct sc_tcp_context) },
+	.ctxt_wlsbs_widths = { ROHC_COMP_WLSB_WIDTH_CONF,   /* MSN */
+	                       ROHC_COMP_WLSB_WIDTH_CONF,   /* IP-ID offset */
+	                       ROHC_COMP_WLSB_WIDTH_CONF,   /* TTL/Hop Limit */
+	                       ROHC_COMP_WLSB_WIDTH_CONF,   /* TCP window */
+	                       ROHC_COMP_WLSB_WIDTH_CONF,   /* sequence number */
+	                       4,                           /* scaled seq. number */
+	                       ROHC_COMP_WLSB_WIDTH_CONF,   /* ACK number */
+	                       4,                           /* scaled ACK number */
+	                       ROHC_COMP_WLSB_WIDTH_CONF,   /* TS option request */
+	                       ROHC_COMP_WLSB_WIDTH_CONF }, /* TS option reply */
 	.create         = c_tcp_create,     /* profile handlers */
 	.destroy        = c_tcp_destroy,
 	.check_profile  = c_tcp_check_profile,
@@ -7281,5 +7679,7 @@ const struct rohc_comp_profile c_tcp_profile =
 	.encode         = c_tcp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = c_tcp_feedback,
+	.export_ctxt    = c_tcp_export_ctxt,
+	.import_ctxt    = c_tcp_import_ctxt,
 };
 
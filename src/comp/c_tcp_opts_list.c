@@ -30,6 +30,7 @@
 
 #include "schemes/tcp_ts.h"
 #include "schemes/tcp_sack.h"
+#include "rohc_snapshot.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -1068,6 +1069,110 @@ error:
 }
 
 
+/**
+ * @brief Write the compression context for TCP options in a snapshot
+ *
+ * The structure of the last list of TCP options is written first, then the
+ * W-LSB windows of the TCP option Timestamp, then the context of every
+ * option index.
+ *
+ * @param opts_ctxt  The compression context for TCP options
+ * @param snapshot   The snapshot to write to
+ * @return           true if successful, false if the snapshot is too small
+ */
+bool c_tcp_opts_export(const struct c_tcp_opts_ctxt *const opts_ctxt,
+                       struct rohc_buf *const snapshot)
+{
+	size_t i;
+
+	if(!rohc_snapshot_put32(snapshot, opts_ctxt->structure_nr_trans) ||
+	   !rohc_snapshot_put8(snapshot, opts_ctxt->structure_nr) ||
+	   !rohc_snapshot_put(snapshot, opts_ctxt->structure,
+	                      opts_ctxt->structure_nr) ||
+	   !rohc_snapshot_put8(snapshot, opts_ctxt->is_timestamp_init) ||
+	   !c_wlsb_export(opts_ctxt->ts_req_wlsb, snapshot) ||
+	   !c_wlsb_export(opts_ctxt->ts_reply_wlsb, snapshot))
+	{
+		return false;
+	}
+
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		const struct c_tcp_opt_ctxt *const opt = &opts_ctxt->list[i];
+
+		if(!rohc_snapshot_put8(snapshot, opt->used) ||
+		   !rohc_snapshot_put8(snapshot, opt->type) ||
+		   !rohc_snapshot_put32(snapshot, opt->nr_trans) ||
+		   !rohc_snapshot_put32(snapshot, opt->age) ||
+		   !rohc_snapshot_put8(snapshot, opt->data_len) ||
+		   !rohc_snapshot_put(snapshot, opt->data.raw, opt->data_len))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Read the compression context for TCP options from a snapshot
+ *
+ * @param opts_ctxt  The compression context for TCP options
+ * @param snapshot   The snapshot to read from
+ * @return           true if successful, false if the snapshot is malformed
+ */
+bool c_tcp_opts_import(struct c_tcp_opts_ctxt *const opts_ctxt,
+                       struct rohc_buf *const snapshot)
+{
+	uint32_t structure_nr_trans;
+	uint8_t structure_nr;
+	uint8_t is_timestamp_init;
+	size_t i;
+
+	if(!rohc_snapshot_get32(snapshot, &structure_nr_trans) ||
+	   !rohc_snapshot_get8(snapshot, &structure_nr) ||
+	   structure_nr > ROHC_TCP_OPTS_MAX ||
+	   !rohc_snapshot_get(snapshot, opts_ctxt->structure, structure_nr) ||
+	   !rohc_snapshot_get8(snapshot, &is_timestamp_init) ||
+	   is_timestamp_init > 1 ||
+	   !c_wlsb_import(opts_ctxt->ts_req_wlsb, snapshot) ||
+	   !c_wlsb_import(opts_ctxt->ts_reply_wlsb, snapshot))
+	{
+		return false;
+	}
+	opts_ctxt->structure_nr_trans = structure_nr_trans;
+	opts_ctxt->structure_nr = structure_nr;
+	opts_ctxt->is_timestamp_init = !!is_timestamp_init;
+
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		struct c_tcp_opt_ctxt *const opt = &opts_ctxt->list[i];
+		uint8_t used;
+		uint32_t nr_trans;
+		uint32_t age;
+		uint8_t data_len;
+
+		if(!rohc_snapshot_get8(snapshot, &used) || used > 1 ||
+		   !rohc_snapshot_get8(snapshot, &opt->type) ||
+		   !rohc_snapshot_get32(snapshot, &nr_trans) ||
+		   !rohc_snapshot_get32(snapshot, &age) ||
+		   !rohc_snapshot_get8(snapshot, &data_len) ||
+		   data_len > MAX_TCP_OPT_SIZE ||
+		   !rohc_snapshot_get(snapshot, opt->data.raw, data_len))
+		{
+			return false;
+		}
+		opt->used = !!used;
+		opt->nr_trans = nr_trans;
+		opt->age = age;
+		opt->data_len = data_len;
+	}
+
+	return true;
+}
+
+
 /**
  * @brief Get the type and length of the next TCP option
  *
@@ -155,5 +155,12 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
                               const size_t comp_opts_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 
+bool c_tcp_opts_export(const struct c_tcp_opts_ctxt *const opts_ctxt,
+                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool c_tcp_opts_import(struct c_tcp_opts_ctxt *const opts_ctxt,
+                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif /* ROHC_COMP_TCP_OPTS_LIST_H */
 
@@ -28,6 +28,7 @@
 #include "c_udp.h"
 #include "c_ip.h"
 #include "rohc_traces_internal.h"
+#include "rohc_snapshot.h"
 #include "rohc_packets.h"
 #include "rohc_utils.h"
 #include "crc.h"
@@ -88,6 +89,13 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static rohc_status_t c_udp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_udp_import_ctxt(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 static void udp_decide_state(struct rohc_comp_ctxt *const context);
 
 static int c_udp_encode(struct rohc_comp_ctxt *const context,
@@ -146,7 +154,8 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 	udp = (struct udphdr *) packet->transport->data;
 
 	/* create the UDP part of the profile context */
-	udp_context = malloc(sizeof(struct sc_udp_context));
+	udp_context = rohc_slab_malloc(&context->compressor->ctxt_slab,
+	                               sizeof(struct sc_udp_context));
 	if(udp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -213,7 +222,7 @@ quit:
  *                  \li false if the IP packet does not correspond to
  *                      the profile
  */
-bool c_udp_check_profile(const struct rohc_comp *const comp,
+bool c_udp_check_profile(struct rohc_comp *const comp,
                          const struct net_pkt *const packet)
 {
 	const struct udphdr *udp_header;
@@ -571,6 +580,65 @@ static int udp_changed_udp_dynamic(const struct rohc_comp_ctxt *context,
 }
 
 
+/**
+ * @brief Write the UDP context in a snapshot
+ *
+ * @param context   The compression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          Possible return values, see \ref rohc_comp_rfc3095_export
+ */
+static rohc_status_t c_udp_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct sc_udp_context *const udp_context = rfc3095_ctxt->specific;
+	struct udphdr ref_udp = udp_context->old_udp;
+	rohc_status_t status;
+
+	/* the UDP length of the reference headers is fixed for the parsing */
+	ref_udp.len = rohc_hton16(sizeof(struct udphdr));
+	status = rohc_comp_rfc3095_export(context, (uint8_t *) &ref_udp,
+	                                  sizeof(struct udphdr), snapshot);
+	if(status != ROHC_STATUS_OK)
+	{
+		return status;
+	}
+	if(!rohc_snapshot_put32(snapshot, udp_context->udp_checksum_change_count))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the UDP context from a snapshot
+ *
+ * The previous UDP header was initialized from the reference headers.
+ *
+ * @param context   The compression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool c_udp_import_ctxt(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct sc_udp_context *const udp_context = rfc3095_ctxt->specific;
+	uint32_t udp_checksum_change_count;
+
+	if(!rohc_comp_rfc3095_import(context, snapshot) ||
+	   !rohc_snapshot_get32(snapshot, &udp_checksum_change_count))
+	{
+		return false;
+	}
+	udp_context->udp_checksum_change_count = udp_checksum_change_count;
+
+	return true;
+}
+
+
 /**
  * @brief Define the compression part of the UDP profile as described
  *        in the RFC 3095.
@@ -579,6 +647,9 @@ const struct rohc_comp_profile c_udp_profile =
 {
 	.id             = ROHC_PROFILE_UDP, /* profile ID (see 8 in RFC 3095) */
 	.protocol       = ROHC_IPPROTO_UDP, /* IP protocol */
+	.ctxt_objs_sizes = { sizeof(struct rohc_comp_rfc3095_ctxt),
+	                     sizeof(struct sc_udp_context) },
+	.ctxt_wlsbs_widths = { ROHC_COMP_RFC3095_CTXT_WLSBS },
 	.create         = c_udp_create,     /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
 	.check_profile  = c_udp_check_profile,
@@ -586,5 +657,7 @@ const struct rohc_comp_profile c_udp_profile =
 	.encode         = c_udp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.export_ctxt    = c_udp_export_ctxt,
+	.import_ctxt    = c_udp_import_ctxt,
 };
 
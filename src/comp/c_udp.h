@@ -37,7 +37,7 @@
  * Function prototypes.
  */
 
-bool c_udp_check_profile(const struct rohc_comp *const comp,
+bool c_udp_check_profile(struct rohc_comp *const comp,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
@@ -28,6 +28,7 @@
 #include "c_udp.h"
 #include "c_ip.h"
 #include "rohc_traces_internal.h"
+#include "rohc_snapshot.h"
 #include "rohc_packets.h"
 #include "rohc_utils.h"
 #include "crc.h"
@@ -112,7 +113,14 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
                               const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static bool c_udp_lite_check_profile(const struct rohc_comp *const comp,
+static rohc_status_t c_udp_lite_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                            struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_udp_lite_import_ctxt(struct rohc_comp_ctxt *const context,
+                                   struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool c_udp_lite_check_profile(struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
@@ -194,7 +202,8 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 	udp_lite = (struct udphdr *) packet->transport->data;
 
 	/* create the UDP-Lite part of the profile context */
-	udp_lite_context = malloc(sizeof(struct sc_udp_lite_context));
+	udp_lite_context = rohc_slab_malloc(&context->compressor->ctxt_slab,
+	                                    sizeof(struct sc_udp_lite_context));
 	if(udp_lite_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -266,7 +275,7 @@ quit:
  *                  \li false if the IP packet does not correspond to
  *                      the profile
  */
-static bool c_udp_lite_check_profile(const struct rohc_comp *const comp,
+static bool c_udp_lite_check_profile(struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
 {
 	bool ip_check;
@@ -822,6 +831,89 @@ static bool udp_lite_send_cce_packet(const struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Write the UDP-Lite context in a snapshot
+ *
+ * @param context   The compression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          Possible return values, see \ref rohc_comp_rfc3095_export
+ */
+static rohc_status_t c_udp_lite_export_ctxt(const struct rohc_comp_ctxt *const context,
+                                            struct rohc_buf *const snapshot)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct sc_udp_lite_context *const udp_lite_context =
+		rfc3095_ctxt->specific;
+	rohc_status_t status;
+
+	status = rohc_comp_rfc3095_export(context,
+	                                  (uint8_t *) &udp_lite_context->old_udp_lite,
+	                                  sizeof(struct udphdr), snapshot);
+	if(status != ROHC_STATUS_OK)
+	{
+		return status;
+	}
+	if(!rohc_snapshot_put8(snapshot, udp_lite_context->cfp) ||
+	   !rohc_snapshot_put8(snapshot, udp_lite_context->cfi) ||
+	   !rohc_snapshot_put8(snapshot, udp_lite_context->FK) ||
+	   !rohc_snapshot_put32(snapshot, udp_lite_context->coverage_equal_count) ||
+	   !rohc_snapshot_put32(snapshot, udp_lite_context->coverage_inferred_count) ||
+	   !rohc_snapshot_put32(snapshot, udp_lite_context->sent_cce_only_count) ||
+	   !rohc_snapshot_put32(snapshot, udp_lite_context->sent_cce_on_count) ||
+	   !rohc_snapshot_put32(snapshot, udp_lite_context->sent_cce_off_count))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the UDP-Lite context from a snapshot
+ *
+ * The previous UDP-Lite header was initialized from the reference headers.
+ *
+ * @param context   The compression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool c_udp_lite_import_ctxt(struct rohc_comp_ctxt *const context,
+                                   struct rohc_buf *const snapshot)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct sc_udp_lite_context *const udp_lite_context = rfc3095_ctxt->specific;
+	uint8_t cfp;
+	uint8_t cfi;
+	uint32_t counts[5];
+	size_t i;
+
+	if(!rohc_comp_rfc3095_import(context, snapshot) ||
+	   !rohc_snapshot_get8(snapshot, &cfp) ||
+	   !rohc_snapshot_get8(snapshot, &cfi) ||
+	   !rohc_snapshot_get8(snapshot, &udp_lite_context->FK))
+	{
+		return false;
+	}
+	for(i = 0; i < 5; i++)
+	{
+		if(!rohc_snapshot_get32(snapshot, &counts[i]))
+		{
+			return false;
+		}
+	}
+	udp_lite_context->cfp = cfp;
+	udp_lite_context->cfi = cfi;
+	udp_lite_context->coverage_equal_count = counts[0];
+	udp_lite_context->coverage_inferred_count = counts[1];
+	udp_lite_context->sent_cce_only_count = counts[2];
+	udp_lite_context->sent_cce_on_count = counts[3];
+	udp_lite_context->sent_cce_off_count = counts[4];
+
+	return true;
+}
+
+
 /**
  * @brief Define the compression part of the UDP-Lite profile as described
  *        in the RFC 4019.
@@ -830,6 +922,9 @@ const struct rohc_comp_profile c_udp_lite_profile =
 {
 	.id             = ROHC_PROFILE_UDPLITE, /* profile ID (see 7 in RFC4019) */
 	.protocol       = ROHC_IPPROTO_UDPLITE, /* IP protocol */
+	.ctxt_objs_sizes = { sizeof(struct rohc_comp_rfc3095_ctxt),
+	                     sizeof(struct sc_udp_lite_context) },
+	.ctxt_wlsbs_widths = { ROHC_COMP_RFC3095_CTXT_WLSBS },
 	.create         = c_udp_lite_create,    /* profile handlers */
 	.destroy        = rohc_comp_rfc3095_destroy,
 	.check_profile  = c_udp_lite_check_profile,
@@ -837,5 +932,7 @@ const struct rohc_comp_profile c_udp_lite_profile =
 	.encode         = c_udp_lite_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.export_ctxt    = c_udp_lite_export_ctxt,
+	.import_ctxt    = c_udp_lite_import_ctxt,
 };
 
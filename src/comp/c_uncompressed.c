@@ -44,7 +44,7 @@ static bool c_uncompressed_create(struct rohc_comp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
-static bool c_uncompressed_check_profile(const struct rohc_comp *const comp,
+static bool c_uncompressed_check_profile(struct rohc_comp *const comp,
                                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
@@ -160,7 +160,7 @@ static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
  *                      the profile
 
  */
-static bool c_uncompressed_check_profile(const struct rohc_comp *const comp __attribute__((unused)),
+static bool c_uncompressed_check_profile(struct rohc_comp *const comp __attribute__((unused)),
                                          const struct net_pkt *const packet __attribute__((unused)))
 {
 	return true;
@@ -505,8 +505,7 @@ static int uncompressed_code_IR_packet(const struct rohc_comp_ctxt *context,
 	/* part 5 */
 	rohc_pkt[counter] = 0;
 	rohc_pkt[counter] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                  CRC_INIT_8,
-	                                  context->compressor->crc_table_8);
+	                                  CRC_INIT_8);
 	rohc_comp_debug(context, "CRC on %zu bytes = 0x%02x", counter,
 	                rohc_pkt[counter]);
 	counter++;
@@ -41,10 +41,12 @@
 
 #include "rohc_comp.h"
 #include "rohc_comp_internals.h"
+#include "c_rtp.h"
 #include "rohc_packets.h"
 #include "rohc_traces.h"
 #include "rohc_traces_internal.h"
 #include "rohc_time_internal.h"
+#include "rohc_snapshot.h"
 #include "rohc_debug.h"
 #include "rohc_utils.h"
 #include "sdvl.h"
@@ -62,8 +64,12 @@
 #  include <string.h>
 #endif
 #include <stdlib.h>
+#if defined(_WIN32) && !defined(__KERNEL__)
+#  include <malloc.h> /* for _aligned_malloc() */
+#endif
 #ifdef __KERNEL__
 #  include <linux/types.h>
+#  include <asm/barrier.h>
 #else
 #  include <stdbool.h>
 #endif
@@ -71,6 +77,18 @@
 #include <stdarg.h>
 
 
+/* Load an index of the queue of feedback items written by another thread,
+ * and store an index of the queue for another thread */
+#ifdef __KERNEL__
+#  define rohc_comp_load_acquire(ptr)  smp_load_acquire(ptr)
+#  define rohc_comp_store_release(ptr, value)  smp_store_release(ptr, value)
+#else
+#  define rohc_comp_load_acquire(ptr)  __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#  define rohc_comp_store_release(ptr, value) \
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#endif
+
+
 extern const struct rohc_comp_profile c_rtp_profile,
                                       c_udp_profile,
                                       c_udp_lite_profile,
@@ -97,6 +115,49 @@ static const struct rohc_comp_profile *const rohc_comp_profiles[C_NUM_PROFILES]
 };
 
 
+/*
+ * Prototypes of private functions related to ROHC compression
+ */
+
+static struct rohc_comp * c_alloc_comp(void)
+	__attribute__((warn_unused_result));
+static void c_free_comp(struct rohc_comp *const comp);
+
+static rohc_status_t __rohc_compress(struct rohc_comp *const comp,
+                                     const struct rohc_buf uncomp_packet,
+                                     struct rohc_buf *const rohc_packet,
+                                     const size_t max_len,
+                                     rohc_comp_payload_t *const payload)
+	__attribute__((warn_unused_result));
+
+static bool rohc_comp_parse_pkt(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                const struct rohc_buf *const rohc_packet,
+                                struct net_pkt *const ip_pkt)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+static rohc_status_t rohc_comp_encode_pkt(struct rohc_comp *const comp,
+                                          struct rohc_comp_ctxt *c,
+                                          const struct net_pkt *const ip_pkt,
+                                          const struct rohc_buf uncomp_packet,
+                                          struct rohc_buf *const rohc_packet,
+                                          const size_t max_len,
+                                          rohc_comp_payload_t *const payload,
+                                          const bool segment_allowed)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+
+static void rohc_comp_prefetch_ctxt(const struct rohc_comp *const comp,
+                                    const struct rohc_comp_burst_pkt *const bp,
+                                    const bool specific)
+	__attribute__((nonnull(1, 2)));
+
+static rohc_status_t __rohc_comp_get_segment(struct rohc_comp *const comp,
+                                             const size_t max_len,
+                                             struct rohc_buf *const segment,
+                                             rohc_comp_payload_t *const payload)
+	__attribute__((warn_unused_result));
+
+
 /*
  * Prototypes of private functions related to ROHC compression profiles
  */
@@ -107,10 +168,17 @@ static const struct rohc_comp_profile *
 	__attribute__((warn_unused_result, nonnull(1)));
 
 static const struct rohc_comp_profile *
-	c_get_profile_from_packet(const struct rohc_comp *const comp,
+	c_get_profile_from_packet(struct rohc_comp *const comp,
 	                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static void c_build_profiles_dispatch(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+static void c_reset_rtp_flows(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+static uint16_t c_get_dispatch_key(const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 
 /*
  * Prototypes of private functions related to ROHC compression contexts
@@ -120,6 +188,8 @@ static bool c_create_contexts(struct rohc_comp *const comp)
 	__attribute__((nonnull(1)));
 static void c_destroy_contexts(struct rohc_comp *const comp)
 	__attribute__((nonnull(1)));
+static bool c_prealloc_contexts(struct rohc_comp *const comp)
+	__attribute__((nonnull(1), warn_unused_result));
 
 static struct rohc_comp_ctxt *
 	c_create_context(struct rohc_comp *const comp,
@@ -133,9 +203,50 @@ static struct rohc_comp_ctxt *
 	                    const int profile_id_hint,
 	                    const struct rohc_ts arrival_time)
 	__attribute__((nonnull(1, 2), warn_unused_result));
+static struct rohc_comp_ctxt *
+	c_lookup_context(const struct rohc_comp *const comp,
+	                 const struct rohc_comp_profile *const profile,
+	                 const struct net_pkt *const packet,
+	                 const uint32_t flow_hash)
+	__attribute__((nonnull(1, 2, 3), warn_unused_result));
+static void c_use_context(struct rohc_comp *const comp,
+                          struct rohc_comp_ctxt *const context,
+                          const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1, 2)));
 static struct rohc_comp_ctxt *
 	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static void c_destroy_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+
+static inline uint32_t c_flow_hash_mix(uint32_t hash, uint32_t word)
+	__attribute__((warn_unused_result, const));
+static uint32_t c_flow_hash_ip(uint32_t hash, const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(2)));
+static inline uint32_t c_flow_hash_finish(uint32_t hash)
+	__attribute__((warn_unused_result, const));
+static uint32_t c_get_flow_hash(const struct rohc_comp_profile *const profile,
+                                const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint32_t
+	c_get_profile_cache_key(const struct net_pkt *const packet,
+	                        const uint16_t dispatch_key,
+	                        struct rohc_comp_profile_cache_key *const key)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static void c_ctxt_hash_add(struct rohc_comp *const comp,
+                            const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_hash_del(struct rohc_comp *const comp,
+                            const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+
+static void c_ctxt_lru_append(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_lru_unlink(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
 
 
 /*
@@ -147,6 +258,9 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
                                          const size_t size)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static void rohc_comp_drain_feedback(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
 static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
                                          const uint8_t *const feedback,
                                          const size_t feedback_len,
@@ -166,6 +280,35 @@ static bool rohc_comp_feedback_check_opts(const struct rohc_comp_ctxt *const con
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 
+/*
+ * Prototypes of private functions related to detailed statistics
+ */
+
+static struct rohc_stats *
+	rohc_comp_get_ctxt_stats(const struct rohc_comp *const comp,
+	                         const struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
+static void rohc_comp_stats_add_pkt(struct rohc_comp *const comp,
+                                    const struct rohc_comp_ctxt *const context,
+                                    const rohc_packet_t packet_type,
+                                    const uint64_t start_time,
+                                    const size_t comp_hdr_len,
+                                    const size_t uncomp_hdr_len)
+	__attribute__((nonnull(1, 2)));
+
+static void rohc_comp_stats_add_transition(struct rohc_comp *const comp,
+                                           const struct rohc_comp_ctxt *const context,
+                                           const rohc_comp_state_t old_state,
+                                           const rohc_comp_state_t new_state)
+	__attribute__((nonnull(1, 2)));
+
+static bool rohc_comp_stats_export(const struct rohc_comp *const comp,
+                                   const struct rohc_stats *const counters,
+                                   rohc_comp_stats_snapshot_t *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+
 /*
  * Definitions of public functions
  */
@@ -232,9 +375,41 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
                                   const rohc_cid_t max_cid,
                                   const rohc_comp_random_cb_t rand_cb,
                                   void *const rand_priv)
+{
+	return rohc_comp_new_shard(cid_type, max_cid, 0, max_cid + 1,
+	                           rand_cb, rand_priv);
+}
+
+
+/**
+ * @brief Create a new ROHC compressor that uses a range of CIDs only
+ *
+ * The compressor works as one created by \ref rohc_comp_new2 but it only
+ * creates contexts with CIDs in the range [first_cid, first_cid +
+ * contexts_nr - 1]. The CIDs are encoded according to \e cid_type and
+ * \e max_cid, so that several compressors with disjoint ranges of CIDs may
+ * share one ROHC channel.
+ *
+ * @param cid_type     The type of Context IDs (CID) of the ROHC channel
+ * @param max_cid      The maximum value for CIDs on the ROHC channel
+ * @param first_cid    The first CID the compressor may use
+ * @param contexts_nr  The number of CIDs the compressor may use
+ * @param rand_cb      The random callback to set
+ * @param rand_priv    Private data that will be given to the callback
+ * @return             The created compressor if successful,
+ *                     NULL if creation failed
+ */
+struct rohc_comp * rohc_comp_new_shard(const rohc_cid_type_t cid_type,
+                                       const rohc_cid_t max_cid,
+                                       const rohc_cid_t first_cid,
+                                       const size_t contexts_nr,
+                                       const rohc_comp_random_cb_t rand_cb,
+                                       void *const rand_priv)
 {
 	const size_t wlsb_width = 4; /* default window width for W-LSB encoding */
 	struct rohc_comp *comp;
+	size_t rtp_flows_sets_nr;
+	size_t profiles_cache_size;
 	bool is_fine;
 	size_t i;
 
@@ -260,13 +435,18 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		/* unexpected CID type */
 		goto error;
 	}
+	if(contexts_nr == 0 || first_cid > max_cid ||
+	   contexts_nr > (max_cid - first_cid + 1))
+	{
+		goto error;
+	}
 	if(rand_cb == NULL)
 	{
 		return NULL;
 	}
 
 	/* allocate memory for the ROHC compressor */
-	comp = malloc(sizeof(struct rohc_comp));
+	comp = c_alloc_comp();
 	if(comp == NULL)
 	{
 		goto error;
@@ -275,7 +455,40 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 
 	comp->medium.cid_type = cid_type;
 	comp->medium.max_cid = max_cid;
+	comp->first_cid = first_cid;
+	comp->contexts_nr = contexts_nr;
+
+	/* allocate memory for the cache of RTP detection: its number of sets is
+	 * a power of two, with at least twice as many flows as contexts */
+	rtp_flows_sets_nr = 1;
+	while((rtp_flows_sets_nr * ROHC_COMP_RTP_FLOWS_WAYS) < (contexts_nr * 2))
+	{
+		rtp_flows_sets_nr *= 2;
+	}
+	comp->rtp_flows = calloc(rtp_flows_sets_nr * ROHC_COMP_RTP_FLOWS_WAYS,
+	                         sizeof(struct rohc_comp_rtp_flow));
+	if(comp->rtp_flows == NULL)
+	{
+		goto destroy_comp;
+	}
+	comp->rtp_flows_mask = rtp_flows_sets_nr - 1;
+
+	/* allocate memory for the cache of profiles: its size is a power of two
+	 * at least twice as large as the number of contexts */
+	profiles_cache_size = 2;
+	while(profiles_cache_size < (contexts_nr * 2))
+	{
+		profiles_cache_size *= 2;
+	}
+	comp->profiles_cache = malloc(profiles_cache_size *
+	                              sizeof(struct rohc_comp_profile_cache));
+	if(comp->profiles_cache == NULL)
+	{
+		goto destroy_comp;
+	}
+	comp->profiles_cache_mask = profiles_cache_size - 1;
 	comp->mrru = 0; /* no segmentation by default */
+	comp->crc_fcs32 = rohc_crc_fcs32_probe();
 	comp->random_cb = rand_cb;
 	comp->random_cb_ctxt = rand_priv;
 
@@ -284,6 +497,7 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 	{
 		comp->enabled_profiles[i] = false;
 	}
+	c_build_profiles_dispatch(comp);
 
 	/* reset statistics */
 	comp->num_packets = 0;
@@ -315,23 +529,6 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
-	/* init the tables for fast CRC computation */
-	is_fine = rohc_crc_init_table(comp->crc_table_3, ROHC_CRC_TYPE_3);
-	if(is_fine != true)
-	{
-		goto destroy_comp;
-	}
-	is_fine = rohc_crc_init_table(comp->crc_table_7, ROHC_CRC_TYPE_7);
-	if(is_fine != true)
-	{
-		goto destroy_comp;
-	}
-	is_fine = rohc_crc_init_table(comp->crc_table_8, ROHC_CRC_TYPE_8);
-	if(is_fine != true)
-	{
-		goto destroy_comp;
-	}
-
 	/* create the MAX_CID + 1 contexts */
 	if(!c_create_contexts(comp))
 	{
@@ -341,7 +538,9 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 	return comp;
 
 destroy_comp:
-	zfree(comp);
+	free(comp->profiles_cache);
+	free(comp->rtp_flows);
+	c_free_comp(comp);
 error:
 	return NULL;
 }
@@ -380,8 +579,24 @@ void rohc_comp_free(struct rohc_comp *const comp)
 		/* free memory used by contexts */
 		c_destroy_contexts(comp);
 
+		/* free the RRU buffer used for segmentation */
+		free(comp->rru);
+
+		/* free the packets of the bursts if any */
+		free(comp->burst);
+
+		/* free the cache of profiles and the cache of RTP detection */
+		free(comp->profiles_cache);
+		free(comp->rtp_flows);
+
+		/* free the queue of feedback items */
+		free(comp->feedback_queue.slots);
+
+		/* free the detailed statistics if any */
+		free(comp->detailed_stats);
+
 		/* free the compressor */
-		free(comp);
+		c_free_comp(comp);
 	}
 }
 
@@ -459,6 +674,66 @@ error:
 }
 
 
+/**
+ * @brief Set the minimum level of the traces in compressor
+ *
+ * Set the minimum level of the traces that the compressor gives to the
+ * user-defined trace callback. The traces of lower levels are skipped
+ * before their arguments are evaluated, so they cost almost nothing on the
+ * fast path. The traces below the level selected by the configure option
+ * --with-max-trace-level are never built in the library whatever the
+ * minimum level set here.
+ *
+ * The default minimum level is \ref ROHC_TRACE_DEBUG, ie. all traces are
+ * given to the callback.
+ *
+ * @warning The minimum level can not be modified after library
+ *          initialization, like the trace callback
+ *
+ * @param comp       The ROHC compressor
+ * @param min_level  The minimum level of the traces to give to the callback
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_traces_cb2
+ */
+bool rohc_comp_set_traces_min_level(struct rohc_comp *const comp,
+                                    const rohc_trace_level_t min_level)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* check the trace level */
+	if(min_level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "invalid minimum level %d for traces", min_level);
+		goto error;
+	}
+
+	/* refuse to set a new minimum level if compressor is in use: the
+	 * contexts and their encoding schemes keep a copy of it */
+	if(comp->num_packets > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the minimum level of traces after initialization");
+		goto error;
+	}
+
+	comp->trace_min_level = min_level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Compress the given uncompressed packet into a ROHC packet
  *
@@ -524,145 +799,550 @@ error:
  *
  * @see rohc_comp_set_mrru
  * @see rohc_comp_get_segment2
+ * @see rohc_compress_sg
  */
 rohc_status_t rohc_compress4(struct rohc_comp *const comp,
                              const struct rohc_buf uncomp_packet,
                              struct rohc_buf *const rohc_packet)
 {
-	struct net_pkt ip_pkt;
-	struct rohc_comp_ctxt *c;
-	rohc_packet_t packet_type;
-	int rohc_hdr_size;
-	size_t payload_size;
-	size_t payload_offset;
+	return __rohc_compress(comp, uncomp_packet, rohc_packet, 0, NULL);
+}
 
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
 
-	/* check inputs validity */
+/**
+ * @brief Compress the given uncompressed packet without copying its payload
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, but
+ * write only the ROHC header in the output buffer \e rohc_hdr. The payload of
+ * the uncompressed packet is not copied: \e payload points to it inside
+ * \e uncomp_packet. The ROHC packet is the ROHC header followed by that
+ * payload, so it may be sent with writev() or sendmsg() without any copy.
+ *
+ * Notes:
+ *   \li ROHC segmentation:
+ *       The ROHC compressor has to use ROHC segmentation if the ROHC packet
+ *       (header and payload) is larger than \e max_len bytes and if the MRRU
+ *       configured with the function \ref rohc_comp_set_mrru was not exceeded.
+ *       The payload is not copied in the compressor either, so the
+ *       uncompressed packet shall not be modified nor freed until the final
+ *       ROHC segment was retrieved with \ref rohc_comp_get_segment_sg or
+ *       \ref rohc_comp_get_segment2.
+ *   \li Time-related features in the ROHC protocol:
+ *       see \ref rohc_compress4
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param max_len        The maximum length (in bytes) of the ROHC packet,
+ *                       ROHC header and payload included
+ * @param[out] rohc_hdr  The ROHC header of the compressed ROHC packet
+ * @param[out] payload   The payload of the compressed ROHC packet, it points
+ *                       inside \e uncomp_packet
+ * @return               Possible return values:
+ *                       \li \ref ROHC_STATUS_OK if a ROHC header and its
+ *                           payload are returned
+ *                       \li \ref ROHC_STATUS_SEGMENT if no ROHC data is
+ *                           returned and ROHC segments can be retrieved
+ *                           with successive calls to
+ *                           \ref rohc_comp_get_segment_sg
+ *                       \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_comp_get_segment_sg
+ */
+rohc_status_t rohc_compress_sg(struct rohc_comp *const comp,
+                               const struct rohc_buf uncomp_packet,
+                               const size_t max_len,
+                               struct rohc_buf *const rohc_hdr,
+                               rohc_comp_payload_t *const payload)
+{
 	if(comp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(uncomp_packet))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is malformed");
-		goto error;
-	}
-	if(rohc_buf_is_empty(uncomp_packet))
+	if(payload == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is empty");
+		             "given payload is NULL");
 		goto error;
 	}
-	if(rohc_packet == NULL)
+	if(max_len == 0)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is NULL");
+		             "given maximum length for ROHC packet is zero");
 		goto error;
 	}
-	if(rohc_buf_is_malformed(*rohc_packet))
+
+	return __rohc_compress(comp, uncomp_packet, rohc_hdr, max_len, payload);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress a burst of uncompressed packets into ROHC packets
+ *
+ * Compress the given uncompressed packets as successive calls to
+ * \ref rohc_compress4 would do, but share the work between the packets of
+ * the burst:
+ *  -# all the packets are checked and parsed, their profiles are determined
+ *     and the context hash table slots for their flows are prefetched,
+ *  -# the packets are compressed in order, while the contexts of the next
+ *     packets are prefetched.
+ *
+ * The packets are handled by groups of 32 packets. The ROHC packets are the
+ * same as the ones that successive calls to \ref rohc_compress4 would
+ * produce.
+ *
+ * The ROHC packet for \e uncomp_packets[i] is stored in \e rohc_packets[i]
+ * and its status in \e statuses[i], see \ref rohc_compress4 for the possible
+ * status values. Only one packet of the burst may be segmented: if the RRU
+ * is already used by another packet of the burst, the packet is dropped and
+ * \ref ROHC_STATUS_OUTPUT_TOO_SMALL is returned for it. The segments of the
+ * segmented packet may be retrieved with \ref rohc_comp_get_segment2 once
+ * the whole burst is compressed.
+ *
+ * @param comp                The ROHC compressor
+ * @param uncomp_packets      The uncompressed packets to compress
+ * @param[out] rohc_packets   The resulting compressed ROHC packets
+ * @param[out] statuses       The compression status of every packet
+ * @param packets_nr          The number of packets in the burst
+ * @return                    The number of packets for which
+ *                            \ref ROHC_STATUS_OK or
+ *                            \ref ROHC_STATUS_SEGMENT is returned
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+size_t rohc_compress_burst(struct rohc_comp *const comp,
+                           const struct rohc_buf uncomp_packets[],
+                           struct rohc_buf rohc_packets[],
+                           rohc_status_t statuses[],
+                           const size_t packets_nr)
+{
+	bool rru_used = false;
+	size_t compressed_nr = 0;
+	size_t first;
+	size_t i;
+
+	/* check inputs validity */
+	if(comp == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*rohc_packet))
+	if(uncomp_packets == NULL || rohc_packets == NULL || statuses == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is not empty");
+		             "given arrays of packets and statuses cannot be NULL");
 		goto error;
 	}
 
-	/* print uncompressed bytes */
-	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	/* the packets of the bursts are allocated only if bursts are used */
+	if(comp->burst == NULL)
 	{
-		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
-		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
-		                 "uncompressed data, max 100 bytes", uncomp_packet);
+		comp->burst = malloc(ROHC_COMP_BURST_MAX *
+		                     sizeof(struct rohc_comp_burst_pkt));
+		if(comp->burst == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "no memory for the packets of the burst");
+			goto error;
+		}
 	}
 
-	/* parse the uncompressed packet */
-	if(!net_pkt_parse(&ip_pkt, uncomp_packet, comp->trace_callback,
-	                  comp->trace_callback_priv, ROHC_TRACE_COMP))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to parse uncompressed packet");
-		goto error;
-	}
+	/* take into account the feedback queued by another thread */
+	rohc_comp_drain_feedback(comp);
 
-	/* find the best context for the packet */
-	c = rohc_comp_find_ctxt(comp, &ip_pkt, -1, uncomp_packet.time);
-	if(c == NULL)
+	for(first = 0; first < packets_nr; first += ROHC_COMP_BURST_MAX)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to find a matching context or to create a new "
-		             "context");
-		goto error;
-	}
-
-	/* create the ROHC packet: */
-	rohc_packet->len = 0;
+		const size_t nr = rohc_min(packets_nr - first, ROHC_COMP_BURST_MAX);
+		const struct rohc_buf *const uncomp = uncomp_packets + first;
+		struct rohc_buf *const rohc = rohc_packets + first;
+		rohc_status_t *const st = statuses + first;
+
+		/* check and parse all the packets, then determine their profiles and
+		 * flow hashes, and prefetch the hash table slots for their flows */
+		for(i = 0; i < nr; i++)
+		{
+			struct rohc_comp_burst_pkt *const bp = &comp->burst[i];
 
-	/* use profile to compress packet */
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "compress the packet #%d", comp->num_packets + 1);
-	rohc_hdr_size =
-		c->profile->encode(c, &ip_pkt, rohc_buf_data(*rohc_packet),
-		                   rohc_buf_avail_len(*rohc_packet),
-		                   &packet_type, &payload_offset);
-	if(rohc_hdr_size < 0)
-	{
-		/* error while compressing, use the Uncompressed profile */
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "error while compressing with the profile, using "
-		             "uncompressed profile");
+			st[i] = ROHC_STATUS_ERROR;
+			bp->profile = NULL;
 
-		/* free context if it was just created */
-		if(c->num_sent_packets <= 1)
-		{
-			c->profile->destroy(c);
-			c->used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
+			if(!rohc_comp_parse_pkt(comp, uncomp[i], &rohc[i], &bp->pkt))
+			{
+				continue;
+			}
+			bp->profile = c_get_profile_from_packet(comp, &bp->pkt);
+			if(bp->profile == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "no profile found for packet #%zu of burst, giving "
+				             "up", first + i + 1);
+				continue;
+			}
+			bp->flow_hash = c_get_flow_hash(bp->profile, &bp->pkt);
+			__builtin_prefetch(&comp->ctxts_hash[bp->flow_hash &
+			                                     comp->ctxts_hash_mask]);
 		}
-
-		/* find the best context for the Uncompressed profile */
-		c = rohc_comp_find_ctxt(comp, &ip_pkt, ROHC_PROFILE_UNCOMPRESSED,
-		                        uncomp_packet.time);
-		if(c == NULL)
+		for(i = 0; i < rohc_min(nr, 2U); i++)
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to find a matching Uncompressed context or to "
-			             "create a new Uncompressed context");
-			goto error;
+			rohc_comp_prefetch_ctxt(comp, &comp->burst[i], false);
 		}
 
-		/* use the Uncompressed profile to compress the packet */
-		rohc_hdr_size =
-			c->profile->encode(c, &ip_pkt, rohc_buf_data(*rohc_packet),
-			                   rohc_buf_avail_len(*rohc_packet),
-			                   &packet_type, &payload_offset);
-		if(rohc_hdr_size < 0)
+		/* compress the packets in order: the context that matches one packet
+		 * depends on the compression of the previous packets */
+		for(i = 0; i < nr; i++)
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "error while compressing with uncompressed profile, "
-			             "giving up");
-			goto error_free_new_context;
+			struct rohc_comp_burst_pkt *const bp = &comp->burst[i];
+			struct rohc_comp_ctxt *context;
+
+			/* prefetch the contexts of the next packets */
+			if((i + 1) < nr)
+			{
+				rohc_comp_prefetch_ctxt(comp, &comp->burst[i + 1], true);
+			}
+			if((i + 2) < nr)
+			{
+				rohc_comp_prefetch_ctxt(comp, &comp->burst[i + 2], false);
+			}
+
+			if(bp->profile == NULL)
+			{
+				continue;
+			}
+
+			/* find the best context for the packet */
+			context = c_lookup_context(comp, bp->profile, &bp->pkt,
+			                           bp->flow_hash);
+			if(context != NULL)
+			{
+				c_use_context(comp, context, uncomp[i].time);
+			}
+			else
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "no existing context found for packet #%zu of burst, "
+				           "create a new one", first + i + 1);
+				context = c_create_context(comp, bp->profile, &bp->pkt,
+				                           uncomp[i].time);
+				if(context == NULL)
+				{
+					rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+					             "failed to create a new context for packet #%zu "
+					             "of burst", first + i + 1);
+					continue;
+				}
+			}
+
+			/* compress the packet */
+			st[i] = rohc_comp_encode_pkt(comp, context, &bp->pkt, uncomp[i],
+			                             &rohc[i], 0, NULL, !rru_used);
+			if(st[i] == ROHC_STATUS_OK)
+			{
+				compressed_nr++;
+			}
+			else if(st[i] == ROHC_STATUS_SEGMENT)
+			{
+				rru_used = true;
+				compressed_nr++;
+			}
 		}
 	}
-	rohc_packet->len += rohc_hdr_size;
 
-	/* the payload starts after the header, skip it */
-	rohc_buf_pull(rohc_packet, rohc_hdr_size);
-	payload_size = ip_pkt.len - payload_offset;
+	return compressed_nr;
 
-	/* is packet too large for output buffer? */
-	if(payload_size > rohc_buf_avail_len(*rohc_packet))
+error:
+	if(statuses != NULL)
 	{
-		const size_t max_rohc_buf_len =
-			rohc_buf_avail_len(*rohc_packet) + rohc_hdr_size;
-		uint32_t rru_crc;
+		for(i = 0; i < packets_nr; i++)
+		{
+			statuses[i] = ROHC_STATUS_ERROR;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Prefetch the context that most probably matches the given packet
+ *
+ * The context stored in the first hash table slot for the flow of the packet
+ * is the one that most probably matches the packet. The hash table slot
+ * shall be prefetched before the context, and the context before its
+ * profile-specific part.
+ *
+ * @param comp      The ROHC compressor
+ * @param bp        The packet of the burst
+ * @param specific  false to prefetch the context,
+ *                  true to prefetch the profile-specific part of the context
+ */
+static void rohc_comp_prefetch_ctxt(const struct rohc_comp *const comp,
+                                    const struct rohc_comp_burst_pkt *const bp,
+                                    const bool specific)
+{
+	const struct rohc_comp_ctxt_slot *slot;
+
+	if(bp->profile == NULL)
+	{
+		return;
+	}
+
+	slot = &comp->ctxts_hash[bp->flow_hash & comp->ctxts_hash_mask];
+	if(slot->cid == ROHC_COMP_CTXT_SLOT_FREE)
+	{
+		return;
+	}
+
+	if(specific)
+	{
+		__builtin_prefetch(comp->contexts[slot->cid - comp->first_cid].specific);
+	}
+	else
+	{
+		__builtin_prefetch(&comp->contexts[slot->cid - comp->first_cid]);
+	}
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet with or without payload copy
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The ROHC header, followed by the payload if the
+ *                          payload is copied
+ * @param max_len           The maximum length of the ROHC packet if the
+ *                          payload is not copied, ignored otherwise (the
+ *                          whole ROHC packet shall then fit in
+ *                          \e rohc_packet)
+ * @param[out] payload      NULL to copy the payload after the ROHC header,
+ *                          the description of the uncopied payload otherwise
+ * @return                  Possible return values, see \ref rohc_compress4
+ */
+static rohc_status_t __rohc_compress(struct rohc_comp *const comp,
+                                     const struct rohc_buf uncomp_packet,
+                                     struct rohc_buf *const rohc_packet,
+                                     const size_t max_len,
+                                     rohc_comp_payload_t *const payload)
+{
+	struct net_pkt ip_pkt;
+	struct rohc_comp_ctxt *c;
+
+	/* check inputs validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* take into account the feedback queued by another thread */
+	rohc_comp_drain_feedback(comp);
+
+	/* check and parse the uncompressed packet */
+	if(!rohc_comp_parse_pkt(comp, uncomp_packet, rohc_packet, &ip_pkt))
+	{
+		goto error;
+	}
+
+	/* find the best context for the packet */
+	c = rohc_comp_find_ctxt(comp, &ip_pkt, -1, uncomp_packet.time);
+	if(c == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to find a matching context or to create a new "
+		             "context");
+		goto error;
+	}
+
+	/* compress the packet */
+	return rohc_comp_encode_pkt(comp, c, &ip_pkt, uncomp_packet, rohc_packet,
+	                            max_len, payload, true);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Check the buffers given for one packet to compress, then parse the
+ *        uncompressed packet
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param rohc_packet       The buffer for the compressed packet
+ * @param[out] ip_pkt       The parsed uncompressed packet
+ * @return                  true if the packet may be compressed,
+ *                          false otherwise
+ */
+static bool rohc_comp_parse_pkt(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                const struct rohc_buf *const rohc_packet,
+                                struct net_pkt *const ip_pkt)
+{
+	if(rohc_buf_is_malformed(uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is empty");
+		goto error;
+	}
+	if(rohc_packet == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is not empty");
+		goto error;
+	}
+
+	/* print uncompressed bytes */
+	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(comp, ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
+		                 "uncompressed data, max 100 bytes", uncomp_packet);
+	}
+
+	/* parse the uncompressed packet */
+	if(!net_pkt_parse(ip_pkt, uncomp_packet, comp->trace_callback,
+	                 comp->trace_callback_priv, comp->trace_min_level,
+	                 ROHC_TRACE_COMP))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to parse uncompressed packet");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress one parsed packet with the given context
+ *
+ * The Uncompressed profile is used if the profile of the context fails to
+ * compress the packet.
+ *
+ * @param comp               The ROHC compressor
+ * @param c                  The compression context for the packet
+ * @param ip_pkt             The parsed uncompressed packet
+ * @param uncomp_packet      The uncompressed packet to compress
+ * @param[out] rohc_packet   The ROHC header, followed by the payload if the
+ *                           payload is copied
+ * @param max_len            The maximum length of the ROHC packet if the
+ *                           payload is not copied, ignored otherwise
+ * @param[out] payload       NULL to copy the payload after the ROHC header,
+ *                           the description of the uncopied payload otherwise
+ * @param segment_allowed    Whether the RRU of the compressor may be used if
+ *                           the ROHC packet is too large
+ * @return                   Possible return values, see \ref rohc_compress4
+ */
+static rohc_status_t rohc_comp_encode_pkt(struct rohc_comp *const comp,
+                                          struct rohc_comp_ctxt *c,
+                                          const struct net_pkt *const ip_pkt,
+                                          const struct rohc_buf uncomp_packet,
+                                          struct rohc_buf *const rohc_packet,
+                                          const size_t max_len,
+                                          rohc_comp_payload_t *const payload,
+                                          const bool segment_allowed)
+{
+	const uint64_t start_time =
+		(comp->detailed_stats != NULL ? rohc_time_get_ns() : 0);
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	size_t max_rohc_len;
+	size_t payload_size;
+	size_t payload_offset;
+	size_t rohc_len;
+
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+
+	/* the whole ROHC packet shall fit in the output buffer if the payload is
+	 * copied, the limit is given by the user otherwise */
+	if(payload == NULL)
+	{
+		max_rohc_len = rohc_buf_avail_len(*rohc_packet);
+	}
+	else
+	{
+		max_rohc_len = max_len;
+	}
+
+	/* create the ROHC packet: */
+	rohc_packet->len = 0;
+
+	/* use profile to compress packet */
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "compress the packet #%d", comp->num_packets + 1);
+	rohc_hdr_size =
+		c->profile->encode(c, ip_pkt, rohc_buf_data(*rohc_packet),
+		                   rohc_buf_avail_len(*rohc_packet),
+		                   &packet_type, &payload_offset);
+	if(rohc_hdr_size < 0)
+	{
+		/* error while compressing, use the Uncompressed profile */
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "error while compressing with the profile, using "
+		             "uncompressed profile");
+
+		/* free context if it was just created, the context for the
+		 * Uncompressed profile may be created too */
+		if(c->num_sent_packets <= 1)
+		{
+			c_destroy_context(comp, c);
+		}
+
+		/* find the best context for the Uncompressed profile */
+		c = rohc_comp_find_ctxt(comp, ip_pkt, ROHC_PROFILE_UNCOMPRESSED,
+		                        uncomp_packet.time);
+		if(c == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to find a matching Uncompressed context or to "
+			             "create a new Uncompressed context");
+			goto error;
+		}
+
+		/* use the Uncompressed profile to compress the packet */
+		rohc_hdr_size =
+			c->profile->encode(c, ip_pkt, rohc_buf_data(*rohc_packet),
+			                   rohc_buf_avail_len(*rohc_packet),
+			                   &packet_type, &payload_offset);
+		if(rohc_hdr_size < 0)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "error while compressing with uncompressed profile, "
+			             "giving up");
+			goto error_free_new_context;
+		}
+	}
+	rohc_packet->len += rohc_hdr_size;
+	payload_size = ip_pkt->len - payload_offset;
+
+	/* is packet too large for output buffer? */
+	if((rohc_hdr_size + payload_size) > max_rohc_len)
+	{
+		uint32_t rru_crc;
 
 		/* resulting ROHC packet too large, segmentation may be a solution */
 		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -670,12 +1350,12 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		          "try to segment it (input size = %zd, maximum output "
 		          "size = %zd, required output size = %d + %zd = %zd, "
 		          "MRRU = %zd)", rohc_get_packet_descr(packet_type),
-		          uncomp_packet.len, max_rohc_buf_len, rohc_hdr_size,
+		          uncomp_packet.len, max_rohc_len, rohc_hdr_size,
 		          payload_size, rohc_hdr_size + payload_size, comp->mrru);
 
 		/* in order to be segmented, a ROHC packet shall be <= MRRU
 		 * (remember that MRRU includes the CRC length) */
-		if((payload_size + CRC_FCS32_LEN) > comp->mrru)
+		if((rohc_hdr_size + payload_size + CRC_FCS32_LEN) > comp->mrru)
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			             "%s ROHC packet cannot be segmented: too large (%d + "
@@ -689,6 +1369,17 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		          "%s ROHC packet can be segmented (MRRU = %zd)",
 		          rohc_get_packet_descr(packet_type), comp->mrru);
 
+		/* only one RRU may be stored in the compressor at a time */
+		if(!segment_allowed)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "%s ROHC packet cannot be segmented: the RRU is already "
+			             "used by another packet of the burst",
+			             rohc_get_packet_descr(packet_type));
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			goto error_free_new_context;
+		}
+
 		/* store the whole ROHC packet in compressor (headers and payload only,
 		 * not feedbacks, feedbacks will be transmitted with the first segment
 		 * when rohc_comp_get_segment2() is called) */
@@ -701,24 +1392,30 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 			             "support for ROHC segments in your application)",
 			             comp->rru_len);
 		}
-		comp->rru_len = 0;
 		comp->rru_off = 0;
 		/* ROHC header */
-		rohc_buf_push(rohc_packet, rohc_hdr_size);
-		memcpy(comp->rru + comp->rru_off, rohc_buf_data(*rohc_packet),
-		       rohc_hdr_size);
-		comp->rru_len += rohc_hdr_size;
-		/* ROHC payload */
-		memcpy(comp->rru + comp->rru_off + comp->rru_len,
-		       rohc_buf_data_at(uncomp_packet, payload_offset), payload_size);
-		comp->rru_len += payload_size;
+		memcpy(comp->rru, rohc_buf_data(*rohc_packet), rohc_hdr_size);
+		comp->rru_hdr_len = rohc_hdr_size;
+		/* ROHC payload: copied after the ROHC header, or referenced in the
+		 * uncompressed packet if the user does not want any copy */
+		if(payload == NULL)
+		{
+			memcpy(comp->rru + comp->rru_hdr_len,
+			       rohc_buf_data_at(uncomp_packet, payload_offset), payload_size);
+			comp->rru_payload = comp->rru + comp->rru_hdr_len;
+		}
+		else
+		{
+			comp->rru_payload = rohc_buf_data_at(uncomp_packet, payload_offset);
+		}
+		comp->rru_payload_len = payload_size;
 		/* compute FCS-32 CRC over header and payload (optional feedbacks and
 		   the CRC field itself are excluded) */
-		rru_crc = crc_calc_fcs32(comp->rru + comp->rru_off, comp->rru_len,
-		                         CRC_INIT_FCS32);
-		memcpy(comp->rru + comp->rru_off + comp->rru_len, &rru_crc,
-		       CRC_FCS32_LEN);
-		comp->rru_len += CRC_FCS32_LEN;
+		rru_crc = comp->crc_fcs32(comp->rru, comp->rru_hdr_len, CRC_INIT_FCS32);
+		rru_crc = comp->crc_fcs32(comp->rru_payload, comp->rru_payload_len,
+		                          rru_crc);
+		memcpy(comp->rru_crc, &rru_crc, CRC_FCS32_LEN);
+		comp->rru_len = comp->rru_hdr_len + comp->rru_payload_len + CRC_FCS32_LEN;
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "RRU 32-bit FCS CRC = 0x%08x", rohc_ntoh32(rru_crc));
 		/* computed RRU must be <= MRRU */
@@ -726,15 +1423,23 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 		/* reset the length of the ROHC packet: it shall be 0 for users */
 		rohc_packet->len = 0;
+		if(payload != NULL)
+		{
+			payload->data = NULL;
+			payload->len = 0;
+			payload->trailer_len = 0;
+		}
+		rohc_len = 0;
 
 		/* report to users that segmentation is possible */
 		status = ROHC_STATUS_SEGMENT;
 	}
-	else
+	else if(payload == NULL)
 	{
 		/* copy full payload after ROHC header */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "copy full %zd-byte payload", payload_size);
+		rohc_buf_pull(rohc_packet, rohc_hdr_size);
 		rohc_buf_append(rohc_packet,
 		                rohc_buf_data_at(uncomp_packet, payload_offset),
 		                payload_size);
@@ -745,6 +1450,22 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		           "ROHC size = %zd bytes (header = %d, payload = %zu), output "
 		           "buffer size = %zu", rohc_packet->len, rohc_hdr_size,
 		           payload_size, rohc_buf_avail_len(*rohc_packet));
+		rohc_len = rohc_packet->len;
+
+		/* report to user that compression was successful */
+		status = ROHC_STATUS_OK;
+	}
+	else
+	{
+		/* reference the payload in the uncompressed packet */
+		payload->data = rohc_buf_data_at(uncomp_packet, payload_offset);
+		payload->len = payload_size;
+		payload->trailer_len = 0;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "ROHC size = %zd bytes (header = %d, uncopied payload = "
+		           "%zu)", rohc_hdr_size + payload_size, rohc_hdr_size,
+		           payload_size);
+		rohc_len = rohc_hdr_size + payload_size;
 
 		/* report to user that compression was successful */
 		status = ROHC_STATUS_OK;
@@ -755,22 +1476,28 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	 *  - context statistics (global + last packet + last 16 packets) */
 	comp->num_packets++;
 	comp->total_uncompressed_size += uncomp_packet.len;
-	comp->total_compressed_size += rohc_packet->len;
+	comp->total_compressed_size += rohc_len;
 	comp->last_context = c;
 
 	c->packet_type = packet_type;
 
 	c->total_uncompressed_size += uncomp_packet.len;
-	c->total_compressed_size += rohc_packet->len;
+	c->total_compressed_size += rohc_len;
 	c->header_uncompressed_size += payload_offset;
 	c->header_compressed_size += rohc_hdr_size;
 	c->num_sent_packets++;
 
 	c->total_last_uncompressed_size = uncomp_packet.len;
-	c->total_last_compressed_size = rohc_packet->len;
+	c->total_last_compressed_size = rohc_len;
 	c->header_last_uncompressed_size = payload_offset;
 	c->header_last_compressed_size = rohc_hdr_size;
 
+	if(comp->detailed_stats != NULL)
+	{
+		rohc_comp_stats_add_pkt(comp, c, packet_type, start_time,
+		                        (size_t) rohc_hdr_size, payload_offset);
+	}
+
 	/* compression is successful */
 	return status;
 
@@ -778,13 +1505,10 @@ error_free_new_context:
 	/* free context if it was just created */
 	if(c->num_sent_packets <= 1)
 	{
-		c->profile->destroy(c);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		c_destroy_context(comp, c);
 	}
 error:
-	return ROHC_STATUS_ERROR;
+	return status;
 }
 
 
@@ -840,9 +1564,103 @@ error:
 rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
                                      struct rohc_buf *const segment)
 
+{
+	return __rohc_comp_get_segment(comp, 0, segment, NULL);
+}
+
+
+/**
+ * @brief Get the next ROHC segment if any, without copying its payload
+ *
+ * Get the next ROHC segment if any, as \ref rohc_comp_get_segment2 does, but
+ * write only the segment type and the part of the ROHC header that belongs
+ * to the segment in the output buffer \e segment. The part of the payload
+ * that belongs to the segment is not copied, \e payload points to it. The
+ * part of the FCS-32 CRC that belongs to the segment, if any, is stored in
+ * the trailer of \e payload.
+ *
+ * If the ROHC packet was built by \ref rohc_compress_sg, the payload points
+ * inside the uncompressed packet. If it was built by \ref rohc_compress4, the
+ * payload points inside the compressor and is valid until the next call to
+ * one of the compression functions.
+ *
+ * To get all the segments of one ROHC packet, call this function until
+ * \ref ROHC_STATUS_OK or \ref ROHC_STATUS_ERROR is returned.
+ *
+ * @param comp          The ROHC compressor
+ * @param max_len       The maximum length (in bytes) of the ROHC segment
+ * @param[out] segment  The buffer where to store the segment type and the
+ *                      ROHC header of the ROHC segment
+ * @param[out] payload  The payload and trailer of the ROHC segment
+ * @return              Possible return values:
+ *                       \li \ref ROHC_STATUS_SEGMENT if a ROHC segment is
+ *                           returned and more segments are available,
+ *                       \li \ref ROHC_STATUS_OK if a ROHC segment is returned
+ *                           and no more ROHC segment is available
+ *                       \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the output
+ *                           buffer is too small for the segment type and the
+ *                           ROHC header
+ *                       \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_sg
+ * @see rohc_comp_get_segment2
+ */
+rohc_status_t rohc_comp_get_segment_sg(struct rohc_comp *const comp,
+                                       const size_t max_len,
+                                       struct rohc_buf *const segment,
+                                       rohc_comp_payload_t *const payload)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(payload == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given payload is NULL");
+		goto error;
+	}
+
+	return __rohc_comp_get_segment(comp, max_len, segment, payload);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Get the next ROHC segment with or without payload copy
+ *
+ * The remaining bytes of the RRU are taken from 3 parts: the ROHC header
+ * stored in the compressor, the payload, and the FCS-32 CRC.
+ *
+ * @param comp          The ROHC compressor
+ * @param max_len       The maximum length of the ROHC segment if the payload
+ *                      is not copied, ignored otherwise (the whole segment
+ *                      shall then fit in \e segment)
+ * @param[out] segment  The segment type followed by the ROHC header, followed
+ *                      by the payload and CRC if they are copied
+ * @param[out] payload  NULL to copy payload and CRC in \e segment, the
+ *                      description of the uncopied payload and CRC otherwise
+ * @return              Possible return values, see
+ *                      \ref rohc_comp_get_segment_sg
+ */
+static rohc_status_t __rohc_comp_get_segment(struct rohc_comp *const comp,
+                                             const size_t max_len,
+                                             struct rohc_buf *const segment,
+                                             rohc_comp_payload_t *const payload)
 {
 	const size_t segment_type_len = 1; /* segment type byte */
+	size_t max_seg_len;
 	size_t max_data_len;
+	size_t hdr_off;
+	size_t hdr_len;
+	size_t payload_off;
+	size_t payload_len;
+	size_t crc_off;
+	size_t crc_len;
 	rohc_status_t status;
 
 	/* check input parameters */
@@ -880,8 +1698,19 @@ rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* the whole segment shall fit in the output buffer if the payload is
+	 * copied, the limit is given by the user otherwise */
+	if(payload == NULL)
+	{
+		max_seg_len = rohc_buf_avail_len(*segment);
+	}
+	else
+	{
+		max_seg_len = max_len;
+	}
+
 	/* abort is the given output buffer is too small for RRU */
-	if(rohc_buf_avail_len(*segment) <= segment_type_len)
+	if(max_seg_len <= segment_type_len)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "output buffer is too small for RRU, more than %zd bytes "
@@ -890,21 +1719,70 @@ rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
 	}
 
 	/* how many bytes of ROHC packet can we put in that new segment? */
-	max_data_len = rohc_min(rohc_buf_avail_len(*segment) - segment_type_len,
-	                        comp->rru_len);
+	max_data_len = rohc_min(max_seg_len - segment_type_len, comp->rru_len);
 	assert(max_data_len > 0);
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "copy %zd bytes of the remaining %zd bytes of ROHC packet and "
 	           "CRC in the segment", max_data_len, comp->rru_len);
 
-	/* set segment type with F bit set only for last segment */
+	/* split the bytes of the segment between ROHC header, payload and CRC */
+	hdr_off = comp->rru_off;
+	hdr_len = 0;
+	if(hdr_off < comp->rru_hdr_len)
+	{
+		hdr_len = rohc_min(comp->rru_hdr_len - hdr_off, max_data_len);
+	}
+	payload_off = 0;
+	payload_len = 0;
+	if((hdr_off + hdr_len) >= comp->rru_hdr_len)
+	{
+		payload_off = hdr_off + hdr_len - comp->rru_hdr_len;
+		if(payload_off < comp->rru_payload_len)
+		{
+			payload_len = rohc_min(comp->rru_payload_len - payload_off,
+			                       max_data_len - hdr_len);
+		}
+	}
+	crc_off = 0;
+	crc_len = max_data_len - hdr_len - payload_len;
+	if(crc_len > 0)
+	{
+		crc_off = payload_off + payload_len - comp->rru_payload_len;
+	}
+	assert((crc_off + crc_len) <= CRC_FCS32_LEN);
+
+	/* the segment type and the ROHC header are always copied */
+	if(rohc_buf_avail_len(*segment) < (segment_type_len + hdr_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "output buffer is too small for RRU, %zu bytes are "
+		             "required for segment type and ROHC header",
+		             segment_type_len + hdr_len);
+		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+		goto error_status;
+	}
+
+	/* set segment type with F bit set only for last segment */
 	rohc_buf_byte_at(*segment, 0) = 0xfe | (max_data_len == comp->rru_len);
 	segment->len++;
-	rohc_buf_pull(segment, 1);
 
 	/* copy remaining ROHC data (CRC included) */
-	rohc_buf_append(segment, comp->rru + comp->rru_off, max_data_len);
-	rohc_buf_pull(segment, max_data_len);
+	if(hdr_len > 0)
+	{
+		rohc_buf_append(segment, comp->rru + hdr_off, hdr_len);
+	}
+	if(payload == NULL)
+	{
+		rohc_buf_append(segment, comp->rru_payload + payload_off, payload_len);
+		rohc_buf_append(segment, comp->rru_crc + crc_off, crc_len);
+	}
+	else
+	{
+		payload->data = comp->rru_payload + payload_off;
+		payload->len = payload_len;
+		memcpy(payload->trailer, comp->rru_crc + crc_off, crc_len);
+		payload->trailer_len = crc_len;
+	}
 	comp->rru_off += max_data_len;
 	comp->rru_len -= max_data_len;
 
@@ -915,6 +1793,7 @@ rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
 		status = ROHC_STATUS_OK;
 		/* reset context for next RRU */
 		comp->rru_off = 0;
+		comp->rru_payload = NULL;
 	}
 	else
 	{
@@ -922,13 +1801,12 @@ rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
 		status = ROHC_STATUS_SEGMENT;
 	}
 
-	/* shift backward the RRU data, header and the feedback data */
-	rohc_buf_push(segment, max_data_len + 1);
-
 	return status;
 
 error:
-	return ROHC_STATUS_ERROR;
+	status = ROHC_STATUS_ERROR;
+error_status:
+	return status;
 }
 
 
@@ -974,14 +1852,15 @@ bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
 	          "force re-initialization for all %zu contexts",
 	          comp->num_contexts_used);
 
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	for(i = 0; i < comp->contexts_nr; i++)
 	{
 		if(comp->contexts[i].used)
 		{
 			if(!comp->contexts[i].profile->reinit_context(&(comp->contexts[i])))
 			{
 				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				             "failed to force re-initialization for CID %zu", i);
+				             "failed to force re-initialization for CID %zu",
+				             comp->contexts[i].cid);
 				goto error;
 			}
 		}
@@ -1007,6 +1886,10 @@ error:
  *
  * @warning The value can not be modified after library initialization
  *
+ * @warning The value can not be modified while the contexts are preallocated,
+ *          the width shall be set before \ref ROHC_COMP_FEATURE_CTXT_SLAB is
+ *          enabled
+ *
  * @param comp   The ROHC compressor
  * @param width  The width of the W-LSB sliding window
  * @return       true in case of success, false in case of failure
@@ -1046,6 +1929,17 @@ bool rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
 		return false;
 	}
 
+	/* refuse to set another value if the W-LSB windows of the contexts were
+	 * preallocated with the current width */
+	if((comp->features & ROHC_COMP_FEATURE_CTXT_SLAB) != 0 &&
+	   width != comp->wlsb_window_width)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		             "modify the W-LSB window width while contexts are "
+		             "preallocated");
+		return false;
+	}
+
 	comp->wlsb_window_width = width;
 
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -1175,10 +2069,16 @@ bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
  * Set or replace the callback function that the ROHC library will call to
  * detect RTP streams among other UDP streams.
  *
- * The function is called once per UDP packet to compress, with the IP and
- * UDP headers and the UDP payload. If the callback function returns true, the
- * RTP profile is used for compression, otherwise the IP/UDP profile is used
- * instead.
+ * The function is called once per UDP flow to compress, with the IP and
+ * UDP headers and the UDP payload of the first packet of the flow. If the
+ * callback function returns true, the RTP profile is used for compression,
+ * otherwise the IP/UDP profile is used instead. The result is remembered for
+ * the flow, so the function is called again only once the flow remained
+ * idle for a while or if the flow was evicted from the cache by another
+ * flow.
+ *
+ * The callback takes precedence over the built-in RTP heuristic enabled by
+ * \ref rohc_comp_set_rtp_detection_heuristic.
  *
  * Special value NULL may be used to disable the detection of RTP streams with
  * the callback method. The detection will then be based on a list of UDP
@@ -1231,6 +2131,66 @@ bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
 	comp->rtp_callback = callback;
 	comp->rtp_private = rtp_private;
 
+	/* the flows previously classified as non-RTP might be RTP now */
+	c_reset_rtp_flows(comp);
+	c_build_profiles_dispatch(comp);
+
+	return true;
+}
+
+
+/**
+ * @brief Enable or disable the built-in RTP heuristic
+ *
+ * Enable or disable the heuristic that the ROHC library uses to detect RTP
+ * streams among other UDP streams when no RTP detection callback is set
+ * with \ref rohc_comp_set_rtp_detection_cb.
+ *
+ * A UDP flow is detected as a RTP stream once the given number of
+ * consecutive packets of the flow look like RTP packets: RTP version 2,
+ * no RTCP payload type, same SSRC, increasing SN and non-decreasing TS. The
+ * packets of the flow are compressed with the IP/UDP profile until the RTP
+ * stream is detected.
+ *
+ * The RTP heuristic is disabled by default.
+ *
+ * @param comp        The ROHC compressor
+ * @param packets_nr  The number of consecutive RTP-like packets required to
+ *                    detect a RTP stream, 0 to disable the heuristic
+ * @return            true if the heuristic was successfully configured,
+ *                    false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_rtp_detection_cb
+ */
+bool rohc_comp_set_rtp_detection_heuristic(struct rohc_comp *const comp,
+                                           const size_t packets_nr)
+{
+	/* sanity check on compressor */
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->rtp_heuristic_pkts_nr = packets_nr;
+
+	/* forget the RTP detection results obtained with the previous settings */
+	c_reset_rtp_flows(comp);
+	c_build_profiles_dispatch(comp);
+
+	if(packets_nr == 0)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "RTP heuristic disabled");
+	}
+	else
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "RTP heuristic enabled: detect RTP streams after %zu "
+		          "RTP-like packets", packets_nr);
+	}
+
 	return true;
 }
 
@@ -1351,6 +2311,7 @@ bool rohc_comp_enable_profile(struct rohc_comp *const comp,
 
 	/* mark the profile as enabled */
 	comp->enabled_profiles[i] = true;
+	c_build_profiles_dispatch(comp);
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	          "ROHC compression profile (ID = %d) enabled", profile);
 
@@ -1413,6 +2374,7 @@ bool rohc_comp_disable_profile(struct rohc_comp *const comp,
 
 	/* mark the profile as disabled */
 	comp->enabled_profiles[i] = false;
+	c_build_profiles_dispatch(comp);
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	          "ROHC compression profile (ID = %d) disabled", profile);
 
@@ -1565,6 +2527,10 @@ error:
  * If set to 0, segmentation is disabled as no segment headers are allowed
  * on the channel. No segment will be generated.
  *
+ * The memory required to store one MRRU is allocated only when segmentation
+ * is enabled. The MRRU cannot be changed while a ROHC packet is still
+ * waiting to be retrieved as segments.
+ *
  * If segmentation is enabled and used by the compressor, the function
  * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
  *
@@ -1608,6 +2574,47 @@ bool rohc_comp_set_mrru(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* ROHC segments carry no CID, so the decompressor cannot reassemble the
+	 * segments of several shards of a pool that share the same channel */
+	if(mrru > 0 && comp->contexts_nr != (comp->medium.max_cid + 1))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "segmentation cannot be enabled on one shard of a pool "
+		             "of compressors");
+		goto error;
+	}
+
+	/* the RRU buffer is sized for the MRRU, so it cannot be resized while
+	 * it still holds segments not retrieved yet */
+	if(mrru != comp->mrru && comp->rru_len != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to change MRRU: %zu bytes of the current RRU "
+		             "were not retrieved yet with rohc_comp_get_segment2()",
+		             comp->rru_len);
+		goto error;
+	}
+
+	/* allocate the RRU buffer only when segmentation is enabled */
+	if(mrru != comp->mrru)
+	{
+		uint8_t *rru = NULL;
+
+		if(mrru > 0)
+		{
+			rru = malloc(mrru);
+			if(rru == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to allocate memory for the %zu-byte RRU",
+				             mrru);
+				goto error;
+			}
+		}
+		free(comp->rru);
+		comp->rru = rru;
+	}
+
 	/* set new MRRU */
 	comp->mrru = mrru;
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -1746,6 +2753,15 @@ error:
  *
  * @warning Changing the feature set while library is used is not supported
  *
+ * The \ref ROHC_COMP_FEATURE_CTXT_SLAB feature preallocates the memory of
+ * all contexts, it shall be changed right after the compressor creation:
+ * the call fails if contexts are in use.
+ *
+ * The \ref ROHC_COMP_FEATURE_STATS feature allocates the memory for the
+ * detailed statistics of the compressor and of all its contexts. The
+ * statistics start from zero every time the feature is enabled. They are
+ * released when the feature is disabled.
+ *
  * @param comp      The ROHC compressor
  * @param features  The feature set to enable/disable
  * @return          true if the feature set was successfully enabled/disabled,
@@ -1760,7 +2776,11 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 {
 	const rohc_comp_features_t all_features =
 		ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
-		ROHC_COMP_FEATURE_DUMP_PACKETS;
+		ROHC_COMP_FEATURE_DUMP_PACKETS |
+		ROHC_COMP_FEATURE_CTXT_SLAB |
+		ROHC_COMP_FEATURE_STATS |
+		ROHC_COMP_FEATURE_NO_STEADY_PATH;
+	union rohc_stats_padded *detailed_stats;
 
 	/* compressor must be valid */
 	if(comp == NULL)
@@ -1778,11 +2798,64 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* memory for detailed statistics is allocated when they are enabled: one
+	 * item for the whole compressor, then one item per context */
+	detailed_stats = comp->detailed_stats;
+	if((features & ROHC_COMP_FEATURE_STATS) != 0 && detailed_stats == NULL)
+	{
+		detailed_stats = calloc(1 + comp->contexts_nr,
+		                        sizeof(union rohc_stats_padded));
+		if(detailed_stats == NULL)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "failed to allocate memory for detailed statistics");
+			goto error;
+		}
+	}
+
+	/* context memory may be preallocated or released only while no context
+	 * is in use */
+	if((features & ROHC_COMP_FEATURE_CTXT_SLAB) !=
+	   (comp->features & ROHC_COMP_FEATURE_CTXT_SLAB))
+	{
+		if(comp->num_contexts_used > 0)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot change preallocation of contexts while %zu "
+			             "contexts are in use", comp->num_contexts_used);
+			goto free_stats;
+		}
+		if((features & ROHC_COMP_FEATURE_CTXT_SLAB) != 0)
+		{
+			if(!c_prealloc_contexts(comp))
+			{
+				goto free_stats;
+			}
+		}
+		else
+		{
+			rohc_slab_reset(&comp->ctxt_slab);
+		}
+	}
+
+	/* release detailed statistics when they are disabled */
+	if((features & ROHC_COMP_FEATURE_STATS) == 0 && detailed_stats != NULL)
+	{
+		free(detailed_stats);
+		detailed_stats = NULL;
+	}
+
 	/* record new feature set */
+	comp->detailed_stats = detailed_stats;
 	comp->features = features;
 
 	return true;
 
+free_stats:
+	if(detailed_stats != comp->detailed_stats)
+	{
+		free(detailed_stats);
+	}
 error:
 	return false;
 }
@@ -1875,6 +2948,54 @@ error:
 }
 
 
+/**
+ * @brief Take into account all the feedback items queued by another thread
+ *
+ * The feedback items are delivered in the order they were queued. The slots
+ * are given back to the producer all at once, after the last item.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void rohc_comp_drain_feedback(struct rohc_comp *const comp)
+{
+	struct rohc_comp_feedback_queue *const queue = &comp->feedback_queue;
+	size_t tail;
+
+	if(queue->slots == NULL)
+	{
+		return;
+	}
+
+	/* read the index of the producer only if its previous copy tells that
+	 * the ring is empty */
+	tail = queue->tail;
+	if(tail == queue->head_cache)
+	{
+		queue->head_cache = rohc_comp_load_acquire(&queue->head);
+		if(tail == queue->head_cache)
+		{
+			return;
+		}
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "deliver %zu queued feedback item(s)", queue->head_cache - tail);
+	while(tail != queue->head_cache)
+	{
+		const struct rohc_comp_feedback_slot *const slot =
+			&queue->slots[tail & queue->mask];
+
+		if(!__rohc_comp_deliver_feedback(comp, slot->data, slot->len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver one queued feedback item");
+		}
+		tail++;
+	}
+	rohc_comp_store_release(&queue->tail, tail);
+}
+
+
 /**
  * @brief Deliver a feedback packet to the compressor
  *
@@ -1975,6 +3096,203 @@ error:
 }
 
 
+/**
+ * @brief Set the size of the queue of feedback items
+ *
+ * The queue lets one thread deliver the feedback received for the compressor
+ * with \ref rohc_comp_queue_feedback while another thread compresses packets.
+ * The queued feedback items are taken into account by the compressor at the
+ * beginning of the next call to \ref rohc_compress4, \ref rohc_compress_sg
+ * or \ref rohc_compress_burst, all the queued items at once.
+ *
+ * The queue is disabled by default. It shall be configured before the
+ * thread that queues the feedback items is started, and it cannot be resized
+ * while some feedback items are still queued.
+ *
+ * @param comp      The ROHC compressor
+ * @param slots_nr  The number of feedback items the queue may hold, a power
+ *                  of 2 in range [1, 4096], or 0 to disable the queue
+ * @return          true if the queue was successfully configured,
+ *                  false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_feedback
+ */
+bool rohc_comp_set_feedback_queue(struct rohc_comp *const comp,
+                                  const size_t slots_nr)
+{
+	struct rohc_comp_feedback_queue *queue;
+	struct rohc_comp_feedback_slot *slots = NULL;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	queue = &comp->feedback_queue;
+
+	/* the number of slots shall be a power of 2 for the ring */
+	if(slots_nr > ROHC_COMP_FEEDBACK_QUEUE_MAX ||
+	   (slots_nr & (slots_nr - 1)) != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unexpected number of slots %zu for the feedback queue: "
+		             "must be a power of 2 in range [1, %u], or 0", slots_nr,
+		             ROHC_COMP_FEEDBACK_QUEUE_MAX);
+		goto error;
+	}
+
+	/* the queued items would be lost */
+	if(queue->head != rohc_comp_load_acquire(&queue->tail))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to resize the feedback queue: %zu feedback items "
+		             "are still queued", queue->head - queue->tail);
+		goto error;
+	}
+
+	if(slots_nr > 0)
+	{
+		slots = malloc(slots_nr * sizeof(struct rohc_comp_feedback_slot));
+		if(slots == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to allocate memory for the %zu-slot feedback "
+			             "queue", slots_nr);
+			goto error;
+		}
+	}
+	free(queue->slots);
+	queue->slots = slots;
+	queue->mask = (slots_nr > 0 ? slots_nr - 1 : 0);
+	queue->head = 0;
+	queue->tail_cache = 0;
+	queue->tail = 0;
+	queue->head_cache = 0;
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "feedback queue is now %zu-slot long", slots_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Queue feedback for the compressor from another thread
+ *
+ * The function does the same as \ref rohc_comp_deliver_feedback2, but it
+ * may be called from another thread than the one that compresses packets:
+ * the feedback items are copied in the queue of the compressor and they are
+ * taken into account at the beginning of the next compression. The function
+ * never blocks: if the queue is too full for all the feedback items, none of
+ * them is queued.
+ *
+ * The queue shall be enabled with \ref rohc_comp_set_feedback_queue first.
+ * One single thread shall queue feedback for the compressor. The function
+ * prints no trace, so that the callback for traces is only called from the
+ * thread that compresses packets.
+ *
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data
+ * @return          true if all the feedback items were queued,
+ *                  false if the feedback is malformed, if the queue is
+ *                  disabled, or if the queue is full
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_feedback_queue
+ * @see rohc_comp_deliver_feedback2
+ */
+bool rohc_comp_queue_feedback(struct rohc_comp *const comp,
+                              const struct rohc_buf feedback)
+{
+	struct rohc_comp_feedback_queue *queue;
+	struct rohc_buf remain_data = feedback;
+	size_t items_nr = 0;
+	size_t head;
+
+	if(comp == NULL || rohc_buf_is_malformed(feedback))
+	{
+		goto error;
+	}
+	queue = &comp->feedback_queue;
+	if(queue->slots == NULL)
+	{
+		goto error;
+	}
+
+	/* count the feedback items and check that they are well-formed */
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len) ||
+		   (feedback_hdr_len + feedback_data_len) > remain_data.len)
+		{
+			goto error;
+		}
+		assert(feedback_data_len <= ROHC_COMP_FEEDBACK_DATA_MAX);
+		rohc_buf_pull(&remain_data, feedback_hdr_len + feedback_data_len);
+		items_nr++;
+	}
+	if(items_nr == 0)
+	{
+		goto ignore;
+	}
+
+	/* is there enough room in the ring for all the items? read the index of
+	 * the consumer only if its previous copy tells that there is not */
+	head = queue->head;
+	if((head - queue->tail_cache + items_nr) > (queue->mask + 1))
+	{
+		queue->tail_cache = rohc_comp_load_acquire(&queue->tail);
+		if((head - queue->tail_cache + items_nr) > (queue->mask + 1))
+		{
+			goto error;
+		}
+	}
+
+	/* copy the feedback data without the feedback headers in the ring */
+	remain_data = feedback;
+	while(items_nr > 0)
+	{
+		struct rohc_comp_feedback_slot *const slot =
+			&queue->slots[head & queue->mask];
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+
+		/* feedback items were checked above, parsing cannot fail */
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len))
+		{
+			assert(0);
+			goto error;
+		}
+		rohc_buf_pull(&remain_data, feedback_hdr_len);
+		memcpy(slot->data, rohc_buf_data(remain_data), feedback_data_len);
+		slot->len = feedback_data_len;
+		rohc_buf_pull(&remain_data, feedback_data_len);
+		head++;
+		items_nr--;
+	}
+
+	/* publish all the items at once */
+	rohc_comp_store_release(&queue->head, head);
+
+ignore:
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get some information about the last compressed packet
  *
@@ -2067,6 +3385,7 @@ error:
  * \ref rohc_comp_general_info_t structure with the \e version_major and
  * \e version_minor fields set to one of the following supported versions:
  *  - Major 0, minor 0
+ *  - Major 0, minor 1
  *
  * See the \ref rohc_comp_general_info_t structure for details about fields
  * that are supported in the above versions.
@@ -2104,12 +3423,21 @@ bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
 		info->comp_bytes_nr = comp->total_compressed_size;
 
 		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		switch(info->version_minor)
 		{
-			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "general information", info->version_minor);
-			goto error;
+			case 0:
+				/* nothing to add */
+				break;
+			case 1:
+				/* new fields in 0.1 */
+				info->ctxts_mem_reserved = comp->ctxt_slab.reserved_bytes;
+				info->ctxts_mem_peak = comp->ctxt_slab.peak_bytes;
+				break;
+			default:
+				rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "unsupported minor version (%u) of the structure for "
+				           "general information", info->version_minor);
+				goto error;
 		}
 	}
 	else
@@ -2159,13 +3487,605 @@ const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
 }
 
 
-/*
- * Definitions of private functions
- */
-
-
 /**
- * @brief Find out a ROHC profile given a profile ID
+ * @brief Get a snapshot of the detailed statistics of the whole compressor
+ *
+ * Copy the detailed statistics of the compressor in the given flat structure,
+ * eg. to export them to a monitoring system. The detailed statistics are
+ * kept only if the \ref ROHC_COMP_FEATURE_STATS feature is enabled.
+ *
+ * @param comp           The ROHC compressor to get statistics from
+ * @param[in,out] stats  The structure where to store the statistics, its
+ *                       \e version_major and \e version_minor fields shall
+ *                       be set by the caller
+ * @return               true if the statistics were successfully copied,
+ *                       false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_stats_snapshot_t
+ * @see rohc_comp_get_ctxt_stats_snapshot
+ */
+bool rohc_comp_get_stats_snapshot(const struct rohc_comp *const comp,
+                                  rohc_comp_stats_snapshot_t *const stats)
+{
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for detailed statistics is not valid");
+		goto error;
+	}
+
+	if(comp->detailed_stats == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "detailed statistics are not enabled, see feature "
+		             "ROHC_COMP_FEATURE_STATS");
+		goto error;
+	}
+
+	if(!rohc_comp_stats_export(comp, &comp->detailed_stats[0].counters, stats))
+	{
+		goto error;
+	}
+	stats->profile_id = ROHC_PROFILE_GENERAL;
+
+	/* find out which contexts are stuck in the lower states */
+	for(i = 0; i < comp->contexts_nr; i++)
+	{
+		if(comp->contexts[i].used)
+		{
+			assert(comp->contexts[i].state < ROHC_STATS_STATES_NR);
+			stats->contexts_per_state[comp->contexts[i].state]++;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get a snapshot of the detailed statistics of one context
+ *
+ * Copy the detailed statistics of the given compression context in the given
+ * flat structure, eg. to export them to a monitoring system. The detailed
+ * statistics are kept only if the \ref ROHC_COMP_FEATURE_STATS feature is
+ * enabled.
+ *
+ * The statistics of an unused context are the ones of the last flow that
+ * used the context.
+ *
+ * @param comp           The ROHC compressor to get statistics from
+ * @param cid            The CID of the context to get statistics for
+ * @param[in,out] stats  The structure where to store the statistics, its
+ *                       \e version_major and \e version_minor fields shall
+ *                       be set by the caller
+ * @return               true if the statistics were successfully copied,
+ *                       false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_stats_snapshot_t
+ * @see rohc_comp_get_stats_snapshot
+ */
+bool rohc_comp_get_ctxt_stats_snapshot(const struct rohc_comp *const comp,
+                                       const rohc_cid_t cid,
+                                       rohc_comp_stats_snapshot_t *const stats)
+{
+	const struct rohc_comp_ctxt *context;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for detailed statistics is not valid");
+		goto error;
+	}
+
+	if(comp->detailed_stats == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "detailed statistics are not enabled, see feature "
+		             "ROHC_COMP_FEATURE_STATS");
+		goto error;
+	}
+
+	if(cid < comp->first_cid || (cid - comp->first_cid) >= comp->contexts_nr)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "CID %zu is not handled by the compressor", cid);
+		goto error;
+	}
+	context = &comp->contexts[cid - comp->first_cid];
+
+	if(!rohc_comp_stats_export(comp, rohc_comp_get_ctxt_stats(comp, context),
+	                           stats))
+	{
+		goto error;
+	}
+	if(context->used)
+	{
+		assert(context->state < ROHC_STATS_STATES_NR);
+		stats->profile_id = context->profile->id;
+		stats->contexts_per_state[context->state] = 1;
+	}
+	else
+	{
+		stats->profile_id = ROHC_PROFILE_GENERAL;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Export the contexts of the ROHC compressor in a snapshot
+ *
+ * Write a binary snapshot of the contexts of the compressor at the end of
+ * the given buffer. Another compressor may import the snapshot with
+ * \ref rohc_comp_import_contexts to go on compressing the same flows without
+ * going back to the IR state, eg. after a restart of the application. The
+ * snapshot format is versioned and does not depend on the platform.
+ *
+ * The contexts of the IP-only, UDP, UDP-Lite, ESP, RTP and TCP profiles are
+ * exported, provided that they compressed at least one packet. The contexts
+ * of IPv6 flows are exported with their IPv6 extension headers and the
+ * tables of list compression. The other contexts are not exported: the
+ * compressor that imports the snapshot will create them again as usual.
+ *
+ * @param comp               The ROHC compressor
+ * @param[in,out] snapshot   The buffer where to append the snapshot
+ * @return                   \ref ROHC_STATUS_OK if the snapshot was
+ *                           successfully written,
+ *                           \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the buffer
+ *                           is too small for the snapshot (the buffer is
+ *                           left unchanged),
+ *                           \ref ROHC_STATUS_ERROR if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_import_contexts
+ */
+rohc_status_t rohc_comp_export_contexts(const struct rohc_comp *const comp,
+                                        struct rohc_buf *const snapshot)
+{
+	size_t initial_len;
+	size_t ctxts_nr;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(snapshot == NULL || rohc_buf_is_malformed(*snapshot))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given snapshot buffer is not valid");
+		goto error;
+	}
+	initial_len = snapshot->len;
+
+	/* the snapshot header, the number of contexts is written at the end */
+	if(!rohc_snapshot_put(snapshot, ROHC_SNAPSHOT_MAGIC,
+	                      ROHC_SNAPSHOT_MAGIC_LEN) ||
+	   !rohc_snapshot_put8(snapshot, ROHC_SNAPSHOT_VERSION) ||
+	   !rohc_snapshot_put8(snapshot, ROHC_SNAPSHOT_KIND_COMP) ||
+	   !rohc_snapshot_put8(snapshot, comp->medium.cid_type) ||
+	   !rohc_snapshot_put16(snapshot, comp->medium.max_cid) ||
+	   !rohc_snapshot_put16(snapshot, 0))
+	{
+		goto too_small;
+	}
+
+	/* one record for every context that may be exported */
+	ctxts_nr = 0;
+	for(i = 0; i < comp->contexts_nr; i++)
+	{
+		const struct rohc_comp_ctxt *const context = &comp->contexts[i];
+		const size_t record_start = snapshot->len;
+		rohc_status_t status;
+		size_t record_len;
+
+		if(!context->used)
+		{
+			continue;
+		}
+		if(context->profile->export_ctxt == NULL)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+			           "context with CID %zu not exported: profile does not "
+			           "support snapshots", context->cid);
+			continue;
+		}
+
+		/* the record header then the generic part of the context */
+		if(!rohc_snapshot_put16(snapshot, context->cid) ||
+		   !rohc_snapshot_put16(snapshot, context->profile->id) ||
+		   !rohc_snapshot_put16(snapshot, 0) ||
+		   !rohc_snapshot_put8(snapshot, context->mode) ||
+		   !rohc_snapshot_put8(snapshot, context->state) ||
+		   !rohc_snapshot_put64(snapshot, context->first_used) ||
+		   !rohc_snapshot_put64(snapshot, context->latest_used) ||
+		   !rohc_snapshot_put32(snapshot, context->ir_count) ||
+		   !rohc_snapshot_put32(snapshot, context->fo_count) ||
+		   !rohc_snapshot_put32(snapshot, context->so_count) ||
+		   !rohc_snapshot_put32(snapshot, context->go_back_fo_count) ||
+		   !rohc_snapshot_put32(snapshot, context->go_back_ir_count) ||
+		   !rohc_snapshot_put32(snapshot, context->num_sent_packets))
+		{
+			goto too_small;
+		}
+
+		/* the profile-specific part of the context */
+		status = context->profile->export_ctxt(context, snapshot);
+		if(status == ROHC_STATUS_OUTPUT_TOO_SMALL)
+		{
+			goto too_small;
+		}
+		record_len = snapshot->len - record_start - ROHC_SNAPSHOT_CTXT_HDR_LEN;
+		if(status != ROHC_STATUS_OK || record_len > 0xffff)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+			           "context with CID %zu not exported: profile cannot "
+			           "export it", context->cid);
+			snapshot->len = record_start;
+			continue;
+		}
+		rohc_snapshot_set16(*snapshot, record_start + 4, record_len);
+		ctxts_nr++;
+	}
+	rohc_snapshot_set16(*snapshot, initial_len + ROHC_SNAPSHOT_HDR_CTXTS_NR_OFFSET,
+	                    ctxts_nr);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts exported in a %zu-byte snapshot", ctxts_nr,
+	          snapshot->len - initial_len);
+
+	return ROHC_STATUS_OK;
+
+too_small:
+	rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	             "snapshot buffer is too small for the contexts");
+	snapshot->len = initial_len;
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Import the contexts of a ROHC compressor from a snapshot
+ *
+ * Create the contexts recorded in a snapshot written by
+ * \ref rohc_comp_export_contexts. The compressor shall use no context yet,
+ * and it shall be configured as the compressor that wrote the snapshot
+ * (CID type, enabled profiles, RTP detection...). The contexts are restored
+ * with their state, so their next packets are compressed as if the
+ * compressor had never stopped.
+ *
+ * The records of contexts with disabled or unknown profiles are skipped, as
+ * well as the records of contexts with CIDs that the compressor does not
+ * handle. If the snapshot is malformed, no context is imported at all.
+ *
+ * @param comp      The ROHC compressor
+ * @param snapshot  The snapshot to import contexts from
+ * @return          true if the snapshot was successfully imported,
+ *                  false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_export_contexts
+ */
+bool rohc_comp_import_contexts(struct rohc_comp *const comp,
+                               const struct rohc_buf snapshot)
+{
+	struct rohc_buf remain = snapshot;
+	uint8_t magic[ROHC_SNAPSHOT_MAGIC_LEN];
+	uint8_t version;
+	uint8_t kind;
+	uint8_t cid_type;
+	uint16_t max_cid;
+	uint16_t ctxts_nr;
+	size_t imported_nr;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(rohc_buf_is_malformed(snapshot))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given snapshot is malformed");
+		goto error;
+	}
+	if(comp->num_contexts_used > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot import contexts in a compressor that already "
+		             "uses %zu contexts", comp->num_contexts_used);
+		goto error;
+	}
+
+	/* the snapshot header */
+	if(!rohc_snapshot_get(&remain, magic, ROHC_SNAPSHOT_MAGIC_LEN) ||
+	   !rohc_snapshot_get8(&remain, &version) ||
+	   !rohc_snapshot_get8(&remain, &kind) ||
+	   !rohc_snapshot_get8(&remain, &cid_type) ||
+	   !rohc_snapshot_get16(&remain, &max_cid) ||
+	   !rohc_snapshot_get16(&remain, &ctxts_nr))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "snapshot is too short for its header");
+		goto error;
+	}
+	if(memcmp(magic, ROHC_SNAPSHOT_MAGIC, ROHC_SNAPSHOT_MAGIC_LEN) != 0 ||
+	   kind != ROHC_SNAPSHOT_KIND_COMP)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "data is not a snapshot of compression contexts");
+		goto error;
+	}
+	if(version != ROHC_SNAPSHOT_VERSION)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unsupported version %u of snapshot", version);
+		goto error;
+	}
+	if(cid_type != comp->medium.cid_type)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "snapshot was written by a compressor with another CID "
+		             "type");
+		goto error;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "snapshot with %u contexts (MAX_CID = %u)", ctxts_nr, max_cid);
+
+	/* the records of contexts */
+	imported_nr = 0;
+	for(i = 0; i < ctxts_nr; i++)
+	{
+		const struct rohc_comp_profile *profile;
+		struct rohc_comp_ctxt *context;
+		const struct rohc_ts unknown_time = { .sec = 0, .nsec = 0 };
+		struct rohc_buf record;
+		struct rohc_buf ref_hdrs;
+		struct net_pkt ref_pkt;
+		uint16_t cid;
+		uint16_t profile_id;
+		uint16_t record_len;
+		uint16_t ref_hdrs_len;
+		uint8_t mode;
+		uint8_t state;
+		uint64_t first_used;
+		uint64_t latest_used;
+		uint32_t counts[6];
+		size_t j;
+
+		if(!rohc_snapshot_get16(&remain, &cid) ||
+		   !rohc_snapshot_get16(&remain, &profile_id) ||
+		   !rohc_snapshot_get16(&remain, &record_len) ||
+		   remain.len < record_len)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "snapshot is too short for context #%zu", i + 1);
+			goto destroy_contexts;
+		}
+		record = remain;
+		record.len = record_len;
+		rohc_buf_pull(&remain, record_len);
+
+		/* skip the contexts that the compressor cannot handle */
+		if(cid < comp->first_cid || (cid - comp->first_cid) >= comp->contexts_nr)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "context with CID %u not imported: CID is not handled "
+			             "by the compressor", cid);
+			continue;
+		}
+		profile = rohc_get_profile_from_id(comp, profile_id);
+		if(profile == NULL || profile->import_ctxt == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "context with CID %u not imported: profile 0x%04x is "
+			             "not enabled or does not support snapshots", cid,
+			             profile_id);
+			continue;
+		}
+		if(comp->contexts[cid - comp->first_cid].used)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "snapshot contains context with CID %u twice", cid);
+			goto destroy_contexts;
+		}
+
+		/* the generic part of the context */
+		if(!rohc_snapshot_get8(&record, &mode) ||
+		   !rohc_snapshot_get8(&record, &state) ||
+		   !rohc_snapshot_get64(&record, &first_used) ||
+		   !rohc_snapshot_get64(&record, &latest_used))
+		{
+			goto malformed_record;
+		}
+		for(j = 0; j < 6; j++)
+		{
+			if(!rohc_snapshot_get32(&record, &counts[j]))
+			{
+				goto malformed_record;
+			}
+		}
+		if(mode < ROHC_U_MODE || mode > ROHC_R_MODE ||
+		   state < ROHC_COMP_STATE_IR || state > ROHC_COMP_STATE_SO)
+		{
+			goto malformed_record;
+		}
+
+		/* the reference headers to create the context from */
+		if(!rohc_snapshot_get16(&record, &ref_hdrs_len) ||
+		   record.len < ref_hdrs_len)
+		{
+			goto malformed_record;
+		}
+		ref_hdrs = record;
+		ref_hdrs.len = ref_hdrs_len;
+		rohc_buf_pull(&record, ref_hdrs_len);
+		if(!net_pkt_parse(&ref_pkt, ref_hdrs, comp->trace_callback,
+		                  comp->trace_callback_priv, comp->trace_min_level,
+		                  ROHC_TRACE_COMP))
+		{
+			goto malformed_record;
+		}
+
+		/* the reference headers shall match the profile of the record: the
+		 * UDP flow of a RTP record was already detected as a RTP stream, so
+		 * the RTP detection shall not run again on it */
+		if(profile->id == ROHC_PROFILE_RTP &&
+		   !c_rtp_restore_flow(comp, &ref_pkt))
+		{
+			goto malformed_record;
+		}
+		if(!profile->check_profile(comp, &ref_pkt))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "reference headers of context with CID %u do not "
+			             "match profile 0x%04x", cid, profile_id);
+			goto malformed_record;
+		}
+
+		/* create the context with the CID of the record: put the CID on top
+		 * of the stack of free CIDs */
+		for(j = 0; comp->free_cids[j] != cid; j++)
+		{
+			assert(j < comp->free_cids_nr);
+		}
+		comp->free_cids[j] = comp->free_cids[comp->free_cids_nr - 1];
+		comp->free_cids[comp->free_cids_nr - 1] = cid;
+		context = c_create_context(comp, profile, &ref_pkt, unknown_time);
+		if(context == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create context with CID %u", cid);
+			goto destroy_contexts;
+		}
+		assert(context->cid == cid);
+
+		/* restore the state of the context */
+		context->mode = mode;
+		context->state = state;
+		context->first_used = first_used;
+		context->latest_used = latest_used;
+		context->ir_count = counts[0];
+		context->fo_count = counts[1];
+		context->so_count = counts[2];
+		context->go_back_fo_count = counts[3];
+		context->go_back_ir_count = counts[4];
+		context->num_sent_packets = counts[5];
+		if(!profile->import_ctxt(context, &record) || record.len != 0)
+		{
+			c_destroy_context(comp, context);
+			goto malformed_record;
+		}
+		imported_nr++;
+	}
+	if(remain.len != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "%zu unexpected bytes at the end of snapshot", remain.len);
+		goto destroy_contexts;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts imported from snapshot", imported_nr);
+
+	return true;
+
+malformed_record:
+	rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	             "malformed record for context #%zu in snapshot", i + 1);
+destroy_contexts:
+	for(i = 0; i < comp->contexts_nr; i++)
+	{
+		if(comp->contexts[i].used)
+		{
+			c_destroy_context(comp, &comp->contexts[i]);
+		}
+	}
+error:
+	return false;
+}
+
+
+/*
+ * Definitions of private functions
+ */
+
+
+/**
+ * @brief Allocate the memory of a ROHC compressor
+ *
+ * The compressor is aligned on a cache line, as the queue of feedback items
+ * within it requires.
+ *
+ * @return  The uninitialized compressor, NULL if memory is missing
+ */
+static struct rohc_comp * c_alloc_comp(void)
+{
+	struct rohc_comp *comp;
+
+#if defined(__KERNEL__)
+	/* kmalloc() aligns objects as large as the compressor on their size */
+	comp = malloc(sizeof(struct rohc_comp));
+#elif defined(_WIN32)
+	comp = _aligned_malloc(sizeof(struct rohc_comp), ROHC_COMP_CACHE_LINE_LEN);
+#else
+	if(posix_memalign((void **) &comp, ROHC_COMP_CACHE_LINE_LEN,
+	                  sizeof(struct rohc_comp)) != 0)
+	{
+		comp = NULL;
+	}
+#endif
+
+	return comp;
+}
+
+
+/**
+ * @brief Free the memory of a ROHC compressor allocated by \ref c_alloc_comp
+ *
+ * @param comp  The compressor to free
+ */
+static void c_free_comp(struct rohc_comp *const comp)
+{
+#if defined(_WIN32) && !defined(__KERNEL__)
+	_aligned_free(comp);
+#else
+	free(comp);
+#endif
+}
+
+
+/**
+ * @brief Find out a ROHC profile given a profile ID
  *
  * @param comp       The ROHC compressor
  * @param profile_id The ID of the ROHC profile to find out
@@ -2194,30 +4114,84 @@ static const struct rohc_comp_profile *
 /**
  * @brief Find out a ROHC profile given an IP protocol ID
  *
+ * The profile chosen for the flow of the packet is tried first if the flow
+ * is in the cache of profiles. Otherwise, only the profiles that may accept
+ * the type of packet are tried, in the order of priority.
+ *
+ * The chosen profile is cached for the flow only if no profile but the RTP
+ * one rejected the packet: the flows that the RTP profile does not recognize
+ * are then compressed with their profile without consulting the RTP profile
+ * again, while the packets that other profiles reject for temporary reasons
+ * (IP fragments, bad checksums, unsupported options...) do not change the
+ * profile of the next packets of their flow. The RTP rejections do not count
+ * if the RTP heuristic is running since the flow might be detected as RTP
+ * later. The flows that remain idle for too long are forgotten. The flows
+ * with malformed or unknown IP headers are never cached.
+ *
  * @param comp    The ROHC compressor
  * @param packet  The packet to find a compression profile for
  * @return        The ROHC profile if found, NULL otherwise
  */
 static const struct rohc_comp_profile *
-	c_get_profile_from_packet(const struct rohc_comp *const comp,
+	c_get_profile_from_packet(struct rohc_comp *const comp,
 	                          const struct net_pkt *const packet)
 {
+	const uint16_t dispatch_key = c_get_dispatch_key(packet);
+	struct rohc_comp_profile_cache_key flow_key;
+	const uint32_t flow_hash =
+		c_get_profile_cache_key(packet, dispatch_key, &flow_key);
+	struct rohc_comp_profile_cache *const cached_flow =
+		&comp->profiles_cache[flow_hash & comp->profiles_cache_mask];
+	const uint8_t candidates = comp->profiles_dispatch[dispatch_key];
+	bool is_cacheable;
 	size_t i;
 
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "try to find the best profile for packet with transport "
 	           "protocol %u", packet->transport->proto);
 
-	/* test all compression profiles */
+	comp->flows_clock++;
+
+	/* the flows with malformed or unknown IP headers are not identified by
+	 * their addresses, so they are not cached */
+	is_cacheable = (dispatch_key / ((ROHC_IPPROTO_MAX + 1U) *
+	                                ROHC_COMP_DISPATCH_IP_HDRS) !=
+	                (ROHC_COMP_DISPATCH_IP_VERSIONS - 1));
+
+	/* known flow: try the profile that was chosen for the previous packets */
+	if(is_cacheable &&
+	   cached_flow->profile_idx != 0 &&
+	   memcmp(&cached_flow->key, &flow_key, sizeof(flow_key)) == 0 &&
+	   (comp->flows_clock - cached_flow->last_use) <= ROHC_COMP_FLOWS_MAX_IDLE)
+	{
+		const struct rohc_comp_profile *const profile =
+			rohc_comp_profiles[cached_flow->profile_idx - 1];
+
+		if(profile->check_profile(comp, packet))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "profile '%s' (0x%04x) was already chosen for the flow",
+			           rohc_get_profile_descr(profile->id), profile->id);
+			cached_flow->last_use = comp->flows_clock;
+			return profile;
+		}
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "profile '%s' (0x%04x) chosen for the flow does not match "
+		           "packet anymore", rohc_get_profile_descr(profile->id),
+		           profile->id);
+	}
+
+	/* test the candidate compression profiles */
 	for(i = 0; i < C_NUM_PROFILES; i++)
 	{
 		bool check_profile;
 
-		/* skip profile if the profile is not enabled */
-		if(!comp->enabled_profiles[i])
+		/* skip profile if the profile is not enabled or if it cannot accept
+		 * that type of packet */
+		if((candidates & (1U << i)) == 0)
 		{
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "skip disabled profile '%s' (0x%04x)",
+			           "skip disabled or unsuitable profile '%s' (0x%04x)",
 			           rohc_get_profile_descr(rohc_comp_profiles[i]->id),
 			           rohc_comp_profiles[i]->id);
 			continue;
@@ -2231,14 +4205,149 @@ static const struct rohc_comp_profile *
 			           "skip profile '%s' (0x%04x) because it does not match "
 			           "packet",rohc_get_profile_descr(rohc_comp_profiles[i]->id),
 			           rohc_comp_profiles[i]->id);
+			if(rohc_comp_profiles[i]->id != ROHC_PROFILE_RTP ||
+			   (comp->rtp_callback == NULL && comp->rtp_heuristic_pkts_nr > 0))
+			{
+				is_cacheable = false;
+			}
 			continue;
 		}
 
-		/* the packet is compatible with the profile, let's go with it! */
+		/* the packet is compatible with the profile, let's go with it! Remember
+		 * the profile for the next packets of the flow */
+		if(is_cacheable &&
+		   rohc_comp_profiles[i]->id != ROHC_PROFILE_UNCOMPRESSED)
+		{
+			memcpy(&cached_flow->key, &flow_key, sizeof(flow_key));
+			cached_flow->profile_idx = i + 1;
+			cached_flow->last_use = comp->flows_clock;
+		}
 		return rohc_comp_profiles[i];
 	}
 
-	return NULL;
+	return NULL;
+}
+
+
+/**
+ * @brief Build the table of the candidate profiles for every type of packet
+ *
+ * A profile is a candidate for one type of packet if it is enabled and if
+ * it may accept such packets, ie. if it is not bound to a transport protocol
+ * or if it is bound to the protocol transported by the innermost IP header.
+ * All the enabled profiles are candidates for malformed or unknown IP
+ * headers and for packets with more than 2 IP headers, since the profiles
+ * parse such packets on their own.
+ *
+ * The cache of profiles is flushed since it might refer to profiles that
+ * are not enabled anymore.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void c_build_profiles_dispatch(struct rohc_comp *const comp)
+{
+	size_t key;
+
+	/* one bit per profile in every entry */
+	assert(C_NUM_PROFILES <= 8);
+
+	for(key = 0; key < ROHC_COMP_DISPATCH_KEYS_NR; key++)
+	{
+		const uint8_t proto = key % (ROHC_IPPROTO_MAX + 1U);
+		const size_t version_idx =
+			key / ((ROHC_IPPROTO_MAX + 1U) * ROHC_COMP_DISPATCH_IP_HDRS);
+		uint8_t candidates = 0;
+		size_t i;
+
+		for(i = 0; i < C_NUM_PROFILES; i++)
+		{
+			const struct rohc_comp_profile *const profile = rohc_comp_profiles[i];
+
+			if(!comp->enabled_profiles[i])
+			{
+				continue;
+			}
+			if(version_idx == (ROHC_COMP_DISPATCH_IP_VERSIONS - 1) ||
+			   rohc_is_tunneling(proto) ||
+			   profile->protocol == 0 ||
+			   profile->protocol == proto)
+			{
+				candidates |= (1U << i);
+			}
+		}
+		comp->profiles_dispatch[key] = candidates;
+	}
+
+	memset(comp->profiles_cache, 0,
+	       (comp->profiles_cache_mask + 1) *
+	       sizeof(struct rohc_comp_profile_cache));
+}
+
+
+/**
+ * @brief Forget the RTP detection results of the UDP flows
+ *
+ * The UDP flows that are compressed by RTP contexts are kept: they are
+ * never classified again while their contexts live.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void c_reset_rtp_flows(struct rohc_comp *const comp)
+{
+	const size_t flows_nr =
+		(comp->rtp_flows_mask + 1) * ROHC_COMP_RTP_FLOWS_WAYS;
+	size_t i;
+
+	for(i = 0; i < flows_nr; i++)
+	{
+		if(comp->rtp_flows[i].ctxts_nr == 0)
+		{
+			memset(&comp->rtp_flows[i], 0, sizeof(struct rohc_comp_rtp_flow));
+		}
+	}
+}
+
+
+/**
+ * @brief Get the type of packet the compression profiles are dispatched on
+ *
+ * The type of packet is made of the IP version of the innermost IP header,
+ * the number of IP headers and the protocol transported by the innermost IP
+ * header. The IP version is set to the last index (unknown) if one of the IP
+ * headers is malformed or not IPv4/IPv6, or if the transport layer was not
+ * found.
+ *
+ * @param packet  The packet to get the type for
+ * @return        The index of the type of packet in the dispatch table
+ */
+static uint16_t c_get_dispatch_key(const struct net_pkt *const packet)
+{
+	const struct ip_packet *const innermost_ip =
+		(packet->ip_hdr_nr > 1 ? &packet->inner_ip : &packet->outer_ip);
+	const ip_version outer_version = ip_get_version(&packet->outer_ip);
+	const ip_version innermost_version = ip_get_version(innermost_ip);
+	size_t version_idx;
+
+	assert(packet->ip_hdr_nr >= 1);
+	assert(packet->ip_hdr_nr <= ROHC_COMP_DISPATCH_IP_HDRS);
+
+	if((outer_version != IPV4 && outer_version != IPV6) ||
+	   (innermost_version != IPV4 && innermost_version != IPV6) ||
+	   packet->transport->data == NULL)
+	{
+		version_idx = ROHC_COMP_DISPATCH_IP_VERSIONS - 1;
+	}
+	else if(innermost_version == IPV4)
+	{
+		version_idx = 0;
+	}
+	else
+	{
+		version_idx = 1;
+	}
+
+	return ((version_idx * ROHC_COMP_DISPATCH_IP_HDRS + packet->ip_hdr_nr - 1) *
+	        (ROHC_IPPROTO_MAX + 1U) + packet->transport->proto);
 }
 
 
@@ -2265,64 +4374,28 @@ static struct rohc_comp_ctxt *
 	assert(profile != NULL);
 	assert(packet != NULL);
 
-	cid_to_use = 0;
-
 	/* if all the contexts in the array are used:
-	 *   => recycle the oldest context to make room
+	 *   => recycle the least recently used context to make room
 	 * if at least one context in the array is not used:
-	 *   => pick the first unused context
+	 *   => pick the unused context on top of the stack of free CIDs
 	 */
-	if(comp->num_contexts_used > comp->medium.max_cid)
-	{
-		/* all the contexts in the array were used, recycle the oldest context
-		 * to make some room */
-
-		uint64_t oldest;
-		rohc_cid_t i;
-
-		/* find the oldest context */
-		oldest = 0xffffffff;
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].latest_used < oldest)
-			{
-				oldest = comp->contexts[i].latest_used;
-				cid_to_use = i;
-			}
-		}
-
-		/* destroy the oldest context before replacing it with a new one */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "recycle oldest context (CID = %zu)", cid_to_use);
-		comp->contexts[cid_to_use].profile->destroy(&comp->contexts[cid_to_use]);
-		comp->contexts[cid_to_use].key = 0; /* reset context key */
-		comp->contexts[cid_to_use].used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
-	}
-	else
+	if(comp->free_cids_nr == 0)
 	{
-		/* there was at least one unused context in the array, pick the first
-		 * unused context in the context array */
-
-		rohc_cid_t i;
-
-		/* find the first unused context */
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].used == 0)
-			{
-				cid_to_use = i;
-				break;
-			}
-		}
-
+		/* all the contexts in the array were used, recycle the least recently
+		 * used context to make some room */
+		assert(comp->num_contexts_used == comp->contexts_nr);
+		assert(comp->lru_first != NULL);
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "take the first unused context (CID = %zu)", cid_to_use);
+		           "recycle oldest context (CID = %zu)", comp->lru_first->cid);
+		c_destroy_context(comp, comp->lru_first);
 	}
+	assert(comp->free_cids_nr > 0);
+	cid_to_use = comp->free_cids[comp->free_cids_nr - 1];
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "take an unused context (CID = %zu)", cid_to_use);
 
 	/* initialize the previously found context */
-	c = &comp->contexts[cid_to_use];
+	c = &comp->contexts[cid_to_use - comp->first_cid];
 
 	c->ir_count = 0;
 	c->fo_count = 0;
@@ -2345,168 +4418,592 @@ static struct rohc_comp_ctxt *
 	c->cid = cid_to_use;
 	c->profile = profile;
 	c->key = packet->key;
+	c->flow_hash = c_get_flow_hash(profile, packet);
 
 	c->mode = ROHC_U_MODE;
 	c->state = ROHC_COMP_STATE_IR;
 
 	c->compressor = comp;
 
+	/* the statistics of the context start again with the new flow */
+	if(comp->detailed_stats != NULL)
+	{
+		memset(rohc_comp_get_ctxt_stats(comp, c), 0, sizeof(struct rohc_stats));
+	}
+
 	/* create profile-specific context */
 	if(!profile->create(c, packet))
 	{
-		return NULL;
+		return NULL;
+	}
+
+	/* if creation is successful, mark the context as used */
+	c->used = 1;
+	c->first_used = arrival_time.sec;
+	c->latest_used = arrival_time.sec;
+	assert(comp->num_contexts_used < comp->contexts_nr);
+	comp->num_contexts_used++;
+
+	/* record the creation of the context in statistics */
+	if(comp->detailed_stats != NULL)
+	{
+		rohc_comp_stats_add_transition(comp, c, ROHC_COMP_STATE_UNKNOWN,
+		                               c->state);
+	}
+
+	/* the CID is not free anymore */
+	comp->free_cids_nr--;
+
+	/* index the new context by its flow, it is the most recently used one */
+	c_ctxt_hash_add(comp, c);
+	c_ctxt_lru_append(comp, c);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "context (CID = %zu) created (num_used = %zu)",
+	           c->cid, comp->num_contexts_used);
+	return c;
+}
+
+
+/**
+ * @brief Find a compression context given an IP packet
+ *
+ * @param comp             The ROHC compressor
+ * @param packet           The packet to find a compression context for
+ * @param profile_id_hint  If positive, indicate the profile to use
+ * @param arrival_time     The time at which packet was received
+ *                         (0 if unknown, or to disable time-related features
+ *                          in the ROHC protocol)
+ * @return                 The context if found or successfully created,
+ *                         NULL if not found
+ */
+static struct rohc_comp_ctxt *
+	rohc_comp_find_ctxt(struct rohc_comp *const comp,
+	                    const struct net_pkt *const packet,
+	                    const int profile_id_hint,
+	                    const struct rohc_ts arrival_time)
+{
+	const struct rohc_comp_profile *profile;
+	struct rohc_comp_ctxt *context;
+	uint32_t flow_hash;
+
+	/* use the suggested profile if any, otherwise find the best profile for
+	 * the packet */
+	if(profile_id_hint < 0)
+	{
+		profile = c_get_profile_from_packet(comp, packet);
+	}
+	else
+	{
+		profile = rohc_get_profile_from_id(comp, profile_id_hint);
+	}
+	if(profile == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no profile found for packet, giving up");
+		goto not_found;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "using profile '%s' (0x%04x)",
+	           rohc_get_profile_descr(profile->id), profile->id);
+
+	/* get the context using help from the profile we just found */
+	flow_hash = c_get_flow_hash(profile, packet);
+	context = c_lookup_context(comp, profile, packet, flow_hash);
+	if(context == NULL)
+	{
+		/* context not found, create a new one */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no existing context found for packet, create a new one");
+		context = c_create_context(comp, profile, packet, arrival_time);
+		if(context == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create a new context");
+			goto not_found;
+		}
+	}
+	else
+	{
+		c_use_context(comp, context, arrival_time);
+	}
+
+	return context;
+
+not_found:
+	return NULL;
+}
+
+
+/**
+ * @brief Look for the compression context of the given packet
+ *
+ * Probe the slots of the hash table until a free slot is found: all the
+ * contexts for the flow are stored before the first free slot.
+ *
+ * @param comp       The ROHC compressor
+ * @param profile    The profile to compress the packet with
+ * @param packet     The packet to find a compression context for
+ * @param flow_hash  The flow hash of the packet for the given profile
+ * @return           The context if found, NULL if not found
+ */
+static struct rohc_comp_ctxt *
+	c_lookup_context(const struct rohc_comp *const comp,
+	                 const struct rohc_comp_profile *const profile,
+	                 const struct net_pkt *const packet,
+	                 const uint32_t flow_hash)
+{
+	struct rohc_comp_ctxt *context;
+	size_t i;
+
+	context = NULL;
+	for(i = flow_hash & comp->ctxts_hash_mask;
+	    comp->ctxts_hash[i].cid != ROHC_COMP_CTXT_SLOT_FREE;
+	    i = (i + 1) & comp->ctxts_hash_mask)
+	{
+		struct rohc_comp_ctxt *const candidate =
+			&comp->contexts[comp->ctxts_hash[i].cid - comp->first_cid];
+
+		/* don't even look at contexts of other flows */
+		if(comp->ctxts_hash[i].hash != flow_hash)
+		{
+			continue;
+		}
+		assert(candidate->used);
+
+		/* don't look at contexts with the wrong profile */
+		if(candidate->profile->id != profile->id)
+		{
+			continue;
+		}
+
+		/* don't look at contexts with the wrong key */
+		if(packet->key != candidate->key)
+		{
+			continue;
+		}
+
+		/* several contexts may match the packet: always prefer the one with
+		 * the smallest CID */
+		if(context != NULL && candidate->cid > context->cid)
+		{
+			continue;
+		}
+
+		/* ask the profile whether the packet matches the context */
+		if(candidate->profile->check_context(candidate, packet))
+		{
+			context = candidate;
+		}
+	}
+
+	return context;
+}
+
+
+/**
+ * @brief Mark the given compression context as the most recently used one
+ *
+ * @param comp          The ROHC compressor
+ * @param context       The compression context that matched a packet
+ * @param arrival_time  The time at which the packet was received
+ */
+static void c_use_context(struct rohc_comp *const comp,
+                          struct rohc_comp_ctxt *const context,
+                          const struct rohc_ts arrival_time)
+{
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "using context CID = %zu", context->cid);
+	context->latest_used = arrival_time.sec;
+	c_ctxt_lru_unlink(comp, context);
+	c_ctxt_lru_append(comp, context);
+}
+
+
+/**
+ * @brief Find out a context given its CID
+ *
+ * @param comp The ROHC compressor
+ * @param cid  The CID of the context to find
+ * @return     The context with the given CID if found, NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	/* the CID must be in the range of CIDs of the context array */
+	if(cid < comp->first_cid || (cid - comp->first_cid) >= comp->contexts_nr)
+	{
+		goto not_found;
+	}
+
+	/* the context with the given CID must be in use */
+	if(comp->contexts[cid - comp->first_cid].used == 0)
+	{
+		goto not_found;
+	}
+
+	return &(comp->contexts[cid - comp->first_cid]);
+
+not_found:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy one compression context and make its CID available again
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to destroy
+ */
+static void c_destroy_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+{
+	assert(context->used);
+
+	c_ctxt_hash_del(comp, context);
+	c_ctxt_lru_unlink(comp, context);
+	context->profile->destroy(context);
+	context->key = 0; /* reset context key */
+	context->used = 0;
+	assert(comp->num_contexts_used > 0);
+	comp->num_contexts_used--;
+
+	/* the CID is available again */
+	assert(comp->free_cids_nr < comp->contexts_nr);
+	comp->free_cids[comp->free_cids_nr] = context->cid;
+	comp->free_cids_nr++;
+}
+
+
+/**
+ * @brief Mix one 32-bit word into a flow hash
+ *
+ * @param hash  The flow hash computed so far
+ * @param word  The 32-bit word to add to the flow hash
+ * @return      The updated flow hash
+ */
+static inline uint32_t c_flow_hash_mix(uint32_t hash, uint32_t word)
+{
+	word *= 0xcc9e2d51U;
+	word = (word << 15) | (word >> 17);
+	word *= 0x1b873593U;
+	hash ^= word;
+	hash = (hash << 13) | (hash >> 19);
+	return hash * 5 + 0xe6546b64U;
+}
+
+
+/**
+ * @brief Finish a flow hash with a final avalanche
+ *
+ * @param hash  The flow hash computed so far
+ * @return      The final flow hash
+ */
+static inline uint32_t c_flow_hash_finish(uint32_t hash)
+{
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+
+/**
+ * @brief Mix the addresses of one IP header into a flow hash
+ *
+ * @param hash  The flow hash computed so far
+ * @param ip    The IP header to get addresses from
+ * @return      The updated flow hash
+ */
+static uint32_t c_flow_hash_ip(uint32_t hash, const struct ip_packet *const ip)
+{
+	if(ip_get_version(ip) == IPV4)
+	{
+		hash = c_flow_hash_mix(hash, ipv4_get_saddr(ip));
+		hash = c_flow_hash_mix(hash, ipv4_get_daddr(ip));
+	}
+	else if(ip_get_version(ip) == IPV6)
+	{
+		const struct ipv6_addr *const saddr = ipv6_get_saddr(ip);
+		const struct ipv6_addr *const daddr = ipv6_get_daddr(ip);
+		size_t i;
+
+		for(i = 0; i < 4; i++)
+		{
+			hash = c_flow_hash_mix(hash, saddr->u32[i]);
+			hash = c_flow_hash_mix(hash, daddr->u32[i]);
+		}
+	}
+
+	return hash;
+}
+
+
+/**
+ * @brief Compute the flow hash of a packet for the given profile
+ *
+ * The flow hash is computed on the profile ID and on some of the header
+ * fields that the profile compares in its check_context() handler, ie. the
+ * source and destination addresses of all the IP headers, and the first
+ * 32 bits of the transport header (UDP/UDP-Lite/TCP ports, ESP SPI) if the
+ * profile is bound to a transport protocol. Two packets that match the same
+ * context thus always get the same flow hash.
+ *
+ * The Uncompressed profile accepts any packet with the same key, so only the
+ * key is used for that profile.
+ *
+ * @param profile  The profile the packet shall be compressed with
+ * @param packet   The packet to compute the flow hash for
+ * @return         The flow hash
+ */
+static uint32_t c_get_flow_hash(const struct rohc_comp_profile *const profile,
+                                const struct net_pkt *const packet)
+{
+	uint32_t hash = c_flow_hash_mix(0, profile->id);
+
+	if(profile->id == ROHC_PROFILE_UNCOMPRESSED)
+	{
+		hash = c_flow_hash_mix(hash, packet->key);
+	}
+	else
+	{
+		hash = c_flow_hash_ip(hash, &packet->outer_ip);
+		if(packet->ip_hdr_nr > 1)
+		{
+			hash = c_flow_hash_ip(hash, &packet->inner_ip);
+		}
+		if(profile->protocol != 0 &&
+		   packet->transport->proto == profile->protocol &&
+		   packet->transport->data != NULL &&
+		   packet->transport->len >= sizeof(uint32_t))
+		{
+			uint32_t transport_word;
+			memcpy(&transport_word, packet->transport->data, sizeof(uint32_t));
+			hash = c_flow_hash_mix(hash, transport_word);
+		}
+	}
+
+	return c_flow_hash_finish(hash);
+}
+
+
+/**
+ * @brief Get the key and the hash of a packet for the cache of profiles
+ *
+ * Contrary to \ref c_get_flow_hash, the key does not depend on any profile:
+ * it is made of the type of packet, of the IP version of the outer IP
+ * header, of the source and destination addresses of all the IP headers,
+ * and of the first 32 bits of the transport header if any.
+ *
+ * @param packet        The packet to get the key for
+ * @param dispatch_key  The type of packet
+ * @param[out] key      The key of the flow of the packet
+ * @return              The hash of the key
+ */
+static uint32_t
+	c_get_profile_cache_key(const struct net_pkt *const packet,
+	                        const uint16_t dispatch_key,
+	                        struct rohc_comp_profile_cache_key *const key)
+{
+	uint32_t hash = c_flow_hash_mix(0, dispatch_key);
+	size_t i;
+
+	memset(key, 0, sizeof(struct rohc_comp_profile_cache_key));
+	key->dispatch_key = dispatch_key;
+	key->outer_version = ip_get_version(&packet->outer_ip);
+
+	for(i = 0; i < packet->ip_hdr_nr && i < ROHC_COMP_DISPATCH_IP_HDRS; i++)
+	{
+		const struct ip_packet *const ip =
+			(i == 0 ? &packet->outer_ip : &packet->inner_ip);
+
+		if(ip_get_version(ip) == IPV4)
+		{
+			key->saddrs[i][0] = ipv4_get_saddr(ip);
+			key->daddrs[i][0] = ipv4_get_daddr(ip);
+		}
+		else if(ip_get_version(ip) == IPV6)
+		{
+			memcpy(key->saddrs[i], ipv6_get_saddr(ip)->u32,
+			       sizeof(key->saddrs[i]));
+			memcpy(key->daddrs[i], ipv6_get_daddr(ip)->u32,
+			       sizeof(key->daddrs[i]));
+		}
+		hash = c_flow_hash_ip(hash, ip);
+	}
+	if(packet->transport->data != NULL &&
+	   packet->transport->len >= sizeof(uint32_t))
+	{
+		memcpy(&key->transport_word, packet->transport->data, sizeof(uint32_t));
+		hash = c_flow_hash_mix(hash, key->transport_word);
 	}
 
-	/* if creation is successful, mark the context as used */
-	c->used = 1;
-	c->first_used = arrival_time.sec;
-	c->latest_used = arrival_time.sec;
-	assert(comp->num_contexts_used <= comp->medium.max_cid);
-	comp->num_contexts_used++;
-
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "context (CID = %zu) created (num_used = %zu)",
-	           c->cid, comp->num_contexts_used);
-	return c;
+	return c_flow_hash_finish(hash);
 }
 
 
 /**
- * @brief Find a compression context given an IP packet
+ * @brief Compute the hash of a packet for a pool of compressors
  *
- * @param comp             The ROHC compressor
- * @param packet           The packet to find a compression context for
- * @param profile_id_hint  If positive, indicate the profile to use
- * @param arrival_time     The time at which packet was received
- *                         (0 if unknown, or to disable time-related features
- *                          in the ROHC protocol)
- * @return                 The context if found or successfully created,
- *                         NULL if not found
+ * The hash shall be the same for all the packets that the compressor would
+ * compress with the same context, whatever the profile: it is computed on the
+ * source and destination addresses of all the IP headers, and on the first
+ * 32 bits of the transport header (ports, SPI) only for the UDP, UDP-Lite,
+ * TCP and ESP protocols. The first 32 bits of the other transport protocols
+ * (eg. the ICMP checksum) may change from one packet to another.
+ *
+ * @param packet  The packet to compute the hash for
+ * @return        The hash
  */
-static struct rohc_comp_ctxt *
-	rohc_comp_find_ctxt(struct rohc_comp *const comp,
-	                    const struct net_pkt *const packet,
-	                    const int profile_id_hint,
-	                    const struct rohc_ts arrival_time)
+uint32_t rohc_comp_get_pool_flow_hash(const struct net_pkt *const packet)
 {
-	const struct rohc_comp_profile *profile;
-	struct rohc_comp_ctxt *context;
-	size_t num_used_ctxt_seen = 0;
-	rohc_cid_t i;
+	uint32_t hash = 0;
 
-	/* use the suggested profile if any, otherwise find the best profile for
-	 * the packet */
-	if(profile_id_hint < 0)
+	hash = c_flow_hash_ip(hash, &packet->outer_ip);
+	if(packet->ip_hdr_nr > 1)
 	{
-		profile = c_get_profile_from_packet(comp, packet);
+		hash = c_flow_hash_ip(hash, &packet->inner_ip);
 	}
-	else
+	if((packet->transport->proto == ROHC_IPPROTO_UDP ||
+	    packet->transport->proto == ROHC_IPPROTO_UDPLITE ||
+	    packet->transport->proto == ROHC_IPPROTO_TCP ||
+	    packet->transport->proto == ROHC_IPPROTO_ESP) &&
+	   packet->transport->data != NULL &&
+	   packet->transport->len >= sizeof(uint32_t))
 	{
-		profile = rohc_get_profile_from_id(comp, profile_id_hint);
+		uint32_t transport_word;
+		memcpy(&transport_word, packet->transport->data, sizeof(uint32_t));
+		hash = c_flow_hash_mix(hash, transport_word);
 	}
-	if(profile == NULL)
+
+	return c_flow_hash_finish(hash);
+}
+
+
+/**
+ * @brief Index the given context in the hash table of contexts
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to index
+ */
+static void c_ctxt_hash_add(struct rohc_comp *const comp,
+                            const struct rohc_comp_ctxt *const context)
+{
+	size_t i;
+
+	/* the table is at least twice as large as the context array, so there is
+	 * always a free slot */
+	for(i = context->flow_hash & comp->ctxts_hash_mask;
+	    comp->ctxts_hash[i].cid != ROHC_COMP_CTXT_SLOT_FREE;
+	    i = (i + 1) & comp->ctxts_hash_mask)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "no profile found for packet, giving up");
-		goto not_found;
+		assert(comp->ctxts_hash[i].cid != context->cid);
 	}
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "using profile '%s' (0x%04x)",
-	           rohc_get_profile_descr(profile->id), profile->id);
+	comp->ctxts_hash[i].hash = context->flow_hash;
+	comp->ctxts_hash[i].cid = context->cid;
+}
 
-	/* get the context using help from the profile we just found */
-	for(i = 0; i <= comp->medium.max_cid; i++)
-	{
-		context = &comp->contexts[i];
 
-		/* don't even look at unused contexts */
-		if(!context->used)
-		{
-			continue;
-		}
-		num_used_ctxt_seen++;
+/**
+ * @brief Remove the given context from the hash table of contexts
+ *
+ * The slots that follow the removed slot are shifted backward if required,
+ * so that no tombstone is needed and probing may stop at the first free slot.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to remove
+ */
+static void c_ctxt_hash_del(struct rohc_comp *const comp,
+                            const struct rohc_comp_ctxt *const context)
+{
+	const size_t mask = comp->ctxts_hash_mask;
+	size_t i;
+	size_t j;
 
-		/* don't look at contexts with the wrong profile */
-		if(context->profile->id != profile->id)
-		{
-			continue;
-		}
+	/* find the slot of the context */
+	for(i = context->flow_hash & mask;
+	    comp->ctxts_hash[i].cid != context->cid;
+	    i = (i + 1) & mask)
+	{
+		assert(comp->ctxts_hash[i].cid != ROHC_COMP_CTXT_SLOT_FREE);
+	}
 
-		/* don't look at contexts with the wrong key */
-		if(packet->key != context->key)
+	/* free the slot, then move back the next slots that would not be found
+	 * anymore because of the new hole in their probe sequence */
+	for(j = (i + 1) & mask;
+	    comp->ctxts_hash[j].cid != ROHC_COMP_CTXT_SLOT_FREE;
+	    j = (j + 1) & mask)
+	{
+		const size_t k = comp->ctxts_hash[j].hash & mask;
+
+		/* leave the slot in place if its ideal position is in ]i, j] */
+		if((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
 		{
 			continue;
 		}
+		comp->ctxts_hash[i] = comp->ctxts_hash[j];
+		i = j;
+	}
+	comp->ctxts_hash[i].cid = ROHC_COMP_CTXT_SLOT_FREE;
+}
 
-		/* ask the profile whether the packet matches the context */
-		if(context->profile->check_context(context, packet))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "using context CID = %zu", context->cid);
-			break;
-		}
 
-		/* if all used contexts were checked, no need go search further */
-		if(num_used_ctxt_seen >= comp->num_contexts_used)
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "no context was found");
-			context = NULL;
-			break;
-		}
-	}
-	if(context == NULL || i > comp->medium.max_cid)
+/**
+ * @brief Append the given context at the end of the LRU list
+ *
+ * The end of the LRU list is the most recently used context.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to append to the LRU list
+ */
+static void c_ctxt_lru_append(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+{
+	context->lru_prev = comp->lru_last;
+	context->lru_next = NULL;
+	if(comp->lru_last != NULL)
 	{
-		/* context not found, create a new one */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "no existing context found for packet, create a new one");
-		context = c_create_context(comp, profile, packet, arrival_time);
-		if(context == NULL)
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to create a new context");
-			goto not_found;
-		}
+		comp->lru_last->lru_next = context;
 	}
 	else
 	{
-		/* matching context found, update use timestamp */
-		context->latest_used = arrival_time.sec;
+		comp->lru_first = context;
 	}
-
-	return context;
-
-not_found:
-	return NULL;
+	comp->lru_last = context;
 }
 
 
 /**
- * @brief Find out a context given its CID
+ * @brief Remove the given context from the LRU list
  *
- * @param comp The ROHC compressor
- * @param cid  The CID of the context to find
- * @return     The context with the given CID if found, NULL otherwise
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to remove from the LRU list
  */
-static struct rohc_comp_ctxt *
-	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+static void c_ctxt_lru_unlink(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
 {
-	/* the CID must not be larger than the context array */
-	if(cid > comp->medium.max_cid)
+	if(context->lru_prev != NULL)
 	{
-		goto not_found;
+		context->lru_prev->lru_next = context->lru_next;
 	}
-
-	/* the context with the given CID must be in use */
-	if(comp->contexts[cid].used == 0)
+	else
 	{
-		goto not_found;
+		assert(comp->lru_first == context);
+		comp->lru_first = context->lru_next;
 	}
-
-	return &(comp->contexts[cid]);
-
-not_found:
-	return NULL;
+	if(context->lru_next != NULL)
+	{
+		context->lru_next->lru_prev = context->lru_prev;
+	}
+	else
+	{
+		assert(comp->lru_last == context);
+		comp->lru_last = context->lru_prev;
+	}
+	context->lru_prev = NULL;
+	context->lru_next = NULL;
 }
 
 
@@ -2518,16 +5015,19 @@ not_found:
  */
 static bool c_create_contexts(struct rohc_comp *const comp)
 {
+	size_t slots_nr;
+	size_t i;
+
 	assert(comp->contexts == NULL);
 
 	comp->num_contexts_used = 0;
 
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "create enough room for %zu contexts (MAX_CID = %zu)",
-	          comp->medium.max_cid + 1, comp->medium.max_cid);
+	          "create enough room for %zu contexts (CID %zu to %zu, MAX_CID = "
+	          "%zu)", comp->contexts_nr, comp->first_cid,
+	          comp->first_cid + comp->contexts_nr - 1, comp->medium.max_cid);
 
-	comp->contexts = calloc(comp->medium.max_cid + 1,
-	                        sizeof(struct rohc_comp_ctxt));
+	comp->contexts = calloc(comp->contexts_nr, sizeof(struct rohc_comp_ctxt));
 	if(comp->contexts == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -2535,13 +5035,119 @@ static bool c_create_contexts(struct rohc_comp *const comp)
 		goto error;
 	}
 
+	/* create the hash table that indexes contexts by flow: its size is a
+	 * power of two at least twice as large as the number of contexts */
+	slots_nr = 2;
+	while(slots_nr < (comp->contexts_nr * 2))
+	{
+		slots_nr *= 2;
+	}
+	comp->ctxts_hash = malloc(slots_nr * sizeof(struct rohc_comp_ctxt_slot));
+	if(comp->ctxts_hash == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the hash table of contexts");
+		goto free_contexts;
+	}
+	for(i = 0; i < slots_nr; i++)
+	{
+		comp->ctxts_hash[i].hash = 0;
+		comp->ctxts_hash[i].cid = ROHC_COMP_CTXT_SLOT_FREE;
+	}
+	comp->ctxts_hash_mask = slots_nr - 1;
+
+	/* all CIDs are free, the smallest ones are used first */
+	comp->free_cids = malloc(comp->contexts_nr * sizeof(rohc_cid_t));
+	if(comp->free_cids == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the stack of free CIDs");
+		goto free_hash;
+	}
+	for(i = 0; i < comp->contexts_nr; i++)
+	{
+		comp->free_cids[i] = comp->first_cid + comp->contexts_nr - 1 - i;
+	}
+	comp->free_cids_nr = comp->contexts_nr;
+	comp->lru_first = NULL;
+	comp->lru_last = NULL;
+
 	return true;
 
+free_hash:
+	zfree(comp->ctxts_hash);
+free_contexts:
+	zfree(comp->contexts);
 error:
 	return false;
 }
 
 
+/**
+ * @brief Preallocate the memory of the MAX_CID + 1 compression contexts
+ *
+ * Every CID gets the objects and the W-LSB windows required by the most
+ * demanding profile, so that contexts of any profile may be created and
+ * destroyed without calling the system allocator.
+ *
+ * @param comp The ROHC compressor
+ * @return     true if the preallocation is successful, false otherwise
+ */
+static bool c_prealloc_contexts(struct rohc_comp *const comp)
+{
+	size_t i;
+
+	assert(comp->num_contexts_used == 0);
+
+	for(i = 0; i < C_NUM_PROFILES; i++)
+	{
+		const struct rohc_comp_profile *const profile = rohc_comp_profiles[i];
+		size_t objs_sizes[ROHC_COMP_CTXT_OBJS_MAX + ROHC_COMP_CTXT_WLSBS_MAX];
+		size_t j;
+
+		/* the profile-specific objects, then the W-LSB windows */
+		memcpy(objs_sizes, profile->ctxt_objs_sizes,
+		       ROHC_COMP_CTXT_OBJS_MAX * sizeof(size_t));
+		for(j = 0; j < ROHC_COMP_CTXT_WLSBS_MAX; j++)
+		{
+			size_t width = profile->ctxt_wlsbs_widths[j];
+
+			if(width == ROHC_COMP_WLSB_WIDTH_CONF)
+			{
+				width = comp->wlsb_window_width;
+			}
+			objs_sizes[ROHC_COMP_CTXT_OBJS_MAX + j] =
+				(width == 0 ? 0 : c_wlsb_size(width));
+		}
+
+		if(!rohc_slab_add(&comp->ctxt_slab, objs_sizes,
+		                  ROHC_COMP_CTXT_OBJS_MAX + ROHC_COMP_CTXT_WLSBS_MAX,
+		                  comp->contexts_nr))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "too many different context objects for profile "
+			             "0x%04x", profile->id);
+			goto reset_slab;
+		}
+	}
+	if(!rohc_slab_prealloc(&comp->ctxt_slab))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "not enough memory to preallocate contexts");
+		goto reset_slab;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "%zu bytes preallocated for %zu contexts",
+	           comp->ctxt_slab.reserved_bytes, comp->contexts_nr);
+
+	return true;
+
+reset_slab:
+	rohc_slab_reset(&comp->ctxt_slab);
+	return false;
+}
+
+
 /**
  * @brief Destroy all the compression contexts in the context array
  *
@@ -2551,26 +5157,24 @@ error:
  */
 static void c_destroy_contexts(struct rohc_comp *const comp)
 {
-	rohc_cid_t i;
+	size_t i;
 
 	assert(comp->contexts != NULL);
 
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	for(i = 0; i < comp->contexts_nr; i++)
 	{
-		if(comp->contexts[i].used && comp->contexts[i].profile != NULL)
-		{
-			comp->contexts[i].profile->destroy(&comp->contexts[i]);
-		}
-
 		if(comp->contexts[i].used)
 		{
-			comp->contexts[i].used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
+			c_destroy_context(comp, &comp->contexts[i]);
 		}
 	}
 	assert(comp->num_contexts_used == 0);
+	rohc_slab_reset(&comp->ctxt_slab);
 
+	free(comp->free_cids);
+	comp->free_cids = NULL;
+	free(comp->ctxts_hash);
+	comp->ctxts_hash = NULL;
 	free(comp->contexts);
 	comp->contexts = NULL;
 }
@@ -2632,6 +5236,12 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 		context->fo_count = 0;
 		context->so_count = 0;
 
+		if(context->compressor->detailed_stats != NULL)
+		{
+			rohc_comp_stats_add_transition(context->compressor, context,
+			                               context->state, new_state);
+		}
+
 		/* change state */
 		context->state = new_state;
 	}
@@ -2896,13 +5506,12 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
 
 		/* compute the CRC of the feedback packet (skip CRC byte) */
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet,
-		                             packet_len - crc_pos_from_end, CRC_INIT_8,
-		                             context->compressor->crc_table_8);
+		                             packet_len - crc_pos_from_end, CRC_INIT_8);
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, &zeroed_crc, zeroed_crc_len,
-		                             crc_computed, context->compressor->crc_table_8);
+		                             crc_computed);
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet + packet_len -
 		                             crc_pos_from_end + 1, crc_pos_from_end - 1,
-		                             crc_computed, context->compressor->crc_table_8);
+		                             crc_computed);
 
 		/* ignore feedback in case of bad CRC */
 		if(crc_in_packet != crc_computed)
@@ -3095,3 +5704,142 @@ error:
 	return false;
 }
 
+
+/**
+ * @brief Get the detailed statistics of the given context
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context
+ * @return         The detailed statistics of the context
+ */
+static struct rohc_stats *
+	rohc_comp_get_ctxt_stats(const struct rohc_comp *const comp,
+	                         const struct rohc_comp_ctxt *const context)
+{
+	/* the context may be unused, so rely on its position, not on its CID */
+	const size_t ctxt_index = context - comp->contexts;
+
+	assert(comp->detailed_stats != NULL);
+	assert(ctxt_index < comp->contexts_nr);
+
+	/* the first item is for the whole compressor */
+	return &comp->detailed_stats[1 + ctxt_index].counters;
+}
+
+
+/**
+ * @brief Record one compressed packet in the detailed statistics
+ *
+ * @param comp            The ROHC compressor
+ * @param context         The compression context that compressed the packet
+ * @param packet_type     The type of the ROHC packet
+ * @param start_time      The time (in nanoseconds) the compression started
+ * @param comp_hdr_len    The length (in bytes) of the ROHC header
+ * @param uncomp_hdr_len  The length (in bytes) of the uncompressed header
+ */
+static void rohc_comp_stats_add_pkt(struct rohc_comp *const comp,
+                                    const struct rohc_comp_ctxt *const context,
+                                    const rohc_packet_t packet_type,
+                                    const uint64_t start_time,
+                                    const size_t comp_hdr_len,
+                                    const size_t uncomp_hdr_len)
+{
+	struct rohc_stats *const comp_stats = &comp->detailed_stats[0].counters;
+	struct rohc_stats *const ctxt_stats = rohc_comp_get_ctxt_stats(comp, context);
+	const uint64_t duration = rohc_time_get_ns() - start_time;
+
+	rohc_stats_add_pkt(comp_stats, packet_type, duration);
+	rohc_stats_add_hdr(comp_stats, comp_hdr_len, uncomp_hdr_len);
+	rohc_stats_add_pkt(ctxt_stats, packet_type, duration);
+	rohc_stats_add_hdr(ctxt_stats, comp_hdr_len, uncomp_hdr_len);
+}
+
+
+/**
+ * @brief Record one state transition in the detailed statistics
+ *
+ * @param comp       The ROHC compressor
+ * @param context    The compression context that changes its state
+ * @param old_state  The state the context leaves
+ * @param new_state  The state the context enters in
+ */
+static void rohc_comp_stats_add_transition(struct rohc_comp *const comp,
+                                           const struct rohc_comp_ctxt *const context,
+                                           const rohc_comp_state_t old_state,
+                                           const rohc_comp_state_t new_state)
+{
+	rohc_stats_add_transition(&comp->detailed_stats[0].counters,
+	                          old_state, new_state);
+	rohc_stats_add_transition(rohc_comp_get_ctxt_stats(comp, context),
+	                          old_state, new_state);
+}
+
+
+/**
+ * @brief Copy the given detailed statistics in the structure given by user
+ *
+ * The fields that depend on the states of contexts are reset.
+ *
+ * @param comp           The ROHC compressor
+ * @param counters       The detailed statistics to copy
+ * @param[in,out] stats  The structure given by user
+ * @return               true if the statistics were successfully copied,
+ *                       false if the version of the structure is unsupported
+ */
+static bool rohc_comp_stats_export(const struct rohc_comp *const comp,
+                                   const struct rohc_stats *const counters,
+                                   rohc_comp_stats_snapshot_t *const stats)
+{
+	size_t i;
+	size_t j;
+
+	/* check compatibility version */
+	if(stats->version_major != 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "detailed statistics", stats->version_major);
+		goto error;
+	}
+	if(stats->version_minor != 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported minor version (%u) of the structure for "
+		           "detailed statistics", stats->version_minor);
+		goto error;
+	}
+
+	/* base fields for major version 0 */
+	stats->packets_nr = counters->packets_nr;
+	stats->uncomp_hdr_bytes = counters->uncomp_hdr_bytes;
+	stats->comp_hdr_bytes = counters->comp_hdr_bytes;
+	for(i = 0; i < ROHC_STATS_STATES_NR; i++)
+	{
+		stats->contexts_per_state[i] = 0;
+	}
+	for(i = 0; i < ROHC_STATS_TIME_BUCKETS; i++)
+	{
+		stats->time_hist[i] = counters->time_hist[i];
+	}
+	for(i = 0; i < ROHC_STATS_RATIO_BUCKETS; i++)
+	{
+		stats->ratio_hist[i] = counters->ratio_hist[i];
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		stats->packet_types[i] = counters->packet_types[i];
+	}
+	for(i = 0; i < ROHC_STATS_STATES_NR; i++)
+	{
+		for(j = 0; j < ROHC_STATS_STATES_NR; j++)
+		{
+			stats->transitions[i][j] = counters->transitions[i][j];
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
@@ -64,6 +64,13 @@ extern "C"
 
 struct rohc_comp;
 
+/*
+ * Declare the private structure for pools of ROHC compressors that is defined
+ * inside the library.
+ */
+
+struct rohc_comp_pool;
+
 
 /*
  * Public structures and types
@@ -210,9 +217,134 @@ typedef struct
 	unsigned long uncomp_bytes_nr;
 	/** The number of compressed bytes produced by the compressor */
 	unsigned long comp_bytes_nr;
+
+	/* added in 0.1 */
+	/** The number of bytes preallocated for contexts, see
+	 *  \ref ROHC_COMP_FEATURE_CTXT_SLAB */
+	size_t ctxts_mem_reserved;
+	/** The largest number of preallocated bytes ever used by contexts */
+	size_t ctxts_mem_peak;
+
 } __attribute__((packed)) rohc_comp_general_info_t;
 
 
+/**
+ * @brief A snapshot of the detailed statistics of the compressor
+ *
+ * The structure is used by the \ref rohc_comp_get_stats_snapshot and
+ * \ref rohc_comp_get_ctxt_stats_snapshot functions to store the detailed
+ * statistics of the whole compressor or of one of its contexts. The detailed
+ * statistics are kept only if the \ref ROHC_COMP_FEATURE_STATS feature is
+ * enabled.
+ *
+ * Only the successfully compressed packets are counted. The processing time
+ * is the time spent to encode the packet and to build the ROHC packet, the
+ * parsing of the uncompressed packet and the search for the context are not
+ * included.
+ *
+ * The statistics of one context are reset when the context is (re-)created
+ * for a new flow. The statistics of the whole compressor are kept since the
+ * \ref ROHC_COMP_FEATURE_STATS feature was enabled.
+ *
+ * Versioning works as follow:
+ *  - The \e version_major field defines the compatibility level. If the major
+ *    number given by user does not match the one expected by the library,
+ *    an error is returned.
+ *  - The \e version_minor field defines the extension level. If the minor
+ *    number given by user does not match the one expected by the library,
+ *    only the fields supported in that minor version will be filled by
+ *    \ref rohc_comp_get_stats_snapshot.
+ *
+ * Notes for developers:
+ *  - Increase the major version if a field is removed.
+ *  - Increase the major version if a field is added at the beginning or in
+ *    the middle of the structure.
+ *  - Increase the minor version if a field is added at the very end of the
+ *    structure.
+ *  - The version_major and version_minor fields must be located at the very
+ *    beginning of the structure.
+ *  - The structure must be packed.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    profile_id, packets_nr, uncomp_hdr_bytes, comp_hdr_bytes,
+ *    contexts_per_state, time_hist, ratio_hist, packet_types, and
+ *    transitions.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_stats_snapshot
+ * @see rohc_comp_get_ctxt_stats_snapshot
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The profile ID of the context, \ref ROHC_PROFILE_GENERAL for the whole
+	 *  compressor or for an unused context */
+	int profile_id;
+	/** The number of packets compressed successfully */
+	uint64_t packets_nr;
+	/** The number of bytes of the uncompressed headers */
+	uint64_t uncomp_hdr_bytes;
+	/** The number of bytes of the compressed headers */
+	uint64_t comp_hdr_bytes;
+	/** The number of contexts in use in every state (indexed by
+	 *  \ref rohc_comp_state_t), at most 1 for a single context */
+	uint64_t contexts_per_state[ROHC_STATS_STATES_NR];
+	/** The log2 histogram of the processing times, see
+	 *  \ref ROHC_STATS_TIME_BUCKETS */
+	uint64_t time_hist[ROHC_STATS_TIME_BUCKETS];
+	/** The histogram of the header compression ratios, see
+	 *  \ref ROHC_STATS_RATIO_BUCKETS */
+	uint64_t ratio_hist[ROHC_STATS_RATIO_BUCKETS];
+	/** The number of ROHC packets of every type (indexed by
+	 *  \ref rohc_packet_t) */
+	uint64_t packet_types[ROHC_PACKET_MAX];
+	/** The number of transitions from one state (first index) to another
+	 *  state (second index), a transition from the unknown state is the
+	 *  creation of a context */
+	uint64_t transitions[ROHC_STATS_STATES_NR][ROHC_STATS_STATES_NR];
+
+} __attribute__((packed)) rohc_comp_stats_snapshot_t;
+
+
+/**
+ * @brief The payload of a ROHC packet or segment that was not copied
+ *
+ * The structure is used by the \ref rohc_compress_sg and
+ * \ref rohc_comp_get_segment_sg functions to describe the part of the ROHC
+ * packet or ROHC segment that was not copied in the output buffer. The full
+ * ROHC packet or ROHC segment is the concatenation of:
+ *  -# the bytes written in the output buffer,
+ *  -# the \e len bytes located at \e data,
+ *  -# the \e trailer_len bytes of \e trailer.
+ *
+ * The three parts map to three elements of a struct iovec array for writev()
+ * or sendmsg(). The \e data pointer refers to memory that the library does
+ * not own, see \ref rohc_compress_sg for its lifetime.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_sg
+ * @see rohc_comp_get_segment_sg
+ */
+typedef struct
+{
+	/** The payload bytes (not copied) */
+	const uint8_t *data;
+	/** The length of the payload (in bytes) */
+	size_t len;
+	/** The bytes to transmit after the payload (the FCS-32 CRC of the RRU
+	 *  for the last ROHC segments) */
+	uint8_t trailer[4];
+	/** The number of bytes in \e trailer */
+	size_t trailer_len;
+} rohc_comp_payload_t;
+
+
 /**
  * @brief The different features of the ROHC compressor
  *
@@ -234,6 +366,12 @@ typedef enum
 	ROHC_COMP_FEATURE_NO_IP_CHECKSUMS = (1 << 2),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_COMP_FEATURE_DUMP_PACKETS    = (1 << 3),
+	/** Preallocate the memory of all contexts (no malloc for new contexts) */
+	ROHC_COMP_FEATURE_CTXT_SLAB       = (1 << 4),
+	/** Keep detailed statistics (beware: performance impact) */
+	ROHC_COMP_FEATURE_STATS           = (1 << 5),
+	/** Always run the full detection of changes, even for steady flows */
+	ROHC_COMP_FEATURE_NO_STEADY_PATH  = (1 << 6),
 
 } rohc_comp_features_t;
 
@@ -241,10 +379,12 @@ typedef enum
 /**
  * @brief The prototype of the RTP detection callback
  *
- * User-defined function that is called by the ROHC library for every UDP
- * packet to determine whether the UDP packet transports RTP data. If the
- * function returns true, the RTP profile is used to compress the packet.
- * Otherwise the UDP profile is used.
+ * User-defined function that is called by the ROHC library for the UDP
+ * packets of unknown flows to determine whether the UDP flow transports RTP
+ * data. If the function returns true, the RTP profile is used to compress
+ * the packets of the flow. Otherwise the UDP profile is used. The result is
+ * remembered for the flow (identified by its innermost IP addresses and its
+ * UDP ports) until the flow remains idle for a while.
  *
  * The user-defined function is set by calling the function
  * \ref rohc_comp_set_rtp_detection_cb
@@ -307,6 +447,10 @@ bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
                                           void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_traces_min_level(struct rohc_comp *const comp,
+                                                const rohc_trace_level_t min_level)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_compress4(struct rohc_comp *const comp,
                                          const struct rohc_buf uncomp_packet,
                                          struct rohc_buf *const rohc_packet)
@@ -316,6 +460,25 @@ rohc_status_t ROHC_EXPORT rohc_comp_get_segment2(struct rohc_comp *const comp,
                                                  struct rohc_buf *const segment)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_compress_burst(struct rohc_comp *const comp,
+                                       const struct rohc_buf uncomp_packets[],
+                                       struct rohc_buf rohc_packets[],
+                                       rohc_status_t statuses[],
+                                       const size_t packets_nr);
+
+rohc_status_t ROHC_EXPORT rohc_compress_sg(struct rohc_comp *const comp,
+                                           const struct rohc_buf uncomp_packet,
+                                           const size_t max_len,
+                                           struct rohc_buf *const rohc_hdr,
+                                           rohc_comp_payload_t *const payload)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_comp_get_segment_sg(struct rohc_comp *const comp,
+                                                   const size_t max_len,
+                                                   struct rohc_buf *const segment,
+                                                   rohc_comp_payload_t *const payload)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
 	__attribute__((warn_unused_result));
 
@@ -361,6 +524,9 @@ bool ROHC_EXPORT rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
                                                 rohc_rtp_detection_callback_t callback,
                                                 void *const rtp_private)
 	__attribute__((warn_unused_result));
+bool ROHC_EXPORT rohc_comp_set_rtp_detection_heuristic(struct rohc_comp *const comp,
+                                                       const size_t packets_nr)
+	__attribute__((warn_unused_result));
 
 bool ROHC_EXPORT rohc_comp_set_features(struct rohc_comp *const comp,
                                         const rohc_comp_features_t features)
@@ -370,6 +536,14 @@ bool ROHC_EXPORT rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
                                              const struct rohc_buf feedback)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_feedback_queue(struct rohc_comp *const comp,
+                                              const size_t slots_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_queue_feedback(struct rohc_comp *const comp,
+                                          const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions that configure robustness to packet
@@ -405,6 +579,65 @@ bool ROHC_EXPORT rohc_comp_get_last_packet_info2(const struct rohc_comp *const c
 const char * ROHC_EXPORT rohc_comp_get_state_descr(const rohc_comp_state_t state)
 	__attribute__((warn_unused_result, const));
 
+bool ROHC_EXPORT rohc_comp_get_stats_snapshot(const struct rohc_comp *const comp,
+                                              rohc_comp_stats_snapshot_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_ctxt_stats_snapshot(const struct rohc_comp *const comp,
+                                                   const rohc_cid_t cid,
+                                                   rohc_comp_stats_snapshot_t *const stats)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_comp_export_contexts(const struct rohc_comp *const comp,
+                                                    struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_import_contexts(struct rohc_comp *const comp,
+                                           const struct rohc_buf snapshot)
+	__attribute__((warn_unused_result));
+
+
+
+/*
+ * Prototypes of public functions related to pools of ROHC compressors
+ */
+
+struct rohc_comp_pool * ROHC_EXPORT rohc_comp_pool_new(const rohc_cid_type_t cid_type,
+                                                       const rohc_cid_t max_cid,
+                                                       const size_t shards_nr,
+                                                       const rohc_comp_random_cb_t rand_cb,
+                                                       void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_pool_free(struct rohc_comp_pool *const pool);
+
+size_t ROHC_EXPORT rohc_comp_pool_get_shards_nr(const struct rohc_comp_pool *const pool)
+	__attribute__((warn_unused_result));
+
+struct rohc_comp * ROHC_EXPORT rohc_comp_pool_get_shard(const struct rohc_comp_pool *const pool,
+                                                        const size_t shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_pool_get_packet_shard(const struct rohc_comp_pool *const pool,
+                                                 const struct rohc_buf uncomp_packet,
+                                                 size_t *const shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_pool_get_feedback_shard(const struct rohc_comp_pool *const pool,
+                                                   const struct rohc_buf feedback,
+                                                   size_t *const shard_idx,
+                                                   size_t *const feedback_len)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_comp_pool_compress(struct rohc_comp_pool *const pool,
+                                                  const struct rohc_buf uncomp_packet,
+                                                  struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_pool_deliver_feedback2(struct rohc_comp_pool *const pool,
+                                                  const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
@@ -33,7 +33,11 @@
 #include "rohc_comp.h"
 #include "schemes/comp_wlsb.h"
 #include "net_pkt.h"
+#include "protocols/ip_numbers.h"
 #include "feedback.h"
+#include "crc.h"
+#include "rohc_slab.h"
+#include "rohc_stats_internal.h"
 
 #ifdef __KERNEL__
 #  include <linux/types.h>
@@ -94,10 +98,8 @@
 #define rohc_comp_dump_buf(context, descr, buf, buf_len) \
 	do { \
 		if(((context)->compressor->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0) { \
-			rohc_dump_buf((context)->compressor->trace_callback, \
-			              (context)->compressor->trace_callback_priv, \
-			              ROHC_TRACE_COMP, ROHC_TRACE_DEBUG, \
-			              descr, buf, buf_len); \
+			rohc_dump_buf((context)->compressor, ROHC_TRACE_COMP, \
+			              ROHC_TRACE_DEBUG, descr, buf, buf_len); \
 		} \
 	} while(0)
 
@@ -115,56 +117,261 @@ struct rohc_comp_ctxt;
  */
 
 
+/** The value of \ref rohc_comp_ctxt_slot::cid for a free slot */
+#define ROHC_COMP_CTXT_SLOT_FREE  0xffffffffU
+
 /**
- * @brief The ROHC compressor
+ * @brief One slot in the hash table of compression contexts
+ *
+ * The hash table uses open addressing with linear probing. The flow hash is
+ * stored in the slot so that contexts of other flows are not even read while
+ * probing.
  */
-struct rohc_comp
+struct rohc_comp_ctxt_slot
 {
-	/** The medium associated with the decompressor */
-	struct rohc_medium medium;
+	uint32_t hash;  /**< The flow hash of the context stored in the slot */
+	uint32_t cid;   /**< The CID of the context, or ROHC_COMP_CTXT_SLOT_FREE */
+};
 
-	/** Enabled/disabled features for the compressor */
-	rohc_comp_features_t features;
 
-	/** The array of compression contexts that use the compressor */
-	struct rohc_comp_ctxt *contexts;
-	/** The number of compression contexts in use in the array */
-	size_t num_contexts_used;
+/** The IP versions the compression profiles are dispatched on: IPv4, IPv6,
+ *  or anything else (unknown or malformed IP headers) */
+#define ROHC_COMP_DISPATCH_IP_VERSIONS  3U
 
-	/** Which profiles are enabled and with one are not? */
-	bool enabled_profiles[C_NUM_PROFILES];
+/** The number of IP headers the compression profiles are dispatched on */
+#define ROHC_COMP_DISPATCH_IP_HDRS  2U
 
+/** The number of packet types the compression profiles are dispatched on:
+ *  IP version of the innermost IP header, number of IP headers and protocol
+ *  transported by the innermost IP header */
+#define ROHC_COMP_DISPATCH_KEYS_NR \
+	(ROHC_COMP_DISPATCH_IP_VERSIONS * ROHC_COMP_DISPATCH_IP_HDRS * \
+	 (ROHC_IPPROTO_MAX + 1U))
 
-	/* CRC-related variables: */
+/** The number of packets without any packet of a flow after which the flow
+ *  is forgotten by the cache of profiles and the cache of RTP detection */
+#define ROHC_COMP_FLOWS_MAX_IDLE  65536U
 
-	/** The table to enable fast CRC-3 computation */
-	uint8_t crc_table_3[256];
-	/** The table to enable fast CRC-7 computation */
-	uint8_t crc_table_7[256];
-	/** The table to enable fast CRC-8 computation */
-	uint8_t crc_table_8[256];
+/**
+ * @brief The key of one flow in the cache of profiles
+ *
+ * The unused addresses and the padding are zeroed, so that keys may be
+ * compared with memcmp().
+ */
+struct rohc_comp_profile_cache_key
+{
+	/** The source and destination addresses of the IP headers, outer first */
+	uint32_t saddrs[ROHC_COMP_DISPATCH_IP_HDRS][4];
+	uint32_t daddrs[ROHC_COMP_DISPATCH_IP_HDRS][4];
+	/** The first 32 bits of the transport header (ports, SPI...) if any */
+	uint32_t transport_word;
+	uint16_t dispatch_key;  /**< The packet type of the flow */
+	uint8_t outer_version;  /**< The IP version of the outer IP header */
+};
 
+/**
+ * @brief One flow in the cache of the profiles chosen for the latest flows
+ */
+struct rohc_comp_profile_cache
+{
+	struct rohc_comp_profile_cache_key key;  /**< The key of the flow */
+	uint32_t last_use;      /**< The flow clock of the last packet of the flow */
+	uint8_t profile_idx;    /**< The index of the profile plus one, 0 if the
+	                             cache entry is unused */
+};
 
-	/* segment-related variables */
 
-/** The maximal value for MRRU */
-#define ROHC_MAX_MRRU 65535
-	/** The remaining bytes of the Reconstructed Reception Unit (RRU) waiting
-	 *  to be split into segments */
-	uint8_t rru[ROHC_MAX_MRRU];
-	/** The offset of the remaining bytes in the RRU buffer */
-	size_t rru_off;
-	/** The number of the remaining bytes in the RRU buffer */
-	size_t rru_len;
+/** The number of UDP flows in one set of the cache of RTP detection: the
+ *  cache is set-associative, the least recently used flow of a set is
+ *  replaced by new flows */
+#define ROHC_COMP_RTP_FLOWS_WAYS  4U
+
+/** The states of one UDP flow in the cache of RTP detection */
+typedef enum
+{
+	ROHC_COMP_RTP_FLOW_FREE    = 0, /**< The cache entry is unused */
+	ROHC_COMP_RTP_FLOW_PROBING = 1, /**< The RTP heuristic is running */
+	ROHC_COMP_RTP_FLOW_RTP     = 2, /**< The flow was detected as RTP */
+	ROHC_COMP_RTP_FLOW_NOT_RTP = 3, /**< The flow was detected as not RTP */
+} rohc_comp_rtp_flow_state_t;
 
+/**
+ * @brief One UDP flow in the cache of RTP detection
+ *
+ * The flow is identified by the addresses of the innermost IP header and by
+ * the UDP ports. The RTP fields are those of the last packet of the flow,
+ * they are used by the RTP heuristic only. The flows that are compressed by
+ * RTP contexts are never replaced nor forgotten, so that they are never
+ * classified again while their contexts live.
+ */
+struct rohc_comp_rtp_flow
+{
+	uint32_t saddr[4];       /**< The innermost IP source address */
+	uint32_t daddr[4];       /**< The innermost IP destination address */
+	uint32_t ports;          /**< The UDP source and destination ports */
+	uint32_t last_use;       /**< The flow clock of the last packet of the flow */
+	uint32_t ssrc;           /**< The RTP SSRC of the last packet */
+	uint32_t ts;             /**< The RTP TS of the last packet */
+	uint16_t sn;             /**< The RTP SN of the last packet */
+	uint8_t ip_version;      /**< The innermost IP version */
+	uint8_t state;           /**< The state of the flow, see
+	                              \ref rohc_comp_rtp_flow_state_t */
+	size_t probes_nr;        /**< The number of consecutive packets that look
+	                              like RTP packets */
+	size_t ctxts_nr;         /**< The number of RTP contexts that compress
+	                              the flow */
+};
 
-	/* variables related to RTP detection */
+
+/** The largest number of slots of the queue of feedback items */
+#define ROHC_COMP_FEEDBACK_QUEUE_MAX  4096U
+
+/** The largest length of the data of one feedback item, CID included: the
+ *  Size field of the feedback header is 8-bit long */
+#define ROHC_COMP_FEEDBACK_DATA_MAX  255U
+
+/** The length of one CPU cache line, the indexes of the producer and the
+ *  consumer of the queue of feedback items are kept on their own lines */
+#define ROHC_COMP_CACHE_LINE_LEN  64U
+
+/**
+ * @brief One feedback item in the queue of feedback items
+ */
+struct rohc_comp_feedback_slot
+{
+	size_t len;                                  /**< The length of the data */
+	uint8_t data[ROHC_COMP_FEEDBACK_DATA_MAX];   /**< The feedback data without
+	                                                  the feedback header */
+};
+
+/**
+ * @brief The queue of the feedback items received by another thread
+ *
+ * The queue is a single-producer/single-consumer ring: one thread enqueues
+ * feedback items with \ref rohc_comp_queue_feedback while the thread that
+ * compresses packets dequeues them. The indexes are free-running counters,
+ * every index is written by one single thread. Every thread keeps a copy of
+ * the index of the other thread, so that the shared cache line of the other
+ * thread is read only when the copy tells that the ring looks full or empty.
+ *
+ * The indexes of the producer and the indexes of the consumer start two
+ * different cache lines, so that they share their lines neither with each
+ * other nor with the fields of the compressor around the queue.
+ */
+struct rohc_comp_feedback_queue
+{
+	/** The slots of the ring, NULL if the queue is disabled */
+	struct rohc_comp_feedback_slot *slots;
+	/** The number of slots minus one (the number of slots is a power of 2) */
+	size_t mask;
+
+	/** The index of the next slot to write, written by the producer */
+	size_t head __attribute__((aligned(ROHC_COMP_CACHE_LINE_LEN)));
+	/** The copy of \e tail seen by the producer the last time */
+	size_t tail_cache;
+
+	/** The index of the next slot to read, written by the consumer */
+	size_t tail __attribute__((aligned(ROHC_COMP_CACHE_LINE_LEN)));
+	/** The copy of \e head seen by the consumer the last time */
+	size_t head_cache;
+} __attribute__((aligned(ROHC_COMP_CACHE_LINE_LEN)));
+
+
+/** The maximal number of packets that \ref rohc_compress_burst parses and
+ *  looks up together */
+#define ROHC_COMP_BURST_MAX  32U
+
+
+/** The maximum number of objects a profile allocates for one context */
+#define ROHC_COMP_CTXT_OBJS_MAX  2U
+
+/** The maximum number of W-LSB windows a profile creates for one context */
+#define ROHC_COMP_CTXT_WLSBS_MAX  10U
+
+/** The width of a W-LSB window that follows the width configured with
+ *  \ref rohc_comp_set_wlsb_window_width */
+#define ROHC_COMP_WLSB_WIDTH_CONF  SIZE_MAX
+
+/**
+ * @brief One packet of the burst being compressed by rohc_compress_burst()
+ */
+struct rohc_comp_burst_pkt
+{
+	/** The parsed uncompressed packet */
+	struct net_pkt pkt;
+	/** The profile to compress the packet with, NULL if the packet cannot
+	 *  be compressed */
+	const struct rohc_comp_profile *profile;
+	/** The flow hash of the packet for its profile */
+	uint32_t flow_hash;
+};
+
+
+/**
+ * @brief The ROHC compressor
+ */
+struct rohc_comp
+{
+	/* variables used for every packet: they are grouped at the beginning of
+	 * the structure so that they share as few cache lines as possible */
+
+	/** The medium associated with the decompressor */
+	struct rohc_medium medium;
+
+	/** Enabled/disabled features for the compressor */
+	rohc_comp_features_t features;
+
+	/** The hash table that indexes the contexts in use by flow */
+	struct rohc_comp_ctxt_slot *ctxts_hash;
+	/** The mask to apply on a flow hash to get a slot of the hash table */
+	size_t ctxts_hash_mask;
+	/** The last context used by the compressor */
+	struct rohc_comp_ctxt *last_context;
+	/** The least recently used context, the first one to be recycled */
+	struct rohc_comp_ctxt *lru_first;
+	/** The most recently used context */
+	struct rohc_comp_ctxt *lru_last;
+	/** The number of compression contexts in use in the array */
+	size_t num_contexts_used;
+
+	/** The callback function used to manage traces */
+	rohc_trace_callback2_t trace_callback;
+	/** The private context of the callback function used to manage traces */
+	void *trace_callback_priv;
+	/** The minimum level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 
 	/** The callback function used to detect RTP packet */
 	rohc_rtp_detection_callback_t rtp_callback;
 	/** Pointer to an external memory area provided/used by the callback user */
 	void *rtp_private;
+	/** The number of consecutive RTP-like packets required by the built-in
+	 *  RTP heuristic to detect a RTP flow, 0 if the heuristic is disabled */
+	size_t rtp_heuristic_pkts_nr;
+	/** The cache of the RTP detection results for the latest UDP flows, so
+	 *  that the RTP detection is not run again for every packet: a power of
+	 *  2 of sets of \ref ROHC_COMP_RTP_FLOWS_WAYS flows, with at least
+	 *  twice as many flows as contexts */
+	struct rohc_comp_rtp_flow *rtp_flows;
+	/** The number of sets of the cache of RTP detection minus one */
+	size_t rtp_flows_mask;
+	/** The flow clock, incremented for every packet whose profile is
+	 *  determined, used to forget the idle flows */
+	uint32_t flows_clock;
 
+	/** Maximum Reconstructed Reception Unit */
+	size_t mrru;
+
+	/** The width of the W-LSB sliding window */
+	size_t wlsb_window_width;
+	/** The maximal number of packets sent in > IR states (= FO and SO
+	 *  states) before changing back the state to IR (periodic refreshes) */
+	size_t periodic_refreshes_ir_timeout;
+	/** The maximal number of packets sent in > FO states (= SO state)
+	 *  before changing back the state to FO (periodic refreshes) */
+	size_t periodic_refreshes_fo_timeout;
+	/** The number of uncompressed transmissions for list compression (L) */
+	size_t list_trans_nr;
 
 	/* some statistics about the compression process: */
 
@@ -174,9 +381,43 @@ struct rohc_comp
 	int total_uncompressed_size;
 	/** The size of all the sent compressed ROHC packets */
 	int total_compressed_size;
+	/** The detailed statistics, allocated only if the feature
+	 *  ROHC_COMP_FEATURE_STATS is enabled: the first item is for the whole
+	 *  compressor, the next ones for the contexts in the order of the array
+	 *  of contexts */
+	union rohc_stats_padded *detailed_stats;
 
-	/** The last context used by the compressor */
-	struct rohc_comp_ctxt *last_context;
+	/** Which profiles are enabled and with one are not? */
+	bool enabled_profiles[C_NUM_PROFILES];
+	/** The enabled profiles that may accept the packets of every type, one
+	 *  bit per profile index, rebuilt whenever the enabled profiles change */
+	uint8_t profiles_dispatch[ROHC_COMP_DISPATCH_KEYS_NR];
+	/** The profiles chosen for the latest flows, flushed whenever the
+	 *  enabled profiles change: a power of 2 of flows, at least twice as
+	 *  many as contexts */
+	struct rohc_comp_profile_cache *profiles_cache;
+	/** The number of flows in the cache of profiles minus one */
+	size_t profiles_cache_mask;
+
+
+	/* context-management variables used only when contexts are created or
+	 * destroyed */
+
+	/** The array of compression contexts that use the compressor */
+	struct rohc_comp_ctxt *contexts;
+	/** The first CID that the compressor uses: 0 unless the compressor is
+	 *  one shard of a \ref rohc_comp_pool */
+	rohc_cid_t first_cid;
+	/** The number of CIDs that the compressor uses, from \e first_cid,
+	 *  ie. the number of contexts in the array */
+	size_t contexts_nr;
+	/** The stack of unused CIDs, the next CID to use is on top */
+	rohc_cid_t *free_cids;
+	/** The number of unused CIDs in the stack */
+	size_t free_cids_nr;
+	/** The memory preallocated for the contexts if the feature
+	 *  ROHC_COMP_FEATURE_CTXT_SLAB is enabled, empty otherwise */
+	struct rohc_slab ctxt_slab;
 
 
 	/* random callback */
@@ -186,28 +427,49 @@ struct rohc_comp
 	/** Private data that will be given to the callback for random numbers */
 	void *random_cb_ctxt;
 
-
-	/* user interaction variables: */
-
-	/** The width of the W-LSB sliding window */
-	size_t wlsb_window_width;
-	/** The maximal number of packets sent in > IR states (= FO and SO
-	 *  states) before changing back the state to IR (periodic refreshes) */
-	size_t periodic_refreshes_ir_timeout;
-	/** The maximal number of packets sent in > FO states (= SO state)
-	 *  before changing back the state to FO (periodic refreshes) */
-	size_t periodic_refreshes_fo_timeout;
-	/** Maximum Reconstructed Reception Unit */
-	size_t mrru;
 	/** The connection type (currently not used) */
 	int connection_type;
-	/** The number of uncompressed transmissions for list compression (L) */
-	size_t list_trans_nr;
 
-	/** The callback function used to manage traces */
-	rohc_trace_callback2_t trace_callback;
-	/** The private context of the callback function used to manage traces */
-	void *trace_callback_priv;
+
+	/* segment-related variables */
+
+/** The maximal value for MRRU */
+#define ROHC_MAX_MRRU 65535
+	/** The ROHC header of the Reconstructed Reception Unit (RRU) waiting
+	 *  to be split into segments, followed by its payload if the payload
+	 *  was copied. The buffer is MRRU-byte long, it is allocated only
+	 *  when segmentation is enabled with \ref rohc_comp_set_mrru */
+	uint8_t *rru;
+	/** The length of the ROHC header stored at the beginning of the RRU
+	 *  buffer */
+	size_t rru_hdr_len;
+	/** The payload of the RRU: either in the RRU buffer right after the ROHC
+	 *  header, or in the uncompressed packet given by the user */
+	const uint8_t *rru_payload;
+	/** The length of the payload of the RRU */
+	size_t rru_payload_len;
+	/** The FCS-32 CRC of the RRU */
+	uint8_t rru_crc[CRC_FCS32_LEN];
+	/** The offset of the remaining bytes in the RRU (header, payload and CRC
+	 *  taken as a whole) */
+	size_t rru_off;
+	/** The number of the remaining bytes in the RRU */
+	size_t rru_len;
+	/** The fastest FCS-32 implementation for the CPU, used to protect RRUs */
+	rohc_crc_fcs32_t crc_fcs32;
+
+
+	/* feedback-related variables */
+
+	/** The queue of the feedback items received by another thread */
+	struct rohc_comp_feedback_queue feedback_queue;
+
+
+	/* burst-related variables */
+
+	/** The ROHC_COMP_BURST_MAX packets of the burst being compressed,
+	 *  allocated by the first call to \ref rohc_compress_burst only */
+	struct rohc_comp_burst_pkt *burst;
 };
 
 
@@ -228,6 +490,23 @@ struct rohc_comp_profile
 	 */
 	const unsigned short protocol;
 
+	/**
+	 * @brief The sizes of the objects the profile allocates for every context
+	 *
+	 * Used to preallocate the context slab if the feature
+	 * ROHC_COMP_FEATURE_CTXT_SLAB is enabled. Unused entries are zero.
+	 */
+	const size_t ctxt_objs_sizes[ROHC_COMP_CTXT_OBJS_MAX];
+
+	/**
+	 * @brief The widths of the W-LSB windows the profile creates for every
+	 *        context
+	 *
+	 * Used to preallocate the W-LSB windows in the context slab. Unused
+	 * entries are zero, see also \ref ROHC_COMP_WLSB_WIDTH_CONF.
+	 */
+	const size_t ctxt_wlsbs_widths[ROHC_COMP_CTXT_WLSBS_MAX];
+
 	/**
 	 * @brief The handler used to create the profile-specific part of the
 	 *        compression context
@@ -246,8 +525,11 @@ struct rohc_comp_profile
 	/**
 	 * @brief The handler used to check whether an uncompressed IP packet
 	 *        fits the current profile or not
+	 *
+	 * The handler may update the classification of the flow of the packet
+	 * by the compressor (RTP detection).
 	 */
-	bool (*check_profile)(const struct rohc_comp *const comp,
+	bool (*check_profile)(struct rohc_comp *const comp,
 	                      const struct net_pkt *const packet)
 		__attribute__((warn_unused_result, nonnull(1, 2)));
 
@@ -297,6 +579,28 @@ struct rohc_comp_profile
 	                 const uint8_t *const feedback_data,
 	                 const size_t feedback_data_len)
 		__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+
+	/**
+	 * @brief The handler used to write the profile-specific part of the
+	 *        context in a snapshot, NULL if the profile cannot export contexts
+	 *
+	 * The profile-specific part shall begin with the reference headers, see
+	 * \ref rohc_comp_rfc3095_export. The handler returns \ref ROHC_STATUS_ERROR
+	 * if the context cannot be exported.
+	 */
+	rohc_status_t (*export_ctxt)(const struct rohc_comp_ctxt *const context,
+	                             struct rohc_buf *const snapshot)
+		__attribute__((warn_unused_result, nonnull(1, 2)));
+
+	/**
+	 * @brief The handler used to read the profile-specific part of the
+	 *        context from a snapshot, NULL if the profile cannot import contexts
+	 *
+	 * The context was created from the reference headers of the snapshot.
+	 */
+	bool (*import_ctxt)(struct rohc_comp_ctxt *const context,
+	                    struct rohc_buf *const snapshot)
+		__attribute__((warn_unused_result, nonnull(1, 2)));
 };
 
 
@@ -311,12 +615,19 @@ struct rohc_comp_ctxt
 	uint64_t latest_used;
 	/** The time when the context was last used (in seconds) */
 	uint64_t first_used;
+	/** The previous context in the LRU list (less recently used) */
+	struct rohc_comp_ctxt *lru_prev;
+	/** The next context in the LRU list (more recently used) */
+	struct rohc_comp_ctxt *lru_next;
 
 	/** The context unique ID (CID) */
 	rohc_cid_t cid;
 
 	/** The key to help finding the context associated with a packet */
 	rohc_ctxt_key_t key; /* may not be unique */
+	/** The hash of the flow compressed by the context (profile ID and the
+	 *  header fields that the profile compares to find a context) */
+	uint32_t flow_hash;
 
 	/** The associated compressor */
 	struct rohc_comp *compressor;
@@ -380,6 +691,17 @@ struct rohc_comp_ctxt
 };
 
 
+struct rohc_comp * rohc_comp_new_shard(const rohc_cid_type_t cid_type,
+                                       const rohc_cid_t max_cid,
+                                       const rohc_cid_t first_cid,
+                                       const size_t contexts_nr,
+                                       const rohc_comp_random_cb_t rand_cb,
+                                       void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+uint32_t rohc_comp_get_pool_flow_hash(const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
 void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
                            const rohc_mode_t new_mode)
 	__attribute__((nonnull(1)));
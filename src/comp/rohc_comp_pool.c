@@ -0,0 +1,527 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_comp_pool.c
+ * @brief  Pools of ROHC compressors that share one ROHC channel
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A pool of compressors splits the CID space of one ROHC channel between
+ * several compressors called shards. Every shard owns a contiguous range of
+ * CIDs and shares no state with the other shards, so the shards may compress
+ * packets in parallel, one thread (or CPU) per shard. The library creates no
+ * thread itself: the application dispatches the uncompressed packets and the
+ * received feedback to the shards with the classification functions of the
+ * pool, then every worker compresses the packets of its shard with the usual
+ * functions of the compression API.
+ *
+ * The ROHC packets of all the shards are sent on the same ROHC channel and
+ * are decompressed by one single decompressor.
+ */
+
+#include "rohc_comp.h"
+#include "rohc_comp_internals.h"
+#include "rohc_add_cid.h"
+#include "sdvl.h"
+#include "feedback_parse.h"
+#include "net_pkt.h"
+
+#include <stdlib.h>
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
+#  include <stdbool.h>
+#endif
+#include <assert.h>
+
+
+/** A pool of ROHC compressors that share one ROHC channel */
+struct rohc_comp_pool
+{
+	/** The type of CIDs used on the ROHC channel */
+	rohc_cid_type_t cid_type;
+	/** The largest CID used on the ROHC channel */
+	rohc_cid_t max_cid;
+	/** The number of shards in the pool */
+	size_t shards_nr;
+	/** The shards of the pool, shard #i owns the CIDs from
+	 *  i * (MAX_CID + 1) / shards_nr */
+	struct rohc_comp *shards[];
+};
+
+
+/*
+ * Prototypes of private functions
+ */
+
+static rohc_cid_t rohc_comp_pool_get_first_cid(const struct rohc_comp_pool *const pool,
+                                               const size_t shard_idx)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static size_t rohc_comp_pool_get_cid_shard(const struct rohc_comp_pool *const pool,
+                                           const rohc_cid_t cid)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+
+/*
+ * Definitions of public functions
+ */
+
+
+/**
+ * @brief Create a new pool of ROHC compressors
+ *
+ * Create a new pool of \e shards_nr ROHC compressors that share one ROHC
+ * channel with the given type of CIDs and MAX_CID. The CIDs of the channel
+ * are split in contiguous ranges of (almost) the same size, one range for
+ * every shard.
+ *
+ * The shards are created as if they were created by \ref rohc_comp_new2,
+ * they shall be configured one by one after they are retrieved with
+ * \ref rohc_comp_pool_get_shard. The shards cannot enable ROHC segmentation
+ * (see \ref rohc_comp_set_mrru) if there are several of them, because ROHC
+ * segments carry no CID.
+ *
+ * The pool itself is never modified after creation: the functions
+ * \ref rohc_comp_pool_get_packet_shard and
+ * \ref rohc_comp_pool_get_feedback_shard may be called concurrently from any
+ * thread. Every shard shall however be used by one single thread at a time.
+ *
+ * @param cid_type   The type of Context IDs (CID) of the ROHC channel
+ * @param max_cid    The maximum value for context IDs (CID) on the ROHC
+ *                   channel, see \ref rohc_comp_new2 for accepted values
+ * @param shards_nr  The number of shards of the pool, in range
+ *                   [1, \e max_cid + 1]
+ * @param rand_cb    The random callback to set on every shard
+ * @param rand_priv  Private data that will be given to the callback, may be
+ *                   used as a context by user
+ * @return           The created pool if successful,
+ *                   NULL if creation failed
+ *
+ * @warning Don't forget to free pool memory with \ref rohc_comp_pool_free
+ *          if \e rohc_comp_pool_new succeeded
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_pool_free
+ * @see rohc_comp_pool_get_shard
+ */
+struct rohc_comp_pool * rohc_comp_pool_new(const rohc_cid_type_t cid_type,
+                                           const rohc_cid_t max_cid,
+                                           const size_t shards_nr,
+                                           const rohc_comp_random_cb_t rand_cb,
+                                           void *const rand_priv)
+{
+	struct rohc_comp_pool *pool;
+	size_t i;
+
+	/* check the number of shards, other parameters are checked by shards */
+	if(shards_nr == 0 || shards_nr > (max_cid + 1))
+	{
+		goto error;
+	}
+
+	pool = malloc(sizeof(struct rohc_comp_pool) +
+	              shards_nr * sizeof(struct rohc_comp *));
+	if(pool == NULL)
+	{
+		goto error;
+	}
+	pool->cid_type = cid_type;
+	pool->max_cid = max_cid;
+	pool->shards_nr = shards_nr;
+
+	/* create one compressor for every range of CIDs */
+	for(i = 0; i < shards_nr; i++)
+	{
+		const rohc_cid_t first_cid = rohc_comp_pool_get_first_cid(pool, i);
+		const rohc_cid_t next_first_cid = rohc_comp_pool_get_first_cid(pool, i + 1);
+
+		assert(next_first_cid > first_cid);
+		pool->shards[i] = rohc_comp_new_shard(cid_type, max_cid, first_cid,
+		                                      next_first_cid - first_cid,
+		                                      rand_cb, rand_priv);
+		if(pool->shards[i] == NULL)
+		{
+			goto free_shards;
+		}
+	}
+
+	return pool;
+
+free_shards:
+	while(i > 0)
+	{
+		i--;
+		rohc_comp_free(pool->shards[i]);
+	}
+	free(pool);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given pool of ROHC compressors
+ *
+ * Destroy the given pool of ROHC compressors and all its shards.
+ *
+ * @param pool  The pool of ROHC compressors to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_pool_new
+ */
+void rohc_comp_pool_free(struct rohc_comp_pool *const pool)
+{
+	if(pool != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < pool->shards_nr; i++)
+		{
+			rohc_comp_free(pool->shards[i]);
+		}
+		free(pool);
+	}
+}
+
+
+/**
+ * @brief Get the number of shards of the given pool of ROHC compressors
+ *
+ * @param pool  The pool of ROHC compressors
+ * @return      The number of shards, 0 if the pool is not valid
+ *
+ * @ingroup rohc_comp
+ */
+size_t rohc_comp_pool_get_shards_nr(const struct rohc_comp_pool *const pool)
+{
+	if(pool == NULL)
+	{
+		return 0;
+	}
+	return pool->shards_nr;
+}
+
+
+/**
+ * @brief Get one shard of the given pool of ROHC compressors
+ *
+ * The shard is a ROHC compressor that may be configured and used with all
+ * the functions of the compression API, except \ref rohc_comp_free. It only
+ * creates contexts with the CIDs of its range.
+ *
+ * @param pool       The pool of ROHC compressors
+ * @param shard_idx  The index of the shard, in range [0, shards_nr - 1]
+ * @return           The shard, NULL if the pool or the index is not valid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_pool_get_packet_shard
+ * @see rohc_comp_pool_get_feedback_shard
+ */
+struct rohc_comp * rohc_comp_pool_get_shard(const struct rohc_comp_pool *const pool,
+                                            const size_t shard_idx)
+{
+	if(pool == NULL || shard_idx >= pool->shards_nr)
+	{
+		return NULL;
+	}
+	return pool->shards[shard_idx];
+}
+
+
+/**
+ * @brief Get the shard that shall compress the given uncompressed packet
+ *
+ * All the packets of one flow are given to the same shard, so that the flow
+ * is compressed with one single context. The shard is determined from the
+ * IP addresses of all the IP headers, and from the ports (or SPI) of the
+ * UDP, UDP-Lite, TCP and ESP transport headers. Packets that cannot be
+ * parsed are given to the first shard.
+ *
+ * The function does not modify the pool, it may be called concurrently from
+ * any thread.
+ *
+ * @param pool             The pool of ROHC compressors
+ * @param uncomp_packet    The uncompressed packet to classify
+ * @param[out] shard_idx   The index of the shard that shall compress the
+ *                         packet
+ * @return                 true if the shard was found,
+ *                         false if one parameter is not valid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_pool_get_shard
+ */
+bool rohc_comp_pool_get_packet_shard(const struct rohc_comp_pool *const pool,
+                                     const struct rohc_buf uncomp_packet,
+                                     size_t *const shard_idx)
+{
+	struct net_pkt ip_pkt;
+
+	if(pool == NULL || shard_idx == NULL ||
+	   rohc_buf_is_malformed(uncomp_packet) || rohc_buf_is_empty(uncomp_packet))
+	{
+		goto error;
+	}
+
+	if(pool->shards_nr == 1 ||
+	   !net_pkt_parse(&ip_pkt, uncomp_packet, NULL, NULL, ROHC_TRACE_ERROR,
+	                  ROHC_TRACE_COMP))
+	{
+		*shard_idx = 0;
+	}
+	else
+	{
+		const uint32_t hash = rohc_comp_get_pool_flow_hash(&ip_pkt);
+		*shard_idx = (((uint64_t) hash) * pool->shards_nr) >> 32;
+	}
+	assert((*shard_idx) < pool->shards_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the shard that shall handle the given feedback
+ *
+ * Only the first feedback item of the given feedback data is classified:
+ * the shard is the one that owns the CID of the feedback item. The length of
+ * the feedback item is returned, so that the next feedback items may be
+ * classified too.
+ *
+ * The function does not modify the pool, it may be called concurrently from
+ * any thread.
+ *
+ * @param pool               The pool of ROHC compressors
+ * @param feedback           The feedback data, as received by
+ *                           \ref rohc_comp_deliver_feedback2
+ * @param[out] shard_idx     The index of the shard that shall handle the
+ *                           first feedback item
+ * @param[out] feedback_len  The length of the first feedback item
+ * @return                   true if the shard was found,
+ *                           false if the feedback is malformed or if its CID
+ *                           is not valid for the ROHC channel
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_pool_deliver_feedback2
+ */
+bool rohc_comp_pool_get_feedback_shard(const struct rohc_comp_pool *const pool,
+                                       const struct rohc_buf feedback,
+                                       size_t *const shard_idx,
+                                       size_t *const feedback_len)
+{
+	size_t feedback_hdr_len;
+	size_t feedback_data_len;
+	const uint8_t *feedback_data;
+	rohc_cid_t cid;
+
+	if(pool == NULL || shard_idx == NULL || feedback_len == NULL ||
+	   rohc_buf_is_malformed(feedback) || rohc_buf_is_empty(feedback))
+	{
+		goto error;
+	}
+
+	/* parse the feedback header */
+	if(!rohc_packet_is_feedback(rohc_buf_byte(feedback)) ||
+	   !rohc_feedback_get_size(feedback, &feedback_hdr_len, &feedback_data_len) ||
+	   (feedback_hdr_len + feedback_data_len) > feedback.len)
+	{
+		goto error;
+	}
+	feedback_data = rohc_buf_data_at(feedback, feedback_hdr_len);
+
+	/* decode the CID of the feedback data */
+	if(pool->cid_type == ROHC_LARGE_CID)
+	{
+		size_t large_cid_bits_nr;
+		uint32_t large_cid;
+		size_t large_cid_size;
+
+		large_cid_size = sdvl_decode(feedback_data, feedback_data_len,
+		                             &large_cid, &large_cid_bits_nr);
+		if(large_cid_size != 1 && large_cid_size != 2)
+		{
+			goto error;
+		}
+		cid = large_cid;
+	}
+	else
+	{
+		cid = rohc_add_cid_decode(feedback_data, feedback_data_len);
+		if(cid == UINT8_MAX)
+		{
+			cid = 0;
+		}
+	}
+	if(cid > pool->max_cid)
+	{
+		goto error;
+	}
+
+	*shard_idx = rohc_comp_pool_get_cid_shard(pool, cid);
+	*feedback_len = feedback_hdr_len + feedback_data_len;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet with the right shard
+ *
+ * The function is a convenience for applications that use the pool from one
+ * single thread: it classifies the packet with
+ * \ref rohc_comp_pool_get_packet_shard, then compresses it with
+ * \ref rohc_compress4 on the right shard. Multi-threaded applications shall
+ * classify the packets themselves, then give them to the worker of the shard.
+ *
+ * @param pool               The pool of ROHC compressors
+ * @param uncomp_packet      The uncompressed packet to compress
+ * @param[out] rohc_packet   The resulting compressed ROHC packet
+ * @return                   See \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ */
+rohc_status_t rohc_comp_pool_compress(struct rohc_comp_pool *const pool,
+                                      const struct rohc_buf uncomp_packet,
+                                      struct rohc_buf *const rohc_packet)
+{
+	size_t shard_idx;
+
+	if(!rohc_comp_pool_get_packet_shard(pool, uncomp_packet, &shard_idx))
+	{
+		return ROHC_STATUS_ERROR;
+	}
+
+	return rohc_compress4(pool->shards[shard_idx], uncomp_packet, rohc_packet);
+}
+
+
+/**
+ * @brief Deliver feedback to the right shards
+ *
+ * The function is a convenience for applications that use the pool from one
+ * single thread: every feedback item is delivered with
+ * \ref rohc_comp_deliver_feedback2 to the shard that owns its CID.
+ * Multi-threaded applications shall classify the feedback items themselves
+ * with \ref rohc_comp_pool_get_feedback_shard, then give them to the worker
+ * of the shard.
+ *
+ * @param pool      The pool of ROHC compressors
+ * @param feedback  The feedback data
+ * @return          true if all the feedback items were successfully taken
+ *                  into account, false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_pool_deliver_feedback2(struct rohc_comp_pool *const pool,
+                                      const struct rohc_buf feedback)
+{
+	struct rohc_buf remain_data = feedback;
+	size_t nr_failures = 0;
+
+	if(pool == NULL || rohc_buf_is_malformed(feedback))
+	{
+		goto error;
+	}
+
+	/* split the feedback items, give every one to its shard */
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		struct rohc_buf feedback_item = remain_data;
+		size_t feedback_len;
+		size_t shard_idx;
+
+		if(!rohc_comp_pool_get_feedback_shard(pool, remain_data, &shard_idx,
+		                                      &feedback_len))
+		{
+			goto error;
+		}
+
+		feedback_item.len = feedback_len;
+		if(!rohc_comp_deliver_feedback2(pool->shards[shard_idx], feedback_item))
+		{
+			nr_failures++;
+		}
+		rohc_buf_pull(&remain_data, feedback_len);
+	}
+
+	return (nr_failures == 0);
+
+error:
+	return false;
+}
+
+
+/*
+ * Definitions of private functions
+ */
+
+
+/**
+ * @brief Get the first CID owned by the given shard
+ *
+ * @param pool       The pool of ROHC compressors
+ * @param shard_idx  The index of the shard, in range [0, shards_nr]
+ * @return           The first CID of the shard, MAX_CID + 1 for the index
+ *                   shards_nr
+ */
+static rohc_cid_t rohc_comp_pool_get_first_cid(const struct rohc_comp_pool *const pool,
+                                               const size_t shard_idx)
+{
+	const size_t cids_nr = pool->max_cid + 1;
+
+	assert(shard_idx <= pool->shards_nr);
+	return (shard_idx * cids_nr) / pool->shards_nr;
+}
+
+
+/**
+ * @brief Get the shard that owns the given CID
+ *
+ * The shard is the largest index i such as i * (MAX_CID + 1) / shards_nr
+ * is lower than or equal to the CID.
+ *
+ * @param pool  The pool of ROHC compressors
+ * @param cid   The CID, in range [0, MAX_CID]
+ * @return      The index of the shard that owns the CID
+ */
+static size_t rohc_comp_pool_get_cid_shard(const struct rohc_comp_pool *const pool,
+                                           const rohc_cid_t cid)
+{
+	const size_t cids_nr = pool->max_cid + 1;
+	const size_t shard_idx = ((cid + 1) * pool->shards_nr - 1) / cids_nr;
+
+	assert(cid <= pool->max_cid);
+	assert(shard_idx < pool->shards_nr);
+	assert(rohc_comp_pool_get_first_cid(pool, shard_idx) <= cid);
+	assert(rohc_comp_pool_get_first_cid(pool, shard_idx + 1) > cid);
+
+	return shard_idx;
+}
+
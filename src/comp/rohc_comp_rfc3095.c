@@ -39,6 +39,7 @@
 #include "schemes/cid.h"
 #include "schemes/ip_id_offset.h"
 #include "schemes/comp_list_ipv6.h"
+#include "rohc_snapshot.h"
 #include "sdvl.h"
 #include "crc.h"
 
@@ -77,14 +78,23 @@
 
 static bool ip_header_info_new(struct ip_header_info *const header_info,
                                const struct ip_packet *const ip,
+                               struct rohc_slab *const slab,
                                const size_t list_trans_nr,
                                const size_t wlsb_window_width,
                                rohc_trace_callback2_t trace_cb,
                                void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_min_level,
                                const int profile_id)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void ip_header_info_free(struct ip_header_info *const header_info,
+                                struct rohc_slab *const slab)
+	__attribute__((nonnull(1, 2)));
+static bool ip_header_info_export(const struct ip_header_info *const header_info,
+                                  struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool ip_header_info_import(struct ip_header_info *const header_info,
+                                  struct rohc_buf *const snapshot)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
-static void ip_header_info_free(struct ip_header_info *const header_info)
-	__attribute__((nonnull(1)));
 
 static void c_init_tmp_variables(struct generic_tmp_vars *const tmp_vars);
 
@@ -309,12 +319,11 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
                          int counter)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 7)));
 
-static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
+static uint8_t compute_uo_crc(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt,
                               const struct net_pkt *const uncomp_pkt,
                               const rohc_crc_type_t crc_type,
-                              const uint8_t crc_init,
-                              const uint8_t *const crc_table)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                              const uint8_t crc_init)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static void update_context(struct rohc_comp_ctxt *const context,
                            const struct net_pkt *const uncomp_pkt)
@@ -324,8 +333,23 @@ static void update_context_ip_hdr(struct ip_header_info *const ip_flags,
 	__attribute__((nonnull(1, 2)));
 
 static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const context,
-                                             const struct net_pkt *const uncomp_pkt)
+                                             const struct net_pkt *const uncomp_pkt,
+                                             const bool ip_id_detected)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_comp_rfc3095_detect_steady(struct rohc_comp_ctxt *const context,
+                                            const struct net_pkt *const uncomp_pkt,
+                                            bool *const ip_id_detected)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool is_ip_hdr_steady(const struct ip_header_info *const header_info,
+                             const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+static bool is_uo0_steady(const struct rohc_comp_ctxt *const context,
+                          const struct net_pkt *const uncomp_pkt)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+static bool is_ip_id_steady(const struct ip_header_info *const header_info,
+                             const struct ip_packet *const ip,
+                             const uint32_t sn)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 static int changed_static_both_hdr(struct rohc_comp_ctxt *const context,
                                    const struct net_pkt *const uncomp_pkt)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -348,6 +372,10 @@ static unsigned short detect_changed_fields(const struct rohc_comp_ctxt *const c
 static bool is_field_changed(const unsigned short changed_fields,
                              const unsigned short check_field)
 	__attribute__((warn_unused_result, const));
+static bool is_ip_crc_static_changed(const struct ip_header_info *const header_info,
+                                     const unsigned short changed_fields,
+                                     const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(1, 3), pure));
 static void detect_ip_id_behaviours(struct rohc_comp_ctxt *const context,
                                     const struct net_pkt *const uncomp_pkt)
 	__attribute__((nonnull(1, 2)));
@@ -418,21 +446,25 @@ static bool is_field_changed(const unsigned short changed_fields,
  *
  * @param header_info        The IP header info to initialize
  * @param ip                 The IP header
+ * @param slab               The slab to allocate the IP-ID window from
  * @param list_trans_nr      The number of uncompressed transmissions for
  *                           list compression (L)
  * @param wlsb_window_width  The width of the W-LSB sliding window for IPv4
  *                           IP-ID (must be > 0)
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_min_level    The minimum level of the traces to print
  * @param profile_id         The ID of the associated compression profile
  * @return                   true if successful, false otherwise
  */
 static bool ip_header_info_new(struct ip_header_info *const header_info,
                                const struct ip_packet *const ip,
+                               struct rohc_slab *const slab,
                                const size_t list_trans_nr,
                                const size_t wlsb_window_width,
                                rohc_trace_callback2_t trace_cb,
                                void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_min_level,
                                const int profile_id)
 {
 	assert(header_info != NULL);
@@ -449,14 +481,21 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 	/* version specific initialization */
 	if(header_info->version == IPV4)
 	{
+		/* keep the header the context was created from, it is the previous
+		 * header of a context imported from a snapshot */
+		header_info->info.v4.old_ip = *(ipv4_get_header(ip));
+
 		/* init the parameters to encode the IP-ID with W-LSB encoding */
 		header_info->info.v4.ip_id_window =
-			c_create_wlsb(16, wlsb_window_width, ROHC_LSB_SHIFT_IP_ID);
+			c_create_wlsb(slab, 16, wlsb_window_width, ROHC_LSB_SHIFT_IP_ID);
 		if(header_info->info.v4.ip_id_window == NULL)
 		{
-			__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_ERROR,
-			             ROHC_TRACE_COMP, profile_id,
-			             "no memory to allocate W-LSB encoding for IP-ID");
+			if(ROHC_TRACE_ERROR >= trace_min_level)
+			{
+				__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_ERROR,
+				             ROHC_TRACE_COMP, profile_id,
+				             "no memory to allocate W-LSB encoding for IP-ID");
+			}
 			goto error;
 		}
 
@@ -472,9 +511,15 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 	}
 	else
 	{
+		/* keep the header the context was created from, it is the previous
+		 * header of a context imported from a snapshot */
+		header_info->info.v6.old_ip = *(ipv6_get_header(ip));
+		header_info->info.v6.old_ip.nh = ip_get_protocol(ip);
+
 		/* init the compression context for IPv6 extension header list */
 		rohc_comp_list_ipv6_new(&header_info->info.v6.ext_comp, list_trans_nr,
-		                        trace_cb, trace_cb_priv, profile_id);
+		                        trace_cb, trace_cb_priv, trace_min_level,
+		                        profile_id);
 	}
 
 	return true;
@@ -488,13 +533,15 @@ error:
  * @brief Reset the given IP header info
  *
  * @param header_info  The IP header info to reset
+ * @param slab         The slab the IP-ID window was allocated from
  */
-static void ip_header_info_free(struct ip_header_info *const header_info)
+static void ip_header_info_free(struct ip_header_info *const header_info,
+                                struct rohc_slab *const slab)
 {
 	if(header_info->version == IPV4)
 	{
 		/* IPv4: destroy the W-LSB context for the IP-ID offset */
-		c_destroy_wlsb(header_info->info.v4.ip_id_window);
+		c_destroy_wlsb(slab, header_info->info.v4.ip_id_window);
 	}
 	else
 	{
@@ -504,6 +551,124 @@ static void ip_header_info_free(struct ip_header_info *const header_info)
 }
 
 
+/**
+ * @brief Write the dynamic state of the given IP header info in a snapshot
+ *
+ * The state of an IPv6 header contains the state of the compression of its
+ * list of extension headers.
+ *
+ * @param header_info  The IP header info
+ * @param snapshot     The snapshot to write to
+ * @return             true if successful, false if the snapshot is too small
+ */
+static bool ip_header_info_export(const struct ip_header_info *const header_info,
+                                  struct rohc_buf *const snapshot)
+{
+	const struct ipv4_header_info *const v4 = &header_info->info.v4;
+
+	if(!rohc_snapshot_put32(snapshot, header_info->tos_count) ||
+	   !rohc_snapshot_put32(snapshot, header_info->ttl_count) ||
+	   !rohc_snapshot_put32(snapshot, header_info->protocol_count))
+	{
+		return false;
+	}
+	if(header_info->version == IPV6)
+	{
+		return rohc_comp_list_export(&header_info->info.v6.ext_comp, snapshot);
+	}
+
+	return (rohc_snapshot_put32(snapshot, v4->df_count) &&
+	        rohc_snapshot_put32(snapshot, v4->rnd_count) &&
+	        rohc_snapshot_put32(snapshot, v4->nbo_count) &&
+	        rohc_snapshot_put32(snapshot, v4->sid_count) &&
+	        rohc_snapshot_put8(snapshot, v4->rnd) &&
+	        rohc_snapshot_put8(snapshot, v4->nbo) &&
+	        rohc_snapshot_put8(snapshot, v4->sid) &&
+	        rohc_snapshot_put8(snapshot, v4->old_rnd) &&
+	        rohc_snapshot_put8(snapshot, v4->old_nbo) &&
+	        rohc_snapshot_put8(snapshot, v4->old_sid) &&
+	        rohc_snapshot_put16(snapshot, v4->id_delta) &&
+	        c_wlsb_export(v4->ip_id_window, snapshot));
+}
+
+
+/**
+ * @brief Read the dynamic state of the given IP header info from a snapshot
+ *
+ * The previous IP header was already initialized from the reference headers
+ * of the snapshot when the context was created.
+ *
+ * @param header_info  The IP header info
+ * @param snapshot     The snapshot to read from
+ * @return             true if successful, false if the snapshot is malformed
+ */
+static bool ip_header_info_import(struct ip_header_info *const header_info,
+                                  struct rohc_buf *const snapshot)
+{
+	struct ipv4_header_info *const v4 = &header_info->info.v4;
+	uint32_t counts[7];
+	uint8_t flags[6];
+	size_t i;
+
+	for(i = 0; i < 3; i++)
+	{
+		if(!rohc_snapshot_get32(snapshot, &counts[i]))
+		{
+			return false;
+		}
+	}
+	header_info->tos_count = counts[0];
+	header_info->ttl_count = counts[1];
+	header_info->protocol_count = counts[2];
+
+	if(header_info->version == IPV6)
+	{
+		if(!rohc_comp_list_import(&header_info->info.v6.ext_comp, snapshot))
+		{
+			return false;
+		}
+		header_info->is_first_header = false;
+		return true;
+	}
+
+	for(i = 3; i < 7; i++)
+	{
+		if(!rohc_snapshot_get32(snapshot, &counts[i]))
+		{
+			return false;
+		}
+	}
+	for(i = 0; i < 6; i++)
+	{
+		if(!rohc_snapshot_get8(snapshot, &flags[i]) || flags[i] > 1)
+		{
+			return false;
+		}
+	}
+	if(!rohc_snapshot_get16(snapshot, &v4->id_delta) ||
+	   !c_wlsb_import(v4->ip_id_window, snapshot))
+	{
+		return false;
+	}
+
+	v4->df_count = counts[3];
+	v4->rnd_count = counts[4];
+	v4->nbo_count = counts[5];
+	v4->sid_count = counts[6];
+	v4->rnd = flags[0];
+	v4->nbo = flags[1];
+	v4->sid = flags[2];
+	v4->old_rnd = flags[3];
+	v4->old_nbo = flags[4];
+	v4->old_sid = flags[5];
+
+	/* the previous IP header is known */
+	header_info->is_first_header = false;
+
+	return true;
+}
+
+
 /**
  * @brief Initialize all temporary variables stored in the context.
  *
@@ -548,7 +713,8 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "new generic context required for a new stream");
 
 	/* allocate memory for the generic part of the context */
-	rfc3095_ctxt = malloc(sizeof(struct rohc_comp_rfc3095_ctxt));
+	rfc3095_ctxt = rohc_slab_malloc(&context->compressor->ctxt_slab,
+	                                sizeof(struct rohc_comp_rfc3095_ctxt));
 	if(rfc3095_ctxt == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -570,7 +736,8 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "use shift parameter %d for LSB-encoding of SN",
 	                sn_shift);
 	rfc3095_ctxt->sn_window =
-		c_create_wlsb(16, context->compressor->wlsb_window_width, sn_shift);
+		c_create_wlsb(&context->compressor->ctxt_slab, 16,
+		              context->compressor->wlsb_window_width, sn_shift);
 	if(rfc3095_ctxt->sn_window == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -581,10 +748,12 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	/* step 3 */
 	if(!ip_header_info_new(&rfc3095_ctxt->outer_ip_flags,
 	                       &packet->outer_ip,
+	                       &context->compressor->ctxt_slab,
 	                       context->compressor->list_trans_nr,
 	                       context->compressor->wlsb_window_width,
 	                       context->compressor->trace_callback,
 	                       context->compressor->trace_callback_priv,
+	                       context->compressor->trace_min_level,
 	                       context->profile->id))
 	{
 		goto free_sn_window;
@@ -593,10 +762,12 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	{
 		if(!ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
 		                       &packet->inner_ip,
+		                       &context->compressor->ctxt_slab,
 		                       context->compressor->list_trans_nr,
 		                       context->compressor->wlsb_window_width,
 		                       context->compressor->trace_callback,
 		                       context->compressor->trace_callback_priv,
+		                       context->compressor->trace_min_level,
 		                       context->profile->id))
 		{
 			goto free_header_info;
@@ -631,11 +802,12 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	return true;
 
 free_header_info:
-	ip_header_info_free(&rfc3095_ctxt->outer_ip_flags);
+	ip_header_info_free(&rfc3095_ctxt->outer_ip_flags,
+	                    &context->compressor->ctxt_slab);
 free_sn_window:
-	c_destroy_wlsb(rfc3095_ctxt->sn_window);
+	c_destroy_wlsb(&context->compressor->ctxt_slab, rfc3095_ctxt->sn_window);
 free_generic_context:
-	free(rfc3095_ctxt);
+	rohc_slab_free(&context->compressor->ctxt_slab, rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -654,15 +826,166 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 
-	ip_header_info_free(&rfc3095_ctxt->outer_ip_flags);
+	ip_header_info_free(&rfc3095_ctxt->outer_ip_flags,
+	                    &context->compressor->ctxt_slab);
 	if(rfc3095_ctxt->ip_hdr_nr > 1)
 	{
-		ip_header_info_free(&rfc3095_ctxt->inner_ip_flags);
+		ip_header_info_free(&rfc3095_ctxt->inner_ip_flags,
+		                    &context->compressor->ctxt_slab);
+	}
+	c_destroy_wlsb(&context->compressor->ctxt_slab, rfc3095_ctxt->sn_window);
+
+	rohc_slab_zfree(&context->compressor->ctxt_slab, rfc3095_ctxt->specific);
+	rohc_slab_free(&context->compressor->ctxt_slab, rfc3095_ctxt);
+}
+
+
+/**
+ * @brief Write the generic part of the given context in a snapshot
+ *
+ * The record begins with the reference headers, ie. the previous IP headers
+ * followed by the given next header: the compressor that imports the
+ * snapshot creates the context from them as if they were a packet. The
+ * dynamic state of the context follows. Profiles append their own state
+ * after the generic part.
+ *
+ * The reference IPv6 headers carry no extension header: the lists of
+ * extension headers are restored from the dynamic state of the context.
+ *
+ * @param context          The compression context to export
+ * @param next_header      The previous next header (UDP, ESP...), if any
+ * @param next_header_len  The length (in bytes) of the previous next header
+ * @param snapshot         The snapshot to write to
+ * @return                 \ref ROHC_STATUS_OK if the context was exported,
+ *                         \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the snapshot
+ *                         is too small,
+ *                         \ref ROHC_STATUS_ERROR if the context cannot be
+ *                         exported
+ */
+rohc_status_t rohc_comp_rfc3095_export(const struct rohc_comp_ctxt *const context,
+                                       const uint8_t *const next_header,
+                                       const size_t next_header_len,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct ip_header_info *ip_flags[2];
+	size_t ref_hdrs_len;
+	size_t remain_len;
+	size_t i;
+
+	ip_flags[0] = &rfc3095_ctxt->outer_ip_flags;
+	ip_flags[1] = &rfc3095_ctxt->inner_ip_flags;
+	ref_hdrs_len = next_header_len;
+	for(i = 0; i < rfc3095_ctxt->ip_hdr_nr; i++)
+	{
+		if(ip_flags[i]->is_first_header)
+		{
+			rohc_comp_debug(context, "cannot export context that compressed "
+			                "no packet yet");
+			return ROHC_STATUS_ERROR;
+		}
+		if(ip_flags[i]->version == IPV4)
+		{
+			ref_hdrs_len += sizeof(struct ipv4_hdr);
+		}
+		else
+		{
+			ref_hdrs_len += sizeof(struct ipv6_hdr);
+		}
 	}
-	c_destroy_wlsb(rfc3095_ctxt->sn_window);
 
-	zfree(rfc3095_ctxt->specific);
-	free(rfc3095_ctxt);
+	/* the reference headers with their lengths fixed for the parsing */
+	if(!rohc_snapshot_put16(snapshot, ref_hdrs_len))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	remain_len = ref_hdrs_len;
+	for(i = 0; i < rfc3095_ctxt->ip_hdr_nr; i++)
+	{
+		if(ip_flags[i]->version == IPV4)
+		{
+			struct ipv4_hdr ref_ip = ip_flags[i]->info.v4.old_ip;
+			ref_ip.tot_len = rohc_hton16(remain_len);
+			ref_ip.check = 0;
+			ref_ip.check = ip_fast_csum((uint8_t *) &ref_ip, ref_ip.ihl);
+			if(!rohc_snapshot_put(snapshot, &ref_ip, sizeof(struct ipv4_hdr)))
+			{
+				return ROHC_STATUS_OUTPUT_TOO_SMALL;
+			}
+			remain_len -= sizeof(struct ipv4_hdr);
+		}
+		else
+		{
+			struct ipv6_hdr ref_ip = ip_flags[i]->info.v6.old_ip;
+			remain_len -= sizeof(struct ipv6_hdr);
+			ref_ip.plen = rohc_hton16(remain_len);
+			if(!rohc_snapshot_put(snapshot, &ref_ip, sizeof(struct ipv6_hdr)))
+			{
+				return ROHC_STATUS_OUTPUT_TOO_SMALL;
+			}
+		}
+	}
+	if(next_header_len > 0 &&
+	   !rohc_snapshot_put(snapshot, next_header, next_header_len))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	/* the dynamic state */
+	if(!rohc_snapshot_put32(snapshot, rfc3095_ctxt->sn) ||
+	   !c_wlsb_export(rfc3095_ctxt->sn_window, snapshot))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	for(i = 0; i < rfc3095_ctxt->ip_hdr_nr; i++)
+	{
+		if(!ip_header_info_export(ip_flags[i], snapshot))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the generic part of the given context from a snapshot
+ *
+ * The context was created from the reference headers of the snapshot, they
+ * are already pulled from the snapshot.
+ *
+ * @param context   The compression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool rohc_comp_rfc3095_import(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
+	if(!rohc_snapshot_get32(snapshot, &rfc3095_ctxt->sn) ||
+	   !c_wlsb_import(rfc3095_ctxt->sn_window, snapshot))
+	{
+		rohc_comp_warn(context, "malformed SN in snapshot");
+		goto error;
+	}
+	if(!ip_header_info_import(&rfc3095_ctxt->outer_ip_flags, snapshot))
+	{
+		rohc_comp_warn(context, "malformed outer IP header in snapshot");
+		goto error;
+	}
+	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	   !ip_header_info_import(&rfc3095_ctxt->inner_ip_flags, snapshot))
+	{
+		rohc_comp_warn(context, "malformed inner IP header in snapshot");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -690,7 +1013,7 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
  *                  \li false if the IP packet does not correspond to
  *                      the profile
  */
-bool rohc_comp_rfc3095_check_profile(const struct rohc_comp *const comp,
+bool rohc_comp_rfc3095_check_profile(struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
 {
 	ip_version version;
@@ -831,6 +1154,7 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
                              size_t *const payload_offset)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
+	bool ip_id_detected = false;
 	int size;
 
 	assert(context != NULL);
@@ -840,8 +1164,18 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->tmp.nr_ip_id_bits2 = 0;
 	rfc3095_ctxt->tmp.packet_type = ROHC_PACKET_UNKNOWN;
 
-	/* detect changes between new uncompressed packet and context */
-	if(!rohc_comp_rfc3095_detect_changes(context, uncomp_pkt))
+	/* detect changes between new uncompressed packet and context: a few
+	 * compares are enough if the profile found the packet in the steady
+	 * state of the flow, the full detection is run otherwise (without
+	 * detecting the IP-ID behaviours again if the few compares did it) */
+	if(rfc3095_ctxt->tmp.is_steady &&
+	   !rohc_comp_rfc3095_detect_steady(context, uncomp_pkt, &ip_id_detected))
+	{
+		rohc_comp_debug(context, "IP headers are not in the steady state");
+		rfc3095_ctxt->tmp.is_steady = false;
+	}
+	if(!rfc3095_ctxt->tmp.is_steady &&
+	   !rohc_comp_rfc3095_detect_changes(context, uncomp_pkt, ip_id_detected))
 	{
 		rohc_comp_warn(context, "failed to detect changes in uncompressed packet");
 		goto error;
@@ -855,7 +1189,14 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 		rohc_comp_periodic_down_transition(context);
 	}
 
-	/* compute how many bits are needed to send header fields */
+	/* once the W-LSB windows only contain values of UO-0 packets sent in the
+	 * steady state, UO-0 is enough again: the field values advanced by the
+	 * same steps as for the previous packet, so the numbers of bits required
+	 * by the windows did not change */
+	rfc3095_ctxt->tmp.is_uo0_steady = is_uo0_steady(context, uncomp_pkt);
+
+	/* compute how many bits are needed to send header fields, or only update
+	 * the W-LSB windows in the steady state */
 	if(!encode_uncomp_fields(context, uncomp_pkt))
 	{
 		rohc_comp_warn(context, "failed to compute how many bits are needed "
@@ -863,15 +1204,36 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	/* decide which packet to send */
-	rfc3095_ctxt->tmp.packet_type = decide_packet(context);
-
-	/* code the ROHC header (and the extension if needed) */
-	size = code_packet(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len);
+	/* decide which packet to send, then code the ROHC header (and the
+	 * extension if needed) */
+	if(rfc3095_ctxt->tmp.is_uo0_steady)
+	{
+		rohc_comp_debug(context, "choose packet UO-0 because the W-LSB windows "
+		                "are filled with the steady state of the flow");
+		context->so_count++;
+		rfc3095_ctxt->tmp.packet_type = ROHC_PACKET_UO_0;
+		size = code_UO0_packet(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len);
+	}
+	else
+	{
+		rfc3095_ctxt->tmp.packet_type = decide_packet(context);
+		size = code_packet(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len);
+	}
 	if(size < 0)
 	{
 		goto error;
 	}
+
+	/* count the UO-0 packets sent in the steady state of the flow */
+	if(!rfc3095_ctxt->tmp.is_steady ||
+	   rfc3095_ctxt->tmp.packet_type != ROHC_PACKET_UO_0)
+	{
+		rfc3095_ctxt->steady_uo0_nr = 0;
+	}
+	else if(rfc3095_ctxt->steady_uo0_nr < context->compressor->wlsb_window_width)
+	{
+		rfc3095_ctxt->steady_uo0_nr++;
+	}
 	/* determine the offset of the payload */
 	*payload_offset = net_pkt_get_payload_offset(uncomp_pkt);
 	*payload_offset += rfc3095_ctxt->next_header_len;
@@ -1172,6 +1534,10 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 			acked_nr = wlsb_ack(rfc3095_ctxt->sn_window, sn_bits, sn_bits_nr);
 			rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 			                "from SN W-LSB", acked_nr);
+
+			/* the W-LSB windows no longer match the UO-0 packets sent in the
+			 * steady state of the flow */
+			rfc3095_ctxt->steady_uo0_nr = 0;
 		}
 	}
 
@@ -1224,13 +1590,16 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 /**
  * @brief Detect changes between packet and context
  *
- * @param context     The compression context to compare
- * @param uncomp_pkt  The uncompressed packet to compare
- * @return            true if changes were successfully detected,
- *                    false if a problem occurred
+ * @param context         The compression context to compare
+ * @param uncomp_pkt      The uncompressed packet to compare
+ * @param ip_id_detected  Whether the IP-ID behaviours of the packet were
+ *                        already detected in the steady state
+ * @return                true if changes were successfully detected,
+ *                        false if a problem occurred
  */
 static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const context,
-                                             const struct net_pkt *const uncomp_pkt)
+                                             const struct net_pkt *const uncomp_pkt,
+                                             const bool ip_id_detected)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
@@ -1244,15 +1613,18 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 	 * headers changed */
 	if(uncomp_pkt->ip_hdr_nr != rfc3095_ctxt->ip_hdr_nr)
 	{
+		rfc3095_ctxt->tmp.crc_static_changed = true;
 		if(uncomp_pkt->ip_hdr_nr > 1)
 		{
 			rohc_comp_debug(context, "packet got one more IP header than context");
 			if(!ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
 			                       &uncomp_pkt->inner_ip,
+			                       &context->compressor->ctxt_slab,
 			                       context->compressor->list_trans_nr,
 			                       context->compressor->wlsb_window_width,
 			                       context->compressor->trace_callback,
 			                       context->compressor->trace_callback_priv,
+			                       context->compressor->trace_min_level,
 			                       context->profile->id))
 			{
 				goto error;
@@ -1261,13 +1633,17 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 		else
 		{
 			rohc_comp_debug(context, "packet got one less IP header than context");
-			ip_header_info_free(&rfc3095_ctxt->inner_ip_flags);
+			ip_header_info_free(&rfc3095_ctxt->inner_ip_flags,
+			                    &context->compressor->ctxt_slab);
 		}
 		rfc3095_ctxt->ip_hdr_nr = uncomp_pkt->ip_hdr_nr;
 	}
 
 	/* check NBO and RND of the IP-ID of the IP headers (IPv4 only) */
-	detect_ip_id_behaviours(context, uncomp_pkt);
+	if(!ip_id_detected)
+	{
+		detect_ip_id_behaviours(context, uncomp_pkt);
+	}
 
 	/* find outer IP fields that changed */
 	rfc3095_ctxt->tmp.changed_fields =
@@ -1294,6 +1670,19 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 		}
 	}
 
+	/* did the CRC-STATIC fields of the IP headers change? */
+	if(is_ip_crc_static_changed(&rfc3095_ctxt->outer_ip_flags,
+	                            rfc3095_ctxt->tmp.changed_fields,
+	                            &uncomp_pkt->outer_ip) ||
+	   (uncomp_pkt->ip_hdr_nr > 1 &&
+	    is_ip_crc_static_changed(&rfc3095_ctxt->inner_ip_flags,
+	                             rfc3095_ctxt->tmp.changed_fields2,
+	                             &uncomp_pkt->inner_ip)))
+	{
+		rohc_comp_debug(context, "CRC-STATIC fields of IP headers changed");
+		rfc3095_ctxt->tmp.crc_static_changed = true;
+	}
+
 	/* how many changed fields are static ones? */
 	rfc3095_ctxt->tmp.send_static = changed_static_both_hdr(context, uncomp_pkt);
 
@@ -1309,6 +1698,189 @@ error:
 }
 
 
+/**
+ * @brief Detect changes between packet and context in the steady state
+ *
+ * The profile found that only the SN and the fields that follow it advanced
+ * since the previous packet. The IP headers are checked with a few compares
+ * instead of the full detection of changes: the IP fields shall not change
+ * and the IP-ID behaviours shall stay the same. IPv6 headers are never in the
+ * steady state, since their extension headers are tracked by the list
+ * compression.
+ *
+ * Once enough UO-0 packets were sent in the steady state, the numbers of SN,
+ * TS and IP-ID bits are not computed any more, see \ref is_uo0_steady.
+ *
+ * @param context              The compression context to compare
+ * @param uncomp_pkt           The uncompressed packet to compare
+ * @param[out] ip_id_detected  Whether the IP-ID behaviours of the packet were
+ *                             detected, so that the full detection of changes
+ *                             does not detect them again
+ * @return                     true if the IP headers are in the steady state,
+ *                             false if the full detection is required
+ */
+static bool rohc_comp_rfc3095_detect_steady(struct rohc_comp_ctxt *const context,
+                                            const struct net_pkt *const uncomp_pkt,
+                                            bool *const ip_id_detected)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
+		(struct rohc_comp_rfc3095_ctxt *) context->specific;
+
+	/* the IP fields shall not change */
+	if(uncomp_pkt->ip_hdr_nr != rfc3095_ctxt->ip_hdr_nr ||
+	   !is_ip_hdr_steady(&rfc3095_ctxt->outer_ip_flags, &uncomp_pkt->outer_ip))
+	{
+		goto not_steady;
+	}
+	if(uncomp_pkt->ip_hdr_nr > 1 &&
+	   !is_ip_hdr_steady(&rfc3095_ctxt->inner_ip_flags, &uncomp_pkt->inner_ip))
+	{
+		goto not_steady;
+	}
+
+	/* the IP-ID behaviours shall not change */
+	detect_ip_id_behaviours(context, uncomp_pkt);
+	*ip_id_detected = true;
+	if(rfc3095_ctxt->outer_ip_flags.info.v4.rnd != rfc3095_ctxt->outer_ip_flags.info.v4.old_rnd ||
+	   rfc3095_ctxt->outer_ip_flags.info.v4.nbo != rfc3095_ctxt->outer_ip_flags.info.v4.old_nbo ||
+	   rfc3095_ctxt->outer_ip_flags.info.v4.sid != rfc3095_ctxt->outer_ip_flags.info.v4.old_sid)
+	{
+		goto not_steady;
+	}
+	if(uncomp_pkt->ip_hdr_nr > 1 &&
+	   (rfc3095_ctxt->inner_ip_flags.info.v4.rnd != rfc3095_ctxt->inner_ip_flags.info.v4.old_rnd ||
+	    rfc3095_ctxt->inner_ip_flags.info.v4.nbo != rfc3095_ctxt->inner_ip_flags.info.v4.old_nbo ||
+	    rfc3095_ctxt->inner_ip_flags.info.v4.sid != rfc3095_ctxt->inner_ip_flags.info.v4.old_sid))
+	{
+		goto not_steady;
+	}
+
+	/* compute or find the new SN */
+	assert(rfc3095_ctxt->get_next_sn != NULL);
+	rfc3095_ctxt->sn = rfc3095_ctxt->get_next_sn(context, uncomp_pkt);
+	rohc_comp_debug(context, "SN = %u (steady state)", rfc3095_ctxt->sn);
+
+	/* no IP field changed, but some of them might have changed in the last
+	 * few packets and shall still be transmitted */
+	rfc3095_ctxt->tmp.changed_fields = 0;
+	rfc3095_ctxt->tmp.changed_fields2 = 0;
+	rfc3095_ctxt->tmp.send_static = changed_static_both_hdr(context, uncomp_pkt);
+	rfc3095_ctxt->tmp.send_dynamic = changed_dynamic_both_hdr(context, uncomp_pkt);
+
+	return true;
+
+not_steady:
+	return false;
+}
+
+
+/**
+ * @brief Check whether one IP header is in the steady state
+ *
+ * The IPv4 header shall be a non-fragmented header without options with the
+ * same TOS, TTL, DF and Protocol fields as the previous header. The IPv4
+ * addresses are already known to be the same.
+ *
+ * @param header_info  The header info stored in the context
+ * @param ip           The IP header to check
+ * @return             true if the IP header is in the steady state,
+ *                     false otherwise
+ */
+static bool is_ip_hdr_steady(const struct ip_header_info *const header_info,
+                             const struct ip_packet *const ip)
+{
+	const struct ipv4_hdr *ipv4;
+	const struct ipv4_hdr *old_ipv4;
+
+	if(header_info->is_first_header ||
+	   header_info->version != IPV4 ||
+	   ip_get_version(ip) != IPV4)
+	{
+		return false;
+	}
+	ipv4 = ipv4_get_header(ip);
+	old_ipv4 = &header_info->info.v4.old_ip;
+
+	return (ipv4->ihl == 5 && old_ipv4->ihl == 5 &&
+	        ipv4->tos == old_ipv4->tos &&
+	        ipv4->frag_off == old_ipv4->frag_off &&
+	        (ipv4->frag_off & rohc_hton16(IPV4_MF | IPV4_OFFMASK)) == 0 &&
+	        ipv4->ttl == old_ipv4->ttl &&
+	        ipv4->protocol == old_ipv4->protocol);
+}
+
+
+/**
+ * @brief Check whether UO-0 is enough for the packet without computing the
+ *        numbers of SN, TS and IP-ID bits
+ *
+ * The packet shall be in the steady state of the flow, and the W-LSB windows
+ * shall only contain values of the previous UO-0 packets sent in the steady
+ * state, ie. SNs and TS_SCALED values that advanced by 1 and IP-ID offsets
+ * that stayed the same. The windows then require the same numbers of bits as
+ * for the previous packet, provided that the IP-ID offsets of the packet did
+ * not change either. The acknowledgements that remove values from the windows
+ * restart the count of UO-0 packets.
+ *
+ * @param context     The compression context
+ * @param uncomp_pkt  The uncompressed packet to encode
+ * @return            true if UO-0 is enough for the packet,
+ *                    false if the numbers of bits shall be computed
+ */
+static bool is_uo0_steady(const struct rohc_comp_ctxt *const context,
+                          const struct net_pkt *const uncomp_pkt)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
+		(struct rohc_comp_rfc3095_ctxt *) context->specific;
+
+	if(!rfc3095_ctxt->tmp.is_steady ||
+	   context->state != ROHC_COMP_STATE_SO ||
+	   rfc3095_ctxt->steady_uo0_nr < context->compressor->wlsb_window_width)
+	{
+		return false;
+	}
+
+	/* the IP headers are IPv4 headers in the steady state */
+	if(!is_ip_id_steady(&rfc3095_ctxt->outer_ip_flags, &uncomp_pkt->outer_ip,
+	                    rfc3095_ctxt->sn))
+	{
+		return false;
+	}
+	if(uncomp_pkt->ip_hdr_nr > 1 &&
+	   !is_ip_id_steady(&rfc3095_ctxt->inner_ip_flags, &uncomp_pkt->inner_ip,
+	                    rfc3095_ctxt->sn))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Check whether the IP-ID offset of one IPv4 header stayed the same
+ *
+ * Random and constant IP-IDs are never transmitted as offsets, so their
+ * offsets may change.
+ *
+ * @param header_info  The header info stored in the context
+ * @param ip           The IPv4 header to check
+ * @param sn           The SN of the packet
+ * @return             true if the IP-ID offset stayed the same,
+ *                     false otherwise
+ */
+static bool is_ip_id_steady(const struct ip_header_info *const header_info,
+                             const struct ip_packet *const ip,
+                             const uint32_t sn)
+{
+	const uint16_t id_delta =
+		rohc_ntoh16(ipv4_get_id_nbo(ip, header_info->info.v4.nbo)) - sn;
+
+	return (header_info->info.v4.rnd || header_info->info.v4.sid ||
+	        id_delta == header_info->info.v4.id_delta);
+}
+
+
 /**
  * @brief Decide the state that should be used for the next packet.
  *
@@ -1782,8 +2354,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 
 	/* part 5 */
 	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                       CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	                                       CRC_INIT_8);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -1926,8 +2497,7 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 
 	/* part 5 */
 	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                       CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	                                       CRC_INIT_8);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -2660,8 +3230,7 @@ static int code_UO0_packet(struct rohc_comp_ctxt *const context,
 	 * if the CRC-STATIC fields did not change */
 	assert(rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 <= 4);
 	f_byte = (rfc3095_ctxt->sn & 0x0f) << 3;
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3);
 	f_byte |= crc;
 	rohc_comp_debug(context, "first byte = 0x%02x (CRC = 0x%x)", f_byte, crc);
 	rohc_pkt[first_position] = f_byte;
@@ -2803,8 +3372,7 @@ static int rohc_comp_rfc3095_build_uo1_pkt(struct rohc_comp_ctxt *const context,
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3);
 	rohc_pkt[counter] = ((rfc3095_ctxt->sn & 0x1f) << 3) | (crc & 0x07);
 	rohc_comp_debug(context, "SN (%d) + CRC (%x) = 0x%02x",
 	                rfc3095_ctxt->sn, crc, rohc_pkt[counter]);
@@ -2940,8 +3508,7 @@ static int rohc_comp_rfc3095_build_uo1rtp_pkt(struct rohc_comp_ctxt *const conte
 	}
 	rohc_pkt[counter] = ((!!rtp_context->tmp.is_marker_bit_set) & 0x01) << 7;
 	rohc_pkt[counter] |= (rfc3095_ctxt->sn & 0x0f) << 3;
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3);
 	rohc_pkt[counter] |= crc & 0x07;
 	rohc_comp_debug(context, "M (%d) + SN (%d) + CRC (%x) = 0x%02x",
 	                !!rtp_context->tmp.is_marker_bit_set,
@@ -3088,8 +3655,7 @@ static int rohc_comp_rfc3095_build_uo1ts_pkt(struct rohc_comp_ctxt *const contex
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3);
 	rohc_pkt[counter] = ((!!rtp_context->tmp.is_marker_bit_set) & 0x01) << 7;
 	rohc_pkt[counter] |= (rfc3095_ctxt->sn & 0x0f) << 3;
 	rohc_pkt[counter] |= crc & 0x07;
@@ -3359,8 +3925,7 @@ static int rohc_comp_rfc3095_build_uo1id_pkt(struct rohc_comp_ctxt *const contex
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3);
 	s_byte = crc & 0x07;
 	switch(extension)
 	{
@@ -3646,8 +4211,7 @@ static int code_UO2_packet(struct rohc_comp_ctxt *const context,
 	 *
 	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
 	 * if the CRC-STATIC fields did not change */
-	t_byte = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_7, CRC_INIT_7,
-	                        context->compressor->crc_table_7);
+	t_byte = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_7, CRC_INIT_7);
 	t_byte_position = counter;
 	counter++;
 
@@ -6004,19 +6568,17 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
  * @param uncomp_pkt  The uncompressed packet to encode
  * @param crc_type    The type of CRC to compute
  * @param crc_init    The initial value of the CRC
- * @param crc_table   The table of pre-computed CRC
  * @return            The computed CRC
  */
-static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
+static uint8_t compute_uo_crc(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt,
                               const struct net_pkt *const uncomp_pkt,
                               const rohc_crc_type_t crc_type,
-                              const uint8_t crc_init,
-                              const uint8_t *const crc_table)
+                              const uint8_t crc_init)
 {
 	const uint8_t *outer_ip_hdr;
 	const uint8_t *inner_ip_hdr;
 	const uint8_t *next_header;
-	uint8_t crc = crc_init;
+	uint8_t crc;
 
 	outer_ip_hdr = ip_get_raw_data(&uncomp_pkt->outer_ip);
 	if(uncomp_pkt->ip_hdr_nr > 1)
@@ -6029,13 +6591,25 @@ static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
 	}
 	next_header = uncomp_pkt->transport->data;
 
-	/* compute CRC on CRC-STATIC fields */
-	crc = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr, next_header,
-	                                       crc_type, crc, crc_table);
+	/* compute CRC on CRC-STATIC fields: they seldom change, so the CRC is
+	 * retrieved from the cache of the context most of the time */
+	if(rfc3095_ctxt->tmp.crc_static_changed)
+	{
+		crc = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
+		                                       next_header, crc_type, crc_init);
+	}
+	else if(!crc_static_cache_get(&rfc3095_ctxt->crc_static_cache, crc_type,
+	                              crc_init, &crc))
+	{
+		crc = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
+		                                       next_header, crc_type, crc_init);
+		crc_static_cache_set(&rfc3095_ctxt->crc_static_cache, crc_type,
+		                     crc_init, crc);
+	}
 
 	/* compute CRC on CRC-DYNAMIC fields */
 	crc = rfc3095_ctxt->compute_crc_dynamic(outer_ip_hdr, inner_ip_hdr, next_header,
-	                                        crc_type, crc, crc_table);
+	                                        crc_type, crc);
 
 	return crc;
 }
@@ -6053,6 +6627,13 @@ static void update_context(struct rohc_comp_ctxt *const context,
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 
+	/* the CRC computed on the former CRC-STATIC fields is useless now */
+	if(rfc3095_ctxt->tmp.crc_static_changed)
+	{
+		crc_static_cache_reset(&rfc3095_ctxt->crc_static_cache);
+		rfc3095_ctxt->tmp.crc_static_changed = false;
+	}
+
 	/* update the context with the new headers */
 	update_context_ip_hdr(&rfc3095_ctxt->outer_ip_flags,
 	                      &uncomp_pkt->outer_ip);
@@ -6488,6 +7069,52 @@ error:
 }
 
 
+/**
+ * @brief Check whether the CRC-STATIC fields of one IP header changed
+ *
+ * The CRC-STATIC fields are the TOS/TC, TTL/HL and Protocol/Next Header
+ * fields, the IPv6 extension headers and the IPv4 DF bit, in addition to the
+ * fields that identify the context (addresses, IPv6 flow label).
+ *
+ * @param header_info     The header info stored in the context
+ * @param changed_fields  The fields that changed, see detect_changed_fields
+ * @param ip              The header of the new IP packet
+ * @return                true if one of the CRC-STATIC fields changed,
+ *                        false otherwise
+ */
+static bool is_ip_crc_static_changed(const struct ip_header_info *const header_info,
+                                     const unsigned short changed_fields,
+                                     const struct ip_packet *const ip)
+{
+	const unsigned short crc_static_fields =
+		MOD_TOS | MOD_TTL | MOD_PROTOCOL |
+		MOD_IPV6_EXT_LIST_STRUCT | MOD_IPV6_EXT_LIST_CONTENT;
+
+	if(header_info->is_first_header ||
+	   header_info->version != ip_get_version(ip) ||
+	   is_field_changed(changed_fields, crc_static_fields))
+	{
+		return true;
+	}
+
+	if(ip_get_version(ip) == IPV4)
+	{
+		const struct ipv4_hdr *const ipv4 = ipv4_get_header(ip);
+		const struct ipv4_hdr *const old_ipv4 = &header_info->info.v4.old_ip;
+
+		return (ipv4->ihl != old_ipv4->ihl ||
+		        ipv4->frag_off != old_ipv4->frag_off);
+	}
+	else
+	{
+		const struct ipv6_hdr *const ipv6 = ipv6_get_header(ip);
+		const struct ipv6_hdr *const old_ipv6 = &header_info->info.v6.old_ip;
+
+		return (ipv6_get_flow_label(ipv6) != ipv6_get_flow_label(old_ipv6));
+	}
+}
+
+
 /**
  * @brief Detect the behaviour of the IP-ID fields of the IPv4 headers
  *
@@ -6653,30 +7280,40 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		rohc_comp_debug(context, "new SN = %u / 0x%x", rfc3095_ctxt->sn,
 		                rfc3095_ctxt->sn);
 
-		/* how many bits are required to encode the new SN ? */
-		if(context->profile->id == ROHC_PROFILE_RTP ||
-		   context->profile->id == ROHC_PROFILE_ESP)
+		/* how many bits are required to encode the new SN ? in the steady
+		 * state, the numbers of bits of the previous packet are kept */
+		if(rfc3095_ctxt->tmp.is_uo0_steady)
 		{
-			rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 =
-				wlsb_get_mink_32bits(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn, 5);
-			rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 =
-				wlsb_get_kp_32bits(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn, 1);
+			rohc_comp_debug(context, "SN is encoded with the UO-0 bits of the "
+			                "steady state");
 		}
 		else
 		{
-			rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 =
-				wlsb_get_k_32bits(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn);
-			rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 =
-				rfc3095_ctxt->tmp.nr_sn_bits_more_than_4;
+			if(context->profile->id == ROHC_PROFILE_RTP ||
+			   context->profile->id == ROHC_PROFILE_ESP)
+			{
+				rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 =
+					wlsb_get_mink_32bits(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn, 5);
+				rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 =
+					wlsb_get_kp_32bits(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn, 1);
+			}
+			else
+			{
+				rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 =
+					wlsb_get_k_32bits(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn);
+				rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 =
+					rfc3095_ctxt->tmp.nr_sn_bits_more_than_4;
+			}
+			rohc_comp_debug(context, "SN can%s be encoded with %zu bits in a "
+			                "field smaller than or equal to 4 bits",
+			                (rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 <= 4 ?
+			                 "" : "not"),
+			                rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4);
+			rohc_comp_debug(context, "SN can%s be encoded with %zu bits in a "
+			                "field strictly larger than 4 bits",
+			                (rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 > 4 ? "" : "not"),
+			                rfc3095_ctxt->tmp.nr_sn_bits_more_than_4);
 		}
-		rohc_comp_debug(context, "SN can%s be encoded with %zu bits in a field "
-		                "smaller than or equal to 4 bits",
-		                (rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 <= 4 ? "" : "not"),
-		                rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4);
-		rohc_comp_debug(context, "SN can%s be encoded with %zu bits in a field "
-		                "strictly larger than 4 bits",
-		                (rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 > 4 ? "" : "not"),
-		                rfc3095_ctxt->tmp.nr_sn_bits_more_than_4);
 
 		/* add the new SN to the W-LSB encoding object */
 		c_add_wlsb(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn, rfc3095_ctxt->sn);
@@ -6700,7 +7337,12 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		                rfc3095_ctxt->outer_ip_flags.info.v4.sid);
 
 		/* how many bits are required to encode the new IP-ID / SN delta ? */
-		if(rfc3095_ctxt->outer_ip_flags.info.v4.sid)
+		if(rfc3095_ctxt->tmp.is_uo0_steady)
+		{
+			rohc_comp_debug(context, "outer IP-ID is encoded with the UO-0 bits "
+			                "of the steady state");
+		}
+		else if(rfc3095_ctxt->outer_ip_flags.info.v4.sid)
 		{
 			/* IP-ID is constant, no IP-ID bit to transmit */
 			rfc3095_ctxt->tmp.nr_ip_id_bits = 0;
@@ -6746,7 +7388,12 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		                rfc3095_ctxt->inner_ip_flags.info.v4.sid);
 
 		/* how many bits are required to encode the new IP-ID / SN delta ? */
-		if(rfc3095_ctxt->inner_ip_flags.info.v4.sid)
+		if(rfc3095_ctxt->tmp.is_uo0_steady)
+		{
+			rohc_comp_debug(context, "inner IP-ID is encoded with the UO-0 bits "
+			                "of the steady state");
+		}
+		else if(rfc3095_ctxt->inner_ip_flags.info.v4.sid)
 		{
 			/* IP-ID is constant, no IP-ID bit to transmit */
 			rfc3095_ctxt->tmp.nr_ip_id_bits2 = 0;
@@ -168,6 +168,22 @@ struct generic_tmp_vars
 
 	/// The type of packet the compressor must send: IR, IR-DYN, UO*
 	rohc_packet_t packet_type;
+
+	/** Whether the packet is in the steady state of the flow, ie. only the SN
+	 *  and the fields that follow it advanced since the previous packet (set
+	 *  by the profile before \ref rohc_comp_rfc3095_encode is called) */
+	bool is_steady;
+
+	/** Whether enough UO-0 packets were sent in the steady state of the flow
+	 *  to fill the W-LSB windows, so that UO-0 is sent again without computing
+	 *  the numbers of SN, TS and IP-ID bits */
+	bool is_uo0_steady;
+
+	/** Whether one of the CRC-STATIC fields changed since the previous packet
+	 *  (set by the profile for the next header before
+	 *  \ref rohc_comp_rfc3095_encode is called, completed for the IP headers
+	 *  during the detection of changes) */
+	bool crc_static_changed;
 };
 
 
@@ -184,6 +200,9 @@ struct rohc_comp_rfc3095_ctxt
 	uint32_t sn;
 	/// A window used to encode the SN
 	struct c_wlsb *sn_window;
+	/** The number of consecutive UO-0 packets sent in the steady state of the
+	 *  flow, not counted beyond the width of the W-LSB windows */
+	size_t steady_uo0_nr;
 
 	/** The number of IP headers */
 	size_t ip_hdr_nr;
@@ -273,24 +292,39 @@ struct rohc_comp_rfc3095_ctxt
 	                              const uint8_t *const ip2,
 	                              const uint8_t *const next_header,
 	                              const rohc_crc_type_t crc_type,
-	                              const uint8_t init_val,
-	                              const uint8_t *const crc_table)
-		__attribute__((nonnull(1, 3, 6), warn_unused_result));
+	                              const uint8_t init_val)
+		__attribute__((nonnull(1, 3), warn_unused_result));
 
 	/// @brief The handler used to compute the CRC-DYNAMIC value
 	uint8_t (*compute_crc_dynamic)(const uint8_t *const ip,
 	                               const uint8_t *const ip2,
 	                               const uint8_t *const next_header,
 	                               const rohc_crc_type_t crc_type,
-	                               const uint8_t init_val,
-	                               const uint8_t *const crc_table)
-		__attribute__((nonnull(1, 3, 6), warn_unused_result));
+	                               const uint8_t init_val)
+		__attribute__((nonnull(1, 3), warn_unused_result));
+
+	/** The CRCs computed on the CRC-STATIC fields of the context */
+	struct crc_static_cache crc_static_cache;
 
 	/// Profile-specific data
 	void *specific;
 };
 
 
+/**
+ * @brief The widths of the W-LSB windows created by
+ *        \ref rohc_comp_rfc3095_create
+ *
+ * One window for the SN, one for the IP-ID of each of the two IPv4 headers.
+ * The RFC3095-based profiles list them at the beginning of their
+ * rohc_comp_profile::ctxt_wlsbs_widths, before their own windows.
+ */
+#define ROHC_COMP_RFC3095_CTXT_WLSBS \
+	ROHC_COMP_WLSB_WIDTH_CONF, \
+	ROHC_COMP_WLSB_WIDTH_CONF, \
+	ROHC_COMP_WLSB_WIDTH_CONF
+
+
 /*
  * Function prototypes.
  */
@@ -303,7 +337,16 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
-bool rohc_comp_rfc3095_check_profile(const struct rohc_comp *const comp,
+rohc_status_t rohc_comp_rfc3095_export(const struct rohc_comp_ctxt *const context,
+                                       const uint8_t *const next_header,
+                                       const size_t next_header_len,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+bool rohc_comp_rfc3095_import(struct rohc_comp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_comp_rfc3095_check_profile(struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
@@ -25,6 +25,7 @@
 
 #include "schemes/comp_list.h"
 #include "rohc_comp_internals.h"
+#include "rohc_snapshot.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -453,6 +454,101 @@ void rohc_list_update_context(struct list_comp *const comp)
 }
 
 
+/**
+ * @brief Write the state of the given list compressor in a snapshot
+ *
+ * The IDs of the reference and current lists are written first, then the
+ * translation table, then the lists that were already used.
+ *
+ * @param comp      The list compressor
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool rohc_comp_list_export(const struct list_comp *const comp,
+                           struct rohc_buf *const snapshot)
+{
+	size_t lists_nr;
+	size_t i;
+
+	if(!rohc_snapshot_put16(snapshot, comp->ref_id) ||
+	   !rohc_snapshot_put16(snapshot, comp->cur_id) ||
+	   !rohc_list_trans_table_export(comp->trans_table, snapshot))
+	{
+		return false;
+	}
+
+	lists_nr = 0;
+	for(i = 0; i <= ROHC_LIST_GEN_ID_ANON; i++)
+	{
+		if(comp->lists[i].items_nr > 0 || comp->lists[i].counter > 0)
+		{
+			lists_nr++;
+		}
+	}
+	if(!rohc_snapshot_put16(snapshot, lists_nr))
+	{
+		return false;
+	}
+	for(i = 0; i <= ROHC_LIST_GEN_ID_ANON; i++)
+	{
+		if(comp->lists[i].items_nr == 0 && comp->lists[i].counter == 0)
+		{
+			continue;
+		}
+		if(!rohc_snapshot_put16(snapshot, i) ||
+		   !rohc_list_export(&comp->lists[i], comp->trans_table, snapshot))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Read the state of the given list compressor from a snapshot
+ *
+ * @param comp      The list compressor, freshly created
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool rohc_comp_list_import(struct list_comp *const comp,
+                           struct rohc_buf *const snapshot)
+{
+	uint16_t ref_id;
+	uint16_t cur_id;
+	uint16_t lists_nr;
+	size_t i;
+
+	if(!rohc_snapshot_get16(snapshot, &ref_id) ||
+	   ref_id > ROHC_LIST_GEN_ID_NONE ||
+	   !rohc_snapshot_get16(snapshot, &cur_id) ||
+	   cur_id > ROHC_LIST_GEN_ID_NONE ||
+	   !rohc_list_trans_table_import(comp->trans_table, snapshot) ||
+	   !rohc_snapshot_get16(snapshot, &lists_nr) ||
+	   lists_nr > (ROHC_LIST_GEN_ID_ANON + 1))
+	{
+		return false;
+	}
+	for(i = 0; i < lists_nr; i++)
+	{
+		uint16_t id;
+
+		if(!rohc_snapshot_get16(snapshot, &id) ||
+		   id > ROHC_LIST_GEN_ID_ANON ||
+		   !rohc_list_import(&comp->lists[id], comp->trans_table, snapshot))
+		{
+			return false;
+		}
+	}
+	comp->ref_id = ref_id;
+	comp->cur_id = cur_id;
+
+	return true;
+}
+
+
 /**
  * @brief Search the nearest list for the packet list
  *
@@ -74,6 +74,8 @@ struct list_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 	/** The profile ID the compression list was created for */
 	int profile_id;
 };
@@ -93,5 +95,12 @@ int rohc_list_encode(struct list_comp *const comp,
 void rohc_list_update_context(struct list_comp *const comp)
 	__attribute__((nonnull(1)));
 
+bool rohc_comp_list_export(const struct list_comp *const comp,
+                           struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool rohc_comp_list_import(struct list_comp *const comp,
+                           struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
@@ -44,16 +44,18 @@ static bool cmp_ipv6_ext(const struct rohc_list_item *const item,
 /**
  * @brief Create one context for compressing lists of IPv6 extension headers
  *
- * @param comp            The context to create
- * @param list_trans_nr   The number of uncompressed transmissions (L)
- * @param trace_cb        The function to call for printing traces
- * @param trace_cb_priv   An optional private context, may be NULL
- * @param profile_id      The ID of the associated decompression profile
+ * @param comp             The context to create
+ * @param list_trans_nr    The number of uncompressed transmissions (L)
+ * @param trace_cb         The function to call for printing traces
+ * @param trace_cb_priv    An optional private context, may be NULL
+ * @param trace_min_level  The minimum level of the traces to print
+ * @param profile_id       The ID of the associated decompression profile
  */
 void rohc_comp_list_ipv6_new(struct list_comp *const comp,
                              const size_t list_trans_nr,
                              rohc_trace_callback2_t trace_cb,
                              void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_min_level,
                              const int profile_id)
 {
 	size_t i;
@@ -84,6 +86,7 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
 	/* traces */
 	comp->trace_callback = trace_cb;
 	comp->trace_callback_priv = trace_cb_priv;
+	comp->trace_min_level = trace_min_level;
 	comp->profile_id = profile_id;
 }
 
@@ -33,6 +33,7 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
                              const size_t list_trans_nr,
                              rohc_trace_callback2_t trace_cb,
                              void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_min_level,
                              const int profile_id)
 	__attribute__((nonnull(1)));
 
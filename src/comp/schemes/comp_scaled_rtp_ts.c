@@ -28,6 +28,7 @@
 #include "comp_scaled_rtp_ts.h"
 #include "sdvl.h"
 #include "rohc_traces_internal.h"
+#include "rohc_snapshot.h"
 
 #include <stdlib.h> /* for abs(3) */
 #include <assert.h>
@@ -43,17 +44,21 @@
  * @brief Create the ts_sc_comp object
  *
  * @param ts_sc              The ts_sc_comp object to create
+ * @param slab               The slab to allocate the W-LSB windows from
  * @param wlsb_window_width  The width of the W-LSB sliding window to use
  *                           for TS_STRIDE (must be > 0)
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
  *                           callback, may be NULL
+ * @param trace_min_level    The minimum level of the traces to print
  * @return                   true if creation is successful, false otherwise
  */
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
+                 struct rohc_slab *const slab,
                  const size_t wlsb_window_width,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_min_level)
 {
 	assert(ts_sc != NULL);
 	assert(wlsb_window_width > 0);
@@ -73,9 +78,10 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 
 	ts_sc->trace_callback = trace_cb;
 	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_min_level = trace_min_level;
 
 	/* W-LSB context for TS_SCALED */
-	ts_sc->ts_scaled_wlsb = c_create_wlsb(32, wlsb_window_width,
+	ts_sc->ts_scaled_wlsb = c_create_wlsb(slab, 32, wlsb_window_width,
 	                                      ROHC_LSB_SHIFT_RTP_TS);
 	if(ts_sc->ts_scaled_wlsb == NULL)
 	{
@@ -85,7 +91,7 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 	}
 
 	/* W-LSB context for unscaled TS */
-	ts_sc->ts_unscaled_wlsb = c_create_wlsb(32, wlsb_window_width,
+	ts_sc->ts_unscaled_wlsb = c_create_wlsb(slab, 32, wlsb_window_width,
 	                                        ROHC_LSB_SHIFT_RTP_TS);
 	if(ts_sc->ts_unscaled_wlsb == NULL)
 	{
@@ -97,7 +103,7 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 	return true;
 
 free_ts_scaled_wlsb:
-	c_destroy_wlsb(ts_sc->ts_scaled_wlsb);
+	c_destroy_wlsb(slab, ts_sc->ts_scaled_wlsb);
 error:
 	return false;
 }
@@ -107,14 +113,16 @@ error:
  * @brief Destroy the ts_sc_comp object
  *
  * @param ts_sc        The ts_sc_comp object to destroy
+ * @param slab         The slab the W-LSB windows were allocated from
  */
-void c_destroy_sc(struct ts_sc_comp *const ts_sc)
+void c_destroy_sc(struct ts_sc_comp *const ts_sc,
+                  struct rohc_slab *const slab)
 {
 	assert(ts_sc != NULL);
 	assert(ts_sc->ts_unscaled_wlsb != NULL);
 	assert(ts_sc->ts_scaled_wlsb != NULL);
-	c_destroy_wlsb(ts_sc->ts_unscaled_wlsb);
-	c_destroy_wlsb(ts_sc->ts_scaled_wlsb);
+	c_destroy_wlsb(slab, ts_sc->ts_unscaled_wlsb);
+	c_destroy_wlsb(slab, ts_sc->ts_scaled_wlsb);
 }
 
 
@@ -503,3 +511,75 @@ bool rohc_ts_sc_is_deducible(const struct ts_sc_comp *const ts_sc)
 	return ts_sc->is_deducible;
 }
 
+
+
+/**
+ * @brief Write the state of the scaled RTP Timestamp encoding in a snapshot
+ *
+ * @param ts_sc     The TS SCALED compression context
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool c_ts_sc_export(const struct ts_sc_comp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+{
+	return (rohc_snapshot_put32(snapshot, ts_sc->ts_stride) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->ts_scaled) &&
+	        c_wlsb_export(ts_sc->ts_scaled_wlsb, snapshot) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->ts_offset) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->ts) &&
+	        c_wlsb_export(ts_sc->ts_unscaled_wlsb, snapshot) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->old_ts) &&
+	        rohc_snapshot_put16(snapshot, ts_sc->sn) &&
+	        rohc_snapshot_put16(snapshot, ts_sc->old_sn) &&
+	        rohc_snapshot_put8(snapshot, ts_sc->is_deducible) &&
+	        rohc_snapshot_put8(snapshot, ts_sc->state) &&
+	        rohc_snapshot_put8(snapshot, ts_sc->are_old_val_init) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->nr_init_stride_packets) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->ts_delta));
+}
+
+
+/**
+ * @brief Read the state of the scaled RTP Timestamp encoding from a snapshot
+ *
+ * @param ts_sc     The TS SCALED compression context, freshly created
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool c_ts_sc_import(struct ts_sc_comp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+{
+	uint32_t nr_init_stride_packets;
+	uint8_t is_deducible;
+	uint8_t state;
+	uint8_t are_old_val_init;
+
+	if(!rohc_snapshot_get32(snapshot, &ts_sc->ts_stride) ||
+	   !rohc_snapshot_get32(snapshot, &ts_sc->ts_scaled) ||
+	   !c_wlsb_import(ts_sc->ts_scaled_wlsb, snapshot) ||
+	   !rohc_snapshot_get32(snapshot, &ts_sc->ts_offset) ||
+	   !rohc_snapshot_get32(snapshot, &ts_sc->ts) ||
+	   !c_wlsb_import(ts_sc->ts_unscaled_wlsb, snapshot) ||
+	   !rohc_snapshot_get32(snapshot, &ts_sc->old_ts) ||
+	   !rohc_snapshot_get16(snapshot, &ts_sc->sn) ||
+	   !rohc_snapshot_get16(snapshot, &ts_sc->old_sn) ||
+	   !rohc_snapshot_get8(snapshot, &is_deducible) ||
+	   !rohc_snapshot_get8(snapshot, &state) ||
+	   !rohc_snapshot_get8(snapshot, &are_old_val_init) ||
+	   !rohc_snapshot_get32(snapshot, &nr_init_stride_packets) ||
+	   !rohc_snapshot_get32(snapshot, &ts_sc->ts_delta))
+	{
+		return false;
+	}
+	if(state != INIT_TS && state != INIT_STRIDE && state != SEND_SCALED)
+	{
+		return false;
+	}
+	ts_sc->is_deducible = !!is_deducible;
+	ts_sc->state = state;
+	ts_sc->are_old_val_init = !!are_old_val_init;
+	ts_sc->nr_init_stride_packets = nr_init_stride_packets;
+
+	return true;
+}
@@ -106,6 +106,8 @@ struct ts_sc_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 };
 
 
@@ -115,11 +117,15 @@ struct ts_sc_comp
  */
 
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
+                 struct rohc_slab *const slab,
                  const size_t wlsb_window_width,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
-	__attribute__((warn_unused_result));
-void c_destroy_sc(struct ts_sc_comp *const ts_sc);
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_min_level)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+void c_destroy_sc(struct ts_sc_comp *const ts_sc,
+                  struct rohc_slab *const slab)
+	__attribute__((nonnull(1, 2)));
 
 void c_add_ts(struct ts_sc_comp *const ts_sc,
               const uint32_t ts,
@@ -147,5 +153,12 @@ uint32_t get_ts_unscaled(const struct ts_sc_comp *const ts_sc)
 bool rohc_ts_sc_is_deducible(const struct ts_sc_comp *const ts_sc)
 	__attribute__((nonnull(1), warn_unused_result, pure));
 
+bool c_ts_sc_export(const struct ts_sc_comp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool c_ts_sc_import(struct ts_sc_comp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
@@ -27,26 +27,66 @@
 
 #include "comp_wlsb.h"
 #include "interval.h" /* for the rohc_f_*bits() functions */
+#include "rohc_snapshot.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
 #endif
 #include <assert.h>
 
+/** Whether the W-LSB window may be evaluated with the x86 AVX2 instructions */
+#if !defined(__KERNEL__) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#  define ROHC_WLSB_AVX2 1
+#  include <immintrin.h>
+#else
+#  define ROHC_WLSB_AVX2 0
+#endif
+
+/** Whether the W-LSB window may be evaluated with the ARMv8 NEON instructions */
+#if !defined(__KERNEL__) && defined(__GNUC__) && \
+    defined(__aarch64__) && defined(__ARM_NEON)
+#  define ROHC_WLSB_NEON 1
+#  include <arm_neon.h>
+#else
+#  define ROHC_WLSB_NEON 0
+#endif
+
+
+/**
+ * @brief The minimal number of references in the window to compare them all
+ *        at once with the value to encode
+ *
+ * Smaller windows are evaluated one reference after the other.
+ */
+#define ROHC_WLSB_DISTS_MIN_REFS  8U
+
 
 /*
  * Private structures and types
  */
 
 /**
- * @brief Define a W-LSB window entry
+ * @brief The function to get the range of the distances between a base value
+ *        and the references of a W-LSB window
+ *
+ * The distances are computed modulo the field length, then interpreted as
+ * signed values. The range given as input is extended with the distances
+ * of the given references.
+ *
+ * @param refs           The references
+ * @param refs_nr        The number of references
+ * @param base           The base value
+ * @param shift          32 minus the length (in bits) of the field
+ * @param[in,out] min    The minimal distance
+ * @param[in,out] max    The maximal distance
  */
-struct c_window
-{
-	uint32_t sn;     /**< The Sequence Number (SN) associated with the entry
-	                      (used to acknowledge the entry) */
-	uint32_t value;  /**< The value stored in the window entry */
-};
+typedef void (*wlsb_get_dists_t)(const uint32_t *const refs,
+                                 const size_t refs_nr,
+                                 const uint32_t base,
+                                 const size_t shift,
+                                 int32_t *const min,
+                                 int32_t *const max);
 
 
 /**
@@ -70,11 +110,32 @@ struct c_wlsb
 
 	/// The maximal number of bits for representing the value
 	size_t bits;
+	/// The mask for the values, ie. 2^bits - 1
+	uint32_t value_mask;
 	/// Shift parameter (see 4.5.2 in the RFC 3095)
 	rohc_lsb_shift_t p;
 
-	/** The window in which previous values of the encoded value are stored */
-	struct c_window window[1];
+	/** The number of consecutive entries whose value goes backward from the
+	 *  value of the previous entry, ie. whose forward distance is at least
+	 *  half of the field */
+	size_t backward_steps_nr;
+	/** The sum of the forward distances between consecutive entries, ie. the
+	 *  distance between the oldest and newest values if no step goes backward */
+	uint64_t span;
+
+	/** The function to compare the window references with the value to encode
+	 *  all at once */
+	wlsb_get_dists_t get_dists;
+
+	/** The Sequence Numbers (SN) associated with the window entries (used to
+	 *  acknowledge the entries) */
+	uint32_t *sns;
+	/** The values stored in the window entries, apart from their SN so that
+	 *  several references may be loaded at once */
+	uint32_t *values;
+
+	/** The storage for the SN then the values of the window entries */
+	uint32_t entries[1];
 };
 
 
@@ -88,6 +149,59 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 static size_t wlsb_ack_remove(struct c_wlsb *const wlsb, const size_t pos)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+static void wlsb_add_step(struct c_wlsb *const wlsb,
+                          const size_t older,
+                          const size_t newer)
+	__attribute__((nonnull(1)));
+static void wlsb_remove_step(struct c_wlsb *const wlsb,
+                             const size_t older,
+                             const size_t newer)
+	__attribute__((nonnull(1)));
+
+static bool wlsb_get_farthest_ref(const struct c_wlsb *const wlsb,
+                                  const uint32_t value,
+                                  const size_t field_bits,
+                                  const size_t min_k,
+                                  const rohc_lsb_shift_t p,
+                                  uint32_t *const ref)
+	__attribute__((warn_unused_result, nonnull(1, 6)));
+
+static size_t wlsb_get_k_from_dists(const struct c_wlsb *const wlsb,
+                                    const uint32_t value,
+                                    const size_t field_bits,
+                                    const size_t min_k,
+                                    const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static wlsb_get_dists_t wlsb_get_dists_probe(void)
+	__attribute__((warn_unused_result));
+
+static void wlsb_get_dists(const uint32_t *const refs,
+                           const size_t refs_nr,
+                           const uint32_t base,
+                           const size_t shift,
+                           int32_t *const min,
+                           int32_t *const max)
+	__attribute__((nonnull(1, 5, 6)));
+#if ROHC_WLSB_AVX2 == 1
+static void wlsb_get_dists_avx2(const uint32_t *const refs,
+                                const size_t refs_nr,
+                                const uint32_t base,
+                                const size_t shift,
+                                int32_t *const min,
+                                int32_t *const max)
+	__attribute__((target("avx2"), nonnull(1, 5, 6)));
+#endif
+#if ROHC_WLSB_NEON == 1
+static void wlsb_get_dists_neon(const uint32_t *const refs,
+                                const size_t refs_nr,
+                                const uint32_t base,
+                                const size_t shift,
+                                int32_t *const min,
+                                int32_t *const max)
+	__attribute__((nonnull(1, 5, 6)));
+#endif
+
 static size_t rohc_g_8bits(const uint8_t v_ref,
                            const uint8_t v,
                            const rohc_lsb_shift_t p,
@@ -113,16 +227,33 @@ static size_t rohc_g_32bits(const uint32_t v_ref,
  * Public functions
  */
 
+/**
+ * @brief Get the size of a W-LSB encoding object
+ *
+ * Used to declare the W-LSB objects of the contexts in the slab of the
+ * compressor.
+ *
+ * @param window_width The number of entries in the window
+ * @return             The size (in bytes) of the W-LSB encoding object
+ */
+size_t c_wlsb_size(const size_t window_width)
+{
+	return (sizeof(struct c_wlsb) + (window_width * 2 - 1) * sizeof(uint32_t));
+}
+
+
 /**
  * @brief Create a new Window-based Least Significant Bits (W-LSB) encoding
  *        object
  *
+ * @param slab         The slab to allocate the object from
  * @param bits         The maximal number of bits for representing a value
  * @param window_width The number of entries in the window (power of 2)
  * @param p            Shift parameter (see 4.5.2 in the RFC 3095)
  * @return             The newly-created W-LSB encoding object
  */
-struct c_wlsb * c_create_wlsb(const size_t bits,
+struct c_wlsb * c_create_wlsb(struct rohc_slab *const slab,
+                              const size_t bits,
                               const size_t window_width,
                               const rohc_lsb_shift_t p)
 {
@@ -133,7 +264,7 @@ struct c_wlsb * c_create_wlsb(const size_t bits,
 	/* window_width must be a power of 2! */
 	assert(window_width != 0 && (window_width & (window_width - 1)) == 0);
 
-	wlsb = malloc(sizeof(struct c_wlsb) + (window_width - 1) * sizeof(struct c_window));
+	wlsb = rohc_slab_malloc(slab, c_wlsb_size(window_width));
 	if(wlsb == NULL)
 	{
 		goto error;
@@ -145,7 +276,20 @@ struct c_wlsb * c_create_wlsb(const size_t bits,
 	wlsb->window_width = window_width;
 	wlsb->window_mask = window_width - 1;
 	wlsb->bits = bits;
+	if(bits >= 32)
+	{
+		wlsb->value_mask = 0xffffffff;
+	}
+	else
+	{
+		wlsb->value_mask = (1U << bits) - 1;
+	}
 	wlsb->p = p;
+	wlsb->backward_steps_nr = 0;
+	wlsb->span = 0;
+	wlsb->get_dists = wlsb_get_dists_probe();
+	wlsb->sns = wlsb->entries;
+	wlsb->values = wlsb->entries + window_width;
 
 	return wlsb;
 
@@ -157,11 +301,12 @@ error:
 /**
  * @brief Destroy a Window-based LSB (W-LSB) encoding object
  *
+ * @param slab  The slab the object was allocated from
  * @param wlsb  The W-LSB object to destroy
  */
-void c_destroy_wlsb(struct c_wlsb *const wlsb)
+void c_destroy_wlsb(struct rohc_slab *const slab, struct c_wlsb *const wlsb)
 {
-	free(wlsb);
+	rohc_slab_free(slab, wlsb);
 }
 
 
@@ -177,22 +322,30 @@ void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t value)
 {
 	assert(wlsb != NULL);
-	assert(wlsb->window != NULL);
+	assert(wlsb->values != NULL);
 	assert(wlsb->next < wlsb->window_width);
 
 	/* if window is full, an entry is overwritten */
 	if(wlsb->count == wlsb->window_width)
 	{
-		wlsb->oldest = (wlsb->oldest + 1) & wlsb->window_mask;
+		const size_t new_oldest = (wlsb->oldest + 1) & wlsb->window_mask;
+		if(wlsb->count > 1)
+		{
+			wlsb_remove_step(wlsb, wlsb->oldest, new_oldest);
+		}
+		wlsb->oldest = new_oldest;
+		wlsb->count--;
 	}
-	else
+
+	wlsb->sns[wlsb->next] = sn;
+	wlsb->values[wlsb->next] = value;
+	if(wlsb->count > 0)
 	{
-		wlsb->count++;
+		wlsb_add_step(wlsb, wlsb_get_next_older(wlsb->next, wlsb->window_mask),
+		              wlsb->next);
 	}
-
-	wlsb->window[wlsb->next].sn = sn;
-	wlsb->window[wlsb->next].value = value;
 	wlsb->next = (wlsb->next + 1) & wlsb->window_mask;
+	wlsb->count++;
 }
 
 
@@ -227,6 +380,7 @@ size_t wlsb_get_kp_8bits(const struct c_wlsb *const wlsb,
                          const uint8_t value,
                          const rohc_lsb_shift_t p)
 {
+	uint32_t ref;
 	size_t bits_nr;
 
 	/* use all bits if the window contains no value */
@@ -234,6 +388,17 @@ size_t wlsb_get_kp_8bits(const struct c_wlsb *const wlsb,
 	{
 		bits_nr = wlsb->bits;
 	}
+	else if(wlsb_get_farthest_ref(wlsb, value, 8, 0, p, &ref))
+	{
+		/* the window reference that requires the most bits is known without
+		 * scanning the whole window */
+		bits_nr = rohc_g_8bits(ref, value, p, wlsb->bits);
+	}
+	else if(wlsb->count >= ROHC_WLSB_DISTS_MIN_REFS)
+	{
+		/* compare all the window references with the value at once */
+		bits_nr = wlsb_get_k_from_dists(wlsb, value, 8, 0, p);
+	}
 	else
 	{
 		size_t entry;
@@ -248,7 +413,7 @@ size_t wlsb_get_kp_8bits(const struct c_wlsb *const wlsb,
 		    i--, entry = (entry + 1) & wlsb->window_mask)
 		{
 			const size_t k =
-				rohc_g_8bits(wlsb->window[entry].value, value, p, wlsb->bits);
+				rohc_g_8bits(wlsb->values[entry], value, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -334,6 +499,7 @@ size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
                              const size_t min_k,
                              const rohc_lsb_shift_t p)
 {
+	uint32_t ref;
 	size_t bits_nr;
 
 	/* use all bits if the window contains no value */
@@ -341,6 +507,17 @@ size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
 	{
 		bits_nr = wlsb->bits;
 	}
+	else if(wlsb_get_farthest_ref(wlsb, value, 16, min_k, p, &ref))
+	{
+		/* the window reference that requires the most bits is known without
+		 * scanning the whole window */
+		bits_nr = rohc_g_16bits(ref, value, min_k, p, wlsb->bits);
+	}
+	else if(wlsb->count >= ROHC_WLSB_DISTS_MIN_REFS)
+	{
+		/* compare all the window references with the value at once */
+		bits_nr = wlsb_get_k_from_dists(wlsb, value, 16, min_k, p);
+	}
 	else
 	{
 		size_t entry;
@@ -355,7 +532,7 @@ size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
 		    i--, entry = (entry + 1) & wlsb->window_mask)
 		{
 			const size_t k =
-				rohc_g_16bits(wlsb->window[entry].value, value, min_k, p, wlsb->bits);
+				rohc_g_16bits(wlsb->values[entry], value, min_k, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -441,9 +618,10 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
                              const size_t min_k,
                              const rohc_lsb_shift_t p)
 {
+	uint32_t ref;
 	size_t bits_nr;
 
-	assert(wlsb->window != NULL);
+	assert(wlsb->values != NULL);
 	assert(value <= 0xffffffff);
 
 	/* use all bits if the window contains no value */
@@ -451,6 +629,17 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 	{
 		bits_nr = wlsb->bits;
 	}
+	else if(wlsb_get_farthest_ref(wlsb, value, 32, min_k, p, &ref))
+	{
+		/* the window reference that requires the most bits is known without
+		 * scanning the whole window */
+		bits_nr = rohc_g_32bits(ref, value, min_k, p, wlsb->bits);
+	}
+	else if(wlsb->count >= ROHC_WLSB_DISTS_MIN_REFS)
+	{
+		/* compare all the window references with the value at once */
+		bits_nr = wlsb_get_k_from_dists(wlsb, value, 32, min_k, p);
+	}
 	else
 	{
 		size_t entry;
@@ -465,7 +654,7 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 		    i--, entry = (entry + 1) & wlsb->window_mask)
 		{
 			const size_t k =
-				rohc_g_32bits(wlsb->window[entry].value, value, min_k, p, wlsb->bits);
+				rohc_g_32bits(wlsb->values[entry], value, min_k, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -512,7 +701,7 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 	for(i = 0; i < wlsb->count; i++)
 	{
 		entry = wlsb_get_next_older(entry, wlsb->window_mask);
-		if((wlsb->window[entry].sn & sn_mask) == sn_bits)
+		if((wlsb->sns[entry] & sn_mask) == sn_bits)
 		{
 			/* remove the window entry and all the older ones if found */
 			return wlsb_ack_remove(wlsb, entry);
@@ -523,6 +712,83 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 }
 
 
+/**
+ * @brief Write the entries of a W-LSB encoding object in a snapshot
+ *
+ * The number of entries is written first, then the entries from the oldest
+ * one to the newest one.
+ *
+ * @param wlsb      The W-LSB object
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool c_wlsb_export(const struct c_wlsb *const wlsb,
+                   struct rohc_buf *const snapshot)
+{
+	size_t entry = wlsb->oldest;
+	size_t i;
+
+	if(!rohc_snapshot_put16(snapshot, wlsb->count))
+	{
+		return false;
+	}
+	for(i = 0; i < wlsb->count; i++)
+	{
+		if(!rohc_snapshot_put32(snapshot, wlsb->sns[entry]) ||
+		   !rohc_snapshot_put32(snapshot, wlsb->values[entry]))
+		{
+			return false;
+		}
+		entry = (entry + 1) & wlsb->window_mask;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Read the entries of a W-LSB encoding object from a snapshot
+ *
+ * The entries read from the snapshot replace the entries of the W-LSB object.
+ *
+ * @param wlsb      The W-LSB object
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool c_wlsb_import(struct c_wlsb *const wlsb,
+                   struct rohc_buf *const snapshot)
+{
+	uint16_t count;
+	size_t i;
+
+	/* forget the current entries */
+	wlsb->oldest = 0;
+	wlsb->next = 0;
+	wlsb->count = 0;
+	wlsb->backward_steps_nr = 0;
+	wlsb->span = 0;
+
+	if(!rohc_snapshot_get16(snapshot, &count) || count > wlsb->window_width)
+	{
+		return false;
+	}
+	for(i = 0; i < count; i++)
+	{
+		uint32_t sn;
+		uint32_t value;
+
+		if(!rohc_snapshot_get32(snapshot, &sn) ||
+		   !rohc_snapshot_get32(snapshot, &value))
+		{
+			return false;
+		}
+		c_add_wlsb(wlsb, sn, value & wlsb->value_mask);
+	}
+
+	return true;
+}
+
+
 /*
  * Private functions
  */
@@ -555,7 +821,9 @@ static size_t wlsb_ack_remove(struct c_wlsb *const wlsb, const size_t pos)
 	while(wlsb->oldest != pos)
 	{
 		/* remove the oldest entry */
-		wlsb->oldest = (wlsb->oldest + 1) & wlsb->window_mask;
+		const size_t new_oldest = (wlsb->oldest + 1) & wlsb->window_mask;
+		wlsb_remove_step(wlsb, wlsb->oldest, new_oldest);
+		wlsb->oldest = new_oldest;
 		wlsb->count--;
 		acked_nr++;
 	}
@@ -564,6 +832,382 @@ static size_t wlsb_ack_remove(struct c_wlsb *const wlsb, const size_t pos)
 }
 
 
+/**
+ * @brief Account for the step between two consecutive W-LSB window entries
+ *
+ * @param wlsb   The W-LSB object
+ * @param older  The position of the older entry
+ * @param newer  The position of the newer entry
+ */
+static void wlsb_add_step(struct c_wlsb *const wlsb,
+                          const size_t older,
+                          const size_t newer)
+{
+	const uint32_t step =
+		(wlsb->values[newer] - wlsb->values[older]) & wlsb->value_mask;
+
+	if(step > (wlsb->value_mask >> 1))
+	{
+		wlsb->backward_steps_nr++;
+	}
+	wlsb->span += step;
+}
+
+
+/**
+ * @brief Forget the step between two consecutive W-LSB window entries
+ *
+ * @param wlsb   The W-LSB object
+ * @param older  The position of the older entry
+ * @param newer  The position of the newer entry
+ */
+static void wlsb_remove_step(struct c_wlsb *const wlsb,
+                             const size_t older,
+                             const size_t newer)
+{
+	const uint32_t step =
+		(wlsb->values[newer] - wlsb->values[older]) & wlsb->value_mask;
+
+	if(step > (wlsb->value_mask >> 1))
+	{
+		assert(wlsb->backward_steps_nr > 0);
+		wlsb->backward_steps_nr--;
+	}
+	assert(wlsb->span >= step);
+	wlsb->span -= step;
+}
+
+
+/**
+ * @brief Find the window reference that requires the most bits without
+ *        scanning the window
+ *
+ * When no value of the window goes backward and the window spans less than
+ * half of the field, all the references are in the interval [oldest, newest]
+ * and the oldest reference is the farthest one from the value to encode,
+ * provided that the value (shifted by p) is not within the interval. As the
+ * g function only increases with the distance between the reference and the
+ * value, the oldest reference then requires the most bits.
+ *
+ * The shift parameters that depend on k (RTP TS, RTP SN and ESP SN) are all
+ * positive, so the value shall also be far enough from the upper boundary of
+ * the field for the largest p to not wrap around.
+ *
+ * In other cases, the whole window shall be scanned.
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param field_bits  The length (in bits) of the field being encoded
+ * @param min_k       The minimum number of bits to find out
+ * @param p           The shift parameter p
+ * @param[out] ref    The reference that requires the most bits
+ * @return            true if the reference was found,
+ *                    false if the whole window shall be scanned
+ */
+static bool wlsb_get_farthest_ref(const struct c_wlsb *const wlsb,
+                                  const uint32_t value,
+                                  const size_t field_bits,
+                                  const size_t min_k,
+                                  const rohc_lsb_shift_t p,
+                                  uint32_t *const ref)
+{
+	const uint32_t oldest = wlsb->values[wlsb->oldest];
+	uint32_t dist;
+
+	if(wlsb->bits != field_bits ||
+	   min_k >= wlsb->bits ||
+	   wlsb->backward_steps_nr > 0 ||
+	   wlsb->span > (wlsb->value_mask >> 1))
+	{
+		return false;
+	}
+
+	if(p == ROHC_LSB_SHIFT_RTP_TS ||
+	   p == ROHC_LSB_SHIFT_RTP_SN ||
+	   p == ROHC_LSB_SHIFT_ESP_SN)
+	{
+		/* p only increases with k, except for RTP/ESP SN that gets its lowest
+		 * value for k = 5, so the largest p is reached for one of the bounds */
+		const int32_t p_first = rohc_interval_compute_p(min_k, p);
+		const int32_t p_last = rohc_interval_compute_p(wlsb->bits - 1, p);
+		const uint32_t p_max = (p_first > p_last ? p_first : p_last);
+
+		dist = (value - oldest) & wlsb->value_mask;
+		if(dist < wlsb->span || dist > (wlsb->value_mask - p_max))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		const int32_t computed_p = rohc_interval_compute_p(min_k, p);
+
+		dist = (value + computed_p - oldest) & wlsb->value_mask;
+		if(dist < wlsb->span)
+		{
+			return false;
+		}
+	}
+
+	*ref = oldest;
+	return true;
+}
+
+
+/**
+ * @brief Find out the number of bits required by all the window references
+ *        at once
+ *
+ * With o = p(0), every reference r defines the interpretation intervals
+ * [o - p(k), o - p(k) + 2^k - 1] for the signed distance d = v + o - r
+ * (modulo the field length). The intervals of the reference r for all the k
+ * in [min_k, K] form one single interval. K bits are thus enough for all the
+ * references if the minimal and maximal distances of the window both fall
+ * into that interval.
+ *
+ * The distances of all the references are computed at once with the vector
+ * instructions of the CPU if available.
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param field_bits  The length (in bits) of the field being encoded
+ * @param min_k       The minimum number of bits to find out
+ * @param p           The shift parameter p
+ * @return            The number of bits required to uniquely recreate the value
+ */
+static size_t wlsb_get_k_from_dists(const struct c_wlsb *const wlsb,
+                                    const uint32_t value,
+                                    const size_t field_bits,
+                                    const size_t min_k,
+                                    const rohc_lsb_shift_t p)
+{
+	const int32_t offset = rohc_interval_compute_p(0, p);
+	const size_t shift = 32 - field_bits;
+	const size_t first_nr =
+		(wlsb->oldest + wlsb->count <= wlsb->window_width ?
+		 wlsb->count : wlsb->window_width - wlsb->oldest);
+	int32_t min_dist;
+	int32_t max_dist;
+	int64_t interval_min = 0;
+	int64_t interval_max = 0;
+	size_t k;
+
+	assert(wlsb->count > 0);
+
+	/* start with the distance of the oldest reference */
+	min_dist =
+		((int32_t) ((value + offset - wlsb->values[wlsb->oldest]) << shift)) >> shift;
+	max_dist = min_dist;
+
+	/* the window is a circular buffer: first the references from the oldest
+	 * one to the end of the buffer, then the ones at the start of the buffer */
+	wlsb->get_dists(wlsb->values + wlsb->oldest, first_nr, value + offset,
+	                shift, &min_dist, &max_dist);
+	if(first_nr < wlsb->count)
+	{
+		wlsb->get_dists(wlsb->values, wlsb->count - first_nr, value + offset,
+		                shift, &min_dist, &max_dist);
+	}
+
+	for(k = min_k; k < wlsb->bits; k++)
+	{
+		const int64_t k_min = ((int64_t) offset) - rohc_interval_compute_p(k, p);
+		const int64_t k_max = k_min + (((int64_t) 1) << k) - 1;
+
+		if(k == min_k || k_min < interval_min)
+		{
+			interval_min = k_min;
+		}
+		if(k == min_k || k_max > interval_max)
+		{
+			interval_max = k_max;
+		}
+		if(min_dist >= interval_min && max_dist <= interval_max)
+		{
+			break;
+		}
+	}
+
+	return k;
+}
+
+
+/**
+ * @brief Get the fastest implementation to compare all the window references
+ *        with the value to encode supported by the CPU
+ *
+ * The vector instructions (AVX2 on x86, NEON on ARMv8) are used if the library
+ * was built with them and if the CPU supports them. Otherwise, the references
+ * are compared one after the other.
+ *
+ * @return  The function to get the range of the distances with
+ */
+static wlsb_get_dists_t wlsb_get_dists_probe(void)
+{
+#if ROHC_WLSB_AVX2 == 1
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+	{
+		return wlsb_get_dists_avx2;
+	}
+#endif
+#if ROHC_WLSB_NEON == 1
+	return wlsb_get_dists_neon;
+#else
+	return wlsb_get_dists;
+#endif
+}
+
+
+/**
+ * @brief Get the range of the distances between a base value and the
+ *        references of a W-LSB window, one reference after the other
+ *
+ * @param refs           The references
+ * @param refs_nr        The number of references
+ * @param base           The base value
+ * @param shift          32 minus the length (in bits) of the field
+ * @param[in,out] min    The minimal distance
+ * @param[in,out] max    The maximal distance
+ */
+static void wlsb_get_dists(const uint32_t *const refs,
+                           const size_t refs_nr,
+                           const uint32_t base,
+                           const size_t shift,
+                           int32_t *const min,
+                           int32_t *const max)
+{
+	size_t i;
+
+	for(i = 0; i < refs_nr; i++)
+	{
+		/* sign-extend the distance modulo the field length */
+		const int32_t dist = ((int32_t) ((base - refs[i]) << shift)) >> shift;
+
+		if(dist < (*min))
+		{
+			*min = dist;
+		}
+		if(dist > (*max))
+		{
+			*max = dist;
+		}
+	}
+}
+
+
+#if ROHC_WLSB_AVX2 == 1
+
+/**
+ * @brief Get the range of the distances between a base value and the
+ *        references of a W-LSB window, with the x86 AVX2 instructions
+ *
+ * The CPU shall support the AVX2 instructions, see \ref wlsb_get_dists_probe.
+ *
+ * @param refs           The references
+ * @param refs_nr        The number of references
+ * @param base           The base value
+ * @param shift          32 minus the length (in bits) of the field
+ * @param[in,out] min    The minimal distance
+ * @param[in,out] max    The maximal distance
+ */
+static void wlsb_get_dists_avx2(const uint32_t *const refs,
+                                const size_t refs_nr,
+                                const uint32_t base,
+                                const size_t shift,
+                                int32_t *const min,
+                                int32_t *const max)
+{
+	const __m256i base_v = _mm256_set1_epi32((int) base);
+	const __m128i shift_v = _mm_cvtsi32_si128((int) shift);
+	__m256i min_v = _mm256_set1_epi32(*min);
+	__m256i max_v = _mm256_set1_epi32(*max);
+	int32_t mins[8];
+	int32_t maxs[8];
+	size_t i;
+
+	/* 8 references at a time */
+	for(i = 0; (i + 8) <= refs_nr; i += 8)
+	{
+		const __m256i refs_v = _mm256_loadu_si256((const __m256i *) (refs + i));
+		__m256i dists_v = _mm256_sub_epi32(base_v, refs_v);
+
+		/* sign-extend the distances modulo the field length */
+		dists_v = _mm256_sra_epi32(_mm256_sll_epi32(dists_v, shift_v), shift_v);
+		min_v = _mm256_min_epi32(min_v, dists_v);
+		max_v = _mm256_max_epi32(max_v, dists_v);
+	}
+	_mm256_storeu_si256((__m256i *) mins, min_v);
+	_mm256_storeu_si256((__m256i *) maxs, max_v);
+	for(i = 0; i < 8; i++)
+	{
+		if(mins[i] < (*min))
+		{
+			*min = mins[i];
+		}
+		if(maxs[i] > (*max))
+		{
+			*max = maxs[i];
+		}
+	}
+
+	/* the last references one by one */
+	wlsb_get_dists(refs + (refs_nr & ~((size_t) 7)), refs_nr & 7, base, shift,
+	               min, max);
+}
+
+#endif /* ROHC_WLSB_AVX2 */
+
+
+#if ROHC_WLSB_NEON == 1
+
+/**
+ * @brief Get the range of the distances between a base value and the
+ *        references of a W-LSB window, with the ARMv8 NEON instructions
+ *
+ * @param refs           The references
+ * @param refs_nr        The number of references
+ * @param base           The base value
+ * @param shift          32 minus the length (in bits) of the field
+ * @param[in,out] min    The minimal distance
+ * @param[in,out] max    The maximal distance
+ */
+static void wlsb_get_dists_neon(const uint32_t *const refs,
+                                const size_t refs_nr,
+                                const uint32_t base,
+                                const size_t shift,
+                                int32_t *const min,
+                                int32_t *const max)
+{
+	const uint32x4_t base_v = vdupq_n_u32(base);
+	const int32x4_t lshift_v = vdupq_n_s32((int32_t) shift);
+	const int32x4_t rshift_v = vdupq_n_s32(-((int32_t) shift));
+	int32x4_t min_v = vdupq_n_s32(*min);
+	int32x4_t max_v = vdupq_n_s32(*max);
+	size_t i;
+
+	/* 4 references at a time */
+	for(i = 0; (i + 4) <= refs_nr; i += 4)
+	{
+		const uint32x4_t refs_v = vld1q_u32(refs + i);
+		int32x4_t dists_v = vreinterpretq_s32_u32(vsubq_u32(base_v, refs_v));
+
+		/* sign-extend the distances modulo the field length */
+		dists_v = vshlq_s32(vshlq_s32(dists_v, lshift_v), rshift_v);
+		min_v = vminq_s32(min_v, dists_v);
+		max_v = vmaxq_s32(max_v, dists_v);
+	}
+	*min = vminvq_s32(min_v);
+	*max = vmaxvq_s32(max_v);
+
+	/* the last references one by one */
+	wlsb_get_dists(refs + (refs_nr & ~((size_t) 3)), refs_nr & 3, base, shift,
+	               min, max);
+}
+
+#endif /* ROHC_WLSB_NEON */
+
+
 /**
  * @brief The g function as defined in LSB encoding for 8-bit fields
  *
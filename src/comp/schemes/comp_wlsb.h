@@ -28,6 +28,8 @@
 #define ROHC_COMP_SCHEMES_WLSB_H
 
 #include "interval.h" /* for rohc_lsb_shift_t */
+#include "rohc_buf.h"
+#include "rohc_slab.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -42,11 +44,15 @@ struct c_wlsb;
  * Public function prototypes:
  */
 
-struct c_wlsb * c_create_wlsb(const size_t bits,
+size_t c_wlsb_size(const size_t window_width)
+	__attribute__((warn_unused_result, const));
+struct c_wlsb * c_create_wlsb(struct rohc_slab *const slab,
+                              const size_t bits,
                               const size_t window_width,
                               const rohc_lsb_shift_t p)
-	__attribute__((warn_unused_result));
-void c_destroy_wlsb(struct c_wlsb *s);
+	__attribute__((warn_unused_result, nonnull(1)));
+void c_destroy_wlsb(struct rohc_slab *const slab, struct c_wlsb *const wlsb)
+	__attribute__((nonnull(1)));
 
 void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
@@ -99,5 +105,12 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const size_t sn_bits_nr)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+bool c_wlsb_export(const struct c_wlsb *const wlsb,
+                   struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool c_wlsb_import(struct c_wlsb *const wlsb,
+                   struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
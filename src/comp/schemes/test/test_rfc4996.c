@@ -46,6 +46,11 @@
 /** The width of the W-LSB sliding window */
 #define ROHC_WLSB_WINDOW_WIDTH  4U
 
+/** The slab the encoding/decoding objects are allocated from, left empty so
+ *  that they are allocated with malloc() */
+static struct rohc_slab slab;
+
+
 /** Print trace on stdout only in verbose mode */
 #define trace(is_verbose, format, ...) \
 	do { \
@@ -167,7 +172,7 @@ static bool run_test_variable_length_32_enc(const bool be_verbose)
 	};
 
 	/* create the W-LSB context */
-	wlsb = c_create_wlsb(32, ROHC_WLSB_WINDOW_WIDTH, ROHC_LSB_SHIFT_VAR);
+	wlsb = c_create_wlsb(&slab, 32, ROHC_WLSB_WINDOW_WIDTH, ROHC_LSB_SHIFT_VAR);
 	if(wlsb == NULL)
 	{
 		trace(be_verbose, "failed to create W-LSB context\n");
@@ -229,7 +234,7 @@ static bool run_test_variable_length_32_enc(const bool be_verbose)
 	is_success = true;
 
 free_wlsb:
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 error:
 	return is_success;
 }
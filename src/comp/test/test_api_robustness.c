@@ -23,12 +23,16 @@
  * @author  Didier Barvaux <didier@barvaux.org>
  */
 
+#include "config.h" /* for HAVE_*_H */
 #include "rohc_comp.h"
 
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
+#if HAVE_PTHREAD_H == 1
+#  include <pthread.h>
+#endif
 
 
 /** Print trace on stdout only in verbose mode */
@@ -48,10 +52,42 @@
 	} while(0)
 
 
+/** The number of shards of the pool used by several threads at once */
+#define POOL_THREADS_NR  4U
+
+/** The number of packets every thread compresses on its shard */
+#define POOL_THREAD_PACKETS_NR  100U
+
+
+/** One thread that compresses the packets of one flow on one shard */
+struct pool_worker
+{
+	struct rohc_comp *shard;  /**< The shard of the pool for the thread */
+	uint8_t ip_buf[20];       /**< The IPv4 packet of the flow of the shard */
+	size_t first_cid;         /**< The first CID that the shard owns */
+	size_t cids_nr;           /**< The number of CIDs that the shard owns */
+	size_t cid;               /**< OUT: The CID of the flow */
+	bool is_success;          /**< OUT: Whether the ROHC packets were right */
+};
+
+
 static int random_cb(const struct rohc_comp *const comp,
                      void *const user_context)
 	__attribute__((warn_unused_result));
 
+static void count_traces_cb(void *const priv_ctxt,
+                            const rohc_trace_level_t level,
+                            const rohc_trace_entity_t entity,
+                            const int profile,
+                            const char *const format,
+                            ...)
+	__attribute__((format(printf, 5, 6), nonnull(1, 5)));
+
+#if HAVE_PTHREAD_H == 1
+static void * pool_worker_run(void *const arg)
+	__attribute__((nonnull(1)));
+#endif
+
 
 /**
  * @brief Test the robustness of the compression API
@@ -121,6 +157,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == true);
 	}
 
+	/* rohc_comp_set_traces_min_level() */
+	CHECK(rohc_comp_set_traces_min_level(NULL, ROHC_TRACE_DEBUG) == false);
+	CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_ERROR) == true);
+	CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_comp_profile_enabled() */
 	CHECK(rohc_comp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_GENERAL) == false);
@@ -185,6 +227,18 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_segment2(comp, &pkt1) == ROHC_STATUS_ERROR);
 	}
 
+	/* rohc_comp_get_segment_sg() */
+	{
+		uint8_t buf1[10];
+		struct rohc_buf pkt1 = rohc_buf_init_empty(buf1, 10);
+		rohc_comp_payload_t payload;
+		CHECK(rohc_comp_get_segment_sg(NULL, 100, &pkt1, &payload) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_sg(comp, 100, NULL, &payload) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_sg(comp, 100, &pkt1, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_sg(comp, 1, &pkt1, &payload) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_sg(comp, 100, &pkt1, &payload) == ROHC_STATUS_ERROR);
+	}
+
 	/* rohc_comp_force_contexts_reinit() */
 	CHECK(rohc_comp_force_contexts_reinit(NULL) == false);
 	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
@@ -216,6 +270,11 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_rtp_detection_cb(comp, fct, NULL) == true);
 	}
 
+	/* rohc_comp_set_rtp_detection_heuristic() */
+	CHECK(rohc_comp_set_rtp_detection_heuristic(NULL, 4) == false);
+	CHECK(rohc_comp_set_rtp_detection_heuristic(comp, 4) == true);
+	CHECK(rohc_comp_set_rtp_detection_heuristic(comp, 0) == true);
+
 	/* rohc_comp_set_mrru() */
 	CHECK(rohc_comp_set_mrru(NULL, 10) == false);
 	CHECK(rohc_comp_set_mrru(comp, 65535 + 1) == false);
@@ -302,6 +361,45 @@ int main(int argc, char *argv[])
 		pkt2.offset = 0;
 		pkt2.len = 0;
 		CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+
+		/* rohc_compress_sg() with the same packets */
+		{
+			rohc_comp_payload_t payload;
+			pkt2.max_len = 100;
+			pkt2.offset = 0;
+			pkt2.len = 0;
+			CHECK(rohc_compress_sg(NULL, pkt, 100, &pkt2, &payload) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_sg(comp, pkt, 0, &pkt2, &payload) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_sg(comp, pkt, 100, NULL, &payload) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_sg(comp, pkt, 100, &pkt2, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_sg(comp, pkt, 100, &pkt2, &payload) == ROHC_STATUS_OK);
+			CHECK(pkt2.len > 0);
+			CHECK(payload.len > 0);
+			CHECK((payload.data + payload.len) == (buf + sizeof(buf)));
+			CHECK(payload.trailer_len == 0);
+		}
+
+		/* rohc_compress_burst() with the same packets */
+		{
+			struct rohc_buf in[2] = { pkt1, pkt };
+			uint8_t out_buf[2][100];
+			struct rohc_buf out[2] =
+			{
+				rohc_buf_init_empty(out_buf[0], 100),
+				rohc_buf_init_empty(out_buf[1], 100),
+			};
+			rohc_status_t st[2];
+			CHECK(rohc_compress_burst(NULL, in, out, st, 2) == 0);
+			CHECK(st[0] == ROHC_STATUS_ERROR && st[1] == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_burst(comp, NULL, out, st, 2) == 0);
+			CHECK(rohc_compress_burst(comp, in, NULL, st, 2) == 0);
+			CHECK(rohc_compress_burst(comp, in, out, NULL, 2) == 0);
+			CHECK(rohc_compress_burst(comp, in, out, st, 0) == 0);
+			CHECK(rohc_compress_burst(comp, in, out, st, 2) == 1);
+			CHECK(st[0] == ROHC_STATUS_ERROR);
+			CHECK(st[1] == ROHC_STATUS_OK);
+			CHECK(out[1].len > 0);
+		}
 	}
 
 	/* rohc_comp_get_last_packet_info2() */
@@ -332,6 +430,10 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_general_info(comp, &info) == false);
 		info.version_minor = 0;
 		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.ctxts_mem_reserved == 0);
+		CHECK(info.ctxts_mem_peak == 0);
 	}
 
 	/* rohc_comp_get_state_descr() */
@@ -367,6 +469,7 @@ int main(int argc, char *argv[])
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
+		CHECK(rohc_comp_set_traces_min_level(comp, ROHC_TRACE_WARNING) == false);
 
 		CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == false);
 
@@ -379,6 +482,715 @@ int main(int argc, char *argv[])
 	rohc_comp_free(NULL);
 	rohc_comp_free(comp);
 
+	/* rohc_comp_set_features() with preallocated contexts */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x14,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		rohc_comp_general_info_t info;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CTXT_SLAB) == true);
+
+		/* the W-LSB windows are preallocated with the current width */
+		CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == false);
+		CHECK(rohc_comp_set_wlsb_window_width(comp, 4) == true);
+
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
+		CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == true);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CTXT_SLAB |
+		                                   ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.ctxts_mem_reserved > 0);
+		CHECK(info.ctxts_mem_peak == 0);
+
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 1);
+		CHECK(info.ctxts_mem_peak > 0);
+		CHECK(info.ctxts_mem_peak <= info.ctxts_mem_reserved);
+
+		/* preallocation cannot be changed while contexts are in use */
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == false);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CTXT_SLAB) == true);
+
+		rohc_comp_free(comp);
+	}
+
+	/* rohc_comp_get_stats_snapshot() and rohc_comp_get_ctxt_stats_snapshot() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x14,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		rohc_comp_stats_snapshot_t stats;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+
+		/* detailed statistics are disabled by default */
+		memset(&stats, 0, sizeof(rohc_comp_stats_snapshot_t));
+		CHECK(rohc_comp_get_stats_snapshot(NULL, &stats) == false);
+		CHECK(rohc_comp_get_stats_snapshot(comp, NULL) == false);
+		CHECK(rohc_comp_get_stats_snapshot(comp, &stats) == false);
+		CHECK(rohc_comp_get_ctxt_stats_snapshot(NULL, 0, &stats) == false);
+		CHECK(rohc_comp_get_ctxt_stats_snapshot(comp, 0, NULL) == false);
+		CHECK(rohc_comp_get_ctxt_stats_snapshot(comp, 0, &stats) == false);
+
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_STATS |
+		                                   ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		stats.version_major = 0xffff;
+		CHECK(rohc_comp_get_stats_snapshot(comp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_comp_get_stats_snapshot(comp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_comp_get_stats_snapshot(comp, &stats) == true);
+		CHECK(stats.packets_nr == 0);
+		CHECK(rohc_comp_get_ctxt_stats_snapshot(comp, ROHC_SMALL_CID_MAX + 1,
+		                                        &stats) == false);
+
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_stats_snapshot(comp, &stats) == true);
+		CHECK(stats.packets_nr == 1);
+		CHECK(stats.packet_types[ROHC_PACKET_IR] == 1);
+		CHECK(stats.contexts_per_state[ROHC_COMP_STATE_IR] == 1);
+		CHECK(stats.comp_hdr_bytes > 0);
+		CHECK(stats.uncomp_hdr_bytes == sizeof(ip_buf));
+		CHECK(rohc_comp_get_ctxt_stats_snapshot(comp, 0, &stats) == true);
+		CHECK(stats.profile_id == ROHC_PROFILE_IP);
+		CHECK(stats.packets_nr == 1);
+		CHECK(rohc_comp_get_ctxt_stats_snapshot(comp, 1, &stats) == true);
+		CHECK(stats.packets_nr == 0);
+
+		/* statistics are released once disabled */
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
+		CHECK(rohc_comp_get_stats_snapshot(comp, &stats) == false);
+
+		rohc_comp_free(comp);
+	}
+
+	/* pools of compressors */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x14,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		struct rohc_buf ip_pkt = rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		uint8_t fb_buf[] = { 0xf2, 0xe5, 0x00, 0xf2, 0xed, 0x00 };
+		struct rohc_buf fb_pkt = rohc_buf_init_full(fb_buf, sizeof(fb_buf), ts);
+		uint8_t large_fb_buf[] = { 0xf2, 50, 0x00 };
+		const struct rohc_buf large_fb_pkt =
+			rohc_buf_init_full(large_fb_buf, sizeof(large_fb_buf), ts);
+		rohc_comp_last_packet_info2_t last_info;
+		struct rohc_comp_pool *pool;
+		size_t shard_idx;
+		size_t fb_len;
+		size_t i;
+
+		/* rohc_comp_pool_new() */
+		CHECK(rohc_comp_pool_new(ROHC_SMALL_CID, 15, 0, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_pool_new(ROHC_SMALL_CID, 15, 17, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_pool_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1, 2,
+		                         random_cb, NULL) == NULL);
+		CHECK(rohc_comp_pool_new(ROHC_SMALL_CID + 1, 15, 2,
+		                         random_cb, NULL) == NULL);
+		CHECK(rohc_comp_pool_new(ROHC_SMALL_CID, 15, 2, NULL, NULL) == NULL);
+		pool = rohc_comp_pool_new(ROHC_SMALL_CID, 15, 16, random_cb, NULL);
+		CHECK(pool != NULL);
+		rohc_comp_pool_free(pool);
+		pool = rohc_comp_pool_new(ROHC_SMALL_CID, 15, 4, random_cb, NULL);
+		CHECK(pool != NULL);
+
+		/* rohc_comp_pool_get_shards_nr() and rohc_comp_pool_get_shard() */
+		CHECK(rohc_comp_pool_get_shards_nr(NULL) == 0);
+		CHECK(rohc_comp_pool_get_shards_nr(pool) == 4);
+		CHECK(rohc_comp_pool_get_shard(NULL, 0) == NULL);
+		CHECK(rohc_comp_pool_get_shard(pool, 4) == NULL);
+		for(i = 0; i < 4; i++)
+		{
+			comp = rohc_comp_pool_get_shard(pool, i);
+			CHECK(comp != NULL);
+			CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+			CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+
+			/* no segmentation on the shared channel */
+			CHECK(rohc_comp_set_mrru(comp, 500) == false);
+			CHECK(rohc_comp_set_mrru(comp, 0) == true);
+		}
+
+		/* rohc_comp_pool_get_packet_shard() */
+		CHECK(rohc_comp_pool_get_packet_shard(NULL, ip_pkt, &shard_idx) == false);
+		CHECK(rohc_comp_pool_get_packet_shard(pool, ip_pkt, NULL) == false);
+		ip_pkt.len = 0;
+		CHECK(rohc_comp_pool_get_packet_shard(pool, ip_pkt, &shard_idx) == false);
+		ip_pkt.len = 1;
+		CHECK(rohc_comp_pool_get_packet_shard(pool, ip_pkt, &shard_idx) == true);
+		CHECK(shard_idx == 0);
+		ip_pkt.len = sizeof(ip_buf);
+		CHECK(rohc_comp_pool_get_packet_shard(pool, ip_pkt, &shard_idx) == true);
+		CHECK(shard_idx < 4);
+
+		/* rohc_comp_pool_compress() creates the context in the shard range */
+		CHECK(rohc_comp_pool_compress(NULL, ip_pkt, &rohc_pkt) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_pool_compress(pool, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		memset(&last_info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		comp = rohc_comp_pool_get_shard(pool, shard_idx);
+		CHECK(rohc_comp_get_last_packet_info2(comp, &last_info) == true);
+		CHECK(last_info.context_id >= (shard_idx * 4));
+		CHECK(last_info.context_id < ((shard_idx + 1) * 4));
+
+		/* rohc_comp_pool_get_feedback_shard() */
+		CHECK(rohc_comp_pool_get_feedback_shard(NULL, fb_pkt, &shard_idx,
+		                                        &fb_len) == false);
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, fb_pkt, NULL,
+		                                        &fb_len) == false);
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, fb_pkt, &shard_idx,
+		                                        NULL) == false);
+		fb_pkt.len = 2;
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, fb_pkt, &shard_idx,
+		                                        &fb_len) == false);
+		fb_pkt.len = sizeof(fb_buf);
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, fb_pkt, &shard_idx,
+		                                        &fb_len) == true);
+		CHECK(shard_idx == 1);
+		CHECK(fb_len == 3);
+		rohc_buf_pull(&fb_pkt, fb_len);
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, fb_pkt, &shard_idx,
+		                                        &fb_len) == true);
+		CHECK(shard_idx == 3);
+		CHECK(fb_len == 3);
+		rohc_buf_push(&fb_pkt, 3);
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, ip_pkt, &shard_idx,
+		                                        &fb_len) == false);
+
+		/* rohc_comp_pool_deliver_feedback2(), no context for CIDs 5 and 13 */
+		CHECK(rohc_comp_pool_deliver_feedback2(NULL, fb_pkt) == false);
+		fb_pkt.len = 0;
+		CHECK(rohc_comp_pool_deliver_feedback2(pool, fb_pkt) == true);
+		fb_pkt.len = 5;
+		CHECK(rohc_comp_pool_deliver_feedback2(pool, fb_pkt) == false);
+		fb_pkt.len = sizeof(fb_buf);
+		CHECK(rohc_comp_pool_deliver_feedback2(pool, fb_pkt) == false);
+
+		/* rohc_comp_pool_free() */
+		rohc_comp_pool_free(NULL);
+		rohc_comp_pool_free(pool);
+
+		/* pool with large CIDs and CID ranges of different sizes */
+		pool = rohc_comp_pool_new(ROHC_LARGE_CID, 99, 7, random_cb, NULL);
+		CHECK(pool != NULL);
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, large_fb_pkt, &shard_idx,
+		                                        &fb_len) == true);
+		CHECK(shard_idx == 3);
+		CHECK(fb_len == 3);
+		large_fb_buf[1] = 100;
+		CHECK(rohc_comp_pool_get_feedback_shard(pool, large_fb_pkt, &shard_idx,
+		                                        &fb_len) == false);
+		rohc_comp_pool_free(pool);
+	}
+
+	/* queue of feedback items */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x14,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		uint8_t fb_buf[] = { 0xf4, 0x20, 0x01, 0x11, 0x39, 0xf1, 0x00 };
+		struct rohc_buf fb_pkt = rohc_buf_init_full(fb_buf, sizeof(fb_buf), ts);
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+
+		/* rohc_comp_set_feedback_queue() */
+		CHECK(rohc_comp_set_feedback_queue(NULL, 4) == false);
+		CHECK(rohc_comp_set_feedback_queue(comp, 3) == false);
+		CHECK(rohc_comp_set_feedback_queue(comp, 8192) == false);
+
+		/* rohc_comp_queue_feedback() */
+		CHECK(rohc_comp_queue_feedback(NULL, fb_pkt) == false);
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == false);
+		CHECK(rohc_comp_set_feedback_queue(comp, 4) == true);
+		fb_pkt.len = 0;
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == true);
+		fb_pkt.len = 3;
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == false);
+		fb_pkt.len = 6;
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == false);
+		fb_pkt.len = sizeof(fb_buf);
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == true);
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == true);
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == false);
+		fb_pkt.len = 5;
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == false);
+
+		/* the queue cannot be resized while items are queued */
+		CHECK(rohc_comp_set_feedback_queue(comp, 8) == false);
+
+		/* compression takes the queued items into account */
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == true);
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_set_feedback_queue(comp, 0) == true);
+		CHECK(rohc_comp_queue_feedback(comp, fb_pkt) == false);
+
+		rohc_comp_free(comp);
+	}
+
+#if HAVE_PTHREAD_H == 1
+	/* pools of compressors used by several threads at once */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x14,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		struct pool_worker workers[POOL_THREADS_NR];
+		pthread_t threads[POOL_THREADS_NR];
+		struct rohc_comp_pool *pool;
+		uint8_t src_addr = 0;
+		size_t round;
+		size_t i;
+
+		pool = rohc_comp_pool_new(ROHC_SMALL_CID, 15, POOL_THREADS_NR,
+		                          random_cb, NULL);
+		CHECK(pool != NULL);
+
+		/* one flow for every shard, the feedback for the shard is queued by
+		 * the main thread */
+		for(i = 0; i < POOL_THREADS_NR; i++)
+		{
+			struct pool_worker *const worker = &workers[i];
+			size_t shard_idx;
+
+			worker->shard = rohc_comp_pool_get_shard(pool, i);
+			CHECK(worker->shard != NULL);
+			CHECK(rohc_comp_set_features(worker->shard,
+			                             ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+			CHECK(rohc_comp_enable_profile(worker->shard, ROHC_PROFILE_IP) == true);
+			CHECK(rohc_comp_set_feedback_queue(worker->shard, 4) == true);
+			worker->first_cid = i * 4;
+			worker->cids_nr = 4;
+
+			memcpy(worker->ip_buf, ip_buf, sizeof(ip_buf));
+			do
+			{
+				const struct rohc_buf ip_pkt =
+					rohc_buf_init_full(worker->ip_buf, sizeof(ip_buf), ts);
+
+				src_addr++;
+				CHECK(src_addr != 0);
+				worker->ip_buf[15] = src_addr;
+				CHECK(rohc_comp_pool_get_packet_shard(pool, ip_pkt, &shard_idx) == true);
+			}
+			while(shard_idx != i);
+		}
+
+		/* compress on all the shards at once, then send a STATIC-NACK to
+		 * every context and compress again: the first packets shall be IR
+		 * packets again, on every shard */
+		for(round = 0; round < 2; round++)
+		{
+			for(i = 0; i < POOL_THREADS_NR; i++)
+			{
+				CHECK(pthread_create(&threads[i], NULL, pool_worker_run,
+				                     &workers[i]) == 0);
+			}
+			for(i = 0; i < POOL_THREADS_NR; i++)
+			{
+				CHECK(pthread_join(threads[i], NULL) == 0);
+				CHECK(workers[i].is_success);
+			}
+
+			for(i = 0; round == 0 && i < POOL_THREADS_NR; i++)
+			{
+				uint8_t fb_buf[4];
+				struct rohc_buf fb_pkt = rohc_buf_init_empty(fb_buf, 4);
+				size_t shard_idx;
+				size_t fb_len;
+
+				fb_buf[0] = 0xf0;
+				fb_pkt.len = 1;
+				if(workers[i].cid != 0)
+				{
+					fb_buf[fb_pkt.len] = 0xe0 | workers[i].cid;
+					fb_pkt.len++;
+				}
+				fb_buf[fb_pkt.len] = 0x80; /* STATIC-NACK, no mode change */
+				fb_buf[fb_pkt.len + 1] = 0x00;
+				fb_pkt.len += 2;
+				fb_buf[0] |= fb_pkt.len - 1;
+
+				CHECK(rohc_comp_pool_get_feedback_shard(pool, fb_pkt, &shard_idx,
+				                                        &fb_len) == true);
+				CHECK(shard_idx == i);
+				CHECK(fb_len == fb_pkt.len);
+				CHECK(rohc_comp_queue_feedback(workers[i].shard, fb_pkt) == true);
+			}
+		}
+
+		rohc_comp_pool_free(pool);
+	}
+#endif
+
+	/* rohc_comp_export_contexts() and rohc_comp_import_contexts() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x14,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		uint8_t rohc_buf2[100];
+		struct rohc_buf rohc_pkt2 = rohc_buf_init_empty(rohc_buf2, 100);
+		uint8_t snapshot_buf[500];
+		struct rohc_buf snapshot = rohc_buf_init_empty(snapshot_buf, 500);
+		struct rohc_buf small_snapshot = rohc_buf_init_empty(snapshot_buf, 20);
+		struct rohc_comp *comp2;
+		size_t i;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                       random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profile(comp2, ROHC_PROFILE_IP) == true);
+
+		/* bring the context up to the SO state */
+		for(i = 0; i < 10; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+
+		/* rohc_comp_export_contexts() */
+		CHECK(rohc_comp_export_contexts(NULL, &snapshot) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_export_contexts(comp, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_export_contexts(comp, &small_snapshot) ==
+		      ROHC_STATUS_OUTPUT_TOO_SMALL);
+		CHECK(small_snapshot.len == 0);
+		CHECK(rohc_comp_export_contexts(comp, &snapshot) == ROHC_STATUS_OK);
+		CHECK(snapshot.len > 13);
+
+		/* rohc_comp_import_contexts() */
+		CHECK(rohc_comp_import_contexts(NULL, snapshot) == false);
+		CHECK(rohc_comp_import_contexts(comp, snapshot) == false);
+		snapshot.len--;
+		CHECK(rohc_comp_import_contexts(comp2, snapshot) == false);
+		snapshot.len++;
+		snapshot_buf[0] = 'X';
+		CHECK(rohc_comp_import_contexts(comp2, snapshot) == false);
+		snapshot_buf[0] = 'R';
+		CHECK(rohc_comp_import_contexts(comp2, snapshot) == true);
+		CHECK(rohc_comp_import_contexts(comp2, snapshot) == false);
+
+		/* the imported context compresses the next packet as the original one */
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_compress4(comp2, ip_pkt, &rohc_pkt2) == ROHC_STATUS_OK);
+		CHECK(rohc_pkt2.len == rohc_pkt.len);
+		CHECK(rohc_pkt2.len < sizeof(ip_buf));
+		CHECK(memcmp(rohc_buf_data(rohc_pkt2), rohc_buf_data(rohc_pkt),
+		             rohc_pkt.len) == 0);
+
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp);
+	}
+
+	/* rohc_comp_import_contexts() with headers that do not match the profile */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x20,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x11, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x04, 0xd2, 0x16, 0x2e,
+			0x00, 0x0c, 0x00, 0x00,  0x00, 0x01, 0x02, 0x03
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		uint8_t snapshot_buf[500];
+		struct rohc_buf snapshot = rohc_buf_init_empty(snapshot_buf, 500);
+		const size_t ref_proto_offset = 11 + 6 + 42 + 2 + 9;
+		struct rohc_comp *comp2;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+		                                -1) == true);
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                       random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+		                                -1) == true);
+
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_export_contexts(comp, &snapshot) == ROHC_STATUS_OK);
+
+		/* the UDP record with UDP-Lite reference headers is malformed */
+		CHECK(snapshot.len > ref_proto_offset);
+		CHECK(snapshot_buf[ref_proto_offset] == 0x11);
+		snapshot_buf[ref_proto_offset] = 0x88;
+		CHECK(rohc_comp_import_contexts(comp2, snapshot) == false);
+		snapshot_buf[ref_proto_offset] = 0x11;
+		CHECK(rohc_comp_import_contexts(comp2, snapshot) == true);
+
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp);
+	}
+
+	/* the UDP flow of a RTP context is never classified again */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x2c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x11, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x04, 0xd2, 0x16, 0x2e,
+			0x00, 0x18, 0x00, 0x00,  0x80, 0x00, 0x00, 0x01,
+			0x00, 0x00, 0x00, 0xa0,  0x12, 0x34, 0x56, 0x78,
+			0x00, 0x01, 0x02, 0x03
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		uint8_t rohc_buf2[100];
+		struct rohc_buf rohc_pkt2 = rohc_buf_init_empty(rohc_buf2, 100);
+		uint8_t snapshot_buf[500];
+		struct rohc_buf snapshot = rohc_buf_init_empty(snapshot_buf, 500);
+		rohc_comp_last_packet_info2_t info;
+		struct rohc_comp *comp2;
+		size_t i;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_set_rtp_detection_heuristic(comp, 2) == true);
+
+		/* the RTP heuristic detects the RTP stream */
+		for(i = 0; i < 3; i++)
+		{
+			ip_buf[31]++;
+			ip_buf[34]++;
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+		CHECK(info.profile_id == ROHC_PROFILE_RTP);
+
+		/* the new settings of the RTP heuristic do not apply to the flow */
+		CHECK(rohc_comp_set_rtp_detection_heuristic(comp, 4) == true);
+		ip_buf[31]++;
+		ip_buf[34]++;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+		CHECK(info.profile_id == ROHC_PROFILE_RTP);
+		CHECK(info.is_context_init == false);
+
+		/* the RTP context imported by another compressor compresses the next
+		 * packets of the flow, although its RTP heuristic never saw the flow */
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                       random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHC_PROFILE_RTP,
+		                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+		                                -1) == true);
+		CHECK(rohc_comp_set_rtp_detection_heuristic(comp2, 4) == true);
+		CHECK(rohc_comp_export_contexts(comp, &snapshot) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_import_contexts(comp2, snapshot) == true);
+		ip_buf[31]++;
+		ip_buf[34]++;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_compress4(comp2, ip_pkt, &rohc_pkt2) == ROHC_STATUS_OK);
+		CHECK(rohc_pkt2.len == rohc_pkt.len);
+		CHECK(memcmp(rohc_buf_data(rohc_pkt2), rohc_buf_data(rohc_pkt),
+		             rohc_pkt.len) == 0);
+
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp);
+	}
+
+	/* packets are dumped only if the minimum level of traces allows it */
+	{
+		const rohc_trace_level_t min_levels[] =
+			{ ROHC_TRACE_WARNING, ROHC_TRACE_DEBUG };
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x14,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		size_t i;
+
+		for(i = 0; i < 2; i++)
+		{
+			struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+			size_t traces_nr = 0;
+
+			comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+			                      random_cb, NULL);
+			CHECK(comp != NULL);
+			CHECK(rohc_comp_set_traces_cb2(comp, count_traces_cb,
+			                               &traces_nr) == true);
+			CHECK(rohc_comp_set_traces_min_level(comp, min_levels[i]) == true);
+			CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_DUMP_PACKETS |
+			                                   ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+			CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+
+			CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK((traces_nr > 0) == (min_levels[i] == ROHC_TRACE_DEBUG));
+
+			rohc_comp_free(comp);
+		}
+	}
+
+	/* the steady state of RTP flows does not change the ROHC packets */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buf[] =
+		{
+			0x45, 0x00, 0x00, 0x2c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x11, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x04, 0xd2, 0x16, 0x2e,
+			0x00, 0x18, 0x00, 0x00,  0x80, 0x00, 0x00, 0x01,
+			0x00, 0x00, 0x00, 0xa0,  0x12, 0x34, 0x56, 0x78,
+			0x00, 0x01, 0x02, 0x03
+		};
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(ip_buf, sizeof(ip_buf), ts);
+		uint8_t rohc_buf[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+		uint8_t rohc_buf2[100];
+		struct rohc_buf rohc_pkt2 = rohc_buf_init_empty(rohc_buf2, 100);
+		rohc_comp_last_packet_info2_t info;
+		struct rohc_comp *comp2;
+		uint16_t ip_id = 0;
+		uint16_t sn = 1;
+		uint32_t rtp_ts = 160;
+		size_t i;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_set_rtp_detection_heuristic(comp, 2) == true);
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                       random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
+		                                    ROHC_COMP_FEATURE_NO_STEADY_PATH) == true);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHC_PROFILE_RTP,
+		                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+		                                -1) == true);
+		CHECK(rohc_comp_set_rtp_detection_heuristic(comp2, 2) == true);
+
+		/* sequential IP-ID, then RTP Marker bit, TS jump, TTL change and SN
+		 * jump: the packets after the long steady runs show whether the W-LSB
+		 * windows were updated in the steady state */
+		for(i = 0; i < 100; i++)
+		{
+			ip_id++;
+			sn += (i == 90 ? 10 : 1);
+			rtp_ts += (i == 60 ? 160 * 10 : 160);
+			ip_buf[4] = (ip_id >> 8) & 0xff;
+			ip_buf[5] = ip_id & 0xff;
+			ip_buf[8] = (i >= 80 ? 0x3f : 0x40);
+			ip_buf[29] = (i == 40 ? 0x80 : 0x00);
+			ip_buf[30] = (sn >> 8) & 0xff;
+			ip_buf[31] = sn & 0xff;
+			ip_buf[32] = (rtp_ts >> 24) & 0xff;
+			ip_buf[33] = (rtp_ts >> 16) & 0xff;
+			ip_buf[34] = (rtp_ts >> 8) & 0xff;
+			ip_buf[35] = rtp_ts & 0xff;
+
+			rohc_pkt.len = 0;
+			rohc_pkt2.len = 0;
+			CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_compress4(comp2, ip_pkt, &rohc_pkt2) == ROHC_STATUS_OK);
+			CHECK(rohc_pkt2.len == rohc_pkt.len);
+			CHECK(memcmp(rohc_buf_data(rohc_pkt2), rohc_buf_data(rohc_pkt),
+			             rohc_pkt.len) == 0);
+		}
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+		CHECK(info.profile_id == ROHC_PROFILE_RTP);
+		CHECK(info.packet_type == ROHC_PACKET_UO_0);
+
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -401,3 +1213,101 @@ static int random_cb(const struct rohc_comp *const comp __attribute__((unused)),
 	return 0; /* fake */
 }
 
+
+/**
+ * @brief Count the traces of the library
+ *
+ * @param priv_ctxt  The number of traces
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void count_traces_cb(void *const priv_ctxt,
+                            const rohc_trace_level_t level __attribute__((unused)),
+                            const rohc_trace_entity_t entity __attribute__((unused)),
+                            const int profile __attribute__((unused)),
+                            const char *const format __attribute__((unused)),
+                            ...)
+{
+	size_t *const traces_nr = (size_t *) priv_ctxt;
+
+	(*traces_nr)++;
+}
+
+
+#if HAVE_PTHREAD_H == 1
+
+/**
+ * @brief Compress the packets of one flow on one shard of a pool
+ *
+ * The first ROHC packet shall be an IR packet, the last one shall not. All
+ * the ROHC packets shall be sent on the same context, with one of the CIDs
+ * of the shard.
+ *
+ * @param arg  The thread that compresses, as a \ref pool_worker
+ * @return     Always NULL, the result is stored in the \ref pool_worker
+ */
+static void * pool_worker_run(void *const arg)
+{
+	const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+	struct pool_worker *const worker = (struct pool_worker *) arg;
+	const struct rohc_buf ip_pkt =
+		rohc_buf_init_full(worker->ip_buf, sizeof(worker->ip_buf), ts);
+	uint8_t rohc_buf[100];
+	struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buf, 100);
+	rohc_comp_last_packet_info2_t last_info;
+	size_t i;
+
+	worker->is_success = false;
+
+	for(i = 0; i < POOL_THREAD_PACKETS_NR; i++)
+	{
+		rohc_pkt.len = 0;
+		if(rohc_compress4(worker->shard, ip_pkt, &rohc_pkt) != ROHC_STATUS_OK)
+		{
+			goto error;
+		}
+		memset(&last_info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		if(!rohc_comp_get_last_packet_info2(worker->shard, &last_info))
+		{
+			goto error;
+		}
+		if(i == 0)
+		{
+			if(last_info.packet_type != ROHC_PACKET_IR)
+			{
+				goto error;
+			}
+			worker->cid = last_info.context_id;
+		}
+		if(last_info.context_id != worker->cid ||
+		   worker->cid < worker->first_cid ||
+		   worker->cid >= (worker->first_cid + worker->cids_nr))
+		{
+			goto error;
+		}
+
+		/* the CID is sent in an Add-CID octet, except for CID 0 */
+		if(worker->cid != 0 && rohc_buf_byte(rohc_pkt) != (0xe0 | worker->cid))
+		{
+			goto error;
+		}
+		if(worker->cid == 0 && (rohc_buf_byte(rohc_pkt) & 0xf0) == 0xe0)
+		{
+			goto error;
+		}
+	}
+	if(last_info.packet_type == ROHC_PACKET_IR)
+	{
+		goto error;
+	}
+
+	worker->is_success = true;
+
+error:
+	return NULL;
+}
+
+#endif
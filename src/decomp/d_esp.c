@@ -31,6 +31,7 @@
 #include "rohc_debug.h"
 #include "rohc_utils.h"
 #include "crc.h"
+#include "rohc_snapshot.h"
 #include "protocols/esp.h"
 #include "schemes/decomp_wlsb.h"
 
@@ -66,9 +67,10 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_esp_destroy(const struct rohc_decomp_ctxt *const context,
+                          struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
 
 static int esp_parse_static_esp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
@@ -95,6 +97,14 @@ static void esp_update_context(struct rohc_decomp_ctxt *const context,
                                const struct rohc_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
+static rohc_status_t d_esp_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_esp_import_ctxt(struct rohc_decomp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 
 /*
  * Private function definitions
@@ -136,7 +146,8 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the ESP-specific part of the context */
-	esp_context = malloc(sizeof(struct d_esp_context));
+	esp_context = rohc_slab_malloc(&context->decompressor->ctxt_slab,
+	                               sizeof(struct d_esp_context));
 	if(esp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -148,7 +159,8 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN (same shift value as RTP) */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_ESP_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(32);
+	rfc3095_ctxt->sn_lsb_ctxt =
+		rohc_lsb_new(&context->decompressor->ctxt_slab, 32);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -170,7 +182,9 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the ESP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct esphdr));
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 sizeof(struct esphdr));
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -181,7 +195,9 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct esphdr));
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct esphdr));
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 sizeof(struct esphdr));
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -197,13 +213,15 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
+	rohc_lsb_free(&context->decompressor->ctxt_slab,
+	              rfc3095_ctxt->sn_lsb_ctxt);
 free_esp_context:
-	zfree(esp_context);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab, rfc3095_ctxt->specific);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 quit:
 	return false;
 }
@@ -215,23 +233,28 @@ quit:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * @param context       The decompression context
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
  * @param volat_ctxt    The volatile decompression context
  */
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_esp_destroy(const struct rohc_decomp_ctxt *const context,
+                          struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
 	/* clean ESP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the LSB decoding context for SN */
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
+	rohc_lsb_free(&context->decompressor->ctxt_slab,
+	              rfc3095_ctxt->sn_lsb_ctxt);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -378,6 +401,12 @@ static bool esp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 	rohc_decomp_debug(context, "decoded SPI = 0x%08x",
 	                  rohc_ntoh32(decoded->esp_spi));
 
+	/* the SPI is a CRC-STATIC field */
+	if(memcmp(&decoded->esp_spi, &esp->spi, spi_length) != 0)
+	{
+		decoded->crc_static_changed = true;
+	}
+
 	return true;
 }
 
@@ -433,6 +462,59 @@ static void esp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Write the ESP part of the given context in a snapshot
+ *
+ * The generic part of the context is written first, then the ESP SPI.
+ *
+ * @param context   The decompression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          \ref ROHC_STATUS_OK if the context was exported,
+ *                  \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the snapshot is too
+ *                  small,
+ *                  \ref ROHC_STATUS_ERROR if the context cannot be exported
+ */
+static rohc_status_t d_esp_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const struct d_esp_context *const esp_context = rfc3095_ctxt->specific;
+	rohc_status_t status;
+
+	status = rohc_decomp_rfc3095_export(context, snapshot);
+	if(status != ROHC_STATUS_OK)
+	{
+		return status;
+	}
+
+	if(!rohc_snapshot_put32(snapshot, esp_context->spi))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the ESP part of the given context from a snapshot
+ *
+ * @param context   The decompression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool d_esp_import_ctxt(struct rohc_decomp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	struct d_esp_context *const esp_context = rfc3095_ctxt->specific;
+
+	return (rohc_decomp_rfc3095_import(context, snapshot) &&
+	        rohc_snapshot_get32(snapshot, &esp_context->spi));
+}
+
+
 /**
  * @brief Define the decompression part of the ESP profile as described
  *        in the RFC 3095.
@@ -441,6 +523,10 @@ const struct rohc_decomp_profile d_esp_profile =
 {
 	.id              = ROHC_PROFILE_ESP, /* profile ID (RFC 3095, §8) */
 	.msn_max_bits    = 32,
+	.ctxt_objs_sizes = { ROHC_DECOMP_RFC3095_CTXT_OBJS_SIZES,
+	                     sizeof(struct rohc_lsb_decode),
+	                     sizeof(struct d_esp_context),
+	                     sizeof(struct esphdr), sizeof(struct esphdr) },
 	.new_context     = (rohc_decomp_new_context_t) d_esp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_esp_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
@@ -450,5 +536,7 @@ const struct rohc_decomp_profile d_esp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.export_ctxt     = d_esp_export_ctxt,
+	.import_ctxt     = d_esp_import_ctxt,
 };
 
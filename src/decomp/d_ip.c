@@ -45,9 +45,10 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_ip_destroy(const struct rohc_decomp_ctxt *const context,
+                         struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
 
 
 /**
@@ -87,7 +88,8 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
+	rfc3095_ctxt->sn_lsb_ctxt =
+		rohc_lsb_new(&context->decompressor->ctxt_slab, 16);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -102,7 +104,7 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_context:
-	zfree(rfc3095_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 quit:
 	return false;
 }
@@ -114,14 +116,17 @@ quit:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * @param context       The decompression context
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
  * @param volat_ctxt    The volatile decompression context
  */
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_ip_destroy(const struct rohc_decomp_ctxt *const context,
+                         struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_lsb_free(&context->decompressor->ctxt_slab,
+	              rfc3095_ctxt->sn_lsb_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -779,6 +784,8 @@ const struct rohc_decomp_profile d_ip_profile =
 {
 	.id              = ROHC_PROFILE_IP, /* profile ID (see 5 in RFC 3843) */
 	.msn_max_bits    = 16,
+	.ctxt_objs_sizes = { ROHC_DECOMP_RFC3095_CTXT_OBJS_SIZES,
+	                     sizeof(struct rohc_lsb_decode) },
 	.new_context     = (rohc_decomp_new_context_t) d_ip_create,
 	.free_context    = (rohc_decomp_free_context_t) d_ip_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
@@ -788,5 +795,7 @@ const struct rohc_decomp_profile d_ip_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.export_ctxt     = rohc_decomp_rfc3095_export,
+	.import_ctxt     = rohc_decomp_rfc3095_import,
 };
 
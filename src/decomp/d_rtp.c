@@ -35,6 +35,7 @@
 #include "rohc_utils.h"
 #include "sdvl.h"
 #include "crc.h"
+#include "rohc_snapshot.h"
 #include "schemes/decomp_scaled_rtp_ts.h"
 #include "rohc_decomp_detect_packet.h"
 #include "protocols/udp.h"
@@ -74,9 +75,10 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_rtp_destroy(const struct rohc_decomp_ctxt *const context,
+                          struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
 
 static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -142,6 +144,14 @@ static void rtp_update_context(struct rohc_decomp_ctxt *const context,
                                const struct rohc_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
+static rohc_status_t d_rtp_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_rtp_import_ctxt(struct rohc_decomp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 
 /*
  * Prototypes of private helper functions
@@ -194,7 +204,8 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the RTP-specific part of the context */
-	rtp_context = malloc(sizeof(struct d_rtp_context));
+	rtp_context = rohc_slab_malloc(&context->decompressor->ctxt_slab,
+	                               sizeof(struct d_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -206,7 +217,8 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_RTP_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
+	rfc3095_ctxt->sn_lsb_ctxt =
+		rohc_lsb_new(&context->decompressor->ctxt_slab, 16);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -232,7 +244,9 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the UDP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(nh_len);
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 nh_len);
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -243,7 +257,9 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, nh_len);
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(nh_len);
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 nh_len);
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -258,8 +274,10 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the scaled RTP Timestamp decoding context */
 	rtp_context->ts_scaled_ctxt =
-		d_create_sc(context->decompressor->trace_callback,
-		            context->decompressor->trace_callback_priv);
+		d_create_sc(&context->decompressor->ctxt_slab,
+		            context->decompressor->trace_callback,
+		            context->decompressor->trace_callback_priv,
+		            context->decompressor->trace_min_level);
 	if(rtp_context->ts_scaled_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -270,15 +288,18 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_inner_ip_changes_next_header:
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->inner_ip_changes->next_header);
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
+	rohc_lsb_free(&context->decompressor->ctxt_slab,
+	              rfc3095_ctxt->sn_lsb_ctxt);
 free_rtp_context:
-	zfree(rtp_context);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab, rfc3095_ctxt->specific);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 quit:
 	return false;
 }
@@ -290,29 +311,35 @@ quit:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * @param context       The decompression context
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
  * @param volat_ctxt    The volatile decompression context
  */
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_rtp_destroy(const struct rohc_decomp_ctxt *const context,
+                          struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
 	const struct d_rtp_context *const rtp_context =
 		(struct d_rtp_context *) rfc3095_ctxt->specific;
 
 	/* destroy the scaled RTP Timestamp decoding object */
-	rohc_ts_scaled_free(rtp_context->ts_scaled_ctxt);
+	rohc_ts_scaled_free(&context->decompressor->ctxt_slab,
+	                    rtp_context->ts_scaled_ctxt);
 
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the LSB decoding context for SN */
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
+	rohc_lsb_free(&context->decompressor->ctxt_slab,
+	              rfc3095_ctxt->sn_lsb_ctxt);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -1591,6 +1618,12 @@ static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 	rohc_decomp_debug(context, "decoded UDP destination port = 0x%04x",
 	                  rohc_ntoh16(decoded->udp_dst));
 
+	/* the UDP ports are CRC-STATIC fields */
+	if(decoded->udp_src != udp->source || decoded->udp_dst != udp->dest)
+	{
+		decoded->crc_static_changed = true;
+	}
+
 	/* take UDP checksum behavior from packet if present, otherwise from context */
 	if(bits->udp_check_present != ROHC_TRISTATE_NONE)
 	{
@@ -1795,6 +1828,17 @@ static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 	}
 	rohc_decomp_debug(context, "decoded SSRC = %u", decoded->rtp_ssrc);
 
+	/* the V, P, X, CC and SSRC fields of the RTP header are CRC-STATIC
+	 * fields */
+	if(decoded->rtp_version != rtp->version ||
+	   decoded->rtp_p != rtp->padding ||
+	   decoded->rtp_x != rtp->extension ||
+	   decoded->rtp_cc != rtp->cc ||
+	   decoded->rtp_ssrc != rtp->ssrc)
+	{
+		decoded->crc_static_changed = true;
+	}
+
 	return true;
 
 error:
@@ -1897,6 +1941,71 @@ static void rtp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Write the RTP part of the given context in a snapshot
+ *
+ * The generic part of the context is written first, then the RTP SSRC, whether the UDP checksum is used and the state of the TS decoding.
+ *
+ * @param context   The decompression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          \ref ROHC_STATUS_OK if the context was exported,
+ *                  \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the snapshot is too
+ *                  small,
+ *                  \ref ROHC_STATUS_ERROR if the context cannot be exported
+ */
+static rohc_status_t d_rtp_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	rohc_status_t status;
+
+	status = rohc_decomp_rfc3095_export(context, snapshot);
+	if(status != ROHC_STATUS_OK)
+	{
+		return status;
+	}
+
+	if(!rohc_snapshot_put32(snapshot, rtp_context->ssrc) ||
+	   !rohc_snapshot_put8(snapshot, rtp_context->udp_check_present) ||
+	   !d_ts_sc_export(rtp_context->ts_scaled_ctxt, snapshot))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the RTP part of the given context from a snapshot
+ *
+ * @param context   The decompression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool d_rtp_import_ctxt(struct rohc_decomp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	uint8_t udp_check_present;
+
+	if(!rohc_decomp_rfc3095_import(context, snapshot) ||
+	   !rohc_snapshot_get32(snapshot, &rtp_context->ssrc) ||
+	   !rohc_snapshot_get8(snapshot, &udp_check_present) ||
+	   udp_check_present > ROHC_TRISTATE_NO ||
+	   !d_ts_sc_import(rtp_context->ts_scaled_ctxt, snapshot))
+	{
+		return false;
+	}
+	rtp_context->udp_check_present = udp_check_present;
+
+	return true;
+}
+
+
 /*
  * Private helper functions
  */
@@ -1958,6 +2067,14 @@ const struct rohc_decomp_profile d_rtp_profile =
 {
 	.id              = ROHC_PROFILE_RTP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.ctxt_objs_sizes = { ROHC_DECOMP_RFC3095_CTXT_OBJS_SIZES,
+	                     sizeof(struct rohc_lsb_decode),
+	                     sizeof(struct d_rtp_context),
+	                     sizeof(struct udphdr) + sizeof(struct rtphdr),
+	                     sizeof(struct udphdr) + sizeof(struct rtphdr),
+	                     sizeof(struct ts_sc_decomp),
+	                     sizeof(struct rohc_lsb_decode),
+	                     sizeof(struct rohc_lsb_decode) },
 	.new_context     = (rohc_decomp_new_context_t) d_rtp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_rtp_destroy,
 	.detect_pkt_type = rtp_detect_packet_type,
@@ -1967,5 +2084,7 @@ const struct rohc_decomp_profile d_rtp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.export_ctxt     = d_rtp_export_ctxt,
+	.import_ctxt     = d_rtp_import_ctxt,
 };
 
@@ -39,6 +39,7 @@
 #include "rohc_traces_internal.h"
 #include "rohc_utils.h"
 #include "rohc_debug.h"
+#include "rohc_snapshot.h"
 #include "schemes/rfc4996.h"
 #include "schemes/decomp_wlsb.h"
 #include "schemes/tcp_sack.h"
@@ -55,6 +56,16 @@
 #include <stdint.h>
 
 
+/**
+ * @brief The maximum length (in bytes) of the base header of one CO packet
+ *
+ * The largest base header is the co_common one with all its optional fields:
+ * 7 bytes of fixed fields, then up to 4 + 4 + 2 + 2 + 2 + 2 + 1 + 1 bytes of
+ * variable fields.
+ */
+#define D_TCP_CO_BASE_HDR_MAX_LEN  32U
+
+
 /*
  * Private function prototypes.
  */
@@ -64,9 +75,10 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
+static void d_tcp_destroy(const struct rohc_decomp_ctxt *const context,
+                          struct d_tcp_context *const tcp_context,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
 
 static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -77,6 +89,13 @@ static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const
 static uint32_t d_tcp_get_msn(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
+static rohc_status_t d_tcp_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool d_tcp_import_ctxt(struct rohc_decomp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 /* parsing */
 static bool d_tcp_parse_packet(const struct rohc_decomp_ctxt *const context,
                                const struct rohc_buf rohc_packet,
@@ -330,12 +349,11 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
                                       struct rohc_buf *const uncomp_hdrs,
                                       size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
-static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
-                                   const struct rohc_decomp_ctxt *const context,
+static bool d_tcp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
                                    struct rohc_buf *const uncomp_hdrs,
                                    const rohc_crc_type_t crc_type,
                                    const uint8_t crc_packet)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 /* CRC repair */
 static bool d_tcp_attempt_repair(const struct rohc_decomp *const decomp,
@@ -368,10 +386,11 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
                          struct d_tcp_context **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = &context->decompressor->ctxt_slab;
 	struct d_tcp_context *tcp_context;
 
 	/* allocate memory for the context */
-	*persist_ctxt = malloc(sizeof(struct d_tcp_context));
+	*persist_ctxt = rohc_slab_malloc(slab, sizeof(struct d_tcp_context));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -382,7 +401,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	memset(tcp_context, 0, sizeof(struct d_tcp_context));
 
 	/* create the LSB decoding context for the MSN */
-	tcp_context->msn_lsb_ctxt = rohc_lsb_new(16);
+	tcp_context->msn_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(tcp_context->msn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -391,7 +410,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the innermost IP-ID */
-	tcp_context->ip_id_lsb_ctxt = rohc_lsb_new(16);
+	tcp_context->ip_id_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(tcp_context->ip_id_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -401,7 +420,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the innermost TTL/HL */
-	tcp_context->ttl_hl_lsb_ctxt = rohc_lsb_new(8);
+	tcp_context->ttl_hl_lsb_ctxt = rohc_lsb_new(slab, 8);
 	if(tcp_context->ttl_hl_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -411,7 +430,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the TCP window */
-	tcp_context->window_lsb_ctxt = rohc_lsb_new(16);
+	tcp_context->window_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(tcp_context->window_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -420,7 +439,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the sequence number */
-	tcp_context->seq_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->seq_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->seq_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -430,7 +449,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the scaled sequence number */
-	tcp_context->seq_scaled_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->seq_scaled_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->seq_scaled_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -440,7 +459,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the ACK number */
-	tcp_context->ack_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->ack_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->ack_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -450,7 +469,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the scaled acknowledgment number */
-	tcp_context->ack_scaled_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->ack_scaled_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->ack_scaled_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -466,7 +485,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for the TCP option Timestamp echo
 	 * request */
-	tcp_context->opt_ts_req_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->opt_ts_req_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->opt_ts_req_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -477,7 +496,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for the TCP option Timestamp echo
 	 * reply */
-	tcp_context->opt_ts_rep_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->opt_ts_rep_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->opt_ts_rep_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -489,14 +508,16 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_tcp_extr_bits));
+	volat_ctxt->extr_bits =
+		rohc_slab_malloc(slab, sizeof(struct rohc_tcp_extr_bits));
 	if(volat_ctxt->extr_bits == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
 		                 "of one of the TCP decompression context");
 		goto free_lsb_ts_opt_rep;
 	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_tcp_decoded_values));
+	volat_ctxt->decoded_values =
+		rohc_slab_malloc(slab, sizeof(struct rohc_tcp_decoded_values));
 	if(volat_ctxt->decoded_values == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
@@ -507,29 +528,29 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
+	rohc_slab_zfree(slab, volat_ctxt->extr_bits);
 free_lsb_ts_opt_rep:
-	rohc_lsb_free(tcp_context->opt_ts_rep_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->opt_ts_rep_lsb_ctxt);
 free_lsb_ts_opt_req:
-	rohc_lsb_free(tcp_context->opt_ts_req_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->opt_ts_req_lsb_ctxt);
 free_lsb_scaled_ack:
-	rohc_lsb_free(tcp_context->ack_scaled_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ack_scaled_lsb_ctxt);
 free_lsb_ack:
-	rohc_lsb_free(tcp_context->ack_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ack_lsb_ctxt);
 free_lsb_scaled_seq:
-	rohc_lsb_free(tcp_context->seq_scaled_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->seq_scaled_lsb_ctxt);
 free_lsb_seq:
-	rohc_lsb_free(tcp_context->seq_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->seq_lsb_ctxt);
 free_lsb_window:
-	rohc_lsb_free(tcp_context->window_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->window_lsb_ctxt);
 free_lsb_ttl_hl:
-	rohc_lsb_free(tcp_context->ttl_hl_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ttl_hl_lsb_ctxt);
 free_lsb_ip_id:
-	rohc_lsb_free(tcp_context->ip_id_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ip_id_lsb_ctxt);
 free_lsb_msn:
-	rohc_lsb_free(tcp_context->msn_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->msn_lsb_ctxt);
 destroy_context:
-	zfree(tcp_context);
+	rohc_slab_zfree(slab, *persist_ctxt);
 quit:
 	return false;
 }
@@ -541,41 +562,45 @@ quit:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * @param context      The decompression context
  * @param tcp_context  The persistent decompression context for the TCP profile
  * @param volat_ctxt   The volatile decompression context
  */
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
+static void d_tcp_destroy(const struct rohc_decomp_ctxt *const context,
+                          struct d_tcp_context *const tcp_context,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = &context->decompressor->ctxt_slab;
+
 	/* destroy the LSB decoding context for the TCP option Timestamp echo
 	 * request */
-	rohc_lsb_free(tcp_context->opt_ts_req_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->opt_ts_req_lsb_ctxt);
 	/* destroy the LSB decoding context for the TCP option Timestamp echo
 	 * reply */
-	rohc_lsb_free(tcp_context->opt_ts_rep_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->opt_ts_rep_lsb_ctxt);
 	/* destroy the LSB decoding context for the scaled acknowledgment number */
-	rohc_lsb_free(tcp_context->ack_scaled_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ack_scaled_lsb_ctxt);
 	/* destroy the LSB decoding context for the ACK number */
-	rohc_lsb_free(tcp_context->ack_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ack_lsb_ctxt);
 	/* destroy the LSB decoding context for the scaled sequence number */
-	rohc_lsb_free(tcp_context->seq_scaled_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->seq_scaled_lsb_ctxt);
 	/* destroy the LSB decoding context for the sequence number */
-	rohc_lsb_free(tcp_context->seq_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->seq_lsb_ctxt);
 	/* destroy the LSB decoding context for the TCP window */
-	rohc_lsb_free(tcp_context->window_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->window_lsb_ctxt);
 	/* destroy the LSB decoding context for the innermost TTL/HL */
-	rohc_lsb_free(tcp_context->ttl_hl_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ttl_hl_lsb_ctxt);
 	/* destroy the LSB decoding context for the innermost IP-ID */
-	rohc_lsb_free(tcp_context->ip_id_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->ip_id_lsb_ctxt);
 	/* destroy the LSB decoding context for the MSN */
-	rohc_lsb_free(tcp_context->msn_lsb_ctxt);
+	rohc_lsb_free(slab, tcp_context->msn_lsb_ctxt);
 
 	/* free the TCP decompression context itself */
-	free(tcp_context);
+	rohc_slab_free(slab, tcp_context);
 
 	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_slab_free(slab, volat_ctxt->decoded_values);
+	rohc_slab_free(slab, volat_ctxt->extr_bits);
 }
 
 
@@ -981,8 +1006,6 @@ error:
  * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
- *
- * @todo TODO: avoid malloc/free of packed_rohc_packet
  */
 static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
                            const uint8_t *const rohc_packet,
@@ -993,11 +1016,14 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
                            struct rohc_tcp_extr_bits *const bits,
                            size_t *const rohc_hdr_len)
 {
-	const size_t packed_rohc_packet_max_len = 0xffff + 100;
-	uint8_t *packed_rohc_packet = malloc(packed_rohc_packet_max_len); // TODO: change that
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	int ret;
 
+	/* the base header without the large CID field in the middle of it */
+	uint8_t packed_base_hdr[D_TCP_CO_BASE_HDR_MAX_LEN];
+	const uint8_t *base_hdr;
+	size_t base_hdr_max_len;
+
 	/* remaining ROHC data not parsed yet */
 	const uint8_t *rohc_remain_data;
 	size_t rohc_remain_len;
@@ -1021,9 +1047,6 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	assert(large_cid_len <= 2);
 	assert(packet_type != ROHC_PACKET_UNKNOWN);
 
-#ifndef __clang_analyzer__ /* silent warning about value never read */
-	rohc_remain_data = (uint8_t *) rohc_packet;
-#endif
 	rohc_remain_len = rohc_length;
 
 	rohc_decomp_debug(context, "large_cid_len = %zu, rohc_length = %zu",
@@ -1042,18 +1065,24 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* copy the first byte of header over the last byte of the large CID field
-	 * to be able to map packet strutures to the ROHC bytes */
-	if((rohc_remain_len - large_cid_len) > packed_rohc_packet_max_len)
+	/* the large CID field is located after the first byte of the base header:
+	 * copy the first byte and the rest of the base header side by side in a
+	 * small buffer to be able to map packet structures to the ROHC bytes, the
+	 * data after the base header is parsed in place */
+	rohc_remain_len -= large_cid_len;
+	if(large_cid_len == 0)
 	{
-		rohc_decomp_warn(context, "internal problem: internal buffer too small");
-		goto error;
+		base_hdr = rohc_packet;
+		base_hdr_max_len = rohc_remain_len;
+	}
+	else
+	{
+		base_hdr_max_len = rohc_min(rohc_remain_len, D_TCP_CO_BASE_HDR_MAX_LEN);
+		packed_base_hdr[0] = rohc_packet[0];
+		memcpy(packed_base_hdr + 1, rohc_packet + 1 + large_cid_len,
+		       base_hdr_max_len - 1);
+		base_hdr = packed_base_hdr;
 	}
-	packed_rohc_packet[0] = rohc_packet[0];
-	memcpy(packed_rohc_packet + 1, rohc_packet + 1 + large_cid_len,
-	       rohc_remain_len - 1 - large_cid_len);
-	rohc_remain_data = packed_rohc_packet;
-	rohc_remain_len -= large_cid_len;
 	*rohc_hdr_len = 0;
 
 	/* parse the packet type we detected earlier */
@@ -1118,19 +1147,20 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	}
 	{
 		size_t co_pkt_len;
-		if(!parse_co_pkt(context, rohc_remain_data, rohc_remain_len,
+		if(!parse_co_pkt(context, base_hdr, base_hdr_max_len,
 		                 extr_crc, bits, &co_pkt_len, &has_opts_list))
 		{
 			rohc_decomp_warn(context, "failed to parse %s packet (type %d)",
 			                 rohc_get_packet_descr(packet_type), packet_type);
 			goto error;
 		}
-		rohc_remain_data += co_pkt_len;
+		assert(co_pkt_len > 0);
+		assert(co_pkt_len <= base_hdr_max_len);
+		rohc_remain_data = rohc_packet + large_cid_len + co_pkt_len;
 		rohc_remain_len -= co_pkt_len;
 		(*rohc_hdr_len) += co_pkt_len;
 	}
-	rohc_decomp_dump_buf(context, "ROHC base header", packed_rohc_packet,
-	                     *rohc_hdr_len);
+	rohc_decomp_dump_buf(context, "ROHC base header", base_hdr, *rohc_hdr_len);
 
 	/* innermost IP-ID behavior */
 	if(inner_ip_bits->id_behavior_nr > 0)
@@ -1205,11 +1235,9 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	*rohc_hdr_len += large_cid_len;
 	assert((*rohc_hdr_len) <= rohc_length);
 
-	free(packed_rohc_packet);
 	return true;
 
 error:
-	free(packed_rohc_packet);
 	return false;
 }
 
@@ -2918,6 +2946,13 @@ static bool d_tcp_decode_bits_ip_hdr(const struct rohc_decomp_ctxt *const contex
 						memcpy(&(ip_decoded->opts[ext_pos]), &(ip_bits->opts[ext_pos]),
 						       sizeof(ip_option_context_t));
 					}
+					else
+					{
+						/* extension header unchanged, take it from context */
+						memcpy(&(ip_decoded->opts[ext_pos]),
+						       &(ip_context->opts[ext_pos]),
+						       sizeof(ip_option_context_t));
+					}
 					break;
 				default:
 					assert(0);
@@ -3996,7 +4031,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->type != ROHC_CRC_TYPE_NONE)
 	{
-		const bool crc_ok = d_tcp_check_uncomp_crc(decomp, context, uncomp_hdrs,
+		const bool crc_ok = d_tcp_check_uncomp_crc(context, uncomp_hdrs,
 		                                           extr_crc->type, extr_crc->bits);
 		if(!crc_ok)
 		{
@@ -4007,8 +4042,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 			                 rohc_get_mode_descr(context->mode));
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
-				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+				rohc_dump_packet(decomp, ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				                 "uncompressed headers", *uncomp_hdrs);
 			}
 			goto error_crc;
@@ -4017,8 +4051,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 
 	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
-		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
+		rohc_dump_packet(decomp, ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
 		                 "IP/TCP headers", *uncomp_hdrs);
 	}
 
@@ -4034,32 +4067,27 @@ error_output_too_small:
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
- * @param decomp       The ROHC decompressor
  * @param context      The decompression context
  * @param uncomp_hdrs  The uncompressed headers
  * @param crc_type     The type of CRC
  * @param crc_packet   The CRC extracted from the ROHC header
  * @return             true if the CRC is correct, false otherwise
  */
-static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
-                                   const struct rohc_decomp_ctxt *const context,
+static bool d_tcp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
                                    struct rohc_buf *const uncomp_hdrs,
                                    const rohc_crc_type_t crc_type,
                                    const uint8_t crc_packet)
 {
-	const uint8_t *crc_table;
 	uint8_t crc_computed;
 
-	/* determine the initial value and the pre-computed table for the CRC */
+	/* determine the initial value for the CRC */
 	switch(crc_type)
 	{
 		case ROHC_CRC_TYPE_3:
 			crc_computed = CRC_INIT_3;
-			crc_table = decomp->crc_table_3;
 			break;
 		case ROHC_CRC_TYPE_7:
 			crc_computed = CRC_INIT_7;
-			crc_table = decomp->crc_table_7;
 			break;
 		case ROHC_CRC_TYPE_8:
 			rohc_decomp_warn(context, "unexpected CRC type %d", crc_type);
@@ -4075,7 +4103,7 @@ static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
 	/* compute the CRC from built uncompressed headers */
 	crc_computed =
 		crc_calculate(crc_type, rohc_buf_data(*uncomp_hdrs), uncomp_hdrs->len,
-		              crc_computed, crc_table);
+		              crc_computed);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_type, crc_computed);
 
@@ -4349,6 +4377,284 @@ static uint32_t d_tcp_get_msn(const struct rohc_decomp_ctxt *const context)
 }
 
 
+/**
+ * @brief Write the TCP context in a snapshot
+ *
+ * The IP contexts are written first with their IPv6 extension headers, then
+ * the TCP fields, the LSB decoding contexts and the context of the TCP
+ * options.
+ *
+ * @param context   The decompression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          \ref ROHC_STATUS_OK if the context was exported,
+ *                  \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the snapshot is too
+ *                  small,
+ *                  \ref ROHC_STATUS_ERROR if the context cannot be exported
+ */
+static rohc_status_t d_tcp_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       struct rohc_buf *const snapshot)
+{
+	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	size_t i;
+
+	if(!rohc_lsb_is_ready(tcp_context->msn_lsb_ctxt))
+	{
+		rohc_decomp_debug(context, "cannot export context that decompressed "
+		                  "no packet yet");
+		return ROHC_STATUS_ERROR;
+	}
+
+	/* the IP headers */
+	if(!rohc_snapshot_put8(snapshot, tcp_context->ip_contexts_nr))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+		size_t j;
+
+		if(!rohc_snapshot_put8(snapshot, ip_context->version) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.dscp) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.ip_ecn_flags) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.next_header) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.ttl_hopl) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->ctxt.vx.ip_id_behavior))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+		if(ip_context->version == IPV4)
+		{
+			if(!rohc_snapshot_put8(snapshot, ip_context->ctxt.v4.df) ||
+			   !rohc_snapshot_put16(snapshot, ip_context->ctxt.v4.ip_id) ||
+			   !rohc_snapshot_put(snapshot, &ip_context->ctxt.v4.src_addr, 4) ||
+			   !rohc_snapshot_put(snapshot, &ip_context->ctxt.v4.dst_addr, 4))
+			{
+				return ROHC_STATUS_OUTPUT_TOO_SMALL;
+			}
+			continue;
+		}
+		if(!rohc_snapshot_put32(snapshot, ip_context->ctxt.v6.flow_label) ||
+		   !rohc_snapshot_put(snapshot, ip_context->ctxt.v6.src_addr, 16) ||
+		   !rohc_snapshot_put(snapshot, ip_context->ctxt.v6.dest_addr, 16) ||
+		   !rohc_snapshot_put8(snapshot, ip_context->opts_nr))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+		for(j = 0; j < ip_context->opts_nr; j++)
+		{
+			const ip_option_context_t *const opt = &(ip_context->opts[j]);
+
+			if(!rohc_snapshot_put16(snapshot, opt->len) ||
+			   !rohc_snapshot_put8(snapshot, opt->proto) ||
+			   !rohc_snapshot_put8(snapshot, opt->nh_proto) ||
+			   !rohc_snapshot_put16(snapshot, opt->generic.data_len) ||
+			   !rohc_snapshot_put(snapshot, opt->generic.data,
+			                      opt->generic.data_len))
+			{
+				return ROHC_STATUS_OUTPUT_TOO_SMALL;
+			}
+		}
+	}
+
+	/* the TCP header */
+	if(!rohc_snapshot_put16(snapshot, tcp_context->tcp_src_port) ||
+	   !rohc_snapshot_put16(snapshot, tcp_context->tcp_dst_port) ||
+	   !rohc_snapshot_put32(snapshot, tcp_context->seq_num_residue) ||
+	   !rohc_snapshot_put16(snapshot, tcp_context->ack_stride) ||
+	   !rohc_snapshot_put16(snapshot, tcp_context->ack_num_residue) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->res_flags) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->ecn_used) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->ecn_flags) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->urg_flag) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->ack_flag) ||
+	   !rohc_snapshot_put8(snapshot, tcp_context->rsf_flags) ||
+	   !rohc_snapshot_put16(snapshot, tcp_context->urg_ptr) ||
+	   !rohc_lsb_export(tcp_context->msn_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->ip_id_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->ttl_hl_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->seq_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->seq_scaled_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->ack_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->ack_scaled_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->window_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->opt_ts_req_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_export(tcp_context->opt_ts_rep_lsb_ctxt, snapshot) ||
+	   !d_tcp_opts_export(&tcp_context->tcp_opts, snapshot) ||
+	   !d_tcp_sack_export(&tcp_context->opt_sack_blocks, snapshot))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the TCP context from a snapshot
+ *
+ * @param context   The decompression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool d_tcp_import_ctxt(struct rohc_decomp_ctxt *const context,
+                              struct rohc_buf *const snapshot)
+{
+	struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	uint8_t ip_contexts_nr;
+	uint8_t flags[6];
+	size_t i;
+
+	/* the IP headers */
+	if(!rohc_snapshot_get8(snapshot, &ip_contexts_nr) ||
+	   ip_contexts_nr == 0 || ip_contexts_nr > ROHC_TCP_MAX_IP_HDRS)
+	{
+		rohc_decomp_warn(context, "malformed number of IP headers in snapshot");
+		goto error;
+	}
+	for(i = 0; i < ip_contexts_nr; i++)
+	{
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+		uint8_t fields[6];
+		size_t j;
+
+		for(j = 0; j < 6; j++)
+		{
+			if(!rohc_snapshot_get8(snapshot, &fields[j]))
+			{
+				goto malformed_ip;
+			}
+		}
+		if((fields[0] != IPV4 && fields[0] != IPV6) ||
+		   fields[1] > 0x3f || fields[2] > 0x03 ||
+		   fields[5] > IP_ID_BEHAVIOR_ZERO)
+		{
+			goto malformed_ip;
+		}
+		ip_context->version = fields[0];
+		ip_context->ctxt.vx.version = fields[0];
+		ip_context->ctxt.vx.dscp = fields[1];
+		ip_context->ctxt.vx.ip_ecn_flags = fields[2];
+		ip_context->ctxt.vx.next_header = fields[3];
+		ip_context->ctxt.vx.ttl_hopl = fields[4];
+		ip_context->ctxt.vx.ip_id_behavior = fields[5];
+
+		if(ip_context->version == IPV4)
+		{
+			uint16_t ip_id;
+			uint8_t df;
+
+			if(!rohc_snapshot_get8(snapshot, &df) || df > 1 ||
+			   !rohc_snapshot_get16(snapshot, &ip_id) ||
+			   !rohc_snapshot_get(snapshot, &ip_context->ctxt.v4.src_addr, 4) ||
+			   !rohc_snapshot_get(snapshot, &ip_context->ctxt.v4.dst_addr, 4))
+			{
+				goto malformed_ip;
+			}
+			ip_context->ctxt.v4.df = df;
+			ip_context->ctxt.v4.ip_id = ip_id;
+			ip_context->opts_nr = 0;
+			ip_context->opts_len = 0;
+		}
+		else
+		{
+			uint32_t flow_label;
+			uint8_t opts_nr;
+
+			if(!rohc_snapshot_get32(snapshot, &flow_label) ||
+			   flow_label > 0xfffff ||
+			   !rohc_snapshot_get(snapshot, ip_context->ctxt.v6.src_addr, 16) ||
+			   !rohc_snapshot_get(snapshot, ip_context->ctxt.v6.dest_addr, 16) ||
+			   !rohc_snapshot_get8(snapshot, &opts_nr) ||
+			   opts_nr > ROHC_TCP_MAX_IP_EXT_HDRS)
+			{
+				goto malformed_ip;
+			}
+			ip_context->ctxt.v6.flow_label = flow_label;
+			ip_context->opts_len = 0;
+			for(j = 0; j < opts_nr; j++)
+			{
+				ip_option_context_t *const opt = &(ip_context->opts[j]);
+				uint16_t len;
+				uint16_t data_len;
+
+				if(!rohc_snapshot_get16(snapshot, &len) ||
+				   len < 2 || len > (IPV6_OPT_CTXT_LEN_MAX + 2) ||
+				   !rohc_snapshot_get8(snapshot, &opt->proto) ||
+				   !rohc_snapshot_get8(snapshot, &opt->nh_proto) ||
+				   !rohc_snapshot_get16(snapshot, &data_len) ||
+				   data_len > IPV6_OPT_CTXT_LEN_MAX ||
+				   !rohc_snapshot_get(snapshot, opt->generic.data, data_len))
+				{
+					goto malformed_ip;
+				}
+				opt->len = len;
+				opt->generic.data_len = data_len;
+				ip_context->opts_len += len;
+			}
+			ip_context->opts_nr = opts_nr;
+		}
+	}
+	tcp_context->ip_contexts_nr = ip_contexts_nr;
+
+	/* the TCP header */
+	if(!rohc_snapshot_get16(snapshot, &tcp_context->tcp_src_port) ||
+	   !rohc_snapshot_get16(snapshot, &tcp_context->tcp_dst_port) ||
+	   !rohc_snapshot_get32(snapshot, &tcp_context->seq_num_residue) ||
+	   !rohc_snapshot_get16(snapshot, &tcp_context->ack_stride) ||
+	   !rohc_snapshot_get16(snapshot, &tcp_context->ack_num_residue))
+	{
+		goto malformed_tcp;
+	}
+	for(i = 0; i < 6; i++)
+	{
+		if(!rohc_snapshot_get8(snapshot, &flags[i]))
+		{
+			goto malformed_tcp;
+		}
+	}
+	if(flags[0] > 0x0f || flags[1] > 1 || flags[2] > 0x03 || flags[3] > 1 ||
+	   flags[4] > 1 || flags[5] > 0x07 ||
+	   !rohc_snapshot_get16(snapshot, &tcp_context->urg_ptr) ||
+	   !rohc_lsb_import(tcp_context->msn_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->ip_id_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->ttl_hl_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->seq_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->seq_scaled_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->ack_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->ack_scaled_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->window_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->opt_ts_req_lsb_ctxt, snapshot) ||
+	   !rohc_lsb_import(tcp_context->opt_ts_rep_lsb_ctxt, snapshot))
+	{
+		goto malformed_tcp;
+	}
+	tcp_context->res_flags = flags[0];
+	tcp_context->ecn_used = !!flags[1];
+	tcp_context->ecn_flags = flags[2];
+	tcp_context->urg_flag = !!flags[3];
+	tcp_context->ack_flag = !!flags[4];
+	tcp_context->rsf_flags = flags[5];
+
+	if(!d_tcp_opts_import(&tcp_context->tcp_opts, snapshot) ||
+	   !d_tcp_sack_import(&tcp_context->opt_sack_blocks, snapshot))
+	{
+		rohc_decomp_warn(context, "malformed TCP options in snapshot");
+		goto error;
+	}
+
+	return true;
+
+malformed_ip:
+	rohc_decomp_warn(context, "malformed IP header #%zu in snapshot", i + 1);
+	goto error;
+malformed_tcp:
+	rohc_decomp_warn(context, "malformed TCP header in snapshot");
+error:
+	return false;
+}
+
+
 /**
  * @brief Define the decompression part of the TCP profile as described
  *        in the RFC 3095.
@@ -4357,6 +4663,19 @@ const struct rohc_decomp_profile d_tcp_profile =
 {
 	.id              = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.ctxt_objs_sizes = { sizeof(struct d_tcp_context),
+	                     sizeof(struct rohc_tcp_extr_bits),
+	                     sizeof(struct rohc_tcp_decoded_values),
+	                     sizeof(struct rohc_lsb_decode),   /* MSN */
+	                     sizeof(struct rohc_lsb_decode),   /* IP-ID */
+	                     sizeof(struct rohc_lsb_decode),   /* TTL/HL */
+	                     sizeof(struct rohc_lsb_decode),   /* window */
+	                     sizeof(struct rohc_lsb_decode),   /* seq. number */
+	                     sizeof(struct rohc_lsb_decode),   /* scaled seq. */
+	                     sizeof(struct rohc_lsb_decode),   /* ACK number */
+	                     sizeof(struct rohc_lsb_decode),   /* scaled ACK */
+	                     sizeof(struct rohc_lsb_decode),   /* TS request */
+	                     sizeof(struct rohc_lsb_decode) }, /* TS reply */
 	.new_context     = (rohc_decomp_new_context_t) d_tcp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_tcp_destroy,
 	.detect_pkt_type = tcp_detect_packet_type,
@@ -4365,6 +4684,8 @@ const struct rohc_decomp_profile d_tcp_profile =
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) d_tcp_build_hdrs,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) d_tcp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) d_tcp_attempt_repair,
-	.get_sn          = d_tcp_get_msn
+	.get_sn          = d_tcp_get_msn,
+	.export_ctxt     = d_tcp_export_ctxt,
+	.import_ctxt     = d_tcp_import_ctxt,
 };
 
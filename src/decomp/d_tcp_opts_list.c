@@ -31,6 +31,7 @@
 #include "d_tcp_defines.h"
 #include "protocols/tcp.h"
 #include "rohc_bit_ops.h"
+#include "rohc_snapshot.h"
 #include "rohc_utils.h"
 #include "schemes/tcp_sack.h"
 
@@ -254,6 +255,15 @@ static bool d_tcp_build_generic(const struct rohc_decomp_ctxt *const context,
                                 size_t *const opt_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 
+static bool d_tcp_opt_export(const uint8_t opt_index,
+                             const struct d_tcp_opt_ctxt *const opt,
+                             struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
+static bool d_tcp_opt_import(const uint8_t opt_index,
+                             struct d_tcp_opt_ctxt *const opt,
+                             struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
+
 
 /* TODO */
 static struct d_tcp_opt d_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
@@ -1485,3 +1495,232 @@ error:
 	return false;
 }
 
+
+
+/**
+ * @brief Write the decompression context for TCP options in a snapshot
+ *
+ * The structure of the last list of TCP options is written first, then the
+ * context of every option index. The context is needed by the packets that
+ * do not transmit the list of TCP options.
+ *
+ * @param tcp_opts  The decompression context for TCP options
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool d_tcp_opts_export(const struct d_tcp_opts_ctxt *const tcp_opts,
+                       struct rohc_buf *const snapshot)
+{
+	size_t i;
+
+	if(!rohc_snapshot_put8(snapshot, tcp_opts->nr) ||
+	   !rohc_snapshot_put(snapshot, tcp_opts->structure, tcp_opts->nr))
+	{
+		return false;
+	}
+	for(i = 0; i < tcp_opts->nr; i++)
+	{
+		if(!rohc_snapshot_put8(snapshot, tcp_opts->expected_dynamic[i]) ||
+		   !rohc_snapshot_put8(snapshot, tcp_opts->found[i]))
+		{
+			return false;
+		}
+	}
+
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		if(!d_tcp_opt_export(i, &tcp_opts->bits[i], snapshot))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Read the decompression context for TCP options from a snapshot
+ *
+ * @param tcp_opts  The decompression context for TCP options
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool d_tcp_opts_import(struct d_tcp_opts_ctxt *const tcp_opts,
+                       struct rohc_buf *const snapshot)
+{
+	uint8_t nr;
+	size_t i;
+
+	if(!rohc_snapshot_get8(snapshot, &nr) || nr > ROHC_TCP_OPTS_MAX ||
+	   !rohc_snapshot_get(snapshot, tcp_opts->structure, nr))
+	{
+		return false;
+	}
+	for(i = 0; i < nr; i++)
+	{
+		uint8_t expected_dynamic;
+		uint8_t found;
+
+		if(tcp_opts->structure[i] > MAX_TCP_OPTION_INDEX ||
+		   !rohc_snapshot_get8(snapshot, &expected_dynamic) ||
+		   expected_dynamic > 1 ||
+		   !rohc_snapshot_get8(snapshot, &found) || found > 1)
+		{
+			return false;
+		}
+		tcp_opts->expected_dynamic[i] = !!expected_dynamic;
+		tcp_opts->found[i] = !!found;
+	}
+	tcp_opts->nr = nr;
+
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		if(!d_tcp_opt_import(i, &tcp_opts->bits[i], snapshot))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Write the decompression context of one TCP option in a snapshot
+ *
+ * The index of the option tells which data is written.
+ *
+ * @param opt_index  The index of the TCP option
+ * @param opt        The decompression context of the TCP option
+ * @param snapshot   The snapshot to write to
+ * @return           true if successful, false if the snapshot is too small
+ */
+static bool d_tcp_opt_export(const uint8_t opt_index,
+                             const struct d_tcp_opt_ctxt *const opt,
+                             struct rohc_buf *const snapshot)
+{
+	if(!rohc_snapshot_put8(snapshot, opt->used) ||
+	   !rohc_snapshot_put8(snapshot, opt->type))
+	{
+		return false;
+	}
+
+	switch(opt_index)
+	{
+		case TCP_INDEX_NOP:
+		case TCP_INDEX_SACK_PERM:
+			return true;
+		case TCP_INDEX_EOL:
+			return (rohc_snapshot_put8(snapshot, opt->data.eol.is_static) &&
+			        rohc_snapshot_put8(snapshot, opt->data.eol.len));
+		case TCP_INDEX_MSS:
+			return (rohc_snapshot_put8(snapshot, opt->data.mss.is_static) &&
+			        rohc_snapshot_put16(snapshot, opt->data.mss.value));
+		case TCP_INDEX_WS:
+			return (rohc_snapshot_put8(snapshot, opt->data.ws.is_static) &&
+			        rohc_snapshot_put8(snapshot, opt->data.ws.value));
+		case TCP_INDEX_TS:
+			return (rohc_snapshot_put32(snapshot, opt->data.ts.req.bits) &&
+			        rohc_snapshot_put8(snapshot, opt->data.ts.req.bits_nr) &&
+			        rohc_snapshot_put32(snapshot, opt->data.ts.req.p) &&
+			        rohc_snapshot_put32(snapshot, opt->data.ts.rep.bits) &&
+			        rohc_snapshot_put8(snapshot, opt->data.ts.rep.bits_nr) &&
+			        rohc_snapshot_put32(snapshot, opt->data.ts.rep.p));
+		case TCP_INDEX_SACK:
+			return d_tcp_sack_export(&opt->data.sack, snapshot);
+		default:
+			return (rohc_snapshot_put8(snapshot, opt->data.generic.type) &&
+			        rohc_snapshot_put8(snapshot, opt->data.generic.load_len) &&
+			        rohc_snapshot_put(snapshot, opt->data.generic.load,
+			                          opt->data.generic.load_len));
+	}
+}
+
+
+/**
+ * @brief Read the decompression context of one TCP option from a snapshot
+ *
+ * @param opt_index  The index of the TCP option
+ * @param opt        The decompression context of the TCP option
+ * @param snapshot   The snapshot to read from
+ * @return           true if successful, false if the snapshot is malformed
+ */
+static bool d_tcp_opt_import(const uint8_t opt_index,
+                             struct d_tcp_opt_ctxt *const opt,
+                             struct rohc_buf *const snapshot)
+{
+	uint8_t used;
+	uint8_t is_static;
+	uint8_t generic_type;
+	uint8_t bits_nr[2];
+	uint32_t p[2];
+
+	if(!rohc_snapshot_get8(snapshot, &used) || used > 1 ||
+	   !rohc_snapshot_get8(snapshot, &opt->type))
+	{
+		return false;
+	}
+	opt->used = !!used;
+
+	switch(opt_index)
+	{
+		case TCP_INDEX_NOP:
+		case TCP_INDEX_SACK_PERM:
+			return true;
+		case TCP_INDEX_EOL:
+			if(!rohc_snapshot_get8(snapshot, &is_static) || is_static > 1 ||
+			   !rohc_snapshot_get8(snapshot, &opt->data.eol.len))
+			{
+				return false;
+			}
+			opt->data.eol.is_static = !!is_static;
+			return true;
+		case TCP_INDEX_MSS:
+			if(!rohc_snapshot_get8(snapshot, &is_static) || is_static > 1 ||
+			   !rohc_snapshot_get16(snapshot, &opt->data.mss.value))
+			{
+				return false;
+			}
+			opt->data.mss.is_static = !!is_static;
+			return true;
+		case TCP_INDEX_WS:
+			if(!rohc_snapshot_get8(snapshot, &is_static) || is_static > 1 ||
+			   !rohc_snapshot_get8(snapshot, &opt->data.ws.value))
+			{
+				return false;
+			}
+			opt->data.ws.is_static = !!is_static;
+			return true;
+		case TCP_INDEX_TS:
+			if(!rohc_snapshot_get32(snapshot, &opt->data.ts.req.bits) ||
+			   !rohc_snapshot_get8(snapshot, &bits_nr[0]) || bits_nr[0] > 32 ||
+			   !rohc_snapshot_get32(snapshot, &p[0]) ||
+			   !rohc_snapshot_get32(snapshot, &opt->data.ts.rep.bits) ||
+			   !rohc_snapshot_get8(snapshot, &bits_nr[1]) || bits_nr[1] > 32 ||
+			   !rohc_snapshot_get32(snapshot, &p[1]))
+			{
+				return false;
+			}
+			opt->data.ts.req.bits_nr = bits_nr[0];
+			opt->data.ts.req.p = (int32_t) p[0];
+			opt->data.ts.rep.bits_nr = bits_nr[1];
+			opt->data.ts.rep.p = (int32_t) p[1];
+			return true;
+		case TCP_INDEX_SACK:
+			return d_tcp_sack_import(&opt->data.sack, snapshot);
+		default:
+			if(!rohc_snapshot_get8(snapshot, &generic_type) ||
+			   generic_type > TCP_GENERIC_OPT_FULL ||
+			   !rohc_snapshot_get8(snapshot, &opt->data.generic.load_len) ||
+			   opt->data.generic.load_len > ROHC_TCP_OPT_GENERIC_DATA_MAX_LEN ||
+			   !rohc_snapshot_get(snapshot, opt->data.generic.load,
+			                      opt->data.generic.load_len))
+			{
+				return false;
+			}
+			opt->data.generic.type = generic_type;
+			return true;
+	}
+}
+
@@ -55,5 +55,13 @@ bool d_tcp_build_tcp_opts(const struct rohc_decomp_ctxt *const context,
                           size_t *const opts_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
+bool d_tcp_opts_export(const struct d_tcp_opts_ctxt *const tcp_opts,
+                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool d_tcp_opts_import(struct d_tcp_opts_ctxt *const tcp_opts,
+                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif /* ROHC_DECOMP_TCP_OPTS_LIST_H */
 
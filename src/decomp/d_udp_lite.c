@@ -34,6 +34,7 @@
 #include "rohc_utils.h"
 #include "rohc_packets.h"
 #include "crc.h"
+#include "rohc_snapshot.h"
 #include "protocols/udp_lite.h"
 
 #ifndef __KERNEL__
@@ -76,9 +77,10 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_udp_lite_destroy(const struct rohc_decomp_ctxt *const context,
+                               struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
 
 static rohc_packet_t udp_lite_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                                  const uint8_t *const rohc_packet,
@@ -119,6 +121,14 @@ static void udp_lite_update_context(struct rohc_decomp_ctxt *const context,
                                     const struct rohc_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
+static rohc_status_t d_udp_lite_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                            struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_udp_lite_import_ctxt(struct rohc_decomp_ctxt *const context,
+                                   struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 
 /*
  * Definitions of functions.
@@ -160,7 +170,8 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the UDP-Lite-specific part of the context */
-	udp_lite_context = malloc(sizeof(struct d_udp_lite_context));
+	udp_lite_context = rohc_slab_malloc(&context->decompressor->ctxt_slab,
+	                                    sizeof(struct d_udp_lite_context));
 	if(udp_lite_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -172,7 +183,8 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
+	rfc3095_ctxt->sn_lsb_ctxt =
+		rohc_lsb_new(&context->decompressor->ctxt_slab, 16);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -199,7 +211,9 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the UDP-Lite-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct udphdr));
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 sizeof(struct udphdr));
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -210,7 +224,9 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct udphdr));
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct udphdr));
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 sizeof(struct udphdr));
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -226,13 +242,15 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
+	rohc_lsb_free(&context->decompressor->ctxt_slab,
+	              rfc3095_ctxt->sn_lsb_ctxt);
 free_udp_context:
-	zfree(udp_lite_context);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab, rfc3095_ctxt->specific);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 quit:
 	return false;
 }
@@ -244,23 +262,28 @@ quit:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * @param context       The decompression context
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
  * @param volat_ctxt    The volatile decompression context
  */
-static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+static void d_udp_lite_destroy(const struct rohc_decomp_ctxt *const context,
+                               struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab,
+	                rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the LSB decoding context for SN */
-	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
+	rohc_lsb_free(&context->decompressor->ctxt_slab,
+	              rfc3095_ctxt->sn_lsb_ctxt);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(context, rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -664,6 +687,13 @@ static bool udp_lite_decode_values_from_bits(const struct rohc_decomp_ctxt *cont
 	rohc_decomp_debug(context, "decoded UDP-Lite destination port = 0x%04x",
 	                  rohc_ntoh16(decoded->udp_dst));
 
+	/* the UDP ports are CRC-STATIC fields */
+	if(decoded->udp_src != udp_lite->source ||
+	   decoded->udp_dst != udp_lite->dest)
+	{
+		decoded->crc_static_changed = true;
+	}
+
 	/* decode UDP-Lite checksum */
 	assert(bits->udp_check_nr == 16);
 	decoded->udp_check = bits->udp_check;
@@ -788,6 +818,76 @@ static void udp_lite_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Write the UDP-Lite part of the given context in a snapshot
+ *
+ * The generic part of the context is written first, then the UDP-Lite ports and the state of the checksum coverage.
+ *
+ * @param context   The decompression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          \ref ROHC_STATUS_OK if the context was exported,
+ *                  \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the snapshot is too
+ *                  small,
+ *                  \ref ROHC_STATUS_ERROR if the context cannot be exported
+ */
+static rohc_status_t d_udp_lite_export_ctxt(const struct rohc_decomp_ctxt *const context,
+                                            struct rohc_buf *const snapshot)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const struct d_udp_lite_context *const udp_lite_context = rfc3095_ctxt->specific;
+	rohc_status_t status;
+
+	status = rohc_decomp_rfc3095_export(context, snapshot);
+	if(status != ROHC_STATUS_OK)
+	{
+		return status;
+	}
+
+	if(!rohc_snapshot_put16(snapshot, udp_lite_context->sport) ||
+	   !rohc_snapshot_put16(snapshot, udp_lite_context->dport) ||
+	   !rohc_snapshot_put8(snapshot, udp_lite_context->cfp) ||
+	   !rohc_snapshot_put8(snapshot, udp_lite_context->cfi) ||
+	   !rohc_snapshot_put16(snapshot, udp_lite_context->cc))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the UDP-Lite part of the given context from a snapshot
+ *
+ * @param context   The decompression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+static bool d_udp_lite_import_ctxt(struct rohc_decomp_ctxt *const context,
+                                   struct rohc_buf *const snapshot)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	struct d_udp_lite_context *const udp_lite_context = rfc3095_ctxt->specific;
+	uint8_t cfp;
+	uint8_t cfi;
+
+	if(!rohc_decomp_rfc3095_import(context, snapshot) ||
+	   !rohc_snapshot_get16(snapshot, &udp_lite_context->sport) ||
+	   !rohc_snapshot_get16(snapshot, &udp_lite_context->dport) ||
+	   !rohc_snapshot_get8(snapshot, &cfp) || cfp > ROHC_TRISTATE_NO ||
+	   !rohc_snapshot_get8(snapshot, &cfi) || cfi > ROHC_TRISTATE_NO ||
+	   !rohc_snapshot_get16(snapshot, &udp_lite_context->cc))
+	{
+		return false;
+	}
+	udp_lite_context->cfp = cfp;
+	udp_lite_context->cfi = cfi;
+
+	return true;
+}
+
+
 /**
  * @brief Define the decompression part of the UDP-Lite profile as described
  *        in the RFC 4019.
@@ -796,6 +896,10 @@ const struct rohc_decomp_profile d_udplite_profile =
 {
 	.id              = ROHC_PROFILE_UDPLITE, /* profile ID (RFC 4019, §7) */
 	.msn_max_bits    = 16,
+	.ctxt_objs_sizes = { ROHC_DECOMP_RFC3095_CTXT_OBJS_SIZES,
+	                     sizeof(struct rohc_lsb_decode),
+	                     sizeof(struct d_udp_lite_context),
+	                     sizeof(struct udphdr), sizeof(struct udphdr) },
 	.new_context     = (rohc_decomp_new_context_t) d_udp_lite_create,
 	.free_context    = (rohc_decomp_free_context_t) d_udp_lite_destroy,
 	.detect_pkt_type = udp_lite_detect_packet_type,
@@ -805,5 +909,7 @@ const struct rohc_decomp_profile d_udplite_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.export_ctxt     = d_udp_lite_export_ctxt,
+	.import_ctxt     = d_udp_lite_import_ctxt,
 };
 
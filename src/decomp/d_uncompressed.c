@@ -65,9 +65,10 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
                                struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void uncomp_free_context(void *const persist_ctxt,
+static void uncomp_free_context(const struct rohc_decomp_ctxt *const context,
+                                void *const persist_ctxt,
                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+	__attribute__((nonnull(1, 3)));
 
 static rohc_packet_t uncomp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -161,14 +162,16 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
 	/* volatile part */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_uncomp_extr_bits));
+	volat_ctxt->extr_bits = rohc_slab_malloc(&context->decompressor->ctxt_slab,
+	                                         sizeof(struct rohc_uncomp_extr_bits));
 	if(volat_ctxt->extr_bits == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
 		                 "of the Uncompressed decompression profile");
 		goto error;
 	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_uncomp_decoded));
+	volat_ctxt->decoded_values =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab, sizeof(struct rohc_uncomp_decoded));
 	if(volat_ctxt->decoded_values == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
@@ -179,7 +182,7 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_extr_bits:
-	free(volat_ctxt->extr_bits);
+	rohc_slab_free(&context->decompressor->ctxt_slab, volat_ctxt->extr_bits);
 error:
 	return false;
 }
@@ -192,15 +195,17 @@ error:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * @param context       The decompression context
  * @param persist_ctxt  The persistent part of the decompression context
  * @param volat_ctxt    The volatile part of the decompression context
  */
-static void uncomp_free_context(void *const persist_ctxt,
+static void uncomp_free_context(const struct rohc_decomp_ctxt *const context,
+                                void *const persist_ctxt,
                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
 	assert(persist_ctxt == NULL);
-	free(volat_ctxt->extr_bits);
-	free(volat_ctxt->decoded_values);
+	rohc_slab_free(&context->decompressor->ctxt_slab, volat_ctxt->extr_bits);
+	rohc_slab_free(&context->decompressor->ctxt_slab, volat_ctxt->decoded_values);
 }
 
 
@@ -554,6 +559,8 @@ const struct rohc_decomp_profile d_uncomp_profile =
 {
 	.id              = ROHC_PROFILE_UNCOMPRESSED, /* profile ID (RFC3095 §8) */
 	.msn_max_bits    = 0, /* no MSN */
+	.ctxt_objs_sizes = { sizeof(struct rohc_uncomp_extr_bits),
+	                     sizeof(struct rohc_uncomp_decoded) },
 	.new_context     = uncomp_new_context,
 	.free_context    = uncomp_free_context,
 	.detect_pkt_type = uncomp_detect_pkt_type,
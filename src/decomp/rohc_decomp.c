@@ -50,6 +50,7 @@
 #include "rohc_add_cid.h"
 #include "rohc_decomp_detect_packet.h"
 #include "crc.h"
+#include "rohc_snapshot.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -127,6 +128,8 @@ struct rohc_decomp_stream
 static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
                                         const rohc_cid_t max_cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static bool rohc_decomp_prealloc_contexts(struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1), warn_unused_result));
 
 static const struct rohc_decomp_profile *
 	find_profile(const struct rohc_decomp *const decomp,
@@ -143,11 +146,38 @@ static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const de
 static void context_free(struct rohc_decomp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+static bool rohc_decomp_check_pkt(const struct rohc_decomp *const decomp,
+                                  const struct rohc_buf rohc_packet,
+                                  const struct rohc_buf *const uncomp_packet)
+	__attribute__((nonnull(1), warn_unused_result));
+static bool rohc_decomp_check_feedbacks(const struct rohc_decomp *const decomp,
+                                        const struct rohc_buf *const rcvd_feedback,
+                                        const struct rohc_buf *const feedback_send)
+	__attribute__((nonnull(1), warn_unused_result));
+
+static rohc_status_t __rohc_decompress(struct rohc_decomp *const decomp,
+                                       const struct rohc_buf rohc_packet,
+                                       struct rohc_buf *const uncomp_packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send,
+                                       const bool is_in_place)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+
+static bool rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                                 const struct rohc_buf rohc_packet,
+                                 rohc_cid_t *const cid)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+static void rohc_decomp_prefetch_ctxt(const struct rohc_decomp *const decomp,
+                                      const rohc_cid_t cid,
+                                      const bool persist)
+	__attribute__((nonnull(1)));
+
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
                                      struct rohc_buf *const rcvd_feedback,
-                                     struct rohc_decomp_stream *const stream)
+                                     struct rohc_decomp_stream *const stream,
+                                     const bool is_in_place)
 	__attribute__((nonnull(1, 3, 5), warn_unused_result));
 
 static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
@@ -179,18 +209,18 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const bool is_in_place,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
-	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 8, 9)));
 
-static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
-                                     const struct rohc_decomp_ctxt *const context,
+static bool rohc_decomp_check_ir_crc(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const rohc_hdr,
                                      const size_t rohc_hdr_len,
                                      const size_t add_cid_len,
                                      const size_t large_cid_len,
                                      const uint8_t crc_packet)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context,
                                           const size_t comp_hdr_len,
@@ -228,6 +258,17 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 /* statistics-related functions */
 static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 	__attribute__((nonnull(1)));
+static struct rohc_stats *
+	rohc_decomp_get_ctxt_stats(const struct rohc_decomp *const decomp,
+	                           const rohc_cid_t cid)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static void rohc_decomp_stats_add_transition(struct rohc_decomp_ctxt *const context,
+                                             const rohc_decomp_state_t new_state)
+	__attribute__((nonnull(1)));
+static bool rohc_decomp_stats_export(const struct rohc_decomp *const decomp,
+                                     const struct rohc_stats *const counters,
+                                     rohc_decomp_stats_snapshot_t *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 static bool rohc_decomp_packet_carry_static_info(const rohc_packet_t packet_type)
 	__attribute__((warn_unused_result, const));
@@ -279,7 +320,7 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	assert(profile != NULL);
 
 	/* allocate memory for the decompression context */
-	context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
+	context = rohc_slab_malloc(&decomp->ctxt_slab, sizeof(struct rohc_decomp_ctxt));
 	if(context == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
@@ -350,10 +391,21 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	assert(decomp->num_contexts_used <= (decomp->medium.max_cid + 1));
 	decomp->num_contexts_used++;
 
+	/* the statistics of the CID start again with the new context */
+	if(decomp->detailed_stats != NULL)
+	{
+		memset(rohc_decomp_get_ctxt_stats(decomp, cid), 0,
+		       sizeof(struct rohc_stats));
+		rohc_stats_add_transition(&decomp->detailed_stats[0].counters,
+		                          ROHC_DECOMP_STATE_UNKNOWN, context->state);
+		rohc_stats_add_transition(rohc_decomp_get_ctxt_stats(decomp, cid),
+		                          ROHC_DECOMP_STATE_UNKNOWN, context->state);
+	}
+
 	return context;
 
 destroy_context:
-	zfree(context);
+	rohc_slab_zfree(&decomp->ctxt_slab, context);
 error:
 	return NULL;
 }
@@ -374,14 +426,15 @@ static void context_free(struct rohc_decomp_ctxt *const context)
 	           "free context with CID %zu", context->cid);
 
 	/* destroy the profile-specific data */
-	context->profile->free_context(context->persist_ctxt, &context->volat_ctxt);
+	context->profile->free_context(context, context->persist_ctxt,
+	                               &context->volat_ctxt);
 
 	/* decompressor got one more context */
 	assert(context->decompressor->num_contexts_used > 0);
 	context->decompressor->num_contexts_used--;
 
 	/* destroy the context itself */
-	free(context);
+	rohc_slab_free(&context->decompressor->ctxt_slab, context);
 }
 
 
@@ -498,6 +551,12 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	/* default feature set (empty for the moment) */
 	decomp->features = ROHC_DECOMP_FEATURE_NONE;
 
+	/* no detailed statistics until ROHC_DECOMP_FEATURE_STATS is enabled */
+	decomp->detailed_stats = NULL;
+
+	/* contexts are not preallocated by default */
+	rohc_slab_init(&decomp->ctxt_slab);
+
 	/* init decompressor medium */
 	decomp->medium.cid_type = cid_type;
 	decomp->medium.max_cid = max_cid;
@@ -540,34 +599,17 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	}
 
 	/* no Reconstructed Reception Unit (RRU) at the moment */
+	decomp->rru = NULL;
 	decomp->rru_len = 0;
 	/* no segmentation by default */
 	decomp->mrru = 0;
-
-	/* init the tables for fast CRC computation */
-	is_fine = rohc_crc_init_table(decomp->crc_table_3, ROHC_CRC_TYPE_3);
-	if(is_fine != true)
-	{
-		goto destroy_contexts;
-	}
-	is_fine = rohc_crc_init_table(decomp->crc_table_7, ROHC_CRC_TYPE_7);
-	if(is_fine != true)
-	{
-		goto destroy_contexts;
-	}
-	is_fine = rohc_crc_init_table(decomp->crc_table_8, ROHC_CRC_TYPE_8);
-	if(is_fine != true)
-	{
-		goto destroy_contexts;
-	}
+	decomp->crc_fcs32 = rohc_crc_fcs32_probe();
 
 	/* reset the decompressor statistics */
 	rohc_decomp_reset_stats(decomp);
 
 	return decomp;
 
-destroy_contexts:
-	free(decomp->contexts);
 destroy_decomp:
 	free(decomp);
 error:
@@ -623,6 +665,13 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 	}
 	zfree(decomp->contexts);
 	assert(decomp->num_contexts_used == 0);
+	rohc_slab_reset(&decomp->ctxt_slab);
+
+	/* destroy the RRU buffer used for segmentation */
+	free(decomp->rru);
+
+	/* destroy the detailed statistics if any */
+	free(decomp->detailed_stats);
 
 	/* destroy the decompressor itself */
 	free(decomp);
@@ -705,14 +754,296 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
                                struct rohc_buf *const rcvd_feedback,
                                struct rohc_buf *const feedback_send)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	struct rohc_decomp_stream stream;
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_decomp_check_pkt(decomp, rohc_packet, uncomp_packet) ||
+	   !rohc_decomp_check_feedbacks(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	return __rohc_decompress(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
+	                         feedback_send, false);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet in place
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 does, but without
+ * copying the payload: the payload stays where it is in the buffer and the
+ * uncompressed headers replace the ROHC header in front of it. The
+ * uncompressed headers are always longer than the ROHC header, so the buffer
+ * shall reserve some headroom before the ROHC packet (ie. \e packet.offset
+ * shall be large enough), 128 bytes are enough for most IP/UDP/RTP headers.
+ * If the headroom is too small for the uncompressed headers,
+ * \ref ROHC_STATUS_OUTPUT_TOO_SMALL is returned.
+ *
+ * Once decompressed, the given buffer describes the uncompressed packet. It
+ * might be empty if the ROHC packet contained only feedback data. ROHC
+ * segments cannot be decompressed in place, use \ref rohc_decompress3 for
+ * them.
+ *
+ * If decompression fails, the content of the buffer is undefined: the packet
+ * shall be dropped.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[in,out] packet      IN:  The compressed packet to decompress, with
+ *                                 headroom
+ *                            OUT: The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel, see \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor through the feedback channel, see
+ *                            \ref rohc_decompress3
+ * @return                    Possible return values, see
+ *                            \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                      struct rohc_buf *const packet,
+                                      struct rohc_buf *const rcvd_feedback,
+                                      struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf uncomp_packet;
+	rohc_status_t status;
+
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is NULL");
+		goto error;
+	}
+	if(packet->offset == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet has no headroom for the uncompressed headers");
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	/* the uncompressed headers are built in the headroom of the packet */
+	uncomp_packet = *packet;
+	uncomp_packet.max_len = packet->offset;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
+
+	if(!rohc_decomp_check_pkt(decomp, *packet, &uncomp_packet) ||
+	   !rohc_decomp_check_feedbacks(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	status = __rohc_decompress(decomp, *packet, &uncomp_packet, rcvd_feedback,
+	                           feedback_send, true);
+	if(status == ROHC_STATUS_OK)
+	{
+		if(uncomp_packet.len > 0)
+		{
+			*packet = uncomp_packet;
+		}
+		else
+		{
+			/* feedback-only packet */
+			packet->len = 0;
+		}
+	}
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress a burst of ROHC packets
+ *
+ * Decompress the given ROHC packets as successive calls to
+ * \ref rohc_decompress3 would do, but share the work between the packets of
+ * the burst:
+ *  -# the CIDs of all the packets are decoded, and the decompression contexts
+ *     for those CIDs are prefetched,
+ *  -# the packets are decompressed in order, while the contexts and their
+ *     profile-specific parts for the next packets are prefetched.
+ *
+ * The packets are handled by groups of 32 packets.
+ *
+ * The uncompressed packet for \e rohc_packets[i] is stored in
+ * \e uncomp_packets[i] and its status in \e statuses[i], see
+ * \ref rohc_decompress3 for the possible status values.
+ *
+ * The feedback received for the same-side associated ROHC compressor and the
+ * feedback to be transmitted to the remote compressor are aggregated for the
+ * whole burst: the feedback items of all the packets are stored one after the
+ * other in \e rcvd_feedback and \e feedback_send. The feedback items that do
+ * not fit in the buffers are dropped.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packets        The compressed packets to decompress
+ * @param[out] uncomp_packets The resulting uncompressed packets
+ * @param[out] statuses       The decompression status of every packet
+ * @param packets_nr          The number of packets in the burst
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel, see \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor through the feedback channel, see
+ *                            \ref rohc_decompress3
+ * @return                    The number of packets for which
+ *                            \ref ROHC_STATUS_OK is returned
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+size_t rohc_decompress_burst(struct rohc_decomp *const decomp,
+                             const struct rohc_buf rohc_packets[],
+                             struct rohc_buf uncomp_packets[],
+                             rohc_status_t statuses[],
+                             const size_t packets_nr,
+                             struct rohc_buf *const rcvd_feedback,
+                             struct rohc_buf *const feedback_send)
+{
+	rohc_cid_t cids[ROHC_DECOMP_BURST_MAX];
+	size_t rcvd_feedback_len = 0;
+	size_t feedback_send_len = 0;
+	size_t decompressed_nr = 0;
+	size_t first;
+	size_t i;
 
 	/* check inputs validity */
 	if(decomp == NULL)
 	{
 		goto error;
 	}
+	if(rohc_packets == NULL || uncomp_packets == NULL || statuses == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given arrays of packets and statuses cannot be NULL");
+		goto error;
+	}
+	if(!rohc_decomp_check_feedbacks(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	for(first = 0; first < packets_nr; first += ROHC_DECOMP_BURST_MAX)
+	{
+		const size_t nr = rohc_min(packets_nr - first, ROHC_DECOMP_BURST_MAX);
+		const struct rohc_buf *const rohc = rohc_packets + first;
+		struct rohc_buf *const uncomp = uncomp_packets + first;
+		rohc_status_t *const st = statuses + first;
+
+		/* decode the CIDs of all the packets, and prefetch the slots of the
+		 * contexts for those CIDs */
+		for(i = 0; i < nr; i++)
+		{
+			if(rohc_decomp_peek_cid(decomp, rohc[i], &cids[i]))
+			{
+				__builtin_prefetch(&decomp->contexts[cids[i]]);
+			}
+			else
+			{
+				cids[i] = SIZE_MAX;
+			}
+		}
+		for(i = 0; i < rohc_min(nr, 2U); i++)
+		{
+			rohc_decomp_prefetch_ctxt(decomp, cids[i], false);
+		}
+
+		/* decompress the packets in order: the decompression of one packet
+		 * depends on the decompression of the previous packets */
+		for(i = 0; i < nr; i++)
+		{
+			/* prefetch the contexts of the next packets */
+			if((i + 1) < nr)
+			{
+				rohc_decomp_prefetch_ctxt(decomp, cids[i + 1], true);
+			}
+			if((i + 2) < nr)
+			{
+				rohc_decomp_prefetch_ctxt(decomp, cids[i + 2], false);
+			}
+
+			if(!rohc_decomp_check_pkt(decomp, rohc[i], &uncomp[i]))
+			{
+				st[i] = ROHC_STATUS_ERROR;
+				continue;
+			}
+			st[i] = __rohc_decompress(decomp, rohc[i], &uncomp[i], rcvd_feedback,
+			                          feedback_send, false);
+			if(st[i] == ROHC_STATUS_OK)
+			{
+				decompressed_nr++;
+			}
+
+			/* hide the feedback of the packet, so that the feedback of the next
+			 * packets is stored after it */
+			if(rcvd_feedback != NULL)
+			{
+				rcvd_feedback_len += rcvd_feedback->len;
+				rohc_buf_pull(rcvd_feedback, rcvd_feedback->len);
+			}
+			if(feedback_send != NULL)
+			{
+				feedback_send_len += feedback_send->len;
+				rohc_buf_pull(feedback_send, feedback_send->len);
+			}
+		}
+	}
+
+	/* unhide the feedback of all the packets */
+	if(rcvd_feedback != NULL)
+	{
+		rohc_buf_push(rcvd_feedback, rcvd_feedback_len);
+	}
+	if(feedback_send != NULL)
+	{
+		rohc_buf_push(feedback_send, feedback_send_len);
+	}
+
+	return decompressed_nr;
+
+error:
+	if(statuses != NULL)
+	{
+		for(i = 0; i < packets_nr; i++)
+		{
+			statuses[i] = ROHC_STATUS_ERROR;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Check the ROHC packet and the uncompressed packet given by the user
+ *
+ * @param decomp         The ROHC decompressor
+ * @param rohc_packet    The compressed packet to decompress
+ * @param uncomp_packet  The buffer for the uncompressed packet
+ * @return               true if the packets are valid, false otherwise
+ */
+static bool rohc_decomp_check_pkt(const struct rohc_decomp *const decomp,
+                                  const struct rohc_buf rohc_packet,
+                                  const struct rohc_buf *const uncomp_packet)
+{
 	if(rohc_buf_is_malformed(rohc_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -743,6 +1074,26 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 		             "given uncomp_packet is not empty");
 		goto error;
 	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Check the feedback buffers given by the user
+ *
+ * @param decomp         The ROHC decompressor
+ * @param rcvd_feedback  The buffer for the received feedback, may be NULL
+ * @param feedback_send  The buffer for the feedback to send, may be NULL
+ * @return               true if the buffers are valid, false otherwise
+ */
+static bool rohc_decomp_check_feedbacks(const struct rohc_decomp *const decomp,
+                                        const struct rohc_buf *const rcvd_feedback,
+                                        const struct rohc_buf *const feedback_send)
+{
 	if(rcvd_feedback != NULL)
 	{
 		if(rohc_buf_is_malformed(*rcvd_feedback))
@@ -774,6 +1125,40 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 		}
 	}
 
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet once inputs were checked
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor
+ * @param is_in_place         Whether the payload shall stay in the ROHC
+ *                            packet, see \ref rohc_decompress_inplace
+ * @return                    Possible return values, see
+ *                            \ref rohc_decompress3
+ */
+static rohc_status_t __rohc_decompress(struct rohc_decomp *const decomp,
+                                       const struct rohc_buf rohc_packet,
+                                       struct rohc_buf *const uncomp_packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send,
+                                       const bool is_in_place)
+{
+	const uint64_t start_time =
+		(decomp->detailed_stats != NULL ? rohc_time_get_ns() : 0);
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_decomp_stream stream;
+
 	decomp->stats.received++;
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
@@ -782,14 +1167,13 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 	/* print compressed bytes */
 	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
-		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
+		rohc_dump_packet(decomp, ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
 		                 "compressed data, max 100 bytes", rohc_packet);
 	}
 
 	/* decode ROHC header */
 	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
-	                         &stream);
+	                         &stream, is_in_place);
 	assert(status != ROHC_STATUS_SEGMENT);
 
 	/* handle mode transitions if context was found and it is still valid */
@@ -869,6 +1253,15 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 			stream.context->total_compressed_size += rohc_packet.len;
 			decomp->stats.total_uncompressed_size += uncomp_packet->len;
 			decomp->stats.total_compressed_size += rohc_packet.len;
+			if(decomp->detailed_stats != NULL)
+			{
+				const uint64_t duration = rohc_time_get_ns() - start_time;
+
+				rohc_stats_add_pkt(&decomp->detailed_stats[0].counters,
+				                   stream.packet_type, duration);
+				rohc_stats_add_pkt(rohc_decomp_get_ctxt_stats(decomp, stream.cid),
+				                   stream.packet_type, duration);
+			}
 
 			/* build positive feedback if asked by user and if needed by decompressor */
 			if(!rohc_decomp_feedback_ack(decomp, &stream, feedback_send))
@@ -931,57 +1324,170 @@ error:
 
 
 /**
- * @brief Decompress the compressed headers.
+ * @brief Decode the CID of the given ROHC packet ahead of decompression
  *
- * @param decomp              The ROHC decompressor
- * @param rohc_packet         The ROHC packet to decode
- * @param[out] uncomp_packet  The uncompressed packet
- * @param[out] rcvd_feedback  The feedback received from the remote peer for
- *                            the same-side associated ROHC compressor through
- *                            the feedback channel:
- *                            \li If NULL, ignore the received feedback data
- *                            \li If not NULL, store the received feedback in
- *                                at the given address
- * @param[out] stream         The informations about the decompressed stream,
- *                            required for sending feedback to compressor
- * @return                    Possible return values:
- *                            \li ROHC_STATUS_OK if packet is successfully
- *                                decoded,
- *                            \li ROHC_STATUS_NO_CONTEXT if no matching
- *                                context was found and packet cannot create
- *                                a new context (or failed to do so),
- *                            \li ROHC_STATUS_MALFORMED if packet is
- *                                malformed,
- *                            \li ROHC_STATUS_BAD_CRC if a CRC error occurs,
- *                            \li ROHC_STATUS_ERROR if another error occurs
+ * Only the padding is skipped: the CID of packets that start with feedback
+ * items or that are segments is not decoded.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet to decode the CID from
+ * @param[out] cid     The CID of the packet
+ * @return             true if a valid CID was decoded, false otherwise
  */
-static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
-                                     const struct rohc_buf rohc_packet,
-                                     struct rohc_buf *const uncomp_packet,
-                                     struct rohc_buf *const rcvd_feedback,
-                                     struct rohc_decomp_stream *const stream)
+static bool rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                                 const struct rohc_buf rohc_packet,
+                                 rohc_cid_t *const cid)
 {
-	const struct rohc_decomp_profile *profile;
-	bool is_new_context = false;
-	size_t sn_feedback_min_bits;
-	size_t add_cid_len;
-	size_t large_cid_len;
-
-	struct rohc_buf remain_rohc_data = rohc_packet;
 	const uint8_t *walk;
 	size_t remain_len;
 
-	rohc_status_t status;
+	if(rohc_buf_is_malformed(rohc_packet))
+	{
+		goto error;
+	}
+	walk = rohc_buf_data(rohc_packet);
+	remain_len = rohc_packet.len;
 
-	/* at the beginning, context is not found yet but channel CID type is known */
-	stream->profile_id = ROHC_PROFILE_GENERAL;
-	stream->cid_type = decomp->medium.cid_type;
-	stream->cid_found = false;
-	stream->cid = SIZE_MAX;
-	stream->context_found = false;
-	stream->context = NULL;
-	stream->mode = ROHC_UNKNOWN_MODE;
-	stream->state = ROHC_DECOMP_STATE_UNKNOWN;
+	/* skip padding bits if some are present */
+	while(remain_len > 0 && rohc_decomp_packet_is_padding(walk))
+	{
+		walk++;
+		remain_len--;
+	}
+	if(remain_len == 0 || rohc_packet_is_feedback(walk[0]) ||
+	   rohc_decomp_packet_is_segment(walk))
+	{
+		goto error;
+	}
+
+	if(decomp->medium.cid_type == ROHC_SMALL_CID)
+	{
+		*cid = rohc_add_cid_decode(walk, remain_len);
+		if((*cid) == UINT8_MAX)
+		{
+			*cid = 0;
+		}
+	}
+	else
+	{
+		uint32_t large_cid;
+		size_t large_cid_bits_nr;
+		size_t large_cid_len;
+
+		if(remain_len < 2)
+		{
+			goto error;
+		}
+		large_cid_len = sdvl_decode(walk + 1, remain_len - 1, &large_cid,
+		                            &large_cid_bits_nr);
+		if(large_cid_len != 1 && large_cid_len != 2)
+		{
+			goto error;
+		}
+		*cid = large_cid & 0xffff;
+	}
+
+	return ((*cid) <= decomp->medium.max_cid);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Prefetch the decompression context for the given CID
+ *
+ * The slot of the context shall be prefetched before the context, and the
+ * context before its profile-specific part.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param cid      The CID of the context, SIZE_MAX if unknown
+ * @param persist  false to prefetch the context,
+ *                 true to prefetch the profile-specific part of the context
+ */
+static void rohc_decomp_prefetch_ctxt(const struct rohc_decomp *const decomp,
+                                      const rohc_cid_t cid,
+                                      const bool persist)
+{
+	const struct rohc_decomp_ctxt *context;
+
+	if(cid > decomp->medium.max_cid)
+	{
+		return;
+	}
+
+	context = decomp->contexts[cid];
+	if(context == NULL)
+	{
+		return;
+	}
+
+	if(persist)
+	{
+		__builtin_prefetch(context->persist_ctxt);
+	}
+	else
+	{
+		__builtin_prefetch(context);
+	}
+}
+
+
+/**
+ * @brief Decompress the compressed headers.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The ROHC packet to decode
+ * @param[out] uncomp_packet  The uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel:
+ *                            \li If NULL, ignore the received feedback data
+ *                            \li If not NULL, store the received feedback in
+ *                                at the given address
+ * @param[out] stream         The informations about the decompressed stream,
+ *                            required for sending feedback to compressor
+ * @param is_in_place         Whether the payload shall stay in the ROHC
+ *                            packet, see \ref rohc_decompress_inplace
+ * @return                    Possible return values:
+ *                            \li ROHC_STATUS_OK if packet is successfully
+ *                                decoded,
+ *                            \li ROHC_STATUS_NO_CONTEXT if no matching
+ *                                context was found and packet cannot create
+ *                                a new context (or failed to do so),
+ *                            \li ROHC_STATUS_MALFORMED if packet is
+ *                                malformed,
+ *                            \li ROHC_STATUS_BAD_CRC if a CRC error occurs,
+ *                            \li ROHC_STATUS_ERROR if another error occurs
+ */
+static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
+                                     const struct rohc_buf rohc_packet,
+                                     struct rohc_buf *const uncomp_packet,
+                                     struct rohc_buf *const rcvd_feedback,
+                                     struct rohc_decomp_stream *const stream,
+                                     const bool is_in_place)
+{
+	const struct rohc_decomp_profile *profile;
+	bool is_new_context = false;
+	size_t sn_feedback_min_bits;
+	size_t add_cid_len;
+	size_t large_cid_len;
+
+	struct rohc_buf remain_rohc_data = rohc_packet;
+	const uint8_t *walk;
+	size_t remain_len;
+
+	rohc_status_t status;
+
+	/* at the beginning, context is not found yet but channel CID type is known */
+	stream->profile_id = ROHC_PROFILE_GENERAL;
+	stream->cid_type = decomp->medium.cid_type;
+	stream->cid_found = false;
+	stream->cid = SIZE_MAX;
+	stream->context_found = false;
+	stream->context = NULL;
+	stream->mode = ROHC_UNKNOWN_MODE;
+	stream->state = ROHC_DECOMP_STATE_UNKNOWN;
 	stream->do_change_mode = false;
 	stream->sn_bits = 0; /* must be set to 0 until we get some bits */
 	stream->sn_bits_nr = 0;
@@ -1050,6 +1556,23 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 		           "ROHC packet is a %zu-byte %s segment", remain_len,
 		           is_final ? "final" : "non-final");
 
+		/* the payload of the reassembled RRU would not be in the given packet */
+		if(is_in_place)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "ROHC segments cannot be decompressed in place");
+			status = ROHC_STATUS_ERROR;
+			goto error;
+		}
+
+		/* segments are not expected if segmentation is disabled */
+		if(decomp->mrru == 0)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid RRU: segmentation is disabled (MRRU = 0)");
+			goto error_malformed;
+		}
+
 		/* store all the remaining ROHC data in RRU */
 		if((decomp->rru_len + remain_len) > decomp->mrru)
 		{
@@ -1091,8 +1614,8 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "final segment received, check the 4-byte CRC of the "
 		           "%zd-byte RRU", decomp->rru_len);
-		crc_computed = crc_calc_fcs32(decomp->rru, decomp->rru_len,
-		                              CRC_INIT_FCS32);
+		crc_computed = decomp->crc_fcs32(decomp->rru, decomp->rru_len,
+		                                 CRC_INIT_FCS32);
 		if(memcmp(&crc_computed, decomp->rru + decomp->rru_len, 4) != 0)
 		{
 			uint32_t crc_packet;
@@ -1244,7 +1767,8 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	 * (may change the initial assumption about the packet type) */
 	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
 	                                add_cid_len, large_cid_len, uncomp_packet,
-	                                &stream->packet_type, &stream->do_change_mode);
+	                                is_in_place, &stream->packet_type,
+	                                &stream->do_change_mode);
 	if(status != ROHC_STATUS_OK)
 	{
 		/* decompression failed, free ressources if necessary */
@@ -1310,7 +1834,8 @@ error_no_context:
  *  \li C. Decode extracted bits
  *  \li D. Build uncompressed headers (and check for correct decompression
  *         for UO* packets)
- *  \li E. Copy the payload (if any)
+ *  \li E. Copy the payload (if any), or move the uncompressed headers in
+ *         front of the payload if the packet is decompressed in place
  *  \li F. Update the compression context
  *
  * Steps C and D may be repeated if packet or context repair is attempted
@@ -1322,6 +1847,8 @@ error_no_context:
  * @param add_cid_len          The length of the optional Add-CID field
  * @param large_cid_len        The length of the optional large CID field
  * @param[out] uncomp_packet   The uncompressed packet
+ * @param is_in_place          Whether the payload shall stay in the ROHC
+ *                             packet, see \ref rohc_decompress_inplace
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
  * @param[out] do_change_mode  Whether the profile context wants to change
@@ -1337,6 +1864,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const bool is_in_place,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
 {
@@ -1403,7 +1931,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		assert(extr_crc_bits->type == ROHC_CRC_TYPE_NONE);
 		assert(extr_crc_bits->bits_nr == 8);
 
-		crc_ok = rohc_decomp_check_ir_crc(decomp, context,
+		crc_ok = rohc_decomp_check_ir_crc(context,
 		                                  rohc_buf_data(rohc_packet) - add_cid_len,
 		                                  add_cid_len + rohc_hdr_len, large_cid_len,
 		                                  add_cid_len, extr_crc_bits->bits);
@@ -1413,8 +1941,8 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			                 "%s packet", rohc_get_packet_descr(*packet_type));
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
-				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
-				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
+				rohc_dump_buf(decomp, ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+				              "ROHC header",
 				              rohc_buf_data(rohc_packet) - add_cid_len,
 				              rohc_hdr_len + add_cid_len);
 			}
@@ -1501,8 +2029,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			                 "headers", context->cid);
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
-				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+				rohc_dump_packet(decomp, ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				                 "compressed headers", rohc_packet);
 			}
 			goto error;
@@ -1533,9 +2060,9 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 				                 "headers (CRC failure)", context->cid);
 				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 				{
-					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
-					                 "compressed headers", rohc_packet);
+					rohc_dump_packet(decomp, ROHC_TRACE_DECOMP,
+					                 ROHC_TRACE_WARNING, "compressed headers",
+					                 rohc_packet);
 				}
 				goto error_crc;
 			}
@@ -1601,17 +2128,33 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		                 rohc_hdr_len, payload_len, rohc_packet.len);
 		goto error;
 	}
-	if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
-	{
-		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
-		                 "max) for the %zu-byte payload",
-		                 rohc_buf_avail_len(*uncomp_packet), payload_len);
-		goto error_output_too_small;
+	if(is_in_place)
+	{
+		/* the uncompressed headers were built in the headroom of the ROHC
+		 * packet, move them right before the payload that stays in place */
+		const size_t payload_offset = payload_data - uncomp_packet->data;
+		assert(uncomp_packet->data == rohc_packet.data);
+		assert(payload_offset >= uncomp_packet->offset);
+		memmove(uncomp_packet->data + payload_offset - uncomp_hdr_len,
+		        rohc_buf_data(*uncomp_packet) - uncomp_hdr_len, uncomp_hdr_len);
+		uncomp_packet->max_len = rohc_packet.max_len;
+		uncomp_packet->offset = payload_offset + payload_len;
+		uncomp_packet->len = 0;
 	}
-	if(payload_len != 0)
+	else
 	{
-		rohc_buf_append(uncomp_packet, payload_data, payload_len);
-		rohc_buf_pull(uncomp_packet, payload_len);
+		if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+		{
+			rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+			                 "max) for the %zu-byte payload",
+			                 rohc_buf_avail_len(*uncomp_packet), payload_len);
+			goto error_output_too_small;
+		}
+		if(payload_len != 0)
+		{
+			rohc_buf_append(uncomp_packet, payload_data, payload_len);
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
 	}
 	/* unhide the uncompressed headers and payload */
 	rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
@@ -1633,6 +2176,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	{
 		rohc_decomp_debug(context, "change from state %d to state %d",
 		                  context->state, ROHC_DECOMP_STATE_FC);
+		rohc_decomp_stats_add_transition(context, ROHC_DECOMP_STATE_FC);
 		context->state = ROHC_DECOMP_STATE_FC;
 	}
 
@@ -1663,7 +2207,6 @@ error_malformed:
  * The CRC for IR/IR-DYN headers is always CRC-8. It is computed on the
  * whole compressed header (payload excluded, but any CID bits included).
  *
- * @param decomp          The ROHC decompressor
  * @param context         The decompression context
  * @param rohc_hdr        The compressed IR or IR-DYN header
  * @param rohc_hdr_len    The length (in bytes) of the compressed header
@@ -1672,8 +2215,7 @@ error_malformed:
  * @param crc_packet      The CRC extracted from the ROHC header
  * @return                true if the CRC is correct, false otherwise
  */
-static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
-                                     const struct rohc_decomp_ctxt *const context,
+static bool rohc_decomp_check_ir_crc(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const rohc_hdr,
                                      const size_t rohc_hdr_len,
                                      const size_t add_cid_len,
@@ -1681,35 +2223,31 @@ static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
                                      const uint8_t crc_packet)
 {
 	const size_t rohc_hdr_full_len = add_cid_len + large_cid_len + rohc_hdr_len;
-	const uint8_t *crc_table;
 	const rohc_crc_type_t crc_type = ROHC_CRC_TYPE_8;
 	const uint8_t crc_zero[] = { 0x00 };
 	unsigned int crc_comp; /* computed CRC */
 
-	assert(decomp != NULL);
 	assert(rohc_hdr != NULL);
 	assert(rohc_hdr_len >= (add_cid_len + 2 + large_cid_len + 1));
 
-	crc_table = decomp->crc_table_8;
-
 	/* ROHC header before CRC field:
 	 * optional Add-CID + IR type + Profile ID + optional large CID */
 	crc_comp = crc_calculate(crc_type, rohc_hdr,
 	                         add_cid_len + 2 + large_cid_len,
-	                         CRC_INIT_8, crc_table);
+	                         CRC_INIT_8);
 
 	/* all profiles but the Uncompressed profile compute their CRC through the
 	 * zeroed CRC field and the rest of the ROHC header */
 	if(context->profile->id != ROHC_PROFILE_UNCOMPRESSED)
 	{
 		/* zeroed CRC field */
-		crc_comp = crc_calculate(crc_type, crc_zero, 1, crc_comp, crc_table);
+		crc_comp = crc_calculate(crc_type, crc_zero, 1, crc_comp);
 
 		/* ROHC header after CRC field */
 		crc_comp = crc_calculate(crc_type,
 		                         rohc_hdr + add_cid_len + 2 + large_cid_len + 1,
 		                         rohc_hdr_len - add_cid_len - 2 - large_cid_len - 1,
-		                         crc_comp, crc_table);
+		                         crc_comp);
 	}
 
 	rohc_decomp_debug(context, "CRC-%d on compressed %zu-byte ROHC header = "
@@ -1938,7 +2476,7 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 
 		/* build the feedback packet */
 		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, decomp->crc_table_8, &feedbacksize);
+		                            crc_present, &feedbacksize);
 		if(feedbackp == NULL)
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
@@ -2268,7 +2806,7 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 
 		/* build the feedback packet */
 		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, decomp->crc_table_8, &feedbacksize);
+		                            crc_present, &feedbacksize);
 		if(feedbackp == NULL)
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
@@ -2327,6 +2865,7 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			          "change from state %d to state %d because of error(s)",
 			          infos->state, ROHC_DECOMP_STATE_NC);
+			rohc_decomp_stats_add_transition(infos->context, ROHC_DECOMP_STATE_NC);
 			infos->context->state = ROHC_DECOMP_STATE_NC;
 		}
 		else if(infos->state == ROHC_DECOMP_STATE_FC)
@@ -2334,6 +2873,7 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			          "change from state %d to state %d because of error(s)",
 			          infos->state, ROHC_DECOMP_STATE_SC);
+			rohc_decomp_stats_add_transition(infos->context, ROHC_DECOMP_STATE_SC);
 			infos->context->state = ROHC_DECOMP_STATE_SC;
 		}
 		else
@@ -2362,8 +2902,18 @@ static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context
                                           const size_t comp_hdr_len,
                                           const size_t uncomp_hdr_len)
 {
+	const struct rohc_decomp *const decomp = context->decompressor;
+
 	context->header_compressed_size += comp_hdr_len;
 	context->header_uncompressed_size += uncomp_hdr_len;
+
+	if(decomp->detailed_stats != NULL)
+	{
+		rohc_stats_add_hdr(&decomp->detailed_stats[0].counters,
+		                   comp_hdr_len, uncomp_hdr_len);
+		rohc_stats_add_hdr(rohc_decomp_get_ctxt_stats(decomp, context->cid),
+		                   comp_hdr_len, uncomp_hdr_len);
+	}
 }
 
 
@@ -2387,6 +2937,115 @@ static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 }
 
 
+/**
+ * @brief Get the detailed statistics of the given CID
+ *
+ * @param decomp  The ROHC decompressor
+ * @param cid     The CID of the context
+ * @return        The detailed statistics of the CID
+ */
+static struct rohc_stats *
+	rohc_decomp_get_ctxt_stats(const struct rohc_decomp *const decomp,
+	                           const rohc_cid_t cid)
+{
+	assert(decomp->detailed_stats != NULL);
+	assert(cid <= decomp->medium.max_cid);
+
+	/* the first item is for the whole decompressor */
+	return &decomp->detailed_stats[1 + cid].counters;
+}
+
+
+/**
+ * @brief Record one state transition in the detailed statistics if enabled
+ *
+ * @param context    The decompression context that changes its state
+ * @param new_state  The state the context enters in
+ */
+static void rohc_decomp_stats_add_transition(struct rohc_decomp_ctxt *const context,
+                                             const rohc_decomp_state_t new_state)
+{
+	const struct rohc_decomp *const decomp = context->decompressor;
+
+	if(decomp->detailed_stats != NULL)
+	{
+		rohc_stats_add_transition(&decomp->detailed_stats[0].counters,
+		                          context->state, new_state);
+		rohc_stats_add_transition(rohc_decomp_get_ctxt_stats(decomp, context->cid),
+		                          context->state, new_state);
+	}
+}
+
+
+/**
+ * @brief Copy the given detailed statistics in the structure given by user
+ *
+ * The fields that depend on the states of contexts are reset.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param counters       The detailed statistics to copy
+ * @param[in,out] stats  The structure given by user
+ * @return               true if the statistics were successfully copied,
+ *                       false if the version of the structure is unsupported
+ */
+static bool rohc_decomp_stats_export(const struct rohc_decomp *const decomp,
+                                     const struct rohc_stats *const counters,
+                                     rohc_decomp_stats_snapshot_t *const stats)
+{
+	size_t i;
+	size_t j;
+
+	/* check compatibility version */
+	if(stats->version_major != 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "detailed statistics", stats->version_major);
+		goto error;
+	}
+	if(stats->version_minor != 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported minor version (%u) of the structure for "
+		           "detailed statistics", stats->version_minor);
+		goto error;
+	}
+
+	/* base fields for major version 0 */
+	stats->packets_nr = counters->packets_nr;
+	stats->uncomp_hdr_bytes = counters->uncomp_hdr_bytes;
+	stats->comp_hdr_bytes = counters->comp_hdr_bytes;
+	for(i = 0; i < ROHC_STATS_STATES_NR; i++)
+	{
+		stats->contexts_per_state[i] = 0;
+	}
+	for(i = 0; i < ROHC_STATS_TIME_BUCKETS; i++)
+	{
+		stats->time_hist[i] = counters->time_hist[i];
+	}
+	for(i = 0; i < ROHC_STATS_RATIO_BUCKETS; i++)
+	{
+		stats->ratio_hist[i] = counters->ratio_hist[i];
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		stats->packet_types[i] = counters->packet_types[i];
+	}
+	for(i = 0; i < ROHC_STATS_STATES_NR; i++)
+	{
+		for(j = 0; j < ROHC_STATS_STATES_NR; j++)
+		{
+			stats->transitions[i][j] = counters->transitions[i][j];
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Give a description for the given ROHC decompression context state
  *
@@ -2566,126 +3225,616 @@ bool rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
 		/* base fields for major version 0 */
 		if(decomp->contexts[cid] == NULL)
 		{
-			info->packets_nr = 0;
-			info->comp_bytes_nr = 0;
-			info->uncomp_bytes_nr = 0;
-			info->corrected_crc_failures = 0;
-			info->corrected_sn_wraparounds = 0;
-			info->corrected_wrong_sn_updates = 0;
+			info->packets_nr = 0;
+			info->comp_bytes_nr = 0;
+			info->uncomp_bytes_nr = 0;
+			info->corrected_crc_failures = 0;
+			info->corrected_sn_wraparounds = 0;
+			info->corrected_wrong_sn_updates = 0;
+		}
+		else
+		{
+			info->packets_nr = decomp->contexts[cid]->num_recv_packets;
+			info->comp_bytes_nr = decomp->contexts[cid]->total_compressed_size;
+			info->uncomp_bytes_nr = decomp->contexts[cid]->total_uncompressed_size;
+			info->corrected_crc_failures =
+				decomp->contexts[cid]->corrected_crc_failures;
+			info->corrected_sn_wraparounds =
+				decomp->contexts[cid]->corrected_sn_wraparounds;
+			info->corrected_wrong_sn_updates =
+				decomp->contexts[cid]->corrected_wrong_sn_updates;
+		}
+
+		/* new fields added by minor versions */
+		if(info->version_minor > 0)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "context information", info->version_minor);
+			goto error;
+		}
+	}
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for context"
+		           "information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some general information about the decompressor
+ *
+ * Get some general information about the decompressor.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_general_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *  - Major 0, minor 2
+ *
+ * See the \ref rohc_decomp_general_info_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_general_info_t
+ */
+bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
+                                  rohc_decomp_general_info_t *const info)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for general information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		/* base fields for major version 0 */
+		info->contexts_nr = decomp->num_contexts_used;
+		info->packets_nr = decomp->stats.received;
+		info->comp_bytes_nr = decomp->stats.total_compressed_size;
+		info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
+
+		/* new fields added by minor versions */
+		switch(info->version_minor)
+		{
+			case 0:
+				/* nothing to add */
+				break;
+			case 2:
+				/* new fields in 0.2 */
+				info->ctxts_mem_reserved = decomp->ctxt_slab.reserved_bytes;
+				info->ctxts_mem_peak = decomp->ctxt_slab.peak_bytes;
+				/* fields of 0.1 are also available in 0.2 */
+				/* fall through */
+			case 1:
+				/* new fields in 0.1 */
+				info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
+				info->corrected_sn_wraparounds =
+					decomp->stats.corrected_sn_wraparounds;
+				info->corrected_wrong_sn_updates =
+					decomp->stats.corrected_wrong_sn_updates;
+				break;
+			default:
+				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+				           "unsupported minor version (%u) of the structure for "
+				           "general information", info->version_minor);
+				goto error;
+		}
+	}
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "general information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get a snapshot of the detailed statistics of the whole decompressor
+ *
+ * Copy the detailed statistics of the decompressor in the given flat
+ * structure, eg. to export them to a monitoring system. The detailed
+ * statistics are kept only if the \ref ROHC_DECOMP_FEATURE_STATS feature is
+ * enabled.
+ *
+ * @param decomp         The ROHC decompressor to get statistics from
+ * @param[in,out] stats  The structure where to store the statistics, its
+ *                       \e version_major and \e version_minor fields shall
+ *                       be set by the caller
+ * @return               true if the statistics were successfully copied,
+ *                       false if a problem occurred
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_stats_snapshot_t
+ * @see rohc_decomp_get_ctxt_stats_snapshot
+ */
+bool rohc_decomp_get_stats_snapshot(const struct rohc_decomp *const decomp,
+                                    rohc_decomp_stats_snapshot_t *const stats)
+{
+	rohc_cid_t cid;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for detailed statistics is not valid");
+		goto error;
+	}
+
+	if(decomp->detailed_stats == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "detailed statistics are not enabled, see feature "
+		             "ROHC_DECOMP_FEATURE_STATS");
+		goto error;
+	}
+
+	if(!rohc_decomp_stats_export(decomp, &decomp->detailed_stats[0].counters,
+	                             stats))
+	{
+		goto error;
+	}
+	stats->profile_id = ROHC_PROFILE_GENERAL;
+
+	/* find out which contexts are stuck in the lower states */
+	for(cid = 0; cid <= decomp->medium.max_cid; cid++)
+	{
+		if(decomp->contexts[cid] != NULL)
+		{
+			assert(decomp->contexts[cid]->state < ROHC_STATS_STATES_NR);
+			stats->contexts_per_state[decomp->contexts[cid]->state]++;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get a snapshot of the detailed statistics of one context
+ *
+ * Copy the detailed statistics of the given decompression context in the
+ * given flat structure, eg. to export them to a monitoring system. The
+ * detailed statistics are kept only if the \ref ROHC_DECOMP_FEATURE_STATS
+ * feature is enabled.
+ *
+ * @param decomp         The ROHC decompressor to get statistics from
+ * @param cid            The CID of the context to get statistics for
+ * @param[in,out] stats  The structure where to store the statistics, its
+ *                       \e version_major and \e version_minor fields shall
+ *                       be set by the caller
+ * @return               true if the statistics were successfully copied,
+ *                       false if a problem occurred
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_stats_snapshot_t
+ * @see rohc_decomp_get_stats_snapshot
+ */
+bool rohc_decomp_get_ctxt_stats_snapshot(const struct rohc_decomp *const decomp,
+                                         const rohc_cid_t cid,
+                                         rohc_decomp_stats_snapshot_t *const stats)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for detailed statistics is not valid");
+		goto error;
+	}
+
+	if(decomp->detailed_stats == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "detailed statistics are not enabled, see feature "
+		             "ROHC_DECOMP_FEATURE_STATS");
+		goto error;
+	}
+
+	if(cid > decomp->medium.max_cid)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "CID %zu is greater than MAX_CID %zu", cid,
+		             decomp->medium.max_cid);
+		goto error;
+	}
+
+	if(!rohc_decomp_stats_export(decomp, rohc_decomp_get_ctxt_stats(decomp, cid),
+	                             stats))
+	{
+		goto error;
+	}
+	if(decomp->contexts[cid] != NULL)
+	{
+		assert(decomp->contexts[cid]->state < ROHC_STATS_STATES_NR);
+		stats->profile_id = decomp->contexts[cid]->profile->id;
+		stats->contexts_per_state[decomp->contexts[cid]->state] = 1;
+	}
+	else
+	{
+		stats->profile_id = ROHC_PROFILE_GENERAL;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Export the contexts of the ROHC decompressor in a snapshot
+ *
+ * Write a binary snapshot of the contexts of the decompressor at the end of
+ * the given buffer. Another decompressor may import the snapshot with
+ * \ref rohc_decomp_import_contexts to go on decompressing the same flows
+ * without waiting for new IR packets, eg. after a restart of the application.
+ * The snapshot format is versioned and does not depend on the platform.
+ *
+ * The contexts of the IP-only, UDP, UDP-Lite, ESP, RTP and TCP profiles are
+ * exported, provided that they decompressed at least one packet. The
+ * contexts of IPv6 flows are exported with their IPv6 extension headers and
+ * the tables of list decompression. The other contexts are not exported.
+ *
+ * @param decomp             The ROHC decompressor
+ * @param[in,out] snapshot   The buffer where to append the snapshot
+ * @return                   \ref ROHC_STATUS_OK if the snapshot was
+ *                           successfully written,
+ *                           \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the buffer
+ *                           is too small for the snapshot (the buffer is
+ *                           left unchanged),
+ *                           \ref ROHC_STATUS_ERROR if a problem occurred
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_import_contexts
+ */
+rohc_status_t rohc_decomp_export_contexts(const struct rohc_decomp *const decomp,
+                                          struct rohc_buf *const snapshot)
+{
+	size_t initial_len;
+	size_t ctxts_nr;
+	rohc_cid_t cid;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(snapshot == NULL || rohc_buf_is_malformed(*snapshot))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given snapshot buffer is not valid");
+		goto error;
+	}
+	initial_len = snapshot->len;
+
+	/* the snapshot header, the number of contexts is written at the end */
+	if(!rohc_snapshot_put(snapshot, ROHC_SNAPSHOT_MAGIC,
+	                      ROHC_SNAPSHOT_MAGIC_LEN) ||
+	   !rohc_snapshot_put8(snapshot, ROHC_SNAPSHOT_VERSION) ||
+	   !rohc_snapshot_put8(snapshot, ROHC_SNAPSHOT_KIND_DECOMP) ||
+	   !rohc_snapshot_put8(snapshot, decomp->medium.cid_type) ||
+	   !rohc_snapshot_put16(snapshot, decomp->medium.max_cid) ||
+	   !rohc_snapshot_put16(snapshot, 0))
+	{
+		goto too_small;
+	}
+
+	/* one record for every context that may be exported */
+	ctxts_nr = 0;
+	for(cid = 0; cid <= decomp->medium.max_cid; cid++)
+	{
+		const struct rohc_decomp_ctxt *const context = decomp->contexts[cid];
+		const size_t record_start = snapshot->len;
+		rohc_status_t status;
+		size_t record_len;
+
+		if(context == NULL)
+		{
+			continue;
+		}
+		if(context->profile->export_ctxt == NULL)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+			           "context with CID %zu not exported: profile does not "
+			           "support snapshots", cid);
+			continue;
 		}
-		else
+
+		/* the record header then the generic part of the context */
+		if(!rohc_snapshot_put16(snapshot, cid) ||
+		   !rohc_snapshot_put16(snapshot, context->profile->id) ||
+		   !rohc_snapshot_put16(snapshot, 0) ||
+		   !rohc_snapshot_put8(snapshot, context->mode) ||
+		   !rohc_snapshot_put8(snapshot, context->state) ||
+		   !rohc_snapshot_put64(snapshot, context->first_used) ||
+		   !rohc_snapshot_put64(snapshot, context->latest_used) ||
+		   !rohc_snapshot_put64(snapshot, context->num_recv_packets))
 		{
-			info->packets_nr = decomp->contexts[cid]->num_recv_packets;
-			info->comp_bytes_nr = decomp->contexts[cid]->total_compressed_size;
-			info->uncomp_bytes_nr = decomp->contexts[cid]->total_uncompressed_size;
-			info->corrected_crc_failures =
-				decomp->contexts[cid]->corrected_crc_failures;
-			info->corrected_sn_wraparounds =
-				decomp->contexts[cid]->corrected_sn_wraparounds;
-			info->corrected_wrong_sn_updates =
-				decomp->contexts[cid]->corrected_wrong_sn_updates;
+			goto too_small;
 		}
 
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		/* the profile-specific part of the context */
+		status = context->profile->export_ctxt(context, snapshot);
+		if(status == ROHC_STATUS_OUTPUT_TOO_SMALL)
 		{
-			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "context information", info->version_minor);
-			goto error;
+			goto too_small;
 		}
+		record_len = snapshot->len - record_start - ROHC_SNAPSHOT_CTXT_HDR_LEN;
+		if(status != ROHC_STATUS_OK || record_len > 0xffff)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+			           "context with CID %zu not exported: profile cannot "
+			           "export it", cid);
+			snapshot->len = record_start;
+			continue;
+		}
+		rohc_snapshot_set16(*snapshot, record_start + 4, record_len);
+		ctxts_nr++;
 	}
-	else
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for context"
-		           "information", info->version_major);
-		goto error;
-	}
+	rohc_snapshot_set16(*snapshot, initial_len + ROHC_SNAPSHOT_HDR_CTXTS_NR_OFFSET,
+	                    ctxts_nr);
 
-	return true;
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts exported in a %zu-byte snapshot", ctxts_nr,
+	          snapshot->len - initial_len);
+
+	return ROHC_STATUS_OK;
 
+too_small:
+	rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	             "snapshot buffer is too small for the contexts");
+	snapshot->len = initial_len;
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
 error:
-	return false;
+	return ROHC_STATUS_ERROR;
 }
 
 
 /**
- * @brief Get some general information about the decompressor
+ * @brief Import the contexts of a ROHC decompressor from a snapshot
  *
- * Get some general information about the decompressor.
- *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_decomp_general_info_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
+ * Create the contexts recorded in a snapshot written by
+ * \ref rohc_decomp_export_contexts. The decompressor shall use no context
+ * yet, and it shall be configured as the decompressor that wrote the snapshot
+ * (CID type, enabled profiles...). The contexts are restored with their
+ * state, so that the compressed packets of their flows are decompressed as
+ * if the decompressor had never stopped.
  *
- * See the \ref rohc_decomp_general_info_t structure for details about fields
- * that are supported in the above versions.
+ * The records of contexts with disabled or unknown profiles are skipped, as
+ * well as the records of contexts with CIDs greater than MAX_CID. If the
+ * snapshot is malformed, no context is imported at all.
  *
- * @param decomp        The ROHC decompressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param decomp    The ROHC decompressor
+ * @param snapshot  The snapshot to import contexts from
+ * @return          true if the snapshot was successfully imported,
+ *                  false if a problem occurred
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_general_info_t
+ * @see rohc_decomp_export_contexts
  */
-bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
-                                  rohc_decomp_general_info_t *const info)
+bool rohc_decomp_import_contexts(struct rohc_decomp *const decomp,
+                                 const struct rohc_buf snapshot)
 {
+	struct rohc_buf remain = snapshot;
+	uint8_t magic[ROHC_SNAPSHOT_MAGIC_LEN];
+	uint8_t version;
+	uint8_t kind;
+	uint8_t cid_type;
+	uint16_t max_cid;
+	uint16_t ctxts_nr;
+	size_t imported_nr;
+	size_t i;
+
 	if(decomp == NULL)
 	{
 		goto error;
 	}
 
-	if(info == NULL)
+	if(rohc_buf_is_malformed(snapshot))
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "structure for general information is not valid");
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given snapshot is malformed");
+		goto error;
+	}
+	if(decomp->num_contexts_used > 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot import contexts in a decompressor that already "
+		             "uses %zu contexts", decomp->num_contexts_used);
 		goto error;
 	}
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	/* the snapshot header */
+	if(!rohc_snapshot_get(&remain, magic, ROHC_SNAPSHOT_MAGIC_LEN) ||
+	   !rohc_snapshot_get8(&remain, &version) ||
+	   !rohc_snapshot_get8(&remain, &kind) ||
+	   !rohc_snapshot_get8(&remain, &cid_type) ||
+	   !rohc_snapshot_get16(&remain, &max_cid) ||
+	   !rohc_snapshot_get16(&remain, &ctxts_nr))
 	{
-		/* base fields for major version 0 */
-		info->contexts_nr = decomp->num_contexts_used;
-		info->packets_nr = decomp->stats.received;
-		info->comp_bytes_nr = decomp->stats.total_compressed_size;
-		info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "snapshot is too short for its header");
+		goto error;
+	}
+	if(memcmp(magic, ROHC_SNAPSHOT_MAGIC, ROHC_SNAPSHOT_MAGIC_LEN) != 0 ||
+	   kind != ROHC_SNAPSHOT_KIND_DECOMP)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "data is not a snapshot of decompression contexts");
+		goto error;
+	}
+	if(version != ROHC_SNAPSHOT_VERSION)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unsupported version %u of snapshot", version);
+		goto error;
+	}
+	if(cid_type != decomp->medium.cid_type)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "snapshot was written by a decompressor with another CID "
+		             "type");
+		goto error;
+	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "snapshot with %u contexts (MAX_CID = %u)", ctxts_nr, max_cid);
 
-		/* new fields added by minor versions */
-		switch(info->version_minor)
+	/* the records of contexts */
+	imported_nr = 0;
+	for(i = 0; i < ctxts_nr; i++)
+	{
+		const struct rohc_decomp_profile *profile;
+		struct rohc_decomp_ctxt *context;
+		const struct rohc_ts unknown_time = { .sec = 0, .nsec = 0 };
+		struct rohc_buf record;
+		uint16_t cid;
+		uint16_t profile_id;
+		uint16_t record_len;
+		uint8_t mode;
+		uint8_t state;
+		uint64_t first_used;
+		uint64_t latest_used;
+		uint64_t num_recv_packets;
+
+		if(!rohc_snapshot_get16(&remain, &cid) ||
+		   !rohc_snapshot_get16(&remain, &profile_id) ||
+		   !rohc_snapshot_get16(&remain, &record_len) ||
+		   remain.len < record_len)
 		{
-			case 0:
-				/* nothing to add */
-				break;
-			case 1:
-				/* new fields in 0.1 */
-				info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
-				info->corrected_sn_wraparounds =
-					decomp->stats.corrected_sn_wraparounds;
-				info->corrected_wrong_sn_updates =
-					decomp->stats.corrected_wrong_sn_updates;
-				break;
-			default:
-				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-				           "unsupported minor version (%u) of the structure for "
-				           "general information", info->version_minor);
-				goto error;
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "snapshot is too short for context #%zu", i + 1);
+			goto destroy_contexts;
+		}
+		record = remain;
+		record.len = record_len;
+		rohc_buf_pull(&remain, record_len);
+
+		/* skip the contexts that the decompressor cannot handle */
+		if(cid > decomp->medium.max_cid)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "context with CID %u not imported: CID is greater "
+			             "than MAX_CID %zu", cid, decomp->medium.max_cid);
+			continue;
+		}
+		profile = find_profile(decomp, profile_id);
+		if(profile == NULL || profile->import_ctxt == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "context with CID %u not imported: profile 0x%04x is "
+			             "not enabled or does not support snapshots", cid,
+			             profile_id);
+			continue;
+		}
+		if(decomp->contexts[cid] != NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "snapshot contains context with CID %u twice", cid);
+			goto destroy_contexts;
+		}
+
+		/* the generic part of the context */
+		if(!rohc_snapshot_get8(&record, &mode) ||
+		   !rohc_snapshot_get8(&record, &state) ||
+		   !rohc_snapshot_get64(&record, &first_used) ||
+		   !rohc_snapshot_get64(&record, &latest_used) ||
+		   !rohc_snapshot_get64(&record, &num_recv_packets) ||
+		   mode < ROHC_U_MODE || mode > ROHC_R_MODE ||
+		   state < ROHC_DECOMP_STATE_NC || state > ROHC_DECOMP_STATE_FC)
+		{
+			goto malformed_record;
+		}
+
+		context = context_create(decomp, cid, profile, unknown_time);
+		if(context == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to create context with CID %u", cid);
+			goto destroy_contexts;
+		}
+		rohc_decomp_stats_add_transition(context, state);
+		context->mode = mode;
+		context->state = state;
+		context->first_used = first_used;
+		context->latest_used = latest_used;
+		context->num_recv_packets = num_recv_packets;
+		if(!profile->import_ctxt(context, &record) || record.len != 0)
+		{
+			context_free(context);
+			goto malformed_record;
 		}
+		decomp->contexts[cid] = context;
+		imported_nr++;
 	}
-	else
+	if(remain.len != 0)
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for "
-		           "general information", info->version_major);
-		goto error;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "%zu unexpected bytes at the end of snapshot", remain.len);
+		goto destroy_contexts;
 	}
 
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts imported from snapshot", imported_nr);
+
 	return true;
 
+malformed_record:
+	rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	             "malformed record for context #%zu in snapshot", i + 1);
+destroy_contexts:
+	for(i = 0; i <= decomp->medium.max_cid; i++)
+	{
+		if(decomp->contexts[i] != NULL)
+		{
+			context_free(decomp->contexts[i]);
+			decomp->contexts[i] = NULL;
+		}
+	}
+	decomp->last_context = NULL;
 error:
 	return false;
 }
@@ -2770,7 +3919,10 @@ error:
  * upon decompression until the last segment is received (or a non-segment is
  * received). Decompressed data will be returned at that time.
  *
- * @warning Changing the MRRU value while library is used may lead to
+ * The memory required to store one MRRU is allocated only when segmentation
+ * is enabled.
+ *
+ * @warning Changing the MRRU value while library is used leads to the
  *          destruction of the current RRU.
  *
  * @param decomp  The ROHC decompressor
@@ -2818,6 +3970,34 @@ bool rohc_decomp_set_mrru(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
+	/* allocate the RRU buffer only when segmentation is enabled, the RRU
+	 * being reassembled (if any) is lost */
+	if(mrru != decomp->mrru)
+	{
+		uint8_t *rru = NULL;
+
+		if(mrru > 0)
+		{
+			rru = malloc(mrru);
+			if(rru == NULL)
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+				             "failed to allocate memory for the %zu-byte RRU",
+				             mrru);
+				goto error;
+			}
+		}
+		if(decomp->rru_len != 0)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "MRRU changed: drop the %zu bytes of the RRU being "
+			             "reassembled", decomp->rru_len);
+			decomp->rru_len = 0;
+		}
+		free(decomp->rru);
+		decomp->rru = rru;
+	}
+
 	/* set new MRRU */
 	decomp->mrru = mrru;
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -3205,6 +4385,15 @@ error:
  *
  * @warning Changing the feature set while library is used is not supported
  *
+ * The \ref ROHC_DECOMP_FEATURE_CTXT_SLAB feature preallocates the memory of
+ * all contexts, it shall be changed right after the decompressor creation:
+ * the call fails if contexts are in use.
+ *
+ * The \ref ROHC_DECOMP_FEATURE_STATS feature allocates the memory for the
+ * detailed statistics of the decompressor and of all its contexts. The
+ * statistics start from zero every time the feature is enabled. They are
+ * released when the feature is disabled.
+ *
  * @param decomp    The ROHC decompressor
  * @param features  The feature set to enable/disable
  * @return          true if the feature set was successfully enabled/disabled,
@@ -3219,7 +4408,10 @@ bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
 {
 	const rohc_decomp_features_t all_features =
 		ROHC_DECOMP_FEATURE_CRC_REPAIR |
-		ROHC_DECOMP_FEATURE_DUMP_PACKETS;
+		ROHC_DECOMP_FEATURE_DUMP_PACKETS |
+		ROHC_DECOMP_FEATURE_CTXT_SLAB |
+		ROHC_DECOMP_FEATURE_STATS;
+	union rohc_stats_padded *detailed_stats;
 
 	/* decompressor must be valid */
 	if(decomp == NULL)
@@ -3237,11 +4429,64 @@ bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
+	/* memory for detailed statistics is allocated when they are enabled: one
+	 * item for the whole decompressor, then one item per CID */
+	detailed_stats = decomp->detailed_stats;
+	if((features & ROHC_DECOMP_FEATURE_STATS) != 0 && detailed_stats == NULL)
+	{
+		detailed_stats = calloc(1 + decomp->medium.max_cid + 1,
+		                        sizeof(union rohc_stats_padded));
+		if(detailed_stats == NULL)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "failed to allocate memory for detailed statistics");
+			goto error;
+		}
+	}
+
+	/* context memory may be preallocated or released only while no context
+	 * is in use */
+	if((features & ROHC_DECOMP_FEATURE_CTXT_SLAB) !=
+	   (decomp->features & ROHC_DECOMP_FEATURE_CTXT_SLAB))
+	{
+		if(decomp->num_contexts_used > 0)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "cannot change preallocation of contexts while %zu "
+			             "contexts are in use", decomp->num_contexts_used);
+			goto free_stats;
+		}
+		if((features & ROHC_DECOMP_FEATURE_CTXT_SLAB) != 0)
+		{
+			if(!rohc_decomp_prealloc_contexts(decomp))
+			{
+				goto free_stats;
+			}
+		}
+		else
+		{
+			rohc_slab_reset(&decomp->ctxt_slab);
+		}
+	}
+
+	/* release detailed statistics when they are disabled */
+	if((features & ROHC_DECOMP_FEATURE_STATS) == 0 && detailed_stats != NULL)
+	{
+		free(detailed_stats);
+		detailed_stats = NULL;
+	}
+
 	/* record new feature set */
+	decomp->detailed_stats = detailed_stats;
 	decomp->features = features;
 
 	return true;
 
+free_stats:
+	if(detailed_stats != decomp->detailed_stats)
+	{
+		free(detailed_stats);
+	}
 error:
 	return false;
 }
@@ -3614,6 +4859,66 @@ error:
 }
 
 
+/**
+ * @brief Set the minimum level of the traces in decompressor
+ *
+ * Set the minimum level of the traces that the decompressor gives to the
+ * user-defined trace callback. The traces of lower levels are skipped
+ * before their arguments are evaluated, so they cost almost nothing on the
+ * fast path. The traces below the level selected by the configure option
+ * --with-max-trace-level are never built in the library whatever the
+ * minimum level set here.
+ *
+ * The default minimum level is \ref ROHC_TRACE_DEBUG, ie. all traces are
+ * given to the callback.
+ *
+ * @warning The minimum level can not be modified after library
+ *          initialization, like the trace callback
+ *
+ * @param decomp     The ROHC decompressor
+ * @param min_level  The minimum level of the traces to give to the callback
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_traces_cb2
+ */
+bool rohc_decomp_set_traces_min_level(struct rohc_decomp *const decomp,
+                                      const rohc_trace_level_t min_level)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* check the trace level */
+	if(min_level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "invalid minimum level %d for traces", min_level);
+		goto error;
+	}
+
+	/* refuse to set a new minimum level if decompressor is in use: the
+	 * contexts and their encoding schemes keep a copy of it */
+	if(decomp->stats.received > 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the minimum level of traces after initialization");
+		goto error;
+	}
+
+	decomp->trace_min_level = min_level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /*
  * Private functions
  */
@@ -4119,6 +5424,60 @@ static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
 }
 
 
+/**
+ * @brief Preallocate the memory of the decompression contexts
+ *
+ * Every CID gets the objects required by the most demanding profile, so that
+ * contexts of any profile may be created and destroyed without calling the
+ * system allocator. One more set of objects is reserved because the new
+ * context for one CID is created before the old one is destroyed.
+ *
+ * @param decomp  The ROHC decompressor
+ * @return        true if the preallocation is successful, false otherwise
+ */
+static bool rohc_decomp_prealloc_contexts(struct rohc_decomp *const decomp)
+{
+	const size_t slots_nr = decomp->medium.max_cid + 2;
+	size_t i;
+
+	assert(decomp->num_contexts_used == 0);
+
+	for(i = 0; i < D_NUM_PROFILES; i++)
+	{
+		size_t objs_sizes[ROHC_DECOMP_CTXT_OBJS_MAX + 1];
+
+		/* the generic context, then the profile-specific objects */
+		objs_sizes[0] = sizeof(struct rohc_decomp_ctxt);
+		memcpy(objs_sizes + 1, rohc_decomp_profiles[i]->ctxt_objs_sizes,
+		       ROHC_DECOMP_CTXT_OBJS_MAX * sizeof(size_t));
+
+		if(!rohc_slab_add(&decomp->ctxt_slab, objs_sizes,
+		                  ROHC_DECOMP_CTXT_OBJS_MAX + 1, slots_nr))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "too many different context objects for profile "
+			             "0x%04x", rohc_decomp_profiles[i]->id);
+			goto reset_slab;
+		}
+	}
+	if(!rohc_slab_prealloc(&decomp->ctxt_slab))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "not enough memory to preallocate contexts");
+		goto reset_slab;
+	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "%zu bytes preallocated for %zu contexts",
+	           decomp->ctxt_slab.reserved_bytes, slots_nr);
+
+	return true;
+
+reset_slab:
+	rohc_slab_reset(&decomp->ctxt_slab);
+	return false;
+}
+
+
 /**
  * @brief Does packet type carry static information?
  *
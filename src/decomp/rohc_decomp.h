@@ -268,9 +268,98 @@ typedef struct
 	 *  upon CRC failure */
 	unsigned long corrected_wrong_sn_updates;
 
+	/* added in 0.2 */
+	/** The number of bytes preallocated for contexts, see
+	 *  \ref ROHC_DECOMP_FEATURE_CTXT_SLAB */
+	size_t ctxts_mem_reserved;
+	/** The largest number of preallocated bytes ever used by contexts */
+	size_t ctxts_mem_peak;
+
 } __attribute__((packed)) rohc_decomp_general_info_t;
 
 
+/**
+ * @brief A snapshot of the detailed statistics of the decompressor
+ *
+ * The structure is used by the \ref rohc_decomp_get_stats_snapshot and
+ * \ref rohc_decomp_get_ctxt_stats_snapshot functions to store the detailed
+ * statistics of the whole decompressor or of one of its contexts. The
+ * detailed statistics are kept only if the \ref ROHC_DECOMP_FEATURE_STATS
+ * feature is enabled.
+ *
+ * Only the successfully decompressed packets are counted, feedback-only
+ * packets are not. The processing time is the time spent in the
+ * decompression functions of the library.
+ *
+ * The statistics of one context are reset when a new context is created for
+ * the CID. The statistics of the whole decompressor are kept since the
+ * \ref ROHC_DECOMP_FEATURE_STATS feature was enabled.
+ *
+ * Versioning works as follow:
+ *  - The \e version_major field defines the compatibility level. If the major
+ *    number given by user does not match the one expected by the library,
+ *    an error is returned.
+ *  - The \e version_minor field defines the extension level. If the minor
+ *    number given by user does not match the one expected by the library,
+ *    only the fields supported in that minor version will be filled by
+ *    \ref rohc_decomp_get_stats_snapshot.
+ *
+ * Notes for developers:
+ *  - Increase the major version if a field is removed.
+ *  - Increase the major version if a field is added at the beginning or in
+ *    the middle of the structure.
+ *  - Increase the minor version if a field is added at the very end of the
+ *    structure.
+ *  - The version_major and version_minor fields must be located at the very
+ *    beginning of the structure.
+ *  - The structure must be packed.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    profile_id, packets_nr, uncomp_hdr_bytes, comp_hdr_bytes,
+ *    contexts_per_state, time_hist, ratio_hist, packet_types, and
+ *    transitions.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_stats_snapshot
+ * @see rohc_decomp_get_ctxt_stats_snapshot
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The profile ID of the context, \ref ROHC_PROFILE_GENERAL for the whole
+	 *  decompressor or for a CID without context */
+	int profile_id;
+	/** The number of packets decompressed successfully */
+	uint64_t packets_nr;
+	/** The number of bytes of the uncompressed headers */
+	uint64_t uncomp_hdr_bytes;
+	/** The number of bytes of the compressed headers */
+	uint64_t comp_hdr_bytes;
+	/** The number of contexts in every state (indexed by
+	 *  \ref rohc_decomp_state_t), at most 1 for a single context */
+	uint64_t contexts_per_state[ROHC_STATS_STATES_NR];
+	/** The log2 histogram of the processing times, see
+	 *  \ref ROHC_STATS_TIME_BUCKETS */
+	uint64_t time_hist[ROHC_STATS_TIME_BUCKETS];
+	/** The histogram of the header compression ratios, see
+	 *  \ref ROHC_STATS_RATIO_BUCKETS */
+	uint64_t ratio_hist[ROHC_STATS_RATIO_BUCKETS];
+	/** The number of ROHC packets of every type (indexed by
+	 *  \ref rohc_packet_t) */
+	uint64_t packet_types[ROHC_PACKET_MAX];
+	/** The number of transitions from one state (first index) to another
+	 *  state (second index), a transition from the unknown state is the
+	 *  creation of a context */
+	uint64_t transitions[ROHC_STATS_STATES_NR][ROHC_STATS_STATES_NR];
+
+} __attribute__((packed)) rohc_decomp_stats_snapshot_t;
+
+
 /**
  * @brief The different features of the ROHC decompressor
  *
@@ -292,6 +381,10 @@ typedef enum
 	ROHC_DECOMP_FEATURE_COMPAT_1_6_x = (1 << 1),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_DECOMP_FEATURE_DUMP_PACKETS = (1 << 3),
+	/** Preallocate the memory of all contexts (no malloc for new contexts) */
+	ROHC_DECOMP_FEATURE_CTXT_SLAB    = (1 << 4),
+	/** Keep detailed statistics (beware: performance impact) */
+	ROHC_DECOMP_FEATURE_STATS        = (1 << 5),
 
 } rohc_decomp_features_t;
 
@@ -315,6 +408,20 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            struct rohc_buf *const feedback_send)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                                  struct rohc_buf *const packet,
+                                                  struct rohc_buf *const rcvd_feedback,
+                                                  struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decompress_burst(struct rohc_decomp *const decomp,
+                                         const struct rohc_buf rohc_packets[],
+                                         struct rohc_buf uncomp_packets[],
+                                         rohc_status_t statuses[],
+                                         const size_t packets_nr,
+                                         struct rohc_buf *const rcvd_feedback,
+                                         struct rohc_buf *const feedback_send);
+
 
 
 /*
@@ -337,6 +444,23 @@ bool ROHC_EXPORT rohc_decomp_get_last_packet_info(const struct rohc_decomp *cons
                                                   rohc_decomp_last_packet_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_get_stats_snapshot(const struct rohc_decomp *const decomp,
+                                                rohc_decomp_stats_snapshot_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_ctxt_stats_snapshot(const struct rohc_decomp *const decomp,
+                                                     const rohc_cid_t cid,
+                                                     rohc_decomp_stats_snapshot_t *const stats)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decomp_export_contexts(const struct rohc_decomp *const decomp,
+                                                      struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_import_contexts(struct rohc_decomp *const decomp,
+                                             const struct rohc_buf snapshot)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to user parameters
@@ -427,6 +551,10 @@ bool ROHC_EXPORT rohc_decomp_set_traces_cb2(struct rohc_decomp *const decomp,
                                             void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_traces_min_level(struct rohc_decomp *const decomp,
+                                                  const rohc_trace_level_t min_level)
+	__attribute__((warn_unused_result));
+
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
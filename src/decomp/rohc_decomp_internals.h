@@ -32,6 +32,8 @@
 #include "rohc_traces_internal.h"
 #include "feedback_create.h"
 #include "crc.h"
+#include "rohc_slab.h"
+#include "rohc_stats_internal.h"
 
 
 /*
@@ -42,6 +44,13 @@
 /** The number of ROHC profiles ready to be used */
 #define D_NUM_PROFILES 7U
 
+/** The maximal number of packets that \ref rohc_decompress_burst parses
+ *  ahead of decompression */
+#define ROHC_DECOMP_BURST_MAX  32U
+
+/** The maximum number of objects a profile allocates for one context */
+#define ROHC_DECOMP_CTXT_OBJS_MAX  16U
+
 
 /** Print a warning trace for the given decompression context */
 #define rohc_decomp_warn(context, format, ...) \
@@ -59,10 +68,8 @@
 #define rohc_decomp_dump_buf(context, descr, buf, buf_len) \
 	do { \
 		if(((context)->decompressor->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0) { \
-			rohc_dump_buf((context)->decompressor->trace_callback, \
-			              (context)->decompressor->trace_callback_priv, \
-			              ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG, \
-			              descr, buf, buf_len); \
+			rohc_dump_buf((context)->decompressor, ROHC_TRACE_DECOMP, \
+			              ROHC_TRACE_DEBUG, descr, buf, buf_len); \
 		} \
 	} while(0)
 
@@ -141,69 +148,77 @@ struct rohc_ack_stats
  */
 struct rohc_decomp
 {
+	/* variables used for every packet: they are grouped at the beginning of
+	 * the structure so that they share as few cache lines as possible */
+
 	/** The medium associated with the decompressor */
 	struct rohc_medium medium;
 
 	/** Enabled/disabled features for the decompressor */
 	rohc_decomp_features_t features;
 
-	/** Which profiles are enabled and with one are not? */
-	bool enabled_profiles[D_NUM_PROFILES];
-
 	/** The operation mode that the contexts shall target */
 	rohc_mode_t target_mode;
 
 	/** The array of decompression contexts that use the decompressor */
 	struct rohc_decomp_ctxt **contexts;
-	/** The number of decompression contexts in use */
-	size_t num_contexts_used;
 	/** The last decompression context used by the decompressor */
 	struct rohc_decomp_ctxt *last_context;
+	/** The number of decompression contexts in use */
+	size_t num_contexts_used;
 
+	/** The callback function used to manage traces */
+	rohc_trace_callback2_t trace_callback;
+	/** The private context of the callback function used to manage traces */
+	void *trace_callback_priv;
+	/** The minimum level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 
-	/* feedback-related variables */
-
+	/** Whether the last decompressed packets failed or not */
+	uint32_t last_pkts_errors;
+	/** The informations for feedback rate-limiting */
+	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
 	/** The maximum number of packets sent during one RTT */
 	size_t prtt;
 	/** The minimum number of SN bits to transmit in feedbacks */
 	size_t sn_feedback_min_bits;
+
+	/** The Maximum Reconstructed Reception Unit (MRRU) */
+	size_t mrru;
+	/** The length (in bytes) of the Reconstructed Reception Unit */
+	size_t rru_len;
+
 	/** The configuration for feedback rate-limiting */
 	struct rohc_ack_rate_limits ack_rate_limits;
-	/** Whether the last decompressed packets failed or not */
-	uint32_t last_pkts_errors;
-	/** The informations for feedback rate-limiting */
-	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
 
+	/** Some statistics about the decompression processes */
+	struct d_statistics stats;
+	/** The detailed statistics, allocated only if the feature
+	 *  ROHC_DECOMP_FEATURE_STATS is enabled: the first item is for the whole
+	 *  decompressor, the next ones for the contexts indexed by CID */
+	union rohc_stats_padded *detailed_stats;
 
-	/* segment-related variables */
-
-/** The maximal value for MRRU */
-#define ROHC_MAX_MRRU 65535
-	/** The Reconstructed Reception Unit */
-	uint8_t rru[ROHC_MAX_MRRU];
-	/** The length (in bytes) of the Reconstructed Reception Unit */
-	size_t rru_len;
-	/** The Maximum Reconstructed Reception Unit (MRRU) */
-	size_t mrru;
+	/** Which profiles are enabled and with one are not? */
+	bool enabled_profiles[D_NUM_PROFILES];
 
 
-	/* CRC-related variables: */
+	/* context-management variables used only when contexts are created or
+	 * destroyed */
 
-	/** The table to enable fast CRC-3 computation */
-	uint8_t crc_table_3[256];
-	/** The table to enable fast CRC-7 computation */
-	uint8_t crc_table_7[256];
-	/** The table to enable fast CRC-8 computation */
-	uint8_t crc_table_8[256];
+	/** The memory preallocated for the contexts if the feature
+	 *  ROHC_DECOMP_FEATURE_CTXT_SLAB is enabled, empty otherwise */
+	struct rohc_slab ctxt_slab;
 
 
-	/** Some statistics about the decompression processes */
-	struct d_statistics stats;
+	/* segment-related variables */
 
-	/** The callback function used to manage traces */
-	rohc_trace_callback2_t trace_callback;
-	/** The private context of the callback function used to manage traces */
-	void *trace_callback_priv;
+/** The maximal value for MRRU */
+#define ROHC_MAX_MRRU 65535
+	/** The Reconstructed Reception Unit, MRRU-byte long, allocated only
+	 *  when segmentation is enabled with \ref rohc_decomp_set_mrru */
+	uint8_t *rru;
+	/** The fastest FCS-32 implementation for the CPU, used to check RRUs */
+	rohc_crc_fcs32_t crc_fcs32;
 };
 
 
@@ -342,9 +357,10 @@ typedef bool (*rohc_decomp_new_context_t)(const struct rohc_decomp_ctxt *const c
                                           struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt,
+typedef void (*rohc_decomp_free_context_t)(const struct rohc_decomp_ctxt *const context,
+                                           void *const persist_ctxt,
                                            const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+	__attribute__((nonnull(1, 3)));
 
 typedef rohc_packet_t (*rohc_decomp_detect_pkt_type_t) (const struct rohc_decomp_ctxt *const context,
                                                         const uint8_t *const rohc_packet,
@@ -393,6 +409,14 @@ typedef bool (*rohc_decomp_attempt_repair_t)(const struct rohc_decomp *const dec
 typedef uint32_t (*rohc_decomp_get_sn_t)(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+typedef rohc_status_t (*rohc_decomp_export_ctxt_t)(const struct rohc_decomp_ctxt *const context,
+                                                   struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+typedef bool (*rohc_decomp_import_ctxt_t)(struct rohc_decomp_ctxt *const context,
+                                          struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 
 /**
  * @brief The ROHC decompression profile.
@@ -408,6 +432,11 @@ struct rohc_decomp_profile
 	/** The maximum number of bits of the Master Sequence Number (MSN) */
 	const size_t msn_max_bits;
 
+	/** The sizes of the objects the profile allocates for every context, used
+	 *  to preallocate the context slab if the feature
+	 *  ROHC_DECOMP_FEATURE_CTXT_SLAB is enabled. Unused entries are zero. */
+	const size_t ctxt_objs_sizes[ROHC_DECOMP_CTXT_OBJS_MAX];
+
 	/** @brief The handler used to create the profile-specific part of the
 	 *         decompression context */
 	rohc_decomp_new_context_t new_context;
@@ -436,6 +465,14 @@ struct rohc_decomp_profile
 
 	/* The handler used to retrieve the Sequence Number (SN) */
 	rohc_decomp_get_sn_t get_sn;
+
+	/** The handler used to write the profile-specific part of the context in
+	 *  a snapshot, NULL if the profile does not support snapshots */
+	rohc_decomp_export_ctxt_t export_ctxt;
+
+	/** The handler used to read the profile-specific part of the context from
+	 *  a snapshot, NULL if the profile does not support snapshots */
+	rohc_decomp_import_ctxt_t import_ctxt;
 };
 
 #endif
@@ -38,6 +38,7 @@
 #include "rohc_decomp_detect_packet.h"
 #include "schemes/decomp_wlsb.h"
 #include "schemes/decomp_list_ipv6.h"
+#include "rohc_snapshot.h"
 #include "sdvl.h"
 #include "crc.h"
 
@@ -319,14 +320,19 @@ static bool decode_ip_values_from_bits(const struct rohc_decomp_ctxt *const cont
  * Private function prototypes for miscellaneous functions
  */
 
-static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
-                             const struct rohc_decomp_ctxt *const context,
+static bool check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
                              const uint8_t *const outer_ip_hdr,
                              const uint8_t *const inner_ip_hdr,
                              const uint8_t *const next_header,
                              const rohc_crc_type_t crc_type,
-                             const uint8_t crc_packet)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+                             const uint8_t crc_packet,
+                             const bool crc_static_changed)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+static bool is_ip_crc_static_changed(const struct rohc_decomp_rfc3095_changes *const ctxt,
+                                     const struct rohc_extr_ip_bits *const bits,
+                                     const struct rohc_decoded_ip_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
                              const struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES],
@@ -371,7 +377,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
 	/* allocate memory for the generic context */
-	*persist_ctxt = malloc(sizeof(struct rohc_decomp_rfc3095_ctxt));
+	*persist_ctxt = rohc_slab_malloc(&context->decompressor->ctxt_slab,
+	                                 sizeof(struct rohc_decomp_rfc3095_ctxt));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -382,7 +389,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt, 0, sizeof(struct rohc_decomp_rfc3095_ctxt));
 
 	/* create the Offset IP-ID decoding context for outer IP header */
-	rfc3095_ctxt->outer_ip_id_offset_ctxt = ip_id_offset_new();
+	rfc3095_ctxt->outer_ip_id_offset_ctxt =
+		ip_id_offset_new(&context->decompressor->ctxt_slab);
 	if(rfc3095_ctxt->outer_ip_id_offset_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -392,7 +400,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the Offset IP-ID decoding context for inner IP header */
-	rfc3095_ctxt->inner_ip_id_offset_ctxt = ip_id_offset_new();
+	rfc3095_ctxt->inner_ip_id_offset_ctxt =
+		ip_id_offset_new(&context->decompressor->ctxt_slab);
 	if(rfc3095_ctxt->inner_ip_id_offset_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -401,7 +410,9 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 		goto free_outer_ip_id_offset_ctxt;
 	}
 
-	rfc3095_ctxt->outer_ip_changes = malloc(sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->outer_ip_changes =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->outer_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -410,7 +421,9 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	}
 	memset(rfc3095_ctxt->outer_ip_changes, 0, sizeof(struct rohc_decomp_rfc3095_changes));
 
-	rfc3095_ctxt->inner_ip_changes = malloc(sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->inner_ip_changes =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab,
+		                 sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->inner_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -422,9 +435,11 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* init the context used to compress the list of IPv6 extension headers
 	 * for the outer and inner IP headers */
 	rohc_decomp_list_ipv6_new(&rfc3095_ctxt->list_decomp1,
-	                          trace_cb, trace_cb_priv, profile_id);
+	                          trace_cb, trace_cb_priv,
+	                          context->decompressor->trace_min_level, profile_id);
 	rohc_decomp_list_ipv6_new(&rfc3095_ctxt->list_decomp2,
-	                          trace_cb, trace_cb_priv, profile_id);
+	                          trace_cb, trace_cb_priv,
+	                          context->decompressor->trace_min_level, profile_id);
 
 	/* no default next header */
 	rfc3095_ctxt->next_header_proto = 0;
@@ -436,14 +451,16 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_extr_bits));
+	volat_ctxt->extr_bits = rohc_slab_malloc(&context->decompressor->ctxt_slab,
+	                                         sizeof(struct rohc_extr_bits));
 	if(volat_ctxt->extr_bits == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
 		                 "of one of the RFC3095 decompression context");
 		goto free_inner_ip_changes;
 	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_decoded_values));
+	volat_ctxt->decoded_values =
+		rohc_slab_malloc(&context->decompressor->ctxt_slab, sizeof(struct rohc_decoded_values));
 	if(volat_ctxt->decoded_values == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
@@ -454,17 +471,19 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	return rfc3095_ctxt;
 
 free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab, volat_ctxt->extr_bits);
 free_inner_ip_changes:
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab, rfc3095_ctxt->inner_ip_changes);
 free_outer_ip_changes:
-	zfree(rfc3095_ctxt->outer_ip_changes);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab, rfc3095_ctxt->outer_ip_changes);
 free_inner_ip_id_offset_ctxt:
-	ip_id_offset_free(rfc3095_ctxt->inner_ip_id_offset_ctxt);
+	ip_id_offset_free(&context->decompressor->ctxt_slab,
+	                  rfc3095_ctxt->inner_ip_id_offset_ctxt);
 free_outer_ip_id_offset_ctxt:
-	ip_id_offset_free(rfc3095_ctxt->outer_ip_id_offset_ctxt);
+	ip_id_offset_free(&context->decompressor->ctxt_slab,
+	                  rfc3095_ctxt->outer_ip_id_offset_ctxt);
 free_context:
-	zfree(rfc3095_ctxt);
+	rohc_slab_zfree(&context->decompressor->ctxt_slab, *persist_ctxt);
 quit:
 	return NULL;
 }
@@ -476,23 +495,27 @@ quit:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * @param context       The decompression context
  * @param rfc3095_ctxt  The generic decompression context
  * @param volat_ctxt    The volatile part of the decompression context
  */
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+void rohc_decomp_rfc3095_destroy(const struct rohc_decomp_ctxt *const context,
+                                 struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                  const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = &context->decompressor->ctxt_slab;
+
 	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_slab_free(slab, volat_ctxt->decoded_values);
+	rohc_slab_free(slab, volat_ctxt->extr_bits);
 
 	/* destroy Offset IP-ID decoding contexts */
-	ip_id_offset_free(rfc3095_ctxt->outer_ip_id_offset_ctxt);
-	ip_id_offset_free(rfc3095_ctxt->inner_ip_id_offset_ctxt);
+	ip_id_offset_free(slab, rfc3095_ctxt->outer_ip_id_offset_ctxt);
+	ip_id_offset_free(slab, rfc3095_ctxt->inner_ip_id_offset_ctxt);
 
 	/* destroy the information about the IP headers */
-	zfree(rfc3095_ctxt->outer_ip_changes);
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	rohc_slab_zfree(slab, rfc3095_ctxt->outer_ip_changes);
+	rohc_slab_zfree(slab, rfc3095_ctxt->inner_ip_changes);
 
 	/* destroy contexts used to decompress the lists of IPv6 extension headers
 	 * for outer and inner IP headers */
@@ -500,10 +523,202 @@ void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_
 	rohc_decomp_list_ipv6_free(&rfc3095_ctxt->list_decomp2);
 
 	/* destroy profile-specific part */
-	zfree(rfc3095_ctxt->specific);
+	rohc_slab_zfree(slab, rfc3095_ctxt->specific);
 
 	/* destroy generic context itself */
-	free(rfc3095_ctxt);
+	rohc_slab_free(slab, rfc3095_ctxt);
+}
+
+
+/**
+ * @brief Write the generic part of the given context in a snapshot
+ *
+ * Every IP header is written with its version. An IPv4 header is followed by
+ * the state of its IP-ID, an IPv6 header by the state of the decompression
+ * of its list of extension headers.
+ *
+ * @param context   The decompression context to export
+ * @param snapshot  The snapshot to write to
+ * @return          \ref ROHC_STATUS_OK if the context was exported,
+ *                  \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the snapshot is too
+ *                  small,
+ *                  \ref ROHC_STATUS_ERROR if the context cannot be exported
+ */
+rohc_status_t rohc_decomp_rfc3095_export(const struct rohc_decomp_ctxt *const context,
+                                         struct rohc_buf *const snapshot)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const struct rohc_decomp_rfc3095_changes *ip_changes[2];
+	const struct ip_id_offset_decode *ip_id_offset_ctxts[2];
+	const struct list_decomp *list_decomps[2];
+	const size_t ip_hdr_nr = (rfc3095_ctxt->multiple_ip ? 2 : 1);
+	size_t i;
+
+	ip_changes[0] = rfc3095_ctxt->outer_ip_changes;
+	ip_changes[1] = rfc3095_ctxt->inner_ip_changes;
+	ip_id_offset_ctxts[0] = rfc3095_ctxt->outer_ip_id_offset_ctxt;
+	ip_id_offset_ctxts[1] = rfc3095_ctxt->inner_ip_id_offset_ctxt;
+	list_decomps[0] = &rfc3095_ctxt->list_decomp1;
+	list_decomps[1] = &rfc3095_ctxt->list_decomp2;
+	if(!rohc_lsb_is_ready(rfc3095_ctxt->sn_lsb_ctxt))
+	{
+		rohc_decomp_debug(context, "cannot export context that decompressed "
+		                  "no packet yet");
+		return ROHC_STATUS_ERROR;
+	}
+
+	if(!rohc_snapshot_put8(snapshot, ip_hdr_nr))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	for(i = 0; i < ip_hdr_nr; i++)
+	{
+		const struct ip_packet *const ip = &ip_changes[i]->ip;
+
+		if(!rohc_snapshot_put8(snapshot, ip_get_version(ip)))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+		if(ip_get_version(ip) == IPV4)
+		{
+			if(!rohc_snapshot_put(snapshot, &ip->header.v4,
+			                      sizeof(struct ipv4_hdr)) ||
+			   !rohc_snapshot_put8(snapshot, ip_changes[i]->rnd) ||
+			   !rohc_snapshot_put8(snapshot, ip_changes[i]->nbo) ||
+			   !rohc_snapshot_put8(snapshot, ip_changes[i]->sid) ||
+			   !ip_id_offset_export(ip_id_offset_ctxts[i], snapshot))
+			{
+				return ROHC_STATUS_OUTPUT_TOO_SMALL;
+			}
+		}
+		else if(!rohc_snapshot_put(snapshot, &ip->header.v6,
+		                           sizeof(struct ipv6_hdr)) ||
+		        !rohc_decomp_list_export(list_decomps[i], snapshot))
+		{
+			return ROHC_STATUS_OUTPUT_TOO_SMALL;
+		}
+	}
+	if(!rohc_snapshot_put16(snapshot, rfc3095_ctxt->outer_ip_changes->next_header_len) ||
+	   (rfc3095_ctxt->outer_ip_changes->next_header_len > 0 &&
+	    !rohc_snapshot_put(snapshot, rfc3095_ctxt->outer_ip_changes->next_header,
+	                       rfc3095_ctxt->outer_ip_changes->next_header_len)) ||
+	   !rohc_lsb_export(rfc3095_ctxt->sn_lsb_ctxt, snapshot))
+	{
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Read the generic part of the given context from a snapshot
+ *
+ * @param context   The decompression context to restore
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool rohc_decomp_rfc3095_import(struct rohc_decomp_ctxt *const context,
+                                struct rohc_buf *const snapshot)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	struct rohc_decomp_rfc3095_changes *ip_changes[2];
+	struct ip_id_offset_decode *ip_id_offset_ctxts[2];
+	struct list_decomp *list_decomps[2];
+	uint16_t next_header_len;
+	uint8_t ip_hdr_nr;
+	size_t i;
+
+	ip_changes[0] = rfc3095_ctxt->outer_ip_changes;
+	ip_changes[1] = rfc3095_ctxt->inner_ip_changes;
+	ip_id_offset_ctxts[0] = rfc3095_ctxt->outer_ip_id_offset_ctxt;
+	ip_id_offset_ctxts[1] = rfc3095_ctxt->inner_ip_id_offset_ctxt;
+	list_decomps[0] = &rfc3095_ctxt->list_decomp1;
+	list_decomps[1] = &rfc3095_ctxt->list_decomp2;
+
+	if(!rohc_snapshot_get8(snapshot, &ip_hdr_nr) ||
+	   ip_hdr_nr < 1 || ip_hdr_nr > 2)
+	{
+		rohc_decomp_warn(context, "malformed number of IP headers in snapshot");
+		goto error;
+	}
+	rfc3095_ctxt->multiple_ip = (ip_hdr_nr > 1);
+	for(i = 0; i < ip_hdr_nr; i++)
+	{
+		struct ip_packet *const ip = &ip_changes[i]->ip;
+		uint8_t version;
+		uint8_t flags[3];
+		size_t j;
+
+		if(!rohc_snapshot_get8(snapshot, &version) ||
+		   (version != IPV4 && version != IPV6))
+		{
+			rohc_decomp_warn(context, "malformed IP version #%zu in snapshot",
+			                 i + 1);
+			goto error;
+		}
+		if(version == IPV6)
+		{
+			if(!rohc_snapshot_get(snapshot, &ip->header.v6,
+			                      sizeof(struct ipv6_hdr)) ||
+			   !rohc_decomp_list_import(list_decomps[i], snapshot))
+			{
+				rohc_decomp_warn(context, "malformed IPv6 header #%zu in "
+				                 "snapshot", i + 1);
+				goto error;
+			}
+			ip->version = IPV6;
+			ip->nl.proto = ip->header.v6.nh;
+			continue;
+		}
+
+		if(!rohc_snapshot_get(snapshot, &ip->header.v4, sizeof(struct ipv4_hdr)))
+		{
+			rohc_decomp_warn(context, "malformed IP header #%zu in snapshot", i + 1);
+			goto error;
+		}
+		for(j = 0; j < 3; j++)
+		{
+			if(!rohc_snapshot_get8(snapshot, &flags[j]) || flags[j] > 1)
+			{
+				rohc_decomp_warn(context, "malformed IP-ID behavior for IP "
+				                 "header #%zu in snapshot", i + 1);
+				goto error;
+			}
+		}
+		if(!ip_id_offset_import(ip_id_offset_ctxts[i], snapshot))
+		{
+			rohc_decomp_warn(context, "malformed IP-ID offset for IP header #%zu "
+			                 "in snapshot", i + 1);
+			goto error;
+		}
+		ip->version = IPV4;
+		ip->nl.proto = ip->header.v4.protocol;
+		ip_changes[i]->rnd = flags[0];
+		ip_changes[i]->nbo = flags[1];
+		ip_changes[i]->sid = flags[2];
+	}
+
+	if(!rohc_snapshot_get16(snapshot, &next_header_len) ||
+	   next_header_len != rfc3095_ctxt->outer_ip_changes->next_header_len ||
+	   (next_header_len > 0 &&
+	    !rohc_snapshot_get(snapshot, rfc3095_ctxt->outer_ip_changes->next_header,
+	                       next_header_len)))
+	{
+		rohc_decomp_warn(context, "malformed next header in snapshot");
+		goto error;
+	}
+	if(!rohc_lsb_import(rfc3095_ctxt->sn_lsb_ctxt, snapshot))
+	{
+		rohc_decomp_warn(context, "malformed SN in snapshot");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -1330,6 +1545,7 @@ static int parse_dynamic_part_ipv6(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 	rohc_decomp_debug(context, "IPv6 extensions list = %d bytes", size_ext);
+	bits->is_ext_list_present = !!(size_ext > 1);
 #ifndef __clang_analyzer__ /* silent warning about dead increment */
 	packet += size_ext;
 #endif
@@ -5100,8 +5316,9 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 
 		assert(extr_crc->bits_nr > 0);
 
-		crc_ok = check_uncomp_crc(decomp, context, outer_ip_hdr, inner_ip_hdr,
-		                          next_header, extr_crc->type, extr_crc->bits);
+		crc_ok = check_uncomp_crc(context, outer_ip_hdr, inner_ip_hdr,
+		                          next_header, extr_crc->type, extr_crc->bits,
+		                          decoded->crc_static_changed);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -5111,8 +5328,7 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 			                 rohc_get_mode_descr(context->mode));
 			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
-				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
-				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+				rohc_dump_buf(decomp, ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
 				              "uncompressed headers", outer_ip_hdr, *uncomp_hdrs_len);
 			}
 			goto error_crc;
@@ -5313,31 +5529,31 @@ error:
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
- * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
- *       if the CRC-STATIC fields did not change.
+ * The CRC on the CRC-STATIC fields is retrieved from the cache of the
+ * context if the CRC-STATIC fields did not change.
  *
- * @param decomp        The ROHC decompressor
- * @param context       The decompression context
- * @param outer_ip_hdr  The outer IP header
- * @param inner_ip_hdr  The inner IP header if it exists, NULL otherwise
- * @param next_header   The transport header, eg. UDP
- * @param crc_type      The type of CRC
- * @param crc_packet    The CRC extracted from the ROHC header
- * @return              true if the CRC is correct, false otherwise
+ * @param context             The decompression context
+ * @param outer_ip_hdr        The outer IP header
+ * @param inner_ip_hdr        The inner IP header if it exists, NULL otherwise
+ * @param next_header         The transport header, eg. UDP
+ * @param crc_type            The type of CRC
+ * @param crc_packet          The CRC extracted from the ROHC header
+ * @param crc_static_changed  Whether one of the CRC-STATIC fields differs
+ *                            from the context
+ * @return                    true if the CRC is correct, false otherwise
  */
-static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
-                             const struct rohc_decomp_ctxt *const context,
+static bool check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
                              const uint8_t *const outer_ip_hdr,
                              const uint8_t *const inner_ip_hdr,
                              const uint8_t *const next_header,
                              const rohc_crc_type_t crc_type,
-                             const uint8_t crc_packet)
+                             const uint8_t crc_packet,
+                             const bool crc_static_changed)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
-	const uint8_t *crc_table;
+	uint8_t crc_init;
 	uint8_t crc_computed;
 
-	assert(decomp != NULL);
 	assert(context != NULL);
 	assert(context->persist_ctxt != NULL);
 	rfc3095_ctxt = context->persist_ctxt;
@@ -5345,20 +5561,17 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
 	assert(next_header != NULL);
 	assert(crc_type != ROHC_CRC_TYPE_NONE);
 
-	/* determine the initial value and the pre-computed table for the CRC */
+	/* determine the initial value for the CRC */
 	switch(crc_type)
 	{
 		case ROHC_CRC_TYPE_3:
-			crc_computed = CRC_INIT_3;
-			crc_table = decomp->crc_table_3;
+			crc_init = CRC_INIT_3;
 			break;
 		case ROHC_CRC_TYPE_7:
-			crc_computed = CRC_INIT_7;
-			crc_table = decomp->crc_table_7;
+			crc_init = CRC_INIT_7;
 			break;
 		case ROHC_CRC_TYPE_8:
-			crc_computed = CRC_INIT_8;
-			crc_table = decomp->crc_table_8;
+			crc_init = CRC_INIT_8;
 			break;
 		case ROHC_CRC_TYPE_NONE:
 		default:
@@ -5367,13 +5580,27 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
 			goto error;
 	}
 
-	/* compute the CRC from built uncompressed headers */
-	crc_computed = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
-	                                                next_header, crc_type,
-	                                                crc_computed, crc_table);
+	/* compute the CRC from built uncompressed headers: the CRC-STATIC fields
+	 * seldom change, so their CRC is retrieved from the cache of the context
+	 * most of the time */
+	if(crc_static_changed)
+	{
+		crc_computed =
+			rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
+			                                 next_header, crc_type, crc_init);
+	}
+	else if(!crc_static_cache_get(&rfc3095_ctxt->crc_static_cache, crc_type,
+	                              crc_init, &crc_computed))
+	{
+		crc_computed =
+			rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
+			                                 next_header, crc_type, crc_init);
+		crc_static_cache_set(&rfc3095_ctxt->crc_static_cache, crc_type,
+		                     crc_init, crc_computed);
+	}
 	crc_computed = rfc3095_ctxt->compute_crc_dynamic(outer_ip_hdr, inner_ip_hdr,
 	                                                 next_header, crc_type,
-	                                                 crc_computed, crc_table);
+	                                                 crc_computed);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_type, crc_computed);
 
@@ -5693,6 +5920,16 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 		}
 	}
 
+	/* did the CRC-STATIC fields of the IP headers change? those of the next
+	 * header are checked by the profile */
+	decoded->crc_static_changed =
+		!!(decoded->multiple_ip != rfc3095_ctxt->multiple_ip ||
+		   is_ip_crc_static_changed(rfc3095_ctxt->outer_ip_changes,
+		                            &bits->outer_ip, &decoded->outer_ip) ||
+		   (decoded->multiple_ip &&
+		    is_ip_crc_static_changed(rfc3095_ctxt->inner_ip_changes,
+		                             &bits->inner_ip, &decoded->inner_ip)));
+
 	/* decode fields of next header if required */
 	if(rfc3095_ctxt->decode_values_from_bits != NULL)
 	{
@@ -6089,6 +6326,53 @@ error:
 }
 
 
+/**
+ * @brief Check whether the CRC-STATIC fields of one IP header changed
+ *
+ * The decoded values are compared with the context. The addresses are
+ * compared only if they were transmitted, and the IPv6 extension headers are
+ * considered as changed whenever their list was transmitted.
+ *
+ * @param ctxt     The decompression context for the IP header
+ * @param bits     The IP bits extracted from ROHC header
+ * @param decoded  The decoded IP values
+ * @return         true if one of the CRC-STATIC fields changed,
+ *                 false otherwise
+ */
+static bool is_ip_crc_static_changed(const struct rohc_decomp_rfc3095_changes *const ctxt,
+                                     const struct rohc_extr_ip_bits *const bits,
+                                     const struct rohc_decoded_ip_values *const decoded)
+{
+	const struct ip_packet *const ip = &ctxt->ip;
+
+	if(ip_get_version(ip) != decoded->version ||
+	   bits->is_ext_list_present ||
+	   ip_get_tos(ip) != decoded->tos ||
+	   ip_get_ttl(ip) != decoded->ttl ||
+	   ip_get_protocol(ip) != decoded->proto)
+	{
+		return true;
+	}
+
+	if(decoded->version == IPV4)
+	{
+		return (ipv4_get_df(ip) != decoded->df ||
+		        (bits->saddr_nr > 0 &&
+		         memcmp(&ip->header.v4.saddr, decoded->saddr, 4) != 0) ||
+		        (bits->daddr_nr > 0 &&
+		         memcmp(&ip->header.v4.daddr, decoded->daddr, 4) != 0));
+	}
+	else
+	{
+		return (ip_get_flow_label(ip) != decoded->flowid ||
+		        (bits->saddr_nr > 0 &&
+		         memcmp(&ip->header.v6.saddr, decoded->saddr, 16) != 0) ||
+		        (bits->daddr_nr > 0 &&
+		         memcmp(&ip->header.v6.daddr, decoded->daddr, 16) != 0));
+	}
+}
+
+
 /**
  * @brief Update context with decoded values
  *
@@ -6115,6 +6399,12 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
 	bool keep_ref_minus_1; /* for action upon CRC failure */
 
+	/* the CRC computed on the former CRC-STATIC fields is useless now */
+	if(decoded->crc_static_changed)
+	{
+		crc_static_cache_reset(&rfc3095_ctxt->crc_static_cache);
+	}
+
 	/* action upon CRC failure: in case of incorrect SN updates, ref-1 shall not
 	 * be replaced by ref0 in the LSB context */
 	if(context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_UPDATES &&
@@ -100,6 +100,9 @@ struct rohc_extr_ip_bits
 	uint8_t daddr[16];   /**< The destination address bits found in static
 	                          chain of IR header */
 	size_t daddr_nr;     /**< The number of source address bits */
+
+	bool is_ext_list_present; /**< Whether the IPv6 extension header list was
+	                               found in dynamic chain of IR/IR-DYN header */
 };
 
 
@@ -297,6 +300,9 @@ struct rohc_decoded_values
 	/* bits below are for ESP profile only
 	   @todo TODO should be moved in d_esp.c */
 	uint32_t esp_spi;       /**< The decoded ESP SPI */
+
+	/** Whether one of the CRC-STATIC fields differs from the context */
+	bool crc_static_changed;
 };
 
 
@@ -424,16 +430,17 @@ struct rohc_decomp_rfc3095_ctxt
 	                              const uint8_t *const ip2,
 	                              const uint8_t *const next_header,
 	                              const rohc_crc_type_t crc_type,
-	                              const uint8_t init_val,
-	                              const uint8_t *const crc_table);
+	                              const uint8_t init_val);
 
 	/// @brief The handler used to compute the CRC-DYNAMIC value
 	uint8_t (*compute_crc_dynamic)(const uint8_t *const ip,
 	                               const uint8_t *const ip2,
 	                               const uint8_t *const next_header,
 	                               const rohc_crc_type_t crc_type,
-	                               const uint8_t init_val,
-	                               const uint8_t *const crc_table);
+	                               const uint8_t init_val);
+
+	/** The CRCs computed on the CRC-STATIC fields of the context */
+	struct crc_static_cache crc_static_cache;
 
 	/** The handler used to update context with decoded next header fields */
 	void (*update_context)(struct rohc_decomp_ctxt *const context,
@@ -445,6 +452,24 @@ struct rohc_decomp_rfc3095_ctxt
 };
 
 
+/**
+ * @brief The sizes of the objects allocated by \ref rohc_decomp_rfc3095_create
+ *
+ * The RFC3095-based profiles list them at the beginning of their
+ * rohc_decomp_profile::ctxt_objs_sizes, before their own objects.
+ */
+#define ROHC_DECOMP_RFC3095_CTXT_OBJS_SIZES \
+	sizeof(struct rohc_decomp_rfc3095_ctxt), \
+	sizeof(struct ip_id_offset_decode), \
+	sizeof(struct rohc_lsb_decode), \
+	sizeof(struct ip_id_offset_decode), \
+	sizeof(struct rohc_lsb_decode), \
+	sizeof(struct rohc_decomp_rfc3095_changes), \
+	sizeof(struct rohc_decomp_rfc3095_changes), \
+	sizeof(struct rohc_extr_bits), \
+	sizeof(struct rohc_decoded_values)
+
+
 /*
  * Public function prototypes.
  */
@@ -457,9 +482,18 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
                                 const int profile_id)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+void rohc_decomp_rfc3095_destroy(const struct rohc_decomp_ctxt *const context,
+                                 struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                  const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
+
+rohc_status_t rohc_decomp_rfc3095_export(const struct rohc_decomp_ctxt *const context,
+                                         struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_decomp_rfc3095_import(struct rohc_decomp_ctxt *const context,
+                                struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_buf rohc_packet,
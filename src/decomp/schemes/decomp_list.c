@@ -26,6 +26,7 @@
 #include "schemes/decomp_list.h"
 
 #include "rohc_bit_ops.h"
+#include "rohc_snapshot.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -406,6 +407,102 @@ error:
 }
 
 
+/**
+ * @brief Write the state of the given list decompressor in a snapshot
+ *
+ * The translation table is written first, then the lists that were already
+ * received, then the list of the last packet.
+ *
+ * @param decomp    The list decompressor
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool rohc_decomp_list_export(const struct list_decomp *const decomp,
+                             struct rohc_buf *const snapshot)
+{
+	size_t lists_nr;
+	size_t i;
+
+	if(!rohc_list_trans_table_export(decomp->trans_table, snapshot))
+	{
+		return false;
+	}
+
+	lists_nr = 0;
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		if(rohc_list_is_gen_id_known(decomp, i))
+		{
+			lists_nr++;
+		}
+	}
+	if(!rohc_snapshot_put16(snapshot, lists_nr))
+	{
+		return false;
+	}
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		if(!rohc_list_is_gen_id_known(decomp, i))
+		{
+			continue;
+		}
+		if(!rohc_snapshot_put8(snapshot, i) ||
+		   !rohc_list_export(&decomp->lists[i], decomp->trans_table, snapshot))
+		{
+			return false;
+		}
+	}
+
+	return (rohc_snapshot_put16(snapshot, decomp->pkt_list.id) &&
+	        rohc_list_export(&decomp->pkt_list, decomp->trans_table, snapshot));
+}
+
+
+/**
+ * @brief Read the state of the given list decompressor from a snapshot
+ *
+ * @param decomp    The list decompressor, freshly created
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool rohc_decomp_list_import(struct list_decomp *const decomp,
+                             struct rohc_buf *const snapshot)
+{
+	uint16_t lists_nr;
+	uint16_t pkt_list_id;
+	size_t i;
+
+	if(!rohc_list_trans_table_import(decomp->trans_table, snapshot) ||
+	   !rohc_snapshot_get16(snapshot, &lists_nr) ||
+	   lists_nr > (ROHC_LIST_GEN_ID_MAX + 1))
+	{
+		return false;
+	}
+	for(i = 0; i < lists_nr; i++)
+	{
+		uint8_t gen_id;
+
+		if(!rohc_snapshot_get8(snapshot, &gen_id) ||
+		   !rohc_list_import(&decomp->lists[gen_id], decomp->trans_table,
+		                     snapshot) ||
+		   decomp->lists[gen_id].counter == 0)
+		{
+			return false;
+		}
+	}
+
+	if(!rohc_snapshot_get16(snapshot, &pkt_list_id) ||
+	   pkt_list_id > ROHC_LIST_GEN_ID_NONE ||
+	   !rohc_list_import(&decomp->pkt_list, decomp->trans_table, snapshot))
+	{
+		return false;
+	}
+	decomp->pkt_list.id = pkt_list_id;
+
+	return true;
+}
+
+
 /**
  * @brief Decode an extension list type 0
  *
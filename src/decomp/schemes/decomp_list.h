@@ -90,6 +90,8 @@ struct list_decomp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
 	/** The profile ID the decompression list was created for */
 	int profile_id;
 };
@@ -113,5 +115,12 @@ bool rohc_decomp_list_create_item(struct list_decomp *const decomp,
                                   size_t *const item_length)
 	__attribute__((warn_unused_result, nonnull(1, 4, 6)));
 
+bool rohc_decomp_list_export(const struct list_decomp *const decomp,
+                             struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool rohc_decomp_list_import(struct list_decomp *const decomp,
+                             struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
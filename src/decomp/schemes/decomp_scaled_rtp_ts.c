@@ -29,6 +29,7 @@
 #include "decomp_scaled_rtp_ts.h"
 #include "decomp_wlsb.h"
 #include "rohc_traces_internal.h"
+#include "rohc_snapshot.h"
 
 #include <assert.h>
 
@@ -39,60 +40,6 @@
 	           format, ##__VA_ARGS__)
 
 
-/*
- * Structure and types
- */
-
-/**
- * @brief The scaled RTP Timestamp decoding context
- *
- * See section 4.5.3 of RFC 3095 for details about Scaled RTP Timestamp
- * decoding.
- */
-struct ts_sc_decomp
-{
-	/// The last computed or received TS_STRIDE value (validated by CRC)
-	uint32_t ts_stride;
-
-	/// The last computed or received TS_SCALED value (validated by CRC)
-	uint32_t ts_scaled;
-	/// The LSB-encoded TS_SCALED value
-	struct rohc_lsb_decode *lsb_ts_scaled;
-
-	/// The last computed or received TS_OFFSET value (validated by CRC)
-	uint32_t ts_offset;
-
-	/** The last timestamp (TS) value */
-	uint32_t ts;
-	/** The LSB-encoded unscaled timestamp (TS) value */
-	struct rohc_lsb_decode *lsb_ts_unscaled;
-	/// The previous timestamp value
-	uint32_t old_ts;
-
-	/// The sequence number (SN)
-	uint16_t sn;
-	/// The previous sequence number
-	uint16_t old_sn;
-
-
-	/* the attributes below are new TS_* values computed by not yet validated
-	   by CRC check */
-
-	/// The last computed or received TS_STRIDE value (not validated by CRC)
-	uint32_t new_ts_stride;
-	/// The last computed or received TS_SCALED value (not validated by CRC)
-	uint32_t new_ts_scaled;
-	/// The last computed or received TS_OFFSET value (not validated by CRC)
-	uint32_t new_ts_offset;
-
-	/** The callback function used to manage traces */
-	rohc_trace_callback2_t trace_callback;
-	/** The private context of the callback function used to manage traces */
-	void *trace_callback_priv;
-};
-
-
-
 /*
  * Public functions
  */
@@ -100,17 +47,21 @@ struct ts_sc_decomp
 /**
  * @brief Create the scaled RTP Timestamp decoding context
  *
- * @param trace_cb       The trace callback
- * @param trace_cb_priv  An optional private context for the trace
+ * @param slab             The slab to allocate the decoding context from
+ * @param trace_cb         The trace callback
+ * @param trace_cb_priv    An optional private context for the trace
+ * @param trace_min_level  The minimum level of the traces to print
  * @return               The scaled RTP Timestamp decoding context in case of
  *                       success, NULL otherwise
  */
-struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
-                                  void *const trace_cb_priv)
+struct ts_sc_decomp * d_create_sc(struct rohc_slab *const slab,
+                                  rohc_trace_callback2_t trace_cb,
+                                  void *const trace_cb_priv,
+                                  const rohc_trace_level_t trace_min_level)
 {
 	struct ts_sc_decomp *ts_sc;
 
-	ts_sc = malloc(sizeof(struct ts_sc_decomp));
+	ts_sc = rohc_slab_malloc(slab, sizeof(struct ts_sc_decomp));
 	if(ts_sc == NULL)
 	{
 		goto error;
@@ -129,13 +80,13 @@ struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
 	ts_sc->new_ts_scaled = 0;
 	ts_sc->new_ts_offset = 0;
 
-	ts_sc->lsb_ts_scaled = rohc_lsb_new(32);
+	ts_sc->lsb_ts_scaled = rohc_lsb_new(slab, 32);
 	if(ts_sc->lsb_ts_scaled == NULL)
 	{
 		goto free_context;
 	}
 
-	ts_sc->lsb_ts_unscaled = rohc_lsb_new(32);
+	ts_sc->lsb_ts_unscaled = rohc_lsb_new(slab, 32);
 	if(ts_sc->lsb_ts_unscaled == NULL)
 	{
 		goto free_lsb_ts_scaled;
@@ -143,13 +94,14 @@ struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
 
 	ts_sc->trace_callback = trace_cb;
 	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_min_level = trace_min_level;
 
 	return ts_sc;
 
 free_lsb_ts_scaled:
-	rohc_lsb_free(ts_sc->lsb_ts_scaled);
+	rohc_lsb_free(slab, ts_sc->lsb_ts_scaled);
 free_context:
-	free(ts_sc);
+	rohc_slab_free(slab, ts_sc);
 error:
 	return NULL;
 }
@@ -158,13 +110,15 @@ error:
 /**
  * @brief Destroy the given ts_sc_decomp object
  *
+ * @param slab   The slab the ts_sc_decomp object was allocated from
  * @param ts_sc  The ts_sc_decomp object to destroy
  */
-void rohc_ts_scaled_free(struct ts_sc_decomp *const ts_sc)
+void rohc_ts_scaled_free(struct rohc_slab *const slab,
+                         struct ts_sc_decomp *const ts_sc)
 {
-	rohc_lsb_free(ts_sc->lsb_ts_unscaled);
-	rohc_lsb_free(ts_sc->lsb_ts_scaled);
-	free(ts_sc);
+	rohc_lsb_free(slab, ts_sc->lsb_ts_unscaled);
+	rohc_lsb_free(slab, ts_sc->lsb_ts_scaled);
+	rohc_slab_free(slab, ts_sc);
 }
 
 
@@ -457,3 +411,53 @@ uint32_t ts_deduce_from_sn(struct ts_sc_decomp *const ts_sc,
 	return new_ts;
 }
 
+
+/**
+ * @brief Write the state of the scaled RTP Timestamp decoding in a snapshot
+ *
+ * @param ts_sc     The ts_sc_decomp object
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool d_ts_sc_export(const struct ts_sc_decomp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+{
+	return (rohc_snapshot_put32(snapshot, ts_sc->ts_stride) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->ts_scaled) &&
+	        rohc_lsb_export(ts_sc->lsb_ts_scaled, snapshot) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->ts_offset) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->ts) &&
+	        rohc_lsb_export(ts_sc->lsb_ts_unscaled, snapshot) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->old_ts) &&
+	        rohc_snapshot_put16(snapshot, ts_sc->sn) &&
+	        rohc_snapshot_put16(snapshot, ts_sc->old_sn) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->new_ts_stride) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->new_ts_scaled) &&
+	        rohc_snapshot_put32(snapshot, ts_sc->new_ts_offset));
+}
+
+
+/**
+ * @brief Read the state of the scaled RTP Timestamp decoding from a snapshot
+ *
+ * @param ts_sc     The ts_sc_decomp object
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool d_ts_sc_import(struct ts_sc_decomp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+{
+	return (rohc_snapshot_get32(snapshot, &ts_sc->ts_stride) &&
+	        rohc_snapshot_get32(snapshot, &ts_sc->ts_scaled) &&
+	        rohc_lsb_import(ts_sc->lsb_ts_scaled, snapshot) &&
+	        rohc_snapshot_get32(snapshot, &ts_sc->ts_offset) &&
+	        rohc_snapshot_get32(snapshot, &ts_sc->ts) &&
+	        rohc_lsb_import(ts_sc->lsb_ts_unscaled, snapshot) &&
+	        rohc_snapshot_get32(snapshot, &ts_sc->old_ts) &&
+	        rohc_snapshot_get16(snapshot, &ts_sc->sn) &&
+	        rohc_snapshot_get16(snapshot, &ts_sc->old_sn) &&
+	        rohc_snapshot_get32(snapshot, &ts_sc->new_ts_stride) &&
+	        rohc_snapshot_get32(snapshot, &ts_sc->new_ts_scaled) &&
+	        rohc_snapshot_get32(snapshot, &ts_sc->new_ts_offset));
+}
+
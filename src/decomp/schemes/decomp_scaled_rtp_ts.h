@@ -30,6 +30,9 @@
 #define ROHC_DECOMP_SCHEMES_SCALED_RTP_TS_H
 
 #include "rohc_traces.h"
+#include "rohc_buf.h"
+#include "rohc_slab.h"
+#include "decomp_wlsb.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -40,19 +43,69 @@
 #endif
 
 
-/* The definition of the scaled RTP Timestamp decoding context is private */
-struct ts_sc_decomp;
+/**
+ * @brief The scaled RTP Timestamp decoding context
+ *
+ * See section 4.5.3 of RFC 3095 for details about Scaled RTP Timestamp
+ * decoding.
+ */
+struct ts_sc_decomp
+{
+	/// The last computed or received TS_STRIDE value (validated by CRC)
+	uint32_t ts_stride;
+
+	/// The last computed or received TS_SCALED value (validated by CRC)
+	uint32_t ts_scaled;
+	/// The LSB-encoded TS_SCALED value
+	struct rohc_lsb_decode *lsb_ts_scaled;
+
+	/// The last computed or received TS_OFFSET value (validated by CRC)
+	uint32_t ts_offset;
+
+	/** The last timestamp (TS) value */
+	uint32_t ts;
+	/** The LSB-encoded unscaled timestamp (TS) value */
+	struct rohc_lsb_decode *lsb_ts_unscaled;
+	/// The previous timestamp value
+	uint32_t old_ts;
+
+	/// The sequence number (SN)
+	uint16_t sn;
+	/// The previous sequence number
+	uint16_t old_sn;
+
+
+	/* the attributes below are new TS_* values computed by not yet validated
+	   by CRC check */
+
+	/// The last computed or received TS_STRIDE value (not validated by CRC)
+	uint32_t new_ts_stride;
+	/// The last computed or received TS_SCALED value (not validated by CRC)
+	uint32_t new_ts_scaled;
+	/// The last computed or received TS_OFFSET value (not validated by CRC)
+	uint32_t new_ts_offset;
+
+	/** The callback function used to manage traces */
+	rohc_trace_callback2_t trace_callback;
+	/** The private context of the callback function used to manage traces */
+	void *trace_callback_priv;
+	/** The minimum level of the traces given to the callback function */
+	rohc_trace_level_t trace_min_level;
+};
 
 
 /*
  * Function prototypes
  */
 
-struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
-                                  void *const trace_cb_priv)
-	__attribute__((warn_unused_result));
-void rohc_ts_scaled_free(struct ts_sc_decomp *const ts_scaled)
-	__attribute__((nonnull(1)));
+struct ts_sc_decomp * d_create_sc(struct rohc_slab *const slab,
+                                  rohc_trace_callback2_t trace_cb,
+                                  void *const trace_cb_priv,
+                                  const rohc_trace_level_t trace_min_level)
+	__attribute__((warn_unused_result, nonnull(1)));
+void rohc_ts_scaled_free(struct rohc_slab *const slab,
+                         struct ts_sc_decomp *const ts_scaled)
+	__attribute__((nonnull(1, 2)));
 
 void ts_update_context(struct ts_sc_decomp *const ts_sc,
                        const uint32_t ts,
@@ -77,5 +130,12 @@ uint32_t ts_deduce_from_sn(struct ts_sc_decomp *const ts_sc,
                            const uint16_t sn)
 	__attribute__((warn_unused_result));
 
+bool d_ts_sc_export(const struct ts_sc_decomp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool d_ts_sc_import(struct ts_sc_decomp *const ts_sc,
+                    struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
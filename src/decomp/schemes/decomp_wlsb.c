@@ -26,6 +26,7 @@
 
 #include "decomp_wlsb.h"
 #include "interval.h" /* for the rohc_f_32bits() function */
+#include "rohc_snapshot.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -33,25 +34,6 @@
 #include <assert.h>
 
 
-/*
- * Private structures and types
- */
-
-/**
- * @brief The Least Significant Bits (LSB) decoding object
- *
- * See RFC 3095, §4.5.1
- */
-struct rohc_lsb_decode
-{
-	bool is_init;         /**< Whether the reference value was initialized */
-	size_t max_len;       /**< The max length (in bits) of the uncomp. field */
-
-	/** The reference values (ref -1 and ref 0) */
-	uint32_t v_ref_d[ROHC_LSB_REF_MAX];
-};
-
-
 /*
  * Private functions
  */
@@ -93,17 +75,19 @@ static bool rohc_lsb_decode8(const struct rohc_lsb_decode *const lsb,
  *
  * See 4.5.1 in the RFC 3095 for details about LSB encoding.
  *
+ * @param slab     The slab to allocate the LSB decoding context from
  * @param max_len  The max length (in bits) of the non-compressed field
  * @return         The new LSB decoding context in case of success, NULL
  *                 otherwise
  */
-struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
+struct rohc_lsb_decode * rohc_lsb_new(struct rohc_slab *const slab,
+                                      const size_t max_len)
 {
 	struct rohc_lsb_decode *lsb;
 
 	assert(max_len == 8 || max_len == 16 || max_len == 32);
 
-	lsb = malloc(sizeof(struct rohc_lsb_decode));
+	lsb = rohc_slab_malloc(slab, sizeof(struct rohc_lsb_decode));
 	if(lsb != NULL)
 	{
 		lsb->max_len = max_len;
@@ -119,11 +103,13 @@ struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
  *
  * See 4.5.1 in the RFC 3095 for details about LSB encoding.
  *
- * @param lsb  The LSB decoding context to destroy
+ * @param slab  The slab the LSB decoding context was allocated from
+ * @param lsb   The LSB decoding context to destroy
  */
-void rohc_lsb_free(struct rohc_lsb_decode *const lsb)
+void rohc_lsb_free(struct rohc_slab *const slab,
+                   struct rohc_lsb_decode *const lsb)
 {
-	free(lsb);
+	rohc_slab_free(slab, lsb);
 }
 
 
@@ -437,3 +423,46 @@ uint32_t rohc_lsb_get_ref(const struct rohc_lsb_decode *const lsb,
 	return lsb->v_ref_d[ref_type];
 }
 
+
+/**
+ * @brief Write the reference values of a LSB decoding object in a snapshot
+ *
+ * @param lsb       The LSB object
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool rohc_lsb_export(const struct rohc_lsb_decode *const lsb,
+                     struct rohc_buf *const snapshot)
+{
+	return (rohc_snapshot_put8(snapshot, lsb->is_init) &&
+	        rohc_snapshot_put32(snapshot, lsb->v_ref_d[ROHC_LSB_REF_MINUS_1]) &&
+	        rohc_snapshot_put32(snapshot, lsb->v_ref_d[ROHC_LSB_REF_0]));
+}
+
+
+/**
+ * @brief Read the reference values of a LSB decoding object from a snapshot
+ *
+ * @param lsb       The LSB object
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool rohc_lsb_import(struct rohc_lsb_decode *const lsb,
+                     struct rohc_buf *const snapshot)
+{
+	uint8_t is_init;
+	uint32_t v_ref_d[ROHC_LSB_REF_MAX];
+
+	if(!rohc_snapshot_get8(snapshot, &is_init) || is_init > 1 ||
+	   !rohc_snapshot_get32(snapshot, &v_ref_d[ROHC_LSB_REF_MINUS_1]) ||
+	   !rohc_snapshot_get32(snapshot, &v_ref_d[ROHC_LSB_REF_0]))
+	{
+		return false;
+	}
+	lsb->is_init = !!is_init;
+	lsb->v_ref_d[ROHC_LSB_REF_MINUS_1] = v_ref_d[ROHC_LSB_REF_MINUS_1];
+	lsb->v_ref_d[ROHC_LSB_REF_0] = v_ref_d[ROHC_LSB_REF_0];
+
+	return true;
+}
+
@@ -28,6 +28,8 @@
 #define ROHC_DECOMP_SCHEMES_WLSB_H
 
 #include "interval.h" /* for rohc_lsb_shift_t */
+#include "rohc_buf.h"
+#include "rohc_slab.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -39,10 +41,6 @@
 #endif
 
 
-/* The definition of the Least Significant Bits decoding object is private */
-struct rohc_lsb_decode;
-
-
 /** The different reference values for LSB decoding */
 typedef enum
 {
@@ -53,6 +51,21 @@ typedef enum
 } rohc_lsb_ref_t;
 
 
+/**
+ * @brief The Least Significant Bits (LSB) decoding object
+ *
+ * See RFC 3095, §4.5.1
+ */
+struct rohc_lsb_decode
+{
+	bool is_init;         /**< Whether the reference value was initialized */
+	size_t max_len;       /**< The max length (in bits) of the uncomp. field */
+
+	/** The reference values (ref -1 and ref 0) */
+	uint32_t v_ref_d[ROHC_LSB_REF_MAX];
+};
+
+
 /** The context to parse and decode one LSB-encoded 32-bit field */
 struct rohc_lsb_field32
 {
@@ -84,11 +97,13 @@ struct rohc_lsb_field8
  * Function prototypes
  */
 
-struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
-	__attribute__((warn_unused_result));
+struct rohc_lsb_decode * rohc_lsb_new(struct rohc_slab *const slab,
+                                      const size_t max_len)
+	__attribute__((warn_unused_result, nonnull(1)));
 
-void rohc_lsb_free(struct rohc_lsb_decode *const lsb)
-	__attribute__((nonnull(1)));
+void rohc_lsb_free(struct rohc_slab *const slab,
+                   struct rohc_lsb_decode *const lsb)
+	__attribute__((nonnull(1, 2)));
 
 bool rohc_lsb_is_ready(const struct rohc_lsb_decode *const lsb)
 	__attribute__((warn_unused_result, nonnull(1), pure));
@@ -111,5 +126,13 @@ uint32_t rohc_lsb_get_ref(const struct rohc_lsb_decode *const lsb,
                           const rohc_lsb_ref_t ref_type)
 	__attribute__((nonnull(1), warn_unused_result));
 
+bool rohc_lsb_export(const struct rohc_lsb_decode *const lsb,
+                     struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_lsb_import(struct rohc_lsb_decode *const lsb,
+                     struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
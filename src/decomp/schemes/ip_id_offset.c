@@ -30,21 +30,6 @@
 #include <assert.h>
 
 
-/*
- * Private structures
- */
-
-/**
- * @brief Defines a IP-ID object to help computing the IP-ID value
- *        from an IP-ID offset
- */
-struct ip_id_offset_decode
-{
-	/** The LSB context for decoding IP-ID offset */
-	struct rohc_lsb_decode *lsb;
-};
-
-
 /*
  * Public functions
  */
@@ -55,20 +40,21 @@ struct ip_id_offset_decode
  *
  * See 4.5.5 in the RFC 3095 for details about Offset IP-ID encoding.
  *
- * @return  The new Offset IP-ID decoding context in case of success,
- *          NULL otherwise
+ * @param slab  The slab to allocate the decoding context from
+ * @return      The new Offset IP-ID decoding context in case of success,
+ *              NULL otherwise
  */
-struct ip_id_offset_decode * ip_id_offset_new(void)
+struct ip_id_offset_decode * ip_id_offset_new(struct rohc_slab *const slab)
 {
 	struct ip_id_offset_decode *ipid;
 
-	ipid = malloc(sizeof(struct ip_id_offset_decode));
+	ipid = rohc_slab_malloc(slab, sizeof(struct ip_id_offset_decode));
 	if(ipid == NULL)
 	{
 		goto error;
 	}
 
-	ipid->lsb = rohc_lsb_new(16);
+	ipid->lsb = rohc_lsb_new(slab, 16);
 	if(ipid->lsb == NULL)
 	{
 		goto destroy_ipid;
@@ -77,7 +63,7 @@ struct ip_id_offset_decode * ip_id_offset_new(void)
 	return ipid;
 
 destroy_ipid:
-	free(ipid);
+	rohc_slab_free(slab, ipid);
 error:
 	return NULL;
 }
@@ -88,12 +74,14 @@ error:
  *
  * See 4.5.5 in the RFC 3095 for details about Offset IP-ID encoding.
  *
+ * @param slab  The slab the decoding context was allocated from
  * @param ipid  The Offset IP-ID decoding context to destroy
  */
-void ip_id_offset_free(struct ip_id_offset_decode *const ipid)
+void ip_id_offset_free(struct rohc_slab *const slab,
+                       struct ip_id_offset_decode *const ipid)
 {
-	rohc_lsb_free(ipid->lsb);
-	free(ipid);
+	rohc_lsb_free(slab, ipid->lsb);
+	rohc_slab_free(slab, ipid);
 }
 
 
@@ -154,3 +142,31 @@ void ip_id_offset_set_ref(struct ip_id_offset_decode *const ipid,
 	rohc_lsb_set_ref(ipid->lsb, offset_ref, keep_ref_minus_1);
 }
 
+
+/**
+ * @brief Write the reference values of an Offset IP-ID object in a snapshot
+ *
+ * @param ipid      The Offset IP-ID decoding object
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool ip_id_offset_export(const struct ip_id_offset_decode *const ipid,
+                         struct rohc_buf *const snapshot)
+{
+	return rohc_lsb_export(ipid->lsb, snapshot);
+}
+
+
+/**
+ * @brief Read the reference values of an Offset IP-ID object from a snapshot
+ *
+ * @param ipid      The Offset IP-ID decoding object
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool ip_id_offset_import(struct ip_id_offset_decode *const ipid,
+                         struct rohc_buf *const snapshot)
+{
+	return rohc_lsb_import(ipid->lsb, snapshot);
+}
+
@@ -38,18 +38,27 @@
 #endif
 
 
-/* The definition of the Offset IP-ID decoding object is private */
-struct ip_id_offset_decode;
+/**
+ * @brief Defines a IP-ID object to help computing the IP-ID value
+ *        from an IP-ID offset
+ */
+struct ip_id_offset_decode
+{
+	/** The LSB context for decoding IP-ID offset */
+	struct rohc_lsb_decode *lsb;
+};
 
 
 /*
  * Function prototypes.
  */
 
-struct ip_id_offset_decode * ip_id_offset_new(void);
+struct ip_id_offset_decode * ip_id_offset_new(struct rohc_slab *const slab)
+	__attribute__((warn_unused_result, nonnull(1)));
 
-void ip_id_offset_free(struct ip_id_offset_decode *const ipid)
-	__attribute__((nonnull(1)));
+void ip_id_offset_free(struct rohc_slab *const slab,
+                       struct ip_id_offset_decode *const ipid)
+	__attribute__((nonnull(1, 2)));
 
 bool ip_id_offset_decode(const struct ip_id_offset_decode *const ipid,
                          const rohc_lsb_ref_t ref_type,
@@ -65,5 +74,13 @@ void ip_id_offset_set_ref(struct ip_id_offset_decode *const ipid,
                           const bool keep_ref_minus_1)
 	__attribute__((nonnull(1)));
 
+bool ip_id_offset_export(const struct ip_id_offset_decode *const ipid,
+                         struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool ip_id_offset_import(struct ip_id_offset_decode *const ipid,
+                         struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
@@ -28,6 +28,7 @@
 
 #include "tcp_sack.h"
 
+#include "rohc_snapshot.h"
 #include "rohc_utils.h"
 
 static int d_tcp_sack_block(const struct rohc_decomp_ctxt *const context,
@@ -116,6 +117,71 @@ error:
 }
 
 
+/**
+ * @brief Write the SACK blocks in a snapshot
+ *
+ * @param sack      The SACK blocks to write
+ * @param snapshot  The snapshot to write to
+ * @return          true if successful, false if the snapshot is too small
+ */
+bool d_tcp_sack_export(const struct d_tcp_opt_sack *const sack,
+                       struct rohc_buf *const snapshot)
+{
+	size_t i;
+
+	if(!rohc_snapshot_put8(snapshot, sack->blocks_nr))
+	{
+		return false;
+	}
+	for(i = 0; i < sack->blocks_nr; i++)
+	{
+		if(!rohc_snapshot_put32(snapshot, sack->blocks[i].block_start) ||
+		   !rohc_snapshot_put32(snapshot, sack->blocks[i].block_end))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Read the SACK blocks from a snapshot
+ *
+ * @param sack      The SACK blocks to read
+ * @param snapshot  The snapshot to read from
+ * @return          true if successful, false if the snapshot is malformed
+ */
+bool d_tcp_sack_import(struct d_tcp_opt_sack *const sack,
+                       struct rohc_buf *const snapshot)
+{
+	uint8_t blocks_nr;
+	size_t i;
+
+	if(!rohc_snapshot_get8(snapshot, &blocks_nr) ||
+	   blocks_nr > TCP_SACK_BLOCKS_MAX_NR)
+	{
+		return false;
+	}
+	for(i = 0; i < blocks_nr; i++)
+	{
+		uint32_t block_start;
+		uint32_t block_end;
+
+		if(!rohc_snapshot_get32(snapshot, &block_start) ||
+		   !rohc_snapshot_get32(snapshot, &block_end))
+		{
+			return false;
+		}
+		sack->blocks[i].block_start = block_start;
+		sack->blocks[i].block_end = block_end;
+	}
+	sack->blocks_nr = blocks_nr;
+
+	return true;
+}
+
 /**
  * @brief Parse a SACK block of the TCP SACK option
  *
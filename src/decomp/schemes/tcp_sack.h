@@ -47,5 +47,13 @@ int d_tcp_sack_parse(const struct rohc_decomp_ctxt *const context,
                      struct d_tcp_opt_sack *const opt_sack)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
+bool d_tcp_sack_export(const struct d_tcp_opt_sack *const sack,
+                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool d_tcp_sack_import(struct d_tcp_opt_sack *const sack,
+                       struct rohc_buf *const snapshot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif /* ROHC_DECOMP_SCHEMES_TCP_SACK_H */
 
@@ -58,24 +58,27 @@ struct rohc_interval32 __wrap_rohc_f_32bits(const uint32_t v_ref,
 static void test_lsb_new(void **state)
 {
 	struct rohc_lsb_decode *lsb;
+	struct rohc_slab slab;
+
+	rohc_slab_init(&slab);
 
 	/* 32-bit LSB */
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(&slab, 32);
 	assert_true(lsb != NULL);
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 
 	/* 16-bit LSB */
-	lsb = rohc_lsb_new(16);
+	lsb = rohc_lsb_new(&slab, 16);
 	assert_true(lsb != NULL);
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 
 	/* 8-bit LSB */
-	lsb = rohc_lsb_new(8);
+	lsb = rohc_lsb_new(&slab, 8);
 	assert_true(lsb != NULL);
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 
 #if 0 /* TODO: enable this when all assert() of the library are replaced */
-	lsb = rohc_lsb_new(0);
+	lsb = rohc_lsb_new(&slab, 0);
 	assert_true(lsb == NULL);
 #endif
 }
@@ -127,9 +130,11 @@ static void test_lsb_decode(void **state)
 		{ false,         0x0,         0x0,         0x0,  0,       false,         0x0 },
 	};
 	struct rohc_lsb_decode *lsb;
+	struct rohc_slab slab;
 	size_t test_num;
 
-	lsb = rohc_lsb_new(32);
+	rohc_slab_init(&slab);
+	lsb = rohc_lsb_new(&slab, 32);
 	assert_true(lsb != NULL);
 
 	rohc_lsb_set_ref(lsb, 0, false);
@@ -159,7 +164,7 @@ static void test_lsb_decode(void **state)
 		printf("\n");
 	}
 
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 }
 
 
@@ -111,6 +111,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == true);
 	}
 
+	/* rohc_decomp_set_traces_min_level() */
+	CHECK(rohc_decomp_set_traces_min_level(NULL, ROHC_TRACE_DEBUG) == false);
+	CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_ERROR) == true);
+	CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_decomp_profile_enabled() */
 	CHECK(rohc_decomp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_GENERAL) == false);
@@ -308,6 +314,38 @@ int main(int argc, char *argv[])
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_malformed) == ROHC_STATUS_ERROR);
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_full) == ROHC_STATUS_ERROR);
 		}
+
+		/* rohc_decompress_burst() with the same packets */
+		{
+			uint8_t buf_malformed[100];
+			struct rohc_buf pkt_malformed = rohc_buf_init_full(buf_malformed, 0, ts);
+			struct rohc_buf in[3] = { pkt, pkt_malformed, pkt };
+			uint8_t out_buf[3][100];
+			struct rohc_buf out[3] =
+			{
+				rohc_buf_init_empty(out_buf[0], 100),
+				rohc_buf_init_empty(out_buf[1], 100),
+				rohc_buf_init_empty(out_buf[2], 100),
+			};
+			rohc_status_t st[3];
+			uint8_t buf_fb[100];
+			struct rohc_buf fb = rohc_buf_init_empty(buf_fb, 100);
+			CHECK(rohc_decompress_burst(NULL, in, out, st, 3, NULL, NULL) == 0);
+			CHECK(st[0] == ROHC_STATUS_ERROR && st[2] == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_burst(decomp, NULL, out, st, 3, NULL, NULL) == 0);
+			CHECK(rohc_decompress_burst(decomp, in, NULL, st, 3, NULL, NULL) == 0);
+			CHECK(rohc_decompress_burst(decomp, in, out, NULL, 3, NULL, NULL) == 0);
+			CHECK(rohc_decompress_burst(decomp, in, out, st, 3, &pkt_malformed, NULL) == 0);
+			CHECK(rohc_decompress_burst(decomp, in, out, st, 3, NULL, &pkt_malformed) == 0);
+			CHECK(rohc_decompress_burst(decomp, in, out, st, 0, NULL, NULL) == 0);
+			CHECK(rohc_decompress_burst(decomp, in, out, st, 3, NULL, &fb) == 2);
+			CHECK(st[0] == ROHC_STATUS_OK);
+			CHECK(st[1] == ROHC_STATUS_ERROR);
+			CHECK(st[2] == ROHC_STATUS_OK);
+			CHECK(out[0].len > 0 && out[0].len == out[2].len);
+			CHECK(out[1].len == 0);
+			CHECK(fb.offset == 0);
+		}
 	}
 
 	/* rohc_decomp_get_last_packet_info() */
@@ -342,6 +380,10 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
 		info.version_minor = 1;
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		info.version_minor = 2;
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.ctxts_mem_reserved == 0);
+		CHECK(info.ctxts_mem_peak == 0);
 	}
 
 	/* rohc_decomp_get_state_descr() */
@@ -354,12 +396,274 @@ int main(int argc, char *argv[])
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == false);
+		CHECK(rohc_decomp_set_traces_min_level(decomp, ROHC_TRACE_WARNING) == false);
 	}
 
 	/* rohc_decomp_free() */
 	rohc_decomp_free(NULL);
 	rohc_decomp_free(decomp);
 
+	/* rohc_decomp_set_features() with preallocated contexts */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir_buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		const struct rohc_buf ir_pkt =
+			rohc_buf_init_full(ir_buf, sizeof(ir_buf), ts);
+		uint8_t ip_buf[100];
+		struct rohc_buf ip_pkt = rohc_buf_init_empty(ip_buf, 100);
+		rohc_decomp_general_info_t info;
+
+		decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp != NULL);
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CTXT_SLAB) == true);
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CTXT_SLAB) == true);
+		CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_IP) == true);
+
+		memset(&info, 0, sizeof(rohc_decomp_general_info_t));
+		info.version_minor = 2;
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.ctxts_mem_reserved > 0);
+		CHECK(info.ctxts_mem_peak == 0);
+
+		/* the same IR packet twice: the context is re-created */
+		CHECK(rohc_decompress3(decomp, ir_pkt, &ip_pkt, NULL, NULL) == ROHC_STATUS_OK);
+		rohc_buf_reset(&ip_pkt);
+		CHECK(rohc_decompress3(decomp, ir_pkt, &ip_pkt, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.contexts_nr == 1);
+		CHECK(info.ctxts_mem_peak > 0);
+		CHECK(info.ctxts_mem_peak <= info.ctxts_mem_reserved);
+
+		/* preallocation cannot be changed while contexts are in use */
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == false);
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CTXT_SLAB) == true);
+
+		rohc_decomp_free(decomp);
+	}
+
+	/* rohc_decomp_get_stats_snapshot() and rohc_decomp_get_ctxt_stats_snapshot() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir_buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		const struct rohc_buf ir_pkt =
+			rohc_buf_init_full(ir_buf, sizeof(ir_buf), ts);
+		uint8_t ip_buf[100];
+		struct rohc_buf ip_pkt = rohc_buf_init_empty(ip_buf, 100);
+		rohc_decomp_stats_snapshot_t stats;
+
+		decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_IP) == true);
+
+		/* detailed statistics are disabled by default */
+		memset(&stats, 0, sizeof(rohc_decomp_stats_snapshot_t));
+		CHECK(rohc_decomp_get_stats_snapshot(NULL, &stats) == false);
+		CHECK(rohc_decomp_get_stats_snapshot(decomp, NULL) == false);
+		CHECK(rohc_decomp_get_stats_snapshot(decomp, &stats) == false);
+		CHECK(rohc_decomp_get_ctxt_stats_snapshot(NULL, 0, &stats) == false);
+		CHECK(rohc_decomp_get_ctxt_stats_snapshot(decomp, 0, NULL) == false);
+		CHECK(rohc_decomp_get_ctxt_stats_snapshot(decomp, 0, &stats) == false);
+
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_STATS) == true);
+		stats.version_major = 0xffff;
+		CHECK(rohc_decomp_get_stats_snapshot(decomp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 0xffff;
+		CHECK(rohc_decomp_get_stats_snapshot(decomp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_decomp_get_stats_snapshot(decomp, &stats) == true);
+		CHECK(stats.packets_nr == 0);
+		CHECK(rohc_decomp_get_ctxt_stats_snapshot(decomp, ROHC_SMALL_CID_MAX + 1,
+		                                          &stats) == false);
+
+		CHECK(rohc_decompress3(decomp, ir_pkt, &ip_pkt, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decomp_get_stats_snapshot(decomp, &stats) == true);
+		CHECK(stats.packets_nr == 1);
+		CHECK(stats.packet_types[ROHC_PACKET_IR] == 1);
+		CHECK(stats.contexts_per_state[ROHC_DECOMP_STATE_FC] == 1);
+		CHECK(stats.transitions[ROHC_DECOMP_STATE_UNKNOWN][ROHC_DECOMP_STATE_NC] == 1);
+		CHECK(stats.transitions[ROHC_DECOMP_STATE_NC][ROHC_DECOMP_STATE_FC] == 1);
+		CHECK(rohc_decomp_get_ctxt_stats_snapshot(decomp, 0, &stats) == true);
+		CHECK(stats.profile_id == ROHC_PROFILE_IP);
+		CHECK(stats.packets_nr == 1);
+		CHECK(rohc_decomp_get_ctxt_stats_snapshot(decomp, 1, &stats) == true);
+		CHECK(stats.profile_id == ROHC_PROFILE_GENERAL);
+		CHECK(stats.packets_nr == 0);
+
+		/* statistics are released once disabled */
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
+		CHECK(rohc_decomp_get_stats_snapshot(decomp, &stats) == false);
+
+		rohc_decomp_free(decomp);
+	}
+
+	/* rohc_decomp_export_contexts() and rohc_decomp_import_contexts() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir_buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		const struct rohc_buf ir_pkt =
+			rohc_buf_init_full(ir_buf, sizeof(ir_buf), ts);
+		uint8_t uo0_buf[2 + 64];
+		struct rohc_buf uo0_pkt = rohc_buf_init_full(uo0_buf, sizeof(uo0_buf), ts);
+		uint8_t ip_buf[100];
+		struct rohc_buf ip_pkt = rohc_buf_init_empty(ip_buf, 100);
+		uint8_t ip_buf2[100];
+		struct rohc_buf ip_pkt2 = rohc_buf_init_empty(ip_buf2, 100);
+		uint8_t snapshot_buf[500];
+		struct rohc_buf snapshot = rohc_buf_init_empty(snapshot_buf, 500);
+		struct rohc_buf small_snapshot = rohc_buf_init_empty(snapshot_buf, 20);
+		struct rohc_decomp *decomp2;
+
+		/* UO-0 packet with SN = 2 and the same ICMP payload as the IR packet */
+		uo0_buf[0] = 0x11;
+		uo0_buf[1] = 0x00;
+		memcpy(uo0_buf + 2, ir_buf + 22, 64);
+
+		decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_IP) == true);
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_decompress3(decomp, ir_pkt, &ip_pkt, NULL, NULL) == ROHC_STATUS_OK);
+
+		/* rohc_decomp_export_contexts() */
+		CHECK(rohc_decomp_export_contexts(NULL, &snapshot) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decomp_export_contexts(decomp, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decomp_export_contexts(decomp, &small_snapshot) ==
+		      ROHC_STATUS_OUTPUT_TOO_SMALL);
+		CHECK(small_snapshot.len == 0);
+		CHECK(rohc_decomp_export_contexts(decomp, &snapshot) == ROHC_STATUS_OK);
+		CHECK(snapshot.len > 13);
+
+		/* rohc_decomp_import_contexts() */
+		CHECK(rohc_decomp_import_contexts(NULL, snapshot) == false);
+		CHECK(rohc_decomp_import_contexts(decomp, snapshot) == false);
+		snapshot.len--;
+		CHECK(rohc_decomp_import_contexts(decomp2, snapshot) == false);
+		snapshot.len++;
+		snapshot_buf[0] = 'X';
+		CHECK(rohc_decomp_import_contexts(decomp2, snapshot) == false);
+		snapshot_buf[0] = 'R';
+		CHECK(rohc_decomp_import_contexts(decomp2, snapshot) == true);
+		CHECK(rohc_decomp_import_contexts(decomp2, snapshot) == false);
+
+		/* the imported context decompresses the next packet as the original */
+		rohc_buf_reset(&ip_pkt);
+		CHECK(rohc_decompress3(decomp, uo0_pkt, &ip_pkt, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decompress3(decomp2, uo0_pkt, &ip_pkt2, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(ip_pkt2.len == ip_pkt.len);
+		CHECK(memcmp(rohc_buf_data(ip_pkt2), rohc_buf_data(ip_pkt),
+		             ip_pkt.len) == 0);
+
+		rohc_decomp_free(decomp2);
+		rohc_decomp_free(decomp);
+	}
+
+	/* rohc_decompress_inplace() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir_buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		const struct rohc_buf ir_pkt =
+			rohc_buf_init_full(ir_buf, sizeof(ir_buf), ts);
+		const size_t headroom = 128;
+		uint8_t inplace_buf[128 + sizeof(ir_buf)];
+		struct rohc_buf inplace_pkt =
+			rohc_buf_init_full(inplace_buf, sizeof(inplace_buf), ts);
+		uint8_t ip_buf[100];
+		struct rohc_buf ip_pkt = rohc_buf_init_empty(ip_buf, 100);
+		struct rohc_decomp *decomp2;
+
+		decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_IP) == true);
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_decompress3(decomp, ir_pkt, &ip_pkt, NULL, NULL) == ROHC_STATUS_OK);
+
+		CHECK(rohc_decompress_inplace(NULL, &inplace_pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_inplace(decomp2, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+
+		/* the headroom shall be large enough for the uncompressed headers */
+		memcpy(inplace_buf, ir_buf, sizeof(ir_buf));
+		inplace_pkt.len = sizeof(ir_buf);
+		CHECK(rohc_decompress_inplace(decomp2, &inplace_pkt, NULL, NULL) ==
+		      ROHC_STATUS_OUTPUT_TOO_SMALL);
+		memcpy(inplace_buf + 10, ir_buf, sizeof(ir_buf));
+		inplace_pkt.offset = 10;
+		inplace_pkt.len = sizeof(ir_buf);
+		CHECK(rohc_decompress_inplace(decomp2, &inplace_pkt, NULL, NULL) ==
+		      ROHC_STATUS_OUTPUT_TOO_SMALL);
+
+		/* the payload stays in place, the headers are written before it */
+		memcpy(inplace_buf + headroom, ir_buf, sizeof(ir_buf));
+		inplace_pkt.max_len = sizeof(inplace_buf);
+		inplace_pkt.offset = headroom;
+		inplace_pkt.len = sizeof(ir_buf);
+		CHECK(rohc_decompress_inplace(decomp2, &inplace_pkt, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(inplace_pkt.len == ip_pkt.len);
+		CHECK(inplace_pkt.offset + inplace_pkt.len == sizeof(inplace_buf));
+		CHECK(memcmp(rohc_buf_data(inplace_pkt), rohc_buf_data(ip_pkt),
+		             ip_pkt.len) == 0);
+
+		rohc_decomp_free(decomp2);
+		rohc_decomp_free(decomp);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -40,6 +40,11 @@
 #define ROHC_INIT_TS_STRIDE_MIN  3U
 
 
+/** The slab the encoding/decoding objects are allocated from, left empty so
+ *  that they are allocated with malloc() */
+static struct rohc_slab slab;
+
+
 /** Print trace on stdout only in verbose mode */
 #define trace(is_verbose, format, ...) \
 	do { \
@@ -143,7 +148,8 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	uint64_t i;
 
 	/* create the RTP TS encoding context */
-	ret = c_create_sc(&ts_sc_comp, ROHC_WLSB_WINDOW_WIDTH, NULL, NULL);
+	ret = c_create_sc(&ts_sc_comp, &slab, ROHC_WLSB_WINDOW_WIDTH, NULL, NULL,
+	                  ROHC_TRACE_DEBUG);
 	if(ret != 1)
 	{
 		fprintf(stderr, "failed to initialize the RTP TS encoding context\n");
@@ -151,7 +157,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	}
 
 	/* create the RTP TS decoding context */
-	ts_sc_decomp = d_create_sc(NULL, NULL);
+	ts_sc_decomp = d_create_sc(&slab, NULL, NULL, ROHC_TRACE_DEBUG);
 	if(ts_sc_decomp == NULL)
 	{
 		fprintf(stderr, "failed to initialize the RTP TS decoding context\n");
@@ -332,9 +338,9 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	is_success = true;
 
 destroy_ts_sc_decomp:
-	rohc_ts_scaled_free(ts_sc_decomp);
+	rohc_ts_scaled_free(&slab, ts_sc_decomp);
 destroy_ts_sc_comp:
-	c_destroy_sc(&ts_sc_comp);
+	c_destroy_sc(&ts_sc_comp, &slab);
 error:
 	return is_success;
 }
@@ -35,6 +35,11 @@
 #define ROHC_WLSB_WINDOW_WIDTH  4U
 
 
+/** The slab the encoding/decoding objects are allocated from, left empty so
+ *  that they are allocated with malloc() */
+static struct rohc_slab slab;
+
+
 /** Print trace on stdout only in verbose mode */
 #define trace(is_verbose, format, ...) \
 	do { \
@@ -195,7 +200,7 @@ static bool run_test8_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(8, win_size, p);
+	wlsb = c_create_wlsb(&slab, 8, win_size, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -205,7 +210,7 @@ static bool run_test8_with_shift_param(bool be_verbose,
 	/* init the LSB decoding context with value 0 */
 	value8 = 0;
 	trace(be_verbose, "\tinitialize with 8 bits of value 0x%02x ...\n", value8);
-	lsb = rohc_lsb_new(8);
+	lsb = rohc_lsb_new(&slab, 8);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -309,9 +314,9 @@ static bool run_test8_with_shift_param(bool be_verbose,
 	is_success = true;
 
 destroy_lsb:
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 destroy_wlsb:
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 error:
 	return is_success;
 }
@@ -345,7 +350,7 @@ static bool run_test16_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(16, win_size, p);
+	wlsb = c_create_wlsb(&slab, 16, win_size, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -355,7 +360,7 @@ static bool run_test16_with_shift_param(bool be_verbose,
 	/* init the LSB decoding context with value 0 */
 	value16 = 0;
 	trace(be_verbose, "\tinitialize with 16 bits of value 0x%04x ...\n", value16);
-	lsb = rohc_lsb_new(16);
+	lsb = rohc_lsb_new(&slab, 16);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -459,9 +464,9 @@ static bool run_test16_with_shift_param(bool be_verbose,
 	is_success = true;
 
 destroy_lsb:
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 destroy_wlsb:
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 error:
 	return is_success;
 }
@@ -495,7 +500,7 @@ static bool run_test32_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(32, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(&slab, 32, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -505,7 +510,7 @@ static bool run_test32_with_shift_param(bool be_verbose,
 	/* init the LSB decoding context with value 0 */
 	value32 = 0;
 	trace(be_verbose, "\tinitialize with 32 bits of value 0x%08x ...\n", value32);
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(&slab, 32);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -605,9 +610,9 @@ static bool run_test32_with_shift_param(bool be_verbose,
 	is_success = true;
 
 destroy_lsb:
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 destroy_wlsb:
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 error:
 	return is_success;
 }
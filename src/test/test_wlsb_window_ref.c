@@ -0,0 +1,400 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_wlsb_window_ref.c
+ * @brief   Test W-LSB encoding against a reference that scans the window
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The W-LSB encoding may determine the number of bits from the window
+ * references without scanning the whole window. The test checks that the
+ * number of bits is always the one that the g function gives for the worst
+ * reference of the window, whatever the window contents, the acknowledgements,
+ * the value to encode and the shift parameter.
+ */
+
+#include "schemes/comp_wlsb.h"
+#include "interval.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** The largest width of the W-LSB sliding window */
+#define WLSB_WINDOW_MAX_WIDTH  256U
+
+/** The number of W-LSB windows to test */
+#define WLSB_WINDOWS_NR  300U
+
+/** The number of operations on every W-LSB window */
+#define WLSB_OPS_NR  300U
+
+
+/** The slab the encoding/decoding objects are allocated from, left empty so
+ *  that they are allocated with malloc() */
+static struct rohc_slab slab;
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+
+/** A copy of the W-LSB window kept by the test */
+struct ref_window
+{
+	size_t width;                          /**< The width of the window */
+	size_t count;                          /**< The number of entries */
+	uint32_t sns[WLSB_WINDOW_MAX_WIDTH];   /**< The SN of the entries */
+	uint32_t values[WLSB_WINDOW_MAX_WIDTH];/**< The values of the entries */
+};
+
+
+static bool run_test_window(const size_t bits,
+                            const size_t window_width,
+                            const uint32_t max_step,
+                            const bool be_verbose)
+	__attribute__((warn_unused_result));
+
+static size_t ref_get_k(const struct ref_window *const ref,
+                        const uint32_t value,
+                        const size_t bits,
+                        const size_t min_k,
+                        const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static uint32_t rand32(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test W-LSB encoding against a reference that scans the window
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test W-LSB encoding against a reference that scans the window\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* same values for every run */
+	srand(42);
+
+	for(i = 0; i < WLSB_WINDOWS_NR; i++)
+	{
+		const size_t fields_bits[] = { 8, 16, 32 };
+		const size_t bits = fields_bits[i % 3];
+		const uint32_t mask = (bits == 32 ? 0xffffffff : ((1U << bits) - 1));
+		const size_t window_width = 1U << (rand() % 9);
+		uint32_t max_step;
+
+		/* values that slowly increase, values that increase by larger steps,
+		 * and values that are totally random */
+		switch(rand() % 4)
+		{
+			case 0:
+				max_step = 3;
+				break;
+			case 1:
+				max_step = 200;
+				break;
+			case 2:
+				max_step = (mask >> 3);
+				break;
+			default:
+				max_step = mask;
+				break;
+		}
+
+		trace(verbose, "test %zu-bit field with %zu-entry window and steps up to "
+		      "%u\n", bits, window_width, max_step);
+		if(!run_test_window(bits, window_width, max_step, verbose))
+		{
+			fprintf(stderr, "test %zu-bit field with %zu-entry window and steps "
+			        "up to %u failed\n", bits, window_width, max_step);
+			goto error;
+		}
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run the test with one W-LSB window
+ *
+ * @param bits          The length (in bits) of the field
+ * @param window_width  The width of the W-LSB window
+ * @param max_step      The largest step between two consecutive values
+ * @param be_verbose    Whether to print traces or not
+ * @return              true if test succeeds, false otherwise
+ */
+static bool run_test_window(const size_t bits,
+                            const size_t window_width,
+                            const uint32_t max_step,
+                            const bool be_verbose)
+{
+	const rohc_lsb_shift_t p_params[] = {
+		ROHC_LSB_SHIFT_SN,
+		ROHC_LSB_SHIFT_IP_ID,
+		ROHC_LSB_SHIFT_TCP_TTL,
+		ROHC_LSB_SHIFT_TCP_SN,
+		ROHC_LSB_SHIFT_TCP_SEQ_SCALED,
+		ROHC_LSB_SHIFT_RTP_TS,
+		ROHC_LSB_SHIFT_RTP_SN,
+		ROHC_LSB_SHIFT_ESP_SN,
+		ROHC_LSB_SHIFT_TCP_WINDOW,
+		ROHC_LSB_SHIFT_TCP_TS_3B,
+		ROHC_LSB_SHIFT_TCP_TS_4B,
+	};
+	const size_t p_nums = sizeof(p_params) / sizeof(p_params[0]);
+	const uint32_t mask = (bits == 32 ? 0xffffffff : ((1U << bits) - 1));
+	struct c_wlsb *wlsb;
+	struct ref_window ref;
+	uint32_t value;
+	uint32_t sn;
+	bool is_success = false;
+	size_t op;
+
+	assert(window_width <= WLSB_WINDOW_MAX_WIDTH);
+
+	wlsb = c_create_wlsb(&slab, bits, window_width, ROHC_LSB_SHIFT_VAR);
+	if(wlsb == NULL)
+	{
+		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
+		goto error;
+	}
+	ref.width = window_width;
+	ref.count = 0;
+
+	value = rand32() & mask;
+	sn = rand32();
+
+	for(op = 0; op < WLSB_OPS_NR; op++)
+	{
+		size_t q;
+
+		if((rand() % 10) == 0 && ref.count > 0)
+		{
+			/* acknowledge one entry of the window, it removes the older ones */
+			const size_t acked_entry = rand() % ref.count;
+			size_t acked_nr;
+
+			trace(be_verbose, "\tacknowledge SN %u\n", ref.sns[acked_entry]);
+			acked_nr = wlsb_ack(wlsb, ref.sns[acked_entry], 32);
+			if(acked_nr != acked_entry)
+			{
+				fprintf(stderr, "%zu entries acked while %zu expected\n",
+				        acked_nr, acked_entry);
+				goto destroy_wlsb;
+			}
+			ref.count -= acked_entry;
+			memmove(ref.sns, ref.sns + acked_entry, ref.count * sizeof(uint32_t));
+			memmove(ref.values, ref.values + acked_entry,
+			        ref.count * sizeof(uint32_t));
+		}
+		else
+		{
+			/* add one value in the window, go backward from time to time */
+			if(max_step == 0xffffffff)
+			{
+				value = (value + rand32()) & mask;
+			}
+			else
+			{
+				value = (value + rand32() % (max_step + 1)) & mask;
+			}
+			if((rand() % 20) == 0)
+			{
+				value = (value - rand() % 50) & mask;
+			}
+			sn++;
+			trace(be_verbose, "\tadd value 0x%08x with SN %u\n", value, sn);
+			c_add_wlsb(wlsb, sn, value);
+
+			if(ref.count == ref.width)
+			{
+				ref.count--;
+				memmove(ref.sns, ref.sns + 1, ref.count * sizeof(uint32_t));
+				memmove(ref.values, ref.values + 1, ref.count * sizeof(uint32_t));
+			}
+			ref.sns[ref.count] = sn;
+			ref.values[ref.count] = value;
+			ref.count++;
+		}
+
+		/* encode values around the window and random values */
+		for(q = 0; q < 8; q++)
+		{
+			const rohc_lsb_shift_t p = p_params[rand() % p_nums];
+			size_t min_k = 0;
+			size_t expected_k;
+			size_t k;
+			uint32_t v;
+
+			switch(rand() % 4)
+			{
+				case 0:
+					v = rand32() & mask;
+					break;
+				case 1:
+					v = (value + rand() % 300) & mask;
+					break;
+				case 2:
+					v = (ref.values[0] - rand() % 40 + rand() % 40) & mask;
+					break;
+				default:
+					v = (value - rand() % 300) & mask;
+					break;
+			}
+
+			if(bits == 8)
+			{
+				k = wlsb_get_kp_8bits(wlsb, v, p);
+			}
+			else
+			{
+				if((rand() % 3) == 0)
+				{
+					min_k = rand() % bits;
+				}
+				if(bits == 16)
+				{
+					k = wlsb_get_minkp_16bits(wlsb, v, min_k, p);
+				}
+				else
+				{
+					k = wlsb_get_minkp_32bits(wlsb, v, min_k, p);
+				}
+			}
+
+			expected_k = ref_get_k(&ref, v, bits, min_k, p);
+			if(k != expected_k)
+			{
+				fprintf(stderr, "value 0x%08x with p = %d and min_k = %zu is "
+				        "encoded on %zu bits while %zu bits are expected\n", v, p,
+				        min_k, k, expected_k);
+				goto destroy_wlsb;
+			}
+		}
+	}
+
+	is_success = true;
+
+destroy_wlsb:
+	c_destroy_wlsb(&slab, wlsb);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Get the number of bits required by the worst reference of the window
+ *
+ * @param ref    The copy of the window kept by the test
+ * @param value  The value to encode
+ * @param bits   The length (in bits) of the field
+ * @param min_k  The minimum number of bits to find out
+ * @param p      The shift parameter
+ * @return       The number of bits required to encode the value
+ */
+static size_t ref_get_k(const struct ref_window *const ref,
+                        const uint32_t value,
+                        const size_t bits,
+                        const size_t min_k,
+                        const rohc_lsb_shift_t p)
+{
+	const uint32_t mask = (bits == 32 ? 0xffffffff : ((1U << bits) - 1));
+	size_t max_k;
+	size_t i;
+
+	if(ref->count == 0)
+	{
+		return bits;
+	}
+
+	max_k = 0;
+	for(i = 0; i < ref->count; i++)
+	{
+		size_t k;
+
+		for(k = min_k; k < bits; k++)
+		{
+			const struct rohc_interval32 interval =
+				rohc_f_32bits(ref->values[i], k, p);
+			const uint32_t interval_width = (interval.max - interval.min) & mask;
+
+			if(((value - interval.min) & mask) <= interval_width)
+			{
+				break;
+			}
+		}
+		if(k > max_k)
+		{
+			max_k = k;
+		}
+	}
+
+	return max_k;
+}
+
+
+/**
+ * @brief Get a 32-bit random value
+ *
+ * @return  The random value
+ */
+static uint32_t rand32(void)
+{
+	return ((((uint32_t) rand()) << 16) ^ ((uint32_t) rand()));
+}
+
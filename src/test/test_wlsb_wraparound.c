@@ -35,6 +35,11 @@
 #define ROHC_WLSB_WINDOW_WIDTH  4U
 
 
+/** The slab the encoding/decoding objects are allocated from, left empty so
+ *  that they are allocated with malloc() */
+static struct rohc_slab slab;
+
+
 /** Print trace on stdout only in verbose mode */
 #define trace(is_verbose, format, ...) \
 	do { \
@@ -200,7 +205,7 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 	uint32_t i;
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(8, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(&slab, 8, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -210,7 +215,7 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0 */
 	value8 = 0;
 	trace(be_verbose, "\tinitialize with 8 bits of value 0x%02x ...\n", value8);
-	lsb = rohc_lsb_new(8);
+	lsb = rohc_lsb_new(&slab, 8);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -242,9 +247,9 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 	is_success = true;
 
 destroy_lsb:
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 destroy_wlsb:
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 error:
 	return is_success;
 }
@@ -269,7 +274,7 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 	uint32_t i;
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(16, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(&slab, 16, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -279,7 +284,7 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0 */
 	value16 = 0;
 	trace(be_verbose, "\tinitialize with 16 bits of value 0x%04x ...\n", value16);
-	lsb = rohc_lsb_new(16);
+	lsb = rohc_lsb_new(&slab, 16);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -312,9 +317,9 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 	is_success = true;
 
 destroy_lsb:
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 destroy_wlsb:
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 error:
 	return is_success;
 }
@@ -339,7 +344,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	uint64_t i;
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(32, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(&slab, 32, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -349,7 +354,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0 */
 	value32 = 0;
 	trace(be_verbose, "\tinitialize with 32 bits of value 0x%08x ...\n", value32);
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(&slab, 32);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -378,12 +383,12 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	}
 
 	/* destroy the LSB decoding context */
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 	/* destroy the W-LSB encoding context */
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 
 	/* create the W-LSB encoding context again */
-	wlsb = c_create_wlsb(32, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(&slab, 32, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -393,7 +398,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0xffffffff - 100 - 3 */
 	value32 = 0xffffffff - 100 - 3;
 	trace(be_verbose, "\tinitialize with 32 bits of value 0x%08x ...\n", value32);
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(&slab, 32);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -423,12 +428,12 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	}
 
 	/* destroy the LSB decoding context */
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 	/* destroy the W-LSB encoding context */
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 
 	/* create the W-LSB encoding context again */
-	wlsb = c_create_wlsb(32, 64U, p);
+	wlsb = c_create_wlsb(&slab, 32, 64U, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -439,7 +444,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	value32 = 0xffffffff - 4500 - 1700;
 	trace(be_verbose, "\tinitialize with 32 bits of value 0x%08x ...\n",
 	      value32);
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(&slab, 32);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -483,9 +488,9 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	is_success = true;
 
 destroy_lsb:
-	rohc_lsb_free(lsb);
+	rohc_lsb_free(&slab, lsb);
 destroy_wlsb:
-	c_destroy_wlsb(wlsb);
+	c_destroy_wlsb(&slab, wlsb);
 error:
 	return is_success;
 }
@@ -0,0 +1,714 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_contexts_snapshot.c
+ * @brief  Check that contexts survive an export/import cycle
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses the IP packets from a source
+ * PCAP file with two pairs of compressor/decompressor. The first pair is the
+ * reference. The second pair exports its contexts after every packet, then
+ * it is replaced by a new pair that imports them. The second pair shall
+ * build the very same ROHC packets as the reference, ie. it shall not go
+ * back to IR packets, and all (de)compressions shall succeed.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <string.h>
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for ntohs() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for ntohs() on Linux */
+#endif
+#include <errno.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/ipv6.h>
+
+/* include for the PCAP library */
+#if HAVE_PCAP_PCAP_H == 1
+#  include <pcap/pcap.h>
+#elif HAVE_PCAP_H == 1
+#  include <pcap.h>
+#else
+#  error "pcap.h header not found, did you specified --enable-rohc-tests \
+for ./configure ? If yes, check configure output and config.log"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The maximum size of a snapshot of contexts */
+#define SNAPSHOT_MAX_SIZE  0xffffU
+
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_comp_and_decomp(const char *filename);
+static struct rohc_comp * create_comp(void)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * create_decomp(void)
+	__attribute__((warn_unused_result));
+static bool restart_comp_and_decomp(struct rohc_comp **const comp,
+                                    struct rohc_decomp **const decomp)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool compress_and_decompress(struct rohc_comp *const comp,
+                                    struct rohc_decomp *const decomp,
+                                    const struct rohc_buf ip_packet,
+                                    struct rohc_buf *const rohc_packet,
+                                    rohc_packet_t *const packet_type)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check that the contexts exported after every packet of the capture
+ *        may be imported to go on with the compression of the flows
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	char *filename = NULL;
+	int args_read;
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_read, argv += args_read)
+	{
+		if(!strcmp(*argv, "-h"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(filename == NULL)
+		{
+			/* get the name of the file that contains the packets to compress */
+			filename = argv[0];
+			args_read = 1;
+		}
+		else
+		{
+			/* do not accept more than one argument without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	/* the source filename is mandatory */
+	if(filename == NULL)
+	{
+		usage();
+		goto error;
+	}
+
+	/* test ROHC compression with the packets from the file */
+	status = test_comp_and_decomp(filename);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that contexts survive an export/import cycle\n"
+	        "\n"
+	        "usage: test_contexts_snapshot [OPTIONS] FLOW\n"
+	        "\n"
+	        "with:\n"
+	        "  FLOW         The flow of Ethernet frames to compress\n"
+	        "               (in PCAP format)\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Test the ROHC library with a flow of IP packets and contexts that
+ *        are exported and imported after every packet
+ *
+ * @param filename  The name of the PCAP file that contains the IP packets
+ * @return          0 in case of success,
+ *                  1 in case of failure
+ */
+static int test_comp_and_decomp(const char *filename)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	pcap_t *handle;
+	int link_layer_type;
+	size_t link_len;
+
+	struct rohc_comp *ref_comp;
+	struct rohc_decomp *ref_decomp;
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+
+	struct pcap_pkthdr header;
+	unsigned char *packet;
+	unsigned int counter;
+
+	int is_failure = 1;
+
+	/* open the source dump file */
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source dump must be Ethernet */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type != DLT_EN10MB &&
+	   link_layer_type != DLT_LINUX_SLL &&
+	   link_layer_type != DLT_RAW)
+	{
+		fprintf(stderr, "link layer type %d not supported in source dump "
+		        "(supported = %d, %d, %d)\n", link_layer_type,
+		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
+		goto close_input;
+	}
+
+	/* determine the length of the link layer header */
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else /* DLT_RAW */
+	{
+		link_len = 0;
+	}
+
+	/* create the reference pair of compressor/decompressor */
+	ref_comp = create_comp();
+	if(ref_comp == NULL)
+	{
+		goto close_input;
+	}
+	ref_decomp = create_decomp();
+	if(ref_decomp == NULL)
+	{
+		goto destroy_ref_comp;
+	}
+
+	/* create the pair of compressor/decompressor that is restarted after
+	 * every packet */
+	comp = create_comp();
+	if(comp == NULL)
+	{
+		goto destroy_ref_decomp;
+	}
+	decomp = create_decomp();
+	if(decomp == NULL)
+	{
+		goto destroy_comp;
+	}
+
+	/* for each packet in the dump */
+	counter = 0;
+	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	{
+		const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full(packet, header.caplen, arrival_time);
+		uint8_t ref_rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf ref_rohc_packet =
+			rohc_buf_init_empty(ref_rohc_buffer, MAX_ROHC_SIZE);
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		rohc_packet_t ref_packet_type;
+		rohc_packet_t packet_type;
+
+		counter++;
+
+		fprintf(stderr, "packet #%u:\n", counter);
+
+		/* check the length of the link layer header/frame */
+		if(header.len <= link_len || header.len != header.caplen)
+		{
+			fprintf(stderr, "\ttruncated packet in capture (len = %u, "
+			        "caplen = %u)\n", header.len, header.caplen);
+			goto destroy_decomp;
+		}
+
+		/* skip the link layer header */
+		rohc_buf_pull(&ip_packet, link_len);
+
+		/* check for padding after the IP packet in the Ethernet payload */
+		if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+		{
+			int version;
+			size_t tot_len;
+
+			version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
+			if(version == 4)
+			{
+				struct ipv4_hdr *ip = (struct ipv4_hdr *) rohc_buf_data(ip_packet);
+				tot_len = ntohs(ip->tot_len);
+			}
+			else
+			{
+				struct ipv6_hdr *ip = (struct ipv6_hdr *) rohc_buf_data(ip_packet);
+				tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+			}
+
+			if(tot_len < ip_packet.len)
+			{
+				fprintf(stderr, "the Ethernet frame has %zu bytes of padding "
+				        "after the %zu byte IP packet!\n",
+				        ip_packet.len - tot_len, tot_len);
+				ip_packet.len = tot_len;
+			}
+		}
+
+		/* (de)compress the packet with the reference pair */
+		if(!compress_and_decompress(ref_comp, ref_decomp, ip_packet,
+		                            &ref_rohc_packet, &ref_packet_type))
+		{
+			fprintf(stderr, "\treference compressor/decompressor failed\n");
+			goto destroy_decomp;
+		}
+
+		/* (de)compress the packet with the pair restarted from the snapshot */
+		if(!compress_and_decompress(comp, decomp, ip_packet, &rohc_packet,
+		                            &packet_type))
+		{
+			fprintf(stderr, "\trestarted compressor/decompressor failed\n");
+			goto destroy_decomp;
+		}
+
+		/* the restarted compressor shall not go back to IR packets */
+		if((packet_type == ROHC_PACKET_IR || packet_type == ROHC_PACKET_IR_DYN) &&
+		   packet_type != ref_packet_type)
+		{
+			fprintf(stderr, "\trestarted compressor sent an IR or IR-DYN packet "
+			        "while the reference compressor sent packet type %d\n",
+			        ref_packet_type);
+			goto destroy_decomp;
+		}
+		if(rohc_packet.len != ref_rohc_packet.len ||
+		   memcmp(rohc_buf_data(rohc_packet), rohc_buf_data(ref_rohc_packet),
+		          rohc_packet.len) != 0)
+		{
+			fprintf(stderr, "\trestarted compressor built a %zu-byte ROHC "
+			        "packet of type %d while the reference compressor built "
+			        "a %zu-byte ROHC packet of type %d\n", rohc_packet.len,
+			        packet_type, ref_rohc_packet.len, ref_packet_type);
+			goto destroy_decomp;
+		}
+		fprintf(stderr, "\trestarted compressor built the same ROHC packet "
+		        "as the reference compressor\n");
+
+		/* export the contexts and restart the compressor/decompressor */
+		if(!restart_comp_and_decomp(&comp, &decomp))
+		{
+			goto destroy_decomp;
+		}
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+destroy_ref_decomp:
+	rohc_decomp_free(ref_decomp);
+destroy_ref_comp:
+	rohc_comp_free(ref_comp);
+close_input:
+	pcap_close(handle);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Create one ROHC compressor for the test
+ *
+ * @return  The new ROHC compressor, NULL in case of failure
+ */
+static struct rohc_comp * create_comp(void)
+{
+	struct rohc_comp *comp;
+
+	/* create the ROHC compressor with large CID */
+	comp = rohc_comp_new2(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+
+	/* set the callback for traces on compressor */
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+
+	/* enable profiles */
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the callback RTP detection\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create one ROHC decompressor for the test
+ *
+ * @return  The new ROHC decompressor, NULL in case of failure
+ */
+static struct rohc_decomp * create_decomp(void)
+{
+	struct rohc_decomp *decomp;
+
+	/* create the ROHC decompressor in unidirectional mode */
+	decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto error;
+	}
+
+	/* set the callback for traces on decompressor */
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "cannot set trace callback for decompressor\n");
+		goto destroy_decomp;
+	}
+
+	/* enable decompression profiles */
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Export the contexts of the compressor/decompressor, then replace
+ *        them by new ones that import the contexts
+ *
+ * @param[in,out] comp    The compressor to restart
+ * @param[in,out] decomp  The decompressor to restart
+ * @return                true if the restart was successful, false otherwise
+ */
+static bool restart_comp_and_decomp(struct rohc_comp **const comp,
+                                    struct rohc_decomp **const decomp)
+{
+	static uint8_t comp_buffer[SNAPSHOT_MAX_SIZE];
+	struct rohc_buf comp_snapshot =
+		rohc_buf_init_empty(comp_buffer, SNAPSHOT_MAX_SIZE);
+	static uint8_t decomp_buffer[SNAPSHOT_MAX_SIZE];
+	struct rohc_buf decomp_snapshot =
+		rohc_buf_init_empty(decomp_buffer, SNAPSHOT_MAX_SIZE);
+	struct rohc_comp *new_comp;
+	struct rohc_decomp *new_decomp;
+
+	/* export the contexts */
+	if(rohc_comp_export_contexts(*comp, &comp_snapshot) != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "\tfailed to export the compression contexts\n");
+		goto error;
+	}
+	if(rohc_decomp_export_contexts(*decomp, &decomp_snapshot) != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "\tfailed to export the decompression contexts\n");
+		goto error;
+	}
+	fprintf(stderr, "\tcontexts exported in snapshots of %zu and %zu bytes\n",
+	        comp_snapshot.len, decomp_snapshot.len);
+
+	/* import the contexts in a new compressor and decompressor */
+	new_comp = create_comp();
+	if(new_comp == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_comp_import_contexts(new_comp, comp_snapshot))
+	{
+		fprintf(stderr, "\tfailed to import the compression contexts\n");
+		goto destroy_comp;
+	}
+	new_decomp = create_decomp();
+	if(new_decomp == NULL)
+	{
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_import_contexts(new_decomp, decomp_snapshot))
+	{
+		fprintf(stderr, "\tfailed to import the decompression contexts\n");
+		goto destroy_decomp;
+	}
+
+	/* replace the old compressor and decompressor */
+	rohc_comp_free(*comp);
+	*comp = new_comp;
+	rohc_decomp_free(*decomp);
+	*decomp = new_decomp;
+
+	return true;
+
+destroy_decomp:
+	rohc_decomp_free(new_decomp);
+destroy_comp:
+	rohc_comp_free(new_comp);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress and decompress one IP packet, then compare the result
+ *        with the original packet
+ *
+ * @param comp              The ROHC compressor
+ * @param decomp            The ROHC decompressor
+ * @param ip_packet         The IP packet to compress
+ * @param[out] rohc_packet  The ROHC packet
+ * @param[out] packet_type  The type of the ROHC packet
+ * @return                  true if the packet was successfully compressed
+ *                          and decompressed, false otherwise
+ */
+static bool compress_and_decompress(struct rohc_comp *const comp,
+                                    struct rohc_decomp *const decomp,
+                                    const struct rohc_buf ip_packet,
+                                    struct rohc_buf *const rohc_packet,
+                                    rohc_packet_t *const packet_type)
+{
+	uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf decomp_packet =
+		rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+	rohc_comp_last_packet_info2_t info;
+	rohc_status_t status;
+
+	/* compress the IP packet */
+	status = rohc_compress4(comp, ip_packet, rohc_packet);
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "\tfailed to compress IP packet\n");
+		goto error;
+	}
+	memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+	info.version_major = 0;
+	info.version_minor = 0;
+	if(!rohc_comp_get_last_packet_info2(comp, &info))
+	{
+		fprintf(stderr, "\tfailed to get information on the last packet\n");
+		goto error;
+	}
+	*packet_type = info.packet_type;
+
+	/* decompress the ROHC packet */
+	status = rohc_decompress3(decomp, *rohc_packet, &decomp_packet, NULL, NULL);
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "\tfailed to decompress ROHC packet\n");
+		goto error;
+	}
+
+	/* compare input and output */
+	if(ip_packet.len != decomp_packet.len ||
+	   memcmp(rohc_buf_data(ip_packet), rohc_buf_data(decomp_packet),
+	          ip_packet.len) != 0)
+	{
+		fprintf(stderr, "\toutput packet does not match input packet\n");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * The number is always the same for the reference compressor and the
+ * restarted compressor to build the same ROHC packets.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0x1234;
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	const size_t default_rtp_ports_nr = 5;
+	unsigned int default_rtp_ports[] = { 1234, 36780, 33238, 5020, 5002 };
+	uint16_t udp_dport;
+	bool is_rtp = false;
+	size_t i;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* get the UDP destination port */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	/* is the UDP destination port in the list of ports reserved for RTP
+	 * traffic by default (for compatibility reasons) */
+	for(i = 0; i < default_rtp_ports_nr; i++)
+	{
+		if(ntohs(udp_dport) == default_rtp_ports[i])
+		{
+			is_rtp = true;
+			break;
+		}
+	}
+
+	return is_rtp;
+}
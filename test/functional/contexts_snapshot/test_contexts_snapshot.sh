@@ -0,0 +1,98 @@
+#!/bin/sh
+#
+# Copyright 2016 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+
+#
+# file:        test_contexts_snapshot.sh
+# description: Check that contexts survive an export/import cycle
+# author:      Didier Barvaux <didier@barvaux.org>
+#
+# This script may be used by creating a link "test_contexts_snapshot_TESTTYPE.sh"
+# where:
+#    TESTTYPE is the type of test to run, it is used to choose the source
+#             capture located in the 'inputs' subdirectory.
+#
+# Script arguments:
+#    test_contexts_snapshot_TESTTYPE.sh [verbose [verbose]]
+# where:
+#   verbose          prints the traces of test application
+#
+
+# skip test in case of cross-compilation
+if [ "${CROSS_COMPILATION}" = "yes" ] && \
+   [ -z "${CROSS_COMPILATION_EMULATOR}" ] ; then
+	exit 77
+fi
+
+test -z "${SED}" && SED="`which sed`"
+test -z "${GREP}" && GREP="`which grep`"
+test -z "${AWK}" && AWK="`which gawk`"
+test -z "${AWK}" && AWK="`which awk`"
+
+# parse arguments
+SCRIPT="$0"
+VERBOSE="$1"
+VERY_VERBOSE="$2"
+if [ "x$MAKELEVEL" != "x" ] ; then
+	BASEDIR="${srcdir}"
+	APP="./test_contexts_snapshot${CROSS_COMPILATION_EXEEXT}"
+else
+	BASEDIR=$( dirname "${SCRIPT}" )
+	APP="${BASEDIR}/test_contexts_snapshot${CROSS_COMPILATION_EXEEXT}"
+fi
+
+# extract the ACK type and test type from the name of the script
+TESTTYPE=$( echo "${SCRIPT}" | \
+            ${SED} -e 's#^.*/test_contexts_snapshot_##' -e 's#\.sh$##' )
+CAPTURE_SOURCE="${BASEDIR}/inputs/${TESTTYPE}.pcap"
+
+# check that capture exists
+if [ ! -r "${CAPTURE_SOURCE}" ] ; then
+	echo "source capture ${CAPTURE_SOURCE} not found or not readable, please do not run $(dirname $0)/test_contexts_snapshot.sh directly!"
+	exit 1
+fi
+
+CMD="${CROSS_COMPILATION_EMULATOR} ${APP} ${CAPTURE_SOURCE}"
+
+# source valgrind-related functions
+. ${BASEDIR}/../../valgrind.sh
+
+# run without valgrind in verbose mode or quiet mode
+if [ "${VERBOSE}" = "verbose" ] ; then
+	if [ "${VERY_VERBOSE}" = "verbose" ] ; then
+		run_test_without_valgrind ${CMD} || exit $?
+	else
+		run_test_without_valgrind ${CMD} > /dev/null || exit $?
+	fi
+else
+	run_test_without_valgrind ${CMD} > /dev/null 2>&1 || exit $?
+fi
+
+[ "${USE_VALGRIND}" != "yes" ] && exit 0
+
+# run with valgrind in verbose mode or quiet mode
+if [ "${VERBOSE}" = "verbose" ] ; then
+	if [ "${VERY_VERBOSE}" = "verbose" ] ; then
+		run_test_with_valgrind ${BASEDIR}/../../valgrind.xsl ${CMD} || exit $?
+	else
+		run_test_with_valgrind ${BASEDIR}/../../valgrind.xsl ${CMD} >/dev/null || exit $?
+	fi
+else
+	run_test_with_valgrind ${BASEDIR}/../../valgrind.xsl ${CMD} > /dev/null 2>&1 || exit $?
+fi
+
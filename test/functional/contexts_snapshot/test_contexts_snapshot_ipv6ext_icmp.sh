@@ -0,0 +1 @@
+test_contexts_snapshot.sh
\ No newline at end of file
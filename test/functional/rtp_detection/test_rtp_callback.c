@@ -102,9 +102,19 @@ static bool check_profile(struct rohc_comp *comp,
                           const unsigned int profile);
 
 
+/** The number of packets of the RTP stream to compress */
+#define RTP_PACKETS_NR  10
+
+/** The number of RTP-like packets required by the RTP heuristic */
+#define RTP_HEURISTIC_PACKETS_NR  4
+
+
 /** Whether the application runs in verbose mode or not */
 static int is_verbose;
 
+/** The number of times the RTP detection callback was called */
+static size_t callback_calls_nr = 0;
+
 
 /**
  * @brief Check the RTP detection callback
@@ -195,7 +205,9 @@ static void usage(void)
 	        "usage: test_rtp_callback [OPTIONS] DETECT STREAM\n"
 	        "\n"
 	        "with:\n"
-	        "  DETECT  whether the RTP stream should be detected or not\n"
+	        "  DETECT  whether the RTP stream should be detected or not by the\n"
+	        "          callback (detect or ignore), or by the RTP heuristic\n"
+	        "          (heuristic)\n"
 	        "  STREAM  a stream of IP packet to compress (PCAP format)\n"
 	        "\n"
 	        "options:\n"
@@ -292,8 +304,18 @@ static int test_rtp_callback(const char *const do_detect,
 		goto destroy_comp;
 	}
 
-	/* enable the RTP detection callback */
-	if(strcmp(do_detect, "detect") == 0)
+	/* enable the RTP detection callback or the RTP heuristic */
+	if(strcmp(do_detect, "heuristic") == 0)
+	{
+		if(!rohc_comp_set_rtp_detection_heuristic(comp, RTP_HEURISTIC_PACKETS_NR))
+		{
+			fprintf(stderr, "failed to enable the RTP heuristic\n");
+			goto destroy_comp;
+		}
+
+		expected_profile = ROHC_PROFILE_RTP;
+	}
+	else if(strcmp(do_detect, "detect") == 0)
 	{
 		if(!rohc_comp_set_rtp_detection_cb(comp, callback_detect, NULL))
 		{
@@ -314,19 +336,39 @@ static int test_rtp_callback(const char *const do_detect,
 		expected_profile = ROHC_PROFILE_UDP;
 	}
 
-	/* compress the first packet of the RTP stream, RTP profile is expected */
-	counter = 1;
-	packet = (unsigned char *) pcap_next(handle, &header);
+	/* compress the first packets of the RTP stream with the expected profile,
+	 * except for the first packets with the RTP heuristic that needs several
+	 * packets to detect the RTP stream */
 	success_expected = 1;
-	ret = compress_and_check(comp, header, packet, link_len,
-	                         counter, success_expected,
-	                         expected_profile);
-	if(ret != 0)
+	for(counter = 1; counter <= RTP_PACKETS_NR; counter++)
 	{
-		fprintf(stderr, "test on packet #%d failed\n", counter);
+		int packet_profile = expected_profile;
+
+		if(strcmp(do_detect, "heuristic") == 0 &&
+		   counter < RTP_HEURISTIC_PACKETS_NR)
+		{
+			packet_profile = ROHC_PROFILE_UDP;
+		}
+
+		packet = (unsigned char *) pcap_next(handle, &header);
+		ret = compress_and_check(comp, header, packet, link_len,
+		                         counter, success_expected,
+		                         packet_profile);
+		if(ret != 0)
+		{
+			fprintf(stderr, "test on packet #%d failed\n", counter);
+			goto destroy_comp;
+		}
+	}
+
+	/* the RTP detection callback shall be called for the first packet of the
+	 * flow only */
+	if(strcmp(do_detect, "heuristic") != 0 && callback_calls_nr != 1)
+	{
+		fprintf(stderr, "RTP detection callback was called %zu times for one "
+		        "flow\n", callback_calls_nr);
 		goto destroy_comp;
 	}
-	counter++;
 
 	/* everything went fine */
 	is_failure = 0;
@@ -472,6 +514,8 @@ static bool callback_detect(const unsigned char *const ip,
 	uint32_t rtp_ssrc;
 	bool is_rtp = false;
 
+	callback_calls_nr++;
+
 	/* check UDP destination port */
 	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
 	if(ntohs(udp_dport) != 1234)
@@ -519,6 +563,7 @@ static bool callback_ignore(const unsigned char *const ip,
                             const unsigned int payload_size,
                             void *const rtp_private)
 {
+	callback_calls_nr++;
 	return false;
 }
 
@@ -0,0 +1 @@
+test_rtp_callback.sh
\ No newline at end of file
@@ -57,6 +57,9 @@
 /** The max size */
 #define TEST_MAX_ROHC_SIZE  (5U * 1024U)
 
+/** The max size of ROHC headers when the payload is not copied */
+#define TEST_MAX_HDR_SIZE  100U
+
 
 /* prototypes of private functions */
 static void usage(void);
@@ -64,6 +67,16 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
                                 const bool is_comp_expected_ok,
                                 const size_t expected_segments_nr);
+static int test_comp_sg(const size_t ip_packet_len,
+                        const size_t mrru);
+static struct rohc_comp * create_comp(const size_t mrru);
+static void gen_ip_packet(struct rohc_buf *const ip_packet,
+                          const size_t ip_packet_len)
+	__attribute__((nonnull(1)));
+static void gather_sg(struct rohc_buf *const packet,
+                      const struct rohc_buf hdr,
+                      const rohc_comp_payload_t *const payload)
+	__attribute__((nonnull(1, 3)));
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -141,6 +154,18 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* test ROHC packets and segments built without copying the payload,
+	 * they shall be the same as the ones built with a copy of the payload */
+	status |= test_comp_sg(100, TEST_MAX_ROHC_SIZE * 2);
+	status |= test_comp_sg(TEST_MAX_ROHC_SIZE, TEST_MAX_ROHC_SIZE * 2);
+	status |= test_comp_sg(TEST_MAX_ROHC_SIZE, 0);
+	status |= test_comp_sg(TEST_MAX_ROHC_SIZE * 2, TEST_MAX_ROHC_SIZE * 3);
+	status |= test_comp_sg(TEST_MAX_ROHC_SIZE * 2, TEST_MAX_ROHC_SIZE);
+	if(status != 0)
+	{
+		goto error;
+	}
+
 error:
 	return status;
 }
@@ -187,7 +212,6 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	struct rohc_decomp *decomp;
 //! [define ROHC decompressor]
 
-	struct ipv4_hdr *ip_header;
 	uint8_t ip_buffer[TEST_MAX_ROHC_SIZE * 3];
 	struct rohc_buf ip_packet =
 		rohc_buf_init_empty(ip_buffer, TEST_MAX_ROHC_SIZE * 3);
@@ -204,7 +228,6 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 
 	int is_failure = 1;
 	rohc_status_t status;
-	size_t i;
 
 	fprintf(stderr, "test ROHC segments with %zu-byte IP packet and "
 	        "MMRU = %zu bytes\n", ip_packet_len, mrru);
@@ -293,40 +316,7 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	}
 
 	/* generate the IP packet of the given length */
-	ip_packet.len = ip_packet_len;
-	ip_header = (struct ipv4_hdr *) rohc_buf_data(ip_packet);
-	ip_header->version = 4; /* we create an IPv4 header */
-	ip_header->ihl = 5; /* minimal IPv4 header length (in 32-bit words) */
-	ip_header->tos = 0;
-	ip_header->tot_len = htons(ip_packet_len);
-	ip_header->id = 0;
-	ip_header->frag_off = 0;
-	ip_header->ttl = 1;
-	ip_header->protocol = 134; /* unassigned number according to /etc/protocols */
-	ip_header->check = 0; /* set to 0 for checksum computation */
-	ip_header->saddr = htonl(0x01020304);
-	ip_header->daddr = htonl(0x05060708);
-	if(ip_packet_len == 100)
-	{
-		ip_header->check = htons(0xa901);
-	}
-	else if(ip_packet_len == TEST_MAX_ROHC_SIZE)
-	{
-		ip_header->check = htons(0x9565);
-	}
-	else if(ip_packet_len == TEST_MAX_ROHC_SIZE * 2)
-	{
-		ip_header->check = htons(0x8165);
-	}
-	else
-	{
-		/* compute the IP checksum for your test length */
-		assert(0);
-	}
-	for(i = sizeof(struct ipv4_hdr); i < ip_packet_len; i++)
-	{
-		rohc_buf_byte_at(ip_packet, i) = i & 0xff;
-	}
+	gen_ip_packet(&ip_packet, ip_packet_len);
 
 	/* compress the IP packet */
 	segments_nr = 0;
@@ -469,6 +459,239 @@ error:
 }
 
 
+/**
+ * @brief Check that ROHC packets and segments built without payload copy are
+ *        the same as the ones built with payload copy
+ *
+ * @param ip_packet_len  The size of the IP packet to generate for the test
+ * @param mrru           The MRRU for the test
+ * @return               0 in case of success,
+ *                       1 in case of failure
+ */
+static int test_comp_sg(const size_t ip_packet_len,
+                        const size_t mrru)
+{
+	struct rohc_comp *comp;
+	struct rohc_comp *comp_sg;
+
+	uint8_t ip_buffer[TEST_MAX_ROHC_SIZE * 3];
+	struct rohc_buf ip_packet =
+		rohc_buf_init_empty(ip_buffer, TEST_MAX_ROHC_SIZE * 3);
+
+	uint8_t rohc_buffer[TEST_MAX_ROHC_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, TEST_MAX_ROHC_SIZE);
+
+	uint8_t hdr_buffer[TEST_MAX_HDR_SIZE];
+	struct rohc_buf rohc_hdr = rohc_buf_init_empty(hdr_buffer, TEST_MAX_HDR_SIZE);
+	rohc_comp_payload_t payload;
+
+	uint8_t sg_buffer[TEST_MAX_ROHC_SIZE];
+	struct rohc_buf sg_packet =
+		rohc_buf_init_empty(sg_buffer, TEST_MAX_ROHC_SIZE);
+
+	size_t segments_nr = 0;
+	rohc_status_t status;
+	rohc_status_t status_sg;
+	int is_failure = 1;
+
+	fprintf(stderr, "test ROHC packets and segments without payload copy "
+	        "with %zu-byte IP packet and MMRU = %zu bytes\n", ip_packet_len,
+	        mrru);
+
+	/* create the two ROHC compressors in the same way */
+	comp = create_comp(mrru);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	comp_sg = create_comp(mrru);
+	if(comp_sg == NULL)
+	{
+		goto destroy_comp;
+	}
+
+	/* generate the IP packet of the given length */
+	gen_ip_packet(&ip_packet, ip_packet_len);
+
+	/* compress the IP packet with and without payload copy (initialize the
+	 * random generator with the same number before each compression, so that
+	 * both contexts are created with the same SN) */
+	srand(4);
+	status = rohc_compress4(comp, ip_packet, &rohc_packet);
+	srand(4);
+	status_sg = rohc_compress_sg(comp_sg, ip_packet, TEST_MAX_ROHC_SIZE,
+	                             &rohc_hdr, &payload);
+	for(;;)
+	{
+		if(status_sg != status)
+		{
+			fprintf(stderr, "\tcompression without payload copy returned "
+			        "status %d while %d expected\n", status_sg, status);
+			goto destroy_comp_sg;
+		}
+		if(status != ROHC_STATUS_OK && status != ROHC_STATUS_SEGMENT)
+		{
+			fprintf(stderr, "\tcompression failed in both cases\n");
+			break;
+		}
+
+		/* compare the ROHC packets or segments (no data at all if the IP
+		 * packet was just segmented) */
+		gather_sg(&sg_packet, rohc_hdr, &payload);
+		if(sg_packet.len != rohc_packet.len ||
+		   memcmp(rohc_buf_data(sg_packet), rohc_buf_data(rohc_packet),
+		          rohc_packet.len) != 0)
+		{
+			fprintf(stderr, "\t%zu-byte ROHC data built without payload copy "
+			        "does not match the %zu-byte ROHC data built with payload "
+			        "copy\n", sg_packet.len, rohc_packet.len);
+			goto destroy_comp_sg;
+		}
+		rohc_packet.len = 0;
+		rohc_hdr.len = 0;
+		sg_packet.len = 0;
+
+		/* stop after the full ROHC packet or the final ROHC segment */
+		if(status == ROHC_STATUS_OK)
+		{
+			break;
+		}
+
+		/* get the next segments with and without payload copy */
+		status = rohc_comp_get_segment2(comp, &rohc_packet);
+		status_sg = rohc_comp_get_segment_sg(comp_sg, TEST_MAX_ROHC_SIZE,
+		                                     &rohc_hdr, &payload);
+		segments_nr++;
+	}
+	fprintf(stderr, "\t%zu segment(s) generated with the same content\n\n",
+	        segments_nr);
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_comp_sg:
+	rohc_comp_free(comp_sg);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Create a ROHC compressor with all profiles and the given MRRU
+ *
+ * @param mrru  The MRRU for the compressor
+ * @return      The new ROHC compressor, NULL in case of failure
+ */
+static struct rohc_comp * create_comp(const size_t mrru)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_mrru(comp, mrru))
+	{
+		fprintf(stderr, "failed to set the MRRU at compressor\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Generate an IPv4 packet of the given length
+ *
+ * @param[out] ip_packet  The generated IP packet
+ * @param ip_packet_len   The length of the IP packet to generate
+ */
+static void gen_ip_packet(struct rohc_buf *const ip_packet,
+                          const size_t ip_packet_len)
+{
+	struct ipv4_hdr *ip_header;
+	size_t i;
+
+	ip_packet->len = ip_packet_len;
+	ip_header = (struct ipv4_hdr *) rohc_buf_data(*ip_packet);
+	ip_header->version = 4; /* we create an IPv4 header */
+	ip_header->ihl = 5; /* minimal IPv4 header length (in 32-bit words) */
+	ip_header->tos = 0;
+	ip_header->tot_len = htons(ip_packet_len);
+	ip_header->id = 0;
+	ip_header->frag_off = 0;
+	ip_header->ttl = 1;
+	ip_header->protocol = 134; /* unassigned number according to /etc/protocols */
+	ip_header->check = 0; /* set to 0 for checksum computation */
+	ip_header->saddr = htonl(0x01020304);
+	ip_header->daddr = htonl(0x05060708);
+	if(ip_packet_len == 100)
+	{
+		ip_header->check = htons(0xa901);
+	}
+	else if(ip_packet_len == TEST_MAX_ROHC_SIZE)
+	{
+		ip_header->check = htons(0x9565);
+	}
+	else if(ip_packet_len == TEST_MAX_ROHC_SIZE * 2)
+	{
+		ip_header->check = htons(0x8165);
+	}
+	else
+	{
+		/* compute the IP checksum for your test length */
+		assert(0);
+	}
+	for(i = sizeof(struct ipv4_hdr); i < ip_packet_len; i++)
+	{
+		rohc_buf_byte_at(*ip_packet, i) = i & 0xff;
+	}
+}
+
+
+/**
+ * @brief Gather the ROHC header, the payload and the trailer built without
+ *        payload copy in one single buffer
+ *
+ * @param[out] packet  The buffer to store the whole ROHC packet or segment in
+ * @param hdr          The ROHC header
+ * @param payload      The payload and trailer
+ */
+static void gather_sg(struct rohc_buf *const packet,
+                      const struct rohc_buf hdr,
+                      const rohc_comp_payload_t *const payload)
+{
+	rohc_buf_append_buf(packet, hdr);
+	rohc_buf_append(packet, payload->data, payload->len);
+	rohc_buf_append(packet, payload->trailer, payload->trailer_len);
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *